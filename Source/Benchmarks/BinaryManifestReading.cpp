@@ -0,0 +1,148 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Compares reading a large binary asset manifest to a Variant tree against reading it through views.
+
+//! The total number of assets in a generated manifest.
+static const s32 kAssetCount = 100000;
+
+//! Runs the binary asset manifest reading benchmark.
+class BinaryManifestReading {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Io::ByteBufferPtr buffer = generateManifest();
+        f64               size   = buffer->length() / (1024.0 * 1024.0);
+
+        Benchmark::report( "BinaryManifestReading", "%d assets, %.1f MB manifest", kAssetCount, size );
+
+        // Read a whole manifest to a Variant tree
+        {
+            buffer->setPosition( 0 );
+            u64 allocations = Benchmark::allocations();
+            Benchmark::Timer timer;
+
+            Variant manifest;
+            Io::BinaryVariantStream( buffer.get() ).read( manifest );
+
+            s64                         total  = 0;
+            KeyValue                    kv     = manifest.as<KeyValue>();
+            const KeyValue::Properties& assets = kv.properties();
+
+            for( KeyValue::Properties::const_iterator i = assets.begin(), end = assets.end(); i != end; ++i ) {
+                total += i->second.as<KeyValue>().valueAtKey( "size" ).as<s64>();
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "BinaryManifestReading", "variant tree: %.1f ms, %.1f MB/s, %llu allocations, %lld bytes", time, size / (time * 0.001), Benchmark::allocations() - allocations, total );
+        }
+
+        // Walk a manifest through views
+        {
+            u64 allocations = Benchmark::allocations();
+            Benchmark::Timer timer;
+
+            Io::BinaryVariantView manifest = Io::BinaryVariantView::root( buffer->buffer(), buffer->length() );
+
+            s64 total = 0;
+
+            for( Io::BinaryVariantView::Cursor i = manifest.items(); i.next(); ) {
+                total += i.value().valueAtKey( "size" ).toInteger();
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "BinaryManifestReading", "views: %.1f ms, %.1f MB/s, %llu allocations, %lld bytes", time, size / (time * 0.001), Benchmark::allocations() - allocations, total );
+        }
+
+        // Index a manifest and look assets up by name
+        {
+            Benchmark::Timer timer;
+            Io::BinaryVariantIndex index( Io::BinaryVariantView::root( buffer->buffer(), buffer->length() ) );
+            f64 indexing = timer.ms();
+
+            timer.restart();
+            u64 allocations = Benchmark::allocations();
+
+            s64  total = 0;
+            char key[32];
+
+            for( s32 i = 0; i < kAssetCount; i++ ) {
+                sprintf( key, "asset%d", (i * 7919) % kAssetCount );
+                total += index.find( key ).valueAtKey( "size" ).toInteger();
+            }
+
+            f64 lookup = timer.ms();
+            Benchmark::report( "BinaryManifestReading", "index: built in %.1f ms, %d lookups in %.1f ms, %llu allocations, %lld bytes", indexing, kAssetCount, lookup, Benchmark::allocations() - allocations, total );
+        }
+    }
+
+private:
+
+    //! Generates a binary manifest with asset names, files, sizes and tags.
+    static Io::ByteBufferPtr generateManifest( void )
+    {
+        KeyValue manifest;
+        char     buffer[64];
+
+        for( s32 i = 0; i < kAssetCount; i++ ) {
+            VariantArray tags;
+            tags << Variant::fromValue<String>( "static" ) << Variant::fromValue<String>( i % 2 ? "streamed" : "resident" );
+
+            KeyValue asset;
+            sprintf( buffer, "meshes/object%d", i );
+            asset.setValueAtKey( "name", Variant::fromValue<String>( buffer ) );
+            sprintf( buffer, "%08x.mesh", i * 2654435761u );
+            asset.setValueAtKey( "file", Variant::fromValue<String>( buffer ) );
+            asset.setValueAtKey( "size", Variant::fromValue<s32>( 1024 + i % 4096 ) );
+            asset.setValueAtKey( "tags", Variant::fromValue<VariantArray>( tags ) );
+
+            sprintf( buffer, "asset%d", i );
+            manifest.setValueAtKey( buffer, Variant::fromValue<KeyValue>( asset ) );
+        }
+
+        Io::ByteBufferPtr result = Io::ByteBuffer::create();
+        Io::BinaryVariantStream( result.get() ).write( Variant::fromValue<KeyValue>( manifest ) );
+        return result;
+    }
+};
+
+int main( int argc, char** argv )
+{
+    BinaryManifestReading benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Compares visiting every entity of a system with visiting only entities reported by a change query.
+
+//! The total number of entities in a world.
+static const s32 kEntityCount = 100000;
+
+//! The number of entities modified on each tick.
+static const s32 kChangedCount = 1000;
+
+//! The total number of simulated ticks.
+static const s32 kTickCount = 100;
+
+//! A component with a position and derived world space bounds.
+class Body : public Ecs::Component<Body> {
+public:
+
+                        Body( void )
+                            : radius( 1.0f ) {}
+
+    Vec3                position;   //!< The body position.
+    f32                 radius;     //!< The body radius.
+    Vec3                min;        //!< World space bounds minimum calculated from a position.
+    Vec3                max;        //!< World space bounds maximum calculated from a position.
+};
+
+//! Calculates world space bounds of a body.
+static void updateBounds( Body& body )
+{
+    Vec3 extents( body.radius, body.radius, body.radius );
+    body.min = body.position - extents;
+    body.max = body.position + extents;
+}
+
+//! Runs the change query benchmark.
+class EcsChangeQuery {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Ecs::EcsPtr         ecs      = Ecs::Ecs::create();
+        Ecs::EntityArray    entities;
+
+        for( s32 i = 0; i < kEntityCount; i++ ) {
+            Ecs::EntityPtr entity = ecs->createEntity();
+            entity->attach<Body>();
+            ecs->addEntity( entity );
+            entities.push_back( entity );
+        }
+
+        Ecs::IndexPtr index = ecs->requestIndex( "Bodies", Ecs::Aspect::all<Body>() );
+        Ecs::QueryPtr query = ecs->requestQuery( "Bodies", Ecs::Aspect::all<Body>(), Body::bit() );
+        ecs->update( 0, 0.0f );
+        query->changed();
+
+        Benchmark::report( "EcsChangeQuery", "%d entities, %d modified per tick", kEntityCount, kChangedCount );
+
+        // Visit each entity on every tick
+        {
+            s32 visited = 0;
+            Benchmark::Timer timer;
+
+            for( s32 tick = 0; tick < kTickCount; tick++ ) {
+                move( entities, tick );
+
+                const Ecs::EntitySet& bodies = index->entities();
+
+                for( Ecs::EntitySet::const_iterator i = bodies.begin(), end = bodies.end(); i != end; ++i ) {
+                    updateBounds( *(*i)->get<Body>() );
+                    visited++;
+                }
+
+                ecs->update( 0, 0.0f );
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "EcsChangeQuery", "full scan: %.3f ms per tick, %d entities visited", time / kTickCount, visited );
+        }
+
+        // Visit only entities with changed bodies
+        {
+            s32 visited = 0;
+            Benchmark::Timer timer;
+
+            for( s32 tick = 0; tick < kTickCount; tick++ ) {
+                move( entities, tick );
+
+                const Ecs::EntityArray& changed = query->changed();
+
+                for( s32 i = 0, n = static_cast<s32>( changed.size() ); i < n; i++ ) {
+                    updateBounds( *changed[i]->get<Body>() );
+                    visited++;
+                }
+
+                ecs->update( 0, 0.0f );
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "EcsChangeQuery", "change query: %.3f ms per tick, %d entities visited", time / kTickCount, visited );
+        }
+    }
+
+private:
+
+    //! Moves a subset of bodies.
+    static void         move( const Ecs::EntityArray& entities, s32 tick )
+    {
+        for( s32 i = 0; i < kChangedCount; i++ ) {
+            const Ecs::EntityPtr& entity = entities[(tick * kChangedCount + i * 97) % kEntityCount];
+            Body* body = entity->modify<Body>();
+            body->position = body->position + Vec3( 0.1f, 0.0f, 0.0f );
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    EcsChangeQuery benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,200 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures entity creation and destruction throughput, iteration over churned entities and entity lookups.
+
+//! The total number of entities alive in a world.
+static const s32 kEntityCount = 1000000;
+
+//! The number of entities destroyed and recreated on each churn round.
+static const s32 kChurnCount = 250000;
+
+//! The total number of churn rounds.
+static const s32 kRoundCount = 4;
+
+//! A component with a position.
+class ChurnPosition : public Ecs::Component<ChurnPosition> {
+public:
+
+    Vec3                value;  //!< The position.
+};
+
+//! A component with a velocity.
+class ChurnVelocity : public Ecs::Component<ChurnVelocity> {
+public:
+
+    Vec3                value;  //!< The velocity.
+};
+
+//! Runs the entity churn benchmark.
+class EcsEntityChurn {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Ecs::EcsPtr ecs = Ecs::Ecs::create();
+        Ecs::IndexPtr index = ecs->requestIndex( "Moving", Ecs::Aspect::all<ChurnPosition, ChurnVelocity>() );
+
+        Benchmark::report( "EcsEntityChurn", "%d entities, %d churned per round, %d rounds", kEntityCount, kChurnCount, kRoundCount );
+
+        Ecs::EntityArray entities;
+        entities.reserve( kEntityCount );
+
+        // Create all entities
+        {
+            u64 allocations = Benchmark::allocations();
+            Benchmark::resetHeapPeak();
+            Benchmark::Timer timer;
+
+            for( s32 i = 0; i < kEntityCount; i++ ) {
+                entities.push_back( spawn( ecs ) );
+            }
+            ecs->update( 0, 0.0f );
+
+            f64 time = timer.ms();
+            Benchmark::report( "EcsEntityChurn", "create: %.3f ms, %.0f entities/s, %llu allocations, %llu KB heap peak"
+                , time, kEntityCount / (time * 0.001), Benchmark::allocations() - allocations, Benchmark::heapPeak() / 1024 );
+        }
+
+        // Destroy and recreate a subset of entities, so pools are fragmented by free lists
+        {
+            f64 destroyTime = 0.0;
+            f64 createTime  = 0.0;
+            u32 seed        = 1;
+
+            for( s32 round = 0; round < kRoundCount; round++ ) {
+                Benchmark::Timer timer;
+
+                for( s32 i = 0; i < kChurnCount; i++ ) {
+                    seed = seed * 1664525 + 1013904223;
+                    s32 slot = static_cast<s32>( seed % kEntityCount );
+
+                    if( entities[slot].valid() ) {
+                        ecs->removeEntity( entities[slot]->id() );
+                        entities[slot] = Ecs::EntityPtr();
+                    }
+                }
+                ecs->update( 0, 0.0f );
+                destroyTime += timer.ms();
+
+                timer.restart();
+
+                for( s32 i = 0; i < kEntityCount; i++ ) {
+                    if( !entities[i].valid() ) {
+                        entities[i] = spawn( ecs );
+                    }
+                }
+                ecs->update( 0, 0.0f );
+                createTime += timer.ms();
+            }
+
+            Benchmark::report( "EcsEntityChurn", "churn: %.3f ms destroying, %.3f ms creating per round", destroyTime / kRoundCount, createTime / kRoundCount );
+        }
+
+        // Iterate entities of an index after the churn
+        {
+            Benchmark::Timer timer;
+            const Ecs::EntitySet& moving = index->entities();
+
+            for( Ecs::EntitySet::const_iterator i = moving.begin(), end = moving.end(); i != end; ++i ) {
+                ChurnPosition* position = (*i)->get<ChurnPosition>();
+                position->value = position->value + (*i)->get<ChurnVelocity>()->value;
+            }
+
+            Benchmark::report( "EcsEntityChurn", "iterate: %.3f ms for %d entities", timer.ms(), static_cast<s32>( moving.size() ) );
+        }
+
+        // Lookup entities by a persistent identifier and by a generational handle
+        {
+            Array<Ecs::EntityId>     ids;
+            Array<Ecs::EntityHandle> handles;
+
+            ids.reserve( kEntityCount );
+            handles.reserve( kEntityCount );
+
+            for( s32 i = 0; i < kEntityCount; i++ ) {
+                ids.push_back( entities[i]->id() );
+                handles.push_back( entities[i]->handle() );
+            }
+
+            s32 found = 0;
+            Benchmark::Timer timer;
+
+            for( s32 i = 0; i < kEntityCount; i++ ) {
+                found += ecs->findEntity( ids[i] ).valid() ? 1 : 0;
+            }
+
+            f64 byId = timer.ms();
+            timer.restart();
+
+            for( s32 i = 0; i < kEntityCount; i++ ) {
+                found += ecs->findEntity( handles[i] ).valid() ? 1 : 0;
+            }
+
+            f64 byHandle = timer.ms();
+            Benchmark::report( "EcsEntityChurn", "lookup: %.3f ms by id, %.3f ms by handle, %d found", byId, byHandle, found );
+        }
+
+        // Report pool occupancy
+        Ecs::ComponentPool::StatisticsArray pools = Ecs::ComponentPool::allStatistics();
+
+        for( s32 i = 0, n = static_cast<s32>( pools.size() ); i < n; i++ ) {
+            const Ecs::ComponentPool::Statistics& pool = pools[i];
+            Benchmark::report( "EcsEntityChurn", "pool %s: %d byte blocks, %d of %d used, %d peak, %d slabs"
+                , pool.name.c_str(), pool.blockSize, pool.used, pool.capacity, pool.peak, pool.slabs );
+        }
+    }
+
+private:
+
+    //! Creates an entity with a position and a velocity and adds it to a world.
+    static Ecs::EntityPtr spawn( Ecs::EcsWPtr ecs )
+    {
+        Ecs::EntityPtr entity = ecs->createEntity();
+        entity->attach<ChurnPosition>();
+        entity->attach<ChurnVelocity>()->value = Vec3( 1.0f, 0.0f, 0.0f );
+        ecs->addEntity( entity );
+        return entity;
+    }
+};
+
+int main( int argc, char** argv )
+{
+    EcsEntityChurn benchmark;
+    benchmark.run();
+    return 0;
+}
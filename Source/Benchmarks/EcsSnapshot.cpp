@@ -0,0 +1,192 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Compares saving and loading an entity world through binary snapshots with key-value entity serialization.
+
+//! The total number of entities in a world.
+static const s32 kEntityCount = 100000;
+
+//! A component that consists of plain data properties only.
+class Motion : public Ecs::Component<Motion> {
+
+    INTROSPECTION_SUPER( Motion, Ecs::ComponentBase
+        , PROPERTY( position, position, setPosition, "The body position." )
+        , PROPERTY( velocity, velocity, setVelocity, "The body velocity." )
+        , PROPERTY( mass, mass, setMass, "The body mass." )
+        )
+
+public:
+
+                            Motion( void )
+                                : m_mass( 1.0f ) {}
+
+    const Vec3&             position( void ) const { return m_position; }
+    void                    setPosition( const Vec3& value ) { m_position = value; }
+    const Vec3&             velocity( void ) const { return m_velocity; }
+    void                    setVelocity( const Vec3& value ) { m_velocity = value; }
+    f32                     mass( void ) const { return m_mass; }
+    void                    setMass( f32 value ) { m_mass = value; }
+
+private:
+
+    Vec3                    m_position;
+    Vec3                    m_velocity;
+    f32                     m_mass;
+};
+
+//! A component with a variable size property.
+class Label : public Ecs::Component<Label> {
+
+    INTROSPECTION_SUPER( Label, Ecs::ComponentBase
+        , PROPERTY( name, name, setName, "The entity name." )
+        , PROPERTY( layer, layer, setLayer, "The entity layer." )
+        )
+
+public:
+
+                            Label( void )
+                                : m_layer( 0 ) {}
+
+    const String&           name( void ) const { return m_name; }
+    void                    setName( const String& value ) { m_name = value; }
+    u32                     layer( void ) const { return m_layer; }
+    void                    setLayer( u32 value ) { m_layer = value; }
+
+private:
+
+    String                  m_name;
+    u32                     m_layer;
+};
+
+//! Runs the world snapshot benchmark.
+class EcsSnapshot {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Reflection::AssemblyPtr assembly = Reflection::Assembly::create();
+        assembly->registerClass<Motion>();
+        assembly->registerClass<Label>();
+
+        // Populate a world
+        Ecs::EcsPtr world = Ecs::Ecs::create();
+
+        for( s32 i = 0; i < kEntityCount; i++ ) {
+            Ecs::EntityPtr entity = world->createEntity();
+
+            Motion* motion = entity->attachComponent( DC_NEW Motion );
+            motion->setPosition( Vec3( static_cast<f32>( i ), 0.0f, 0.0f ) );
+            motion->setVelocity( Vec3( 0.0f, 1.0f, 0.0f ) );
+
+            Label* label = entity->attachComponent( DC_NEW Label );
+            label->setName( "entity" );
+            label->setLayer( i % 4 );
+
+            world->addEntity( entity );
+        }
+
+        Ecs::EntityArray entities = world->entities();
+        Benchmark::Timer timer;
+
+        // Write entities to key-value storages packed to a binary stream
+        Ecs::Serializer   serializer( world );
+        Io::ByteBufferPtr keyValueStream = Io::ByteBuffer::create();
+        {
+            Io::BinaryVariantStream variants( keyValueStream.get() );
+
+            timer.restart();
+            for( s32 i = 0; i < kEntityCount; i++ ) {
+                KeyValue ar;
+                serializer.serializeEntity( entities[i], ar );
+                variants.write( Variant::fromValue( ar ) );
+            }
+        }
+        f64 keyValueWrite = timer.ms();
+
+        // Read them back to an empty world
+        Ecs::EcsPtr keyValueWorld = Ecs::Ecs::create();
+        {
+            Ecs::Serializer         reader( keyValueWorld );
+            Io::BinaryVariantStream variants( keyValueStream.get() );
+            keyValueStream->setPosition( 0 );
+
+            timer.restart();
+            for( s32 i = 0; i < kEntityCount; i++ ) {
+                Variant value;
+                variants.read( value );
+
+                Ecs::EntityPtr entity = keyValueWorld->createEntity( entities[i]->id() );
+                keyValueWorld->addEntity( entity );
+                reader.deserializeEntity( assembly, entity, value.as<KeyValue>() );
+            }
+        }
+        f64 keyValueRead = timer.ms();
+
+        // Write a world snapshot
+        Ecs::WorldSnapshot snapshot( world );
+        Io::ByteBufferPtr  snapshotStream = Io::ByteBuffer::create();
+
+        timer.restart();
+        snapshot.save( snapshotStream.get() );
+        f64 snapshotWrite = timer.ms();
+
+        // Load it to an empty world
+        Ecs::EcsPtr        snapshotWorld = Ecs::Ecs::create();
+        Ecs::WorldSnapshot reader( snapshotWorld );
+        snapshotStream->setPosition( 0 );
+
+        timer.restart();
+        reader.load( assembly, snapshotStream.get() );
+        f64 snapshotRead = timer.ms();
+
+        // Restore a populated world in place, the way an undo or a network baseline does
+        snapshotStream->setPosition( 0 );
+
+        timer.restart();
+        reader.load( assembly, snapshotStream.get() );
+        f64 snapshotRestore = timer.ms();
+
+        Benchmark::report( "EcsSnapshot", "%d entities, key-value %d bytes, snapshot %d bytes", kEntityCount, keyValueStream->length(), snapshotStream->length() );
+        Benchmark::report( "EcsSnapshot", "key-value: save %.1f ms, load %.1f ms", keyValueWrite, keyValueRead );
+        Benchmark::report( "EcsSnapshot", "snapshot: save %.1f ms, load %.1f ms, restore in place %.1f ms", snapshotWrite, snapshotRead, snapshotRestore );
+    }
+};
+
+int main( int argc, char** argv )
+{
+    EcsSnapshot benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Compares spawning prefab copies one by one with a batched spawn.
+
+//! The number of projectiles spawned in a single frame.
+static const s32 kProjectileCount = 50000;
+
+//! The number of indices that are not interested in projectiles.
+static const s32 kUnrelatedIndexCount = 8;
+
+//! A projectile transform.
+class ProjectileTransform : public Ecs::Component<ProjectileTransform> {
+public:
+
+    Vec3                position;   //!< A projectile position.
+    Quat                rotation;   //!< A projectile rotation.
+};
+
+//! A projectile movement.
+class ProjectileMotion : public Ecs::Component<ProjectileMotion> {
+public:
+
+                        ProjectileMotion( void )
+                            : speed( 50.0f ), lifetime( 2.0f ) {}
+
+    Vec3                direction;  //!< A movement direction.
+    f32                 speed;      //!< A movement speed.
+    f32                 lifetime;   //!< A remaining lifetime in seconds.
+};
+
+//! A component attached to other kinds of entities.
+template<s32 N>
+class UnrelatedTag : public Ecs::Component< UnrelatedTag<N> > {
+};
+
+//! Runs the batched spawn benchmark.
+class EcsSpawnBatch {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Benchmark::report( "EcsSpawnBatch", "%d projectiles, %d unrelated indices", kProjectileCount, kUnrelatedIndexCount );
+
+        // Copy and add each projectile separately
+        {
+            Ecs::EcsPtr    ecs    = createWorld();
+            Ecs::EntityPtr prefab = createPrefab( ecs );
+
+            u64 allocations = Benchmark::allocations();
+            Benchmark::Timer timer;
+
+            for( s32 i = 0; i < kProjectileCount; i++ ) {
+                ecs->addEntity( ecs->copyEntity( prefab ) );
+            }
+            ecs->update( 0, 0.0f );
+
+            f64 time = timer.ms();
+            Benchmark::report( "EcsSpawnBatch", "copyEntity: %.3f ms, %llu allocations, %d indexed", time, Benchmark::allocations() - allocations, m_projectiles->size() );
+        }
+
+        // Spawn all projectiles at once
+        {
+            Ecs::EcsPtr    ecs    = createWorld();
+            Ecs::EntityPtr prefab = createPrefab( ecs );
+
+            u64 allocations = Benchmark::allocations();
+            Benchmark::Timer timer;
+
+            ecs->spawnBatch( prefab, kProjectileCount );
+            ecs->update( 0, 0.0f );
+
+            f64 time = timer.ms();
+            Benchmark::report( "EcsSpawnBatch", "spawnBatch: %.3f ms, %llu allocations, %d indexed", time, Benchmark::allocations() - allocations, m_projectiles->size() );
+        }
+    }
+
+private:
+
+    //! Creates a world with a projectile index and a set of unrelated indices.
+    Ecs::EcsPtr         createWorld( void )
+    {
+        Ecs::EcsPtr ecs = Ecs::Ecs::create();
+
+        m_projectiles = ecs->requestIndex( "Projectiles", Ecs::Aspect::all<ProjectileTransform, ProjectileMotion>() );
+        m_unrelated.clear();
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated0", Ecs::Aspect::all< UnrelatedTag<0> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated1", Ecs::Aspect::all< UnrelatedTag<1> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated2", Ecs::Aspect::all< UnrelatedTag<2> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated3", Ecs::Aspect::all< UnrelatedTag<3> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated4", Ecs::Aspect::all< UnrelatedTag<4> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated5", Ecs::Aspect::all< UnrelatedTag<5> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated6", Ecs::Aspect::all< UnrelatedTag<6> >() ) );
+        m_unrelated.push_back( ecs->requestIndex( "Unrelated7", Ecs::Aspect::all< UnrelatedTag<7> >() ) );
+
+        return ecs;
+    }
+
+    //! Creates a projectile prefab.
+    static Ecs::EntityPtr createPrefab( Ecs::EcsWPtr ecs )
+    {
+        Ecs::EntityPtr prefab = ecs->createEntity();
+        prefab->attach<ProjectileTransform>();
+        prefab->attach<ProjectileMotion>()->direction = Vec3( 0.0f, 0.0f, 1.0f );
+        return prefab;
+    }
+
+private:
+
+    Ecs::IndexPtr           m_projectiles;  //!< An index of projectile entities.
+    Array<Ecs::IndexPtr>    m_unrelated;    //!< Indices that never contain projectiles.
+};
+
+int main( int argc, char** argv )
+{
+    EcsSpawnBatch benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,180 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "Benchmark.h"
+
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <cstdarg>
+#include <ctime>
+
+#if !defined( DC_PLATFORM_WINDOWS )
+    #include <sys/resource.h>
+#endif  /*  !DC_PLATFORM_WINDOWS    */
+
+//! The total number of heap allocations, incremented by a global operator new.
+static std::atomic<DC_DREEMCHEST_NS u64> s_allocations( 0 );
+
+//! The number of bytes currently allocated by a global operator new.
+static std::atomic<DC_DREEMCHEST_NS u64> s_heapSize( 0 );
+
+//! The maximum heap size since the last reset.
+static std::atomic<DC_DREEMCHEST_NS u64> s_heapPeak( 0 );
+
+//! Each allocation is prefixed with its size, the header size keeps returned pointers aligned.
+static const size_t kAllocationHeader = 16;
+
+// ** operator new
+void* operator new( size_t size )
+{
+    ++s_allocations;
+
+    void* block = malloc( size + kAllocationHeader );
+
+    if( !block ) {
+        throw std::bad_alloc();
+    }
+
+    *reinterpret_cast<size_t*>( block ) = size;
+
+    // Track a heap size and its peak value
+    DC_DREEMCHEST_NS u64 current = s_heapSize += size;
+    DC_DREEMCHEST_NS u64 peak    = s_heapPeak;
+
+    while( current > peak && !s_heapPeak.compare_exchange_weak( peak, current ) ) {
+    }
+
+    return reinterpret_cast<char*>( block ) + kAllocationHeader;
+}
+
+// ** operator new[]
+void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+// ** operator delete
+void operator delete( void* pointer ) throw()
+{
+    if( !pointer ) {
+        return;
+    }
+
+    void* block = reinterpret_cast<char*>( pointer ) - kAllocationHeader;
+    s_heapSize -= *reinterpret_cast<size_t*>( block );
+    free( block );
+}
+
+// ** operator delete[]
+void operator delete[]( void* pointer ) throw()
+{
+    operator delete( pointer );
+}
+
+DC_BEGIN_DREEMCHEST
+
+namespace Benchmark {
+
+// ** allocations
+u64 allocations( void )
+{
+    return s_allocations;
+}
+
+// ** heapSize
+u64 heapSize( void )
+{
+    return s_heapSize;
+}
+
+// ** heapPeak
+u64 heapPeak( void )
+{
+    return s_heapPeak;
+}
+
+// ** resetHeapPeak
+void resetHeapPeak( void )
+{
+    s_heapPeak = s_heapSize.load();
+}
+
+// ** cpuTime
+f64 cpuTime( void )
+{
+#if defined( DC_PLATFORM_WINDOWS )
+    return static_cast<f64>( clock() ) * 1000.0 / CLOCKS_PER_SEC;
+#else
+    rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 0.001;
+#endif  /*  DC_PLATFORM_WINDOWS */
+}
+
+// ** report
+void report( CString name, CString format, ... )
+{
+    va_list ap;
+    va_start( ap, format );
+
+    printf( "%-32s ", name );
+    vprintf( format, ap );
+    printf( "\n" );
+
+    va_end( ap );
+}
+
+// ** Samples::percentile
+f64 Samples::percentile( f64 value )
+{
+    if( m_values.empty() ) {
+        return 0.0;
+    }
+
+    std::sort( m_values.begin(), m_values.end() );
+    s32 index = static_cast<s32>( (value / 100.0) * (m_values.size() - 1) + 0.5 );
+    return m_values[index];
+}
+
+// ** Samples::mean
+f64 Samples::mean( void ) const
+{
+    if( m_values.empty() ) {
+        return 0.0;
+    }
+
+    f64 sum = 0.0;
+    for( s32 i = 0, n = size(); i < n; i++ ) {
+        sum += m_values[i];
+    }
+
+    return sum / m_values.size();
+}
+
+} // namespace Benchmark
+
+DC_END_DREEMCHEST
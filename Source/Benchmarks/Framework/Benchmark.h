@@ -0,0 +1,109 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Benchmarks_Benchmark_H__
+#define __DC_Benchmarks_Benchmark_H__
+
+#include <Dreemchest.h>
+
+#include <chrono>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Benchmark {
+
+    //! Returns the total number of heap allocations made by this process so far.
+    u64 allocations( void );
+
+    //! Returns the number of bytes currently allocated on a heap.
+    u64 heapSize( void );
+
+    //! Returns the maximum number of bytes allocated on a heap since the last peak reset.
+    u64 heapPeak( void );
+
+    //! Resets a heap peak to a current heap size.
+    void resetHeapPeak( void );
+
+    //! Returns the total amount of CPU time in milliseconds consumed by this process so far.
+    f64 cpuTime( void );
+
+    //! Prints a single benchmark result line to a console.
+    void report( CString name, CString format, ... );
+
+    //! A high resolution wall clock timer.
+    class Timer {
+    public:
+
+                    //! Constructs the Timer instance and starts it.
+                    Timer( void )
+                        : m_start( Clock::now() ) {}
+
+        //! Restarts the timer.
+        void        restart( void ) { m_start = Clock::now(); }
+
+        //! Returns the number of milliseconds elapsed since the timer was started.
+        f64         ms( void ) const { return std::chrono::duration<f64, std::milli>( Clock::now() - m_start ).count(); }
+
+        //! Returns the number of seconds elapsed since the timer was started.
+        f64         seconds( void ) const { return ms() * 0.001; }
+
+    private:
+
+        //! Clock type used by the timer.
+        typedef std::chrono::high_resolution_clock Clock;
+
+        Clock::time_point   m_start;    //!< The time point when the timer was started.
+    };
+
+    //! Accumulates samples and calculates percentiles.
+    class Samples {
+    public:
+
+        //! Adds a new sample.
+        void        push( f64 value ) { m_values.push_back( value ); }
+
+        //! Appends all samples from another instance.
+        void        merge( const Samples& other ) { m_values.insert( m_values.end(), other.m_values.begin(), other.m_values.end() ); }
+
+        //! Returns the total number of samples.
+        s32         size( void ) const { return static_cast<s32>( m_values.size() ); }
+
+        //! Returns the specified percentile (0..100) of recorded samples.
+        f64         percentile( f64 value );
+
+        //! Returns the mean sample value.
+        f64         mean( void ) const;
+
+    private:
+
+        Array<f64>  m_values;   //!< Recorded samples.
+    };
+
+} // namespace Benchmark
+
+DC_END_DREEMCHEST
+
+#endif  /*  !__DC_Benchmarks_Benchmark_H__  */
@@ -0,0 +1,205 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures the particle simulation throughput with a typical module stack and compares vectorized kernels against scalar loops.
+
+//! The total number of simulated particles.
+static const s32 kParticleCount = 1000000;
+
+//! The total number of simulated frames.
+static const s32 kFrameCount = 60;
+
+//! The simulation time step.
+static const f32 kTimeStep = 1.0f / 60.0f;
+
+//! Runs the particle simulation benchmark.
+class FxParticles {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        // Setup a particle system with a life time module stack
+        Fx::ParticleSystemPtr particleSystem( DC_NEW Fx::ParticleSystem );
+        Fx::ParticlesWPtr     particles = particleSystem->addEmitter()->addParticles();
+        particles->setCount( kParticleCount );
+
+        Fx::Size* size = DC_NEW Fx::Size;
+        size->get().setCurve( curve( 1.0f, 0.25f ) );
+        particles->addModule( size );
+
+        Fx::Transparency* transparency = DC_NEW Fx::Transparency;
+        transparency->get().setCurve( curve( 1.0f, 0.0f ) );
+        particles->addModule( transparency );
+
+        Fx::Color* color = DC_NEW Fx::Color;
+        color->get().setCurve( rgb( Rgb( 1.0f, 1.0f, 1.0f ), Rgb( 1.0f, 0.5f, 0.0f ) ) );
+        particles->addModule( color );
+
+        // Allocate and initialize particle data
+        Fx::Particle items;
+        items.allocate( kParticleCount );
+        initialize( items );
+
+        // Simulate particles using modules that evaluate curves
+        Benchmark::Timer timer;
+
+        for( s32 i = 0; i < kFrameCount; i++ ) {
+            particles->update( &items, 0, kParticleCount, kTimeStep );
+        }
+
+        f64 curves = timer.ms();
+
+        // Simulate particles using modules with baked lookup tables
+        particles->bake();
+        initialize( items );
+        timer.restart();
+
+        for( s32 i = 0; i < kFrameCount; i++ ) {
+            particles->update( &items, 0, kParticleCount, kTimeStep );
+        }
+
+        f64 modules = timer.ms();
+
+        // Simulate particles using scalar loops
+        initialize( items );
+        timer.restart();
+
+        for( s32 i = 0; i < kFrameCount; i++ ) {
+            scalar( items, kTimeStep );
+        }
+
+        f64 reference = timer.ms();
+
+        // Calculate particle bounds
+        timer.restart();
+        Bounds bounds;
+
+        for( s32 i = 0; i < kFrameCount; i++ ) {
+            bounds = Fx::Simd::bounds( items.position, items.size, kParticleCount );
+        }
+
+        f64 simdBounds = timer.ms();
+        timer.restart();
+
+        for( s32 i = 0; i < kFrameCount; i++ ) {
+            bounds = Bounds();
+
+            for( s32 j = 0; j < kParticleCount; j++ ) {
+                f32 s = fabsf( items.size[j].current );
+                bounds << items.position[j] - Vec3( s, s, s ) << items.position[j] + Vec3( s, s, s );
+            }
+        }
+
+        f64 scalarBounds = timer.ms();
+
+        f64 scale = 1000000.0 / (static_cast<f64>( kParticleCount ) * kFrameCount);
+        Benchmark::report( "FxParticles", "%d particles, %d SIMD lanes", kParticleCount, Fx::Simd::Width );
+        Benchmark::report( "FxParticles", "update: %.2f ns/particle (curves %.2f ns/particle, scalar arithmetic only %.2f ns/particle)", modules * scale, curves * scale, reference * scale );
+        Benchmark::report( "FxParticles", "bounds: %.2f ns/particle (scalar %.2f ns/particle)", simdBounds * scale, scalarBounds * scale );
+    }
+
+private:
+
+    //! Returns a linear float curve data.
+    static Fx::FloatArray curve( f32 from, f32 to )
+    {
+        Fx::FloatArray result;
+        result.push_back( 0.0f ); result.push_back( from );
+        result.push_back( 1.0f ); result.push_back( to );
+        return result;
+    }
+
+    //! Returns a linear color curve data.
+    static Fx::FloatArray rgb( const Rgb& from, const Rgb& to )
+    {
+        Fx::FloatArray result;
+        result.push_back( 0.0f ); result.push_back( from.r ); result.push_back( from.g ); result.push_back( from.b );
+        result.push_back( 1.0f ); result.push_back( to.r );   result.push_back( to.g );   result.push_back( to.b );
+        return result;
+    }
+
+    //! Fills particle arrays with initial values.
+    static void         initialize( Fx::Particle& items )
+    {
+        for( s32 i = 0; i < kParticleCount; i++ ) {
+            f32 t = static_cast<f32>( i ) / kParticleCount;
+
+            items.indices[i]                = i % Fx::FloatParameter::LifetimeRandomizationCount;
+            items.position[i]               = Vec3( t * 100.0f, 0.0f, -t * 100.0f );
+            items.velocity[i]               = Vec3( 0.0f, 0.0f, 0.0f );
+            items.rotation[i]               = 0.0f;
+            items.life[i].current           = items.life[i].initial = 2.0f + t;
+            items.life[i].scalar            = 0.0f;
+            items.size[i].current           = items.size[i].initial = 1.0f;
+            items.transparency[i].current   = items.transparency[i].initial = 1.0f;
+            items.color[i].current          = items.color[i].initial = Rgb( 1.0f, 1.0f, 1.0f );
+            items.force.velocity[i]         = Vec3( 0.0f, 5.0f, 0.0f );
+            items.force.acceleration[i]     = Vec3( 0.0f, -9.8f, 0.0f );
+        }
+    }
+
+    //! Performs the same simulation step with plain scalar loops and closed-form curves, a lower bound for the scalar module stack.
+    static void         scalar( Fx::Particle& items, f32 dt )
+    {
+        for( s32 i = 0; i < kParticleCount; i++ ) {
+            Fx::Particle::Life& life = items.life[i];
+            life.current -= dt;
+            life.scalar   = min2( 1.0f, 1.0f - life.current / life.initial );
+        }
+
+        for( s32 i = 0; i < kParticleCount; i++ ) {
+            items.force.velocity[i] += items.force.acceleration[i] * dt;
+            items.velocity[i]        = items.force.velocity[i];
+        }
+
+        for( s32 i = 0; i < kParticleCount; i++ ) {
+            items.position[i] += items.velocity[i] * dt;
+        }
+
+        for( s32 i = 0; i < kParticleCount; i++ ) {
+            f32 s = items.life[i].scalar;
+            items.size[i].current         = items.size[i].initial * (1.0f - 0.75f * s);
+            items.transparency[i].current = items.transparency[i].initial * (1.0f - s);
+            items.color[i].current        = items.color[i].initial * Rgb( 1.0f, 1.0f - 0.5f * s, 1.0f - s );
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    FxParticles benchmark;
+    benchmark.run();
+    return 0;
+}
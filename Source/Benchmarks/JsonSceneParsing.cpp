@@ -0,0 +1,136 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures load time and peak heap usage of parsing a large JSON scene file.
+
+//! The approximate size of a generated scene file in bytes.
+static const s32 kSceneSize = 50 * 1024 * 1024;
+
+//! Runs the JSON scene parsing benchmark.
+class JsonSceneParsing {
+public:
+
+                        JsonSceneParsing( void )
+                            : m_records( 0 ) {}
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        String json = generateScene();
+        f64    size = json.length() / (1024.0 * 1024.0);
+        u64    base = Benchmark::heapSize();
+
+        Benchmark::report( "JsonSceneParsing", "%.1f MB scene file", size );
+
+        // Parse a whole document to a Variant tree
+        {
+            Benchmark::resetHeapPeak();
+            Benchmark::Timer timer;
+            Variant document = Io::VariantTextStream::parse( json );
+            f64 time = timer.ms();
+
+            Benchmark::report( "JsonSceneParsing", "variant tree: %.1f ms, %.1f MB/s, peak heap %.1f MB", time, size / (time * 0.001), (Benchmark::heapPeak() - base) / (1024.0 * 1024.0) );
+        }
+
+        // Parse records one by one, the way a scene loader reads them
+        {
+            Benchmark::resetHeapPeak();
+            Benchmark::Timer timer;
+            m_records = 0;
+            Io::VariantTextStream::parseMembers( json.c_str(), static_cast<s32>( json.length() ), dcThisMethod( JsonSceneParsing::readRecord ) );
+            f64 time = timer.ms();
+
+            Benchmark::report( "JsonSceneParsing", "streamed records: %.1f ms, %.1f MB/s, peak heap %.1f MB, %d records", time, size / (time * 0.001), (Benchmark::heapPeak() - base) / (1024.0 * 1024.0), m_records );
+        }
+
+    #ifdef JSONCPP_FOUND
+        // Parse to a jsoncpp document and convert it to a Variant tree
+        {
+            Benchmark::resetHeapPeak();
+            Benchmark::Timer timer;
+            Json::Value  root;
+            Json::Reader reader;
+            reader.parse( json, root );
+            Variant document = Io::VariantTextStream::fromJson( root );
+            f64 time = timer.ms();
+
+            Benchmark::report( "JsonSceneParsing", "jsoncpp + variant: %.1f ms, %.1f MB/s, peak heap %.1f MB", time, size / (time * 0.001), (Benchmark::heapPeak() - base) / (1024.0 * 1024.0) );
+        }
+    #endif  /*  JSONCPP_FOUND   */
+    }
+
+private:
+
+    //! Counts a parsed record, the record value is released right after this call.
+    bool                readRecord( const String& id, const Variant& value )
+    {
+        m_records++;
+        return true;
+    }
+
+    //! Generates a scene file with scene objects, transforms and renderers.
+    static String       generateScene( void )
+    {
+        String json;
+        json.reserve( kSceneSize + 4096 );
+        json += "{\n";
+
+        char buffer[1024];
+
+        for( s32 i = 0; static_cast<s32>( json.length() ) < kSceneSize; i++ ) {
+            s32 length = sprintf( buffer
+                , "\"%d\": { \"class\": \"SceneObject\", \"name\": \"object%d\" },\n"
+                  "\"%d\": { \"class\": \"Transform\", \"sceneObject\": \"%d\", \"parent\": \"%d\", \"position\": [ %.4f, %.4f, %.4f ], \"rotation\": [ 0.0, 0.7071068, 0.0, 0.7071068 ], \"scale\": [ 1, 1, 1 ] },\n"
+                  "\"%d\": { \"class\": \"Renderer\", \"sceneObject\": \"%d\", \"asset\": \"meshes/object%d\", \"materials\": [ \"materials/default\", \"materials/detail\" ] },\n"
+                , i * 3, i
+                , i * 3 + 1, i * 3, i ? (i - 1) * 3 + 1 : 1, i * 0.25f, i * -0.5f, i * 1.0e-3f
+                , i * 3 + 2, i * 3, i % 100 );
+            json.append( buffer, length );
+        }
+
+        json += "\"end\": {}\n}\n";
+        return json;
+    }
+
+private:
+
+    s32                 m_records;  //!< The number of records read.
+};
+
+int main( int argc, char** argv )
+{
+    JsonSceneParsing benchmark;
+    benchmark.run();
+    return 0;
+}
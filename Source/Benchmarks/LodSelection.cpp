@@ -0,0 +1,122 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures level of detail selection for a large field of objects while a camera flies over it.
+
+//! The total number of objects along each axis.
+static const s32 kGridSize = 320;
+
+//! The distance between centers of neighbouring objects.
+static const f32 kGridSpacing = 4.0f;
+
+//! The total number of camera positions visited during each mode.
+static const s32 kIterations = 100;
+
+//! Runs the level of detail selection benchmark.
+class LodSelection {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Array<Bounds>                 bounds;
+        Array<const Scene::LodGroup*> groups;
+
+        Scene::LodGroup group;
+        group.addLevel( Scene::MeshHandle(), 0.1f );
+        group.addLevel( Scene::MeshHandle(), 0.03f );
+        group.addLevel( Scene::MeshHandle(), 0.01f );
+        group.addLevel( Scene::MeshHandle(), 0.003f );
+
+        for( s32 z = 0; z < kGridSize; z++ ) {
+            for( s32 x = 0; x < kGridSize; x++ ) {
+                Vec3 center = Vec3( x * kGridSpacing, 0.0f, z * kGridSpacing );
+                bounds.push_back( Bounds( center - Vec3( 1.0f, 1.0f, 1.0f ), center + Vec3( 1.0f, 1.0f, 1.0f ) ) );
+                groups.push_back( &group );
+            }
+        }
+
+        Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+        Scene::LodSelector      selector;
+
+        measure( "serial", selector, bounds, groups );
+
+        selector.reset();
+        selector.setTaskManager( taskManager );
+        measure( "parallel", selector, bounds, groups );
+    }
+
+private:
+
+    //! Selects levels of all objects from a sequence of camera positions.
+    void                measure( CString mode, Scene::LodSelector& selector, const Array<Bounds>& bounds, const Array<const Scene::LodGroup*>& groups )
+    {
+        Benchmark::Timer timer;
+        s32              count = static_cast<s32>( bounds.size() );
+        s32              levels[5] = { 0 };
+
+        Scene::LodSelector::View view;
+        view.scale       = 1.0f / tanf( radians( 30.0f ) );
+        view.perspective = true;
+
+        timer.restart();
+
+        for( s32 i = 0; i < kIterations; i++ ) {
+            f32 t = static_cast<f32>( i ) / kIterations;
+            view.position = Vec3( t * kGridSize * kGridSpacing, 20.0f, kGridSize * kGridSpacing * 0.5f );
+            selector.select( view, &bounds[0], &groups[0], count );
+        }
+
+        f64 time = timer.ms();
+
+        for( s32 i = 0; i < count; i++ ) {
+            levels[selector.state( i ).level]++;
+        }
+
+        Benchmark::report( "LodSelection", "%s: %.3f ms to select levels of %d objects, %d/%d/%d/%d levels, %d culled", mode
+                         , time / kIterations, count, levels[0], levels[1], levels[2], levels[3], levels[4] );
+    }
+};
+
+int main( int argc, char** argv )
+{
+    LodSelection benchmark;
+    benchmark.run();
+    return 0;
+}
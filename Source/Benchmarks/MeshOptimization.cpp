@@ -0,0 +1,172 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures mesh optimization passes on a bumpy grid with triangles in a shuffled order and reports cache miss ratios and vertex buffer sizes.
+
+//! The total number of quads along each side of a grid.
+static const s32 kGridSize = 250;
+
+//! The total number of iterations for each pass.
+static const s32 kIterations = 10;
+
+//! Runs the mesh optimization benchmark.
+class MeshOptimization {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Scene::Mesh::VertexBuffer vertices;
+        Array<u16>                indices;
+
+        generate( vertices, indices );
+
+        s32 vertexCount = static_cast<s32>( vertices.size() );
+        s32 indexCount  = static_cast<s32>( indices.size() );
+
+        Benchmark::report( "MeshOptimization", "input: %d vertices, %d triangles, ACMR %.3f", vertexCount, indexCount / 3, Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount ) );
+
+        // Vertex cache optimization
+        Benchmark::Timer timer;
+        Array<u16>       optimized;
+        f64              time = 0.0;
+
+        for( s32 i = 0; i < kIterations; i++ ) {
+            optimized = indices;
+            timer.restart();
+            Scene::MeshOptimizer::optimizeVertexCache( &optimized[0], indexCount, vertexCount );
+            time += timer.ms();
+        }
+
+        Benchmark::report( "MeshOptimization", "vertex cache: %.3f ms, ACMR %.3f", time / kIterations, Scene::MeshOptimizer::acmr( &optimized[0], indexCount, vertexCount ) );
+
+        // Overdraw optimization
+        Array<u16> sorted;
+        s32        clusters = 0;
+
+        time = 0.0;
+
+        for( s32 i = 0; i < kIterations; i++ ) {
+            sorted = optimized;
+            timer.restart();
+            clusters = Scene::MeshOptimizer::optimizeOverdraw( &sorted[0], indexCount, &vertices[0].position, sizeof( Scene::Mesh::Vertex ), vertexCount );
+            time += timer.ms();
+        }
+
+        Benchmark::report( "MeshOptimization", "overdraw: %.3f ms, %d clusters, ACMR %.3f", time / kIterations, clusters, Scene::MeshOptimizer::acmr( &sorted[0], indexCount, vertexCount ) );
+
+        // Vertex fetch optimization
+        Array<u16> remap;
+        timer.restart();
+        Scene::MeshOptimizer::optimizeVertexFetch( &sorted[0], indexCount, vertexCount, remap );
+        Scene::MeshOptimizer::remapVertices( vertices, remap );
+        Benchmark::report( "MeshOptimization", "vertex fetch: %.3f ms", timer.ms() );
+
+        // Vertex buffer sizes
+        measure( "float", vertices, 0 );
+        measure( "quantized", vertices, Renderer::VertexFormat::QuantizedPosition | Renderer::VertexFormat::OctahedralNormal | Renderer::VertexFormat::HalfTexCoord );
+    }
+
+private:
+
+    //! Generates a bumpy grid with triangles written in a shuffled order.
+    void                generate( Scene::Mesh::VertexBuffer& vertices, Array<u16>& indices )
+    {
+        for( s32 z = 0; z <= kGridSize; z++ ) {
+            for( s32 x = 0; x <= kGridSize; x++ ) {
+                Scene::Mesh::Vertex vertex;
+                vertex.position = Vec3( static_cast<f32>( x ), sinf( x * 0.1f ) * cosf( z * 0.1f ) * 5.0f, static_cast<f32>( z ) );
+                vertex.normal   = Vec3( 0.0f, 1.0f, 0.0f );
+                vertex.uv[0]    = Vec2( static_cast<f32>( x ) / kGridSize, static_cast<f32>( z ) / kGridSize );
+                vertex.uv[1]    = vertex.uv[0];
+                vertices.push_back( vertex );
+            }
+        }
+
+        Array<s32> order;
+
+        for( s32 i = 0; i < kGridSize * kGridSize; i++ ) {
+            order.push_back( i );
+        }
+
+        u32 seed = 12345;
+
+        for( s32 i = static_cast<s32>( order.size() ) - 1; i > 0; i-- ) {
+            seed = seed * 1103515245 + 12345;
+            std::swap( order[i], order[(seed >> 16) % (i + 1)] );
+        }
+
+        for( s32 i = 0, n = static_cast<s32>( order.size() ); i < n; i++ ) {
+            u16 a = static_cast<u16>( (order[i] / kGridSize) * (kGridSize + 1) + order[i] % kGridSize );
+            u16 b = static_cast<u16>( a + 1 );
+            u16 c = static_cast<u16>( a + kGridSize + 1 );
+            u16 d = static_cast<u16>( c + 1 );
+
+            indices.push_back( a ); indices.push_back( c ); indices.push_back( b );
+            indices.push_back( b ); indices.push_back( c ); indices.push_back( d );
+        }
+    }
+
+    //! Encodes vertices in a specified format and reports an encoding time and a buffer size.
+    void                measure( CString mode, const Scene::Mesh::VertexBuffer& vertices, u8 quantization )
+    {
+        Renderer::VertexFormat format( Renderer::VertexFormat::Normal | Renderer::VertexFormat::TexCoord0 | Renderer::VertexFormat::TexCoord1, quantization );
+
+        Bounds bounds;
+
+        for( s32 i = 0, n = static_cast<s32>( vertices.size() ); i < n; i++ ) {
+            bounds << vertices[i].position;
+        }
+
+        Array<u8> encoded;
+        encoded.resize( vertices.size() * format.vertexSize() );
+
+        Benchmark::Timer timer;
+        Scene::MeshOptimizer::encodeVertices( &vertices[0], static_cast<s32>( vertices.size() ), format, bounds, &encoded[0] );
+
+        Benchmark::report( "MeshOptimization", "%s: %.3f ms to encode, %d bytes per vertex, %u bytes", mode, timer.ms(), format.vertexSize(), static_cast<u32>( encoded.size() ) );
+    }
+};
+
+int main( int argc, char** argv )
+{
+    MeshOptimization benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,472 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+#include <atomic>
+
+DC_USE_DREEMCHEST
+
+// A headless load test for the Network module. Starts a single server application
+// and a configurable number of clients on 127.0.0.1 spread across worker threads,
+// each client drives a configurable mix of Event, RemoteCall and Ping packets.
+//
+// Usage: NetworkLoadTest [--clients N] [--threads N] [--duration SECONDS]
+//                        [--window N] [--mix EVENTS:CALLS:PINGS] [--port PORT]
+
+//! Load test configuration.
+struct Options {
+                        Options( void )
+                            : clients( 64 ), threads( 4 ), duration( 10 ), window( 32 ), events( 1 ), calls( 1 ), pings( 1 ), port( 20002 ) {}
+
+    s32                 clients;    //!< The total number of simulated clients.
+    s32                 threads;    //!< The number of threads that run clients.
+    s32                 duration;   //!< The load test duration in seconds.
+    s32                 window;     //!< The maximum number of requests in-flight per client.
+    s32                 events;     //!< Relative weight of Event packets in a traffic mix.
+    s32                 calls;      //!< Relative weight of RemoteCall packets in a traffic mix.
+    s32                 pings;      //!< Relative weight of Ping packets in a traffic mix.
+    u16                 port;       //!< The server port.
+};
+
+//! Returns the current time in microseconds truncated to 32 bits, used to timestamp packets.
+static u32 timestamp( void )
+{
+    static Benchmark::Timer timer;
+    return static_cast<u32>( timer.ms() * 1000.0 );
+}
+
+//! An event that is sent by clients to a server.
+struct LoadEvent : public Network::ReplicatedEvent<LoadEvent> {
+                        LoadEvent( u32 timestamp = 0 )
+                            : timestamp( timestamp ) {}
+
+    u32                 timestamp;  //!< The time when an event was sent.
+    u8                  data[32];   //!< Dummy event payload.
+
+    virtual void        serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
+    {
+        stream->write( &timestamp, sizeof( timestamp ) );
+        stream->write( data, sizeof( data ) );
+    }
+
+    virtual void        deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
+    {
+        stream->read( &timestamp, sizeof( timestamp ) );
+        stream->read( data, sizeof( data ) );
+    }
+};
+
+//! A remote call argument and response, the timestamp is echoed back to a caller.
+struct Echo : public Network::RemoteCallArgument<Echo> {
+                        Echo( u32 timestamp = 0 )
+                            : timestamp( timestamp ) {}
+
+    u32                 timestamp;  //!< The time when a call was sent.
+
+    virtual void        serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
+    {
+        stream->write( &timestamp, sizeof( timestamp ) );
+    }
+
+    virtual void        deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
+    {
+        stream->read( &timestamp, sizeof( timestamp ) );
+    }
+};
+
+//! Echoes the argument back to a caller.
+struct EchoCall : public Network::RemoteCall<EchoCall, Echo, Echo> {};
+
+//! Statistics collected by a single thread.
+struct Stats {
+                        Stats( void )
+                            : sent( 0 ), received( 0 ), errors( 0 ) {}
+
+    //! Merges statistics from another thread.
+    void                merge( const Stats& other )
+    {
+        sent     += other.sent;
+        received += other.received;
+        errors   += other.errors;
+        latency.merge( other.latency );
+    }
+
+    //! Records a latency sample in microseconds.
+    void                record( u32 sentAt ) { latency.push( static_cast<f64>( timestamp() - sentAt ) ); }
+
+    s64                 sent;       //!< The total number of packets sent.
+    s64                 received;   //!< The total number of responses received.
+    s64                 errors;     //!< The total number of failed requests.
+    Benchmark::Samples  latency;    //!< Latency samples in microseconds.
+};
+
+//! Runs a server application on a dedicated thread.
+class Server {
+public:
+
+                        Server( const Options& options )
+                            : m_options( options ), m_running( true ), m_reset( false ) {}
+
+    //! Starts the server thread.
+    void                start( void )
+    {
+        m_application = Network::ApplicationTCP::listen( m_options.port );
+        NIMBLE_ABORT_IF( !m_application.valid(), "failed to start a server" );
+
+        m_application->registerEvent<LoadEvent>();
+        m_application->subscribe<LoadEvent>( dcThisMethod( Server::handleLoadEvent ) );
+        m_application->registerRemoteProcedure<EchoCall>( dcThisMethod( Server::echo ) );
+
+        m_thread = Threads::Thread::create();
+        m_thread->start( dcThisMethod( Server::update ), NULL );
+    }
+
+    //! Stops the server thread.
+    void                stop( void )
+    {
+        m_running = false;
+        m_thread->wait();
+    }
+
+    //! Resets statistics on the server thread.
+    void                reset( void ) { m_reset = true; }
+
+    //! Returns server-side statistics.
+    const Stats&        stats( void ) const { return m_stats; }
+
+private:
+
+    //! Server thread function.
+    void                update( void* userData )
+    {
+        while( m_running ) {
+            if( m_reset ) {
+                m_stats = Stats();
+                m_reset = false;
+            }
+
+            m_application->update( 1 );
+        }
+    }
+
+    //! Handles an event sent by a client and records a one-way latency.
+    void                handleLoadEvent( const LoadEvent& e )
+    {
+        m_stats.received++;
+        m_stats.record( e.timestamp );
+    }
+
+    //! Echo remote procedure.
+    void                echo( Network::ConnectionWPtr connection, Network::Response<Echo>& response, const Echo& argument )
+    {
+        m_stats.received++;
+        response( argument );
+    }
+
+private:
+
+    const Options&              m_options;      //!< Load test options.
+    Network::ApplicationTCPPtr  m_application;  //!< Server application instance.
+    Threads::ThreadPtr          m_thread;       //!< Server thread.
+    std::atomic<bool>           m_running;      //!< Cleared when the server should stop.
+    std::atomic<bool>           m_reset;        //!< Set when statistics should be reset.
+    Stats                       m_stats;        //!< Server-side statistics.
+};
+
+//! A group of clients updated on a single thread.
+class ClientGroup {
+public:
+
+                        ClientGroup( const Options& options, s32 count, u32 seed )
+                            : m_options( options ), m_count( count ), m_seed( seed ), m_running( true ), m_reset( false ), m_connected( 0 ), m_current( NULL ) {}
+
+    //! Starts the client thread.
+    void                start( void )
+    {
+        m_thread = Threads::Thread::create();
+        m_thread->start( dcThisMethod( ClientGroup::update ), NULL );
+    }
+
+    //! Stops the client thread.
+    void                stop( void )
+    {
+        m_running = false;
+        m_thread->wait();
+    }
+
+    //! Returns the number of connected clients.
+    s32                 connected( void ) const { return m_connected; }
+
+    //! Returns client-side statistics.
+    const Stats&        stats( void ) const { return m_stats; }
+
+    //! Resets collected statistics, called once all clients are connected.
+    void                reset( void ) { m_reset = true; }
+
+private:
+
+    //! A single simulated client.
+    struct Client {
+        Network::ApplicationTCPPtr  application;    //!< Client application instance.
+        Network::ConnectionWPtr     connection;     //!< Connection to a server.
+        s32                         inFlight;       //!< The number of requests waiting for a response.
+    };
+
+    //! Client thread function.
+    void                update( void* userData )
+    {
+        // Connect all clients of this group
+        m_clients.resize( m_count );
+
+        for( s32 i = 0; i < m_count; i++ ) {
+            Client& client = m_clients[i];
+            client.inFlight    = 0;
+            client.application = Network::ApplicationTCP::connect( Network::Address::Localhost, m_options.port );
+            NIMBLE_ABORT_IF( !client.application.valid(), "failed to connect to a server" );
+
+            client.application->subscribe<Network::Application::Connected>( dcThisMethod( ClientGroup::handleConnected ) );
+            client.application->addPacketHandler< Network::PacketHandlerCallback<Network::Packets::Ping> >( dcThisMethod( ClientGroup::handlePing ) );
+        }
+
+        while( m_running ) {
+            if( m_reset ) {
+                m_stats = Stats();
+                m_reset = false;
+            }
+
+            for( s32 i = 0; i < m_count; i++ ) {
+                Client& client = m_clients[i];
+
+                if( client.connection.valid() ) {
+                    m_current = &client;
+                    send( client );
+                }
+
+                client.application->update( 1 );
+            }
+        }
+
+        m_clients.clear();
+    }
+
+    //! Sends packets until the client window is full.
+    void                send( Client& client )
+    {
+        s32 total = m_options.events + m_options.calls + m_options.pings;
+
+        while( client.inFlight < m_options.window ) {
+            s32 value = static_cast<s32>( random() % total );
+
+            if( value < m_options.events ) {
+                client.connection->emit( LoadEvent( timestamp() ) );
+                m_stats.sent++;
+                break;  // Events are not acknowledged, so send at most one per update
+            }
+            else if( value < m_options.events + m_options.calls ) {
+                client.connection->invoke<EchoCall>( Echo( timestamp() ), dcThisMethod( ClientGroup::handleEcho ) );
+            }
+            else {
+                client.connection->send<Network::Packets::Ping>( 1, timestamp(), client.connection->time() );
+            }
+
+            client.inFlight++;
+            m_stats.sent++;
+        }
+    }
+
+    //! A linear congruential generator used to choose packet types.
+    u32                 random( void )
+    {
+        m_seed = m_seed * 1664525 + 1013904223;
+        return m_seed >> 8;
+    }
+
+    //! Handles a client connection.
+    void                handleConnected( const Network::Application::Connected& e )
+    {
+        for( s32 i = 0; i < m_count; i++ ) {
+            if( m_clients[i].application.get() == e.sender.get() ) {
+                m_clients[i].connection = e.connection;
+            }
+        }
+
+        m_connected++;
+    }
+
+    //! Handles an echo response.
+    bool                handleEcho( Network::ConnectionWPtr connection, const Network::Error& error, const Echo& result )
+    {
+        if( error ) {
+            m_stats.errors++;
+        }
+
+        m_current->inFlight--;
+        m_stats.received++;
+        m_stats.record( result.timestamp );
+        return true;
+    }
+
+    //! Handles a ping response.
+    void                handlePing( Network::ConnectionWPtr connection, const Network::Packets::Ping& packet )
+    {
+        if( packet.iterations ) {
+            return;
+        }
+
+        m_current->inFlight--;
+        m_stats.received++;
+        m_stats.record( packet.timestamp );
+    }
+
+private:
+
+    const Options&      m_options;      //!< Load test options.
+    s32                 m_count;        //!< The number of clients in this group.
+    u32                 m_seed;         //!< Random number generator state.
+    std::atomic<bool>   m_running;      //!< Cleared when clients should stop.
+    std::atomic<bool>   m_reset;        //!< Set when statistics should be reset.
+    std::atomic<s32>    m_connected;    //!< The number of connected clients.
+    Array<Client>       m_clients;      //!< Simulated clients.
+    Client*             m_current;      //!< The client being updated, responses are dispatched during it's update.
+    Threads::ThreadPtr  m_thread;       //!< Client thread.
+    Stats               m_stats;        //!< Client-side statistics.
+};
+
+//! Parses command line arguments.
+static Options parseOptions( int argc, char** argv )
+{
+    Options options;
+
+    for( s32 i = 1; i + 1 < argc; i += 2 ) {
+        String key   = argv[i];
+        CString value = argv[i + 1];
+
+        if( key == "--clients" ) {
+            options.clients = atoi( value );
+        }
+        else if( key == "--threads" ) {
+            options.threads = atoi( value );
+        }
+        else if( key == "--duration" ) {
+            options.duration = atoi( value );
+        }
+        else if( key == "--window" ) {
+            options.window = atoi( value );
+        }
+        else if( key == "--port" ) {
+            options.port = static_cast<u16>( atoi( value ) );
+        }
+        else if( key == "--mix" ) {
+            sscanf( value, "%d:%d:%d", &options.events, &options.calls, &options.pings );
+        }
+        else {
+            printf( "unknown option %s\n", key.c_str() );
+        }
+    }
+
+    options.threads = max2( 1, min2( options.threads, options.clients ) );
+    options.window  = max2( 1, options.window );
+    NIMBLE_ABORT_IF( options.events + options.calls + options.pings <= 0, "the traffic mix should not be empty" );
+
+    return options;
+}
+
+int main( int argc, char** argv )
+{
+    Options          options = parseOptions( argc, argv );
+    Network::Network network;
+
+    // Start the server
+    Server server( options );
+    server.start();
+
+    // Spread clients across threads
+    Array<ClientGroup*> groups;
+
+    for( s32 i = 0; i < options.threads; i++ ) {
+        s32 count = options.clients / options.threads + (i < options.clients % options.threads ? 1 : 0);
+        groups.push_back( new ClientGroup( options, count, 12345 + i ) );
+        groups.back()->start();
+    }
+
+    // Wait for all clients to connect
+    for( s32 connected = 0; connected < options.clients; ) {
+        Threads::Thread::sleep( 10 );
+
+        connected = 0;
+        for( s32 i = 0; i < options.threads; i++ ) {
+            connected += groups[i]->connected();
+        }
+    }
+
+    // Reset the warm-up statistics and run the load test
+    server.reset();
+
+    for( s32 i = 0; i < options.threads; i++ ) {
+        groups[i]->reset();
+    }
+
+    u64              allocations = Benchmark::allocations();
+    f64              cpu         = Benchmark::cpuTime();
+    Benchmark::Timer timer;
+
+    Threads::Thread::sleep( options.duration * 1000 );
+
+    f64 seconds = timer.seconds();
+    cpu         = Benchmark::cpuTime() - cpu;
+    allocations = Benchmark::allocations() - allocations;
+
+    // Stop all threads
+    for( s32 i = 0; i < options.threads; i++ ) {
+        groups[i]->stop();
+    }
+    server.stop();
+
+    // Merge statistics
+    Stats clients;
+    for( s32 i = 0; i < options.threads; i++ ) {
+        clients.merge( groups[i]->stats() );
+        delete groups[i];
+    }
+
+    Stats events = server.stats();
+    s64   packets = clients.sent + clients.received;
+
+    Benchmark::report( "NetworkLoadTest", "%d clients, %d threads, mix %d:%d:%d, window %d, %.1fs"
+                      , options.clients, options.threads, options.events, options.calls, options.pings, options.window, seconds );
+    Benchmark::report( "  throughput", "%.0f packets/s (%lld sent, %lld responses, %lld errors)", packets / seconds, clients.sent, clients.received, clients.errors );
+    Benchmark::report( "  round-trip latency", "p50 %.0fus, p99 %.0fus (%d samples)", clients.latency.percentile( 50 ), clients.latency.percentile( 99 ), clients.latency.size() );
+    Benchmark::report( "  event latency", "p50 %.0fus, p99 %.0fus (%d samples)", events.latency.percentile( 50 ), events.latency.percentile( 99 ), events.latency.size() );
+    Benchmark::report( "  cpu time", "%.0fms (%.2f cores)", cpu, cpu / (seconds * 1000.0) );
+    Benchmark::report( "  allocations", "%.2f per packet", packets ? static_cast<f64>( allocations ) / packets : 0.0 );
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures the throughput of pipelined remote calls over a loopback TCP connection.
+
+//! The total number of remote calls to perform.
+static const s32 kTotalCalls = 200000;
+
+//! The maximum number of calls that are in-flight at the same time.
+static const s32 kMaxInFlight = 512;
+
+//! The port used by a benchmark server.
+static const u16 kPort = 20001;
+
+//! Remote procedure argument.
+struct AddArgument : public Network::RemoteCallArgument<AddArgument> {
+                        AddArgument( s32 a = 0, s32 b = 0 )
+                            : a( a ), b( b ) {}
+
+    s32                 a;
+    s32                 b;
+
+    virtual void        serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
+    {
+        stream->write( &a, sizeof( a ) );
+        stream->write( &b, sizeof( b ) );
+    }
+
+    virtual void        deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
+    {
+        stream->read( &a, sizeof( a ) );
+        stream->read( &b, sizeof( b ) );
+    }
+};
+
+//! Remote procedure response.
+struct AddResult : public Network::RemoteCallResponse<AddResult> {
+                        AddResult( s32 sum = 0 )
+                            : sum( sum ) {}
+
+    s32                 sum;
+
+    virtual void        serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
+    {
+        stream->write( &sum, sizeof( sum ) );
+    }
+
+    virtual void        deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
+    {
+        stream->read( &sum, sizeof( sum ) );
+    }
+};
+
+//! Adds two integers on a remote side.
+struct Add : public Network::RemoteCall<Add, AddArgument, AddResult> {};
+
+//! Runs a client and a server on the same thread and pumps both until all calls are completed.
+class RemoteCalls {
+public:
+
+                        RemoteCalls( void )
+                            : m_sent( 0 ), m_completed( 0 ), m_errors( 0 ) {}
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Network::Network network;
+
+        // Launch the server and register a remote procedure
+        m_server = Network::ApplicationTCP::listen( kPort );
+        NIMBLE_ABORT_IF( !m_server.valid(), "failed to start a server" );
+        m_server->registerRemoteProcedure<Add>( dcThisMethod( RemoteCalls::add ) );
+
+        // Connect the client
+        m_client = Network::ApplicationTCP::connect( Network::Address::Localhost, kPort );
+        NIMBLE_ABORT_IF( !m_client.valid(), "failed to connect to a server" );
+        m_client->subscribe<Network::Application::Connected>( dcThisMethod( RemoteCalls::handleConnected ) );
+
+        // Wait for a connection to be established
+        while( !m_connection.valid() ) {
+            pump();
+        }
+
+        // Warm up, so the allocations of lazily created objects are not counted
+        invoke( kMaxInFlight );
+        while( m_completed < m_sent ) {
+            pump();
+        }
+
+        m_sent = m_completed = 0;
+
+        // Now run the benchmark
+        u64              allocations = Benchmark::allocations();
+        Benchmark::Timer timer;
+
+        while( m_completed < kTotalCalls ) {
+            invoke( min2( kMaxInFlight - (m_sent - m_completed), kTotalCalls - m_sent ) );
+            pump();
+        }
+
+        f64 seconds = timer.seconds();
+        allocations = Benchmark::allocations() - allocations;
+
+        Benchmark::report( "RemoteCalls", "%d calls, %d in-flight, %.0f calls/s, %.2f allocations/call, %d errors"
+                          , kTotalCalls, kMaxInFlight, kTotalCalls / seconds, static_cast<f64>( allocations ) / kTotalCalls, m_errors );
+    }
+
+private:
+
+    //! Sends the specified number of calls.
+    void                invoke( s32 count )
+    {
+        for( s32 i = 0; i < count; i++, m_sent++ ) {
+            m_connection->invoke<Add>( AddArgument( m_sent, 1 ), dcThisMethod( RemoteCalls::handleResponse ) );
+        }
+    }
+
+    //! Updates both client and server.
+    void                pump( void )
+    {
+        m_server->update( 0 );
+        m_client->update( 0 );
+    }
+
+    //! Server-side remote procedure.
+    void                add( Network::ConnectionWPtr connection, Network::Response<AddResult>& response, const AddArgument& argument )
+    {
+        response( AddResult( argument.a + argument.b ) );
+    }
+
+    //! Client-side response handler.
+    bool                handleResponse( Network::ConnectionWPtr connection, const Network::Error& error, const AddResult& result )
+    {
+        if( error ) {
+            m_errors++;
+        }
+
+        m_completed++;
+        return true;
+    }
+
+    //! Stores the client connection once it is established.
+    void                handleConnected( const Network::Application::Connected& e )
+    {
+        m_connection = e.connection;
+    }
+
+private:
+
+    Network::ApplicationTCPPtr  m_server;       //!< Server application.
+    Network::ApplicationTCPPtr  m_client;       //!< Client application.
+    Network::ConnectionWPtr     m_connection;   //!< Client connection to a server.
+    s32                         m_sent;         //!< The total number of calls sent.
+    s32                         m_completed;    //!< The total number of responses received.
+    s32                         m_errors;       //!< The total number of error responses.
+};
+
+int main( int argc, char** argv )
+{
+    RemoteCalls benchmark;
+    benchmark.run();
+    return 0;
+}
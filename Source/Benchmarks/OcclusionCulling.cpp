@@ -0,0 +1,128 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures occluder rasterization and bounding box tests for a camera standing on a street of a dense city block.
+
+//! The total number of buildings along each axis.
+static const s32 kBlockCount = 32;
+
+//! The distance between centers of neighbouring buildings.
+static const f32 kBlockSpacing = 20.0f;
+
+//! The total number of small objects placed around each building.
+static const s32 kObjectsPerBlock = 16;
+
+//! The total number of iterations for each mode.
+static const s32 kIterations = 100;
+
+//! Runs the occlusion culling benchmark.
+class OcclusionCulling {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Array<Bounds> buildings;
+        Array<Bounds> objects;
+
+        // Buildings are occluders, and small objects are scattered in streets between them
+        for( s32 z = 0; z < kBlockCount; z++ ) {
+            for( s32 x = 0; x < kBlockCount; x++ ) {
+                f32 cx = (x - kBlockCount / 2) * kBlockSpacing + kBlockSpacing * 0.5f;
+                f32 cz = -z * kBlockSpacing - kBlockSpacing;
+                f32 h  = 10.0f + ((x * 7 + z * 13) % 5) * 8.0f;
+
+                buildings.push_back( Bounds( Vec3( cx - 7.0f, 0.0f, cz - 7.0f ), Vec3( cx + 7.0f, h, cz + 7.0f ) ) );
+
+                for( s32 i = 0; i < kObjectsPerBlock; i++ ) {
+                    f32 ox = cx + ((i % 4) - 1.5f) * 4.5f;
+                    f32 oz = cz + ((i / 4) - 1.5f) * 4.5f;
+                    objects.push_back( Bounds( Vec3( ox - 0.5f, 0.0f, oz - 0.5f ), Vec3( ox + 0.5f, 1.0f, oz + 0.5f ) ) );
+                }
+            }
+        }
+
+        Matrix4 viewProjection = Matrix4::perspective( 60.0f, 2.0f, 0.1f, 1000.0f ) * Matrix4::lookAt( Vec3( 0.0f, 1.7f, 0.0f ), Vec3( 0.0f, 1.7f, -1.0f ), Vec3::axisY() );
+
+        Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+        Scene::OcclusionCuller  culler;
+
+        measure( "serial", culler, viewProjection, buildings, objects );
+
+        culler.setTaskManager( taskManager );
+        measure( "parallel", culler, viewProjection, buildings, objects );
+    }
+
+private:
+
+    //! Rasterizes buildings and tests objects against them a specified number of times.
+    void                measure( CString mode, Scene::OcclusionCuller& culler, const Matrix4& viewProjection, const Array<Bounds>& buildings, const Array<Bounds>& objects )
+    {
+        Benchmark::Timer timer;
+        Array<s32>       visible;
+        f64              rasterization = 0.0;
+        f64              tests         = 0.0;
+
+        for( s32 i = 0; i < kIterations; i++ ) {
+            timer.restart();
+
+            culler.begin( viewProjection );
+
+            for( s32 j = 0, n = static_cast<s32>( buildings.size() ); j < n; j++ ) {
+                culler.addOccluder( buildings[j] );
+            }
+
+            culler.rasterize();
+            rasterization += timer.ms();
+
+            timer.restart();
+            culler.cull( &objects[0], static_cast<s32>( objects.size() ), visible );
+            tests += timer.ms();
+        }
+
+        Benchmark::report( "OcclusionCulling", "%s: %.3f ms to rasterize %d triangles, %.3f ms to test %u boxes, %u visible", mode
+                         , rasterization / kIterations, culler.triangleCount(), tests / kIterations, static_cast<u32>( objects.size() ), static_cast<u32>( visible.size() ) );
+    }
+};
+
+int main( int argc, char** argv )
+{
+    OcclusionCulling benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,169 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures the reflection serializer throughput on a large number of components for key-value and binary targets.
+
+//! The total number of serialized components.
+static const s32 kComponentCount = 100000;
+
+//! A reflected component with a typical mix of property types.
+class Body {
+
+    INTROSPECTION( Body
+        , PROPERTY( name, name, setName, "The body name." )
+        , PROPERTY( position, position, setPosition, "The body position." )
+        , PROPERTY( rotation, rotation, setRotation, "The body rotation." )
+        , PROPERTY( mass, mass, setMass, "The body mass." )
+        , PROPERTY( flags, flags, setFlags, "The body flags." )
+        , PROPERTY( isKinematic, isKinematic, setKinematic, "Indicates that a body is kinematic." )
+        )
+
+public:
+
+                            Body( void )
+                                : m_mass( 1.0f ), m_flags( 0 ), m_isKinematic( false ) {}
+
+    const String&           name( void ) const { return m_name; }
+    void                    setName( const String& value ) { m_name = value; }
+    const Vec3&             position( void ) const { return m_position; }
+    void                    setPosition( const Vec3& value ) { m_position = value; }
+    const Quat&             rotation( void ) const { return m_rotation; }
+    void                    setRotation( const Quat& value ) { m_rotation = value; }
+    f32                     mass( void ) const { return m_mass; }
+    void                    setMass( f32 value ) { m_mass = value; }
+    u32                     flags( void ) const { return m_flags; }
+    void                    setFlags( u32 value ) { m_flags = value; }
+    bool                    isKinematic( void ) const { return m_isKinematic; }
+    void                    setKinematic( bool value ) { m_isKinematic = value; }
+
+private:
+
+    String                  m_name;
+    Vec3                    m_position;
+    Quat                    m_rotation;
+    f32                     m_mass;
+    u32                     m_flags;
+    bool                    m_isKinematic;
+};
+
+//! Runs the reflection serializer benchmark.
+class ReflectionSerializer {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Array<Body> bodies( kComponentCount );
+
+        for( s32 i = 0; i < kComponentCount; i++ ) {
+            bodies[i].setName( "body" );
+            bodies[i].setPosition( Vec3( static_cast<f32>( i ), 0.0f, 0.0f ) );
+            bodies[i].setMass( 1.0f + i % 10 );
+            bodies[i].setFlags( i );
+        }
+
+        Reflection::Serializer serializer;
+        Array<KeyValue>        archives( kComponentCount );
+        Benchmark::Timer       timer;
+
+        // Walk class members for each instance the same way a serializer did before plans were introduced
+        for( s32 i = 0; i < kComponentCount; i++ ) {
+            memberWalk( bodies[i].metaInstance(), archives[i] );
+        }
+        f64 walk = timer.ms();
+
+        // Serialize to key-value storages
+        timer.restart();
+        for( s32 i = 0; i < kComponentCount; i++ ) {
+            serializer.serialize( bodies[i].metaInstance(), archives[i] );
+        }
+        f64 keyValueWrite = timer.ms();
+
+        timer.restart();
+        for( s32 i = 0; i < kComponentCount; i++ ) {
+            serializer.deserialize( bodies[i].metaInstance(), archives[i] );
+        }
+        f64 keyValueRead = timer.ms();
+
+        // Serialize to a single binary stream
+        Io::ByteBufferPtr stream = Io::ByteBuffer::create();
+
+        timer.restart();
+        for( s32 i = 0; i < kComponentCount; i++ ) {
+            serializer.serialize( bodies[i].metaInstance(), stream.get() );
+        }
+        f64 binaryWrite = timer.ms();
+
+        stream->setPosition( 0 );
+
+        timer.restart();
+        for( s32 i = 0; i < kComponentCount; i++ ) {
+            serializer.deserialize( bodies[i].metaInstance(), stream.get() );
+        }
+        f64 binaryRead = timer.ms();
+
+        f64 scale = 1000000.0 / kComponentCount;
+
+        Benchmark::report( "ReflectionSerializer", "%d components, %d bytes in a binary stream", kComponentCount, stream->length() );
+        Benchmark::report( "ReflectionSerializer", "key-value: write %.1f ns/component (member walk %.1f ns/component), read %.1f ns/component", keyValueWrite * scale, walk * scale, keyValueRead * scale );
+        Benchmark::report( "ReflectionSerializer", "binary: write %.1f ns/component, read %.1f ns/component", binaryWrite * scale, binaryRead * scale );
+    }
+
+private:
+
+    //! Writes instance properties by inspecting class members and converting all values through a Variant.
+    static void         memberWalk( Reflection::InstanceConst instance, KeyValue& ar )
+    {
+        const Reflection::Class* cls = instance.type();
+
+        ar.setValueAtKey( "class", Variant::fromValue( cls->name() ) );
+
+        for( s32 i = 0, n = cls->memberCount(); i < n; i++ ) {
+            const Reflection::Property* property = cls->member( i )->isProperty();
+
+            if( !property || property->iterator( instance ).get() ) {
+                continue;
+            }
+
+            ar.setValueAtKey( property->name(), property->serialize( instance ) );
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    ReflectionSerializer benchmark;
+    benchmark.run();
+    return 0;
+}
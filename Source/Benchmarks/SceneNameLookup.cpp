@@ -0,0 +1,131 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Compares scene object lookups by name through a string scan against an interned name index.
+
+//! The total number of scene objects.
+static const s32 kObjectCount = 100000;
+
+//! The total number of distinct names.
+static const s32 kNameCount = 10000;
+
+//! Runs the scene name lookup benchmark.
+class SceneNameLookup {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Scene::ScenePtr scene = Scene::Scene::create();
+        char            name[64];
+
+        for( s32 i = 0; i < kObjectCount; i++ ) {
+            sprintf( name, "level/objects/object%d", i % kNameCount );
+            Scene::SceneObjectPtr sceneObject = scene->createSceneObject();
+            sceneObject->attach<Scene::Identifier>( name );
+            scene->addSceneObject( sceneObject );
+        }
+
+        Benchmark::report( "SceneNameLookup", "%d scene objects, %d distinct names", kObjectCount, kNameCount );
+
+        // Compare a name with each named scene object, the way lookups were done before the name index
+        {
+            Ecs::EntityArray objects = scene->ecs()->entities();
+            s32 lookups = 100;
+            s32 found   = 0;
+
+            Benchmark::Timer timer;
+
+            for( s32 i = 0; i < lookups; i++ ) {
+                sprintf( name, "level/objects/object%d", (i * 7919) % kNameCount );
+                String value = name;
+
+                for( s32 j = 0; j < kObjectCount; j++ ) {
+                    if( objects[j]->get<Scene::Identifier>()->name() == value ) {
+                        found++;
+                    }
+                }
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "SceneNameLookup", "string scan: %.4f ms per lookup, %d objects found", time / lookups, found );
+        }
+
+        // Look scene objects up through an interned name index
+        {
+            s32 lookups = 100000;
+            s32 found   = 0;
+
+            Benchmark::Timer timer;
+
+            for( s32 i = 0; i < lookups; i++ ) {
+                sprintf( name, "level/objects/object%d", (i * 7919) % kNameCount );
+                found += static_cast<s32>( scene->findAllWithName( name ).size() );
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "SceneNameLookup", "name index: %.4f ms per lookup, %d objects found", time / lookups, found );
+        }
+
+        // Look scene objects up by a previously interned name id
+        {
+            Array<Ecs::NameId> ids;
+
+            for( s32 i = 0; i < kNameCount; i++ ) {
+                sprintf( name, "level/objects/object%d", i );
+                ids.push_back( Ecs::NameTable::find( name ) );
+            }
+
+            s32 lookups = 100000;
+            s32 found   = 0;
+
+            Benchmark::Timer timer;
+
+            for( s32 i = 0; i < lookups; i++ ) {
+                found += static_cast<s32>( scene->findAllWithName( ids[(i * 7919) % kNameCount] ).size() );
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "SceneNameLookup", "name id: %.4f ms per lookup, %d objects found", time / lookups, found );
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    SceneNameLookup benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include sound driver headers.
+#include <Sound/Drivers/Mixer/Mixer.h>
+#include <Sound/Drivers/SoundSource.h>
+#include <Sound/Decoders/SoundDecoder.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures the software mixer throughput by rendering many spatialized voices offline.
+
+//! The total number of simultaneously playing voices.
+static const s32 kVoiceCount = 128;
+
+//! The number of rendered seconds.
+static const s32 kSeconds = 10;
+
+//! The length of a test sound in frames.
+static const u32 kSoundFrames = 44100;
+
+//! Runs the software mixer benchmark.
+class SoundMixer {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Sound::MixerPtr mixer = DC_NEW Sound::Mixer;
+        mixer->initialize();
+
+        // Start looped voices with different pitches and positions, every second voice is streamed
+        Io::ByteBufferPtr            wav = sine( kSoundFrames );
+        Array<Sound::SoundSourcePtr> sources;
+
+        for( s32 i = 0; i < kVoiceCount; i++ ) {
+            Sound::SoundDecoderPtr decoder = mixer->createSoundDecoder( DC_NEW Sound::MemorySoundStream( wav->copy() ), Sound::SoundFormatWav );
+            Sound::SoundSourcePtr  source  = mixer->createSource();
+
+            source->setBuffer( mixer->createBuffer( decoder, i % 2 ? 3 : 1 ) );
+            source->setLooped( true );
+            source->setPitch( 0.5f + 1.5f * i / kVoiceCount );
+            source->setVolume( 1.0f / kVoiceCount );
+            source->setPosition( Vec3( static_cast<f32>( i % 16 ), 0.0f, static_cast<f32>( i / 16 ) ) );
+            source->setState( Sound::SoundSource::Playing );
+            sources.push_back( source );
+        }
+
+        // Render to memory
+        u32               frames = mixer->rate() * kSeconds;
+        Io::ByteBufferPtr output = Io::ByteBuffer::create();
+
+        Benchmark::Timer timer;
+        mixer->renderToWav( output.get(), frames );
+        f64 elapsed = timer.ms();
+
+        Benchmark::report( "SoundMixer", "%d voices, %d seconds rendered in %.2f ms (%.1fx real time)", kVoiceCount, kSeconds, elapsed, kSeconds * 1000.0 / elapsed );
+        Benchmark::report( "SoundMixer", "%.1f voices/ms (%d frames each), %.2f ns/sample", mixer->mixedVoices() / elapsed, Sound::Mixer::BlockFrames, elapsed * 1000000.0 / ( f64( frames ) * kVoiceCount ) );
+    }
+
+private:
+
+    //! Creates a mono 16-bit WAV file with a sine wave.
+    static Io::ByteBufferPtr sine( u32 frames )
+    {
+        Io::ByteBufferPtr wav = Io::ByteBuffer::create();
+
+        u32 dataSize    = frames * 2;
+        u32 fileSize    = dataSize + 36;
+        u32 formatSize  = 16;
+        u16 formatTag   = 1;
+        u16 channels    = 1;
+        u32 rate        = Sound::Mixer::DefaultRate;
+        u32 byteRate    = rate * 2;
+        u16 blockAlign  = 2;
+        u16 bits        = 16;
+
+        wav->write( "RIFF", 4 );
+        wav->write( &fileSize, 4 );
+        wav->write( "WAVE", 4 );
+        wav->write( "fmt ", 4 );
+        wav->write( &formatSize, 4 );
+        wav->write( &formatTag, 2 );
+        wav->write( &channels, 2 );
+        wav->write( &rate, 4 );
+        wav->write( &byteRate, 4 );
+        wav->write( &blockAlign, 2 );
+        wav->write( &bits, 2 );
+        wav->write( "data", 4 );
+        wav->write( &dataSize, 4 );
+
+        for( u32 i = 0; i < frames; i++ ) {
+            s16 value = static_cast<s16>( sinf( i * 440.0f * 6.2831853f / rate ) * 32767.0f );
+            wav->write( &value, 2 );
+        }
+
+        wav->setPosition( 0 );
+        return wav;
+    }
+};
+
+int main( int argc, char** argv )
+{
+    SoundMixer benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,191 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures the cost of a brush stroke applied to a terrain and compares incremental rebuilds with a full one.
+
+//! The terrain size.
+static const s32 kTerrainSize = 2048;
+
+//! The total number of brush edits.
+static const s32 kEditCount = 200;
+
+//! The brush radius in heightmap vertices.
+static const s32 kBrushRadius = 16;
+
+//! Generates rolling hills.
+class Hills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.05f ) * cosf( z * 0.03f ) );
+    }
+};
+
+//! Generates a mesh asset from a terrain.
+class TerrainMeshSource : public Assets::GeneratorSource<Scene::Mesh> {
+public:
+
+                        TerrainMeshSource( const Scene::Terrain& terrain )
+                            : m_terrain( terrain ) {}
+
+protected:
+
+    virtual bool        generate( Assets::Assets& assets, Scene::Mesh& mesh ) NIMBLE_OVERRIDE
+    {
+        mesh = m_terrain.createMesh();
+        return true;
+    }
+
+private:
+
+    const Scene::Terrain&   m_terrain;
+};
+
+//! Runs the terrain brush stroke benchmark.
+class TerrainBrushStroke {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Scene::Terrain terrain( kTerrainSize );
+        terrain.heightmap().set( DC_NEW Hills );
+
+        // A terrain mesh is an asset cached by a render cache, so edited chunks are uploaded like in an editor
+        Assets::AssetsPtr             assets( DC_NEW Assets::Assets );
+        Renderer::RenderingContextPtr context = Renderer::createNullRenderingContext();
+        Scene::RenderCachePtr         cache   = Scene::TestRenderCache::create( assets, context );
+        Scene::MeshHandle             mesh    = assets->add<Scene::Mesh>( "terrain", DC_NEW TerrainMeshSource( terrain ) );
+
+        Benchmark::Timer timer;
+        assets->forceLoad( mesh );
+        f64 fullRebuild = timer.ms();
+
+        cache->requestVertexBuffer( mesh );
+        context->display( context->allocateFrame() );
+
+        Scene::TerrainQuadTree  quadTree( terrain );
+        Scene::TerrainRayCaster caster( terrain );
+        terrain.heightmap().clearDirtyRegions();
+
+        f64 brushTime   = 0.0;
+        f64 meshTime    = 0.0;
+        f64 uploadTime  = 0.0;
+        f64 lodTime     = 0.0;
+        f64 casterTime  = 0.0;
+        s32 chunks      = 0;
+
+        for( s32 i = 0; i < kEditCount; i++ ) {
+            // Move a brush along a diagonal stroke
+            s32 cx = kBrushRadius + (i * 7) % (kTerrainSize - kBrushRadius * 2);
+            s32 cz = kBrushRadius + (i * 5) % (kTerrainSize - kBrushRadius * 2);
+
+            timer.restart();
+            raise( terrain.heightmap(), cx, cz );
+            brushTime += timer.ms();
+
+            const Scene::Heightmap::Regions& regions = terrain.heightmap().dirtyRegions();
+
+            timer.restart();
+            Array<s32> updated;
+            {
+                Assets::WriteLock<Scene::Mesh> locked = mesh.writeLock();
+                updated = terrain.updateMesh( *locked, regions );
+            }
+            chunks += static_cast<s32>( updated.size() );
+            meshTime += timer.ms();
+
+            // Upload changed vertex ranges and flush them through a rendering context
+            timer.restart();
+            terrain.uploadChunks( mesh, updated, cache );
+            context->display( context->allocateFrame() );
+            uploadTime += timer.ms();
+
+            timer.restart();
+            for( s32 j = 0, n = static_cast<s32>( regions.size() ); j < n; j++ ) {
+                quadTree.updateHeightBounds( regions[j].x, regions[j].z, regions[j].width, regions[j].height );
+            }
+            lodTime += timer.ms();
+
+            timer.restart();
+            for( s32 j = 0, n = static_cast<s32>( regions.size() ); j < n; j++ ) {
+                caster.update( regions[j].x, regions[j].z, regions[j].width, regions[j].height );
+            }
+            casterTime += timer.ms();
+
+            terrain.heightmap().clearDirtyRegions();
+        }
+
+        f64 total = brushTime + meshTime + uploadTime + lodTime + casterTime;
+        f64 uploadedKb = static_cast<f64>( chunks ) * (Scene::Terrain::kChunkSize + 1) * (Scene::Terrain::kChunkSize + 1) * sizeof( Scene::Mesh::Vertex ) / 1024.0;
+
+        Benchmark::report( "TerrainBrushStroke", "full rebuild: %.3f ms", fullRebuild );
+        Benchmark::report( "TerrainBrushStroke", "brush: %.3f ms per edit", brushTime / kEditCount );
+        Benchmark::report( "TerrainBrushStroke", "updateMesh: %.3f ms per edit, %.1f chunks per edit", meshTime / kEditCount, static_cast<f32>( chunks ) / kEditCount );
+        Benchmark::report( "TerrainBrushStroke", "upload: %.3f ms per edit, %.1f KB per edit", uploadTime / kEditCount, uploadedKb / kEditCount );
+        Benchmark::report( "TerrainBrushStroke", "updateHeightBounds: %.3f ms per edit", lodTime / kEditCount );
+        Benchmark::report( "TerrainBrushStroke", "TerrainRayCaster::update: %.3f ms per edit", casterTime / kEditCount );
+        Benchmark::report( "TerrainBrushStroke", "total: %.3f ms per edit", total / kEditCount );
+    }
+
+private:
+
+    //! Raises heightmap vertices inside a circular brush.
+    void                raise( Scene::Heightmap& heightmap, s32 cx, s32 cz ) const
+    {
+        for( s32 z = cz - kBrushRadius; z <= cz + kBrushRadius; z++ ) {
+            for( s32 x = cx - kBrushRadius; x <= cx + kBrushRadius; x++ ) {
+                s32 dx = x - cx;
+                s32 dz = z - cz;
+
+                if( dx * dx + dz * dz > kBrushRadius * kBrushRadius ) {
+                    continue;
+                }
+
+                heightmap.setHeight( x, z, min2( heightmap.height( x, z ) + 100, static_cast<s32>( heightmap.maxValue() ) ) );
+            }
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    TerrainBrushStroke benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures terrain quadtree node selection along a camera path and compares triangle counts with a full resolution terrain.
+
+//! The terrain size.
+static const s32 kTerrainSize = 2048;
+
+//! The total number of camera positions along a path.
+static const s32 kFrameCount = 1000;
+
+//! Generates rolling hills.
+class Hills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.05f ) * cosf( z * 0.03f ) );
+    }
+};
+
+//! Runs the terrain level of detail benchmark.
+class TerrainLodSelection {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Scene::Terrain terrain( kTerrainSize );
+        terrain.heightmap().set( DC_NEW Hills );
+
+        Benchmark::Timer timer;
+        Scene::TerrainQuadTree quadTree( terrain );
+        Benchmark::report( "TerrainLodSelection", "build: %.3f ms, %d nodes, %d levels", timer.ms(), static_cast<s32>( quadTree.nodes().size() ), quadTree.levelCount() );
+
+        Scene::TerrainQuadTree::Selection selection;
+        Matrix4 projection = Matrix4::perspective( 60.0f, 16.0f / 9.0f, 0.1f, 5000.0f );
+
+        s64 triangles = 0;
+        s64 nodes     = 0;
+        s32 maxTriangles = 0;
+        timer.restart();
+
+        // Fly over the terrain along a diagonal
+        for( s32 i = 0; i < kFrameCount; i++ ) {
+            f32  t      = static_cast<f32>( i ) / kFrameCount;
+            Vec3 camera( t * kTerrainSize, 0.0f, t * kTerrainSize * 0.5f );
+            camera.y = terrain.height( camera.x, camera.z ) + 20.0f;
+
+            Matrix4 view = Matrix4::translation( -camera.x, -camera.y, -camera.z );
+            quadTree.select( camera, projection * view, selection );
+
+            triangles   += selection.triangles;
+            nodes       += static_cast<s64>( selection.nodes.size() );
+            maxTriangles = max2( maxTriangles, selection.triangles );
+        }
+
+        f64 time = timer.ms();
+        Benchmark::report( "TerrainLodSelection", "select: %.3f ms per frame, %lld nodes, %lld triangles on average, %d at most"
+            , time / kFrameCount, nodes / kFrameCount, triangles / kFrameCount, maxTriangles );
+        Benchmark::report( "TerrainLodSelection", "full resolution: %d triangles", kTerrainSize * kTerrainSize * 2 );
+    }
+};
+
+int main( int argc, char** argv )
+{
+    TerrainLodSelection benchmark;
+    benchmark.run();
+    return 0;
+}
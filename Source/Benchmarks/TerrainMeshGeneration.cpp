@@ -0,0 +1,101 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures the whole terrain mesh generation time on a calling thread and with a task manager.
+
+//! The terrain size.
+static const s32 kTerrainSize = 2048;
+
+//! The total number of iterations for each mode.
+static const s32 kIterations = 4;
+
+//! Generates rolling hills.
+class Hills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.05f ) * cosf( z * 0.03f ) );
+    }
+};
+
+//! Runs the terrain mesh generation benchmark.
+class TerrainMeshGeneration {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Scene::Terrain terrain( kTerrainSize );
+        terrain.heightmap().set( DC_NEW Hills );
+
+        Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+        Benchmark::Timer        timer;
+        size_t                  vertices = 0;
+
+        // Generate chunks on a calling thread
+        {
+            timer.restart();
+
+            for( s32 i = 0; i < kIterations; i++ ) {
+                Scene::Mesh mesh = terrain.createMesh();
+                vertices = mesh.vertexBuffer().size();
+            }
+
+            Benchmark::report( "TerrainMeshGeneration", "serial: %.3f ms per mesh, %u vertices", timer.ms() / kIterations, static_cast<u32>( vertices ) );
+        }
+
+        // Generate chunk columns as background tasks
+        {
+            timer.restart();
+
+            for( s32 i = 0; i < kIterations; i++ ) {
+                Scene::Mesh mesh = terrain.createMesh( taskManager );
+                vertices = mesh.vertexBuffer().size();
+            }
+
+            Benchmark::report( "TerrainMeshGeneration", "parallel: %.3f ms per mesh, %u vertices", timer.ms() / kIterations, static_cast<u32>( vertices ) );
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    TerrainMeshGeneration benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+// Include the engine header file.
+#include <Dreemchest.h>
+
+// Include benchmark helpers.
+#include <Benchmark.h>
+
+DC_USE_DREEMCHEST
+
+// Measures terrain ray casting throughput of a min-max height pyramid and compares it with ray marching.
+
+//! The terrain size.
+static const s32 kTerrainSize = 2048;
+
+//! The total number of casted rays.
+static const s32 kRayCount = 100000;
+
+//! Generates rolling hills.
+class Hills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.05f ) * cosf( z * 0.03f ) );
+    }
+};
+
+//! Runs the terrain ray casting benchmark.
+class TerrainRayCasting {
+public:
+
+    //! Runs the benchmark.
+    void                run( void )
+    {
+        Scene::Terrain terrain( kTerrainSize );
+        terrain.heightmap().set( DC_NEW Hills );
+
+        Benchmark::Timer timer;
+        Scene::TerrainRayCaster caster( terrain );
+        Benchmark::report( "TerrainRayCasting", "build: %.3f ms, %d levels", timer.ms(), caster.levelCount() );
+
+        // Cast rays from points above the terrain to random points on it, like line of sight queries do
+        Array<Ray> rays;
+        rays.reserve( kRayCount );
+        srand( 1 );
+
+        for( s32 i = 0; i < kRayCount; i++ ) {
+            Vec3 origin( rand() % kTerrainSize, 0.0f, rand() % kTerrainSize );
+            Vec3 target( rand() % kTerrainSize, 0.0f, rand() % kTerrainSize );
+            origin.y = terrain.height( origin.x, origin.z ) + 50.0f;
+            target.y = terrain.height( target.x, target.z );
+
+            Vec3 direction = target - origin;
+            direction.normalize();
+            rays.push_back( Ray( origin, direction ) );
+        }
+
+        // Cast rays one by one
+        {
+            Scene::TerrainRayCaster::Hit hit;
+            s32 hits = 0;
+            timer.restart();
+
+            for( s32 i = 0; i < kRayCount; i++ ) {
+                hits += caster.cast( rays[i], hit ) ? 1 : 0;
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "TerrainRayCasting", "cast: %.3f ms, %.0f rays/s, %d hits", time, kRayCount / (time * 0.001), hits );
+        }
+
+        // Cast rays in a single batch
+        {
+            Array<Scene::TerrainRayCaster::Hit> hits( kRayCount );
+            timer.restart();
+
+            s32 count = caster.castBatch( &rays[0], kRayCount, &hits[0] );
+
+            f64 time = timer.ms();
+            Benchmark::report( "TerrainRayCasting", "castBatch: %.3f ms, %.0f rays/s, %d hits", time, kRayCount / (time * 0.001), count );
+        }
+
+        // Ray marching
+        {
+            f64 error = 0.0;
+            timer.restart();
+
+            for( s32 i = 0; i < kRayCount; i++ ) {
+                Vec3 point = terrain.rayMarch( rays[i] );
+                error += fabs( terrain.height( point.x, point.z ) - point.y );
+            }
+
+            f64 time = timer.ms();
+            Benchmark::report( "TerrainRayCasting", "rayMarch: %.3f ms, %.0f rays/s, %.3f average height error", time, kRayCount / (time * 0.001), error / kRayCount );
+        }
+
+        // Update a brush sized region
+        {
+            timer.restart();
+
+            for( s32 i = 0; i < 1000; i++ ) {
+                caster.update( (i * 37) % (kTerrainSize - 16), (i * 91) % (kTerrainSize - 16), 16, 16 );
+            }
+
+            Benchmark::report( "TerrainRayCasting", "update: %.3f ms per 16x16 brush stroke", timer.ms() / 1000 );
+        }
+    }
+};
+
+int main( int argc, char** argv )
+{
+    TerrainRayCasting benchmark;
+    benchmark.run();
+    return 0;
+}
@@ -40,6 +40,9 @@ namespace Importers {
 
         //! Imports an asset to project cache.
         virtual bool            import( FileSystemQPtr fs, const Io::Path& sourceFileName, const Io::Path& destinationFileName ) = 0;
+
+        //! Reads import settings from an asset meta data, unknown keys are ignored.
+        virtual void            setSettings( const KeyValue& settings ) {}
     };
 
 } // namespace Importers
@@ -32,6 +32,41 @@ namespace Importers {
 
 // ------------------------------------------------------ MeshImporter ------------------------------------------------------ //
 
+// ** MeshImporter::MeshImporter
+MeshImporter::MeshImporter( void ) : m_quantization( 0 )
+{
+}
+
+// ** MeshImporter::quantization
+u8 MeshImporter::quantization( void ) const
+{
+    return m_quantization;
+}
+
+// ** MeshImporter::setQuantization
+void MeshImporter::setQuantization( u8 value )
+{
+    m_quantization = value;
+}
+
+// ** MeshImporter::setSettings
+void MeshImporter::setSettings( const KeyValue& settings )
+{
+    u8 quantization = 0;
+
+    if( settings.get<bool>( "quantizePositions", false ) ) {
+        quantization |= Renderer::VertexFormat::QuantizedPosition;
+    }
+    if( settings.get<bool>( "quantizeNormals", false ) ) {
+        quantization |= Renderer::VertexFormat::OctahedralNormal;
+    }
+    if( settings.get<bool>( "quantizeTexCoords", false ) ) {
+        quantization |= Renderer::VertexFormat::HalfTexCoord;
+    }
+
+    setQuantization( quantization );
+}
+
 // ** MeshImporter::import
 bool MeshImporter::import( FileSystemQPtr fs, const Io::Path& sourceFileName, const Io::Path& destinationFileName )
 {
@@ -44,13 +79,68 @@ bool MeshImporter::import( FileSystemQPtr fs, const Io::Path& sourceFileName, co
     Io::StreamPtr stream = Io::DiskFileSystem::open( destinationFileName, Io::BinaryWriteStream );
     NIMBLE_BREAK_IF( !stream.valid() );
 
+    u32 signature = Scene::MeshFormatRaw::Signature;
+    u32 version   = Scene::MeshFormatRaw::Version;
     s32 chunkCount = ( s32 )m_nodes.size();
+
+    stream->write( &signature, 4 );
+    stream->write( &version, 4 );
     stream->write( &chunkCount, 4 );
 
+    Renderer::VertexFormat format( Renderer::VertexFormat::Normal | Renderer::VertexFormat::TexCoord0 | Renderer::VertexFormat::TexCoord1, m_quantization );
+
     for( s32 i = 0; i < chunkCount; i++ ) {
         // Get mesh buffers
-        const Mesh::VertexBuffer& vertices = m_nodes[i].mesh.vertexBuffer();
-        const Mesh::IndexBuffer&  indices  = m_nodes[i].mesh.indexBuffer();
+        const Mesh::VertexBuffer& imported = m_nodes[i].mesh.vertexBuffer();
+        Mesh::IndexBuffer         indices  = m_nodes[i].mesh.indexBuffer();
+        Scene::Mesh::VertexBuffer vertices;
+
+        // Convert vertices to a runtime layout
+        vertices.resize( imported.size() );
+
+        for( s32 j = 0, n = ( s32 )imported.size(); j < n; j++ ) {
+            vertices[j].position = imported[j].position;
+            vertices[j].normal   = imported[j].normal;
+            vertices[j].uv[0]    = imported[j].uv[0];
+            vertices[j].uv[1]    = imported[j].uv[1];
+        }
+
+        s32 vertexCount = ( s32 )vertices.size();
+        s32 indexCount  = ( s32 )indices.size();
+        s32 clusters    = 0;
+        f32 acmr        = 0.0f;
+
+        // Reorder triangles for a vertex cache and an overdraw, then vertices for a sequential fetch
+        if( indexCount ) {
+            acmr = Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount );
+
+            Scene::MeshOptimizer::optimizeVertexCache( &indices[0], indexCount, vertexCount );
+            clusters = Scene::MeshOptimizer::optimizeOverdraw( &indices[0], indexCount, &vertices[0].position, sizeof( Scene::Mesh::Vertex ), vertexCount );
+
+            Array<u16> remap;
+            Scene::MeshOptimizer::optimizeVertexFetch( &indices[0], indexCount, vertexCount, remap );
+            Scene::MeshOptimizer::remapVertices( vertices, remap );
+            vertexCount = ( s32 )vertices.size();
+        }
+
+        // Calculate bounds that quantized positions are relative to
+        Bounds bounds;
+
+        for( s32 j = 0; j < vertexCount; j++ ) {
+            bounds << vertices[j].position;
+        }
+
+        // Encode vertices
+        Array<u8> encoded;
+        encoded.resize( vertexCount * format.vertexSize() );
+
+        if( vertexCount ) {
+            Scene::MeshOptimizer::encodeVertices( &vertices[0], vertexCount, format, bounds, &encoded[0] );
+        }
+
+        LogDebug( "meshImporter", "%s[%d]: ACMR %2.3f -> %2.3f, %d clusters, %d vertices, %d bytes -> %d bytes\n", sourceFileName.c_str(), i
+                , acmr, indexCount ? Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount ) : 0.0f, clusters, vertexCount
+                , ( s32 )(imported.size() * sizeof( Scene::Mesh::Vertex )), ( s32 )encoded.size() );
 
         // Write texture base name to stream
         FileInfo fileInfo = fs->extractFileInfo( m_nodes[i].texture );
@@ -58,24 +148,30 @@ bool MeshImporter::import( FileSystemQPtr fs, const Io::Path& sourceFileName, co
         stream->writeString( fileName.c_str() );
 
         // Write buffer size to stream
-        s32 vertexCount = ( s32 )vertices.size();
-        s32 indexCount  = ( s32 )indices.size();
-
         stream->write( &vertexCount, 4 );
         stream->write( &indexCount, 4 );
 
-        // Write vertices to stream
-        for( s32 j = 0; j < vertexCount; j++ ) {
-            const Vertex& v = vertices[j];
+        // Write a vertex format and quantization bounds
+        u8 attributes   = format;
+        u8 quantization = format.quantization();
 
-            stream->write( &v.position, sizeof( v.position ) );
-            stream->write( &v.normal, sizeof( v.normal ) );
-            stream->write( &v.uv[0], sizeof( v.uv[0] ) );
-            stream->write( &v.uv[1], sizeof( v.uv[1] ) );
+        stream->write( &attributes, 1 );
+        stream->write( &quantization, 1 );
+
+        if( format.isQuantized( Renderer::VertexFormat::QuantizedPosition ) ) {
+            stream->write( &bounds.min().x, sizeof( Vec3 ) );
+            stream->write( &bounds.max().x, sizeof( Vec3 ) );
+        }
+
+        // Write vertices to stream
+        if( vertexCount ) {
+            stream->write( &encoded[0], encoded.size() );
         }
 
         // Write indices to stream
-        stream->write( &indices[0], sizeof( u16 ) * indexCount );
+        if( indexCount ) {
+            stream->write( &indices[0], sizeof( u16 ) * indexCount );
+        }
     }
 
     return true;
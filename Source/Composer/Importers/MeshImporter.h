@@ -38,12 +38,28 @@ DC_BEGIN_COMPOSER
 namespace Importers {
 
     //! Base class for all mesh importers.
+    /*!
+     Imported triangles are reordered for a post-transform vertex cache and an overdraw, vertices are renumbered
+     in an order of a first use and optionally quantized before being written to a file.
+     */
     class MeshImporter : public AssetImporter {
     public:
 
+                            //! Constructs MeshImporter instance.
+                            MeshImporter( void );
+
         //! Writes imported mesh nodes to a file.
         virtual bool        import( FileSystemQPtr fs, const Io::Path& sourceFileName, const Io::Path& destinationFileName ) NIMBLE_OVERRIDE;
 
+        //! Reads a vertex quantization from quantizePositions, quantizeNormals and quantizeTexCoords settings.
+        virtual void        setSettings( const KeyValue& settings ) NIMBLE_OVERRIDE;
+
+        //! Returns a bitmask of Renderer::VertexFormat::Quantization modes used to write vertices.
+        u8                  quantization( void ) const;
+
+        //! Sets a bitmask of Renderer::VertexFormat::Quantization modes used to write vertices.
+        void                setQuantization( u8 value );
+
     protected:
 
         //! Imports mesh nodes from a file.
@@ -76,6 +92,7 @@ namespace Importers {
         };
 
         Array<Node>            m_nodes;    //!< Imported mesh nodes.
+        u8                     m_quantization; //!< Quantized vertex attributes.
     };
 
 #ifdef FBX_FOUND
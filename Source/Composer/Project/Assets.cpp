@@ -193,6 +193,13 @@ bool AssetManager::updateAssetCache( const QString& uuid, const FileInfo& file )
     //    return true;
     }
 
+    // Apply import settings stored in an asset meta data
+    Archive meta = m_assetFileSystem->metaData( file );
+
+    if( meta.isValid() ) {
+        importer->setSettings( meta.as<KeyValue>() );
+    }
+
     // Perform asset caching.
     bool result = importer->import( fs, file.absolutePath(), assetsFilePath );
     NIMBLE_BREAK_IF( !result );
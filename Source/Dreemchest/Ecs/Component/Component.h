@@ -28,6 +28,7 @@
 #define __DC_Ecs_Component_H__
 
 #include "../Ecs.h"
+#include "ComponentPool.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -55,13 +56,14 @@ namespace Ecs {
     */
     class ComponentBase : public RefCounted {
     friend class Entity;
+    friend class Ecs;
     public:
 
         INTROSPECTION_ABSTRACT( ComponentBase )
 
                                     //! Constructs ComponentBase instance.
                                     ComponentBase( void )
-                                        : m_flags( IsEnabled ) {}
+                                        : m_flags( IsEnabled ), m_changeRecord( 0 ) {}
 
         //! Sets the internal data.
         template<typename T>
@@ -83,6 +85,9 @@ namespace Ecs {
         //! Returns parent entity instance.
         EntityWPtr                  entity( void ) const;
 
+        //! Marks this component as changed, so queries that track this component type will report a parent entity.
+        void                        markChanged( void );
+
         //! Generates component type index for a specified type.
         template<typename T>
         static TypeIdx              typeId( void ) { return GroupedTypeIndex<T, ComponentBase>::idx(); }
@@ -93,6 +98,9 @@ namespace Ecs {
     #if DC_ECS_ENTITY_CLONING
         //! Copies a component by value and returns a new instance.
         virtual ComponentPtr        deepCopy( void ) const NIMBLE_ABSTRACT;
+
+        //! Writes a specified number of component copies to an output array, used by batched entity spawning.
+        virtual void                deepCopyBatch( ComponentPtr* output, s32 count ) const NIMBLE_ABSTRACT;
     #endif  /*  DC_ECS_ENTITY_CLONING   */
 
     protected:
@@ -100,8 +108,8 @@ namespace Ecs {
         //! Sets the component's enabled flag.
         void                        setEnabled( bool value );
 
-        //! Sets the component's parent entity.
-        void                        setParentEntity( const EntityWPtr& value );
+        //! Sets the component's parent entity, called when a component is attached to or detached from an entity.
+        virtual void                setParentEntity( const EntityWPtr& value );
 
     protected:
 
@@ -111,6 +119,7 @@ namespace Ecs {
         EntityWPtr                  m_entity;   //!< Entity instance this component is attached to.
         InternalDataHolder            m_internal;    //!< The internal data.
         FlagSet32                    m_flags;    //!< Component flags.
+        u32                         m_changeRecord; //!< An absolute position of the last change record plus one.
     };
 
     // ** ComponentBase::setInternal
@@ -189,9 +198,48 @@ namespace Ecs {
 
     #if DC_ECS_ENTITY_CLONING
         virtual ComponentPtr    deepCopy( void ) const NIMBLE_OVERRIDE;
+        virtual void            deepCopyBatch( ComponentPtr* output, s32 count ) const NIMBLE_OVERRIDE;
     #endif  /*  DC_ECS_ENTITY_CLONING   */
+
+    #if DC_ECS_POOLED_ALLOCATIONS
+        //! Allocates a component from a pool of this component type.
+        static void*            operator new( size_t size );
+
+        //! Returns a component memory back to a pool.
+        static void             operator delete( void* pointer, size_t size );
+    #endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
     };
 
+#if DC_ECS_POOLED_ALLOCATIONS
+    // ** Component::operator new
+    template<typename T>
+    void* Component<T>::operator new( size_t size )
+    {
+        ComponentPool& pool = ComponentPool::forType<T>();
+
+        // Subclasses that do not fit a pool block are allocated on a heap
+        if( size > static_cast<size_t>( pool.blockSize() ) ) {
+            return ::operator new( size );
+        }
+
+        return pool.allocate();
+    }
+
+    // ** Component::operator delete
+    template<typename T>
+    void Component<T>::operator delete( void* pointer, size_t size )
+    {
+        ComponentPool& pool = ComponentPool::forType<T>();
+
+        if( size > static_cast<size_t>( pool.blockSize() ) ) {
+            ::operator delete( pointer );
+            return;
+        }
+
+        pool.deallocate( pointer );
+    }
+#endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
+
 #if DC_ECS_ENTITY_CLONING
     // ** Component::deepCopy
     template<typename T>
@@ -199,9 +247,33 @@ namespace Ecs {
     {
         T* instance = DC_NEW T;
         *instance = *static_cast<const T*>( this );
-        instance->setParentEntity( NULL );
+
+        // Reset the parent entity directly, so an overridden setParentEntity does not affect a source entity
+        instance->m_entity       = EntityWPtr();
+        instance->m_changeRecord = 0;
+
         return instance;
     }
+
+    // ** Component::deepCopyBatch
+    template<typename T>
+    void Component<T>::deepCopyBatch( ComponentPtr* output, s32 count ) const
+    {
+    #if DC_ECS_POOLED_ALLOCATIONS
+        // Grow a pool once, so all copies are placed next to each other
+        ComponentPool::forType<T>().reserve( count );
+    #endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
+
+        const T& source = *static_cast<const T*>( this );
+
+        for( s32 i = 0; i < count; i++ ) {
+            T* instance = DC_NEW T;
+            *instance = source;
+            instance->m_entity       = EntityWPtr();
+            instance->m_changeRecord = 0;
+            output[i] = instance;
+        }
+    }
 #endif  /*  DC_ECS_ENTITY_CLONING   */
 
 } // namespace Ecs
@@ -0,0 +1,173 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "ComponentPool.h"
+
+#include "../../Threads/Mutex.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs {
+
+// ** ComponentPool::ComponentPool
+ComponentPool::ComponentPool( const String& name, s32 blockSize, s32 blocksPerSlab )
+    : m_name( name )
+    , m_blocksPerSlab( blocksPerSlab )
+    , m_capacity( 0 )
+    , m_free( NULL )
+    , m_used( 0 )
+    , m_peak( 0 )
+{
+    // Keep each block aligned to 16 bytes and large enough to hold a free list link
+    m_blockSize = (max2( blockSize, static_cast<s32>( sizeof( FreeBlock ) ) ) + 15) & ~15;
+    m_mutex     = Threads::Mutex::create();
+
+    // Pools of different types may be created by several threads at once
+    Threads::MutexWPtr mutex = poolsMutex();
+    DC_SCOPED_LOCK( mutex );
+    pools().push_back( this );
+}
+
+// ** ComponentPool::pools
+Array<ComponentPool*>& ComponentPool::pools( void )
+{
+    static Array<ComponentPool*>* pools = DC_NEW Array<ComponentPool*>;
+    return *pools;
+}
+
+// ** ComponentPool::poolsMutex
+Threads::MutexWPtr ComponentPool::poolsMutex( void )
+{
+    static Threads::MutexPtr* mutex = DC_NEW Threads::MutexPtr( Threads::Mutex::create() );
+    return *mutex;
+}
+
+// ** ComponentPool::allocate
+void* ComponentPool::allocate( void )
+{
+    DC_SCOPED_LOCK( m_mutex );
+
+    if( m_free == NULL ) {
+        allocateSlab( m_blocksPerSlab );
+    }
+
+    FreeBlock* block = m_free;
+    m_free = block->next;
+
+    m_used++;
+    m_peak = max2( m_peak, m_used );
+
+    return block;
+}
+
+// ** ComponentPool::deallocate
+void ComponentPool::deallocate( void* pointer )
+{
+    if( pointer == NULL ) {
+        return;
+    }
+
+    DC_SCOPED_LOCK( m_mutex );
+
+    NIMBLE_BREAK_IF( m_used <= 0, "deallocating a block that was not allocated from this pool" );
+
+    FreeBlock* block = static_cast<FreeBlock*>( pointer );
+    block->next = m_free;
+    m_free = block;
+    m_used--;
+}
+
+// ** ComponentPool::reserve
+void ComponentPool::reserve( s32 count )
+{
+    DC_SCOPED_LOCK( m_mutex );
+
+    s32 available = m_capacity - m_used;
+
+    if( available < count ) {
+        allocateSlab( max2( count - available, m_blocksPerSlab ) );
+    }
+}
+
+// ** ComponentPool::allocateSlab
+void ComponentPool::allocateSlab( s32 count )
+{
+    u8* slab = DC_NEW u8[m_blockSize * count + 15];
+    m_slabs.push_back( slab );
+    m_capacity += count;
+
+    // Align the first block
+    u8* first = reinterpret_cast<u8*>( (reinterpret_cast<uintptr_t>( slab ) + 15) & ~static_cast<uintptr_t>( 15 ) );
+
+    // Link blocks in address order, so consecutive allocations are adjacent in memory
+    for( s32 i = count - 1; i >= 0; i-- ) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>( first + i * m_blockSize );
+        block->next = m_free;
+        m_free = block;
+    }
+}
+
+// ** ComponentPool::blockSize
+s32 ComponentPool::blockSize( void ) const
+{
+    return m_blockSize;
+}
+
+// ** ComponentPool::statistics
+ComponentPool::Statistics ComponentPool::statistics( void ) const
+{
+    DC_SCOPED_LOCK( m_mutex );
+
+    Statistics result;
+    result.name      = m_name;
+    result.blockSize = m_blockSize;
+    result.capacity  = m_capacity;
+    result.used      = m_used;
+    result.peak      = m_peak;
+    result.slabs     = static_cast<s32>( m_slabs.size() );
+    return result;
+}
+
+// ** ComponentPool::allStatistics
+ComponentPool::StatisticsArray ComponentPool::allStatistics( void )
+{
+    Threads::MutexWPtr mutex = poolsMutex();
+    DC_SCOPED_LOCK( mutex );
+
+    const Array<ComponentPool*>& items = pools();
+    StatisticsArray result;
+
+    for( s32 i = 0, n = static_cast<s32>( items.size() ); i < n; i++ ) {
+        result.push_back( items[i]->statistics() );
+    }
+
+    return result;
+}
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
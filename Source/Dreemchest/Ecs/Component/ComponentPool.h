@@ -0,0 +1,127 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Ecs_ComponentPool_H__
+#define __DC_Ecs_ComponentPool_H__
+
+#include "../Ecs.h"
+#include "../../Threads/Threads.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs {
+
+    //! A fixed size block allocator used for components and entities of a single type.
+    /*!
+     Blocks are carved from large slabs, so objects of one type are placed close together in memory,
+     and freed blocks are reused through an intrusive free list, so both allocation and deallocation
+     take constant time. Slabs are never returned to a system heap. Each pool is guarded by its own
+     mutex, so components of a single type can be created and destroyed from several threads.
+     */
+    class ComponentPool {
+    public:
+
+        //! Pool occupancy statistics.
+        struct Statistics {
+            String              name;       //!< A pooled type name.
+            s32                 blockSize;  //!< A size of a single block in bytes.
+            s32                 capacity;   //!< The total number of blocks in all slabs.
+            s32                 used;       //!< The number of allocated blocks.
+            s32                 peak;       //!< The maximum number of blocks allocated at once.
+            s32                 slabs;      //!< The total number of allocated slabs.
+        };
+
+        //! Container type to store statistics of all pools.
+        typedef Array<Statistics> StatisticsArray;
+
+                                //! Constructs ComponentPool instance.
+                                ComponentPool( const String& name, s32 blockSize, s32 blocksPerSlab = 1024 );
+
+        //! Allocates a single block.
+        void*                   allocate( void );
+
+        //! Returns a block back to a pool.
+        void                    deallocate( void* pointer );
+
+        //! Makes sure that a specified number of blocks can be allocated without growing a pool, missing blocks are carved from a single slab.
+        void                    reserve( s32 count );
+
+        //! Returns a size of a single block.
+        s32                     blockSize( void ) const;
+
+        //! Returns occupancy statistics of this pool.
+        Statistics              statistics( void ) const;
+
+        //! Returns occupancy statistics of all created pools.
+        static StatisticsArray  allStatistics( void );
+
+        //! Returns a pool that allocates instances of a specified type, pools are never destroyed so objects can outlive static destructors.
+        template<typename T>
+        static ComponentPool&   forType( void );
+
+    private:
+
+        //! Allocates a new slab with a specified number of blocks and links all of them to a free list.
+        void                    allocateSlab( s32 count );
+
+        //! Returns a list of all created pools.
+        static Array<ComponentPool*>& pools( void );
+
+        //! Returns a mutex that guards a list of all created pools.
+        static Threads::MutexWPtr     poolsMutex( void );
+
+    private:
+
+        //! An unused block links to the next one.
+        struct FreeBlock {
+            FreeBlock*          next;   //!< The next free block.
+        };
+
+        String                  m_name;             //!< A pooled type name.
+        s32                     m_blockSize;        //!< A size of a single block.
+        s32                     m_blocksPerSlab;    //!< The number of blocks in each slab.
+        Array<u8*>              m_slabs;            //!< Allocated slabs.
+        s32                     m_capacity;         //!< The total number of blocks in all slabs.
+        FreeBlock*              m_free;             //!< The first free block.
+        s32                     m_used;             //!< The number of allocated blocks.
+        s32                     m_peak;             //!< The maximum number of allocated blocks.
+        Threads::MutexPtr       m_mutex;            //!< Guards slabs, a free list and counters.
+    };
+
+    // ** ComponentPool::forType
+    template<typename T>
+    ComponentPool& ComponentPool::forType( void )
+    {
+        static ComponentPool* pool = DC_NEW ComponentPool( TypeInfo<T>::name(), sizeof( T ) );
+        return *pool;
+    }
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Ecs_ComponentPool_H__    */
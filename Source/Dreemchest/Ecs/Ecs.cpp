@@ -30,6 +30,8 @@
 
 #include "Entity/Entity.h"
 #include "Entity/Index.h"
+#include "Entity/NameTable.h"
+#include "Entity/Query.h"
 #include "Entity/DataCache.h"
 #include "System/SystemGroup.h"
 
@@ -76,6 +78,15 @@ void Ecs::addEntity( EntityPtr entity )
 {
     NIMBLE_BREAK_IF( !entity.valid(), "invalid entity" );
 
+    registerEntity( entity );
+
+    // Queue entity for notification.
+    m_changed.insert( entity );
+}
+
+// ** Ecs::registerEntity
+void Ecs::registerEntity( const EntityPtr& entity )
+{
     const EntityId& id = entity->id();
     if( id.isNull() ) {
         LogWarning( "entity", "%s", "adding entity with an invalid id\n" );
@@ -86,11 +97,14 @@ void Ecs::addEntity( EntityPtr entity )
     // Setup entity
     entity->setEcs( this );
 
-    // Register the entity
-    m_entities[id] = entity;
+    // Register the entity, integer ids are generated in an increasing order so the end is a good insertion hint
+    m_entities.insert( m_entities.end(), Entities::value_type( id, entity ) );
+    acquireHandle( entity.get() );
 
-    // Queue entity for notification.
-    m_changed.insert( entity );
+    // Register an entity name
+    if( entity->nameId() ) {
+        renameEntity( entity.get(), 0, entity->nameId() );
+    }
 }
 
 // ** Ecs::addEntities
@@ -144,7 +158,61 @@ EntityPtr Ecs::copyEntity( const EntityWPtr& entity, const EntityId& id )
     return clone;
 }
 
-#if !DC_ECS_ENTITY_CLONING
+#if DC_ECS_ENTITY_CLONING
+
+// ** Ecs::spawnBatch
+EntityArray Ecs::spawnBatch( const EntityWPtr& prefab, s32 count )
+{
+    NIMBLE_ABORT_IF( !prefab.valid(), "invalid prefab" );
+
+    EntityArray entities;
+
+    if( count <= 0 ) {
+        return entities;
+    }
+
+    // Copy components column by column, so each component type is copied in a single batch
+    const Entity::Components& layout = prefab->components();
+    Array<ComponentPtr>       copies( layout.size() * count );
+    s32                       column = 0;
+
+    for( Entity::Components::const_iterator i = layout.begin(), end = layout.end(); i != end; ++i, ++column ) {
+        i->second->deepCopyBatch( &copies[column * count], count );
+    }
+
+#if DC_ECS_POOLED_ALLOCATIONS
+    ComponentPool::forType<Entity>().reserve( count );
+#endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
+
+    entities.reserve( count );
+    m_slots.reserve( m_slots.size() + count );
+
+    for( s32 i = 0; i < count; i++ ) {
+        EntityPtr entity = createEntity();
+
+        // All copies share the prefab mask and components are appended in the prefab order
+        entity->m_mask = prefab->mask();
+        column = 0;
+
+        for( Entity::Components::const_iterator j = layout.begin(), end = layout.end(); j != end; ++j, ++column ) {
+            const ComponentPtr& component = copies[column * count + i];
+            entity->m_components.insert( entity->m_components.end(), Entity::Components::value_type( j->first, component ) );
+            component->setParentEntity( entity.get() );
+        }
+
+        registerEntity( entity );
+        entities.push_back( entity );
+    }
+
+    // Insert the whole batch to matching indices
+    for( Indices::iterator i = m_indices.begin(), end = m_indices.end(); i != end; ++i ) {
+        i->second->notifyEntitiesAdded( entities );
+    }
+
+    return entities;
+}
+
+#else
 
 // ** Ecs::cloneEntity
 EntityPtr Ecs::cloneEntity( EntityWPtr entity )
@@ -172,6 +240,62 @@ EntityPtr Ecs::findEntity( const EntityId& id ) const
     return i != m_entities.end() ? i->second : EntityPtr();
 }
 
+// ** Ecs::findByName
+EntitySet Ecs::findByName( NameId name ) const
+{
+    EntitySet result;
+
+    EntitiesByName::const_iterator i = m_named.find( name );
+
+    if( i == m_named.end() ) {
+        return result;
+    }
+
+    for( Array<Entity*>::const_iterator j = i->second.begin(), end = i->second.end(); j != end; ++j ) {
+        result.insert( EntityPtr( *j ) );
+    }
+
+    return result;
+}
+
+// ** Ecs::findByName
+EntitySet Ecs::findByName( const String& name ) const
+{
+    NameId id = NameTable::find( name );
+    return id ? findByName( id ) : EntitySet();
+}
+
+// ** Ecs::renameEntity
+void Ecs::renameEntity( Entity* entity, NameId previous, NameId name )
+{
+    // Remove an entity from a previous name bucket
+    if( previous ) {
+        EntitiesByName::iterator i = m_named.find( previous );
+        NIMBLE_BREAK_IF( i == m_named.end(), "entity name was not registered" );
+
+        if( i != m_named.end() ) {
+            Array<Entity*>& entities = i->second;
+
+            for( s32 j = 0, n = static_cast<s32>( entities.size() ); j < n; j++ ) {
+                if( entities[j] == entity ) {
+                    entities[j] = entities.back();
+                    entities.pop_back();
+                    break;
+                }
+            }
+
+            if( entities.empty() ) {
+                m_named.erase( i );
+            }
+        }
+    }
+
+    // Add it to a new one
+    if( name ) {
+        m_named[name].push_back( entity );
+    }
+}
+
 // ** Ecs::findByAspect
 EntitySet Ecs::findByAspect( const Aspect& aspect ) const
 {
@@ -186,6 +310,19 @@ EntitySet Ecs::findByAspect( const Aspect& aspect ) const
     return result;
 }
 
+// ** Ecs::entities
+EntityArray Ecs::entities( void ) const
+{
+    EntityArray result;
+    result.reserve( m_entities.size() );
+
+    for( Entities::const_iterator i = m_entities.begin(), end = m_entities.end(); i != end; ++i ) {
+        result.push_back( i->second );
+    }
+
+    return result;
+}
+
 // ** Ecs::removeEntity
 void Ecs::removeEntity( const EntityId& id )
 {
@@ -197,12 +334,76 @@ void Ecs::removeEntity( const EntityId& id )
         return;
     }
 
+    // Removed entities can no longer be found by name
+    if( (i->second->flags() & Entity::Removed) == 0 && i->second->nameId() ) {
+        renameEntity( i->second.get(), i->second->nameId(), 0 );
+    }
+
     i->second->markAsRemoved();
 
     m_changed.insert( i->second );
     m_removed.insert( i->second );
 }
 
+// ** Ecs::findEntity
+EntityPtr Ecs::findEntity( const EntityHandle& handle ) const
+{
+    if( handle.index >= m_slots.size() ) {
+        return EntityPtr();
+    }
+
+    const EntitySlot& slot = m_slots[handle.index];
+    return slot.generation == handle.generation ? slot.entity : NULL;
+}
+
+// ** Ecs::entityCount
+s32 Ecs::entityCount( void ) const
+{
+    return static_cast<s32>( m_entities.size() );
+}
+
+// ** Ecs::acquireHandle
+void Ecs::acquireHandle( Entity* entity )
+{
+    u32 index;
+
+    if( m_freeSlots.empty() ) {
+        EntitySlot slot;
+        slot.entity     = NULL;
+        slot.generation = 1;
+
+        index = static_cast<u32>( m_slots.size() );
+        m_slots.push_back( slot );
+    } else {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+
+    EntitySlot& slot = m_slots[index];
+    slot.entity = entity;
+    entity->m_handle = EntityHandle( index, slot.generation );
+}
+
+// ** Ecs::releaseHandle
+void Ecs::releaseHandle( Entity* entity )
+{
+    const EntityHandle& handle = entity->m_handle;
+
+    if( !handle.isValid() ) {
+        return;
+    }
+
+    NIMBLE_BREAK_IF( m_slots[handle.index].entity != entity, "entity handle does not match a slot" );
+
+    // Skip a zero generation, it is reserved for invalid handles
+    EntitySlot& slot = m_slots[handle.index];
+    slot.entity     = NULL;
+    slot.generation = slot.generation + 1 ? slot.generation + 1 : 1;
+
+    m_freeSlots.push_back( handle.index );
+    entity->m_handle = EntityHandle();
+}
+
 // ** Ecs::isUsedId
 bool Ecs::isUsedId( const EntityId& id ) const
 {
@@ -262,6 +463,112 @@ void Ecs::rebuildIndex( IndexWPtr index )
     }
 }
 
+// ** Ecs::requestQuery
+QueryPtr Ecs::requestQuery( const String& name, const Aspect& aspect, const Bitset& tracked )
+{
+    QueryPtr query( DC_NEW Query( this, requestIndex( name, aspect ), tracked ) );
+
+    // Start tracking changes of requested component types
+    for( s32 i = 0, n = static_cast<s32>( query->m_types.size() ); i < n; i++ ) {
+        TypeIdx type = query->m_types[i];
+
+        if( type >= m_changeLogs.size() ) {
+            m_changeLogs.resize( type + 1 );
+        }
+
+        ChangeLog& log = m_changeLogs[type];
+        log.tracked = true;
+        query->m_cursors[i] = log.base + static_cast<u32>( log.records.size() );
+    }
+
+    m_queries.push_back( query );
+
+    return query;
+}
+
+// ** Ecs::notifyComponentChanged
+void Ecs::notifyComponentChanged( ComponentBase& component )
+{
+    TypeIdx type = component.typeIndex();
+
+    if( type >= m_changeLogs.size() || !m_changeLogs[type].tracked ) {
+        return;
+    }
+
+    ChangeLog& log = m_changeLogs[type];
+
+    // The last record of this component was not read by any query yet
+    if( component.m_changeRecord > log.consumed ) {
+        return;
+    }
+
+    log.records.push_back( component.entity() );
+    component.m_changeRecord = log.base + static_cast<u32>( log.records.size() );
+}
+
+// ** Ecs::collectChanges
+u32 Ecs::collectChanges( TypeIdx type, u32 cursor, EntityArray& entities )
+{
+    if( type >= m_changeLogs.size() ) {
+        return cursor;
+    }
+
+    ChangeLog& log = m_changeLogs[type];
+    u32        end = log.base + static_cast<u32>( log.records.size() );
+
+    for( u32 i = max2( cursor, log.base ); i < end; i++ ) {
+        const EntityWPtr& entity = log.records[i - log.base];
+
+        if( entity.valid() ) {
+            entities.push_back( entity.get() );
+        }
+    }
+
+    log.consumed = max2( log.consumed, end );
+
+    return end;
+}
+
+// ** Ecs::compactChangeLogs
+void Ecs::compactChangeLogs( void )
+{
+    // Forget destroyed queries
+    for( s32 i = static_cast<s32>( m_queries.size() ) - 1; i >= 0; i-- ) {
+        if( !m_queries[i].valid() ) {
+            m_queries.erase( m_queries.begin() + i );
+        }
+    }
+
+    for( TypeIdx type = 0, n = static_cast<TypeIdx>( m_changeLogs.size() ); type < n; type++ ) {
+        ChangeLog& log = m_changeLogs[type];
+
+        if( log.records.empty() && log.tracked ) {
+            continue;
+        }
+
+        // Find the slowest query that tracks this component type
+        u32  end     = log.base + static_cast<u32>( log.records.size() );
+        u32  cursor  = end;
+        bool tracked = false;
+
+        for( s32 i = 0, count = static_cast<s32>( m_queries.size() ); i < count; i++ ) {
+            const Query* query = m_queries[i].get();
+
+            for( s32 j = 0, types = static_cast<s32>( query->m_types.size() ); j < types; j++ ) {
+                if( query->m_types[j] == type ) {
+                    cursor  = min2( cursor, max2( query->m_cursors[j], log.base ) );
+                    tracked = true;
+                }
+            }
+        }
+
+        // Erase records that were read by all queries
+        log.records.erase( log.records.begin(), log.records.begin() + (cursor - log.base) );
+        log.base    = cursor;
+        log.tracked = tracked;
+    }
+}
+
 // ** Ecs::rebuildIndices
 void Ecs::rebuildIndices( void )
 {
@@ -294,6 +601,7 @@ void Ecs::cleanupRemovedEntities( void )
         m_removed.clear();
 
         for( EntitySet::iterator i = removed.begin(), end = removed.end(); i != end; ++i ) {
+            releaseHandle( i->get() );
             m_entities.erase( (*i)->id() );
         }
     }
@@ -336,6 +644,9 @@ void Ecs::update( u32 currentTime, f32 dt, u32 systems )
             group->update( currentTime, dt );
         }
     }
+
+    // Drop component changes that were read by all queries
+    compactChangeLogs();
 }
 
 // ** EntityIdGenerator::EntityIdGenerator
@@ -38,6 +38,7 @@
 
 #define DC_ECS_ITERATIVE_INDEX_REBUILD  (1) // Enable to rebuild indicies after each system update
 #define DC_ECS_ENTITY_CLONING           (1) // Enables cloning entities with deepCopy method
+#define DC_ECS_POOLED_ALLOCATIONS       (1) // Allocates components and entities from per-type pools
 
 DC_BEGIN_DREEMCHEST
 
@@ -54,12 +55,44 @@ namespace Ecs {
     typedef Guid EntityId;
 #endif
 
+    //! Interned entity name id, a zero id stands for no name.
+    typedef u32 NameId;
+
+    //! A generational handle of an entity that was added to a world.
+    /*!
+     A handle stores an index of an entity slot inside a world and a generation of this slot. A generation
+     is incremented each time a slot is released, so a stale handle never resolves to another entity.
+     */
+    struct EntityHandle {
+                    //! Constructs an invalid EntityHandle instance.
+                    EntityHandle( void )
+                        : index( 0 ), generation( 0 ) {}
+
+                    //! Constructs EntityHandle instance.
+                    EntityHandle( u32 index, u32 generation )
+                        : index( index ), generation( generation ) {}
+
+        //! Returns true if this handle was issued by a world.
+        bool        isValid( void ) const { return generation != 0; }
+
+        //! Returns a handle packed to a single 64-bit value.
+        u64         value( void ) const { return (static_cast<u64>( generation ) << 32) | index; }
+
+        //! Compares two handles.
+        bool        operator == ( const EntityHandle& other ) const { return index == other.index && generation == other.generation; }
+        bool        operator != ( const EntityHandle& other ) const { return !(*this == other); }
+
+        u32         index;      //!< An entity slot index.
+        u32         generation; //!< An entity slot generation.
+    };
+
     dcDeclarePtrs( Ecs )
     dcDeclarePtrs( EntityIdGenerator )
     dcDeclarePtrs( Entity )
     dcDeclareNamedPtrs( ComponentBase, Component )
     dcDeclareNamedPtrs( DataCacheBase, DataCache )
     dcDeclarePtrs( Index )
+    dcDeclarePtrs( Query )
     dcDeclarePtrs( System )
     dcDeclarePtrs( SystemGroup )
 
@@ -113,6 +146,7 @@ namespace Ecs {
     //! Ecs is a root class of an entity component system.
     class Ecs : public RefCounted {
     friend class Entity;
+    friend class Query;
     public:
 
         //! Creates a new entity.
@@ -132,6 +166,15 @@ namespace Ecs {
         //! Makes a full copy of an entity.
         EntityPtr       copyEntity( const EntityWPtr& entity, const EntityId& id = EntityId() );
 
+    #if DC_ECS_ENTITY_CLONING
+        //! Creates a specified number of prefab copies and adds them to this world at once.
+        /*!
+         Components of each prefab type are copied in a single batch, entities are registered immediately
+         and inserted to each matching index in a single pass instead of waiting for the next update.
+         */
+        EntityArray     spawnBatch( const EntityWPtr& prefab, s32 count );
+    #endif  /*  DC_ECS_ENTITY_CLONING   */
+
     #if !DC_ECS_ENTITY_CLONING
         //! Clones entity.
         EntityPtr       cloneEntity( EntityWPtr entity );
@@ -140,9 +183,24 @@ namespace Ecs {
         //! Returns the entity with specified id.
         EntityPtr        findEntity( const EntityId& id ) const;
 
+        //! Returns the entity referenced by a handle or a null pointer if a handle is stale.
+        EntityPtr       findEntity( const EntityHandle& handle ) const;
+
+        //! Returns the total number of entities added to this world.
+        s32             entityCount( void ) const;
+
         //! Returns a list of entities that match a specified aspect.
         EntitySet        findByAspect( const Aspect& aspect ) const;
 
+        //! Returns all entities ordered by an id.
+        EntityArray     entities( void ) const;
+
+        //! Returns a set of entities with a specified interned name.
+        EntitySet       findByName( NameId name ) const;
+
+        //! Returns a set of entities with a specified name.
+        EntitySet       findByName( const String& name ) const;
+
         //! Rebuild all system indices.
         void            rebuildIndices( void );
 
@@ -161,6 +219,12 @@ namespace Ecs {
         //! Rebuilds the specified index.
         void            rebuildIndex( IndexWPtr index );
 
+        //! Creates a persistent query over entities that match an aspect and tracks changes of specified components.
+        QueryPtr        requestQuery( const String& name, const Aspect& aspect, const Bitset& tracked );
+
+        //! Records a component change for queries that track a component type.
+        void            notifyComponentChanged( ComponentBase& component );
+
         //! Removes an entity by it's id.
         void            removeEntity( const EntityId& id );
 
@@ -200,6 +264,24 @@ namespace Ecs {
         //! Generates the unique entity id.
         EntityId        generateId( void ) const;
 
+        //! Moves an entity from one name bucket to another.
+        void            renameEntity( Entity* entity, NameId previous, NameId name );
+
+        //! Appends entities with components of specified type that changed after a cursor position, returns a new cursor position.
+        u32             collectChanges( TypeIdx type, u32 cursor, EntityArray& entities );
+
+        //! Drops change records that were read by all queries.
+        void            compactChangeLogs( void );
+
+        //! Registers an entity inside this world without queueing it for index updates.
+        void            registerEntity( const EntityPtr& entity );
+
+        //! Assigns a free slot to an entity and issues a handle.
+        void            acquireHandle( Entity* entity );
+
+        //! Releases an entity slot, so all handles that reference it become stale.
+        void            releaseHandle( Entity* entity );
+
     private:
 
         //! Container type to store all active entities.
@@ -217,6 +299,36 @@ namespace Ecs {
         //! Container type to store created data caches.
         typedef List<DataCachePtr>          DataCacheList;
 
+        //! Container type to map interned names to entities.
+        typedef HashMap<NameId, Array<Entity*> > EntitiesByName;
+
+        //! Changes of a single component type recorded for queries.
+        struct ChangeLog {
+                                    //! Constructs ChangeLog instance.
+                                    ChangeLog( void )
+                                        : base( 0 ), consumed( 0 ), tracked( false ) {}
+
+            u32                     base;       //!< An absolute position of the first record.
+            u32                     consumed;   //!< The furthest absolute position read by any query.
+            bool                    tracked;    //!< Indicates that at least one query tracks this component type.
+            EntityWeakArray         records;    //!< Entities with changed components.
+        };
+
+        //! Container type to store change logs indexed by component type.
+        typedef Array<ChangeLog>            ChangeLogs;
+
+        //! Container type to store created queries.
+        typedef Array<QueryWPtr>            Queries;
+
+        //! An entity slot referenced by handles.
+        struct EntitySlot {
+            Entity*                 entity;     //!< An entity that occupies this slot.
+            u32                     generation; //!< A current slot generation.
+        };
+
+        //! Container type to store entity slots.
+        typedef Array<EntitySlot>           EntitySlots;
+
         mutable EntityIdGeneratorPtr        m_entityId;            //!< Used for unique entity id generation.
         Entities                            m_entities;            //!< Active entities reside here.
         SystemGroups                        m_systems;            //!< All systems reside in system groups.
@@ -226,6 +338,11 @@ namespace Ecs {
         EntitySet                            m_removed;            //!< Entities that will be removed.
         IndexSet                            m_changedIndices;   //!< Indices that were changed.
         DataCacheList                       m_dataCaches;       //!< List of data caches that should be populated.
+        EntitiesByName                      m_named;            //!< Registered entities grouped by an interned name.
+        ChangeLogs                          m_changeLogs;       //!< Component changes recorded for queries.
+        Queries                             m_queries;          //!< All created queries.
+        EntitySlots                         m_slots;            //!< Entity lookup table indexed by a handle.
+        Array<u32>                          m_freeSlots;        //!< Indices of released entity slots.
     };
 
 
@@ -244,10 +361,13 @@ DC_END_DREEMCHEST
 
 #ifndef DC_BUILD_LIBRARY
     #include "EntitySerializer.h"
+    #include "WorldSnapshot.h"
     #include "Component/Component.h"
     #include "Entity/Entity.h"
     #include "Entity/Aspect.h"
     #include "Entity/Index.h"
+    #include "Entity/NameTable.h"
+    #include "Entity/Query.h"
     #include "Entity/DataCache.h"
     #include "System/SystemGroup.h"
     #include "System/GenericEntitySystem.h"
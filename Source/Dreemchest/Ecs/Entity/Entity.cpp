@@ -31,11 +31,41 @@ DC_BEGIN_DREEMCHEST
 namespace Ecs {
 
 // ** Entity::Entity
-Entity::Entity( void ) : m_flags( 0 )
+Entity::Entity( void ) : m_flags( 0 ), m_name( 0 )
 {
 
 }
 
+#if DC_ECS_POOLED_ALLOCATIONS
+
+// ** Entity::operator new
+void* Entity::operator new( size_t size )
+{
+    ComponentPool& pool = ComponentPool::forType<Entity>();
+
+    // Subclasses that do not fit a pool block are allocated on a heap
+    if( size > static_cast<size_t>( pool.blockSize() ) ) {
+        return ::operator new( size );
+    }
+
+    return pool.allocate();
+}
+
+// ** Entity::operator delete
+void Entity::operator delete( void* pointer, size_t size )
+{
+    ComponentPool& pool = ComponentPool::forType<Entity>();
+
+    if( size > static_cast<size_t>( pool.blockSize() ) ) {
+        ::operator delete( pointer );
+        return;
+    }
+
+    pool.deallocate( pointer );
+}
+
+#endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
+
 // ** Entity::setEcs
 void Entity::setEcs( EcsWPtr value )
 {
@@ -60,10 +90,17 @@ const EntityId& Entity::id( void ) const
     return m_id;
 }
 
+// ** Entity::handle
+const EntityHandle& Entity::handle( void ) const
+{
+    return m_handle;
+}
+
 // ** Entity::clear
 void Entity::clear( void )
 {
     m_components.clear();
+    setNameId( 0 );
 }
 
 // ** Entity::isSerializable
@@ -78,6 +115,28 @@ void Entity::setSerializable( bool value )
     m_flags.set( Serializable, value );
 }
 
+// ** Entity::nameId
+NameId Entity::nameId( void ) const
+{
+    return m_name;
+}
+
+// ** Entity::setNameId
+void Entity::setNameId( NameId value )
+{
+    if( m_name == value ) {
+        return;
+    }
+
+    NameId previous = m_name;
+    m_name = value;
+
+    // Only entities that were added to a world are indexed by name
+    if( m_ecs.valid() && !m_flags.is( Removed ) ) {
+        m_ecs->renameEntity( this, previous, value );
+    }
+}
+
 // ** Entity::mask
 const Bitset& Entity::mask( void ) const
 {
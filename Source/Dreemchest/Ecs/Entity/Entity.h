@@ -43,6 +43,7 @@ namespace Ecs {
     class Entity : public RefCounted {
     friend class Ecs;
     friend class Serializer;
+    friend class WorldSnapshot;
 
         INTROSPECTION_ABSTRACT( Entity
             , PROPERTY( flags, flags, setFlags, "The entity flags." )
@@ -65,6 +66,9 @@ namespace Ecs {
         //! Returns an entity identifier.
         const EntityId&            id( void ) const;
 
+        //! Returns a generational handle issued when this entity was added to a world.
+        const EntityHandle&     handle( void ) const;
+
         //! Returns a component mask.
         const Bitset&            mask( void ) const;
 
@@ -83,6 +87,12 @@ namespace Ecs {
         //! Sets entity's serializable flag.
         void                    setSerializable( bool value );
 
+        //! Returns an interned entity name.
+        NameId                  nameId( void ) const;
+
+        //! Sets an interned entity name used for lookups, this is done by a component that holds an entity name.
+        void                    setNameId( NameId value );
+
         //! Returns entity components.
         const Components&        components( void ) const;
         Components&                components( void );
@@ -98,6 +108,10 @@ namespace Ecs {
         template<typename TComponent>
         TComponent*                get( void ) const;
 
+        //! Returns an entity's component by type for writing and marks it as changed.
+        template<typename TComponent>
+        TComponent*             modify( void ) const;
+
         //! Enables the component of specified type.
         template<typename TComponent>
         void                    enable( void );
@@ -133,6 +147,14 @@ namespace Ecs {
         TComponent*                attach( Args ... args );
     #endif    /*    #if DREEMCHEST_CPP11    */
 
+    #if DC_ECS_POOLED_ALLOCATIONS
+        //! Allocates an entity from a pool.
+        static void*            operator new( size_t size );
+
+        //! Returns an entity memory back to a pool.
+        static void             operator delete( void* pointer, size_t size );
+    #endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
+
         //! Removes a component by type id from this entity.
         void                    detachById( TypeIdx id );
 
@@ -167,6 +189,8 @@ namespace Ecs {
         Components                m_components;    //!< Attached components.
         Bitset                    m_mask;            //!< Component mask.
         FlagSet8                m_flags;        //!< Entity flags.
+        NameId                  m_name;         //!< Interned entity name.
+        EntityHandle            m_handle;       //!< A generational entity handle.
     };
 
     // ** Entity::has
@@ -189,6 +213,15 @@ namespace Ecs {
         return result;
     }
 
+    // ** Entity::modify
+    template<typename TComponent>
+    TComponent* Entity::modify( void ) const
+    {
+        TComponent* result = get<TComponent>();
+        result->markChanged();
+        return result;
+    }
+
     // ** Entity::attachComponent
     template<typename TComponent>
     TComponent* Entity::attachComponent( TComponent* component )
@@ -202,7 +235,7 @@ namespace Ecs {
         m_components[idx] = component;
         updateComponentBit( idx, true );
 
-        component->setParentEntity( this );
+        static_cast<ComponentBase*>( component )->setParentEntity( this );
         
         return component;    
     }
@@ -78,6 +78,37 @@ void Index::notifyEntityChanged( const EntityPtr& entity )
     }
 }
 
+// ** Index::notifyEntitiesAdded
+void Index::notifyEntitiesAdded( const EntityArray& entities )
+{
+    // All entities share the same mask, so the aspect is tested once
+    if( entities.empty() || !m_aspect.hasIntersection( entities[0] ) ) {
+        return;
+    }
+
+    processEntitiesAdded( entities );
+}
+
+// ** Index::processEntitiesAdded
+void Index::processEntitiesAdded( const EntityArray& entities )
+{
+    LogDebug( "entityIndex", "%d entities added to %s\n", static_cast<s32>( entities.size() ), m_name.c_str() );
+
+    // Insert entities in a descending order, so each one is placed right before a previous one
+    EntityArray sorted = entities;
+    std::sort( sorted.begin(), sorted.end() );
+
+    EntitySet::iterator hint = m_entities.end();
+
+    for( EntityArray::const_reverse_iterator i = sorted.rbegin(), end = sorted.rend(); i != end; ++i ) {
+        hint = m_entities.insert( hint, *i );
+    }
+
+    for( s32 i = 0, n = static_cast<s32>( entities.size() ); i < n; i++ ) {
+        m_eventEmitter.notify<Added>( entities[i] );
+    }
+}
+
 // ** Index::processEntityAdded
 void Index::processEntityAdded( const EntityPtr& entity )
 {
@@ -72,11 +72,17 @@ namespace Ecs {
         //! Processes entity removal.
         virtual void            processEntityRemoved( const EntityPtr& entity );
 
+        //! Processes addition of entities that share the same component mask.
+        virtual void            processEntitiesAdded( const EntityArray& entities );
+
     private:
 
         //! Processes the entity change
         void                    notifyEntityChanged( const EntityPtr& entity );
 
+        //! Processes a batch of new entities that share the same component mask.
+        void                    notifyEntitiesAdded( const EntityArray& entities );
+
     protected:
 
         EcsWPtr                    m_ecs;                //!< Parent ECS instance.
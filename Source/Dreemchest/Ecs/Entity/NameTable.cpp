@@ -0,0 +1,83 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "NameTable.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs {
+
+// ** NameTable::NameTable
+NameTable::NameTable( void )
+{
+    // Reserve a zero id for an empty name
+    m_strings.push_back( &m_ids.insert( Ids::value_type( String(), 0 ) ).first->first );
+}
+
+// ** NameTable::instance
+NameTable& NameTable::instance( void )
+{
+    static NameTable table;
+    return table;
+}
+
+// ** NameTable::intern
+NameId NameTable::intern( const String& value )
+{
+    NameTable& table = instance();
+
+    Ids::const_iterator i = table.m_ids.find( value );
+
+    if( i != table.m_ids.end() ) {
+        return i->second;
+    }
+
+    NameId id = static_cast<NameId>( table.m_strings.size() );
+    table.m_strings.push_back( &table.m_ids.insert( Ids::value_type( value, id ) ).first->first );
+
+    return id;
+}
+
+// ** NameTable::find
+NameId NameTable::find( const String& value )
+{
+    const NameTable& table = instance();
+    Ids::const_iterator i = table.m_ids.find( value );
+    return i != table.m_ids.end() ? i->second : 0;
+}
+
+// ** NameTable::str
+const String& NameTable::str( NameId id )
+{
+    const NameTable& table = instance();
+    NIMBLE_ABORT_IF( id >= table.m_strings.size(), "invalid name id" );
+    return *table.m_strings[id];
+}
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
@@ -0,0 +1,75 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Ecs_NameTable_H__
+#define __DC_Ecs_NameTable_H__
+
+#include "../Ecs.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs {
+
+    //! A global table of interned entity names.
+    /*!
+     Each distinct name is stored once and identified by a 32-bit id, so entities can be
+     looked up by name without comparing strings. An empty name always has a zero id.
+     */
+    class NameTable {
+    public:
+
+        //! Returns an id of a specified name, the name is added to a table if it was not interned before.
+        static NameId           intern( const String& value );
+
+        //! Returns an id of a previously interned name or zero if a name was never interned.
+        static NameId           find( const String& value );
+
+        //! Returns a name string by id.
+        static const String&    str( NameId id );
+
+    private:
+
+                                //! Constructs NameTable instance.
+                                NameTable( void );
+
+        //! Returns a shared table instance.
+        static NameTable&       instance( void );
+
+    private:
+
+        //! Container type to map names to ids.
+        typedef HashMap<String, NameId> Ids;
+
+        Ids                     m_ids;      //!< Name ids by string.
+        Array<const String*>    m_strings;  //!< Interned strings indexed by id, point to stable hash map keys.
+    };
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Ecs_NameTable_H__    */
@@ -0,0 +1,125 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "Query.h"
+#include "Entity.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs {
+
+// ** Query::Query
+Query::Query( EcsWPtr ecs, IndexPtr index, const Bitset& tracked )
+    : m_ecs( ecs )
+    , m_index( index )
+{
+    for( s32 i = 0, n = tracked.size(); i < n; i++ ) {
+        if( tracked.is( i ) ) {
+            m_types.push_back( i );
+        }
+    }
+
+    // Start reading changes from the current position of each log
+    m_cursors.resize( m_types.size(), 0 );
+
+    // Entities that already reside in an index are reported by the first call
+    const EntitySet& entities = m_index->entities();
+
+    for( EntitySet::const_iterator i = entities.begin(), end = entities.end(); i != end; ++i ) {
+        m_added.push_back( *i );
+    }
+
+    m_index->subscribe<Index::Added>( dcThisMethod( Query::handleEntityAdded ) );
+}
+
+// ** Query::~Query
+Query::~Query( void )
+{
+    m_index->unsubscribe<Index::Added>( dcThisMethod( Query::handleEntityAdded ) );
+}
+
+// ** Query::entities
+const EntitySet& Query::entities( void ) const
+{
+    return m_index->entities();
+}
+
+// ** Query::size
+s32 Query::size( void ) const
+{
+    return m_index->size();
+}
+
+// ** Query::changed
+const EntityArray& Query::changed( void )
+{
+    m_changed.clear();
+
+    // Start with entities that were added to an index
+    for( s32 i = 0, n = static_cast<s32>( m_added.size() ); i < n; i++ ) {
+        if( m_added[i].valid() ) {
+            m_changed.push_back( m_added[i].get() );
+        }
+    }
+
+    m_added.clear();
+
+    // Append entities with changed components
+    if( m_ecs.valid() ) {
+        for( s32 i = 0, n = static_cast<s32>( m_types.size() ); i < n; i++ ) {
+            m_cursors[i] = m_ecs->collectChanges( m_types[i], m_cursors[i], m_changed );
+        }
+    }
+
+    // An entity may be recorded several times
+    std::sort( m_changed.begin(), m_changed.end() );
+    m_changed.erase( std::unique( m_changed.begin(), m_changed.end() ), m_changed.end() );
+
+    // Skip entities that no longer match a query
+    const EntitySet& entities = m_index->entities();
+    s32              count    = 0;
+
+    for( s32 i = 0, n = static_cast<s32>( m_changed.size() ); i < n; i++ ) {
+        if( entities.count( m_changed[i] ) ) {
+            m_changed[count++] = m_changed[i];
+        }
+    }
+
+    m_changed.resize( count );
+
+    return m_changed;
+}
+
+// ** Query::handleEntityAdded
+void Query::handleEntityAdded( const Index::Added& e )
+{
+    m_added.push_back( e.entity );
+}
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
@@ -0,0 +1,80 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Ecs_Query_H__
+#define __DC_Ecs_Query_H__
+
+#include "Index.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs {
+
+    //! A persistent query over entities that match an aspect.
+    /*!
+     A query keeps a cached index of matching entities and tracks changes of selected component
+     types, so a caller can visit only entities that were added to a query or had a tracked component
+     marked as changed since the previous visit, instead of scanning the whole world.
+     */
+    class Query : public RefCounted {
+    friend class Ecs;
+    public:
+
+        virtual                 ~Query( void );
+
+        //! Returns all entities that match a query aspect.
+        const EntitySet&        entities( void ) const;
+
+        //! Returns the total number of entities that match a query aspect.
+        s32                     size( void ) const;
+
+        //! Returns matching entities that were added or had a tracked component changed since the previous call.
+        const EntityArray&      changed( void );
+
+    private:
+
+                                //! Constructs Query instance.
+                                Query( EcsWPtr ecs, IndexPtr index, const Bitset& tracked );
+
+        //! Queues an entity that was added to an index.
+        void                    handleEntityAdded( const Index::Added& e );
+
+    private:
+
+        EcsWPtr                 m_ecs;      //!< Parent ECS instance.
+        IndexPtr                m_index;    //!< Index of entities that match a query aspect.
+        Array<TypeIdx>          m_types;    //!< Tracked component types.
+        Array<u32>              m_cursors;  //!< Change log positions for each tracked type.
+        EntityWeakArray         m_added;    //!< Entities added to an index since the previous call.
+        EntityArray             m_changed;  //!< Entities returned by the last call.
+    };
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Ecs_Query_H__    */
@@ -65,6 +65,11 @@ namespace Ecs
         //! Searches for an entity by it's identifier.
         virtual EntityWPtr                  resolveEntity( const Guid& id ) const;
 
+    protected:
+
+        EcsWPtr                             m_ecs;                  //!< Parent Ecs instance.
+        Bitset                              m_excluded;             //!< List of excluded components.
+
     private:
 
         //! Returns a component converter.
@@ -92,8 +97,6 @@ namespace Ecs
         //! Container type to store component conversions.
         typedef HashMap<String32, ComponentConverter> ComponentConverters;
 
-        EcsWPtr                             m_ecs;                  //!< Parent Ecs instance.
-        Bitset                              m_excluded;             //!< List of excluded components.
         ComponentConverters                 m_componentConverters;  //!< Registered component converters.
     };
 
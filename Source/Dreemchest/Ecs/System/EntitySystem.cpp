@@ -49,6 +49,11 @@ bool EntitySystem::initialize( EcsWPtr ecs )
     m_index->subscribe<Index::Added>( dcThisMethod( EntitySystem::handleEntityAdded ) );
     m_index->subscribe<Index::Removed>( dcThisMethod( EntitySystem::handleEntityRemoved ) );
 
+    // Track component changes if this system processes only changed entities
+    if( m_tracked ) {
+        m_changes = ecs->requestQuery( m_name, m_aspect, m_tracked );
+    }
+
     // Run event handler for all entities that reside in an index
     for( EntitySet::const_iterator i = m_index->entities().begin(), end = m_index->entities().end(); i != end; ++i ) {
         entityAdded( *i->get() );
@@ -88,6 +93,18 @@ void EntitySystem::update( u32 currentTime, f32 dt )
 
     NIMBLE_BREADCRUMB_CALL_STACK;
 
+    // Process only entities that were changed since the previous update
+    if( m_changes.valid() ) {
+        const EntityArray& changed = m_changes->changed();
+
+        for( s32 i = 0, n = static_cast<s32>( changed.size() ); i < n; i++ ) {
+            processEntity( currentTime, dt, *changed[i].get() );
+        }
+
+        end();
+        return;
+    }
+
     EntitySet& entities = m_index->entities();
 
     for( EntitySet::iterator i = entities.begin(); i != entities.end(); ) {
@@ -98,6 +115,13 @@ void EntitySystem::update( u32 currentTime, f32 dt )
     end();
 }
 
+// ** EntitySystem::processChangesOnly
+void EntitySystem::processChangesOnly( const Bitset& components )
+{
+    NIMBLE_BREAK_IF( m_index.valid(), "change tracking should be enabled before a system is initialized" );
+    m_tracked = components;
+}
+
 // ** EntitySystem::handleEntityAdded
 void EntitySystem::handleEntityAdded( const Index::Added& e )
 {
@@ -29,6 +29,7 @@
 
 #include "System.h"
 #include "../Entity/Index.h"
+#include "../Entity/Query.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -73,10 +74,15 @@ namespace Ecs {
         //! Handles an entity removed event.
         void            handleEntityRemoved( const Index::Removed& e );
 
+        //! Limits processing to entities that were added or had any of specified components changed since the previous update.
+        void            processChangesOnly( const Bitset& components );
+
     protected:
 
         Aspect          m_aspect;    //!< Entity aspect.
         IndexPtr        m_index;    //!< Entity index used by this system.
+        Bitset          m_tracked;  //!< Components tracked by a change query.
+        QueryPtr        m_changes;  //!< Query used to process only changed entities.
     };
 } // namespace Ecs
 
@@ -91,6 +91,18 @@ namespace Ecs {
 
         NIMBLE_BREADCRUMB_CALL_STACK;
 
+        // Process only entities that were changed since the previous update
+        if( m_changes.valid() ) {
+            const EntityArray& changed = m_changes->changed();
+
+            for( s32 i = 0, n = static_cast<s32>( changed.size() ); i < n; i++ ) {
+                dispatchProcess( currentTime, dt, *changed[i].get(), typename Indices::Indexes() );
+            }
+
+            end();
+            return;
+        }
+
         EntitySet& entities = m_index->entities();
 
         for( EntitySet::iterator i = entities.begin(), n = entities.end(); i != n; ++i ) {
@@ -0,0 +1,508 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "WorldSnapshot.h"
+
+#include "Entity/Entity.h"
+#include "Component/Component.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs
+{
+
+// ** WorldSnapshot::WorldSnapshot
+WorldSnapshot::WorldSnapshot( EcsWPtr ecs, const Bitset& excluded )
+    : Serializer( ecs, excluded )
+{
+}
+
+// ** WorldSnapshot::save
+bool WorldSnapshot::save( Io::StreamWPtr stream ) const
+{
+    return save( m_ecs->entities(), stream );
+}
+
+// ** WorldSnapshot::save
+bool WorldSnapshot::save( const EntityArray& entities, Io::StreamWPtr stream ) const
+{
+    NIMBLE_ABORT_IF( !stream.valid(), "invalid stream" );
+
+    //! Components of a single type grouped together.
+    struct Section {
+        Array<u32>              entities;   //!< Indices of entities that own components.
+        Array<ComponentBase*>   components; //!< Components to be written.
+    };
+
+    //! Container type to store sections by a component type.
+    typedef Map<TypeIdx, Section> Sections;
+
+    // All snapshot offsets are relative to this position
+    s32 origin = stream->position();
+
+    // Group components of stored entities by type
+    EntityArray stored;
+    Sections    sections;
+
+    stored.reserve( entities.size() );
+
+    for( s32 i = 0, n = static_cast<s32>( entities.size() ); i < n; i++ ) {
+        const EntityPtr& entity = entities[i];
+
+        // Skip entities that are queued for removal
+        if( entity->flags() & Entity::Removed ) {
+            continue;
+        }
+
+        u32 index = static_cast<u32>( stored.size() );
+        stored.push_back( entity );
+
+        const Entity::Components& components = entity->components();
+
+        for( Entity::Components::const_iterator j = components.begin(), end = components.end(); j != end; ++j ) {
+            // Skip excluded components
+            if( m_excluded.is( j->first ) ) {
+                continue;
+            }
+
+            // Skip component with no type, this means it's an abstract data type
+            if( !j->second->metaObject()->type() ) {
+                continue;
+            }
+
+            Section& section = sections[j->first];
+            section.entities.push_back( index );
+            section.components.push_back( j->second.get() );
+        }
+    }
+
+    // Write a snapshot header
+    Header header;
+    header.magic    = Magic;
+    header.version  = Version;
+    header.entities = static_cast<u32>( stored.size() );
+    header.sections = static_cast<u32>( sections.size() );
+    stream->write( &header, sizeof( Header ) );
+
+    // Reserve a section table, it is filled once all sections are written
+    s32 table = stream->position();
+    Array<SectionInfo> infos( sections.size() );
+
+    if( !infos.empty() ) {
+        stream->write( &infos[0], static_cast<s32>( infos.size() * sizeof( SectionInfo ) ) );
+    }
+
+    // Write an entity table
+    for( s32 i = 0, n = static_cast<s32>( stored.size() ); i < n; i++ ) {
+        stream->write( &stored[i]->id(), sizeof( EntityId ) );
+    }
+
+    for( s32 i = 0, n = static_cast<s32>( stored.size() ); i < n; i++ ) {
+        u8 flags = stored[i]->flags();
+        stream->write( &flags, sizeof( u8 ) );
+    }
+
+    align( stream, origin );
+
+    // Write a section for each component type
+    s32 index = 0;
+
+    for( Sections::const_iterator i = sections.begin(), end = sections.end(); i != end; ++i, ++index ) {
+        const Section& section = i->second;
+        SectionInfo&   info    = infos[index];
+
+        info.offset = static_cast<u32>( stream->position() - origin );
+
+        // Build a property schema from the first component
+        const ComponentBase* first  = section.components[0];
+        Fields               fields = schemaFor( first->metaInstance() );
+
+        // Components that consist of plain data properties only have a fixed record size
+        u32 stride = 0;
+
+        for( s32 j = 0, n = static_cast<s32>( fields.size() ); j < n; j++ ) {
+            if( fields[j].kind != PlainField ) {
+                stride = 0;
+                break;
+            }
+            stride += fields[j].size;
+        }
+
+        // Write a section header & schema
+        SectionHeader sectionHeader;
+        sectionHeader.count  = static_cast<u32>( section.components.size() );
+        sectionHeader.stride = stride;
+        sectionHeader.schema = schemaHash( fields );
+        sectionHeader.fields = static_cast<u32>( fields.size() );
+        stream->write( &sectionHeader, sizeof( SectionHeader ) );
+        stream->writeString( first->metaObject()->name() );
+
+        for( s32 j = 0, n = static_cast<s32>( fields.size() ); j < n; j++ ) {
+            stream->writeString( fields[j].name.c_str() );
+            stream->write( &fields[j].kind, sizeof( u8 ) );
+            stream->write( &fields[j].size, sizeof( u16 ) );
+        }
+
+        align( stream, origin );
+
+        // Write owning entity indices & component flags
+        stream->write( &section.entities[0], static_cast<s32>( section.entities.size() * sizeof( u32 ) ) );
+
+        for( s32 j = 0, n = static_cast<s32>( section.components.size() ); j < n; j++ ) {
+            u32 flags = section.components[j]->flags();
+            stream->write( &flags, sizeof( u32 ) );
+        }
+
+        align( stream, origin );
+
+        // Write packed component records
+        for( s32 j = 0, n = static_cast<s32>( section.components.size() ); j < n; j++ ) {
+            Reflection::Serializer::serialize( section.components[j]->metaInstance(), stream );
+        }
+
+        align( stream, origin );
+
+        info.size = static_cast<u32>( stream->position() - origin ) - info.offset;
+    }
+
+    // Now fill the section table
+    if( !infos.empty() ) {
+        s32 end = stream->position();
+        stream->setPosition( table );
+        stream->write( &infos[0], static_cast<s32>( infos.size() * sizeof( SectionInfo ) ) );
+        stream->setPosition( end );
+    }
+
+    return true;
+}
+
+// ** WorldSnapshot::load
+s32 WorldSnapshot::load( Reflection::AssemblyWPtr assembly, Io::StreamWPtr stream )
+{
+    NIMBLE_ABORT_IF( !assembly.valid(), "invalid assembly" );
+    NIMBLE_ABORT_IF( !stream.valid(), "invalid stream" );
+
+    // All snapshot offsets are relative to this position
+    s32 origin = stream->position();
+
+    // Read and validate a snapshot header
+    Header header;
+
+    if( stream->read( &header, sizeof( Header ) ) != sizeof( Header ) || header.magic != Magic ) {
+        LogError( "snapshot", "%s", "stream does not contain a world snapshot\n" );
+        return -1;
+    }
+
+    if( header.version > Version ) {
+        LogError( "snapshot", "unsupported snapshot version %d\n", header.version );
+        return -1;
+    }
+
+    // Read a section table
+    Array<SectionInfo> infos( header.sections );
+
+    if( !infos.empty() ) {
+        stream->read( &infos[0], static_cast<s32>( infos.size() * sizeof( SectionInfo ) ) );
+    }
+
+    // Read an entity table
+    Array<EntityId> ids( header.entities );
+    Array<u8>       flags( header.entities );
+
+    if( header.entities ) {
+        stream->read( &ids[0], static_cast<s32>( ids.size() * sizeof( EntityId ) ) );
+        stream->read( &flags[0], static_cast<s32>( flags.size() * sizeof( u8 ) ) );
+    }
+
+    // Entities are registered before reading components, so references between them are resolved
+    EntityArray entities( header.entities );
+
+    for( s32 i = 0, n = static_cast<s32>( ids.size() ); i < n; i++ ) {
+        EntityPtr entity = m_ecs->findEntity( ids[i] );
+
+        if( entity.valid() ) {
+            // An existing entity is restored in place, so detach all components that are not excluded
+            Array<TypeIdx> detached;
+            const Entity::Components& components = entity->components();
+
+            for( Entity::Components::const_iterator j = components.begin(), end = components.end(); j != end; ++j ) {
+                if( !m_excluded.is( j->first ) ) {
+                    detached.push_back( j->first );
+                }
+            }
+
+            for( s32 j = 0, count = static_cast<s32>( detached.size() ); j < count; j++ ) {
+                entity->detachById( detached[j] );
+            }
+        } else {
+            entity = m_ecs->createEntity( ids[i] );
+            m_ecs->addEntity( entity );
+        }
+
+        entity->setFlags( flags[i] );
+        entities[i] = entity;
+    }
+
+    // Now read component sections
+    for( s32 i = 0, n = static_cast<s32>( infos.size() ); i < n; i++ ) {
+        stream->setPosition( origin + infos[i].offset );
+
+        // Read a section header & stored property schema
+        SectionHeader sectionHeader;
+        stream->read( &sectionHeader, sizeof( SectionHeader ) );
+
+        String name;
+        stream->readString( name );
+
+        Fields fields( sectionHeader.fields );
+
+        for( s32 j = 0, count = static_cast<s32>( fields.size() ); j < count; j++ ) {
+            stream->readString( fields[j].name );
+            stream->read( &fields[j].kind, sizeof( u8 ) );
+            stream->read( &fields[j].size, sizeof( u16 ) );
+            fields[j].step = -1;
+        }
+
+        skipAlignment( stream, origin );
+
+        // Read owning entity indices & component flags
+        Array<u32> indices( sectionHeader.count );
+        Array<u32> componentFlags( sectionHeader.count );
+
+        if( sectionHeader.count ) {
+            stream->read( &indices[0], static_cast<s32>( indices.size() * sizeof( u32 ) ) );
+            stream->read( &componentFlags[0], static_cast<s32>( componentFlags.size() * sizeof( u32 ) ) );
+        }
+
+        skipAlignment( stream, origin );
+
+        // Read component records
+        bool evolved = false;
+
+        for( s32 j = 0, count = static_cast<s32>( indices.size() ); j < count; j++ ) {
+            Reflection::Instance instance = assembly->createInstance( name );
+
+            if( !instance ) {
+                LogWarning( "snapshot", "unknown component '%s' skipped\n", name.c_str() );
+                break;
+            }
+
+            ComponentBase* component = instance.upCast<ComponentBase>();
+
+            if( !component ) {
+                LogError( "snapshot", "'%s' is not a subclass of component\n", name.c_str() );
+                break;
+            }
+
+            // Compare a stored schema with a current one once per section
+            if( j == 0 ) {
+                Fields current = schemaFor( instance );
+                evolved = schemaHash( current ) != sectionHeader.schema;
+
+                if( evolved ) {
+                    LogDebug( "snapshot", "'%s' schema has changed, properties are matched by name\n", name.c_str() );
+
+                    // Match stored properties to current ones by name, value kind & size
+                    for( s32 k = 0, fieldCount = static_cast<s32>( fields.size() ); k < fieldCount; k++ ) {
+                        for( s32 l = 0, currentCount = static_cast<s32>( current.size() ); l < currentCount; l++ ) {
+                            if( fields[k].name == current[l].name && fields[k].kind == current[l].kind && fields[k].size == current[l].size ) {
+                                fields[k].step = current[l].step;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if( evolved ) {
+                readEvolvedRecord( instance, fields, stream );
+            } else {
+                Reflection::Serializer::deserialize( instance, stream );
+            }
+
+            component->setFlags( componentFlags[j] );
+
+            // Replace a component that was excluded when restoring an entity
+            EntityPtr& entity = entities[indices[j]];
+
+            if( entity->components().count( component->typeIndex() ) ) {
+                entity->detachById( component->typeIndex() );
+            }
+
+            entity->attachComponent( component );
+            entity->updateComponentBit( component->typeIndex(), component->isEnabled() );
+        }
+    }
+
+    // Move to the end of a snapshot
+    if( !infos.empty() ) {
+        const SectionInfo& last = infos.back();
+        stream->setPosition( origin + last.offset + last.size );
+    }
+
+    return static_cast<s32>( entities.size() );
+}
+
+// ** WorldSnapshot::readEvolvedRecord
+void WorldSnapshot::readEvolvedRecord( const Reflection::Instance& instance, const Fields& fields, Io::StreamWPtr stream ) const
+{
+    const Reflection::Class* cls = instance.type();
+    const Plan& plan = planFor( instance );
+
+    // Values that have no binary representation are read as variants
+    Io::BinaryVariantStream variants( stream.get() );
+
+    // Track properties that were read from a stream
+    Array<bool> restored( plan.size(), false );
+
+    for( s32 i = 0, n = static_cast<s32>( fields.size() ); i < n; i++ ) {
+        const Field& field = fields[i];
+        const Step*  step  = field.step >= 0 ? &plan[field.step] : NULL;
+
+        switch( field.kind ) {
+        case PlainField:    if( step ) {
+                                step->property->read( instance, stream );
+                            } else {
+                                stream->setPosition( field.size, Io::SeekCur );
+                            }
+                            break;
+
+        case StringField:   if( step ) {
+                                step->property->read( instance, stream );
+                            } else {
+                                String skipped;
+                                stream->readString( skipped );
+                            }
+                            break;
+
+        case VariantField:  {
+                                Variant value;
+                                variants.read( value );
+
+                                if( step && value.isValid() ) {
+                                    deserializeProperty( *cls, *step, instance, value );
+                                }
+                            }
+                            break;
+
+        default:            NIMBLE_NOT_IMPLEMENTED;
+        }
+
+        if( step ) {
+            restored[field.step] = true;
+        }
+    }
+
+    // Properties that were added after a snapshot was written are initialized with defaults
+    for( s32 i = 0, n = static_cast<s32>( plan.size() ); i < n; i++ ) {
+        const Step& step = plan[i];
+
+        if( restored[i] || !step.defaultValue ) {
+            continue;
+        }
+
+        Variant value = step.defaultValue( KeyValue() );
+
+        if( value.isValid() ) {
+            deserializeProperty( *cls, step, instance, value );
+        }
+    }
+}
+
+// ** WorldSnapshot::schemaFor
+WorldSnapshot::Fields WorldSnapshot::schemaFor( const Reflection::InstanceConst& instance ) const
+{
+    const Plan& plan = planFor( instance );
+    Fields      fields;
+
+    fields.reserve( plan.size() );
+
+    for( s32 i = 0, n = static_cast<s32>( plan.size() ); i < n; i++ ) {
+        const Step& step = plan[i];
+
+        Field field;
+        field.name = step.property->name();
+        field.size = 0;
+        field.step = i;
+
+        if( step.isBinary ) {
+            field.size = static_cast<u16>( step.property->binarySize() );
+            field.kind = field.size ? PlainField : StringField;
+        } else {
+            field.kind = VariantField;
+        }
+
+        fields.push_back( field );
+    }
+
+    return fields;
+}
+
+// ** WorldSnapshot::schemaHash
+u32 WorldSnapshot::schemaHash( const Fields& fields )
+{
+    // FNV-1a over property names, kinds & sizes
+    u32 hash = 2166136261u;
+
+    for( s32 i = 0, n = static_cast<s32>( fields.size() ); i < n; i++ ) {
+        const Field& field = fields[i];
+
+        for( s32 j = 0, length = static_cast<s32>( field.name.length() ); j < length; j++ ) {
+            hash = ( hash ^ static_cast<u8>( field.name[j] ) ) * 16777619u;
+        }
+
+        hash = ( hash ^ field.kind ) * 16777619u;
+        hash = ( hash ^ field.size ) * 16777619u;
+    }
+
+    return hash;
+}
+
+// ** WorldSnapshot::align
+void WorldSnapshot::align( Io::StreamWPtr stream, s32 origin )
+{
+    static const u8 zeros[Alignment] = { 0 };
+
+    s32 offset = ( stream->position() - origin ) % Alignment;
+
+    if( offset ) {
+        stream->write( zeros, Alignment - offset );
+    }
+}
+
+// ** WorldSnapshot::skipAlignment
+void WorldSnapshot::skipAlignment( Io::StreamWPtr stream, s32 origin )
+{
+    s32 offset = ( stream->position() - origin ) % Alignment;
+
+    if( offset ) {
+        stream->setPosition( Alignment - offset, Io::SeekCur );
+    }
+}
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
@@ -0,0 +1,138 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Ecs_WorldSnapshot_H__
+#define __DC_Ecs_WorldSnapshot_H__
+
+#include "EntitySerializer.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Ecs
+{
+    //! Writes entities to a compact binary snapshot and restores them back.
+    /*!
+     A snapshot starts with a header followed by an entity table and a single section per component type.
+     Each section stores a property schema, entity indices & component flags, followed by packed component
+     records. Plain data properties are copied as is, all other properties fall back to a Variant encoding through
+     the same converters that are used by an entity serializer. Sections are aligned and listed in an offset table,
+     so a snapshot can be mapped to memory and inspected without parsing it as a whole.
+
+     A property schema is stored for each section, when a component class changes between saving and loading
+     properties are matched by name, removed properties are skipped and added ones are initialized with
+     registered defaults.
+     */
+    class WorldSnapshot : public Serializer
+    {
+    public:
+
+        //! A snapshot format version.
+        enum { Version = 1 };
+
+                                            //! Constructs WorldSnapshot instance.
+                                            WorldSnapshot( EcsWPtr ecs, const Bitset& excluded = Bitset() );
+
+        //! Writes all world entities to a binary stream.
+        bool                                save( Io::StreamWPtr stream ) const;
+
+        //! Writes an array of entities to a binary stream.
+        bool                                save( const EntityArray& entities, Io::StreamWPtr stream ) const;
+
+        //! Reads entities from a binary stream and returns the total number of restored entities or -1 on error.
+        /*!
+         Entities that already exist in a world are restored in place, so a snapshot can be used
+         to rollback a world state. Entities that are not a part of a snapshot are left untouched.
+         */
+        s32                                 load( Reflection::AssemblyWPtr assembly, Io::StreamWPtr stream );
+
+    private:
+
+        //! Stored property kind.
+        enum FieldKind {
+              PlainField                    //!< A fixed size plain data value.
+            , StringField                   //!< A length-prefixed string.
+            , VariantField                  //!< A value encoded as Variant.
+        };
+
+        //! A stored property description.
+        struct Field {
+            String                          name;       //!< A property name.
+            u8                              kind;       //!< A property value kind.
+            u16                             size;       //!< A plain data value size.
+            s32                             step;       //!< Matching step of a current serialization plan or -1.
+        };
+
+        //! Container type to store a section schema.
+        typedef Array<Field>                Fields;
+
+        //! A snapshot header.
+        struct Header {
+            u32                             magic;      //!< A snapshot file marker.
+            u32                             version;    //!< A snapshot format version.
+            u32                             entities;   //!< The total number of stored entities.
+            u32                             sections;   //!< The total number of component sections.
+        };
+
+        //! A component section header.
+        struct SectionHeader {
+            u32                             count;      //!< The total number of components inside a section.
+            u32                             stride;     //!< A fixed component record size or 0 for variable size records.
+            u32                             schema;     //!< A property schema hash.
+            u32                             fields;     //!< The total number of stored properties.
+        };
+
+        //! A snapshot section offset & size.
+        struct SectionInfo {
+            u32                             offset;     //!< A section offset relative to a snapshot start.
+            u32                             size;       //!< A section size in bytes.
+        };
+
+        enum {
+              Magic     = 0x53574344    //!< A snapshot marker, reads as 'DCWS'.
+            , Alignment = 16            //!< Snapshot sections are aligned to this number of bytes.
+        };
+
+        //! Builds a property schema for a component instance.
+        Fields                              schemaFor( const Reflection::InstanceConst& instance ) const;
+
+        //! Calculates a property schema hash.
+        static u32                          schemaHash( const Fields& fields );
+
+        //! Writes padding bytes to align a stream position.
+        static void                         align( Io::StreamWPtr stream, s32 origin );
+
+        //! Skips padding bytes to align a stream position.
+        static void                         skipAlignment( Io::StreamWPtr stream, s32 origin );
+
+        //! Reads a component record with a schema that does not match a current one.
+        void                                readEvolvedRecord( const Reflection::Instance& instance, const Fields& fields, Io::StreamWPtr stream ) const;
+    };
+
+} // namespace Ecs
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Ecs_WorldSnapshot_H__    */
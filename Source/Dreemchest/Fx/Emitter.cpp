@@ -172,13 +172,14 @@ void Emitter::addBurst( f32 time, s32 count )
 }
 
 // ** Emitter::emit
-void Emitter::emit( Particle* particles, s32 first, s32 last, const Vec3& position, f32 time ) const
+void Emitter::emit( Particle* particles, s32 first, s32 last, const Vec3& position, f32 time, Random& random ) const
 {
     // Construct the simulation state instance
     SimulationState state;
     state.m_direction = Vec3( 0.0f, 0.0f, 0.0f );
     state.m_dt          = 0.0f;
     state.m_time      = time;
+    state.m_random      = &random;
 
     // Zero all particle data
     memset( particles->indices + first, 0, sizeof( particles->indices[0] ) * (last - first) );
@@ -189,18 +190,20 @@ void Emitter::emit( Particle* particles, s32 first, s32 last, const Vec3& positi
     memset( particles->transparency + first, 0, sizeof( particles->transparency[0] ) * (last - first) );
     memset( particles->color + first, 0, sizeof( particles->color[0] ) * (last - first) );
     memset( particles->angularVelocity + first, 0, sizeof( particles->angularVelocity[0] ) * (last - first) );
-    memset( particles->force + first, 0, sizeof( particles->force[0] ) * (last - first) );
+    memset( particles->velocity + first, 0, sizeof( particles->velocity[0] ) * (last - first) );
+    memset( particles->force.velocity + first, 0, sizeof( particles->force.velocity[0] ) * (last - first) );
+    memset( particles->force.acceleration + first, 0, sizeof( particles->force.acceleration[0] ) * (last - first) );
 
     // Initialize particle positions & initial velocities
     Vec3*             positions = particles->position;
-    Particle::Force* forces       = particles->force;
+    Vec3*             velocity  = particles->force.velocity;
     u32*             indices   = particles->indices;
 
     for( s32 i = first; i < last; i++ ) {
-        Zone::Point point    = m_zone.valid() ? m_zone->generateRandomPoint( time, position ) : Zone::Point( position, Vec3( 0.0f, -1.0f, 0.0f ) );
+        Zone::Point point    = m_zone.valid() ? m_zone->generateRandomPoint( random, time, position ) : Zone::Point( position, Vec3( 0.0f, -1.0f, 0.0f ) );
         positions[i]        = point.position;
-        forces[i].velocity    = point.direction;
-        indices[i]            = rand() % FloatParameter::LifetimeRandomizationCount;
+        velocity[i]            = point.direction;
+        indices[i]            = random.generate() % FloatParameter::LifetimeRandomizationCount;
     }
 
     // Run all emission modules
@@ -221,6 +224,20 @@ FloatParameter& Emitter::emission( void )
     return m_emission;
 }
 
+// ** Emitter::bake
+void Emitter::bake( void )
+{
+    m_emission.bake();
+
+    for( s32 i = 0, n = ( s32 )m_modules.size(); i < n; i++ ) {
+        m_modules[i]->bake();
+    }
+
+    for( s32 i = 0, n = ( s32 )m_particles.size(); i < n; i++ ) {
+        m_particles[i]->bake();
+    }
+}
+
 // ** Emitter::createInstance
 EmitterInstancePtr Emitter::createInstance( IMaterialFactoryWPtr materialFactory ) const
 {
@@ -237,6 +254,7 @@ EmitterInstance::EmitterInstance( IMaterialFactoryWPtr materialFactory, EmitterW
     , m_aliveCount( 0 )
     , m_iteration( 0 )
     , m_isStopped( false )
+    , m_random( rand() )
 {
     // Construct nested particles
     for( int i = 0, n = m_emitter->particlesCount(); i < n; i++ ) {
@@ -268,6 +286,12 @@ void EmitterInstance::restart( void )
     m_timeEmission  = 0.0f;
 }
 
+// ** EmitterInstance::setSeed
+void EmitterInstance::setSeed( u32 value )
+{
+    m_random.setSeed( value );
+}
+
 // ** EmitterInstance::calculateEmissionCount
 s32 EmitterInstance::calculateEmissionCount( f32 scalar, s32 maxCount )
 {
@@ -275,7 +299,7 @@ s32 EmitterInstance::calculateEmissionCount( f32 scalar, s32 maxCount )
     s32 count = 0;
 
     // Calculate emission rate
-    f32 rate = m_emitter->emission().sample( 0, scalar, -1.0f );
+    f32 rate = m_emitter->emission().sample( 0, scalar, -1.0f, &m_random );
 
     if( rate > 0.0f ) {
         count = min2( maxCount, ( s32 )floor( m_timeEmission * rate ) );
@@ -341,9 +365,28 @@ bool EmitterInstance::hasEnded( void ) const
 
 // ** EmitterInstance::update
 s32 EmitterInstance::update( f32 dt, const Vec3& position )
+{
+    // Simulate alive particles
+    for( u32 i = 0, n = ( u32 )m_particles.size(); i < n; i++ ) {
+        m_particles[i]->simulate( 0, m_particles[i]->aliveCount(), dt );
+    }
+
+    // Replace dead particles with new ones
+    emit( dt, position );
+
+    // Update bounding boxes
+    for( u32 i = 0, n = ( u32 )m_particles.size(); i < n; i++ ) {
+        ParticlesInstancePtr& particles = m_particles[i];
+        particles->setBounds( particles->calculateBounds( 0, particles->aliveCount() ) );
+    }
+
+    return m_aliveCount;
+}
+
+// ** EmitterInstance::emit
+s32 EmitterInstance::emit( f32 dt, const Vec3& position )
 {
     f32            duration = m_emitter->duration();
-    ZoneWPtr    zone     = m_emitter->zone();
     const Vec3& pos         = m_emitter->position();
 
     // Update the emitter time
@@ -356,8 +399,8 @@ s32 EmitterInstance::update( f32 dt, const Vec3& position )
         // Store item at index
         ParticlesInstancePtr& particles = m_particles[i];
 
-        // Update item and store alive count
-        s32 count = particles->update( dt );
+        // Remove dead particles and store alive count
+        s32 count = particles->compact();
 
         // We have dead particles - ready to emit
         s32 deadCount = particles->maxCount() - count;
@@ -366,7 +409,7 @@ s32 EmitterInstance::update( f32 dt, const Vec3& position )
             s32 emissionCount = calculateEmissionCount( m_time / duration, deadCount );
 
             if( emissionCount ) {
-                m_emitter->emit( &particles->items(), count, count + emissionCount, position + pos, m_time / duration );
+                m_emitter->emit( &particles->items(), count, count + emissionCount, position + pos, m_time / duration, m_random );
                 particles->addAliveCount( emissionCount );
                 particles->m_particles->update( &particles->items(), count, count + emissionCount, dt );
                 count += emissionCount;
@@ -100,8 +100,8 @@ namespace Fx {
         //! Removes particles from emitter.
         void                    removeParticles( const ParticlesWPtr& particles );
 
-        //! Emits new particles.
-        void                    emit( Particle* particles, s32 first, s32 last, const Vec3& position, f32 time ) const;
+        //! Emits new particles, all random values are taken from a specified generator.
+        void                    emit( Particle* particles, s32 first, s32 last, const Vec3& position, f32 time, Random& random ) const;
 
         //! Adds particles to an emitter.
         ParticlesWPtr            addParticles( void );
@@ -109,6 +109,9 @@ namespace Fx {
         //! Creates the particle emitter instance.
         EmitterInstancePtr        createInstance( IMaterialFactoryWPtr materialFactory ) const;
 
+        //! Bakes emission parameters and parameters of all particles into lookup tables.
+        void                    bake( void );
+
     private:
 
                                 //! Constructs the Emitter instance.
@@ -147,6 +150,9 @@ namespace Fx {
         //! Performs the emitter instance update.
         s32                        update( f32 dt, const Vec3& position );
 
+        //! Removes dead particles and emits new ones, particles should be already simulated for this time step.
+        s32                        emit( f32 dt, const Vec3& position );
+
         //! Performs the emitter warm up.
         void                    warmUp( f32 dt, const Vec3& position );
 
@@ -159,6 +165,9 @@ namespace Fx {
         //! Restarts a playback of an emitter.
         void                    restart( void );
 
+        //! Resets the random number generator used to emit particles.
+        void                    setSeed( u32 value );
+
     private:
 
                                 //! Constructs EmitterInstance instance.
@@ -183,6 +192,7 @@ namespace Fx {
         s32                        m_iteration;        //!< Current iteration index.
         Array<ParticleBurst>    m_bursts;            //!< Particle bursts.
         bool                    m_isStopped;        //!< Indicated that a particle emitter is stopped.
+        Random                    m_random;            //!< The random number generator owned by this instance, so emitters can run in parallel.
     };
 
 } // namespace Fx
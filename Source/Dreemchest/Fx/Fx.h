@@ -122,6 +122,7 @@ DC_END_DREEMCHEST
     #include "Particles.h"
     #include "Renderers.h"
     #include "Modules.h"
+    #include "Simd.h"
 #endif
 
 #endif    /*    !__DC_Fx_H__    */
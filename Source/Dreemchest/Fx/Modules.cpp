@@ -25,6 +25,7 @@
  **************************************************************************/
 
 #include "Modules.h"
+#include "Simd.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -38,7 +39,7 @@ void InitialLife::update( Particle* particles, s32 first, s32 last, const Simula
     Particle::Life* life = particles->life;
 
     for( s32 i = first; i < last; i++ ) {
-        life[i].current = life[i].initial = m_value.sample( 0, state.m_time, 1.0f );
+        life[i].current = life[i].initial = m_value.sample( 0, state.m_time, 1.0f, state.m_random );
     }
 }
 
@@ -74,20 +75,30 @@ FloatParameter&    LinearVelocity::z( void )
     return m_velocity[2];
 }
 
+// ** LinearVelocity::bake
+void LinearVelocity::bake( void )
+{
+    for( s32 i = 0; i < 3; i++ ) {
+        m_velocity[i].bake();
+    }
+}
+
 // ** LinearVelocity::update
 void LinearVelocity::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    const Particle::Life* life       = particles->life;
-    const u32*              indices  = particles->indices;
-    Vec3*                 velocity = particles->velocity;
-
-    for( s32 i = first; i < last; i++ ) {
-        f32 scalar = life[i].scalar;
-        u32 idx       = indices[i];
-
-        velocity[i].x += m_velocity[0].sample( idx, scalar, 0.0f );
-        velocity[i].y += m_velocity[1].sample( idx, scalar, 0.0f );
-        velocity[i].z += m_velocity[2].sample( idx, scalar, 0.0f );
+    const f32*  scalars  = &particles->life[first].scalar;
+    const u32*  indices  = particles->indices + first;
+    f32*        factors  = particles->scratch + first;
+    f32*        velocity = &particles->velocity[first].x;
+    s32         count    = last - first;
+
+    // Sample and accumulate each velocity axis separately
+    for( s32 axis = 0; axis < 3; axis++ ) {
+        m_velocity[axis].sample( indices, scalars, sizeof( Particle::Life ) / sizeof( f32 ), factors, count, 0.0f );
+
+        for( s32 i = 0; i < count; i++ ) {
+            velocity[i * 3 + axis] += factors[i];
+        }
     }
 }
 
@@ -96,12 +107,13 @@ void LinearVelocity::update( Particle* particles, s32 first, s32 last, const Sim
 // ** LimitVelocity::update
 void LimitVelocity::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    const Particle::Life* life       = particles->life;
-    const u32*              indices  = particles->indices;
-    Vec3*                 velocity = particles->velocity;
+    Vec3* velocity = particles->velocity;
+    f32*  maximums = particles->scratch;
+
+    m_value.sample( particles->indices + first, &particles->life[first].scalar, sizeof( Particle::Life ) / sizeof( f32 ), maximums + first, last - first, 0.0f );
 
     for( s32 i = first; i < last; i++ ) {
-        f32 maximum = m_value.sample( indices[i], life[i].scalar, 0.0f );
+        f32 maximum = maximums[i];
         f32 current = velocity[i].length();
 
         if( current <= maximum ) {
@@ -118,7 +130,7 @@ void LimitVelocity::update( Particle* particles, s32 first, s32 last, const Simu
 void InitialSize::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
     for( s32 i = first; i < last; i++ ) {
-        particles->size[i].initial = particles->size[i].current = m_value.sample( 0, state.m_time, 5 );
+        particles->size[i].initial = particles->size[i].current = m_value.sample( 0, state.m_time, 5, state.m_random );
     }
 }
 
@@ -127,13 +139,11 @@ void InitialSize::update( Particle* particles, s32 first, s32 last, const Simula
 // ** Size::update
 void Size::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    Particle::Scalar*      size    = particles->size;
-    const Particle::Life* life    = particles->life;
-    const u32*              indices = particles->indices;
+    f32* factors = particles->scratch;
 
-    for( s32 i = first; i < last; i++ ) {
-        size[i].current = size[i].initial * m_value.sample( indices[i], life[i].scalar, 1.0f );
-    }
+    m_value.sample( particles->indices + first, &particles->life[first].scalar, sizeof( Particle::Life ) / sizeof( f32 ), factors + first, last - first, 1.0f );
+
+    Simd::scale( particles->size + first, factors + first, last - first );
 }
 
 // -------------------------------------------------- InitialTransparency -------------------------------------------------- //
@@ -144,7 +154,7 @@ void InitialTransparency::update( Particle* particles, s32 first, s32 last, cons
     Particle::Scalar* transparency    = particles->transparency;
 
     for( s32 i = first; i < last; i++ ) {
-        transparency[i].initial = transparency[i].current = m_value.sample( 0, state.m_time, 1.0f );
+        transparency[i].initial = transparency[i].current = m_value.sample( 0, state.m_time, 1.0f, state.m_random );
     }
 }
 
@@ -153,13 +163,11 @@ void InitialTransparency::update( Particle* particles, s32 first, s32 last, cons
 // ** Transparency::update
 void Transparency::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    Particle::Scalar*      transparency    = particles->transparency;
-    const Particle::Life* life            = particles->life;
-    const u32*              indices        = particles->indices;
+    f32* factors = particles->scratch;
 
-    for( s32 i = first; i < last; i++ ) {
-        transparency[i].current = transparency[i].initial * m_value.sample( indices[i], life[i].scalar, 1.0f );
-    }
+    m_value.sample( particles->indices + first, &particles->life[first].scalar, sizeof( Particle::Life ) / sizeof( f32 ), factors + first, last - first, 1.0f );
+
+    Simd::scale( particles->transparency + first, factors + first, last - first );
 }
 
 // ----------------------------------------------------- InitialAngularVelocity ------------------------------------------------------ //
@@ -170,7 +178,7 @@ void InitialAngularVelocity::update( Particle* particles, s32 first, s32 last, c
     Particle::Scalar* angular = particles->angularVelocity;
 
     for( s32 i = first; i < last; i++ ) {
-        angular[i].current = angular[i].initial = m_value.sample( 0, state.m_time, 0.0f );
+        angular[i].current = angular[i].initial = m_value.sample( 0, state.m_time, 0.0f, state.m_random );
     }
 }
 
@@ -182,7 +190,7 @@ void InitialRotation::update( Particle* particles, s32 first, s32 last, const Si
     f32* rotation = particles->rotation;
 
     for( s32 i = first; i < last; i++ ) {
-        rotation[i] = m_value.sample( 0, state.m_time, 0.0f );
+        rotation[i] = m_value.sample( 0, state.m_time, 0.0f, state.m_random );
     }
 }
 
@@ -204,10 +212,11 @@ void Rotation::update( Particle* particles, s32 first, s32 last, const Simulatio
 // ** InitialSpeed::update
 void InitialSpeed::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    Particle::Force* force = particles->force;
+    Vec3* velocity = particles->force.velocity;
+    f32   speed    = m_value.sample( 0, state.m_time, 0, state.m_random );
 
     for( s32 i = first; i < last; i++ ) {
-        force[i].velocity *= m_value.sample( 0, state.m_time, 0 );
+        velocity[i] *= speed;
     }
 }
 
@@ -216,10 +225,11 @@ void InitialSpeed::update( Particle* particles, s32 first, s32 last, const Simul
 // ** InitialGravity::update
 void InitialGravity::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    Particle::Force* force = particles->force;
+    Vec3* acceleration = particles->force.acceleration;
+    f32   gravity      = m_value.sample( 0, state.m_time, 0, state.m_random );
 
     for( s32 i = first; i < last; i++ ) {
-        force[i].acceleration.y -= m_value.sample( 0, state.m_time, 0 );
+        acceleration[i].y -= gravity;
     }
 }
 
@@ -228,13 +238,11 @@ void InitialGravity::update( Particle* particles, s32 first, s32 last, const Sim
 // ** Acceleration::update
 void Acceleration::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    Vec3*            velocity = particles->velocity;
-    Particle::Force* force      = particles->force;
+    Particle::Force& force = particles->force;
 
-    for( s32 i = first; i < last; i++ ) {
-        force[i].velocity += force[i].acceleration * state.m_dt;
-        velocity[i]        = force[i].velocity;
-    }
+    // Integrate the force velocity as a flat stream of floats
+    Simd::madd( &force.velocity[first].x, &force.acceleration[first].x, state.m_dt, (last - first) * 3 );
+    memcpy( particles->velocity + first, force.velocity + first, sizeof( Vec3 ) * (last - first) );
 }
 
 // ------------------------------------------------------------ Position ------------------------------------------------------------- //
@@ -242,13 +250,7 @@ void Acceleration::update( Particle* particles, s32 first, s32 last, const Simul
 // ** Position::update
 void Position::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    const Vec3* velocity = particles->velocity;
-    //const Particle::Force* force      = particles->force;
-    Vec3*        position = particles->position;
-
-    for( s32 i = first; i < last; i++ ) {
-        position[i] += (velocity[i] /*+ force[i].velocity*/) * state.m_dt;
-    }
+    Simd::madd( &particles->position[first].x, &particles->velocity[first].x, state.m_dt, (last - first) * 3 );
 }
 
 // ----------------------------------------------------------- InitialColor ----------------------------------------------------------- //
@@ -260,7 +262,7 @@ void InitialColor::update( Particle* particles, s32 first, s32 last, const Simul
     Rgb                 white = Rgb( 1.0f, 1.0f, 1.0f );
 
     for( s32 i = first; i < last; i++ ) {
-        color[i].current = color[i].initial = m_value.sample( 0, state.m_time, white );
+        color[i].current = color[i].initial = m_value.sample( 0, state.m_time, white, state.m_random );
     }
 }
 
@@ -269,14 +271,11 @@ void InitialColor::update( Particle* particles, s32 first, s32 last, const Simul
 // ** Color::update
 void Color::update( Particle* particles, s32 first, s32 last, const SimulationState& state ) const
 {
-    Particle::Color*      color   = particles->color;
-    const Particle::Life* life      = particles->life;
-    const u32*              indices = particles->indices;
-    Rgb                      white      = Rgb( 1.0f, 1.0f, 1.0f );
+    Rgb* factors = reinterpret_cast<Rgb*>( particles->scratch );
 
-    for( s32 i = first; i < last; i++ ) {
-        color[i].current = color[i].initial * m_value.sample( indices[i], life[i].scalar, white );
-    }
+    m_value.sample( particles->indices + first, &particles->life[first].scalar, sizeof( Particle::Life ) / sizeof( f32 ), factors + first, last - first, Rgb( 1.0f, 1.0f, 1.0f ) );
+
+    Simd::scale( particles->color + first, factors + first, last - first );
 }
 
 } // namespace Fx
@@ -38,6 +38,7 @@ namespace Fx {
         f32            m_time;            //!< Current emitter time.
         f32            m_dt;            //!< Frame delta time.
         Vec3        m_direction;    //!< Current emitter direction.
+        Random*        m_random;        //!< The random number generator of an emitter instance, NULL when particles are simulated.
     };
 
     //! Base class for all particle modules.
@@ -52,6 +53,9 @@ namespace Fx {
 
         //! Returns module update priority.
         virtual s32             priority( void ) const = 0;
+
+        //! Bakes module parameters into lookup tables.
+        virtual void            bake( void ) {}
     };
 
     //! Generic class to simplify new module declaraion.
@@ -69,6 +73,9 @@ namespace Fx {
        //! Returns module execution priority.
         virtual s32             priority( void ) const NIMBLE_OVERRIDE;
 
+        //! Bakes the module parameter into lookup tables.
+        virtual void            bake( void ) NIMBLE_OVERRIDE;
+
     protected:
 
         TParameter                m_value;    //!< Parameter curve.
@@ -102,6 +109,13 @@ namespace Fx {
         return TPriority;
     }
 
+    // ** Module::bake
+    template<typename TModule, typename TParameter, s32 TPriority>
+    void Module<TModule, TParameter, TPriority>::bake( void )
+    {
+        m_value.bake();
+    }
+
     //! Initial life module setups the spawned particle.
     class InitialLife : public Module<InitialLife, FloatParameter, -1> {
     protected:
@@ -137,6 +151,9 @@ namespace Fx {
         //! Returns module execution priority.
         virtual s32            priority( void ) const NIMBLE_OVERRIDE { return 2; }
 
+        //! Bakes linear velocity parameters into lookup tables.
+        virtual void        bake( void ) NIMBLE_OVERRIDE;
+
     protected:
 
         //! Updates particle position according to a linear velocity.
@@ -27,7 +27,7 @@
 #ifndef __DC_Fx_Parameter_H__
 #define __DC_Fx_Parameter_H__
 
-#include "Fx.h"
+#include "Random.h"
 
 #define SampleParameter( idx, parameter, default )  ((parameter) ? (parameter)->sample( idx, scalar, default ) : (default))
 #define SampleKoeficient( idx, parameter, default ) SampleParameter( idx, parameter, default * 100.0f ) * 0.01f
@@ -51,6 +51,9 @@ namespace Fx {
         //! Compile time constant to define the randomization of particle lifetime parameters.
         enum { LifetimeRandomizationCount = 100 };
 
+        //! The number of samples stored in a baked lookup table for each curve.
+        enum { BakedSampleCount = 256 };
+
         //! Alias the curve type.
         typedef Curve<TValue>    CurveType;
 
@@ -82,23 +85,47 @@ namespace Fx {
         const CurveType&        curve( CurveIndex index ) const;
         CurveType&                curve( CurveIndex index );
 
-        //! Samples the parameter at specified time.
-        TValue                    sample( s32 particleIndex, f32 scalar, const TValue& defaultValue = TValue() ) const;
+        //! Samples the parameter at specified time, random values are taken from a specified generator or from the global one if it is NULL.
+        TValue                    sample( s32 particleIndex, f32 scalar, const TValue& defaultValue = TValue(), Random* random = NULL ) const;
+
+        //! Samples the parameter for a range of particles, scalars are read with a specified stride in floats.
+        void                    sample( const u32* particleIndices, const f32* scalars, s32 stride, TValue* result, s32 count, const TValue& defaultValue = TValue() ) const;
 
         //! Generates the particle curves.
         void                    constructLifetimeCurves( void );
 
+        //! Returns true if the parameter has up-to-date lookup tables.
+        bool                    isBaked( void ) const;
+
+        //! Evaluates parameter curves into lookup tables, does nothing if tables are up-to-date.
+        void                    bake( void );
+
+        //! Marks baked lookup tables as outdated, called each time the parameter is modified.
+        void                    invalidate( void );
+
+    private:
+
+        //! Appends a lookup table evaluated from a specified curve.
+        void                    bakeCurve( const CurveType& curve );
+
+        //! Samples a lookup table row at specified time.
+        static TValue            sampleTable( const TValue* row, f32 scalar );
+
     private:
 
         bool                    m_isEnabled;                    //!< The flag indicating that parameter is enabled.
+        bool                    m_isBaked;                        //!< The flag indicating that lookup tables are up-to-date.
+        bool                    m_isEmpty;                        //!< The flag indicating that a parameter had no keyframes when it was baked.
         SamplingMode            m_mode;                            //!< The parameter sampling mode.
         CurveType                m_curves[TotalCurveIndices];    //!< Minimum and maximum curves.
         Array<CurveType>        m_particleCurves;                //!< Used for randomization of lifetime parameters.
+        TValue                    m_constants[TotalCurveIndices];    //!< Baked minimum and maximum constant values.
+        Array<TValue>            m_table;                        //!< Baked lookup tables, a row of BakedSampleCount values per curve.
     };
 
     // ** Parameter::Parameter
     template<typename TValue>
-    Parameter<TValue>::Parameter( void ) : m_isEnabled( false ), m_mode( SampleConstant )
+    Parameter<TValue>::Parameter( void ) : m_isEnabled( false ), m_isBaked( false ), m_isEmpty( true ), m_mode( SampleConstant )
     {
 
     }
@@ -121,6 +148,8 @@ namespace Fx {
     template<typename TValue>
     void Parameter<TValue>::scale( f32 value )
     {
+        invalidate();
+
         for( s32 i = 0; i < TotalCurveIndices; i++ ) {
             for( s32 j = 0, n = m_curves[i].keyframeCount(); j < n; j++ ) {
                 m_curves[i].keyframe( j ).m_value *= value;
@@ -148,6 +177,8 @@ namespace Fx {
     template<typename TValue>
     typename Parameter<TValue>::CurveType& Parameter<TValue>::curve( CurveIndex index )
     {
+        // A curve returned by reference may be edited, so baked tables are no longer valid
+        invalidate();
         return m_curves[index];
     }
 
@@ -169,13 +200,100 @@ namespace Fx {
     template<typename TValue>
     void Parameter<TValue>::setSamplingMode( SamplingMode value )
     {
+        invalidate();
         m_mode = value;
     }
 
+    // ** Parameter::isBaked
+    template<typename TValue>
+    bool Parameter<TValue>::isBaked( void ) const
+    {
+        return m_isBaked;
+    }
+
+    // ** Parameter::invalidate
+    template<typename TValue>
+    void Parameter<TValue>::invalidate( void )
+    {
+        m_isBaked = false;
+    }
+
+    // ** Parameter::bake
+    template<typename TValue>
+    void Parameter<TValue>::bake( void )
+    {
+        if( m_isBaked ) {
+            return;
+        }
+
+        m_table.clear();
+        m_isBaked = true;
+
+        // Parameters without keyframes are sampled as default values, so there is nothing to bake
+        m_isEmpty = m_curves[Lower].keyframeCount() == 0;
+
+        if( m_isEmpty ) {
+            return;
+        }
+
+        switch( m_mode ) {
+        case SampleConstant:
+        case SampleRandomBetweenConstants:    {
+                                                m_curves[Lower].value( 0, m_constants[Lower] );
+                                                m_constants[Upper] = m_constants[Lower];
+
+                                                if( m_curves[Upper].keyframeCount() ) {
+                                                    m_curves[Upper].value( 0, m_constants[Upper] );
+                                                }
+                                            }
+                                            break;
+
+        case SampleCurve:                    {
+                                                bakeCurve( m_curves[Lower] );
+                                            }
+                                            break;
+
+        case SampleRandomBetweenCurves:        {
+                                                // Particle curves are derived from minimum and maximum curves, so they are regenerated too
+                                                constructLifetimeCurves();
+
+                                                for( s32 i = 0, n = ( s32 )m_particleCurves.size(); i < n; i++ ) {
+                                                    bakeCurve( m_particleCurves[i] );
+                                                }
+                                            }
+                                            break;
+        default:                            NIMBLE_NOT_IMPLEMENTED
+        }
+    }
+
+    // ** Parameter::bakeCurve
+    template<typename TValue>
+    void Parameter<TValue>::bakeCurve( const CurveType& curve )
+    {
+        for( s32 i = 0; i < BakedSampleCount; i++ ) {
+            TValue value;
+            curve.sample( static_cast<f32>( i ) / (BakedSampleCount - 1), value );
+            m_table.push_back( value );
+        }
+    }
+
+    // ** Parameter::sampleTable
+    template<typename TValue>
+    TValue Parameter<TValue>::sampleTable( const TValue* row, f32 scalar )
+    {
+        f32 x = scalar * (BakedSampleCount - 1);
+        s32 i = min2( static_cast<s32>( x ), static_cast<s32>( BakedSampleCount - 2 ) );
+        f32 t = x - i;
+
+        return row[i] + (row[i + 1] - row[i]) * t;
+    }
+
     // ** Parameter::constructLifetimeCurves
     template<typename TValue>
     void Parameter<TValue>::constructLifetimeCurves(  void )
     {
+        m_particleCurves.clear();
+
         s32                 size  = m_curves[Lower].keyframeCount() > m_curves[Upper].keyframeCount() ? m_curves[Lower].keyframeCount() : m_curves[Upper].keyframeCount();
         const CurveType& curve = m_curves[Lower].keyframeCount() > m_curves[Upper].keyframeCount() ? m_curves[Lower] : m_curves[Upper];
 
@@ -199,10 +317,25 @@ namespace Fx {
 
     // ** Parameter::sample
     template<typename TValue>
-    TValue Parameter<TValue>::sample( s32 particleIndex, f32 scalar, const TValue& defaultValue ) const
+    TValue Parameter<TValue>::sample( s32 particleIndex, f32 scalar, const TValue& defaultValue, Random* random ) const
     {
         NIMBLE_BREAK_IF( scalar < 0.0f || scalar > 1.0f, "scalar value is out of range" );
 
+        // Use lookup tables when they are up-to-date
+        if( m_isBaked ) {
+            if( m_isEmpty ) {
+                return defaultValue;
+            }
+
+            switch( m_mode ) {
+            case SampleConstant:                return m_constants[Lower];
+            case SampleRandomBetweenConstants:    return random ? random->value( m_constants[Lower], m_constants[Upper] ) : randomValue( m_constants[Lower], m_constants[Upper] );
+            case SampleCurve:                    return sampleTable( &m_table[0], scalar );
+            case SampleRandomBetweenCurves:        return sampleTable( &m_table[(particleIndex % LifetimeRandomizationCount) * BakedSampleCount], scalar );
+            default:                            NIMBLE_NOT_IMPLEMENTED
+            }
+        }
+
         // Set result to a default value
         TValue result = defaultValue;
 
@@ -216,7 +349,7 @@ namespace Fx {
                                                 m_curves[Lower].value( 0, a );
                                                 m_curves[Upper].value( 0, b );
 
-                                                result = randomValue( a, b );
+                                                result = random ? random->value( a, b ) : randomValue( a, b );
                                             }
                                             break;
 
@@ -240,6 +373,56 @@ namespace Fx {
         return result;
     }
 
+    // ** Parameter::sample
+    template<typename TValue>
+    void Parameter<TValue>::sample( const u32* particleIndices, const f32* scalars, s32 stride, TValue* result, s32 count, const TValue& defaultValue ) const
+    {
+        // Parameter is not baked - sample each particle separately
+        if( !m_isBaked ) {
+            for( s32 i = 0; i < count; i++ ) {
+                result[i] = sample( particleIndices[i], scalars[i * stride], defaultValue );
+            }
+            return;
+        }
+
+        // Parameters without keyframes are sampled as default values
+        if( m_isEmpty ) {
+            for( s32 i = 0; i < count; i++ ) {
+                result[i] = defaultValue;
+            }
+            return;
+        }
+
+        // Each particle is an index computation and a lerp between two table values
+        switch( m_mode ) {
+        case SampleConstant:                for( s32 i = 0; i < count; i++ ) {
+                                                result[i] = m_constants[Lower];
+                                            }
+                                            break;
+        case SampleRandomBetweenConstants:    for( s32 i = 0; i < count; i++ ) {
+                                                result[i] = randomValue( m_constants[Lower], m_constants[Upper] );
+                                            }
+                                            break;
+        case SampleCurve:                    {
+                                                const TValue* row = &m_table[0];
+
+                                                for( s32 i = 0; i < count; i++ ) {
+                                                    result[i] = sampleTable( row, scalars[i * stride] );
+                                                }
+                                            }
+                                            break;
+        case SampleRandomBetweenCurves:        {
+                                                const TValue* table = &m_table[0];
+
+                                                for( s32 i = 0; i < count; i++ ) {
+                                                    result[i] = sampleTable( table + (particleIndices[i] % LifetimeRandomizationCount) * BakedSampleCount, scalars[i * stride] );
+                                                }
+                                            }
+                                            break;
+        default:                            NIMBLE_NOT_IMPLEMENTED
+        }
+    }
+
     //! Float parameter type.
     class FloatParameter : public Parameter<f32> {
     public:
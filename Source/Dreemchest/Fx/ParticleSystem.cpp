@@ -32,6 +32,8 @@
 #include "Renderers.h"
 
 #include "../Io/DiskFileSystem.h"
+#include "../Threads/Task/TaskManager.h"
+#include "../Threads/Task/TaskProgress.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -74,6 +76,14 @@ EmitterWPtr ParticleSystem::addEmitter( void )
     return emitter;
 }
 
+// ** ParticleSystem::bake
+void ParticleSystem::bake( void )
+{
+    for( s32 i = 0, n = emitterCount(); i < n; i++ ) {
+        m_emitters[i]->bake();
+    }
+}
+
 // ** ParticleSystem::createInstance
 ParticleSystemInstancePtr ParticleSystem::createInstance( IMaterialFactoryWPtr materialFactory ) const
 {
@@ -145,6 +155,15 @@ void ParticleSystemInstance::restart( void )
     }
 }
 
+// ** ParticleSystemInstance::setSeed
+void ParticleSystemInstance::setSeed( u32 value )
+{
+    // Each emitter gets a distinct sequence, so emitters of the same type do not produce identical particles
+    for( s32 i = 0, n = emitterCount(); i < n; i++ ) {
+        emitter( i )->setSeed( value + i * 7919 );
+    }
+}
+
 // ** ParticleSystemInstance::stop
 void ParticleSystemInstance::stop( void )
 {
@@ -195,9 +214,26 @@ Bounds ParticleSystemInstance::bounds( void ) const
     return result;
 }
 
+// ** ParticleSystemInstance::taskManager
+Threads::TaskManagerWPtr ParticleSystemInstance::taskManager( void ) const
+{
+    return m_taskManager;
+}
+
+// ** ParticleSystemInstance::setTaskManager
+void ParticleSystemInstance::setTaskManager( Threads::TaskManagerWPtr value )
+{
+    m_taskManager = value;
+}
+
 // ** ParticleSystemInstance::update
 s32 ParticleSystemInstance::update( f32 dt )
 {
+    if( m_taskManager.valid() ) {
+        updateParallel( dt * m_timeScale );
+        return m_aliveCount;
+    }
+
     m_aliveCount = 0;
 
     for( u32 i = 0, n = ( u32 )m_emitters.size(); i < n; i++ ) {
@@ -207,6 +243,109 @@ s32 ParticleSystemInstance::update( f32 dt )
     return m_aliveCount;
 }
 
+// ** ParticleSystemInstance::updateParallel
+void ParticleSystemInstance::updateParallel( f32 dt )
+{
+    // Simulate alive particles, large particle ranges are split into several jobs
+    addParticleJobs( Job::SimulateParticles, dt );
+    dispatchJobs();
+
+    // Remove dead particles and emit new ones, emitters are independent so each one is a separate job
+    for( u32 i = 0, n = ( u32 )m_emitters.size(); i < n; i++ ) {
+        m_jobs.push_back( Job( Job::EmitParticles, m_emitters[i], ParticlesInstanceWPtr(), 0, 0, dt ) );
+    }
+    dispatchJobs();
+
+    m_aliveCount = 0;
+
+    for( u32 i = 0, n = ( u32 )m_emitters.size(); i < n; i++ ) {
+        m_aliveCount += m_emitters[i]->aliveCount();
+    }
+
+    // Calculate bounding boxes of particle chunks and merge them, particles without alive ones get an empty box
+    for( u32 i = 0, ne = ( u32 )m_emitters.size(); i < ne; i++ ) {
+        for( s32 j = 0, np = m_emitters[i]->particlesCount(); j < np; j++ ) {
+            m_emitters[i]->particles( j )->setBounds( Bounds() );
+        }
+    }
+
+    addParticleJobs( Job::CalculateBounds, dt );
+    dispatchJobs();
+}
+
+// ** ParticleSystemInstance::addParticleJobs
+void ParticleSystemInstance::addParticleJobs( Job::Type type, f32 dt )
+{
+    for( u32 i = 0, ne = ( u32 )m_emitters.size(); i < ne; i++ ) {
+        EmitterInstanceWPtr emitter = m_emitters[i];
+
+        for( s32 j = 0, np = emitter->particlesCount(); j < np; j++ ) {
+            ParticlesInstanceWPtr particles = emitter->particles( j );
+            s32                      count     = particles->aliveCount();
+
+            for( s32 first = 0; first < count; first += ParallelChunkSize ) {
+                m_jobs.push_back( Job( type, emitter, particles, first, min2( first + ParallelChunkSize, count ), dt ) );
+            }
+        }
+    }
+}
+
+// ** ParticleSystemInstance::dispatchJobs
+void ParticleSystemInstance::dispatchJobs( void )
+{
+    if( m_jobs.empty() ) {
+        return;
+    }
+
+    // Queue all jobs except the first one to worker threads
+    for( u32 i = 1, n = ( u32 )m_jobs.size(); i < n; i++ ) {
+        m_progress.push_back( m_taskManager->runBackgroundTask( dcThisMethod( ParticleSystemInstance::processJob ), &m_jobs[i] ) );
+    }
+
+    // The calling thread processes the first job itself
+    processJob( Threads::TaskProgressWPtr(), &m_jobs[0] );
+
+    for( u32 i = 0, n = ( u32 )m_progress.size(); i < n; i++ ) {
+        m_progress[i]->waitForCompletion();
+    }
+
+    // Merge bounding boxes in job order, chunks of the same particles instance are adjacent
+    for( u32 i = 0, n = ( u32 )m_jobs.size(); i < n; i++ ) {
+        const Job& job = m_jobs[i];
+
+        if( job.type != Job::CalculateBounds ) {
+            continue;
+        }
+
+        if( job.first == 0 ) {
+            job.particles->setBounds( job.bounds );
+            continue;
+        }
+
+        Bounds bounds = job.particles->bounds();
+        bounds += job.bounds;
+        job.particles->setBounds( bounds );
+    }
+
+    m_progress.clear();
+    m_jobs.clear();
+}
+
+// ** ParticleSystemInstance::processJob
+void ParticleSystemInstance::processJob( Threads::TaskProgressWPtr progress, void* userData )
+{
+    Job* job = reinterpret_cast<Job*>( userData );
+
+    switch( job->type ) {
+    case Job::SimulateParticles:    job->particles->simulate( job->first, job->last, job->dt );
+                                    break;
+    case Job::EmitParticles:        job->emitter->emit( job->dt, m_position );
+                                    break;
+    case Job::CalculateBounds:        job->bounds = job->particles->calculateBounds( job->first, job->last );
+                                    break;
+    }
+}
+
 // ** ParticleSystemInstance::warmUp
 void ParticleSystemInstance::warmUp( f32 dt )
 {
@@ -30,6 +30,8 @@
 #include "Fx.h"
 #include "Parameter.h"
 
+#include "../Threads/Threads.h"
+
 DC_BEGIN_DREEMCHEST
 
 namespace Fx {
@@ -56,6 +58,13 @@ namespace Fx {
         //! Creates a new instance if a particle system.
         ParticleSystemInstancePtr    createInstance( IMaterialFactoryWPtr materialFactory ) const;
 
+        //! Bakes parameters of all emitters into lookup tables, parameters that were not changed since the last call are skipped.
+        /*!
+         Should be called once a particle system is loaded and after it was edited, parameters that
+         were modified since the last call are sampled from curves until they are baked again.
+         */
+        void                        bake( void );
+
     private:
 
         EmittersArray                m_emitters;    //!< All particle emitters.
@@ -90,6 +99,9 @@ namespace Fx {
         //! Restarts a playback of a particle system.
         void                        restart( void );
 
+        //! Seeds random number generators of all emitters, instances with the same seed emit the same particles.
+        void                        setSeed( u32 value );
+
         //! Stops the playback of a particle system.
         void                        stop( void );
 
@@ -108,6 +120,51 @@ namespace Fx {
         //! Performs the particle system warmup with a specified time delta.
         void                        warmUp( f32 dt = 0.1f );
 
+        //! Returns the task manager used for a parallel update.
+        Threads::TaskManagerWPtr    taskManager( void ) const;
+
+        //! Sets the task manager used to update emitters and large particle ranges in parallel, a serial update is performed if it is not set.
+        void                        setTaskManager( Threads::TaskManagerWPtr value );
+
+    private:
+
+        //! The maximum number of particles processed by a single job.
+        enum { ParallelChunkSize = 8192 };
+
+        //! A unit of work performed by a parallel update.
+        struct Job {
+            //! Available job types.
+            enum Type {
+                  SimulateParticles    //!< Runs particle modules over a particle range.
+                , EmitParticles        //!< Removes dead particles and emits new ones.
+                , CalculateBounds    //!< Calculates the bounding box of a particle range.
+            };
+
+                                    //! Constructs the Job instance.
+                                    Job( Type type, EmitterInstanceWPtr emitter, ParticlesInstanceWPtr particles, s32 first, s32 last, f32 dt )
+                                        : type( type ), emitter( emitter ), particles( particles ), first( first ), last( last ), dt( dt ) {}
+
+            Type                    type;        //!< The job type.
+            EmitterInstanceWPtr        emitter;    //!< Emitter instance to process.
+            ParticlesInstanceWPtr    particles;    //!< Particles instance to process.
+            s32                        first;        //!< The first particle to process.
+            s32                        last;        //!< The particle index after the last one to process.
+            f32                        dt;            //!< The simulation time step.
+            Bounds                    bounds;        //!< Calculated bounding box.
+        };
+
+        //! Performs the particle system update using the task manager.
+        void                        updateParallel( f32 dt );
+
+        //! Adds jobs of a specified type that split alive particles of each emitter into chunks.
+        void                        addParticleJobs( Job::Type type, f32 dt );
+
+        //! Runs all queued jobs and waits for their completion.
+        void                        dispatchJobs( void );
+
+        //! Task function that processes a single job.
+        void                        processJob( Threads::TaskProgressWPtr progress, void* userData );
+
     private:
 
                                     //! Constructs ParticleSystemInstance instance.
@@ -120,6 +177,9 @@ namespace Fx {
         Vec3                        m_position;            //!< Current instance position.
         f32                            m_timeScale;        //!< The time scaling factor.
         s32                            m_aliveCount;        //!< The total number of alive particles.
+        Threads::TaskManagerWPtr    m_taskManager;        //!< Task manager used for a parallel update.
+        Array<Job>                    m_jobs;                //!< Jobs queued for a parallel update.
+        Array<Threads::TaskProgressPtr>    m_progress;        //!< Progress of jobs that are dispatched to worker threads.
     };
 
 } // namespace Fx
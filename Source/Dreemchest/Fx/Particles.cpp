@@ -29,6 +29,7 @@
 #include "Renderers.h"
 #include "Zones.h"
 #include "Modules.h"
+#include "Simd.h"
 
 #define ScalarParam( name ) m_scalar[name] ? &m_scalar[name] : NULL
 #define ColorParam( name )  m_color[name]  ? &m_color[name]  : NULL
@@ -37,6 +38,95 @@ DC_BEGIN_DREEMCHEST
 
 namespace Fx {
 
+// ------------------------------------------------ Particle ------------------------------------------------ //
+
+// ** Particle::Particle
+Particle::Particle( void )
+    : indices( NULL ), position( NULL ), velocity( NULL ), rotation( NULL ), life( NULL ), size( NULL ), transparency( NULL ), color( NULL ), angularVelocity( NULL ), scratch( NULL ), remap( NULL )
+{
+    force.velocity     = NULL;
+    force.acceleration = NULL;
+}
+
+// ** Particle::~Particle
+Particle::~Particle( void )
+{
+    Simd::release( indices );
+    Simd::release( position );
+    Simd::release( velocity );
+    Simd::release( rotation );
+    Simd::release( life );
+    Simd::release( size );
+    Simd::release( transparency );
+    Simd::release( color );
+    Simd::release( angularVelocity );
+    Simd::release( force.velocity );
+    Simd::release( force.acceleration );
+    Simd::release( scratch );
+    Simd::release( remap );
+}
+
+// ** Particle::allocate
+void Particle::allocate( s32 count )
+{
+    NIMBLE_ABORT_IF( indices != NULL, "particle data was already allocated" );
+
+    s32 padded = Simd::paddedCount( count );
+
+    indices            = reinterpret_cast<u32*>( Simd::allocate( sizeof( u32 ) * padded ) );
+    position        = reinterpret_cast<Vec3*>( Simd::allocate( sizeof( Vec3 ) * padded ) );
+    velocity        = reinterpret_cast<Vec3*>( Simd::allocate( sizeof( Vec3 ) * padded ) );
+    rotation        = reinterpret_cast<f32*>( Simd::allocate( sizeof( f32 ) * padded ) );
+    life            = reinterpret_cast<Life*>( Simd::allocate( sizeof( Life ) * padded ) );
+    size            = reinterpret_cast<Scalar*>( Simd::allocate( sizeof( Scalar ) * padded ) );
+    transparency    = reinterpret_cast<Scalar*>( Simd::allocate( sizeof( Scalar ) * padded ) );
+    color            = reinterpret_cast<Color*>( Simd::allocate( sizeof( Color ) * padded ) );
+    angularVelocity    = reinterpret_cast<Scalar*>( Simd::allocate( sizeof( Scalar ) * padded ) );
+    force.velocity    = reinterpret_cast<Vec3*>( Simd::allocate( sizeof( Vec3 ) * padded ) );
+    force.acceleration = reinterpret_cast<Vec3*>( Simd::allocate( sizeof( Vec3 ) * padded ) );
+
+    // Scratch array is large enough to hold a color value per particle
+    scratch            = reinterpret_cast<f32*>( Simd::allocate( sizeof( Rgb ) * padded ) );
+    remap            = reinterpret_cast<u32*>( Simd::allocate( sizeof( u32 ) * padded ) );
+
+    // Padding elements are read by kernels, so they should contain valid numbers
+    memset( position, 0, sizeof( Vec3 ) * padded );
+    memset( color, 0, sizeof( Color ) * padded );
+    memset( scratch, 0, sizeof( Rgb ) * padded );
+}
+
+// ** Particle::compact
+s32 Particle::compact( s32 count )
+{
+    // Build the list of alive particles without branches
+    s32 alive = 0;
+
+    for( s32 i = 0; i < count; i++ ) {
+        remap[alive] = i;
+        alive += life[i].current >= 0.0f ? 1 : 0;
+    }
+
+    // Nothing to remove
+    if( alive == count ) {
+        return count;
+    }
+
+    // Move each attribute array in a separate pass, a source index is never less than a destination one
+    Simd::gather( indices, remap, alive );
+    Simd::gather( position, remap, alive );
+    Simd::gather( velocity, remap, alive );
+    Simd::gather( rotation, remap, alive );
+    Simd::gather( life, remap, alive );
+    Simd::gather( size, remap, alive );
+    Simd::gather( transparency, remap, alive );
+    Simd::gather( color, remap, alive );
+    Simd::gather( angularVelocity, remap, alive );
+    Simd::gather( force.velocity, remap, alive );
+    Simd::gather( force.acceleration, remap, alive );
+
+    return alive;
+}
+
 // ----------------------------------------------- Particles ----------------------------------------------- //
 
 // ** Particles::Particles
@@ -110,6 +200,19 @@ void Particles::setRenderingMode( RenderingMode value )
     m_renderingMode = value;
 }
 
+// ** Particles::moduleCount
+s32 Particles::moduleCount( void ) const
+{
+    return static_cast<s32>( m_modules.size() );
+}
+
+// ** Particles::module
+ModuleWPtr Particles::module( s32 index ) const
+{
+    NIMBLE_ABORT_IF( index < 0 || index >= moduleCount(), "index is out of range" );
+    return m_modules[index];
+}
+
 // ** Particles::addModule
 void Particles::addModule( const ModulePtr& module )
 {
@@ -126,6 +229,14 @@ void Particles::addModule( const ModulePtr& module )
     std::sort( m_modules.begin(), m_modules.end(), Priority::less );
 }
 
+// ** Particles::bake
+void Particles::bake( void )
+{
+    for( s32 i = 0, n = ( s32 )m_modules.size(); i < n; i++ ) {
+        m_modules[i]->bake();
+    }
+}
+
 // ** Particles::update
 void Particles::update( Particle* particles, s32 first, s32 last, f32 dt ) const
 {
@@ -134,6 +245,7 @@ void Particles::update( Particle* particles, s32 first, s32 last, f32 dt ) const
     state.m_direction = Vec3( 0.0f, 0.0f, 0.0f );
     state.m_dt          = dt;
     state.m_time      = 0.0f;
+    state.m_random      = NULL;
 
     // Run all life time modules
     for( s32 i = 0, n = ( s32 )m_modules.size(); i < n; i++ ) {
@@ -146,18 +258,7 @@ void Particles::update( Particle* particles, s32 first, s32 last, f32 dt ) const
 // ** ParticlesInstance::ParticlesInstance
 ParticlesInstance::ParticlesInstance( IMaterialFactoryWPtr materialFactory, ParticlesWPtr particles ) : m_particles( particles ), m_aliveCount( 0 )
 {
-    s32 count = m_particles->count();
-
-    m_items.life            = new Particle::Life[count];
-    m_items.position        = new Vec3[count];
-    m_items.velocity        = new Vec3[count];
-    m_items.size            = new Particle::Scalar[count];
-    m_items.indices            = new u32[count];
-    m_items.transparency    = new Particle::Scalar[count];
-    m_items.rotation        = new f32[count];
-    m_items.angularVelocity    = new Particle::Scalar[count];
-    m_items.force            = new Particle::Force[count];
-    m_items.color            = new Particle::Color[count];
+    m_items.allocate( m_particles->count() );
 
     if( materialFactory.valid() ) {
         m_material = materialFactory->createMaterial( particles->material() );
@@ -218,54 +319,47 @@ const Bounds& ParticlesInstance::bounds( void ) const
     return m_bounds;
 }
 
+// ** ParticlesInstance::setBounds
+void ParticlesInstance::setBounds( const Bounds& value )
+{
+    m_bounds = value;
+}
+
 // ** ParticlesInstance::update
 s32 ParticlesInstance::update( f32 dt )
 {
-    // Lock particles
-    Particle* particles = &items();
-
     // Update particles
-    m_particles->update( particles, 0, m_aliveCount, dt );
-
-    // Calculate alive particles count & particle bounding box.
-    s32    count = m_aliveCount;
-    Bounds bounds;
-    
-    for( s32 i = 0; i < count; i++ ) {
-        // Particle is alive - skip it
-        if( m_items.life[i].current >= 0.0f ) {
-            f32 size = -particles->size[i].current;
-            bounds << particles->position[i] - Vec3( size, size, size ) << particles->position[i] + Vec3( size, size, size );
-            continue;
-        }
-
-        // Decrease the alive particles counter
-        count = count - 1;
-
-        // Swap data
-        particles->indices[i]            = particles->indices[count];
-        particles->position[i]            = particles->position[count];
-        particles->rotation[i]            = particles->rotation[count];
-        particles->life[i]                = particles->life[count];
-        particles->size[i]                = particles->size[count];
-        particles->transparency[i]        = particles->transparency[count];
-        particles->color[i]                = particles->color[count];
-        particles->angularVelocity[i]    = particles->angularVelocity[count];
-        particles->force[i]                = particles->force[count];
-
-        // Decrease counter
-        i = i - 1;
-    }
+    simulate( 0, m_aliveCount, dt );
 
-    // Save alive count
-    m_aliveCount = count;
+    // Remove dead particles
+    compact();
 
     // Save particle bounds
-    m_bounds = bounds;
+    m_bounds = calculateBounds( 0, m_aliveCount );
+
+    return m_aliveCount;
+}
+
+// ** ParticlesInstance::simulate
+void ParticlesInstance::simulate( s32 first, s32 last, f32 dt )
+{
+    NIMBLE_BREAK_IF( first < 0 || last > m_aliveCount, "particle range is out of bounds" );
+    m_particles->update( &m_items, first, last, dt );
+}
 
+// ** ParticlesInstance::compact
+s32 ParticlesInstance::compact( void )
+{
+    m_aliveCount = m_items.compact( m_aliveCount );
     return m_aliveCount;
 }
 
+// ** ParticlesInstance::calculateBounds
+Bounds ParticlesInstance::calculateBounds( s32 first, s32 last ) const
+{
+    return Simd::bounds( m_items.position + first, m_items.size + first, last - first );
+}
+
 } // namespace Fx
 
 DC_END_DREEMCHEST
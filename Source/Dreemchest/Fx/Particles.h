@@ -48,10 +48,10 @@ namespace Fx {
             f32        current;        //!< Current parameter value.
         };
 
-        //! Stores aggregated forces applied to particle.
+        //! Stores aggregated forces applied to particle, each component is a separate array so it can be integrated as a flat stream.
         struct Force {
-            Vec3    velocity;        //!< Additional particle velocity due to particle acceleration.
-            Vec3    acceleration;    //!< Particle acceleration due to applied force.
+            Vec3*   velocity;       //!< Additional particle velocity due to particle acceleration.
+            Vec3*   acceleration;   //!< Particle acceleration due to applied force.
         };
 
         //! Stores particle color.
@@ -69,24 +69,19 @@ namespace Fx {
         Scalar*            transparency;        //!< Particle transparency.
         Color*            color;                //!< Particle color.
         Scalar*            angularVelocity;    //!< Particle angular velocity.
-        Force*            force;                //!< Particle external forces.
+        Force            force;                //!< Particle external forces.
+        f32*            scratch;            //!< Per-particle temporary values used by modules.
+        u32*            remap;                //!< Source indices of alive particles filled by a compaction pass.
 
                         //! Constructs Particle instance.
-                        Particle( void )
-                            : indices( NULL ), position( NULL ), rotation( NULL ), life( NULL ), size( NULL ), transparency( NULL ), color( NULL ), angularVelocity( NULL ), force( NULL ) {}
-                        ~Particle( void )
-                        {
-                            delete[]indices;
-                            delete[]position;
-                            delete[]velocity;
-                            delete[]rotation;
-                            delete[]life;
-                            delete[]size;
-                            delete[]transparency;
-                            delete[]color;
-                            delete[]angularVelocity;
-                            delete[]force;
-                        }
+                        Particle( void );
+                        ~Particle( void );
+
+        //! Allocates aligned particle arrays for a specified capacity.
+        void            allocate( s32 count );
+
+        //! Removes dead particles from a range [0, count) preserving the order of alive ones, returns the number of alive particles.
+        s32                compact( s32 count );
     };
 
     //! Particles contains an array of particles and a set of simulation parameters.
@@ -124,12 +119,21 @@ namespace Fx {
         //! Adds new module instance.
         void                    addModule( const ModulePtr& module );
 
+        //! Returns the total number of modules.
+        s32                        moduleCount( void ) const;
+
+        //! Returns the module by index, modules are sorted by execution priority.
+        ModuleWPtr                module( s32 index ) const;
+
         //! Updates the group of particles.
         void                    update( Particle* items, s32 first, s32 last, f32 dt ) const;
 
         //! Creates particles instance with a specified material factory.
         ParticlesInstancePtr    createInstance( IMaterialFactoryWPtr materialFactory ) const;
 
+        //! Bakes parameters of all modules into lookup tables.
+        void                    bake( void );
+
     private:
 
                                 //! Constructs Particles instance.
@@ -176,6 +180,18 @@ namespace Fx {
         //! Updates the particles.
         s32                        update( f32 dt );
 
+        //! Runs the particle modules over a range of alive particles, ranges that do not overlap can be simulated in parallel.
+        void                    simulate( s32 first, s32 last, f32 dt );
+
+        //! Removes dead particles and returns the number of alive ones.
+        s32                        compact( void );
+
+        //! Calculates the bounding box of a range of alive particles.
+        Bounds                    calculateBounds( s32 first, s32 last ) const;
+
+        //! Sets the particles bounding box.
+        void                    setBounds( const Bounds& value );
+
     private:
 
                                 //! Constructs the ParticlesInstance instance.
@@ -0,0 +1,96 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "Random.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Fx {
+
+// ** Random::Random
+Random::Random( u32 seed )
+{
+    setSeed( seed );
+}
+
+// ** Random::setSeed
+void Random::setSeed( u32 value )
+{
+    // Xorshift state should never be zero
+    m_state = value ? value : 0x9e3779b9;
+}
+
+// ** Random::generate
+u32 Random::generate( void )
+{
+    u32 x = m_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    m_state = x;
+    return x;
+}
+
+// ** Random::scalar
+f32 Random::scalar( f32 min, f32 max )
+{
+    // Use the upper 24 bits to get an exactly representable float in [0, 1]
+    f32 t = (generate() >> 8) / static_cast<f32>( 0xffffff );
+    return min + (max - min) * t;
+}
+
+// ** Random::direction2
+Vec2 Random::direction2( void )
+{
+    f32 angle = radians( scalar( 0.0f, 360.0f ) );
+    return Vec2( cosf( angle ), sinf( angle ) );
+}
+
+// ** Random::direction
+Vec3 Random::direction( void )
+{
+    f32 z     = scalar( -1.0f, 1.0f );
+    f32 angle = radians( scalar( 0.0f, 360.0f ) );
+    f32 r     = sqrtf( max2( 0.0f, 1.0f - z * z ) );
+
+    return Vec3( r * cosf( angle ), r * sinf( angle ), z );
+}
+
+// ** Random::hemisphereDirection
+Vec3 Random::hemisphereDirection( const Vec3& normal )
+{
+    Vec3 direction = this->direction();
+
+    if( direction.x * normal.x + direction.y * normal.y + direction.z * normal.z < 0.0f ) {
+        direction = Vec3( -direction.x, -direction.y, -direction.z );
+    }
+
+    return direction;
+}
+
+} // namespace Fx
+
+DC_END_DREEMCHEST
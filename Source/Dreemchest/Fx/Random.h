@@ -0,0 +1,86 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Fx_Random_H__
+#define __DC_Fx_Random_H__
+
+#include "Fx.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Fx {
+
+    //! Pseudo-random number generator with an explicit state.
+    /*!
+     Each emitter instance owns a generator, so emission jobs that run in parallel never
+     touch the shared C runtime generator and a simulation seeded with the same value
+     produces the same particles no matter how it was scheduled.
+     */
+    class Random {
+    public:
+
+                        //! Constructs the Random instance with a specified seed.
+                        Random( u32 seed = 1 );
+
+        //! Resets the generator state to a specified seed.
+        void            setSeed( u32 value );
+
+        //! Generates the next 32-bit value.
+        u32             generate( void );
+
+        //! Generates the scalar value in a specified range.
+        f32             scalar( f32 min, f32 max );
+
+        //! Generates the value between two specified ones.
+        template<typename TValue>
+        TValue          value( const TValue& min, const TValue& max );
+
+        //! Generates the random unit vector on XY plane.
+        Vec2            direction2( void );
+
+        //! Generates the random unit vector.
+        Vec3            direction( void );
+
+        //! Generates the random unit vector on a hemisphere around the specified normal.
+        Vec3            hemisphereDirection( const Vec3& normal );
+
+    private:
+
+        u32             m_state;    //!< The current generator state.
+    };
+
+    // ** Random::value
+    template<typename TValue>
+    TValue Random::value( const TValue& min, const TValue& max )
+    {
+        return min + (max - min) * scalar( 0.0f, 1.0f );
+    }
+
+} // namespace Fx
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Fx_Random_H__    */
@@ -0,0 +1,212 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "Simd.h"
+
+#include <float.h>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Fx {
+
+namespace Simd {
+
+// ** paddedCount
+s32 paddedCount( s32 count )
+{
+    // Reserve an extra element so a four-float load of the last Vec3 or Rgb stays inside an array
+    return ((count + 1 + Width - 1) / Width) * Width;
+}
+
+// ** allocate
+void* allocate( s32 size )
+{
+    // Allocate a block large enough to hold an alignment gap and an original pointer
+    u8* block = reinterpret_cast<u8*>( malloc( size + Alignment + sizeof( void* ) ) );
+    NIMBLE_ABORT_IF( block == NULL, "failed to allocate particle data" );
+
+    // Align the returned pointer and save the original one right before it
+    u8* aligned = reinterpret_cast<u8*>( (reinterpret_cast<size_t>( block ) + sizeof( void* ) + Alignment - 1) & ~static_cast<size_t>( Alignment - 1 ) );
+    reinterpret_cast<void**>( aligned )[-1] = block;
+
+    return aligned;
+}
+
+// ** release
+void release( void* pointer )
+{
+    if( pointer ) {
+        free( reinterpret_cast<void**>( pointer )[-1] );
+    }
+}
+
+// ** madd
+void madd( f32* dst, const f32* src, f32 scale, s32 count )
+{
+    s32 i = 0;
+
+#if defined( DC_FX_SIMD_AVX )
+    __m256 s = _mm256_set1_ps( scale );
+
+    for( ; i + 8 <= count; i += 8 ) {
+        _mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( dst + i ), _mm256_mul_ps( _mm256_loadu_ps( src + i ), s ) ) );
+    }
+#elif defined( DC_FX_SIMD_SSE )
+    __m128 s = _mm_set1_ps( scale );
+
+    for( ; i + 4 <= count; i += 4 ) {
+        _mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( _mm_loadu_ps( src + i ), s ) ) );
+    }
+#elif defined( DC_FX_SIMD_NEON )
+    float32x4_t s = vdupq_n_f32( scale );
+
+    for( ; i + 4 <= count; i += 4 ) {
+        vst1q_f32( dst + i, vmlaq_f32( vld1q_f32( dst + i ), vld1q_f32( src + i ), s ) );
+    }
+#endif
+
+    // Process the rest of a stream
+    for( ; i < count; i++ ) {
+        dst[i] += src[i] * scale;
+    }
+}
+
+// ** scale
+void scale( Particle::Scalar* items, const f32* factors, s32 count )
+{
+    s32 i = 0;
+
+#if defined( DC_FX_SIMD_AVX ) || defined( DC_FX_SIMD_SSE )
+    // Each register holds two particles: [initial0, current0, initial1, current1]
+    f32* data = reinterpret_cast<f32*>( items );
+
+    for( ; i + 2 <= count; i += 2 ) {
+        __m128 x = _mm_loadu_ps( data + i * 2 );
+        __m128 f = _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const f64*>( factors + i ) ) );
+        __m128 p = _mm_mul_ps( x, _mm_unpacklo_ps( f, f ) );
+        __m128 t = _mm_shuffle_ps( x, p, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+        _mm_storeu_ps( data + i * 2, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 3, 1, 2, 0 ) ) );
+    }
+#elif defined( DC_FX_SIMD_NEON )
+    // Deinterleave initial and current values, four particles at a time
+    f32* data = reinterpret_cast<f32*>( items );
+
+    for( ; i + 4 <= count; i += 4 ) {
+        float32x4x2_t x = vld2q_f32( data + i * 2 );
+        x.val[1] = vmulq_f32( x.val[0], vld1q_f32( factors + i ) );
+        vst2q_f32( data + i * 2, x );
+    }
+#endif
+
+    // Process the rest of particles
+    for( ; i < count; i++ ) {
+        items[i].current = items[i].initial * factors[i];
+    }
+}
+
+// ** scale
+void scale( Particle::Color* items, const Rgb* factors, s32 count )
+{
+#if defined( DC_FX_SIMD_AVX ) || defined( DC_FX_SIMD_SSE )
+    // Colors are not a multiple of a register width, so multiply four lanes and store only three of them
+    for( s32 i = 0; i < count; i++ ) {
+        __m128 c = _mm_mul_ps( _mm_loadu_ps( &items[i].initial.r ), _mm_loadu_ps( &factors[i].r ) );
+        _mm_storel_pi( reinterpret_cast<__m64*>( &items[i].current.r ), c );
+        _mm_store_ss( &items[i].current.b, _mm_movehl_ps( c, c ) );
+    }
+#elif defined( DC_FX_SIMD_NEON )
+    for( s32 i = 0; i < count; i++ ) {
+        float32x4_t c = vmulq_f32( vld1q_f32( &items[i].initial.r ), vld1q_f32( &factors[i].r ) );
+        vst1_f32( &items[i].current.r, vget_low_f32( c ) );
+        vst1q_lane_f32( &items[i].current.b, c, 2 );
+    }
+#else
+    for( s32 i = 0; i < count; i++ ) {
+        items[i].current = items[i].initial * factors[i];
+    }
+#endif
+}
+
+// ** bounds
+Bounds bounds( const Vec3* position, const Particle::Scalar* size, s32 count )
+{
+    if( count == 0 ) {
+        return Bounds();
+    }
+
+#if defined( DC_FX_SIMD_AVX ) || defined( DC_FX_SIMD_SSE )
+    // The fourth lane reads the next array element, it is never written back
+    __m128 min  = _mm_set1_ps(  FLT_MAX );
+    __m128 max  = _mm_set1_ps( -FLT_MAX );
+    __m128 sign = _mm_set1_ps( -0.0f );
+
+    for( s32 i = 0; i < count; i++ ) {
+        __m128 p = _mm_loadu_ps( &position[i].x );
+        __m128 s = _mm_andnot_ps( sign, _mm_set1_ps( size[i].current ) );
+        min = _mm_min_ps( min, _mm_sub_ps( p, s ) );
+        max = _mm_max_ps( max, _mm_add_ps( p, s ) );
+    }
+
+    f32 lower[4], upper[4];
+    _mm_storeu_ps( lower, min );
+    _mm_storeu_ps( upper, max );
+#elif defined( DC_FX_SIMD_NEON )
+    float32x4_t min = vdupq_n_f32(  FLT_MAX );
+    float32x4_t max = vdupq_n_f32( -FLT_MAX );
+
+    for( s32 i = 0; i < count; i++ ) {
+        float32x4_t p = vld1q_f32( &position[i].x );
+        float32x4_t s = vdupq_n_f32( fabsf( size[i].current ) );
+        min = vminq_f32( min, vsubq_f32( p, s ) );
+        max = vmaxq_f32( max, vaddq_f32( p, s ) );
+    }
+
+    f32 lower[4], upper[4];
+    vst1q_f32( lower, min );
+    vst1q_f32( upper, max );
+#else
+    f32 lower[3] = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+    f32 upper[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    for( s32 i = 0; i < count; i++ ) {
+        const f32* p = &position[i].x;
+        f32        s = fabsf( size[i].current );
+
+        for( s32 j = 0; j < 3; j++ ) {
+            lower[j] = min2( lower[j], p[j] - s );
+            upper[j] = max2( upper[j], p[j] + s );
+        }
+    }
+#endif
+
+    return Bounds( Vec3( lower[0], lower[1], lower[2] ), Vec3( upper[0], upper[1], upper[2] ) );
+}
+
+} // namespace Simd
+
+} // namespace Fx
+
+DC_END_DREEMCHEST
@@ -0,0 +1,112 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Fx_Simd_H__
+#define __DC_Fx_Simd_H__
+
+#include "Particles.h"
+
+#if defined( __AVX__ )
+    #define DC_FX_SIMD_AVX
+    #include <immintrin.h>
+#elif defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+    #define DC_FX_SIMD_SSE
+    #include <xmmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+    #define DC_FX_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+DC_BEGIN_DREEMCHEST
+
+namespace Fx {
+
+//! Vectorized kernels used by particle modules.
+/*!
+ Particle attribute arrays are allocated aligned and padded to a multiple of a SIMD width plus one
+ extra element, so kernels are free to process a tail of an array with full-width loads and stores.
+*/
+namespace Simd {
+
+    //! Particle attribute arrays are aligned by this amount of bytes.
+    enum { Alignment = 32 };
+
+    //! The number of floats processed by a single SIMD instruction.
+#if defined( DC_FX_SIMD_AVX )
+    enum { Width = 8 };
+#elif defined( DC_FX_SIMD_SSE ) || defined( DC_FX_SIMD_NEON )
+    enum { Width = 4 };
+#else
+    enum { Width = 1 };
+#endif
+
+    //! Returns the number of particles to be allocated for a specified capacity.
+    s32         paddedCount( s32 count );
+
+    //! Allocates an aligned memory block.
+    void*       allocate( s32 size );
+
+    //! Releases an aligned memory block.
+    void        release( void* pointer );
+
+    //! Adds a scaled source stream to a destination stream, dst[i] += src[i] * scale.
+    void        madd( f32* dst, const f32* src, f32 scale, s32 count );
+
+    //! Multiplies the initial value of each scalar by a per-particle factor, items[i].current = items[i].initial * factors[i].
+    void        scale( Particle::Scalar* items, const f32* factors, s32 count );
+
+    //! Multiplies the initial color of each particle by a per-particle tint, items[i].current = items[i].initial * factors[i].
+    void        scale( Particle::Color* items, const Rgb* factors, s32 count );
+
+    //! Moves array items to the front by source indices, items[i] = items[indices[i]]; indices should be sorted and indices[i] >= i.
+    template<typename T>
+    void        gather( T* items, const u32* indices, s32 count );
+
+    //! Calculates the bounding box of particles extended by their sizes.
+    Bounds      bounds( const Vec3* position, const Particle::Scalar* size, s32 count );
+
+    // ** gather
+    template<typename T>
+    void gather( T* items, const u32* indices, s32 count )
+    {
+        // Skip the leading range of particles that stay in place
+        s32 i = 0;
+        while( i < count && indices[i] == static_cast<u32>( i ) ) {
+            i++;
+        }
+
+        for( ; i < count; i++ ) {
+            items[i] = items[indices[i]];
+        }
+    }
+
+} // namespace Simd
+
+} // namespace Fx
+
+DC_END_DREEMCHEST
+
+#endif        /*    !__DC_Fx_Simd_H__    */
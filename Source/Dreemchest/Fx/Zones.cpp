@@ -62,13 +62,13 @@ ZoneType DiskZone::type( void ) const
 }
 
 // ** DiskZone::generateRandomPoint
-Zone::Point DiskZone::generateRandomPoint( f32 scalar, const Vec3& center ) const
+Zone::Point DiskZone::generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const
 {
-    f32 inner = SampleParameter( 0, &m_innerRadius, 0.0f );
-    f32 outer = SampleParameter( 0, &m_outerRadius, 0.0f );
+    f32 inner = m_innerRadius.sample( 0, scalar, 0.0f, &random );
+    f32 outer = m_outerRadius.sample( 0, scalar, 0.0f, &random );
 
-    Vec2  direction = Vec2::randDirection();
-    f32   distance  = RANDOM_SCALAR( inner, outer );
+    Vec2  direction = random.direction2();
+    f32   distance  = random.scalar( inner, outer );
 
     return Point( center + Vec3( direction.x, direction.y, 0.0f ) * distance, Vec3( direction.x, direction.y, 0.0f ) );
 }
@@ -90,16 +90,16 @@ ZoneType BoxZone::type( void ) const
 }
 
 // ** BoxZone::generateRandomPoint
-Zone::Point BoxZone::generateRandomPoint( f32 scalar, const Vec3& center ) const
+Zone::Point BoxZone::generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const
 {
-    f32 hw = SampleParameter( 0, &m_width,  0.0f ) * 0.5f;
-    f32 hh = SampleParameter( 0, &m_height, 0.0f ) * 0.5f;
-    f32 hd = SampleParameter( 0, &m_depth,  0.0f ) * 0.5f;
+    f32 hw = m_width.sample( 0, scalar, 0.0f, &random ) * 0.5f;
+    f32 hh = m_height.sample( 0, scalar, 0.0f, &random ) * 0.5f;
+    f32 hd = m_depth.sample( 0, scalar, 0.0f, &random ) * 0.5f;
 
     Vec3 min( -hw, -hh, -hd );
     Vec3 max(  hw,  hh,  hd );
 
-    return Point( center + randomValue( min, max ), Vec3( 0.0f, 1.0f, 0.0f ) );
+    return Point( center + random.value( min, max ), Vec3( 0.0f, 1.0f, 0.0f ) );
 }
 
 // ------------------------------------------------- HemiSphereZone ------------------------------------------------- //
@@ -117,9 +117,9 @@ ZoneType HemiSphereZone::type( void ) const
 }
 
 // ** HemiSphereZone::generateRandomPoint
-Zone::Point HemiSphereZone::generateRandomPoint( f32 scalar, const Vec3& center ) const
+Zone::Point HemiSphereZone::generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const
 {
-    Vec3 direction = Vec3::randomHemisphereDirection( Vec3( 0.0f, 1.0f, 0.0f ) );
+    Vec3 direction = random.hemisphereDirection( Vec3( 0.0f, 1.0f, 0.0f ) );
     return Point( center, direction );
 }
 
@@ -138,10 +138,10 @@ ZoneType SphereZone::type( void ) const
 }
 
 // ** SphereZone::generateRandomPoint
-Zone::Point SphereZone::generateRandomPoint( f32 scalar, const Vec3& center ) const
+Zone::Point SphereZone::generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const
 {
-    Vec3 direction = Vec3::randomDirection();
-    f32  radius       = SampleParameter( 0, &m_radius, 0.0f );
+    Vec3 direction = random.direction();
+    f32  radius       = m_radius.sample( 0, scalar, 0.0f, &random );
     return Point( center + direction * radius, direction );
 }
 
@@ -160,13 +160,13 @@ ZoneType LineZone::type( void ) const
 }
 
 // ** LineZone::generateRandomPoint
-Zone::Point LineZone::generateRandomPoint( f32 scalar, const Vec3& center ) const
+Zone::Point LineZone::generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const
 {
-    float length = SampleParameter( 0, &m_length, 0.0f );
-    float angle  = SampleParameter( 0, &m_angle, 0.0f );
+    float length = m_length.sample( 0, scalar, 0.0f, &random );
+    float angle  = m_angle.sample( 0, scalar, 0.0f, &random );
 
     Vec2  direction = Vec2::fromAngle( angle + 90.0f );
-    f32   distance  = RANDOM_SCALAR( -length * 0.5f, length * 0.5f );
+    f32   distance  = random.scalar( -length * 0.5f, length * 0.5f );
 
     return Point( center + Vec3( direction.x, direction.y, 0.0f ) * distance );
 }
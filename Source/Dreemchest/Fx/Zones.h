@@ -55,8 +55,8 @@ namespace Fx {
         //! Returns the zone type.
         virtual ZoneType    type( void ) const                                            = 0;
 
-        //! Generates the random point inside the zone.
-        virtual Point       generateRandomPoint( f32 scalar, const Vec3& center ) const    = 0;
+        //! Generates the random point inside the zone using a specified generator.
+        virtual Point       generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const    = 0;
     };
 
     //! Disk zone generates points between the inner and outer radii.
@@ -70,7 +70,7 @@ namespace Fx {
         virtual ZoneType    type( void ) const;
 
         //! Generates the random point inside the disk.
-        virtual Point       generateRandomPoint( f32 scalar, const Vec3& center ) const;
+        virtual Point       generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const;
 
     private:
 
@@ -89,7 +89,7 @@ namespace Fx {
         virtual ZoneType    type( void ) const;
 
         //! Generates the random point inside the box.
-        virtual Point       generateRandomPoint( f32 scalar, const Vec3& center ) const;
+        virtual Point       generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const;
 
     private:
 
@@ -109,7 +109,7 @@ namespace Fx {
         virtual ZoneType    type( void ) const;
 
         //! Generates the random point inside the hemisphere.
-        virtual Point       generateRandomPoint( f32 scalar, const Vec3& center ) const;
+        virtual Point       generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const;
 
     private:
 
@@ -127,7 +127,7 @@ namespace Fx {
         virtual ZoneType    type( void ) const;
 
         //! Generates the random point inside the sphere.
-        virtual Point       generateRandomPoint( f32 scalar, const Vec3& center ) const;
+        virtual Point       generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const;
 
     private:
 
@@ -145,7 +145,7 @@ namespace Fx {
         virtual ZoneType    type( void ) const;
 
         //! Generates the random point on line segment.
-        virtual Point       generateRandomPoint( f32 scalar, const Vec3& center ) const;
+        virtual Point       generateRandomPoint( Random& random, f32 scalar, const Vec3& center ) const;
 
     private:
 
@@ -0,0 +1,519 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "BinaryVariantView.h"
+#include "KeyValue.h"
+#include "streams/ByteBuffer.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Io {
+
+//! Reads an unaligned value from a memory region, returns false if it does not fit.
+template<typename TValue>
+static bool loadValue( const u8* data, const u8* end, TValue& value )
+{
+    if( data == NULL || end - data < static_cast<s32>( sizeof( TValue ) ) ) {
+        return false;
+    }
+
+    memcpy( &value, data, sizeof( TValue ) );
+    return true;
+}
+
+//! Reads a length-prefixed string span from a memory region, returns a pointer to the first byte after it.
+static const u8* loadString( const u8* data, const u8* end, StringSpan& value )
+{
+    u32 length;
+
+    if( !loadValue( data, end, length ) || static_cast<u32>( end - data - 4 ) < length ) {
+        return NULL;
+    }
+
+    value = StringSpan( reinterpret_cast<CString>( data + 4 ), static_cast<s32>( length ) );
+    return data + 4 + length;
+}
+
+// ---------------------------------------------------------------------- BinaryVariantView::Cursor ---------------------------------------------------------------------- //
+
+// ** BinaryVariantView::Cursor::Cursor
+BinaryVariantView::Cursor::Cursor( const u8* position, const u8* end, s32 count )
+    : m_position( position )
+    , m_end( end )
+    , m_remaining( count )
+{
+}
+
+// ** BinaryVariantView::Cursor::next
+bool BinaryVariantView::Cursor::next( void )
+{
+    // Skip the previous value only when moving past it, so unvisited values are never decoded
+    if( m_value.m_data ) {
+        m_position = m_value.end();
+        m_value    = BinaryVariantView();
+    }
+
+    if( m_position == NULL ) {
+        return false;
+    }
+
+    // Array items are counted
+    if( m_remaining >= 0 ) {
+        if( m_remaining == 0 ) {
+            m_position = NULL;
+            return false;
+        }
+
+        m_remaining--;
+        m_value = BinaryVariantView( m_position, m_end );
+        return true;
+    }
+
+    // Object members are terminated by an empty key
+    const u8* value = loadString( m_position, m_end, m_key );
+
+    if( value == NULL || m_key.length == 0 ) {
+        m_position = NULL;
+        return false;
+    }
+
+    m_value = BinaryVariantView( value, m_end );
+    return true;
+}
+
+// ---------------------------------------------------------------------- BinaryVariantView ---------------------------------------------------------------------- //
+
+// ** BinaryVariantView::BinaryVariantView
+BinaryVariantView::BinaryVariantView( void )
+    : m_data( NULL )
+    , m_end( NULL )
+{
+}
+
+// ** BinaryVariantView::BinaryVariantView
+BinaryVariantView::BinaryVariantView( const u8* data, const u8* end )
+    : m_data( data )
+    , m_end( end )
+{
+}
+
+// ** BinaryVariantView::root
+BinaryVariantView BinaryVariantView::root( const u8* data, s32 size )
+{
+    // Skip the layout header written by BinaryVariantStream::write
+    if( size <= 4 ) {
+        return BinaryVariantView();
+    }
+
+    return BinaryVariantView( data + 4, data + size );
+}
+
+// ** BinaryVariantView::root
+BinaryVariantView BinaryVariantView::root( ByteBufferWPtr buffer )
+{
+    NIMBLE_ABORT_IF( !buffer.valid(), "invalid byte buffer" );
+    return root( buffer->current(), buffer->bytesAvailable() );
+}
+
+// ** BinaryVariantView::kind
+BinaryVariantView::Kind BinaryVariantView::kind( void ) const
+{
+    if( m_data == NULL || m_data >= m_end ) {
+        return InvalidValue;
+    }
+
+    switch( *m_data ) {
+    case BinaryVariantStream::kNull:    return NullValue;
+    case BinaryVariantStream::kBoolean: return BooleanValue;
+    case BinaryVariantStream::kInt8:
+    case BinaryVariantStream::kInt16:
+    case BinaryVariantStream::kInt32:
+    case BinaryVariantStream::kInt64:   return IntegerValue;
+    case BinaryVariantStream::kFloat32:
+    case BinaryVariantStream::kFloat64: return RealValue;
+    case BinaryVariantStream::kString:  return StringValue;
+    case BinaryVariantStream::kGuid:    return GuidValue;
+    case BinaryVariantStream::kArray:   return ArrayValue;
+    case BinaryVariantStream::kObject:  return ObjectValue;
+    }
+
+    return InvalidValue;
+}
+
+// ** BinaryVariantView::isValid
+bool BinaryVariantView::isValid( void ) const
+{
+    return kind() != InvalidValue;
+}
+
+// ** BinaryVariantView::toBool
+bool BinaryVariantView::toBool( void ) const
+{
+    if( kind() == BooleanValue ) {
+        u8 value = 0;
+        loadValue( m_data + 1, m_end, value );
+        return value != 0;
+    }
+
+    return toInteger() != 0;
+}
+
+// ** BinaryVariantView::toInteger
+s64 BinaryVariantView::toInteger( void ) const
+{
+    if( !isValid() ) {
+        return 0;
+    }
+
+    const u8* payload = m_data + 1;
+
+    switch( *m_data ) {
+    case BinaryVariantStream::kBoolean:
+    case BinaryVariantStream::kInt8:    { s8  value = 0; loadValue( payload, m_end, value ); return value; }
+    case BinaryVariantStream::kInt16:   { s16 value = 0; loadValue( payload, m_end, value ); return value; }
+    case BinaryVariantStream::kInt32:   { s32 value = 0; loadValue( payload, m_end, value ); return value; }
+    case BinaryVariantStream::kInt64:   { s64 value = 0; loadValue( payload, m_end, value ); return value; }
+    case BinaryVariantStream::kFloat32:
+    case BinaryVariantStream::kFloat64: return static_cast<s64>( toReal() );
+    }
+
+    return 0;
+}
+
+// ** BinaryVariantView::toReal
+f64 BinaryVariantView::toReal( void ) const
+{
+    if( !isValid() ) {
+        return 0.0;
+    }
+
+    switch( *m_data ) {
+    case BinaryVariantStream::kFloat32: { f32 value = 0.0f; loadValue( m_data + 1, m_end, value ); return value; }
+    case BinaryVariantStream::kFloat64: { f64 value = 0.0;  loadValue( m_data + 1, m_end, value ); return value; }
+    }
+
+    return static_cast<f64>( toInteger() );
+}
+
+// ** BinaryVariantView::toStringSpan
+StringSpan BinaryVariantView::toStringSpan( void ) const
+{
+    StringSpan value;
+
+    if( kind() == StringValue ) {
+        loadString( m_data + 1, m_end, value );
+    }
+
+    return value;
+}
+
+// ** BinaryVariantView::toGuid
+Guid BinaryVariantView::toGuid( void ) const
+{
+    if( kind() != GuidValue || m_end - m_data <= Guid::Size ) {
+        return Guid();
+    }
+
+    return Guid( m_data + 1 );
+}
+
+// ** BinaryVariantView::size
+s32 BinaryVariantView::size( void ) const
+{
+    switch( kind() ) {
+    case ArrayValue:    {
+                            u16 count = 0;
+                            loadValue( m_data + 1, m_end, count );
+                            return count;
+                        }
+    case ObjectValue:   {
+                            s32 count = 0;
+                            for( Cursor i = items(); i.next(); ) {
+                                count++;
+                            }
+                            return count;
+                        }
+    default:            break;
+    }
+
+    return 0;
+}
+
+// ** BinaryVariantView::items
+BinaryVariantView::Cursor BinaryVariantView::items( void ) const
+{
+    switch( kind() ) {
+    case ArrayValue:    {
+                            u16 count;
+                            if( !loadValue( m_data + 1, m_end, count ) ) {
+                                break;
+                            }
+                            return Cursor( m_data + 3, m_end, count );
+                        }
+    case ObjectValue:   return Cursor( m_data + 1, m_end, -1 );
+    default:            break;
+    }
+
+    return Cursor( NULL, m_end, 0 );
+}
+
+// ** BinaryVariantView::itemAt
+BinaryVariantView BinaryVariantView::itemAt( s32 index ) const
+{
+    if( kind() != ArrayValue || index < 0 ) {
+        return BinaryVariantView();
+    }
+
+    for( Cursor i = items(); i.next(); index-- ) {
+        if( index == 0 ) {
+            return i.value();
+        }
+    }
+
+    return BinaryVariantView();
+}
+
+// ** BinaryVariantView::valueAtKey
+BinaryVariantView BinaryVariantView::valueAtKey( CString key ) const
+{
+    if( kind() != ObjectValue ) {
+        return BinaryVariantView();
+    }
+
+    for( Cursor i = items(); i.next(); ) {
+        if( i.key() == key ) {
+            return i.value();
+        }
+    }
+
+    return BinaryVariantView();
+}
+
+// ** BinaryVariantView::end
+const u8* BinaryVariantView::end( void ) const
+{
+    return m_data ? skip( m_data, m_end ) : NULL;
+}
+
+// ** BinaryVariantView::skip
+const u8* BinaryVariantView::skip( const u8* data, const u8* end )
+{
+    if( data == NULL || data >= end ) {
+        return NULL;
+    }
+
+    // Returns a pointer past a fixed size payload if it fits a region
+    #define FIXED_PAYLOAD( size ) ( end - data > ( size ) ? data + 1 + ( size ) : NULL )
+
+    switch( *data ) {
+    case BinaryVariantStream::kNull:    return data + 1;
+    case BinaryVariantStream::kBoolean:
+    case BinaryVariantStream::kInt8:    return FIXED_PAYLOAD( 1 );
+    case BinaryVariantStream::kInt16:   return FIXED_PAYLOAD( 2 );
+    case BinaryVariantStream::kInt32:
+    case BinaryVariantStream::kFloat32: return FIXED_PAYLOAD( 4 );
+    case BinaryVariantStream::kInt64:
+    case BinaryVariantStream::kFloat64: return FIXED_PAYLOAD( 8 );
+    case BinaryVariantStream::kGuid:    return FIXED_PAYLOAD( Guid::Size );
+    case BinaryVariantStream::kString:  {
+                                            StringSpan value;
+                                            return loadString( data + 1, end, value );
+                                        }
+    case BinaryVariantStream::kArray:   {
+                                            u16 count;
+
+                                            if( !loadValue( data + 1, end, count ) ) {
+                                                return NULL;
+                                            }
+
+                                            const u8* position = data + 3;
+
+                                            for( u16 i = 0; i < count && position; i++ ) {
+                                                position = skip( position, end );
+                                            }
+
+                                            return position;
+                                        }
+    case BinaryVariantStream::kObject:  {
+                                            const u8* position = data + 1;
+
+                                            while( position ) {
+                                                StringSpan key;
+                                                position = loadString( position, end, key );
+
+                                                if( position == NULL || key.length == 0 ) {
+                                                    return position;
+                                                }
+
+                                                position = skip( position, end );
+                                            }
+
+                                            return NULL;
+                                        }
+    }
+
+    #undef FIXED_PAYLOAD
+
+    return NULL;
+}
+
+// ** BinaryVariantView::toVariant
+Variant BinaryVariantView::toVariant( void ) const
+{
+    switch( kind() ) {
+    case BooleanValue:  return Variant::fromValue( toBool() );
+    case IntegerValue:  switch( *m_data ) {
+                        case BinaryVariantStream::kInt8:    return Variant::fromValue( static_cast<s8>( toInteger() ) );
+                        case BinaryVariantStream::kInt16:   return Variant::fromValue( static_cast<s16>( toInteger() ) );
+                        case BinaryVariantStream::kInt32:   return Variant::fromValue( static_cast<s32>( toInteger() ) );
+                        default:                            return Variant::fromValue( toInteger() );
+                        }
+    case RealValue:     if( *m_data == BinaryVariantStream::kFloat32 ) {
+                            return Variant::fromValue( static_cast<f32>( toReal() ) );
+                        }
+                        return Variant::fromValue( toReal() );
+    case StringValue:   return Variant::fromValue<String>( toStringSpan().str() );
+    case GuidValue:     return Variant::fromValue<Guid>( toGuid() );
+    case ArrayValue:    {
+                            VariantArray array;
+                            for( Cursor i = items(); i.next(); ) {
+                                array << i.value().toVariant();
+                            }
+                            return Variant::fromValue<VariantArray>( array );
+                        }
+    case ObjectValue:   {
+                            KeyValue object;
+                            for( Cursor i = items(); i.next(); ) {
+                                object.setValueAtKey( i.key().str(), i.value().toVariant() );
+                            }
+                            return Variant::fromValue<KeyValue>( object );
+                        }
+    default:            break;
+    }
+
+    return Variant();
+}
+
+// ---------------------------------------------------------------------- BinaryVariantIndex ---------------------------------------------------------------------- //
+
+// ** BinaryVariantIndex::BinaryVariantIndex
+BinaryVariantIndex::BinaryVariantIndex( const BinaryVariantView& object )
+    : m_mask( 0 )
+    , m_size( 0 )
+    , m_end( object.m_end )
+{
+    NIMBLE_BREAK_IF( object.kind() != BinaryVariantView::ObjectValue, "an object view expected" );
+
+    // Size the table to keep a load factor under one half
+    s32 count    = object.size();
+    u32 capacity = 16;
+
+    while( capacity < static_cast<u32>( count ) * 2 ) {
+        capacity <<= 1;
+    }
+
+    Slot empty;
+    empty.hash  = 0;
+    empty.value = NULL;
+
+    m_slots.resize( capacity, empty );
+    m_mask = capacity - 1;
+
+    // Record member value offsets, the first occurrence of a duplicate key wins as with a linear scan
+    for( BinaryVariantView::Cursor i = object.items(); i.next(); ) {
+        const StringSpan& key = i.key();
+        u32 h = hash( key.data, key.length );
+
+        for( u32 slot = h & m_mask;; slot = (slot + 1) & m_mask ) {
+            Slot& entry = m_slots[slot];
+
+            if( entry.value == NULL ) {
+                entry.hash  = h;
+                entry.key   = key;
+                entry.value = i.value().m_data;
+                m_size++;
+                break;
+            }
+
+            if( entry.hash == h && entry.key.length == key.length && memcmp( entry.key.data, key.data, key.length ) == 0 ) {
+                break;
+            }
+        }
+    }
+}
+
+// ** BinaryVariantIndex::size
+s32 BinaryVariantIndex::size( void ) const
+{
+    return m_size;
+}
+
+// ** BinaryVariantIndex::find
+BinaryVariantView BinaryVariantIndex::find( CString key ) const
+{
+    return find( StringSpan( key, static_cast<s32>( strlen( key ) ) ) );
+}
+
+// ** BinaryVariantIndex::find
+BinaryVariantView BinaryVariantIndex::find( const StringSpan& key ) const
+{
+    if( m_slots.empty() ) {
+        return BinaryVariantView();
+    }
+
+    u32 h = hash( key.data, key.length );
+
+    for( u32 slot = h & m_mask;; slot = (slot + 1) & m_mask ) {
+        const Slot& entry = m_slots[slot];
+
+        if( entry.value == NULL ) {
+            break;
+        }
+
+        if( entry.hash == h && entry.key.length == key.length && memcmp( entry.key.data, key.data, key.length ) == 0 ) {
+            return BinaryVariantView( entry.value, m_end );
+        }
+    }
+
+    return BinaryVariantView();
+}
+
+// ** BinaryVariantIndex::hash
+u32 BinaryVariantIndex::hash( CString key, s32 length )
+{
+    // FNV-1a
+    u32 h = 2166136261u;
+
+    for( s32 i = 0; i < length; i++ ) {
+        h = (h ^ static_cast<u8>( key[i] )) * 16777619u;
+    }
+
+    return h;
+}
+
+} // namespace Io
+
+DC_END_DREEMCHEST
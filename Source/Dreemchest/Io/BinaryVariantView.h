@@ -0,0 +1,210 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Io_BinaryVariantView_H__
+#define __DC_Io_BinaryVariantView_H__
+
+#include "Io.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Io {
+
+    //! A span of characters inside a viewed memory region, not null-terminated.
+    struct StringSpan {
+                            StringSpan( void )
+                                : data( NULL ), length( 0 ) {}
+                            StringSpan( CString data, s32 length )
+                                : data( data ), length( length ) {}
+
+        //! Returns true if this span equals to a null-terminated string.
+        bool                operator == ( CString value ) const { return strncmp( data, value, length ) == 0 && value[length] == 0; }
+
+        //! Returns a copy of this span as a string.
+        String              str( void ) const { return String( data, length ); }
+
+        CString             data;       //!< The first character.
+        s32                 length;     //!< The total number of characters.
+    };
+
+    //! A non-owning view of a single value written by a BinaryVariantStream.
+    /*!
+     Values are decoded on access straight from a contiguous memory region, strings are returned as
+     spans that point into this region and nested arrays & objects are iterated with cursors that skip
+     unvisited values without materializing them, so reading a value allocates nothing. A viewed memory
+     region should outlive all views and cursors created from it.
+     */
+    class BinaryVariantView {
+    friend class BinaryVariantIndex;
+    public:
+
+        //! Available value kinds.
+        enum Kind {
+              InvalidValue          //!< A view points to a malformed or missing value.
+            , NullValue             //!< A null value.
+            , BooleanValue          //!< A boolean value.
+            , IntegerValue          //!< An integer value.
+            , RealValue             //!< A floating point value.
+            , StringValue           //!< A string value.
+            , GuidValue             //!< A Guid value.
+            , ArrayValue            //!< An array of values.
+            , ObjectValue           //!< A set of key-value pairs.
+        };
+
+        //! Iterates over array items or object members.
+        class Cursor;
+
+                            //! Constructs an invalid BinaryVariantView instance.
+                            BinaryVariantView( void );
+
+                            //! Constructs BinaryVariantView instance that points to a value type tag.
+                            BinaryVariantView( const u8* data, const u8* end );
+
+        //! Returns a view of a root value written by BinaryVariantStream::write.
+        static BinaryVariantView    root( const u8* data, s32 size );
+
+        //! Returns a view of a root value that starts at a current byte buffer position.
+        static BinaryVariantView    root( ByteBufferWPtr buffer );
+
+        //! Returns a value kind.
+        Kind                kind( void ) const;
+
+        //! Returns true if a view points to a well-formed value.
+        bool                isValid( void ) const;
+
+        //! Returns a boolean value.
+        bool                toBool( void ) const;
+
+        //! Returns a numeric value converted to an integer.
+        s64                 toInteger( void ) const;
+
+        //! Returns a numeric value converted to a double.
+        f64                 toReal( void ) const;
+
+        //! Returns a string value span.
+        StringSpan          toStringSpan( void ) const;
+
+        //! Returns a Guid value.
+        Guid                toGuid( void ) const;
+
+        //! Returns the number of array items or object members.
+        s32                 size( void ) const;
+
+        //! Returns a cursor over array items or object members.
+        Cursor              items( void ) const;
+
+        //! Returns an array item by index, items that precede it are skipped.
+        BinaryVariantView   itemAt( s32 index ) const;
+
+        //! Searches for an object member by key with a linear scan.
+        BinaryVariantView   valueAtKey( CString key ) const;
+
+        //! Returns a pointer to the first byte after this value or NULL if a value is malformed.
+        const u8*           end( void ) const;
+
+        //! Materializes this view to a Variant.
+        Variant             toVariant( void ) const;
+
+    private:
+
+        //! Returns a pointer to the first byte after a value that starts at a specified position.
+        static const u8*    skip( const u8* data, const u8* end );
+
+    private:
+
+        const u8*           m_data;     //!< Points to a value type tag.
+        const u8*           m_end;      //!< The end of a viewed region.
+    };
+
+    //! Iterates over array items or object members.
+    class BinaryVariantView::Cursor {
+    friend class BinaryVariantView;
+    public:
+
+        //! Moves to the next item, returns false when there are no more items.
+        bool                        next( void );
+
+        //! Returns a current item value.
+        const BinaryVariantView&    value( void ) const { return m_value; }
+
+        //! Returns a current object member key.
+        const StringSpan&           key( void ) const { return m_key; }
+
+    private:
+
+                                    //! Constructs Cursor instance.
+                                    Cursor( const u8* position, const u8* end, s32 count );
+
+    private:
+
+        const u8*                   m_position;     //!< Points to the next item or NULL when iteration is finished.
+        const u8*                   m_end;          //!< The end of a viewed region.
+        s32                         m_remaining;    //!< The number of array items left or -1 for objects.
+        StringSpan                  m_key;          //!< A current member key.
+        BinaryVariantView           m_value;        //!< A current item value.
+    };
+
+    //! An offset index of object members that gives a constant time key lookup inside large objects.
+    class BinaryVariantIndex {
+    public:
+
+                            //! Constructs BinaryVariantIndex instance from an object view.
+        explicit            BinaryVariantIndex( const BinaryVariantView& object );
+
+        //! Returns a member value by key or an invalid view if no such key exists.
+        BinaryVariantView   find( CString key ) const;
+
+        //! Returns a member value by key span.
+        BinaryVariantView   find( const StringSpan& key ) const;
+
+        //! Returns the total number of indexed members.
+        s32                 size( void ) const;
+
+    private:
+
+        //! Calculates a key hash.
+        static u32          hash( CString key, s32 length );
+
+    private:
+
+        //! A hash table slot.
+        struct Slot {
+            u32             hash;   //!< A key hash.
+            StringSpan      key;    //!< A member key.
+            const u8*       value;  //!< A member value.
+        };
+
+        Array<Slot>         m_slots;    //!< Open addressing hash table.
+        u32                 m_mask;     //!< Hash table capacity mask.
+        s32                 m_size;     //!< The total number of indexed members.
+        const u8*           m_end;      //!< The end of a viewed region.
+    };
+
+} // namespace Io
+
+DC_END_DREEMCHEST
+
+#endif        /*    !__DC_Io_BinaryVariantView_H__    */
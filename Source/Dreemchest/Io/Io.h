@@ -109,6 +109,8 @@ DC_END_DREEMCHEST
     #include "Archive.h"
     #include "DiskFileSystem.h"
     #include "KeyValue.h"
+    #include "JsonReader.h"
+    #include "BinaryVariantView.h"
 #endif
 
 #endif /*   !defined( __DC_Io_H__ )   */
@@ -0,0 +1,517 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "JsonReader.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Io {
+
+//! Powers of ten that are exactly representable by a double.
+static const f64 s_powersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// ** JsonReader::JsonReader
+JsonReader::JsonReader( void )
+    : m_begin( NULL )
+    , m_cursor( NULL )
+    , m_end( NULL )
+    , m_line( 0 )
+{
+}
+
+// ** JsonReader::error
+const String& JsonReader::error( void ) const
+{
+    return m_error;
+}
+
+// ** JsonReader::line
+s32 JsonReader::line( void ) const
+{
+    return m_line;
+}
+
+// ** JsonReader::parse
+bool JsonReader::parse( CString text, s32 length, IJsonHandler& handler )
+{
+    NIMBLE_ABORT_IF( text == NULL && length > 0, "invalid text" );
+
+    m_begin  = text;
+    m_cursor = text;
+    m_end    = text + length;
+    m_line   = 0;
+    m_error.clear();
+
+    skipWhitespace();
+
+    if( !parseValue( handler, 0 ) ) {
+        return false;
+    }
+
+    // Only whitespace is allowed after a root value
+    skipWhitespace();
+
+    if( m_cursor != m_end ) {
+        return fail( "unexpected characters after a root value" );
+    }
+
+    return true;
+}
+
+// ** JsonReader::parseValue
+bool JsonReader::parseValue( IJsonHandler& handler, s32 depth )
+{
+    if( m_cursor == m_end ) {
+        return fail( "unexpected end of text" );
+    }
+
+    switch( *m_cursor ) {
+    case '{':   return parseObject( handler, depth + 1 );
+    case '[':   return parseArray( handler, depth + 1 );
+    case '"':   return parseString( handler, false );
+    case 't':   return parseLiteral( "true", 4 ) && (handler.onBoolean( true ) || cancelled());
+    case 'f':   return parseLiteral( "false", 5 ) && (handler.onBoolean( false ) || cancelled());
+    case 'n':   return parseLiteral( "null", 4 ) && (handler.onNull() || cancelled());
+    default:    if( *m_cursor == '-' || (*m_cursor >= '0' && *m_cursor <= '9') ) {
+                    return parseNumber( handler );
+                }
+    }
+
+    return fail( "unexpected character" );
+}
+
+// ** JsonReader::parseObject
+bool JsonReader::parseObject( IJsonHandler& handler, s32 depth )
+{
+    if( depth > MaxDepth ) {
+        return fail( "maximum nesting depth exceeded" );
+    }
+
+    // Skip the opening brace
+    m_cursor++;
+
+    if( !handler.onBeginObject() ) {
+        return cancelled();
+    }
+
+    skipWhitespace();
+
+    // An empty object
+    if( m_cursor != m_end && *m_cursor == '}' ) {
+        m_cursor++;
+        return handler.onEndObject() || cancelled();
+    }
+
+    while( true ) {
+        // Read a member key
+        if( m_cursor == m_end || *m_cursor != '"' ) {
+            return fail( "object key expected" );
+        }
+
+        if( !parseString( handler, true ) ) {
+            return false;
+        }
+
+        skipWhitespace();
+
+        if( m_cursor == m_end || *m_cursor != ':' ) {
+            return fail( "':' expected" );
+        }
+
+        m_cursor++;
+        skipWhitespace();
+
+        // Read a member value
+        if( !parseValue( handler, depth ) ) {
+            return false;
+        }
+
+        skipWhitespace();
+
+        if( m_cursor == m_end ) {
+            return fail( "unterminated object" );
+        }
+
+        if( *m_cursor == ',' ) {
+            m_cursor++;
+            skipWhitespace();
+            continue;
+        }
+
+        if( *m_cursor == '}' ) {
+            m_cursor++;
+            return handler.onEndObject() || cancelled();
+        }
+
+        return fail( "',' or '}' expected" );
+    }
+}
+
+// ** JsonReader::parseArray
+bool JsonReader::parseArray( IJsonHandler& handler, s32 depth )
+{
+    if( depth > MaxDepth ) {
+        return fail( "maximum nesting depth exceeded" );
+    }
+
+    // Skip the opening bracket
+    m_cursor++;
+
+    if( !handler.onBeginArray() ) {
+        return cancelled();
+    }
+
+    skipWhitespace();
+
+    // An empty array
+    if( m_cursor != m_end && *m_cursor == ']' ) {
+        m_cursor++;
+        return handler.onEndArray() || cancelled();
+    }
+
+    while( true ) {
+        if( !parseValue( handler, depth ) ) {
+            return false;
+        }
+
+        skipWhitespace();
+
+        if( m_cursor == m_end ) {
+            return fail( "unterminated array" );
+        }
+
+        if( *m_cursor == ',' ) {
+            m_cursor++;
+            skipWhitespace();
+            continue;
+        }
+
+        if( *m_cursor == ']' ) {
+            m_cursor++;
+            return handler.onEndArray() || cancelled();
+        }
+
+        return fail( "',' or ']' expected" );
+    }
+}
+
+// ** JsonReader::parseString
+bool JsonReader::parseString( IJsonHandler& handler, bool isKey )
+{
+    // Skip the opening quote
+    CString start = ++m_cursor;
+
+    // Scan for the closing quote, strings with no escape sequences are passed in place
+    while( m_cursor != m_end && *m_cursor != '"' && *m_cursor != '\\' ) {
+        if( static_cast<u8>( *m_cursor ) < 0x20 ) {
+            return fail( "control character inside a string" );
+        }
+        m_cursor++;
+    }
+
+    if( m_cursor == m_end ) {
+        return fail( "unterminated string" );
+    }
+
+    CString value  = start;
+    s32     length = static_cast<s32>( m_cursor - start );
+
+    if( *m_cursor == '"' ) {
+        m_cursor++;
+    } else {
+        if( !decodeEscapedString( start ) ) {
+            return false;
+        }
+
+        value  = m_scratch.c_str();
+        length = static_cast<s32>( m_scratch.length() );
+    }
+
+    bool result = isKey ? handler.onKey( value, length ) : handler.onString( value, length );
+    return result || cancelled();
+}
+
+// ** JsonReader::decodeEscapedString
+bool JsonReader::decodeEscapedString( CString start )
+{
+    // Copy a part that precedes the first escape sequence
+    m_scratch.assign( start, m_cursor );
+
+    while( true ) {
+        if( m_cursor == m_end ) {
+            return fail( "unterminated string" );
+        }
+
+        char c = *m_cursor++;
+
+        if( c == '"' ) {
+            return true;
+        }
+
+        if( static_cast<u8>( c ) < 0x20 ) {
+            return fail( "control character inside a string" );
+        }
+
+        if( c != '\\' ) {
+            m_scratch += c;
+            continue;
+        }
+
+        if( m_cursor == m_end ) {
+            return fail( "unterminated escape sequence" );
+        }
+
+        switch( *m_cursor++ ) {
+        case '"':   m_scratch += '"';  break;
+        case '\\':  m_scratch += '\\'; break;
+        case '/':   m_scratch += '/';  break;
+        case 'b':   m_scratch += '\b'; break;
+        case 'f':   m_scratch += '\f'; break;
+        case 'n':   m_scratch += '\n'; break;
+        case 'r':   m_scratch += '\r'; break;
+        case 't':   m_scratch += '\t'; break;
+        case 'u':   {
+                        u32 code = 0;
+
+                        // Read one or two UTF-16 code units
+                        for( s32 unit = 0; unit < 2; unit++ ) {
+                            if( m_end - m_cursor < 4 ) {
+                                return fail( "invalid unicode escape sequence" );
+                            }
+
+                            u32 value = 0;
+
+                            for( s32 i = 0; i < 4; i++ ) {
+                                char h = *m_cursor++;
+                                value <<= 4;
+
+                                if( h >= '0' && h <= '9' )      value |= h - '0';
+                                else if( h >= 'a' && h <= 'f' ) value |= h - 'a' + 10;
+                                else if( h >= 'A' && h <= 'F' ) value |= h - 'A' + 10;
+                                else return fail( "invalid unicode escape sequence" );
+                            }
+
+                            if( unit == 0 ) {
+                                code = value;
+
+                                // Not a high surrogate - done
+                                if( code < 0xD800 || code > 0xDBFF ) {
+                                    break;
+                                }
+
+                                // A low surrogate should follow
+                                if( m_end - m_cursor < 2 || m_cursor[0] != '\\' || m_cursor[1] != 'u' ) {
+                                    return fail( "missing low surrogate" );
+                                }
+
+                                m_cursor += 2;
+                            } else {
+                                if( value < 0xDC00 || value > 0xDFFF ) {
+                                    return fail( "invalid low surrogate" );
+                                }
+
+                                code = 0x10000 + ((code - 0xD800) << 10) + (value - 0xDC00);
+                            }
+                        }
+
+                        // Encode a code point as UTF-8
+                        if( code < 0x80 ) {
+                            m_scratch += static_cast<char>( code );
+                        } else if( code < 0x800 ) {
+                            m_scratch += static_cast<char>( 0xC0 | (code >> 6) );
+                            m_scratch += static_cast<char>( 0x80 | (code & 0x3F) );
+                        } else if( code < 0x10000 ) {
+                            m_scratch += static_cast<char>( 0xE0 | (code >> 12) );
+                            m_scratch += static_cast<char>( 0x80 | ((code >> 6) & 0x3F) );
+                            m_scratch += static_cast<char>( 0x80 | (code & 0x3F) );
+                        } else {
+                            m_scratch += static_cast<char>( 0xF0 | (code >> 18) );
+                            m_scratch += static_cast<char>( 0x80 | ((code >> 12) & 0x3F) );
+                            m_scratch += static_cast<char>( 0x80 | ((code >> 6) & 0x3F) );
+                            m_scratch += static_cast<char>( 0x80 | (code & 0x3F) );
+                        }
+                    }
+                    break;
+        default:    return fail( "invalid escape sequence" );
+        }
+    }
+}
+
+// ** JsonReader::parseNumber
+bool JsonReader::parseNumber( IJsonHandler& handler )
+{
+    CString start    = m_cursor;
+    bool    negative = false;
+
+    if( *m_cursor == '-' ) {
+        negative = true;
+        m_cursor++;
+    }
+
+    if( m_cursor == m_end || *m_cursor < '0' || *m_cursor > '9' ) {
+        return fail( "invalid number" );
+    }
+
+    // Accumulate up to 19 significant digits, numbers with more digits are parsed by a standard library
+    u64  mantissa  = 0;
+    s32  digits    = 0;
+    s32  exponent  = 0;
+    bool isInteger = true;
+    bool truncated = false;
+
+    if( *m_cursor == '0' ) {
+        m_cursor++;
+    } else {
+        for( ; m_cursor != m_end && *m_cursor >= '0' && *m_cursor <= '9'; m_cursor++ ) {
+            if( digits < 19 ) {
+                mantissa = mantissa * 10 + (*m_cursor - '0');
+                digits++;
+            } else {
+                exponent++;
+                truncated = true;
+            }
+        }
+    }
+
+    // Fraction part
+    if( m_cursor != m_end && *m_cursor == '.' ) {
+        isInteger = false;
+        m_cursor++;
+
+        if( m_cursor == m_end || *m_cursor < '0' || *m_cursor > '9' ) {
+            return fail( "invalid number" );
+        }
+
+        for( ; m_cursor != m_end && *m_cursor >= '0' && *m_cursor <= '9'; m_cursor++ ) {
+            // Leading zeros are not significant and only shift an exponent
+            if( mantissa == 0 && *m_cursor == '0' ) {
+                exponent--;
+            } else if( digits < 19 ) {
+                mantissa = mantissa * 10 + (*m_cursor - '0');
+                digits++;
+                exponent--;
+            } else {
+                truncated = true;
+            }
+        }
+    }
+
+    // Exponent part
+    if( m_cursor != m_end && (*m_cursor == 'e' || *m_cursor == 'E') ) {
+        isInteger = false;
+        m_cursor++;
+
+        s32 sign = 1;
+
+        if( m_cursor != m_end && (*m_cursor == '+' || *m_cursor == '-') ) {
+            sign = *m_cursor == '-' ? -1 : 1;
+            m_cursor++;
+        }
+
+        if( m_cursor == m_end || *m_cursor < '0' || *m_cursor > '9' ) {
+            return fail( "invalid number" );
+        }
+
+        s32 value = 0;
+
+        for( ; m_cursor != m_end && *m_cursor >= '0' && *m_cursor <= '9'; m_cursor++ ) {
+            if( value < 100000 ) {
+                value = value * 10 + (*m_cursor - '0');
+            }
+        }
+
+        exponent += sign * value;
+    }
+
+    // Integers that fit 64 bits are reported as is
+    if( isInteger && exponent == 0 && digits < 19 ) {
+        s64 value = static_cast<s64>( mantissa );
+        return handler.onInteger( negative ? -value : value ) || cancelled();
+    }
+
+    f64 value;
+
+    // A mantissa and a power of ten are both exact, so a single operation gives a correctly rounded result
+    if( !truncated && mantissa <= (static_cast<u64>( 1 ) << 53) && exponent >= -22 && exponent <= 22 ) {
+        value = static_cast<f64>( mantissa );
+        value = exponent < 0 ? value / s_powersOfTen[-exponent] : value * s_powersOfTen[exponent];
+        value = negative ? -value : value;
+    } else {
+        // Fallback to a standard library for rare cases, a source text is not null-terminated so copy a number first
+        m_scratch.assign( start, m_cursor );
+        value = strtod( m_scratch.c_str(), NULL );
+    }
+
+    return handler.onNumber( value ) || cancelled();
+}
+
+// ** JsonReader::parseLiteral
+bool JsonReader::parseLiteral( CString literal, s32 length )
+{
+    if( m_end - m_cursor < length || strncmp( m_cursor, literal, length ) != 0 ) {
+        return fail( "invalid literal" );
+    }
+
+    m_cursor += length;
+    return true;
+}
+
+// ** JsonReader::skipWhitespace
+void JsonReader::skipWhitespace( void )
+{
+    while( m_cursor != m_end && (*m_cursor == ' ' || *m_cursor == '\n' || *m_cursor == '\r' || *m_cursor == '\t') ) {
+        m_cursor++;
+    }
+}
+
+// ** JsonReader::fail
+bool JsonReader::fail( CString message )
+{
+    // Calculate a line number only when an error occurs
+    m_line = 1;
+
+    for( CString i = m_begin; i < m_cursor; i++ ) {
+        if( *i == '\n' ) {
+            m_line++;
+        }
+    }
+
+    m_error = message;
+    return false;
+}
+
+// ** JsonReader::cancelled
+bool JsonReader::cancelled( void )
+{
+    return fail( "parsing was cancelled by a handler" );
+}
+
+} // namespace Io
+
+DC_END_DREEMCHEST
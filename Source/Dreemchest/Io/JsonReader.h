@@ -0,0 +1,142 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Io_JsonReader_H__
+#define __DC_Io_JsonReader_H__
+
+#include "Io.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Io {
+
+    //! Receives values from a JSON reader, returning false from any callback stops parsing.
+    /*!
+     Strings and keys are passed as a pointer and a length, they are not null-terminated and stay valid only
+     during a callback. Strings with no escape sequences point directly to a source text.
+     */
+    class IJsonHandler {
+    public:
+
+        virtual         ~IJsonHandler( void ) {}
+
+        //! Called for a null value.
+        virtual bool    onNull( void ) NIMBLE_ABSTRACT;
+
+        //! Called for a boolean value.
+        virtual bool    onBoolean( bool value ) NIMBLE_ABSTRACT;
+
+        //! Called for a number with no fraction and exponent parts.
+        virtual bool    onInteger( s64 value ) NIMBLE_ABSTRACT;
+
+        //! Called for a floating point number.
+        virtual bool    onNumber( f64 value ) NIMBLE_ABSTRACT;
+
+        //! Called for a string value.
+        virtual bool    onString( CString value, s32 length ) NIMBLE_ABSTRACT;
+
+        //! Called for an object member key.
+        virtual bool    onKey( CString value, s32 length ) NIMBLE_ABSTRACT;
+
+        //! Called when an object starts.
+        virtual bool    onBeginObject( void ) NIMBLE_ABSTRACT;
+
+        //! Called when an object ends.
+        virtual bool    onEndObject( void ) NIMBLE_ABSTRACT;
+
+        //! Called when an array starts.
+        virtual bool    onBeginArray( void ) NIMBLE_ABSTRACT;
+
+        //! Called when an array ends.
+        virtual bool    onEndArray( void ) NIMBLE_ABSTRACT;
+    };
+
+    //! Single pass JSON reader that reports parsed values to a handler without building a document tree.
+    class JsonReader {
+    public:
+
+                        //! Constructs JsonReader instance.
+                        JsonReader( void );
+
+        //! Parses a JSON text, the text is not required to be null-terminated.
+        bool            parse( CString text, s32 length, IJsonHandler& handler );
+
+        //! Returns an error message for the last failed parsing.
+        const String&   error( void ) const;
+
+        //! Returns a line number where the last parsing has failed.
+        s32             line( void ) const;
+
+    private:
+
+        //! Parses any JSON value.
+        bool            parseValue( IJsonHandler& handler, s32 depth );
+
+        //! Parses a JSON object.
+        bool            parseObject( IJsonHandler& handler, s32 depth );
+
+        //! Parses a JSON array.
+        bool            parseArray( IJsonHandler& handler, s32 depth );
+
+        //! Parses a string value or an object key.
+        bool            parseString( IJsonHandler& handler, bool isKey );
+
+        //! Parses a number value.
+        bool            parseNumber( IJsonHandler& handler );
+
+        //! Parses a literal value.
+        bool            parseLiteral( CString literal, s32 length );
+
+        //! Decodes an escaped string to a scratch buffer.
+        bool            decodeEscapedString( CString start );
+
+        //! Skips whitespace characters.
+        void            skipWhitespace( void );
+
+        //! Records an error message and returns false.
+        bool            fail( CString message );
+
+        //! Called when a handler has stopped parsing.
+        bool            cancelled( void );
+
+    private:
+
+        //! The maximum nesting depth of objects and arrays.
+        enum { MaxDepth = 512 };
+
+        CString         m_begin;    //!< The beginning of a source text.
+        CString         m_cursor;   //!< Current reading position.
+        CString         m_end;      //!< The end of a source text.
+        String          m_scratch;  //!< Reused buffer for decoded strings.
+        String          m_error;    //!< The last error message.
+        s32             m_line;     //!< The line number of the last error.
+    };
+
+} // namespace Io
+
+DC_END_DREEMCHEST
+
+#endif        /*    !__DC_Io_JsonReader_H__    */
@@ -26,6 +26,7 @@
 
 #include "KeyValue.h"
 
+#include "JsonReader.h"
 #include "streams/Stream.h"
 
 DC_BEGIN_DREEMCHEST
@@ -44,23 +45,200 @@ String VariantTextStream::stringify( const Variant& kv, bool formatted )
 #endif    /*    #ifdef JSONCPP_FOUND    */
 }
 
+//! Builds Variant values from JSON reader events.
+class VariantJsonBuilder : public IJsonHandler {
+public:
+
+                            //! Constructs VariantJsonBuilder instance.
+                            VariantJsonBuilder( const VariantTextStream::MemberCallback& callback = VariantTextStream::MemberCallback(), bool typedObjects = true )
+                                : m_callback( callback ), m_typedObjects( typedObjects ) {}
+
+    //! Returns a parsed value.
+    const Variant&          result( void ) const { return m_result; }
+
+    //! Called for a null value.
+    virtual bool            onNull( void ) NIMBLE_OVERRIDE { return push( Variant() ); }
+
+    //! Called for a boolean value.
+    virtual bool            onBoolean( bool value ) NIMBLE_OVERRIDE { return push( Variant::fromValue<bool>( value ) ); }
+
+    //! Integer values are stored with the smallest type that fits them.
+    virtual bool            onInteger( s64 value ) NIMBLE_OVERRIDE
+    {
+        if( value >= INT_MIN && value <= INT_MAX ) {
+            return push( Variant::fromValue<s32>( static_cast<s32>( value ) ) );
+        }
+        if( value > 0 && value <= UINT_MAX ) {
+            return push( Variant::fromValue<u32>( static_cast<u32>( value ) ) );
+        }
+        return push( Variant::fromValue<s64>( value ) );
+    }
+
+    //! Called for a floating point number.
+    virtual bool            onNumber( f64 value ) NIMBLE_OVERRIDE { return push( Variant::fromValue<f64>( value ) ); }
+
+    //! Called for a string value.
+    virtual bool            onString( CString value, s32 length ) NIMBLE_OVERRIDE { return push( Variant::fromValue<String>( String( value, length ) ) ); }
+
+    //! Called for an object member key.
+    virtual bool            onKey( CString value, s32 length ) NIMBLE_OVERRIDE
+    {
+        m_stack.back().key.assign( value, length );
+        return true;
+    }
+
+    //! Called when an object starts.
+    virtual bool            onBeginObject( void ) NIMBLE_OVERRIDE
+    {
+        m_stack.push_back( Frame( true ) );
+        return true;
+    }
+
+    //! Objects that consist of vector, color or guid fields are converted to a corresponding type unless typed objects are disabled.
+    virtual bool            onEndObject( void ) NIMBLE_OVERRIDE
+    {
+        const KeyValue& object = m_stack.back().object;
+        Variant         value  = m_typedObjects ? convertObject( object ) : Variant::fromValue<KeyValue>( object );
+        m_stack.pop_back();
+        return push( value );
+    }
+
+    //! Called when an array starts.
+    virtual bool            onBeginArray( void ) NIMBLE_OVERRIDE
+    {
+        m_stack.push_back( Frame( false ) );
+        return true;
+    }
+
+    //! Called when an array ends.
+    virtual bool            onEndArray( void ) NIMBLE_OVERRIDE
+    {
+        Variant value = Variant::fromValue<VariantArray>( m_stack.back().array );
+        m_stack.pop_back();
+        return push( value );
+    }
+
+private:
+
+    //! A container being parsed.
+    struct Frame {
+                            Frame( bool isObject )
+                                : isObject( isObject ) {}
+
+        bool                isObject;   //!< Indicates that this frame is an object.
+        KeyValue            object;     //!< Parsed object members.
+        VariantArray        array;      //!< Parsed array items.
+        String              key;        //!< A key of the member being parsed.
+    };
+
+    //! Adds a parsed value to a parent container.
+    bool                    push( const Variant& value )
+    {
+        // A root value
+        if( m_stack.empty() ) {
+            m_result = value;
+            return true;
+        }
+
+        Frame& frame = m_stack.back();
+
+        // Members of a root object are passed to a callback instead of being stored
+        if( m_callback && m_stack.size() == 1 && frame.isObject ) {
+            return m_callback( frame.key, value );
+        }
+
+        if( frame.isObject ) {
+            frame.object.setValueAtKey( frame.key, value );
+        } else {
+            frame.array << value;
+        }
+
+        return true;
+    }
+
+    //! Reads the specified number of float values from an object, fails if any of them is not a number.
+    static bool             readFloats( const KeyValue& object, CString* keys, s32 count, f32* result )
+    {
+        for( s32 i = 0; i < count; i++ ) {
+            const Variant& value = object.valueAtKey( keys[i] );
+
+            if( !value.isValid() || !value.type()->isArithmetic() ) {
+                return false;
+            }
+
+            result[i] = value.as<f32>();
+        }
+
+        return true;
+    }
+
+    //! Converts an object to a typed value if possible.
+    static Variant          convertObject( const KeyValue& object )
+    {
+        static CString quat[] = { "qx", "qy", "qz", "qw" };
+        static CString rgba[] = { "r", "g", "b", "a" };
+        static CString vec4[] = { "x", "y", "z", "w" };
+
+        f32 v[4];
+
+        if( readFloats( object, quat, 4, v ) ) return Variant::fromValue<Quat>( Quat( v[0], v[1], v[2], v[3] ) );
+        if( readFloats( object, rgba, 4, v ) ) return Variant::fromValue<Rgba>( Rgba( v[0], v[1], v[2], v[3] ) );
+        if( readFloats( object, rgba, 3, v ) ) return Variant::fromValue<Rgb>( Rgb( v[0], v[1], v[2] ) );
+        if( readFloats( object, vec4, 4, v ) ) return Variant::fromValue<Vec4>( Vec4( v[0], v[1], v[2], v[3] ) );
+        if( readFloats( object, vec4, 3, v ) ) return Variant::fromValue<Vec3>( Vec3( v[0], v[1], v[2] ) );
+        if( readFloats( object, vec4, 2, v ) ) return Variant::fromValue<Vec2>( Vec2( v[0], v[1] ) );
+
+        const Variant& typeId = object.valueAtKey( "typeID" );
+
+        if( typeId.isValid() && typeId.as<String>() == "guid" ) {
+            return Variant::fromValue<Guid>( Guid( object.valueAtKey( "value" ).as<String>() ) );
+        }
+
+        return Variant::fromValue<KeyValue>( object );
+    }
+
+private:
+
+    VariantTextStream::MemberCallback   m_callback;     //!< Receives root object members.
+    Array<Frame>                        m_stack;        //!< Containers being parsed.
+    bool                                m_typedObjects; //!< Indicates that objects are converted to typed values.
+    Variant                             m_result;       //!< A parsed root value.
+};
+
 // ** VariantTextStream::parse
 Variant VariantTextStream::parse( const String& text )
 {
-#ifdef JSONCPP_FOUND
-    Json::Value json;
-    Json::Reader reader;
-    
-    if( !reader.parse( text, json ) ) {
-        LogError( "keyValue", "%s", "failed to parse JSON string.\n" );
+    return parse( text.c_str(), static_cast<s32>( text.length() ) );
+}
+
+// ** VariantTextStream::parse
+Variant VariantTextStream::parse( CString text, s32 length )
+{
+    VariantJsonBuilder builder;
+    JsonReader         reader;
+
+    if( !reader.parse( text, length, builder ) ) {
+        LogError( "keyValue", "failed to parse JSON string, %s at line %d.\n", reader.error().c_str(), reader.line() );
         return Variant();
     }
 
-    return fromJson( json );
-#else
-    LogError( "variant", "%s", "failed to parse from string, built with no JSON support.\n" );
-    return Variant();
-#endif    /*    #ifdef JSONCPP_FOUND    */
+    return builder.result();
+}
+
+// ** VariantTextStream::parseMembers
+bool VariantTextStream::parseMembers( CString text, s32 length, const MemberCallback& callback, bool typedObjects )
+{
+    NIMBLE_ABORT_IF( !callback, "invalid callback" );
+
+    VariantJsonBuilder builder( callback, typedObjects );
+    JsonReader         reader;
+
+    if( !reader.parse( text, length, builder ) ) {
+        LogError( "keyValue", "failed to parse JSON string, %s at line %d.\n", reader.error().c_str(), reader.line() );
+        return false;
+    }
+
+    return true;
 }
 
 #ifdef JSONCPP_FOUND
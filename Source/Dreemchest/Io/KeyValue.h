@@ -37,12 +37,26 @@ namespace Io {
     class VariantTextStream {
     public:
 
+        //! Callback type used to receive members of a root JSON object.
+        typedef cClosure<bool(const String&, const Variant&)> MemberCallback;
+
         //! Converts Variant to a JSON string.
         static String        stringify( const Variant& value, bool formatted = false );
 
         //! Parses Variant from a JSON string.
         static Variant        parse( const String& text );
 
+        //! Parses Variant from a JSON text that is not required to be null-terminated.
+        static Variant        parse( CString text, s32 length );
+
+        //! Parses a root JSON object and passes each member to a callback as soon as it is read.
+        /*!
+         Only a single member value is kept in memory at a time, so large files with many
+         top-level records are loaded without constructing a whole document first. Objects
+         are kept as KeyValue instances when typedObjects is false.
+         */
+        static bool           parseMembers( CString text, s32 length, const MemberCallback& callback, bool typedObjects = true );
+
     #ifdef JSONCPP_FOUND
         //! Converts Variant to JSON object.
         static Json::Value    toJson( const Variant& value );
@@ -54,6 +68,7 @@ namespace Io {
 
     //! Default KeyValue binary writer.
     class BinaryVariantStream {
+    friend class BinaryVariantView;
     public:
 
                     //! Constructs the BinaryVariantStream instance.
@@ -35,9 +35,6 @@ ConnectionTCP::ConnectionTCP( TCPSocketPtr socket ) : m_socket( socket )
 {
     NIMBLE_ABORT_IF( !m_socket.valid(), "invalid socket" );
 
-    // Create the temporary read buffer for received packet
-    m_packet = Io::ByteBuffer::create();
-
     // Subscribe for socket events
     m_socket->subscribe<TCPSocket::Data>( dcThisMethod( ConnectionTCP::handleSocketData ) );
     m_socket->subscribe<TCPSocket::Closed>( dcThisMethod( ConnectionTCP::handleSocketClosed ) );
@@ -107,15 +104,19 @@ void ConnectionTCP::handleSocketData( const TCPSocket::Data& e )
 
     // Parse packets while there is data left in a TCP stream 
     while( data->hasDataLeft() ) {
-        // Read single packet from a stream
-        Header header = readPacket( data, m_packet );
+        // Read single packet header from a stream
+        Header header = readPacketHeader( data );
 
         if( !header.type ) {
             break;
         }
 
-        // Notify about this packet
-        notifyPacketReceived( header.type, header.size, m_packet );
+        // Notify about this packet, listeners read packet data directly from a receive buffer
+        s32 start = data->position();
+        notifyPacketReceived( header.type, header.size, data );
+
+        // Skip the packet data no matter how much was consumed by listeners
+        data->setPosition( start + header.size, Io::SeekSet );
     }
 
     // Trim processed data
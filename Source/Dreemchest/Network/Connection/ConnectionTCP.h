@@ -67,7 +67,6 @@ namespace Network {
     private:
 
         TCPSocketPtr        m_socket;   //!< TCP socket instance.
-        Io::ByteBufferPtr   m_packet;   //!< Packet temporary read buffer.
     };
 
 } // namespace Network
@@ -43,6 +43,7 @@ Connection_::Connection_( void )
     , m_roundTripTime( 0 )
     , m_shouldClose( false )
 {
+    m_sendBuffer = Io::ByteBuffer::create();
 }
 
 // ** Connection::setId
@@ -146,14 +147,15 @@ void Connection_::addMiddleware( ConnectionMiddlewareUPtr instance )
 // ** Connection::send
 void Connection_::send( const AbstractPacket& packet )
 {
-    // Create the network data to write packet to
-    Io::ByteBufferPtr stream = Io::ByteBuffer::create();
+    // Reset the send buffer, the allocated memory is kept between sends
+    m_sendBuffer->setPosition( 0, Io::SeekSet );
+    m_sendBuffer->trimFromRight( m_sendBuffer->length() );
 
     // Write packet to binary stream
-    u32 bytesWritten = writePacket( packet, stream );
+    u32 bytesWritten = writePacket( packet, m_sendBuffer );
 
     // Send binary data to socket
-    s32 bytesSent = sendData( stream );
+    s32 bytesSent = sendData( m_sendBuffer );
 
     // The socket was closed.
     if( bytesSent == 0 ) {
@@ -195,8 +197,8 @@ s32 Connection_::writePacket( const AbstractPacket& packet, Io::ByteBufferWPtr s
     return stream->position() - position;
 }
 
-// ** Connection::readPacket
-Connection_::Header Connection_::readPacket( Io::ByteBufferWPtr stream, Io::ByteBufferWPtr packet ) const
+// ** Connection::readPacketHeader
+Connection_::Header Connection_::readPacketHeader( Io::ByteBufferWPtr stream ) const
 {
     // The received data is too small to be a readable packet
     if( stream->bytesAvailable() < Header::Size ) {
@@ -217,17 +219,6 @@ Connection_::Header Connection_::readPacket( Io::ByteBufferWPtr stream, Io::Byte
         return Header();
     }
 
-    // Copy data from a stream to a packet buffer
-    packet->setPosition( 0, Io::SeekSet );
-    if( header.size ) {
-        // Copy bytes from a stream to a packet buffer
-        packet->write( stream->current(), header.size );
-        packet->setPosition( 0, Io::SeekSet );
-
-        // Advance the stream cursor
-        stream->setPosition( header.size, Io::SeekCur );
-    }
-
     return header;
 }
 
@@ -142,8 +142,11 @@ namespace Network {
         //! Writes the packet to a binary stream.
         s32                     writePacket( const AbstractPacket& packet, Io::ByteBufferWPtr stream ) const;
 
-        //! Reads the packet from a binary stream to a temporary buffer and returns it's header.
-        Header                  readPacket( Io::ByteBufferWPtr stream, Io::ByteBufferWPtr packet ) const;
+        //! Reads the packet header from a binary stream and leaves the stream positioned at the packet data.
+        /*!
+         Returns an empty header and keeps the stream position unchanged if the whole packet was not received yet.
+         */
+        Header                  readPacketHeader( Io::ByteBufferWPtr stream ) const;
 
         //! Updates this connection
         void                    update( u32 dt );
@@ -167,6 +170,7 @@ namespace Network {
         s32                        m_roundTripTime;        //!< Current round trip time.
         bool                    m_shouldClose;            //!< Indicates that a connection should be closed.
         ConnectionMiddlewares    m_middlewares;            //!< Connection middlewares added to connection.
+        Io::ByteBufferPtr       m_sendBuffer;           //!< Outgoing packets are serialized to this buffer that is reused between sends.
     };
 
 #if DREEMCHEST_CPP11
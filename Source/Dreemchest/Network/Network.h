@@ -239,7 +239,7 @@ namespace Network {
     struct RemoteCall {
         typedef TArgument Argument;
         typedef TResponse Response;
-        static String32   id( void ) { return String32( name() ); }
+        static u32        id( void ) { static u32 hash = String32( name() ); return hash; }
         static CString    name( void ) { return TypeInfo<TRemoteCall>::name(); }
     };
 
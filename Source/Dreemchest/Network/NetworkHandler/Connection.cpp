@@ -34,9 +34,25 @@ namespace Network {
 
 // ** Connection::Connection
 Connection::Connection( Application* application, const TCPSocketPtr& socket )
-    : ConnectionTCP( socket ), m_application( application ), m_nextRemoteCallId( 1 )
+    : ConnectionTCP( socket ), m_application( application ), m_activeRemoteCalls( 0 )
 {
     memset( &m_traffic, 0, sizeof( m_traffic ) );
+
+    // Preallocate pending remote call slots, so no allocations are made when invoking remote procedures
+    m_pendingRemoteCalls.resize( MaxPendingRemoteCalls );
+    m_freeRemoteCallSlots.reserve( MaxPendingRemoteCalls );
+
+    for( s32 i = MaxPendingRemoteCalls - 1; i >= 0; i-- ) {
+        m_freeRemoteCallSlots.push_back( static_cast<u16>( i ) );
+    }
+}
+
+// ** Connection::~Connection
+Connection::~Connection( void )
+{
+    for( s32 i = 0; i < MaxPendingRemoteCalls; i++ ) {
+        delete m_pendingRemoteCalls[i].m_handler;
+    }
 }
 
 // ** Connection::traffic
@@ -51,20 +67,59 @@ Application* Connection::application( void ) const
     return m_application;
 }
 
+// ** Connection::acquireRemoteCall
+u16 Connection::acquireRemoteCall( CString name, IRemoteResponseHandler* handler )
+{
+    if( m_freeRemoteCallSlots.empty() ) {
+        LogWarning( "rpc", "too many pending remote calls, '%s' was not sent\n", name );
+        delete handler;
+        return 0;
+    }
+
+    // Pop the free slot
+    u16 slot = m_freeRemoteCallSlots.back();
+    m_freeRemoteCallSlots.pop_back();
+
+    // Setup the pending remote call
+    PendingRemoteCall& call = m_pendingRemoteCalls[slot];
+    call.m_name     = name;
+    call.m_timeLeft = 60000;
+    call.m_handler  = handler;
+    m_activeRemoteCalls++;
+
+    return static_cast<u16>( (call.m_generation << RemoteCallSlotBits) | slot );
+}
+
+// ** Connection::releaseRemoteCall
+void Connection::releaseRemoteCall( u16 slot )
+{
+    PendingRemoteCall& call = m_pendingRemoteCalls[slot];
+
+    delete call.m_handler;
+    call.m_handler = NULL;
+
+    // Advance the slot generation, so late responses to this call are rejected
+    call.m_generation = call.m_generation == RemoteCallMaxGeneration ? 1 : call.m_generation + 1;
+
+    m_freeRemoteCallSlots.push_back( slot );
+    m_activeRemoteCalls--;
+}
+
 // ** Connection::handleResponse
 void Connection::handleResponse( const Packets::RemoteCallResponse& packet )
 {
     // Find pending remote call
-    PendingRemoteCalls::iterator i = m_pendingRemoteCalls.find( packet.id );
+    u16 slot       = packet.id & RemoteCallSlotMask;
+    u16 generation = packet.id >> RemoteCallSlotBits;
 
-    if( i == m_pendingRemoteCalls.end() ) {
+    if( slot >= MaxPendingRemoteCalls || m_pendingRemoteCalls[slot].m_handler == NULL || m_pendingRemoteCalls[slot].m_generation != generation ) {
         LogWarning( "rpc", "received response with an invalid request id %d\n", packet.id );
         return;
     }
 
     // Run a callback
-    i->second.m_handler->handle( this, packet );
-    m_pendingRemoteCalls.erase( i );
+    m_pendingRemoteCalls[slot].m_handler->handle( this, packet );
+    releaseRemoteCall( slot );
 }
 
 // ** Connection::update
@@ -80,16 +135,22 @@ void Connection::update( u32 dt )
         m_traffic.m_lastReceivedBytes = totalBytesReceived();
     }
 
-    if( m_pendingRemoteCalls.empty() ) {
+    if( m_activeRemoteCalls == 0 ) {
         return;
     }
 
-    for( PendingRemoteCalls::iterator i = m_pendingRemoteCalls.begin(); i != m_pendingRemoteCalls.end(); ) {
-        if( i->second.m_timeLeft < 0 ) {
-            LogWarning( "rpc", "'%s' timed out\n", i->second.m_name.c_str() );
-            i = m_pendingRemoteCalls.erase( i );
-        } else {
-            ++i;
+    for( s32 i = 0; i < MaxPendingRemoteCalls; i++ ) {
+        PendingRemoteCall& call = m_pendingRemoteCalls[i];
+
+        if( call.m_handler == NULL ) {
+            continue;
+        }
+
+        call.m_timeLeft -= dt;
+
+        if( call.m_timeLeft < 0 ) {
+            LogWarning( "rpc", "'%s' timed out\n", call.m_name );
+            releaseRemoteCall( static_cast<u16>( i ) );
         }
     }
 }
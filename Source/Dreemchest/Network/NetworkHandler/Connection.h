@@ -39,6 +39,8 @@ namespace Network {
     friend class Application;
     public:
 
+        virtual                 ~Connection( void );
+
         //! A helper struct to track the traffic in kbps.
         struct Traffic {
             u32                    m_lastUpdateTimestamp;    //!< The last time the tracking was updated.
@@ -66,6 +68,9 @@ namespace Network {
         template<typename TEvent>
         void                    emit( const TEvent& e );
 
+        //! The maximum number of remote calls that can be in-flight over a single connection.
+        enum { MaxPendingRemoteCalls = 1024 };
+
     private:
 
                                 //! Constructs Connection instance.
@@ -77,30 +82,46 @@ namespace Network {
         //! Handles a recieved remote call response.
         void                    handleResponse( const Packets::RemoteCallResponse& packet );
 
+        //! Allocates a pending remote call slot and returns the request id or 0 if there are no free slots left.
+        u16                     acquireRemoteCall( CString name, IRemoteResponseHandler* handler );
+
+        //! Releases a pending remote call slot and destroys it's response handler.
+        void                    releaseRemoteCall( u16 slot );
+
     private:
 
+        //! Number of bits used to store a slot index inside the remote call id, the rest of bits store the slot generation.
+        enum { RemoteCallSlotBits = 10, RemoteCallSlotMask = (1 << RemoteCallSlotBits) - 1, RemoteCallMaxGeneration = 0xFFFF >> RemoteCallSlotBits };
+
         //! A helper struct to store a timestamp of an RPC call.
         struct PendingRemoteCall {
-            String                            m_name;            //!< Remote procedure name.
+            CString                         m_name;            //!< Remote procedure name.
             s32                                m_timeLeft;        //!< The time left to wait for a response to this call.
-            UPtr<IRemoteResponseHandler>    m_handler;        //!< Response handler.
+            IRemoteResponseHandler*         m_handler;        //!< Response handler, NULL for free slots.
+            u16                             m_generation;   //!< Slot generation used to reject stale responses.
 
                                             //! Constructs a PendingRemoteCall instance.
-                                            PendingRemoteCall( const String& name = "", IRemoteResponseHandler* handler = NULL, s32 timeLeft = 60000 )
-                                                : m_name( name ), m_timeLeft( timeLeft ), m_handler( handler ) {}
+                                            PendingRemoteCall( void )
+                                                : m_name( "" ), m_timeLeft( 0 ), m_handler( NULL ), m_generation( 1 ) {}
         };
 
-        //! A container type to store all pending remote calls.
-        typedef Map< u16, PendingRemoteCall > PendingRemoteCalls;
+        //! A flat array of pending remote call slots indexed by the lower bits of a remote call id.
+        typedef Array<PendingRemoteCall> PendingRemoteCalls;
+
+        //! A stack of free pending remote call slots.
+        typedef Array<u16> FreeRemoteCallSlots;
 
         //! Parent network connection.
         Application*            m_application;
 
-        //! A list of pending remote calls.
+        //! Pending remote call slots.
         PendingRemoteCalls        m_pendingRemoteCalls;
 
-        //! Next remote call response id.
-        u16                        m_nextRemoteCallId;
+        //! Free pending remote call slots.
+        FreeRemoteCallSlots     m_freeRemoteCallSlots;
+
+        //! The total number of in-flight remote calls.
+        s32                     m_activeRemoteCalls;
 
         //! Traffic counter.
         Traffic                    m_traffic;
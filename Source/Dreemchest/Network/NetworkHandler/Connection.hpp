@@ -36,70 +36,68 @@ namespace Private {
     //! Writes a network argument value to a binary stream
     struct PrimitiveValueWriter {
         template<typename TValue>
-        static Io::ByteBufferPtr write( const TValue& value )
+        static void write( const TValue& value, Io::StreamWPtr stream )
         {
             NIMBLE_STATIC_ASSERT( false, "the specified type could not be sent over a network" );
-            return Io::ByteBufferPtr();
         }
         
         template<typename TValue>
-        static TValue read( Io::StreamPtr stream )
+        static TValue read( Io::StreamWPtr stream )
         {
             NIMBLE_STATIC_ASSERT( false, "the specified type could not be sent over a network" );
             return TValue();
         }
         
         template<>
-        static Io::ByteBufferPtr write( const KeyValue& value )
+        static void write( const KeyValue& value, Io::StreamWPtr stream )
         {
-            Io::ByteBufferPtr buffer = Io::ByteBuffer::create();
-            Io::BinaryVariantStream stream( buffer );
-            stream.write( Variant::fromValue( value ) );
-            return buffer;
+            Io::BinaryVariantStream writer( Io::StreamPtr( stream.get() ) );
+            writer.write( Variant::fromValue( value ) );
         }
         
         template<>
-        static KeyValue read( Io::StreamPtr stream )
+        static KeyValue read( Io::StreamWPtr stream )
         {
-            Io::BinaryVariantStream reader( stream );
+            Io::BinaryVariantStream reader( Io::StreamPtr( stream.get() ) );
             Variant kv = Variant::fromValue( KeyValue() );
             reader.read( kv );
             return kv.as<KeyValue>();
         }
     };
     
+    //! Returns a serializer shared by all meta-object arguments, so serialization plans are built once per class.
+    inline const Reflection::Serializer& sharedSerializer( void )
+    {
+        static Reflection::Serializer serializer;
+        return serializer;
+    }
+    
+    //! Writes meta-object properties straight to a binary stream.
     struct MetaObjectWriter {
         template<typename T>
-        static Io::ByteBufferPtr write( const T& value )
+        static void write( const T& value, Io::StreamWPtr stream )
         {
-            Reflection::Serializer serializer;
-            KeyValue ar;
-            serializer.serialize( value.metaInstance(), ar );
-            return PrimitiveValueWriter::write( ar );
+            sharedSerializer().serialize( value.metaInstance(), stream );
         }
         
         template<typename T>
-        static T read( Io::StreamPtr stream )
+        static T read( Io::StreamWPtr stream )
         {
-            Reflection::Serializer serializer;
-            KeyValue kv = PrimitiveValueWriter::read<KeyValue>( stream );
             T v;
-            serializer.deserialize( v.metaInstance(), kv );
+            sharedSerializer().deserialize( v.metaInstance(), stream );
             return v;
         }
     };
     
     struct StreamableWriter {
         template<typename T>
-        static Io::ByteBufferPtr write( const T& value )
+        static void write( const T& value, Io::StreamWPtr stream )
         {
-            Io::ByteBufferPtr stream = Io::ByteBuffer::create();
             value.serialize( stream );
-            return stream;
         }
         
         template<typename T>
-        static T read( Io::StreamPtr stream )
+        static T read( Io::StreamWPtr stream )
         {
             T v;
             v.deserialize( stream );
@@ -108,63 +106,84 @@ namespace Private {
     };
     
     template<typename TValue>
-    Io::ByteBufferPtr writeToStream( const TValue& value )
+    void writeToStream( const TValue& value, Io::StreamWPtr stream )
     {
-        return TypeSelector<Reflection::Has_staticMetaObject<TValue>::value, MetaObjectWriter, TypeSelector<IsBaseOf<Io::Streamable, TValue>::value, StreamableWriter, PrimitiveValueWriter>::type>::type::write<TValue>( value );
+        TypeSelector<Reflection::Has_staticMetaObject<TValue>::value, MetaObjectWriter, TypeSelector<IsBaseOf<Io::Streamable, TValue>::value, StreamableWriter, PrimitiveValueWriter>::type>::type::write<TValue>( value, stream );
     }
     
     template<typename TValue>
-    TValue readFromStream( Io::StreamPtr stream )
+    TValue readFromStream( Io::StreamWPtr stream )
     {
         return TypeSelector<Reflection::Has_staticMetaObject<TValue>::value, MetaObjectWriter, TypeSelector<IsBaseOf<Io::Streamable, TValue>::value, StreamableWriter, PrimitiveValueWriter>::type>::type::read<TValue>( stream );
     }
+
+    //! Reads a value from a received payload view without copying the payload bytes.
+    template<typename TValue>
+    TValue readFromPayload( const PayloadView& payload )
+    {
+        return readFromStream<TValue>( payload.open() );
+    }
     
 } // namespace Private
 
+//! A payload that serializes a referenced value straight into an outgoing packet stream.
+template<typename T>
+class Payload : public AbstractPayload {
+public:
+
+                    //! Constructs Payload instance.
+                    Payload( const T& value )
+                        : m_value( value ) {}
+
+    //! Writes the referenced value to a stream.
+    virtual void    serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE { Private::writeToStream( m_value, stream ); }
+
+private:
+
+    const T&        m_value;    //!< The value being sent.
+};
+
 // ** Connection::invokeVoid
 template<typename TRemoteProcedure>
 void Connection::invokeVoid( const typename TRemoteProcedure::Argument& argument )
 {
-    Io::ByteBufferPtr buffer = Private::writeToStream( argument );
-    send<Packets::RemoteCall>( 0, TRemoteProcedure::id(), 0, buffer->array() );
+    Payload<typename TRemoteProcedure::Argument> payload( argument );
+    send<Packets::RemoteCall>( 0, TRemoteProcedure::id(), 0, &payload );
 }
 
 // ** Connection::invoke
 template<typename TRemoteProcedure>
 void Connection::invoke( const typename TRemoteProcedure::Argument& argument, const typename RemoteResponseHandler<typename TRemoteProcedure::Response>::Callback& callback )
 {
-    Io::ByteBufferPtr buffer = Private::writeToStream( argument );
-    
-    // Send an RPC request
-    u16     remoteCallId = m_nextRemoteCallId++;
+    // Allocate a pending call slot before sending a request
+    u16 remoteCallId = acquireRemoteCall( TRemoteProcedure::name(), DC_NEW RemoteResponseHandler<typename TRemoteProcedure::Response>( callback ) );
+
+    if( !remoteCallId ) {
+        return;
+    }
+
+    // Send an RPC request, the argument is serialized directly to an outgoing buffer
+    Payload<typename TRemoteProcedure::Argument> payload( argument );
     TypeId  returnTypeId = TypeInfo<typename TRemoteProcedure::Response>::id();
     
-    send<Packets::RemoteCall>( remoteCallId, TRemoteProcedure::id(), returnTypeId, buffer->array() );
-    
-    // Create a response handler.
-    m_pendingRemoteCalls[remoteCallId] = PendingRemoteCall( TRemoteProcedure::name(), DC_NEW RemoteResponseHandler<typename TRemoteProcedure::Response>( callback ) );
+    send<Packets::RemoteCall>( remoteCallId, TRemoteProcedure::id(), returnTypeId, &payload );
 }
 
 // ** Connection::emit
 template<typename TEvent>
 void Connection::emit( const TEvent& e )
 {
-    // Serialize event to a byte buffer.
-    Io::ByteBufferPtr buffer = Private::writeToStream( e );
-    
-    // Send the packet
-    send<Packets::Event>( TypeInfo<TEvent>::id(), buffer->array() );
+    Payload<TEvent> payload( e );
+    send<Packets::Event>( TypeInfo<TEvent>::id(), &payload );
 }
 
 //! Send a response to caller.
 template<typename T>
 inline bool Response<T>::operator()( const T& value, const Error& error )
 {
-    // Serialize argument to a byte buffer.
-    Io::ByteBufferPtr buffer = Private::writeToStream( value );
-    
-    // Send an RPC response packet.
-    m_connection->send<Packets::RemoteCallResponse>( m_id, error, TypeInfo<T>::id(), buffer->array() );
+    // Send an RPC response packet, the value is serialized directly to an outgoing buffer.
+    Payload<T> payload( value );
+    m_connection->send<Packets::RemoteCallResponse>( m_id, error, TypeInfo<T>::id(), &payload );
     
     // Mark this response as sent.
     m_wasSent = true;
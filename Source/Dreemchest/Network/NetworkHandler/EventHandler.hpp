@@ -35,7 +35,7 @@ namespace Network {
 template<typename T>
 inline bool EventHandler<T>::handle( ConnectionWPtr connection, const Packets::Event& packet )
 {
-    T event = Private::readFromStream<T>( Io::ByteBuffer::createFromArray( packet.payload ) );
+    T event = Private::readFromPayload<T>( packet.payload );
     m_eventEmitter->notify( event );
     return true;
 }
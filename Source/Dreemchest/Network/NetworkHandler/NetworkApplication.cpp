@@ -66,6 +66,11 @@ Application::~Application( void )
         ConnectionPtr connection = *i;
         connection->close();
     }
+
+    // Destroy all registered remote call handlers
+    for( RemoteCallHandlers::iterator i = m_remoteCallHandlers.begin(), end = m_remoteCallHandlers.end(); i != end; ++i ) {
+        delete *i;
+    }
 }
 
 // ** Application::createConnection
@@ -132,19 +137,36 @@ void Application::handlePingPacket( ConnectionWPtr connection, const Packets::Pi
     }
 }
 
+// ** Application::registerRemoteCallHandler
+void Application::registerRemoteCallHandler( u32 method, IRemoteCallHandler* handler )
+{
+    RemoteCallIndices::iterator i = m_remoteCallIndices.find( method );
+
+    // This remote procedure was already registered - replace the handler
+    if( i != m_remoteCallIndices.end() ) {
+        delete m_remoteCallHandlers[i->second];
+        m_remoteCallHandlers[i->second] = handler;
+        return;
+    }
+
+    // Append a new handler to a table
+    m_remoteCallIndices[method] = static_cast<u32>( m_remoteCallHandlers.size() );
+    m_remoteCallHandlers.push_back( handler );
+}
+
 // ** Application::handleRemoteCallPacket
 void Application::handleRemoteCallPacket( ConnectionWPtr connection, const Packets::RemoteCall& packet )
 {
     // Find a remote call handler
-    RemoteCallHandlers::iterator i = m_remoteCallHandlers.find( String32( packet.method ) );
+    RemoteCallIndices::const_iterator i = m_remoteCallIndices.find( packet.method );
 
-    if( i == m_remoteCallHandlers.end() ) {
+    if( i == m_remoteCallIndices.end() ) {
         LogWarning( "rpc", "trying to invoke unknown remote procedure %d\n", packet.method );
         return;
     }
 
     // Invoke a method
-    i->second->handle( connection, packet );
+    m_remoteCallHandlers[i->second]->handle( connection, packet );
 }
 
 // ** Application::handleRemoteCallResponsePacket
@@ -174,12 +196,12 @@ void Application::handlePacketReceived( const Connection::Received& e )
     // Type cast the connection instance
     ConnectionWPtr connection = static_cast<Connection*>( e.sender.get() );
 
-    // Create instance of a network packet
-    PacketUPtr packet = m_packetFactory.construct( e.type );
+    // Get the packet instance to deserialize received data to
+    AbstractPacket* packet = receivedPacket( e.type );
 
     // The packet type is unknown - skip it
     if( packet == NULL ) {
-        LogDebug( "packet", "packet of unknown type %d received, %d bytes skipped\n", e.type, e.packet->bytesAvailable() );
+        LogDebug( "packet", "packet of unknown type %d received, %d bytes skipped\n", e.type, e.size );
         return;
     }
 
@@ -189,7 +211,7 @@ void Application::handlePacketReceived( const Connection::Received& e )
     // Get the packet stream
     Io::ByteBufferWPtr stream = e.packet;
 
-    // Read the packet data from a stream
+    // Read the packet data from a stream, payloads are not copied and remain inside the receive buffer
     s32 position = stream->position();
     packet->deserialize( stream );
     s32 bytesRead = stream->position() - position;
@@ -206,6 +228,29 @@ void Application::handlePacketReceived( const Connection::Received& e )
     }
 }
 
+// ** Application::receivedPacket
+AbstractPacket* Application::receivedPacket( PacketTypeId type )
+{
+    // Packet instances are reused between received packets of the same type
+    ReceivedPackets::iterator i = m_receivedPackets.find( type );
+
+    if( i != m_receivedPackets.end() ) {
+        return i->second.get();
+    }
+
+    // Create instance of a network packet
+    PacketUPtr packet = m_packetFactory.construct( type );
+
+    if( packet == NULL ) {
+        return NULL;
+    }
+
+    AbstractPacket* result = packet.get();
+    m_receivedPackets[type] = packet;
+
+    return result;
+}
+
 // ** Application::handleConnectionClosed
 void Application::handleConnectionClosed( const Connection::Closed& e )
 {
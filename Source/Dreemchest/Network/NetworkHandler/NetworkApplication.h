@@ -132,9 +132,15 @@ namespace Network {
         //! Handles a response to remote call.
         void                    handleRemoteCallResponsePacket( ConnectionWPtr connection, const Packets::RemoteCallResponse& packet );
 
+        //! Registers a remote call handler for a specified remote procedure identifier.
+        void                    registerRemoteCallHandler( u32 method, IRemoteCallHandler* handler );
+
         //! Handles a packet received over a connection.
         void                    handlePacketReceived( const Connection::Received& e );
 
+        //! Returns a packet instance used to deserialize received packets of a specified type.
+        AbstractPacket*         receivedPacket( PacketTypeId type );
+
         //! Handles the connection closed event.
         void                    handleConnectionClosed( const Connection::Closed& e );
 
@@ -143,8 +149,11 @@ namespace Network {
         //! A container type to store all network event emitters.
         typedef Map< TypeId, UPtr<IEventHandler> > EventHandlers;
     
-        //! A container type to store all remote call handlers.
-        typedef Map< String32, UPtr<IRemoteCallHandler> > RemoteCallHandlers;
+        //! A dense table of remote call handlers, the handler index is resolved once at registration time.
+        typedef Array<IRemoteCallHandler*>                RemoteCallHandlers;
+
+        //! A container type to map from a remote procedure identifier to a handler index.
+        typedef HashMap<u32, u32>                         RemoteCallIndices;
 
         //! Container type to store active connections.
         typedef Set<ConnectionPtr>                        ConnectionSet;
@@ -158,10 +167,15 @@ namespace Network {
         //! Network packet factory type.
         typedef AbstractFactory<AbstractPacket, PacketTypeId> PacketFactory;
 
+        //! Container type to store packet instances that are reused for received packets.
+        typedef Map<PacketTypeId, PacketUPtr>           ReceivedPackets;
+
         EventHandlers            m_eventHandlers;            //!< Event handlers.
         RemoteCallHandlers        m_remoteCallHandlers;       //!< Remote call handlers.
+        RemoteCallIndices       m_remoteCallIndices;        //!< Remote call handler indices.
         PacketFactory           m_packetFactory;            //!< Packet factory.
         PacketHandlers          m_packetHandlers;           //!< Registered packet handlers.
+        ReceivedPackets         m_receivedPackets;          //!< Reusable received packet instances.
         ConnectionSet            m_connections;                //!< Active connections.
         u32                     m_nextConnectionId;         //!< The next id that will be assigned to a connection.
         TrafficPerPacket        m_bytesSentPerPacket;       //!< The total number of bytes sent by each packet type.
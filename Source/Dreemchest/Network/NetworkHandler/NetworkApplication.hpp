@@ -42,14 +42,14 @@ namespace Network {
     template<typename TRemoteProcedure>
     inline void Application::registerRemoteProcedureVoid( const typename RemoteCallHandler<typename TRemoteProcedure::Argument, Void>::Callback& callback )
     {
-        m_remoteCallHandlers[TRemoteProcedure::id()] = DC_NEW RemoteCallHandler<typename TRemoteProcedure::Argument, Void>( callback );
+        registerRemoteCallHandler( TRemoteProcedure::id(), DC_NEW RemoteCallHandler<typename TRemoteProcedure::Argument, Void>( callback ) );
     }
     
     // ** NetworkHandler::registerRemoteProcedure
     template<typename TRemoteProcedure>
     inline void Application::registerRemoteProcedure( const typename RemoteCallHandler<typename TRemoteProcedure::Argument, typename TRemoteProcedure::Response>::Callback& callback )
     {
-        m_remoteCallHandlers[TRemoteProcedure::id()] = DC_NEW RemoteCallHandler<typename TRemoteProcedure::Argument, typename TRemoteProcedure::Response>( callback );
+        registerRemoteCallHandler( TRemoteProcedure::id(), DC_NEW RemoteCallHandler<typename TRemoteProcedure::Argument, typename TRemoteProcedure::Response>( callback ) );
     }
     
     // ** Application::emitTo
@@ -50,14 +50,14 @@ template<typename T, typename R>
 inline void RemoteCallHandler<T, R>::handle( ConnectionWPtr connection, const Packets::RemoteCall& packet )
 {
     ResponseType response( connection, packet.id );
-    m_callback( connection, response, Private::readFromStream<T>( Io::ByteBuffer::createFromArray( packet.payload ) ) );
+    m_callback( connection, response, Private::readFromPayload<T>( packet.payload ) );
 }
 
 // ** RemoteResponseHandler::handle
 template<typename T>
 inline void RemoteResponseHandler<T>::handle( ConnectionWPtr connection, const Packets::RemoteCallResponse& packet )
 {
-    m_callback( connection, packet.error, Private::readFromStream<T>( Io::ByteBuffer::createFromArray( packet.payload ) ) );
+    m_callback( connection, packet.error, Private::readFromPayload<T>( packet.payload ) );
 }
     
 } // namespace Network
@@ -74,106 +74,147 @@ namespace Network {
     //! A binary blob type
     typedef Array<u8> BinaryBlob;
 
+    //! Base class for packet payloads that are serialized directly into an outgoing packet stream.
+    class AbstractPayload {
+    public:
+
+        virtual                 ~AbstractPayload( void ) {}
+
+        //! Writes the payload to a binary stream.
+        virtual void            serialize( Io::StreamWPtr stream ) const = 0;
+    };
+
+    //! A non-owning view of a payload stored inside a receive buffer.
+    /*!
+     The view is valid only while the packet is being dispatched, the receive
+     buffer is trimmed right after all packet handlers were invoked.
+     */
+    struct PayloadView {
+                                //! Constructs an empty PayloadView instance.
+                                PayloadView( void )
+                                    : offset( 0 ), length( 0 ) {}
+
+        //! Rewinds the source stream to the beginning of a payload and returns it.
+        Io::StreamWPtr          open( void ) const { stream->setPosition( offset, Io::SeekSet ); return stream; }
+
+        Io::StreamWPtr          stream;     //!< The receive stream that holds the payload.
+        s32                     offset;     //!< The payload offset inside the stream.
+        u16                     length;     //!< The payload length in bytes.
+    };
+
 namespace Packets {
 
+    //! Writes a payload prefixed by it's 16-bit length to a stream.
+    inline void writePayload( Io::StreamWPtr stream, const AbstractPayload* payload )
+    {
+        u16 length = 0;
+        s32 start  = stream->position();
+
+        // Reserve the space for a payload length and serialize payload right after it
+        stream->write( &length, sizeof length );
+        if( payload ) {
+            payload->serialize( stream );
+        }
+
+        // Now patch the payload length
+        s32 end = stream->position();
+        length  = static_cast<u16>( end - start - sizeof length );
+        stream->setPosition( start, Io::SeekSet );
+        stream->write( &length, sizeof length );
+        stream->setPosition( end, Io::SeekSet );
+    }
+
+    //! Reads a payload length from a stream and returns a view of a payload data without copying it.
+    inline PayloadView readPayload( Io::StreamWPtr stream )
+    {
+        PayloadView view;
+        stream->read( &view.length, sizeof view.length );
+        view.stream = stream;
+        view.offset = stream->position();
+        stream->setPosition( view.length, Io::SeekCur );
+        return view;
+    }
+
     //! RPC call packet.
     struct RemoteCall : public Packet<RemoteCall> {
-        u16                id;         //!< Remote call identifier.
-        u32                method;     //!< Remote call method identifier.
-        TypeId          returnType;
-        BinaryBlob      payload;    //!< Remote call argument.
+        u16                     id;         //!< Remote call identifier.
+        u32                     method;     //!< Remote call method identifier.
+        TypeId                  returnType;
+        const AbstractPayload*  argument;   //!< Remote call argument to be written to an outgoing stream.
+        PayloadView             payload;    //!< Received remote call argument.
 
                         //! Constructs RemoteCall instance.
-                        RemoteCall( u16 id = 0, u32 method = 0, TypeId returnType = 0, const BinaryBlob& payload = BinaryBlob() )
-                            : id( id ), method( method ), returnType( returnType ), payload( payload ) {}
+                        RemoteCall( u16 id = 0, u32 method = 0, TypeId returnType = 0, const AbstractPayload* argument = NULL )
+                            : id( id ), method( method ), returnType( returnType ), argument( argument ) {}
 
         virtual void    serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
         {
-            u16 length = static_cast<u16>( payload.size() );
-
             stream->write( &id, sizeof id );
             stream->write( &method, sizeof method );
             stream->write( &returnType, sizeof returnType );
-            stream->write( &length, sizeof length );
-            stream->write( &payload[0], length );
+            writePayload( stream, argument );
         }
 
         virtual void    deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
         {
-            u16 length = 0;
-
             stream->read( &id, sizeof id );
             stream->read( &method, sizeof method );
             stream->read( &returnType, sizeof returnType );
-            stream->read( &length, sizeof length );
-            payload.resize( length );
-            stream->read( &payload[0], length );
+            payload = readPayload( stream );
         }
     };
 
     //! RPC call response
     struct RemoteCallResponse : public Packet<RemoteCallResponse> {
-        u16            id;
-        Error        error;
-        TypeId        returnType;
-        BinaryBlob    payload;
+        u16                     id;
+        Error                   error;
+        TypeId                  returnType;
+        const AbstractPayload*  value;      //!< Response value to be written to an outgoing stream.
+        PayloadView             payload;    //!< Received response value.
 
                     //! Constructs RemoteCallResponse instance.
-                    RemoteCallResponse( u16 id = 0, const Error& error = Error(), TypeId returnType = 0, const BinaryBlob& payload = BinaryBlob() )
-                        : id( id ), error( error ), returnType( returnType ), payload( payload ) {}
+                    RemoteCallResponse( u16 id = 0, const Error& error = Error(), TypeId returnType = 0, const AbstractPayload* value = NULL )
+                        : id( id ), error( error ), returnType( returnType ), value( value ) {}
 
         virtual void    serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
         {
-            u16 length = static_cast<u16>( payload.size() );
-
             stream->write( &id, sizeof id );
             stream->write( &error.code, sizeof error.code );
             stream->writeString( error.message.c_str() );
             stream->write( &returnType, sizeof returnType );
-            stream->write( &length, sizeof length );
-            stream->write( &payload[0], length );
+            writePayload( stream, value );
         }
 
         virtual void    deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
         {
-            u16 length = 0;
-
             stream->read( &id, sizeof id );
             stream->read( &error.code, sizeof error.code );
             stream->readString( error.message );
             stream->read( &returnType, sizeof returnType );
-            stream->read( &length, sizeof length );
-            payload.resize( length );
-            stream->read( &payload[0], length );
+            payload = readPayload( stream );
         }
     };
 
     //! Network event packet
     struct Event : public Packet<Event> {
-        TypeId            eventId;
-        BinaryBlob        payload;
+        TypeId                  eventId;
+        const AbstractPayload*  event;      //!< Event to be written to an outgoing stream.
+        PayloadView             payload;    //!< Received event data.
 
                         //! Constructs Event instance.
-                        Event( TypeId eventId = 0, const BinaryBlob& payload = BinaryBlob() )
-                            : eventId( eventId ), payload( payload ) {}
+                        Event( TypeId eventId = 0, const AbstractPayload* event = NULL )
+                            : eventId( eventId ), event( event ) {}
 
         virtual void    serialize( Io::StreamWPtr stream ) const NIMBLE_OVERRIDE
         {
-            u16 length = static_cast<u16>( payload.size() );
-
             stream->write( &eventId, sizeof eventId );
-            stream->write( &length, sizeof length );
-            stream->write( &payload[0], length );
+            writePayload( stream, event );
         }
 
         virtual void    deserialize( Io::StreamWPtr stream ) NIMBLE_OVERRIDE
         {
-            u16 length = 0;
-
             stream->read( &eventId, sizeof eventId );
-            stream->read( &length, sizeof length );
-            payload.resize( length );
-            stream->read( &payload[0], length );
+            payload = readPayload( stream );
         }
     };
 
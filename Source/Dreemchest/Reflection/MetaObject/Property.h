@@ -31,6 +31,8 @@
 #include "Iterator.h"
 #include "instance.h"
 
+#include "../../Io/streams/Stream.h"
+
 DC_BEGIN_DREEMCHEST
 
 namespace Reflection {
@@ -85,6 +87,18 @@ namespace Reflection {
         //! Converts a property value to a Variant.
         virtual Variant             serialize( InstanceConst instance ) const NIMBLE_ABSTRACT;
 
+        //! Returns true if a property value can be written to a binary stream without a Variant conversion.
+        virtual bool                isBinary( void ) const NIMBLE_ABSTRACT;
+
+        //! Returns the number of bytes a binary property value occupies or 0 if a value has no fixed size.
+        virtual s32                 binarySize( void ) const NIMBLE_ABSTRACT;
+
+        //! Writes a property value to a binary stream.
+        virtual void                write( InstanceConst instance, Io::StreamWPtr stream ) const NIMBLE_ABSTRACT;
+
+        //! Reads a property value from a binary stream.
+        virtual void                read( Instance instance, Io::StreamWPtr stream ) const NIMBLE_ABSTRACT;
+
     private:
 
         const MetaObject*           m_metaObject;   //!< The property value meta-object.
@@ -94,6 +108,53 @@ namespace Reflection {
 
     namespace Private {
 
+        //! Writes and reads values with a fixed binary representation, values of other types are serialized through a Variant.
+        template<typename TValue>
+        struct BinaryValue {
+            enum { IsSupported = false, Size = 0 };
+
+            static void write( Io::StreamWPtr stream, const TValue& value ) { NIMBLE_NOT_IMPLEMENTED; }
+            static void read( Io::StreamWPtr stream, TValue& value ) { NIMBLE_NOT_IMPLEMENTED; }
+        };
+
+        //! Plain data values are written to a stream as is.
+        template<typename TValue>
+        struct PlainBinaryValue {
+            enum { IsSupported = true, Size = sizeof( TValue ) };
+
+            static void write( Io::StreamWPtr stream, const TValue& value ) { stream->write( &value, sizeof( TValue ) ); }
+            static void read( Io::StreamWPtr stream, TValue& value ) { stream->read( &value, sizeof( TValue ) ); }
+        };
+
+        //! Strings are written as a length-prefixed sequence of characters.
+        template<>
+        struct BinaryValue<String> {
+            enum { IsSupported = true, Size = 0 };
+
+            static void write( Io::StreamWPtr stream, const String& value ) { stream->writeString( value.c_str() ); }
+            static void read( Io::StreamWPtr stream, String& value ) { stream->readString( value ); }
+        };
+
+    #define PLAIN_BINARY_VALUE( type ) template<> struct BinaryValue<type> : public PlainBinaryValue<type> {};
+        PLAIN_BINARY_VALUE( bool )
+        PLAIN_BINARY_VALUE( u8 )
+        PLAIN_BINARY_VALUE( s8 )
+        PLAIN_BINARY_VALUE( u16 )
+        PLAIN_BINARY_VALUE( s16 )
+        PLAIN_BINARY_VALUE( u32 )
+        PLAIN_BINARY_VALUE( s32 )
+        PLAIN_BINARY_VALUE( u64 )
+        PLAIN_BINARY_VALUE( s64 )
+        PLAIN_BINARY_VALUE( f32 )
+        PLAIN_BINARY_VALUE( f64 )
+        PLAIN_BINARY_VALUE( Vec2 )
+        PLAIN_BINARY_VALUE( Vec3 )
+        PLAIN_BINARY_VALUE( Vec4 )
+        PLAIN_BINARY_VALUE( Quat )
+        PLAIN_BINARY_VALUE( Rgb )
+        PLAIN_BINARY_VALUE( Rgba )
+    #undef PLAIN_BINARY_VALUE
+
         //! Generic value property bound to a specified type.
         template<typename TObject, typename TValue, typename TPropertyValue>
         class GenericProperty : public Property {
@@ -129,6 +190,18 @@ namespace Reflection {
             //! Encodes property value to Variant.
             virtual Variant             serialize( InstanceConst instance ) const NIMBLE_OVERRIDE;
 
+            //! Returns true if a property value type has a fixed binary representation.
+            virtual bool                isBinary( void ) const NIMBLE_OVERRIDE;
+
+            //! Returns the size of a plain data value.
+            virtual s32                 binarySize( void ) const NIMBLE_OVERRIDE;
+
+            //! Writes a property value to a binary stream.
+            virtual void                write( InstanceConst instance, Io::StreamWPtr stream ) const NIMBLE_OVERRIDE;
+
+            //! Reads a property value from a binary stream.
+            virtual void                read( Instance instance, Io::StreamWPtr stream ) const NIMBLE_OVERRIDE;
+
         private:
 
             Getter                      m_getter;       //!< The property getter.
@@ -212,6 +285,37 @@ namespace Reflection {
             return result;
         }
 
+        // ** GenericProperty::isBinary
+        template<typename TObject, typename TValue, typename TPropertyValue>
+        bool GenericProperty<TObject, TValue, TPropertyValue>::isBinary( void ) const
+        {
+            return BinaryValue<TValue>::IsSupported;
+        }
+
+        // ** GenericProperty::binarySize
+        template<typename TObject, typename TValue, typename TPropertyValue>
+        s32 GenericProperty<TObject, TValue, TPropertyValue>::binarySize( void ) const
+        {
+            return BinaryValue<TValue>::Size;
+        }
+
+        // ** GenericProperty::write
+        template<typename TObject, typename TValue, typename TPropertyValue>
+        void GenericProperty<TObject, TValue, TPropertyValue>::write( InstanceConst instance, Io::StreamWPtr stream ) const
+        {
+            TPropertyValue v = (instance.pointer<TObject>()->*m_getter)();
+            BinaryValue<TValue>::write( stream, v );
+        }
+
+        // ** GenericProperty::read
+        template<typename TObject, typename TValue, typename TPropertyValue>
+        void GenericProperty<TObject, TValue, TPropertyValue>::read( Instance instance, Io::StreamWPtr stream ) const
+        {
+            TValue v;
+            BinaryValue<TValue>::read( stream, v );
+            (instance.pointer<TObject>()->*m_setter)( v );
+        }
+
     } // namespace Private
 
 } // namespace Reflection
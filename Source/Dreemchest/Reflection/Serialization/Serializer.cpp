@@ -31,10 +31,19 @@
 #include "../MetaObject/Property.h"
 #include "../MetaObject/Instance.h"
 
+#include "../../Io/KeyValue.h"
+#include "../../Threads/Mutex.h"
+
 DC_BEGIN_DREEMCHEST
 
 namespace Reflection {
 
+// ** Serializer::Serializer
+Serializer::Serializer( void )
+{
+    m_plansMutex = Threads::Mutex::create();
+}
+
 // ** Serializer::serialize
 bool Serializer::serialize( InstanceConst instance, KeyValue& ar ) const
 {
@@ -47,33 +56,38 @@ bool Serializer::serialize( InstanceConst instance, KeyValue& ar ) const
     ar.setValueAtKey( "class", Variant::fromValue( cls->name() ) );
 
     // Write instance properties
-    for( s32 i = 0, n = cls->memberCount(); i < n; i++ ) {
-        // Get the class member at current index
-        const Member* member = cls->member( i );
+    const Plan& plan = planFor( instance );
 
-        // Is it a property?
-        const Property* property = member->isProperty();
+    for( s32 i = 0, n = static_cast<s32>( plan.size() ); i < n; i++ ) {
+        const Step& step = plan[i];
+        ar.setValueAtKey( step.property->name(), serializeProperty( *cls, step, instance ) );
+    }
 
-        // No it's not - just skip
-        if( !property ) {
-            continue;
-        }
+    return true;
+}
 
-        // Is this property iterable?
-        ConstIteratorUPtr iterator = property->iterator( instance );
+// ** Serializer::serialize
+bool Serializer::serialize( InstanceConst instance, Io::StreamWPtr stream ) const
+{
+    NIMBLE_ABORT_IF( !instance, "invalid asset instance" );
+    NIMBLE_ABORT_IF( !stream.valid(), "invalid stream" );
 
-        if( iterator.get() ) {
-            if( const Reflection::ListIterator* list = iterator->isList() ) {
-                serializeList( *cls, *property, instance, *list, ar );
-            }
-            else if( const Reflection::MapIterator* map = iterator->isMap() ) {
-                serializeMap( *cls, *property, instance, *map, ar );
-            }
-            else {
-                NIMBLE_NOT_IMPLEMENTED;
-            }
+    // Get the meta-class
+    const Class* cls = instance.type();
+
+    // Values that have no binary representation are written as variants
+    Io::BinaryVariantStream variants( stream.get() );
+
+    // Write instance properties
+    const Plan& plan = planFor( instance );
+
+    for( s32 i = 0, n = static_cast<s32>( plan.size() ); i < n; i++ ) {
+        const Step& step = plan[i];
+
+        if( step.isBinary ) {
+            step.property->write( instance, stream );
         } else {
-            serializeValue( *cls, *property, instance, ar );
+            variants.write( serializeProperty( *cls, step, instance ) );
         }
     }
 
@@ -118,48 +132,159 @@ void Serializer::deserialize( const Instance& instance, const KeyValue& ar ) con
     const Class* cls = instance.type();
 
     // Now read instance properties
-    for( s32 i = 0, n = cls->memberCount(); i < n; i++ ) {
-        // Get the class member at current index
-        const Member* member = cls->member( i );
+    const Plan& plan = planFor( instance );
 
-        // Is it a property?
-        const Property* property = member->isProperty();
+    for( s32 i = 0, n = static_cast<s32>( plan.size() ); i < n; i++ ) {
+        const Step& step = plan[i];
 
-        // No it's not - just skip
-        if( !property ) {
+        // First try to lookup value inside an archive
+        const Variant* value = &ar.valueAtKey( step.property->name() );
+
+        // No value inside an archive - try a default one
+        Variant defaultValue;
+
+        if( !value->isValid() && step.defaultValue ) {
+            defaultValue = step.defaultValue( ar );
+            value        = &defaultValue;
+        }
+
+        // Value is invalid - just skip
+        if( !value->isValid() ) {
+            LogDebug( "serializer", "%s.%s does not exist inside a key-value storage\n", cls->name(), step.property->name() );
             continue;
         }
 
-        // Read a property value
-        Variant value = readPropertyValue( cls, property, ar );
+        deserializeProperty( *cls, step, instance, *value );
+    }
+}
 
-        // Value is invalid - just skip
-        if( !value.isValid() ) {
-            LogDebug( "serializer", "%s.%s does not exist inside a key-value storage\n", cls->name(), member->name() );
+// ** Serializer::deserialize
+void Serializer::deserialize( const Instance& instance, Io::StreamWPtr stream ) const
+{
+    NIMBLE_ABORT_IF( !stream.valid(), "invalid stream" );
+
+    // Get the meta-class from instance
+    const Class* cls = instance.type();
+
+    // Values that have no binary representation are read as variants
+    Io::BinaryVariantStream variants( stream.get() );
+
+    // Now read instance properties in the same order they were written
+    const Plan& plan = planFor( instance );
+
+    for( s32 i = 0, n = static_cast<s32>( plan.size() ); i < n; i++ ) {
+        const Step& step = plan[i];
+
+        if( step.isBinary ) {
+            step.property->read( instance, stream );
+            continue;
+        }
+
+        Variant value;
+        variants.read( value );
+
+        if( value.isValid() ) {
+            deserializeProperty( *cls, step, instance, value );
+        }
+    }
+}
+
+// ** Serializer::planFor
+const Serializer::Plan& Serializer::planFor( const InstanceConst& instance ) const
+{
+    // Get the meta-class
+    const Class* cls = instance.type();
+
+    // Plans are built by the first thread that requests them and are read-only after that
+    DC_SCOPED_LOCK( m_plansMutex );
+
+    // Plan was already built for this class
+    Plans::const_iterator existing = m_plans.find( cls );
+
+    if( existing != m_plans.end() ) {
+        return existing->second;
+    }
+
+    Plan& plan = m_plans[cls];
+
+    for( s32 i = 0, n = cls->memberCount(); i < n; i++ ) {
+        // Is it a property?
+        const Property* property = cls->member( i )->isProperty();
+
+        // No it's not - just skip
+        if( !property ) {
             continue;
         }
 
+        Step step;
+        step.property  = property;
+        step.valueType = property->type();
+
         // Is this property iterable?
-        IteratorUPtr iterator = property->iterator( instance );
+        ConstIteratorUPtr iterator = property->iterator( instance );
 
         if( iterator.get() ) {
-            if( Reflection::ListIterator* list = iterator->isList() ) {
-                deserializeList( *cls, *property, instance, value, *list );
+            if( iterator->isList() ) {
+                step.kind = Step::List;
             }
-            else if( Reflection::MapIterator* map = iterator->isMap() ) {
-                deserializeMap( *cls, *property, instance, value, *map );
+            else if( iterator->isMap() ) {
+                step.kind = Step::Map;
             }
             else {
                 NIMBLE_NOT_IMPLEMENTED;
             }
-        } else {
-            deserializeValue( *cls, *property, instance, value );
+
+            step.valueType = iterator->valueType();
+        }
+
+        // Resolve a property default value
+        PropertyDefaults::const_iterator j = m_defaults.find( calculatePropertyReaderHash( cls, property->name() ) );
+
+        if( j != m_defaults.end() ) {
+            step.defaultValue = j->second;
         }
+
+        // Resolve type converters, so that serialization does not modify a plan
+        step.writeConverter    = findTypeConverter( step.valueType, Type::fromClass<Variant>() );
+        step.hasReadConverters = hasTypeConverters( step.valueType );
+
+        // Plain values are written to binary streams as is, unless a custom converter is registered for them
+        step.isBinary = step.kind == Step::Value && property->isBinary() && !step.writeConverter;
+
+        plan.push_back( step );
+    }
+
+    return plan;
+}
+
+// ** Serializer::invalidatePlans
+void Serializer::invalidatePlans( void )
+{
+    DC_SCOPED_LOCK( m_plansMutex );
+    m_plans.clear();
+}
+
+// ** Serializer::deserializeProperty
+void Serializer::deserializeProperty( const Class& cls, const Step& step, const Instance& instance, const Variant& value ) const
+{
+    switch( step.kind ) {
+    case Step::List:    {
+                            IteratorUPtr iterator = step.property->iterator( instance );
+                            deserializeList( cls, step, value, *iterator->isList() );
+                        }
+                        break;
+    case Step::Map:     {
+                            IteratorUPtr iterator = step.property->iterator( instance );
+                            deserializeMap( cls, step, value, *iterator->isMap() );
+                        }
+                        break;
+    case Step::Value:   deserializeValue( cls, step, instance, value );
+                        break;
     }
 }
 
 // ** Serializer::deserializeList
-void Serializer::deserializeList( const Class& cls, const Property& property, const Instance& instance, const Variant& value, Reflection::ListIterator& iterator ) const
+void Serializer::deserializeList( const Class& cls, const Step& step, const Variant& value, Reflection::ListIterator& iterator ) const
 {
     // Get an array value from a variant
     VariantArray array = value.as<VariantArray>();
@@ -173,20 +298,20 @@ void Serializer::deserializeList( const Class& cls, const Property& property, co
         const Variant& item = items[i];
 
         if( !item.isValid() ) {
-            LogWarning( "serializer", "array property '%s' has an invalid value at %d\n", property.name(), i );
+            LogWarning( "serializer", "array property '%s' has an invalid value at %d\n", step.property->name(), i );
             continue;
         }
 
         // Do we have to convert a value before sending it to a property?
-        TypeConverter converter = findTypeConverter( item.type(), iterator.valueType() );
+        const TypeConverter& converter = resolveReadConverter( step, item.type() );
 
         // Perform a conversion and set a property
-        iterator.insertAfter( converter ? converter( cls, property, item ) : item );   
+        iterator.insertAfter( converter ? converter( cls, *step.property, item ) : item );   
     }
 }
 
 // ** Serializer::deserializeMap
-void Serializer::deserializeMap( const Class& cls, const Property& property, const Instance& instance, const Variant& value, Reflection::MapIterator& iterator ) const
+void Serializer::deserializeMap( const Class& cls, const Step& step, const Variant& value, Reflection::MapIterator& iterator ) const
 {
     // Get a key-value from a variant
     KeyValue kv = value.as<KeyValue>();
@@ -200,29 +325,47 @@ void Serializer::deserializeMap( const Class& cls, const Property& property, con
         const Variant& item = i->second;
 
         // Do we have to convert a value before sending it to a property?
-        TypeConverter converter = findTypeConverter( item.type(), iterator.valueType() );
+        const TypeConverter& converter = resolveReadConverter( step, item.type() );
 
         // Perform a conversion and set a property
-        iterator.insert( Variant::fromValue( i->first ), converter ? converter( cls, property, item ) : item );   
+        iterator.insert( Variant::fromValue( i->first ), converter ? converter( cls, *step.property, item ) : item );   
     }
 }
 
 // ** Serializer::deserializeValue
-void Serializer::deserializeValue( const Class& cls, const Property& property, const Instance& instance, const Variant& value ) const
+void Serializer::deserializeValue( const Class& cls, const Step& step, const Instance& instance, const Variant& value ) const
 {
     // Do we have to convert a value before sending it to a property?
-    TypeConverter converter = findTypeConverter( value.type(), property.type() );
+    const TypeConverter& converter = resolveReadConverter( step, value.type() );
 
     // Perform a conversion and set a property
     if( converter ) {
-        property.deserialize( instance, converter( cls, property, value ) );
+        step.property->deserialize( instance, converter( cls, *step.property, value ) );
     } else {
-        property.deserialize( instance, value );
+        step.property->deserialize( instance, value );
     }
 }
 
+// ** Serializer::serializeProperty
+Variant Serializer::serializeProperty( const Class& cls, const Step& step, const InstanceConst& instance ) const
+{
+    switch( step.kind ) {
+    case Step::List:    {
+                            ConstIteratorUPtr iterator = step.property->iterator( instance );
+                            return serializeList( cls, step, *iterator->isList() );
+                        }
+    case Step::Map:     {
+                            ConstIteratorUPtr iterator = step.property->iterator( instance );
+                            return serializeMap( cls, step, *iterator->isMap() );
+                        }
+    case Step::Value:   break;
+    }
+
+    return serializeValue( cls, step, instance );
+}
+
 // ** Serializer::serializeList
-void Serializer::serializeList( const Class& cls, const Property& property, const InstanceConst& instance, const Reflection::ListIterator& iterator, KeyValue& ar ) const
+Variant Serializer::serializeList( const Class& cls, const Step& step, const Reflection::ListIterator& iterator ) const
 {
     // Create an empty variant array
     VariantArray array;
@@ -233,18 +376,17 @@ void Serializer::serializeList( const Class& cls, const Property& property, cons
         Variant item = iterator.value();
 
         // Do we have to convert a value before writing it to a key-value archive?
-        TypeConverter converter = findTypeConverter( item.type(), Type::fromClass<Variant>() );
+        const TypeConverter& converter = resolveWriteConverter( step, item.type() );
 
         // Append an item to an array
-        array << (converter ? converter( cls, property, item ) : item);
+        array << (converter ? converter( cls, *step.property, item ) : item);
     }
 
-    // Append a cunstructed array to a key-value storage
-    ar.setValueAtKey( property.name(), Variant::fromValue( array ) );
+    return Variant::fromValue( array );
 }
 
 // ** Serializer::serializeMap
-void Serializer::serializeMap( const Class& cls, const Property& property, const InstanceConst& instance, const Reflection::MapIterator& iterator, KeyValue& ar ) const
+Variant Serializer::serializeMap( const Class& cls, const Step& step, const Reflection::MapIterator& iterator ) const
 {
     // Create an empty key-value
     KeyValue kv;
@@ -258,56 +400,52 @@ void Serializer::serializeMap( const Class& cls, const Property& property, const
         Variant key = iterator.key();
 
         // Do we have to convert a value before writing it to a key-value archive?
-        TypeConverter converter = findTypeConverter( value.type(), Type::fromClass<Variant>() );
+        const TypeConverter& converter = resolveWriteConverter( step, value.type() );
 
         // Append an item to an array
-        kv.setValueAtKey( key.as<String>(), (converter ? converter( cls, property, value ) : value) );
+        kv.setValueAtKey( key.as<String>(), (converter ? converter( cls, *step.property, value ) : value) );
     }
 
-    // Append a cunstructed array to a key-value storage
-    ar.setValueAtKey( property.name(), Variant::fromValue( kv ) );
+    return Variant::fromValue( kv );
 }
 
 // ** Serializer::serializeValue
-void Serializer::serializeValue( const Class& cls, const Property& property, const InstanceConst& instance, KeyValue& ar ) const
+Variant Serializer::serializeValue( const Class& cls, const Step& step, const InstanceConst& instance ) const
 {
     // Serialize property to a Variant
-    Variant value = property.serialize( instance );
+    Variant value = step.property->serialize( instance );
 
     // Do we have to convert a value before writing it to a key-value archive?
-    TypeConverter converter = findTypeConverter( value.type(), Type::fromClass<Variant>() );
+    const TypeConverter& converter = resolveWriteConverter( step, value.type() );
 
     // Perform a conversion
     if( converter ) {
-        value = converter( cls, property, value );
+        value = converter( cls, *step.property, value );
     }
 
-    // Now set a key inside a key-value archive
-    ar.setValueAtKey( property.name(), value );
+    return value;
 }
 
-// ** Serializer::readPropertyValue
-Variant Serializer::readPropertyValue( const Class* cls, const Property* property, const KeyValue& ar ) const
+// ** Serializer::resolveWriteConverter
+const Serializer::TypeConverter& Serializer::resolveWriteConverter( const Step& step, const Type* type ) const
 {
-    NIMBLE_ABORT_IF( cls == NULL, "invalid class" );
-    NIMBLE_ABORT_IF( property == NULL, "invalid property" );
-
-    // First try to lookup value inside an archive
-    const Variant& v = ar.valueAtKey( property->name() );
-
-    if( v.isValid() ) {
-        return v;
+    if( type == step.valueType ) {
+        return step.writeConverter;
     }
 
-    // No value inside an archive - try a default one
-    PropertyDefaults::const_iterator i = m_defaults.find( calculatePropertyReaderHash( cls, property->name() ) );
+    return findTypeConverter( type, Type::fromClass<Variant>() );
+}
 
-    if( i != m_defaults.end() ) {
-        return i->second( ar );
+// ** Serializer::resolveReadConverter
+const Serializer::TypeConverter& Serializer::resolveReadConverter( const Step& step, const Type* from ) const
+{
+    // Most properties have no converters at all, so a lookup is skipped for them
+    if( !step.hasReadConverters ) {
+        static const TypeConverter kNoConverter;
+        return kNoConverter;
     }
 
-    // Return a void value
-    return Variant();
+    return findTypeConverter( from, step.valueType );
 }
 
 // ** Serializer::calculatePropertyReaderHash
@@ -323,8 +461,10 @@ u64 Serializer::calculateTypeConverterHash( const Type* from, const Type* to ) c
 }
 
 // ** Serializer::findTypeConverter
-Serializer::TypeConverter Serializer::findTypeConverter( const Type* from, const Type* to ) const
+const Serializer::TypeConverter& Serializer::findTypeConverter( const Type* from, const Type* to ) const
 {
+    static const TypeConverter kNoConverter;
+
     // Calculate a hash value
     u64 hash = calculateTypeConverterHash( from, to );
 
@@ -332,7 +472,19 @@ Serializer::TypeConverter Serializer::findTypeConverter( const Type* from, const
     TypeConverters::const_iterator i = m_typeConverters.find( hash );
 
     // Return a type converter
-    return i != m_typeConverters.end() ? i->second : TypeConverter();
+    return i != m_typeConverters.end() ? i->second : kNoConverter;
+}
+
+// ** Serializer::hasTypeConverters
+bool Serializer::hasTypeConverters( const Type* to ) const
+{
+    for( TypeConverters::const_iterator i = m_typeConverters.begin(), end = m_typeConverters.end(); i != end; ++i ) {
+        if( static_cast<u32>( i->first ) == static_cast<u32>( to->id() ) ) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 } // namespace Reflection
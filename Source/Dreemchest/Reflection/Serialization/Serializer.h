@@ -28,12 +28,20 @@
 #define __DC_Reflection_Serializer_H__
 
 #include "../Reflection.h"
+#include "../../Threads/Threads.h"
 
 DC_BEGIN_DREEMCHEST
 
 namespace Reflection {
 
-    //! Uses embedded meta-object instance to serialize object properties to a key-value storage.
+    //! Uses embedded meta-object instance to serialize object properties to a key-value storage or a binary stream.
+    /*!
+     Class members are inspected once for each class and are stored as a flat serialization plan along with
+     resolved property defaults and type converters, so serializing an instance is a single pass over a plan.
+
+     Plans are never modified once built, so a single serializer can be used from several threads. Converters
+     and defaults should be registered before a serializer is shared.
+     */
     class Serializer {
     public:
 
@@ -43,6 +51,9 @@ namespace Reflection {
         //! Function type used by property default value accessor.
         typedef cClosure<Variant(const KeyValue&)> PropertyDefault;
 
+                                //! Constructs a Serializer instance.
+                                Serializer( void );
+
         virtual                 ~Serializer( void ) {}
 
         //! Writes an object instance to a key-value storage.
@@ -54,6 +65,12 @@ namespace Reflection {
         //! Reads instance properties from a key-value storage.
         void                    deserialize( const Instance& instance, const KeyValue& ar ) const;
 
+        //! Writes instance properties to a binary stream, values of plain data properties bypass a Variant conversion.
+        bool                    serialize( InstanceConst instance, Io::StreamWPtr stream ) const;
+
+        //! Reads instance properties from a binary stream written for the same class.
+        void                    deserialize( const Instance& instance, Io::StreamWPtr stream ) const;
+
         //! Registers a type converter.
         template<typename TFrom, typename TTo>
         void                    registerTypeConverter( const TypeConverter& callback );
@@ -64,14 +81,50 @@ namespace Reflection {
 
     protected:
 
+        //! A single property serialization step.
+        struct Step {
+            //! Property value kind.
+            enum Kind {
+                  Value     //!< A single value.
+                , List      //!< A list of values.
+                , Map       //!< A map of values.
+            };
+
+                                Step( void )
+                                    : property( NULL ), kind( Value ), isBinary( false ), valueType( NULL ), hasReadConverters( false ) {}
+
+            const Property*     property;           //!< Serialized property.
+            Kind                kind;               //!< Property value kind.
+            bool                isBinary;           //!< Indicates that a value is written to a binary stream as is.
+            PropertyDefault     defaultValue;       //!< Property default value accessor.
+            const Type*         valueType;          //!< A type of a property value or of collection elements.
+            TypeConverter       writeConverter;     //!< Converts a value of a step value type before writing it.
+            bool                hasReadConverters;  //!< Indicates that values read from an archive may be converted to a step value type.
+        };
+
+        //! A flat list of serialization steps for all class properties.
+        typedef Array<Step>     Plan;
+
+        //! Returns a serialization plan for an instance class, a plan is built on a first request.
+        const Plan&             planFor( const InstanceConst& instance ) const;
+
+        //! Drops all serialization plans, so they are rebuilt with updated converters and defaults.
+        void                    invalidatePlans( void );
+
         //! Reads instance properties from a key-value storage.
         Instance                createAndDeserialize( AssemblyWPtr assembly, const String& name, const KeyValue& ar ) const;
 
-        //! Reads a property value from an archive.
-        Variant                    readPropertyValue( const Class* cls, const Property* property, const KeyValue& ar ) const;
+        //! Returns a converter for a value being written, a converter resolved by a plan is used for values of a step value type.
+        const TypeConverter&    resolveWriteConverter( const Step& step, const Type* type ) const;
+
+        //! Returns a converter for a value being read, a lookup is skipped if there are no converters to a step value type.
+        const TypeConverter&    resolveReadConverter( const Step& step, const Type* from ) const;
 
         //! Returns a value converter.
-        TypeConverter           findTypeConverter( const Type* from, const Type* to ) const;
+        const TypeConverter&    findTypeConverter( const Type* from, const Type* to ) const;
+
+        //! Returns true if there is at least one converter to a specified type.
+        bool                    hasTypeConverters( const Type* to ) const;
 
         //! Calculates a property reader hash value.
         String64                calculatePropertyReaderHash( const Class* cls, CString name ) const;
@@ -79,23 +132,29 @@ namespace Reflection {
         //! Calculates a type converter hash.
         u64                     calculateTypeConverterHash( const Type* from, const Type* to ) const;
 
+        //! Deserializes a property value.
+        void                    deserializeProperty( const Class& cls, const Step& step, const Instance& instance, const Variant& value ) const;
+
         //! Deserializes a list property value.
-        void                    deserializeList( const Class& cls, const Property& property, const Instance& instance, const Variant& value, Reflection::ListIterator& iterator ) const;
+        void                    deserializeList( const Class& cls, const Step& step, const Variant& value, Reflection::ListIterator& iterator ) const;
 
         //! Deserializes a map property value.
-        void                    deserializeMap( const Class& cls, const Property& property, const Instance& instance, const Variant& value, Reflection::MapIterator& iterator ) const;
+        void                    deserializeMap( const Class& cls, const Step& step, const Variant& value, Reflection::MapIterator& iterator ) const;
 
         //! Deserializes a primitive value.
-        void                    deserializeValue( const Class& cls, const Property& property, const Instance& instance, const Variant& value ) const;
+        void                    deserializeValue( const Class& cls, const Step& step, const Instance& instance, const Variant& value ) const;
+
+        //! Serializes a property value.
+        Variant                 serializeProperty( const Class& cls, const Step& step, const InstanceConst& instance ) const;
 
         //! Serializes a list property value.
-        void                    serializeList( const Class& cls, const Property& property, const InstanceConst& instance, const Reflection::ListIterator& iterator, KeyValue& ar ) const;
+        Variant                 serializeList( const Class& cls, const Step& step, const Reflection::ListIterator& iterator ) const;
 
         //! Serializes a map property value.
-        void                    serializeMap( const Class& cls, const Property& property, const InstanceConst& instance, const Reflection::MapIterator& iterator, KeyValue& ar ) const;
+        Variant                 serializeMap( const Class& cls, const Step& step, const Reflection::MapIterator& iterator ) const;
 
         //! Serializes a primitive value.
-        void                    serializeValue( const Class& cls, const Property& property, const InstanceConst& instance, KeyValue& ar ) const;
+        Variant                 serializeValue( const Class& cls, const Step& step, const InstanceConst& instance ) const;
 
     private:
 
@@ -105,8 +164,13 @@ namespace Reflection {
         //! Container type to store property serializers/deserializers.
         typedef HashMap<String64, PropertyDefault> PropertyDefaults;
 
+        //! Container type to store serialization plans.
+        typedef HashMap<const Class*, Plan> Plans;
+
         TypeConverters            m_typeConverters;        //!< Custom type converters.
         PropertyDefaults        m_defaults;                //!< Property default value callbacks.
+        mutable Plans           m_plans;                //!< Serialization plans built for each class.
+        Threads::MutexPtr       m_plansMutex;           //!< Guards plans that are built on a first request.
     };
 
     // ** Serializer::registerTypeConverter
@@ -115,6 +179,7 @@ namespace Reflection {
     {
         u64 hash = calculateTypeConverterHash( Type::fromClass<TFrom>(), Type::fromClass<TTo>() );
         m_typeConverters[hash] = callback;
+        invalidatePlans();
     }
 
     // ** Serializer::registerPropertyDefault
@@ -123,6 +188,7 @@ namespace Reflection {
     {
         String64 hash = calculatePropertyReaderHash( TType::staticMetaObject(), name.c_str() );
         m_defaults[hash] = callback;
+        invalidatePlans();
     }
 
 } // namespace Reflection
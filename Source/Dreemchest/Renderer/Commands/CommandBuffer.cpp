@@ -64,6 +64,7 @@ void CommandBuffer::uploadConstantBuffer(ConstantBuffer_ id, const void* data, s
     OpCode opCode;
     opCode.type = OpCode::UploadConstantBuffer;
     opCode.upload.id = id;
+    opCode.upload.offset = 0;
     opCode.upload.buffer = adoptDataBuffer(data, size);
     push( opCode );
 }
@@ -74,27 +75,30 @@ void CommandBuffer::uploadConstantBuffer(ConstantBuffer_ id, const PersistentPoi
     OpCode opCode;
     opCode.type = OpCode::UploadConstantBuffer;
     opCode.upload.id = id;
+    opCode.upload.offset = 0;
     opCode.upload.buffer.data = reinterpret_cast<const u8*>(data.value);
     opCode.upload.buffer.size = size;
     push( opCode );
 }
 
 // ** CommandBuffer::uploadVertexBuffer
-void CommandBuffer::uploadVertexBuffer(VertexBuffer_ id, const void* data, s32 size)
+void CommandBuffer::uploadVertexBuffer(VertexBuffer_ id, const void* data, s32 size, s32 offset)
 {
     OpCode opCode;
     opCode.type = OpCode::UploadVertexBuffer;
     opCode.upload.id = id;
+    opCode.upload.offset = offset;
     opCode.upload.buffer = adoptDataBuffer(data, size);
     push( opCode );
 }
 
 // ** CommandBuffer::uploadVertexBuffer
-void CommandBuffer::uploadVertexBuffer(VertexBuffer_ id, const PersistentPointer& data, s32 size)
+void CommandBuffer::uploadVertexBuffer(VertexBuffer_ id, const PersistentPointer& data, s32 size, s32 offset)
 {
     OpCode opCode;
     opCode.type = OpCode::UploadVertexBuffer;
     opCode.upload.id = id;
+    opCode.upload.offset = offset;
     opCode.upload.buffer.data = reinterpret_cast<const u8*>(data.value);
     opCode.upload.buffer.size = size;
     push( opCode );
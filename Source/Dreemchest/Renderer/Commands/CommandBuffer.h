@@ -57,11 +57,11 @@ namespace Renderer
         //! Emits a constant buffer upload command.
         void                        uploadConstantBuffer(ConstantBuffer_ id, const PersistentPointer& data, s32 size);
         
-        //! Emits a vertex buffer upload command.
-        void                        uploadVertexBuffer(VertexBuffer_ id, const void* data, s32 size);
+        //! Emits a vertex buffer upload command, the data is written starting from a specified byte offset.
+        void                        uploadVertexBuffer(VertexBuffer_ id, const void* data, s32 size, s32 offset = 0);
 
-        //! Emits a vertex buffer upload command.
-        void                        uploadVertexBuffer(VertexBuffer_ id, const PersistentPointer& data, s32 size);
+        //! Emits a vertex buffer upload command, the data is written starting from a specified byte offset.
+        void                        uploadVertexBuffer(VertexBuffer_ id, const PersistentPointer& data, s32 size, s32 offset = 0);
 
     protected:
 
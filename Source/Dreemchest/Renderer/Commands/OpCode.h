@@ -86,6 +86,7 @@ namespace Renderer
                 PrimitiveType               primitives;                 //!< A primitive type to be rendered.
                 s32                         first;                      //!< First index or primitive.
                 s32                         count;                      //!< A total number of indices or primitives to use.
+                s32                         baseVertex;                 //!< A value added to each index before fetching a vertex.
                 CompiledStateBlock*         stateBlock;                 //!< A compiled state block to be applied before running a command.
             } drawCall;
             
@@ -131,6 +132,7 @@ namespace Renderer
             {
                 ResourceId                  id;                         //!< A target buffer handle.
                 Buffer                      buffer;                     //!< An attached data buffer.
+                s32                         offset;                     //!< A byte offset inside a target buffer.
             } upload;
             
             struct
@@ -182,31 +182,37 @@ void RenderCommandBuffer::releaseTexture(TransientTexture id)
 // ** RenderCommandBuffer::drawIndexed
 void RenderCommandBuffer::drawIndexed(u32 sorting, PrimitiveType primitives, s32 first, s32 count)
 {
-    emitDrawCall(OpCode::DrawIndexed, sorting, primitives, first, count, m_stateStack.states(), m_stateStack.size(), NULL);
+    emitDrawCall(OpCode::DrawIndexed, sorting, primitives, first, count, 0, m_stateStack.states(), m_stateStack.size(), NULL);
 }
 
 // ** RenderCommandBuffer::drawIndexed
 void RenderCommandBuffer::drawIndexed(u32 sorting, PrimitiveType primitives, s32 first, s32 count, const StateBlock& stateBlock)
 {
-    emitDrawCall(OpCode::DrawIndexed, sorting, primitives, first, count, m_stateStack.states(), m_stateStack.size(), &stateBlock);
+    emitDrawCall(OpCode::DrawIndexed, sorting, primitives, first, count, 0, m_stateStack.states(), m_stateStack.size(), &stateBlock);
+}
+
+// ** RenderCommandBuffer::drawIndexed
+void RenderCommandBuffer::drawIndexed(u32 sorting, PrimitiveType primitives, s32 first, s32 count, s32 baseVertex)
+{
+    emitDrawCall(OpCode::DrawIndexed, sorting, primitives, first, count, baseVertex, m_stateStack.states(), m_stateStack.size(), NULL);
 }
 
 // ** RenderCommandBuffer::drawPrimitives
 void RenderCommandBuffer::drawPrimitives(u32 sorting, PrimitiveType primitives, s32 first, s32 count)
 {
-    emitDrawCall(OpCode::DrawPrimitives, sorting, primitives, first, count, m_stateStack.states(), m_stateStack.size(), NULL);
+    emitDrawCall(OpCode::DrawPrimitives, sorting, primitives, first, count, 0, m_stateStack.states(), m_stateStack.size(), NULL);
 }
 
 // ** RenderCommandBuffer::drawPrimitives
 void RenderCommandBuffer::drawPrimitives(u32 sorting, PrimitiveType primitives, s32 first, s32 count, const StateBlock& stateBlock)
 {
-    emitDrawCall(OpCode::DrawPrimitives, sorting, primitives, first, count, m_stateStack.states(), m_stateStack.size(), &stateBlock);
+    emitDrawCall(OpCode::DrawPrimitives, sorting, primitives, first, count, 0, m_stateStack.states(), m_stateStack.size(), &stateBlock);
 }
     
 // ** RenderCommandBuffer::drawItem
 void RenderCommandBuffer::drawItem(u32 sorting, const RenderItem& item)
 {
-    emitDrawCall(item.indexed ? OpCode::DrawIndexed : OpCode::DrawPrimitives, sorting, item.primitives, item.first, item.count, m_stateStack.states(), m_stateStack.size(), &item.states);
+    emitDrawCall(item.indexed ? OpCode::DrawIndexed : OpCode::DrawPrimitives, sorting, item.primitives, item.first, item.count, 0, m_stateStack.states(), m_stateStack.size(), &item.states);
 }
 
 // ** RenderCommandBuffer::drawItem
@@ -216,7 +222,7 @@ void RenderCommandBuffer::drawItem(u32 sorting, const RenderItem& item, const St
 }
 
 // ** RenderCommandBuffer::emitDrawCall
-void RenderCommandBuffer::emitDrawCall(OpCode::Type type, u32 sorting, PrimitiveType primitives, s32 first, s32 count, const StateBlock** stateBlocks, s32 stateBlockCount, const StateBlock* overrideStateBlock)
+void RenderCommandBuffer::emitDrawCall(OpCode::Type type, u32 sorting, PrimitiveType primitives, s32 first, s32 count, s32 baseVertex, const StateBlock** stateBlocks, s32 stateBlockCount, const StateBlock* overrideStateBlock)
 {
     // Compile an array of state blocks
     OpCode::CompiledStateBlock* compiledStateBlock = (OpCode::CompiledStateBlock*)m_frame.allocate(sizeof(OpCode::CompiledStateBlock));
@@ -247,6 +253,7 @@ void RenderCommandBuffer::emitDrawCall(OpCode::Type type, u32 sorting, Primitive
     opCode.drawCall.primitives  = primitives;
     opCode.drawCall.first       = first;
     opCode.drawCall.count       = count;
+    opCode.drawCall.baseVertex  = baseVertex;
     opCode.drawCall.stateBlock  = compiledStateBlock;
     push(opCode);
 }
@@ -84,6 +84,9 @@ namespace Renderer
         //! Emits a draw indexed command with a single render state block.
         void                        drawIndexed(u32 sorting, PrimitiveType primitives, s32 first, s32 count, const StateBlock& stateBlock);
         
+        //! Emits a draw indexed command that adds a base vertex to each index and inherits all rendering states from a state stack.
+        void                        drawIndexed(u32 sorting, PrimitiveType primitives, s32 first, s32 count, s32 baseVertex);
+        
         //! Emits a draw primitives command that inherits all rendering states from a state stack.
         void                        drawPrimitives(u32 sorting, PrimitiveType primitives, s32 first, s32 count);
         
@@ -102,7 +105,7 @@ namespace Renderer
                                     RenderCommandBuffer(RenderFrame& frame);
         
         //! Emits a draw call command.
-        void                        emitDrawCall( OpCode::Type type, u32 sorting, PrimitiveType primitives, s32 first, s32 count, const StateBlock** states, s32 stateCount, const StateBlock* overrideStateBlock);
+        void                        emitDrawCall( OpCode::Type type, u32 sorting, PrimitiveType primitives, s32 first, s32 count, s32 baseVertex, const StateBlock** states, s32 stateCount, const StateBlock* overrideStateBlock);
         
         //! Compiles a state block stack to an array of rendering state.
         s32                         compileStateStack(const StateBlock* const * stateBlocks, s32 count, State* states, s32 maxStates, OpCode::CompiledStateBlock* compiledStateBlock);
@@ -0,0 +1,122 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "NullRenderingContext.h"
+#include "../Commands/CommandBuffer.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Renderer
+{
+
+// ** createNullRenderingContext
+RenderingContextPtr createNullRenderingContext(void)
+{
+    return RenderingContextPtr(DC_NEW NullRenderingContext);
+}
+
+// ** NullRenderingContext::NullRenderingContext
+NullRenderingContext::NullRenderingContext(void)
+    : RenderingContext(RenderViewPtr())
+{
+    m_caps.maxRenderTargets = 8;
+    m_caps.maxTextures      = 8;
+    m_caps.maxCubeMapSize   = 4096;
+    m_caps.maxTextureSize   = 4096;
+}
+
+// ** NullRenderingContext::deprecatedRequestShader
+Program NullRenderingContext::deprecatedRequestShader(const String& fileName)
+{
+    // Render passes can be constructed without shader files next to a working directory
+    return requestProgram(String(), String());
+}
+
+// ** NullRenderingContext::acquireTexture
+ResourceId NullRenderingContext::acquireTexture(u8 type, u16 width, u16 height, u32 options)
+{
+    // First search for a free render target
+    for (List<Texture_>::iterator i = m_transientTextures.begin(), end = m_transientTextures.end(); i != end; ++i)
+    {
+        const TextureInfo& info = textureInfo(*i);
+        
+        if (type == info.type && info.width == width && info.height == height && info.options == options)
+        {
+            Texture_ id = *i;
+            m_transientTextures.erase(i);
+            return id;
+        }
+    }
+    
+    // Allocate a texture identifier without any actual storage
+    Texture_ id = allocateIdentifier<Texture_>();
+    setTextureInfo(id, static_cast<TextureType>(type), width, height, options);
+    return id;
+}
+
+// ** NullRenderingContext::executeCommandBuffer
+void NullRenderingContext::executeCommandBuffer(const CommandBuffer& commands)
+{
+    for (s32 i = 0, n = commands.size(); i < n; i++)
+    {
+        // Get a render operation at specified index
+        const OpCode& opCode = commands.opCodeAt(i);
+        
+        switch(opCode.type)
+        {
+            case OpCode::Execute:
+                execute(*opCode.execute.commands);
+                break;
+                
+            case OpCode::RenderToTexture:
+            case OpCode::RenderToTransientTexture:
+                execute(*opCode.renderToTextures.commands);
+                break;
+                
+            case OpCode::AcquireTexture:
+                loadTransientResource(opCode.transientTexture.id, acquireTexture(opCode.transientTexture.type, opCode.transientTexture.width, opCode.transientTexture.height, opCode.transientTexture.options));
+                break;
+                
+            case OpCode::ReleaseTexture:
+                m_transientTextures.push_back(Texture_::create(transientResource(opCode.transientTexture.id)));
+                unloadTransientResource(opCode.transientTexture.id);
+                break;
+                
+            case OpCode::DrawIndexed:
+            case OpCode::DrawPrimitives:
+                m_counters.drawCalls++;
+                break;
+                
+            default:
+                break;
+        }
+    }
+}
+
+} // namespace Renderer
+
+DC_END_DREEMCHEST
@@ -0,0 +1,64 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Renderer_NullRenderingContext_H__
+#define __DC_Renderer_NullRenderingContext_H__
+
+#include "../RenderingContext.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Renderer
+{
+    //! A rendering context that executes command buffers without a rendering API, used to count draw calls in tests and benchmarks.
+    class NullRenderingContext : public RenderingContext
+    {
+    public:
+                                    //! Constructs a NullRenderingContext instance.
+                                    NullRenderingContext(void);
+        
+        //! Returns a program without reading a shader file, a null context never compiles shaders.
+        virtual Program             deprecatedRequestShader(const String& fileName) NIMBLE_OVERRIDE;
+        
+    protected:
+        
+        //! Executes a specified command buffer.
+        virtual void                executeCommandBuffer(const CommandBuffer& commands) NIMBLE_OVERRIDE;
+        
+        //! Acquires a transient texture.
+        ResourceId                  acquireTexture(u8 type, u16 width, u16 height, u32 options);
+        
+    private:
+        
+        List<Texture_>              m_transientTextures;    //!< Released transient textures that can be reused.
+    };
+    
+} // namespace Renderer
+
+DC_END_DREEMCHEST
+
+#endif  /*  __DC_Renderer_NullRenderingContext_H__    */
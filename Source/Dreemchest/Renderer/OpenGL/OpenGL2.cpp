@@ -916,7 +916,7 @@ void OpenGL2::disableInputLayout(const VertexBufferLayout& layout)
 }
 #else
 // ** OpenGL2::setInputLayout
-void OpenGL2::setInputLayout(const GLint* locations, const VertexBufferLayout& layout)
+void OpenGL2::setInputLayout(const GLint* locations, const VertexBufferLayout& layout, GLbyte* pointer)
 {
     DREEMCHEST_GL_SENTINEL
     
@@ -954,7 +954,7 @@ void OpenGL2::setInputLayout(const GLint* locations, const VertexBufferLayout& l
             const VertexBufferLayout::Element& element = layout[i];
             
             glEnableVertexAttribArray(location);
-            glVertexAttribPointer(location, element.count, s_attributeType[i], i == 2 ? GL_TRUE : GL_FALSE, stride, static_cast<u8*>(NULL) + element.offset);
+            glVertexAttribPointer(location, element.count, s_attributeType[i], i == 2 ? GL_TRUE : GL_FALSE, stride, pointer + element.offset);
         }
     }
 }
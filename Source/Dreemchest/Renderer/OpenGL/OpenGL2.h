@@ -444,8 +444,8 @@ namespace Renderer
         //! Disables a vertex buffer layout.
         static void     disableInputLayout(const VertexBufferLayout& layout);
     #else
-        //! Enables a vertex buffer layout for a set of attribute locations.
-        static void     setInputLayout(const GLint* locations, const VertexBufferLayout& layout);
+        //! Enables a vertex buffer layout for a set of attribute locations, attribute offsets are added to a specified pointer.
+        static void     setInputLayout(const GLint* locations, const VertexBufferLayout& layout, GLbyte* pointer = NULL);
     #endif  //  #if DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
     };
     
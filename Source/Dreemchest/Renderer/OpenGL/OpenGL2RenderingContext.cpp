@@ -125,6 +125,7 @@ OpenGL2RenderingContext::OpenGL2RenderingContext(RenderViewPtr view)
     , m_requestedFeatureLayout(NULL)
     , m_activeInputLayout(NULL)
     , m_activeVertexBuffer(0)
+    , m_activeBaseVertex(0)
 #if DEV_RENDERER_PROGRAM_CACHING
     , m_activePermutation(NULL)
     , m_activeProgram(-1)
@@ -264,7 +265,7 @@ void OpenGL2RenderingContext::executeCommandBuffer(const CommandBuffer& commands
                 break;
                 
             case OpCode::UploadVertexBuffer:
-                OpenGL2::Buffer::subData(GL_ARRAY_BUFFER, m_vertexBuffers[opCode.upload.id], 0, opCode.upload.buffer.size, opCode.upload.buffer.data);
+                OpenGL2::Buffer::subData(GL_ARRAY_BUFFER, m_vertexBuffers[opCode.upload.id], opCode.upload.offset, opCode.upload.buffer.size, opCode.upload.buffer.data);
                 break;
                 
             case OpCode::CreateInputLayout:
@@ -437,15 +438,12 @@ void OpenGL2RenderingContext::executeCommandBuffer(const CommandBuffer& commands
                 // And update all uniforms
                 updateUniforms(permutation);
                 
-            #if !DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
-                if (vertexBufferLayout)
-                {
-                    OpenGL2::setInputLayout(permutation->attributes, *vertexBufferLayout);
-                }
-            #endif  //  #if !DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
+                // Bind vertex attributes starting from a base vertex of this draw call
+                applyInputLayout(permutation, vertexBufferLayout, opCode.drawCall.baseVertex);
                 
-                // Perform an actual draw call
-                OpenGL2::drawElements(opCode.drawCall.primitives, GL_UNSIGNED_SHORT, opCode.drawCall.first, opCode.drawCall.count);
+                // Perform an actual draw call, the first index is converted to a byte offset inside an index buffer
+                OpenGL2::drawElements(opCode.drawCall.primitives, GL_UNSIGNED_SHORT, opCode.drawCall.first * sizeof(u16), opCode.drawCall.count);
+                m_counters.drawCalls++;
                 break;
                 
             case OpCode::DrawPrimitives:
@@ -460,15 +458,12 @@ void OpenGL2RenderingContext::executeCommandBuffer(const CommandBuffer& commands
                 // And update all uniforms
                 updateUniforms(permutation);
                 
-            #if !DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
-                if (vertexBufferLayout)
-                {
-                    OpenGL2::setInputLayout(permutation->attributes, *vertexBufferLayout);
-                }
-            #endif  //  #if !DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
+                // Bind vertex attributes starting from the first vertex
+                applyInputLayout(permutation, vertexBufferLayout, 0);
                 
                 // Perform an actual draw call
                 OpenGL2::drawArrays(opCode.drawCall.primitives, opCode.drawCall.first, opCode.drawCall.count);
+                m_counters.drawCalls++;
                 break;
                 
             default:
@@ -615,6 +610,28 @@ const VertexBufferLayout* OpenGL2RenderingContext::compilePipelineState(const St
     return NULL;
 }
     
+// ** OpenGL2RenderingContext::applyInputLayout
+void OpenGL2RenderingContext::applyInputLayout(const Permutation* permutation, const VertexBufferLayout* changedLayout, s32 baseVertex)
+{
+    // Nothing to do - neither an input layout nor a base vertex has changed
+    if (changedLayout == NULL && baseVertex == m_activeBaseVertex)
+    {
+        return;
+    }
+    
+    NIMBLE_ABORT_IF(m_activeInputLayout == NULL, "no valid input layout set");
+    m_activeBaseVertex = baseVertex;
+    
+    // There is no glDrawElementsBaseVertex in OpenGL 2, so attribute pointers are offset by a base vertex instead
+    GLbyte* pointer = static_cast<GLbyte*>(NULL) + baseVertex * m_activeInputLayout->vertexSize();
+    
+#if DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
+    OpenGL2::enableInputLayout(pointer, *m_activeInputLayout);
+#else
+    OpenGL2::setInputLayout(permutation->attributes, *m_activeInputLayout, pointer);
+#endif  //  #if DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
+}
+    
 // ** OpenGL2RenderingContext::applyProgramPermutation
 const OpenGLRenderingContext::Permutation* OpenGL2RenderingContext::applyProgramPermutation(ResourceId program, const PipelineFeatureLayout* layout, PipelineFeatures features)
 {
@@ -660,7 +677,7 @@ const OpenGLRenderingContext::Permutation* OpenGL2RenderingContext::applyProgram
 #if !DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
     if (m_activeInputLayout)
     {
-        OpenGL2::setInputLayout(permutation->attributes, *m_activeInputLayout);
+        OpenGL2::setInputLayout(permutation->attributes, *m_activeInputLayout, static_cast<GLbyte*>(NULL) + m_activeBaseVertex * m_activeInputLayout->vertexSize());
     }
 #endif  //  #if !DEV_RENDERER_DEPRECATED_INPUT_LAYOUTS
     
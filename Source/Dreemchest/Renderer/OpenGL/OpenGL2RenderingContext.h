@@ -51,6 +51,9 @@ namespace Renderer
         //! Compiles and sets a matching shader permutation.
         const Permutation*          applyProgramPermutation(ResourceId program, const PipelineFeatureLayout* layout, PipelineFeatures features);
         
+        //! Sets vertex attribute pointers of an active input layout offset by a base vertex if a layout or a base vertex has changed.
+        void                        applyInputLayout(const Permutation* permutation, const VertexBufferLayout* changedLayout, s32 baseVertex);
+        
         //! Compiles a shader program permutation.
         const Permutation*          compileShaderPermutation(ResourceId program, PipelineFeatures features, const PipelineFeatureLayout* featureLayout);
         
@@ -104,6 +107,7 @@ namespace Renderer
         const VertexBufferLayout*   m_activeInputLayout;    //!< An active input layout.
         GLuint                      m_activeVertexBuffer;   //!< An active vertex buffer.
     #endif  //  #if DEV_RENDERER_INPUT_LAYOUT_CACHING
+        s32                         m_activeBaseVertex;     //!< A base vertex vertex attribute pointers are offset by.
         
     #if DEV_RENDERER_PROGRAM_CACHING
         const Permutation*          m_activePermutation;    //!< An active program permutation.
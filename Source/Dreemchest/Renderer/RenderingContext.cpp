@@ -397,6 +397,9 @@ void RenderingContext::releaseIdentifier(RenderResourceType::Enum type, Resource
 // ** RenderingContext::requestInputLayout
 InputLayout RenderingContext::requestInputLayout(const VertexFormat& format)
 {
+    // Input layouts are cached by an attribute mask and always describe floating point attributes
+    NIMBLE_ABORT_IF(format.quantization(), "quantized vertex formats should be decoded before rendering");
+
     // First lookup a previously constucted input layout
     InputLayout id = m_inputLayoutCache[format];
     
@@ -487,6 +490,12 @@ IndexBuffer_ RenderingContext::requestIndexBuffer( const void* data, s32 size )
     return m_resourceCommandBuffer->createIndexBuffer(id, data, size);
 }
 
+// ** RenderingContext::uploadVertexBuffer
+void RenderingContext::uploadVertexBuffer( VertexBuffer_ id, const void* data, s32 size, s32 offset )
+{
+    m_resourceCommandBuffer->uploadVertexBuffer(id, data, size, offset);
+}
+
 // ** RenderingContext::requestConstantBuffer
 ConstantBuffer_ RenderingContext::requestConstantBuffer(const void* data, s32 size, UniformLayout layout)
 {
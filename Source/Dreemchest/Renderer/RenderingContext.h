@@ -49,6 +49,7 @@ namespace Renderer
             s32                                 uniformsUploaded;       //!< A total number of uniforms that were uploaded.
             s32                                 permutationsCompiled;   //!< A total number of new program permutations compiled.
             s32                                 stateSwitches;          //!< Recorded number of state changes.
+            s32                                 drawCalls;              //!< A total number of executed draw calls.
         };
         
         //! Rendering context capabilities
@@ -99,6 +100,9 @@ namespace Renderer
         
         //! Queues an index buffer instance for creation and returns it's index.
         IndexBuffer_                            requestIndexBuffer( const void* data, s32 size );
+
+        //! Queues an update of a vertex buffer range, the data is copied so it can be released right after this call.
+        void                                    uploadVertexBuffer( VertexBuffer_ id, const void* data, s32 size, s32 offset = 0 );
         
         //! Queues a constant buffer instance for creation and returns it's index.
         ConstantBuffer_                         requestConstantBuffer(const void* data, s32 size, UniformLayout layout);
@@ -152,7 +156,7 @@ namespace Renderer
         const UniformElement*                   findUniformLayout(const String& name) const;
         
         //! Queues a shader instance creation and returns it's index.
-        Program                                 deprecatedRequestShader(const String& fileName);
+        virtual Program                         deprecatedRequestShader(const String& fileName);
 
     protected:
         
@@ -225,6 +229,9 @@ namespace Renderer
         return allocateIdentifier(static_cast<RenderResourceType::Enum>(TResourceIdentifier::ResourceType));
     }
     
+    //! Creates a rendering context that does not render anything, but still executes command buffers and updates frame counters.
+    RenderingContextPtr createNullRenderingContext(void);
+    
 #ifdef DC_OPENGL_ENABLED
     //! Platform-specific OpenGL view constructor.
     extern RenderViewPtr createOpenGLView(void* window, u32 options);
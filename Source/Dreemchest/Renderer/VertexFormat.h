@@ -57,12 +57,26 @@ namespace Renderer
             , PointSize     = BIT(VertexPointSize)
         };
         
+        //! Available attribute quantization modes.
+        enum Quantization
+        {
+              QuantizedPosition = BIT(0)    //!< Positions are stored as four 16-bit unsigned normalized integers relative to mesh bounds.
+            , OctahedralNormal  = BIT(1)    //!< Normals are stored as two 16-bit signed normalized integers of an octahedral mapping.
+            , HalfTexCoord      = BIT(2)    //!< Texture coordinates are stored as 16-bit floats.
+        };
+        
                                 //! Constructs a VertexFormat instance.
-                                VertexFormat( u8 attributes );
+                                VertexFormat( u8 attributes, u8 quantization = 0 );
         
         //! Converts a VertexFormat to u8 value.
         operator                u8( void ) const;
         
+        //! Returns a bitmask of quantized attributes.
+        u8                      quantization( void ) const;
+        
+        //! Returns true if a specified quantization mode is used.
+        bool                    isQuantized( Quantization value ) const;
+        
         //! Returns true if a specified attribute exists.
         bool                    operator & ( Attribute attribute ) const;
         
@@ -107,11 +121,13 @@ namespace Renderer
     private:
         
         u8                      m_attributes;   //!< Vertex attribute mask.
+        u8                      m_quantization; //!< Quantized attribute mask.
     };
     
     // ** VertexFormat::VertexFormat
-    NIMBLE_INLINE VertexFormat::VertexFormat( u8 attributes )
+    NIMBLE_INLINE VertexFormat::VertexFormat( u8 attributes, u8 quantization )
         : m_attributes( attributes | Position )
+        , m_quantization( quantization )
     {
     }
     
@@ -121,6 +137,18 @@ namespace Renderer
         return m_attributes;
     }
     
+    // ** VertexFormat::quantization
+    NIMBLE_INLINE u8 VertexFormat::quantization( void ) const
+    {
+        return m_quantization;
+    }
+    
+    // ** VertexFormat::isQuantized
+    NIMBLE_INLINE bool VertexFormat::isQuantized( Quantization value ) const
+    {
+        return m_quantization & value ? true : false;
+    }
+    
     // ** VertexFormat::operator &
     NIMBLE_INLINE bool VertexFormat::operator & ( Attribute attribute ) const
     {
@@ -130,7 +158,7 @@ namespace Renderer
     // ** VertexFormat::operator ==
     NIMBLE_INLINE bool VertexFormat::operator == ( const VertexFormat& other ) const
     {
-        return m_attributes == other.m_attributes;
+        return m_attributes == other.m_attributes && m_quantization == other.m_quantization;
     }
     
     // ** VertexFormat::vertexSize
@@ -169,11 +197,11 @@ namespace Renderer
     {
         switch( attribute )
         {
-            case Position:  return sizeof( f32 ) * 3;
-            case Normal:    return sizeof( f32 ) * 3;
+            case Position:  return m_quantization & QuantizedPosition ? sizeof( u16 ) * 4 : sizeof( f32 ) * 3;
+            case Normal:    return m_quantization & OctahedralNormal  ? sizeof( s16 ) * 2 : sizeof( f32 ) * 3;
             case Color:     return sizeof( u8  ) * 4;
-            case TexCoord0: return sizeof( f32 ) * 2;
-            case TexCoord1: return sizeof( f32 ) * 2;
+            case TexCoord0: return m_quantization & HalfTexCoord      ? sizeof( u16 ) * 2 : sizeof( f32 ) * 2;
+            case TexCoord1: return m_quantization & HalfTexCoord      ? sizeof( u16 ) * 2 : sizeof( f32 ) * 2;
             default:        NIMBLE_NOT_IMPLEMENTED
         }
         
@@ -28,6 +28,7 @@
 
 #include "Image.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
 #include "Material.h"
 
 DC_BEGIN_DREEMCHEST
@@ -67,9 +68,18 @@ bool ImageFormatRaw::constructFromStream( Io::StreamPtr stream, Assets::Assets&
 // ** MeshFormatRaw::constructFromStream
 bool MeshFormatRaw::constructFromStream( Io::StreamPtr stream, Assets::Assets& assets, Mesh& asset )
 {
-    // Read the total number of mesh chunks
-    u32 chunkCount;
-    stream->read( &chunkCount, 4 );
+    // Read a file signature, older files start with the total number of mesh chunks
+    u32 signature;
+    stream->read( &signature, 4 );
+
+    u32 version    = 0;
+    u32 chunkCount = signature;
+
+    if( signature == Signature ) {
+        stream->read( &version, 4 );
+        stream->read( &chunkCount, 4 );
+        NIMBLE_BREAK_IF( version > Version );
+    }
 
     // Set the total number of mesh chunks
     asset.setChunkCount( chunkCount );
@@ -77,6 +87,7 @@ bool MeshFormatRaw::constructFromStream( Io::StreamPtr stream, Assets::Assets& a
 
     Mesh::VertexBuffer vertices;
     Mesh::IndexBuffer indices;
+    Array<u8> encoded;
 
     for( u32 i = 0; i < chunkCount; i++ ) {
         // Read chunk texture name
@@ -88,25 +99,38 @@ bool MeshFormatRaw::constructFromStream( Io::StreamPtr stream, Assets::Assets& a
         stream->read( &vertexCount, 4 );
         stream->read( &indexCount, 4 );
 
-        // Read vertex buffer
-        vertices.resize( vertices.size() + vertexCount );
+        // Read a vertex format, older files always store floating point vertices
+        Renderer::VertexFormat format( Renderer::VertexFormat::Normal | Renderer::VertexFormat::TexCoord0 | Renderer::VertexFormat::TexCoord1 );
+        Bounds bounds;
+
+        if( version > 0 ) {
+            u8 attributes, quantization;
+            stream->read( &attributes, 1 );
+            stream->read( &quantization, 1 );
+            format = Renderer::VertexFormat( attributes, quantization );
+
+            if( format.isQuantized( Renderer::VertexFormat::QuantizedPosition ) ) {
+                Vec3 min, max;
+                stream->read( &min.x, sizeof( min ) );
+                stream->read( &max.x, sizeof( max ) );
+                bounds = Bounds( min, max );
+            }
+        }
 
-        for( u32 j = vertices.size() - vertexCount; j < vertexCount; j++ ) {
-            Mesh::Vertex* v = &vertices[j];
+        // Read vertex buffer and decode it to floating point vertices
+        vertices.resize( vertices.size() + vertexCount );
+        encoded.resize( vertexCount * format.vertexSize() );
 
-            stream->read( &v->position.x, sizeof( v->position ) );
-            stream->read( &v->normal.x, sizeof( v->normal ) );
-            stream->read( &v->uv[0].x, sizeof( v->uv[0] ) );
-            stream->read( &v->uv[1].x, sizeof( v->uv[1] ) );
+        if( vertexCount ) {
+            stream->read( &encoded[0], encoded.size() );
+            MeshOptimizer::decodeVertices( &encoded[0], vertexCount, format, bounds, &vertices[vertices.size() - vertexCount] );
         }
 
         // Read index buffer
         indices.resize( indices.size() + indexCount );
 
-        for( u32 j = indices.size() - indexCount; j < indexCount; j++ ) {
-            u16 idx;
-            stream->read( &idx, sizeof(u16) );
-            indices[j] = idx;
+        if( indexCount ) {
+            stream->read( &indices[indices.size() - indexCount], sizeof( u16 ) * indexCount );
         }
 
         // Set chunk texture
@@ -42,7 +42,20 @@ namespace Scene {
     };
 
     //! Loads a mesh from a raw binary format.
+    /*!
+     A file starts with a signature followed by a version and the total number of chunks. Each chunk stores a texture name,
+     vertex and index counts, a vertex format and, if positions are quantized, bounds they are relative to. Older files without
+     a signature start with a chunk count and store floating point vertices.
+     */
     class MeshFormatRaw : public Assets::FileSource<Mesh> {
+    public:
+
+        //! A mesh file signature and a current version.
+        enum {
+              Signature = 0x4853454D    //!< "MESH" characters.
+            , Version   = 1             //!< A current file version.
+        };
+
     protected:
 
         //! Loads mesh data from an input stream.
@@ -47,7 +47,11 @@ s32 Mesh::chunkCount( void ) const
 // ** Mesh::setChunkCount
 void Mesh::setChunkCount( s32 value )
 {
-    m_chunks.resize( value );
+    Chunk chunk;
+    chunk.offset     = 0;
+    chunk.count      = 0;
+    chunk.baseVertex = 0;
+    m_chunks.resize( value, chunk );
 }
 
 // ** Mesh::setTexture
@@ -64,12 +68,48 @@ const String& Mesh::texture( s32 chunk ) const
     return m_chunks[chunk].texture;
 }
 
+// ** Mesh::setChunkIndices
+void Mesh::setChunkIndices( s32 chunk, s32 offset, s32 count, s32 baseVertex )
+{
+    NIMBLE_ABORT_IF( chunk < 0 || chunk >= chunkCount(), "index is out of range" );
+    m_chunks[chunk].offset     = offset;
+    m_chunks[chunk].count      = count;
+    m_chunks[chunk].baseVertex = baseVertex;
+}
+
+// ** Mesh::chunkOffset
+s32 Mesh::chunkOffset( s32 chunk ) const
+{
+    NIMBLE_ABORT_IF( chunk < 0 || chunk >= chunkCount(), "index is out of range" );
+    return m_chunks[chunk].offset;
+}
+
+// ** Mesh::chunkIndexCount
+s32 Mesh::chunkIndexCount( s32 chunk ) const
+{
+    NIMBLE_ABORT_IF( chunk < 0 || chunk >= chunkCount(), "index is out of range" );
+    return m_chunks[chunk].count;
+}
+
+// ** Mesh::chunkBaseVertex
+s32 Mesh::chunkBaseVertex( s32 chunk ) const
+{
+    NIMBLE_ABORT_IF( chunk < 0 || chunk >= chunkCount(), "index is out of range" );
+    return m_chunks[chunk].baseVertex;
+}
+
 // ** Mesh::vertexBuffer
 const Mesh::VertexBuffer& Mesh::vertexBuffer( void ) const
 {
     return m_vertexBuffer;
 }
 
+// ** Mesh::vertexBuffer
+Mesh::VertexBuffer& Mesh::vertexBuffer( void )
+{
+    return m_vertexBuffer;
+}
+
 // ** Mesh::setVertexBuffer
 void Mesh::setVertexBuffer( const VertexBuffer& value )
 {
@@ -115,6 +155,16 @@ void Mesh::updateBounds( void )
     }
 }
 
+// ** Mesh::expandBounds
+void Mesh::expandBounds( s32 firstVertex, s32 count )
+{
+    NIMBLE_ABORT_IF( firstVertex < 0 || firstVertex + count > static_cast<s32>( m_vertexBuffer.size() ), "vertex range is out of bounds" );
+
+    for( s32 i = firstVertex, n = firstVertex + count; i < n; i++ ) {
+        m_bounds << m_vertexBuffer[i].position;
+    }
+}
+
 } // namespace Scene
 
 DC_END_DREEMCHEST
@@ -71,9 +71,24 @@ namespace Scene
         //! Returns chunk texture name.
         const String&                   texture( s32 chunk ) const;
 
+        //! Sets a range of indices rendered by a chunk, indices are offset by a base vertex.
+        void                            setChunkIndices( s32 chunk, s32 offset, s32 count, s32 baseVertex = 0 );
+
+        //! Returns the first index of a chunk.
+        s32                             chunkOffset( s32 chunk ) const;
+
+        //! Returns the total number of indices in a chunk.
+        s32                             chunkIndexCount( s32 chunk ) const;
+
+        //! Returns a value added to each index of a chunk.
+        s32                             chunkBaseVertex( s32 chunk ) const;
+
         //! Returns vertex buffer for a specified mesh chunk.
         const VertexBuffer&             vertexBuffer( void ) const;
 
+        //! Returns vertex buffer that can be filled in place.
+        VertexBuffer&                   vertexBuffer( void );
+
         //! Sets chunk vertex buffer.
         void                            setVertexBuffer( const VertexBuffer& value );
 
@@ -86,6 +101,9 @@ namespace Scene
         //! Updates mesh bounds.
         void                            updateBounds( void );
 
+        //! Expands mesh bounds to include a range of vertices.
+        void                            expandBounds( s32 firstVertex, s32 count );
+
     private:
 
         //! Internal mesh chunk.
@@ -94,6 +112,7 @@ namespace Scene
             String                      texture;    //!< Mesh node texture name.
             s32                         offset;     //!< The first index of a mesh chunk.
             s32                         count;      //!< A total number of indices in a chunk.
+            s32                         baseVertex; //!< A value added to each index of a chunk.
         };
 
         Renderer::VertexFormat          m_vertexFormat; //!< A mesh vertex format.
@@ -0,0 +1,650 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "MeshOptimizer.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+//! A size of a LRU cache modelled by a vertex cache optimization.
+static const s32 kForsythCacheSize = 32;
+
+//! A score of vertices used by the last emitted triangle.
+static const f32 kForsythLastTriangleScore = 0.75f;
+
+//! Controls how fast a score decays with a cache position.
+static const f32 kForsythCacheDecayPower = 1.5f;
+
+//! Scales a bonus given to vertices with a few remaining triangles.
+static const f32 kForsythValenceBoostScale = 2.0f;
+
+//! Controls how fast a valence bonus decays with the number of remaining triangles.
+static const f32 kForsythValenceBoostPower = 0.5f;
+
+//! Vertices with more remaining triangles share the same valence bonus.
+static const s32 kForsythMaxValence = 32;
+
+//! Precalculated parts of a Forsyth's vertex score.
+struct ForsythScores {
+    f32         cache[kForsythCacheSize];       //!< Scores of cache positions.
+    f32         valence[kForsythMaxValence];    //!< Bonuses of remaining triangle counts.
+
+    //! Constructs ForsythScores instance.
+    ForsythScores( void )
+    {
+        for( s32 i = 0; i < kForsythCacheSize; i++ ) {
+            // Vertices of the last triangle get a fixed score, so the next triangle does not always share an edge with it
+            cache[i] = i < 3 ? kForsythLastTriangleScore : powf( 1.0f - static_cast<f32>( i - 3 ) / (kForsythCacheSize - 3), kForsythCacheDecayPower );
+        }
+
+        // Prefer vertices with a few remaining triangles to get rid of lone triangles early
+        valence[0] = 0.0f;
+
+        for( s32 i = 1; i < kForsythMaxValence; i++ ) {
+            valence[i] = kForsythValenceBoostScale * powf( static_cast<f32>( i ), -kForsythValenceBoostPower );
+        }
+    }
+
+    //! Returns a score of a vertex with a specified cache position and the number of remaining triangles.
+    f32         score( s32 cachePosition, s32 remainingTriangles ) const
+    {
+        // A vertex without remaining triangles should never be selected
+        if( remainingTriangles == 0 ) {
+            return -1.0f;
+        }
+
+        return (cachePosition >= 0 ? cache[cachePosition] : 0.0f) + valence[min2( remainingTriangles, kForsythMaxValence - 1 )];
+    }
+};
+
+//! Returns a vertex position stored at a specified index of a strided array.
+static const Vec3& positionAt( const Vec3* positions, s32 stride, s32 index )
+{
+    return *reinterpret_cast<const Vec3*>( reinterpret_cast<const u8*>( positions ) + index * stride );
+}
+
+// ** MeshOptimizer::acmr
+f32 MeshOptimizer::acmr( const u16* indices, s32 indexCount, s32 vertexCount, s32 cacheSize )
+{
+    s32 triangleCount = indexCount / 3;
+
+    if( triangleCount == 0 ) {
+        return 0.0f;
+    }
+
+    // A vertex is inside a FIFO cache while less than cacheSize other vertices were pushed after it
+    Array<s32> pushedAt;
+    pushedAt.resize( vertexCount, -cacheSize - 1 );
+
+    s32 misses = 0;
+
+    for( s32 i = 0; i < triangleCount * 3; i++ ) {
+        s32 vertex = indices[i];
+
+        if( misses - pushedAt[vertex] >= cacheSize ) {
+            pushedAt[vertex] = ++misses;
+        }
+    }
+
+    return static_cast<f32>( misses ) / triangleCount;
+}
+
+// ** MeshOptimizer::optimizeVertexCache
+void MeshOptimizer::optimizeVertexCache( u16* indices, s32 indexCount, s32 vertexCount )
+{
+    s32 triangleCount = indexCount / 3;
+
+    if( triangleCount == 0 ) {
+        return;
+    }
+
+    // Build a list of triangles adjacent to each vertex
+    Array<s32> valence;
+    Array<s32> firstAdjacent;
+    Array<s32> adjacent;
+
+    valence.resize( vertexCount, 0 );
+    firstAdjacent.resize( vertexCount + 1, 0 );
+    adjacent.resize( triangleCount * 3 );
+
+    for( s32 i = 0; i < triangleCount * 3; i++ ) {
+        valence[indices[i]]++;
+    }
+
+    for( s32 i = 0; i < vertexCount; i++ ) {
+        firstAdjacent[i + 1] = firstAdjacent[i] + valence[i];
+        valence[i] = 0;
+    }
+
+    for( s32 i = 0; i < triangleCount * 3; i++ ) {
+        s32 vertex = indices[i];
+        adjacent[firstAdjacent[vertex] + valence[vertex]++] = i / 3;
+    }
+
+    // Calculate initial scores
+    ForsythScores scores;
+    Array<s32>    cachePosition;
+    Array<f32>  vertexScores;
+    Array<f32>  triangleScores;
+    Array<bool> emitted;
+
+    cachePosition.resize( vertexCount, -1 );
+    vertexScores.resize( vertexCount );
+    triangleScores.resize( triangleCount, 0.0f );
+    emitted.resize( triangleCount, false );
+
+    for( s32 i = 0; i < vertexCount; i++ ) {
+        vertexScores[i] = scores.score( -1, valence[i] );
+    }
+
+    for( s32 i = 0; i < triangleCount * 3; i++ ) {
+        triangleScores[i / 3] += vertexScores[indices[i]];
+    }
+
+    // Start from a triangle with the highest score
+    s32 best = 0;
+
+    for( s32 i = 1; i < triangleCount; i++ ) {
+        if( triangleScores[i] > triangleScores[best] ) {
+            best = i;
+        }
+    }
+
+    Array<u16> result;
+    result.resize( triangleCount * 3 );
+
+    s32 cache[kForsythCacheSize + 3];
+    s32 cacheSize = 0;
+    s32 cursor    = 0;
+
+    for( s32 output = 0; output < triangleCount; output++ ) {
+        // No cached vertex has remaining triangles, so continue with the next triangle in an input order
+        if( best < 0 ) {
+            while( emitted[cursor] ) {
+                cursor++;
+            }
+
+            best = cursor;
+        }
+
+        const u16* triangle = indices + best * 3;
+
+        result[output * 3 + 0] = triangle[0];
+        result[output * 3 + 1] = triangle[1];
+        result[output * 3 + 2] = triangle[2];
+        emitted[best] = true;
+
+        // Remove an emitted triangle from adjacency lists of its vertices
+        for( s32 i = 0; i < 3; i++ ) {
+            s32  vertex = triangle[i];
+            s32* first  = &adjacent[firstAdjacent[vertex]];
+
+            for( s32 j = 0; j < valence[vertex]; j++ ) {
+                if( first[j] == best ) {
+                    first[j] = first[--valence[vertex]];
+                    break;
+                }
+            }
+        }
+
+        // Push triangle vertices to the front of a cache, older entries are moved back
+        s32 updated[kForsythCacheSize + 3];
+        s32 updatedSize = 0;
+
+        for( s32 i = 0; i < 3; i++ ) {
+            updated[updatedSize++] = triangle[i];
+        }
+
+        for( s32 i = 0; i < cacheSize; i++ ) {
+            s32 vertex = cache[i];
+
+            if( vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2] ) {
+                updated[updatedSize++] = vertex;
+            }
+        }
+
+        // Update scores of all vertices that were moved or evicted
+        for( s32 i = 0; i < updatedSize; i++ ) {
+            s32 vertex   = updated[i];
+            s32 position = i < kForsythCacheSize ? i : -1;
+            f32 score    = scores.score( position, valence[vertex] );
+            f32 delta    = score - vertexScores[vertex];
+
+            cachePosition[vertex] = position;
+            vertexScores[vertex]  = score;
+
+            for( s32 j = 0; j < valence[vertex]; j++ ) {
+                triangleScores[adjacent[firstAdjacent[vertex] + j]] += delta;
+            }
+        }
+
+        cacheSize = min2( updatedSize, static_cast<s32>( kForsythCacheSize ) );
+        memcpy( cache, updated, cacheSize * sizeof( s32 ) );
+
+        // Select the next triangle among ones adjacent to cached vertices
+        best = -1;
+        f32 bestScore = -1.0f;
+
+        for( s32 i = 0; i < cacheSize; i++ ) {
+            s32 vertex = cache[i];
+
+            for( s32 j = 0; j < valence[vertex]; j++ ) {
+                s32 candidate = adjacent[firstAdjacent[vertex] + j];
+
+                if( triangleScores[candidate] > bestScore ) {
+                    bestScore = triangleScores[candidate];
+                    best      = candidate;
+                }
+            }
+        }
+    }
+
+    memcpy( indices, &result[0], triangleCount * 3 * sizeof( u16 ) );
+}
+
+// ** MeshOptimizer::optimizeOverdraw
+s32 MeshOptimizer::optimizeOverdraw( u16* indices, s32 indexCount, const Vec3* positions, s32 stride, s32 vertexCount )
+{
+    //! A range of triangles that is reordered as a whole.
+    struct Cluster {
+        s32     first;      //!< The first triangle of a cluster.
+        s32     count;      //!< The total number of triangles in a cluster.
+        f32     sortKey;    //!< Clusters that face away from a mesh center are rendered first.
+
+        //! Compares two clusters by a sort key.
+        bool    operator < ( const Cluster& other ) const { return sortKey > other.sortKey || (sortKey == other.sortKey && first < other.first); }
+    };
+
+    s32 triangleCount = indexCount / 3;
+
+    if( triangleCount == 0 ) {
+        return 0;
+    }
+
+    // A cluster is started at each triangle which vertices are all missing in a cache, so reordering clusters barely affects a cache reuse
+    Array<Cluster> clusters;
+    Array<s32>     pushedAt;
+    pushedAt.resize( vertexCount, -CacheSize - 1 );
+
+    s32 misses = 0;
+
+    for( s32 i = 0; i < triangleCount; i++ ) {
+        s32 triangleMisses = 0;
+
+        for( s32 j = 0; j < 3; j++ ) {
+            s32 vertex = indices[i * 3 + j];
+
+            if( misses - pushedAt[vertex] >= CacheSize ) {
+                pushedAt[vertex] = ++misses;
+                triangleMisses++;
+            }
+        }
+
+        if( i == 0 || triangleMisses == 3 ) {
+            Cluster cluster;
+            cluster.first   = i;
+            cluster.count   = 0;
+            cluster.sortKey = 0.0f;
+            clusters.push_back( cluster );
+        }
+
+        clusters.back().count++;
+    }
+
+    // Calculate an area weighted centroid and a normal of each cluster
+    Array<Vec3> centroids;
+    Array<Vec3> normals;
+    Vec3        meshCentroid;
+    f32         meshArea = 0.0f;
+
+    centroids.resize( clusters.size() );
+    normals.resize( clusters.size() );
+
+    for( s32 i = 0, n = static_cast<s32>( clusters.size() ); i < n; i++ ) {
+        const Cluster& cluster = clusters[i];
+        Vec3           centroid;
+        Vec3           normal;
+        f32            area = 0.0f;
+
+        for( s32 j = cluster.first; j < cluster.first + cluster.count; j++ ) {
+            const Vec3& a = positionAt( positions, stride, indices[j * 3 + 0] );
+            const Vec3& b = positionAt( positions, stride, indices[j * 3 + 1] );
+            const Vec3& c = positionAt( positions, stride, indices[j * 3 + 2] );
+
+            Vec3 face     = (b - a) % (c - a);
+            f32  faceArea = face.length();
+
+            normal   = normal + face;
+            centroid = centroid + (a + b + c) * (faceArea / 3.0f);
+            area    += faceArea;
+        }
+
+        centroids[i]  = area > 0.0f ? centroid / area : positionAt( positions, stride, indices[cluster.first * 3] );
+        normals[i]    = normal;
+        meshCentroid  = meshCentroid + centroid;
+        meshArea     += area;
+    }
+
+    if( meshArea > 0.0f ) {
+        meshCentroid = meshCentroid / meshArea;
+    }
+
+    // Clusters that face outwards are more likely to occlude others
+    for( s32 i = 0, n = static_cast<s32>( clusters.size() ); i < n; i++ ) {
+        f32 length = normals[i].length();
+        clusters[i].sortKey = length > 0.0f ? ((centroids[i] - meshCentroid) * normals[i]) / length : 0.0f;
+    }
+
+    std::sort( clusters.begin(), clusters.end() );
+
+    // Write reordered triangles
+    Array<u16> result;
+    result.resize( triangleCount * 3 );
+
+    for( s32 i = 0, n = static_cast<s32>( clusters.size() ), output = 0; i < n; i++ ) {
+        const Cluster& cluster = clusters[i];
+        memcpy( &result[output * 3], indices + cluster.first * 3, cluster.count * 3 * sizeof( u16 ) );
+        output += cluster.count;
+    }
+
+    memcpy( indices, &result[0], triangleCount * 3 * sizeof( u16 ) );
+
+    return static_cast<s32>( clusters.size() );
+}
+
+// ** MeshOptimizer::optimizeVertexFetch
+s32 MeshOptimizer::optimizeVertexFetch( u16* indices, s32 indexCount, s32 vertexCount, Array<u16>& remap )
+{
+    Array<s32> renumbered;
+    renumbered.resize( vertexCount, -1 );
+    remap.clear();
+
+    for( s32 i = 0; i < indexCount; i++ ) {
+        s32 vertex = indices[i];
+
+        if( renumbered[vertex] < 0 ) {
+            renumbered[vertex] = static_cast<s32>( remap.size() );
+            remap.push_back( vertex );
+        }
+
+        indices[i] = static_cast<u16>( renumbered[vertex] );
+    }
+
+    return static_cast<s32>( remap.size() );
+}
+
+// ** MeshOptimizer::quantizeUnorm16
+u16 MeshOptimizer::quantizeUnorm16( f32 value, f32 min, f32 max )
+{
+    if( max <= min ) {
+        return 0;
+    }
+
+    f32 t = min2( max2( (value - min) / (max - min), 0.0f ), 1.0f );
+    return static_cast<u16>( t * 65535.0f + 0.5f );
+}
+
+// ** MeshOptimizer::dequantizeUnorm16
+f32 MeshOptimizer::dequantizeUnorm16( u16 value, f32 min, f32 max )
+{
+    return min + (max - min) * (value / 65535.0f);
+}
+
+// ** MeshOptimizer::encodeOctahedral
+void MeshOptimizer::encodeOctahedral( const Vec3& normal, s16& x, s16& y )
+{
+    f32 sum = fabsf( normal.x ) + fabsf( normal.y ) + fabsf( normal.z );
+
+    if( sum == 0.0f ) {
+        x = y = 0;
+        return;
+    }
+
+    // Project to an octahedron and fold a lower hemisphere over diagonals
+    f32 u = normal.x / sum;
+    f32 v = normal.y / sum;
+
+    if( normal.z < 0.0f ) {
+        f32 fu = (1.0f - fabsf( v )) * (u >= 0.0f ? 1.0f : -1.0f);
+        f32 fv = (1.0f - fabsf( u )) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+
+    x = static_cast<s16>( floorf( min2( max2( u, -1.0f ), 1.0f ) * 32767.0f + 0.5f ) );
+    y = static_cast<s16>( floorf( min2( max2( v, -1.0f ), 1.0f ) * 32767.0f + 0.5f ) );
+}
+
+// ** MeshOptimizer::decodeOctahedral
+Vec3 MeshOptimizer::decodeOctahedral( s16 x, s16 y )
+{
+    f32 u = max2( x / 32767.0f, -1.0f );
+    f32 v = max2( y / 32767.0f, -1.0f );
+    f32 w = 1.0f - fabsf( u ) - fabsf( v );
+
+    // Unfold a lower hemisphere
+    if( w < 0.0f ) {
+        f32 fu = (1.0f - fabsf( v )) * (u >= 0.0f ? 1.0f : -1.0f);
+        f32 fv = (1.0f - fabsf( u )) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+
+    Vec3 result( u, v, w );
+    return result / result.length();
+}
+
+// ** MeshOptimizer::encodeHalf
+u16 MeshOptimizer::encodeHalf( f32 value )
+{
+    u32 bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+
+    u32 sign     = (bits >> 16) & 0x8000;
+    s32 exponent = static_cast<s32>( (bits >> 23) & 0xff );
+    u32 mantissa = bits & 0x7fffff;
+
+    // Infinities and NaNs
+    if( exponent == 0xff ) {
+        return static_cast<u16>( sign | 0x7c00 | (mantissa ? 0x200 : 0) );
+    }
+
+    exponent = exponent - 127 + 15;
+
+    // Overflows to infinity
+    if( exponent >= 31 ) {
+        return static_cast<u16>( sign | 0x7c00 );
+    }
+
+    // Subnormal results or underflows to zero
+    if( exponent <= 0 ) {
+        if( exponent < -10 ) {
+            return static_cast<u16>( sign );
+        }
+
+        mantissa |= 0x800000;
+
+        s32 shift = 14 - exponent;
+        u32 half  = mantissa >> shift;
+
+        if( (mantissa >> (shift - 1)) & 1 ) {
+            half++;
+        }
+
+        return static_cast<u16>( sign | half );
+    }
+
+    // A rounding carry correctly propagates to an exponent
+    u32 half = sign | (exponent << 10) | (mantissa >> 13);
+
+    if( mantissa & 0x1000 ) {
+        half++;
+    }
+
+    return static_cast<u16>( half );
+}
+
+// ** MeshOptimizer::decodeHalf
+f32 MeshOptimizer::decodeHalf( u16 value )
+{
+    u32 sign     = static_cast<u32>( value & 0x8000 ) << 16;
+    s32 exponent = (value >> 10) & 0x1f;
+    u32 mantissa = value & 0x3ff;
+    u32 bits;
+
+    if( exponent == 0 ) {
+        if( mantissa == 0 ) {
+            bits = sign;
+        } else {
+            // Normalize a subnormal value
+            exponent = 1;
+
+            while( (mantissa & 0x400) == 0 ) {
+                mantissa <<= 1;
+                exponent--;
+            }
+
+            bits = sign | ((exponent + 112) << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    } else if( exponent == 31 ) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    f32 result;
+    memcpy( &result, &bits, sizeof( result ) );
+    return result;
+}
+
+// ** MeshOptimizer::encodeVertices
+void MeshOptimizer::encodeVertices( const Mesh::Vertex* vertices, s32 count, const Renderer::VertexFormat& format, const Bounds& bounds, void* output )
+{
+    typedef Renderer::VertexFormat VertexFormat;
+
+    s32 size = format.vertexSize();
+
+    for( s32 i = 0; i < count; i++ ) {
+        const Mesh::Vertex& vertex      = vertices[i];
+        u8*                 destination = reinterpret_cast<u8*>( output ) + i * size;
+
+        if( format.isQuantized( VertexFormat::QuantizedPosition ) ) {
+            u16 position[4];
+
+            for( s32 j = 0; j < 3; j++ ) {
+                position[j] = quantizeUnorm16( vertex.position[j], bounds.min()[j], bounds.max()[j] );
+            }
+            position[3] = 0;
+
+            memcpy( destination + format.attributeOffset( VertexFormat::Position ), position, sizeof( position ) );
+        } else {
+            memcpy( destination + format.attributeOffset( VertexFormat::Position ), &vertex.position, sizeof( vertex.position ) );
+        }
+
+        if( format & VertexFormat::Normal ) {
+            if( format.isQuantized( VertexFormat::OctahedralNormal ) ) {
+                s16 normal[2];
+                encodeOctahedral( vertex.normal, normal[0], normal[1] );
+                memcpy( destination + format.attributeOffset( VertexFormat::Normal ), normal, sizeof( normal ) );
+            } else {
+                memcpy( destination + format.attributeOffset( VertexFormat::Normal ), &vertex.normal, sizeof( vertex.normal ) );
+            }
+        }
+
+        for( s32 j = 0; j < Mesh::Vertex::MaxTexCoords; j++ ) {
+            VertexFormat::Attribute attribute = j == 0 ? VertexFormat::TexCoord0 : VertexFormat::TexCoord1;
+
+            if( !(format & attribute) ) {
+                continue;
+            }
+
+            if( format.isQuantized( VertexFormat::HalfTexCoord ) ) {
+                u16 uv[2] = { encodeHalf( vertex.uv[j].x ), encodeHalf( vertex.uv[j].y ) };
+                memcpy( destination + format.attributeOffset( attribute ), uv, sizeof( uv ) );
+            } else {
+                memcpy( destination + format.attributeOffset( attribute ), &vertex.uv[j], sizeof( vertex.uv[j] ) );
+            }
+        }
+    }
+}
+
+// ** MeshOptimizer::decodeVertices
+void MeshOptimizer::decodeVertices( const void* input, s32 count, const Renderer::VertexFormat& format, const Bounds& bounds, Mesh::Vertex* vertices )
+{
+    typedef Renderer::VertexFormat VertexFormat;
+
+    s32 size = format.vertexSize();
+
+    for( s32 i = 0; i < count; i++ ) {
+        Mesh::Vertex& vertex = vertices[i];
+        const u8*     source = reinterpret_cast<const u8*>( input ) + i * size;
+
+        vertex = Mesh::Vertex();
+
+        if( format.isQuantized( VertexFormat::QuantizedPosition ) ) {
+            u16 position[4];
+            memcpy( position, source + format.attributeOffset( VertexFormat::Position ), sizeof( position ) );
+
+            for( s32 j = 0; j < 3; j++ ) {
+                vertex.position[j] = dequantizeUnorm16( position[j], bounds.min()[j], bounds.max()[j] );
+            }
+        } else {
+            memcpy( &vertex.position, source + format.attributeOffset( VertexFormat::Position ), sizeof( vertex.position ) );
+        }
+
+        if( format & VertexFormat::Normal ) {
+            if( format.isQuantized( VertexFormat::OctahedralNormal ) ) {
+                s16 normal[2];
+                memcpy( normal, source + format.attributeOffset( VertexFormat::Normal ), sizeof( normal ) );
+                vertex.normal = decodeOctahedral( normal[0], normal[1] );
+            } else {
+                memcpy( &vertex.normal, source + format.attributeOffset( VertexFormat::Normal ), sizeof( vertex.normal ) );
+            }
+        }
+
+        for( s32 j = 0; j < Mesh::Vertex::MaxTexCoords; j++ ) {
+            VertexFormat::Attribute attribute = j == 0 ? VertexFormat::TexCoord0 : VertexFormat::TexCoord1;
+
+            if( !(format & attribute) ) {
+                continue;
+            }
+
+            if( format.isQuantized( VertexFormat::HalfTexCoord ) ) {
+                u16 uv[2];
+                memcpy( uv, source + format.attributeOffset( attribute ), sizeof( uv ) );
+                vertex.uv[j] = Vec2( decodeHalf( uv[0] ), decodeHalf( uv[1] ) );
+            } else {
+                memcpy( &vertex.uv[j], source + format.attributeOffset( attribute ), sizeof( vertex.uv[j] ) );
+            }
+        }
+    }
+}
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
@@ -0,0 +1,120 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Scene_MeshOptimizer_H__
+#define __DC_Scene_MeshOptimizer_H__
+
+#include "Mesh.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+    //! Reorders and compresses indexed triangle lists to make them cheaper to render and to store.
+    /*!
+     Triangles are first reordered with a Forsyth's algorithm so that a post-transform vertex cache is reused
+     as much as possible. Then the resulting list is split to clusters at points where a cache is completely
+     flushed and clusters are sorted to render outer surfaces of a mesh first, this reduces an overdraw without
+     noticeably increasing a cache miss ratio. Finally vertices are renumbered in an order of a first use, so a
+     vertex fetch becomes sequential.
+
+     Quantization helpers convert vertex attributes to compact formats described by Renderer::VertexFormat.
+     */
+    class MeshOptimizer {
+    public:
+
+        //! A default size of a simulated FIFO post-transform vertex cache.
+        enum { CacheSize = 16 };
+
+        //! Returns an average number of vertices transformed per triangle when indices are processed by a FIFO vertex cache.
+        static f32              acmr( const u16* indices, s32 indexCount, s32 vertexCount, s32 cacheSize = CacheSize );
+
+        //! Reorders triangles to improve a post-transform vertex cache reuse.
+        static void             optimizeVertexCache( u16* indices, s32 indexCount, s32 vertexCount );
+
+        //! Reorders clusters of triangles so that outer surfaces of a mesh are rendered first.
+        /*!
+         \param indices Triangle indices that were already optimized for a vertex cache.
+         \param indexCount The total number of indices.
+         \param positions Vertex positions.
+         \param stride A distance in bytes between two consecutive vertex positions.
+         \param vertexCount The total number of vertices.
+         \return The total number of triangle clusters.
+         */
+        static s32              optimizeOverdraw( u16* indices, s32 indexCount, const Vec3* positions, s32 stride, s32 vertexCount );
+
+        //! Renumbers vertices in an order of a first use and fills a table that maps new vertex indices to old ones, returns the total number of used vertices.
+        static s32              optimizeVertexFetch( u16* indices, s32 indexCount, s32 vertexCount, Array<u16>& remap );
+
+        //! Reorders vertices using a table returned by an optimizeVertexFetch, unused vertices are removed.
+        template<typename TVertex>
+        static void             remapVertices( Array<TVertex>& vertices, const Array<u16>& remap );
+
+        //! Maps a value inside a specified range to a 16-bit unsigned normalized integer.
+        static u16              quantizeUnorm16( f32 value, f32 min, f32 max );
+
+        //! Maps a 16-bit unsigned normalized integer back to a specified range.
+        static f32              dequantizeUnorm16( u16 value, f32 min, f32 max );
+
+        //! Encodes a unit vector as two 16-bit signed normalized integers of an octahedral mapping.
+        static void             encodeOctahedral( const Vec3& normal, s16& x, s16& y );
+
+        //! Decodes a unit vector from an octahedral mapping.
+        static Vec3             decodeOctahedral( s16 x, s16 y );
+
+        //! Converts a 32-bit float to a 16-bit one.
+        static u16              encodeHalf( f32 value );
+
+        //! Converts a 16-bit float to a 32-bit one.
+        static f32              decodeHalf( u16 value );
+
+        //! Writes vertices in a specified format to an output buffer of count * format.vertexSize() bytes, quantized positions are stored relative to bounds.
+        static void             encodeVertices( const Mesh::Vertex* vertices, s32 count, const Renderer::VertexFormat& format, const Bounds& bounds, void* output );
+
+        //! Reads vertices in a specified format from an input buffer.
+        static void             decodeVertices( const void* input, s32 count, const Renderer::VertexFormat& format, const Bounds& bounds, Mesh::Vertex* vertices );
+    };
+
+    // ** MeshOptimizer::remapVertices
+    template<typename TVertex>
+    void MeshOptimizer::remapVertices( Array<TVertex>& vertices, const Array<u16>& remap )
+    {
+        Array<TVertex> result;
+        result.resize( remap.size() );
+
+        for( s32 i = 0, n = static_cast<s32>( remap.size() ); i < n; i++ ) {
+            result[i] = vertices[remap[i]];
+        }
+
+        vertices.swap( result );
+    }
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Scene_MeshOptimizer_H__    */
@@ -26,6 +26,10 @@
 
 #include "Terrain.h"
 #include "Mesh.h"
+#include "../Rendering/RenderCache.h"
+
+#include "../../Threads/Task/TaskManager.h"
+#include "../../Threads/Task/TaskProgress.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -41,7 +45,7 @@ s32 Terrain::kMaxSize = 2048;
 
 // ** Terrain::Terrain
 Terrain::Terrain( u32 size )
-    : m_heightmap( size ), m_maxHeight( static_cast<f32>( size ) )
+    : m_heightmap( size ), m_maxHeight( static_cast<f32>( size ) ), m_chunkIndices( createChunkIndexBuffer() )
 {
     NIMBLE_BREAK_IF( (size % kChunkSize) != 0, "terrain size should be a multiple of chunk size" );
 }
@@ -87,9 +91,9 @@ f32 Terrain::height( f32 x, f32 z ) const
     s32 hx = static_cast<s32>( floor( x ) );
     s32 hz = static_cast<s32>( floor( z ) );
 
-    // Make sure that we are using right indices
-    if( hx + 1 >= static_cast<s32>( size() ) ) hx--;
-    if( hz + 1 >= static_cast<s32>( size() ) ) hz--;
+    // Make sure that we are using right indices, a heightmap has one more vertex than cells along each axis
+    if( hx + 1 > static_cast<s32>( size() ) ) hx--;
+    if( hz + 1 > static_cast<s32>( size() ) ) hz--;
 
     // Calculate the fraction values
     f32 fx = x - hx;
@@ -188,8 +192,16 @@ Array<Terrain::Vertex> Terrain::chunkVertexBuffer( u32 x, u32 z ) const
 }
 
 // ** Terrain::chunkIndexBuffer
-Array<u16> Terrain::chunkIndexBuffer( void ) const
+const Terrain::IndexBuffer& Terrain::chunkIndexBuffer( void ) const
+{
+    return m_chunkIndices;
+}
+
+// ** Terrain::createChunkIndexBuffer
+Terrain::IndexBuffer Terrain::createChunkIndexBuffer( void )
 {
+    IndexBuffer indices;
+
     // Index offset
     u16 idx = 0;
 
@@ -197,8 +209,7 @@ Array<u16> Terrain::chunkIndexBuffer( void ) const
     s32 stride = kChunkSize + 1;
 
     // Construct index buffer
-    Array<u16> indices;
-    indices.resize( stride * stride * 6 );
+    indices.resize( kChunkSize * kChunkSize * 6 );
 
     // Fill index buffer
     for( s32 i = 0; i < kChunkSize; i++ ) {
@@ -219,28 +230,53 @@ Array<u16> Terrain::chunkIndexBuffer( void ) const
 }
 
 // ** Terrain::createMesh
-Mesh Terrain::createMesh( void ) const
+Mesh Terrain::createMesh( Threads::TaskManagerWPtr taskManager ) const
 {
     // Create an empty mesh
     Mesh mesh;
 
-    // Set the number of mesh chunks
-    mesh.setChunkCount( chunkCount() * chunkCount() );
+    u32 count            = chunkCount();
+    s32 stride           = kChunkSize + 1;
+    s32 verticesPerChunk = stride * stride;
+
+    // All chunks share the same index buffer, so each chunk is rendered with its own base vertex
+    const IndexBuffer& indices = chunkIndexBuffer();
+
+    mesh.setChunkCount( count * count );
+    mesh.setIndexBuffer( indices );
+    mesh.vertexBuffer().resize( count * count * verticesPerChunk );
+
+    for( u32 i = 0, n = count * count; i < n; i++ ) {
+        mesh.setChunkIndices( i, 0, static_cast<s32>( indices.size() ), i * verticesPerChunk );
+    }
+
+    // Each job generates a column of chunks
+    Array<ChunkJob> jobs;
+    jobs.resize( count );
 
-    // Construct chunks
-    u32 chunk = 0;
+    for( u32 i = 0; i < count; i++ ) {
+        jobs[i].terrain = this;
+        jobs[i].mesh    = &mesh;
+        jobs[i].x       = i;
+    }
+
+    if( taskManager.valid() && count > 1 ) {
+        Array<Threads::TaskProgressPtr> progress;
 
-    for( u32 i = 0; i < chunkCount(); i++ ) {
-        for( u32 j = 0; j < chunkCount(); j++ ) {
-            // Get the chunk buffers
-            VertexBuffer vertices = chunkVertexBuffer( i, j );
-            IndexBuffer  indices  = chunkIndexBuffer();
+        // Queue all jobs except the first one to worker threads
+        for( u32 i = 1; i < count; i++ ) {
+            progress.push_back( taskManager->runBackgroundTask( dcStaticFunction( Terrain::processChunkJob ), &jobs[i] ) );
+        }
 
-            // Set chunk mesh
-            setMeshChunk( mesh, chunk, vertices, indices, i * kChunkSize, j * kChunkSize );
+        // The calling thread processes the first job itself
+        processChunkJob( Threads::TaskProgressWPtr(), &jobs[0] );
 
-            // Increase the chunk index
-            chunk++;
+        for( u32 i = 0, n = static_cast<u32>( progress.size() ); i < n; i++ ) {
+            progress[i]->waitForCompletion();
+        }
+    } else {
+        for( u32 i = 0; i < count; i++ ) {
+            processChunkJob( Threads::TaskProgressWPtr(), &jobs[i] );
         }
     }
 
@@ -250,21 +286,127 @@ Mesh Terrain::createMesh( void ) const
     return mesh;
 }
 
+// ** Terrain::updateMesh
+Array<s32> Terrain::updateMesh( Mesh& mesh, const Heightmap::Regions& regions ) const
+{
+    s32 count            = static_cast<s32>( chunkCount() );
+    s32 size             = static_cast<s32>( m_heightmap.size() );
+    s32 verticesPerChunk = (kChunkSize + 1) * (kChunkSize + 1);
+
+    NIMBLE_ABORT_IF( mesh.chunkCount() != count * count, "a mesh was not constructed from this terrain" );
+
+    // Mark chunks that contain changed vertices or their neighbours
+    Array<bool> dirty;
+    dirty.resize( count * count, false );
+
+    for( s32 i = 0, n = static_cast<s32>( regions.size() ); i < n; i++ ) {
+        const Heightmap::Region& region = regions[i];
+
+        if( region.width == 0 || region.height == 0 ) {
+            continue;
+        }
+
+        // Vertices at chunk borders belong to both adjacent chunks
+        s32 minX = max2( static_cast<s32>( region.x ) - 2, 0 ) / kChunkSize;
+        s32 minZ = max2( static_cast<s32>( region.z ) - 2, 0 ) / kChunkSize;
+        s32 maxX = min2( static_cast<s32>( region.x + region.width ), size - 1 ) / kChunkSize;
+        s32 maxZ = min2( static_cast<s32>( region.z + region.height ), size - 1 ) / kChunkSize;
+
+        for( s32 x = minX; x <= maxX; x++ ) {
+            for( s32 z = minZ; z <= maxZ; z++ ) {
+                dirty[x * count + z] = true;
+            }
+        }
+    }
+
+    // Regenerate marked chunks
+    Array<s32> chunks;
+
+    for( s32 x = 0; x < count; x++ ) {
+        for( s32 z = 0; z < count; z++ ) {
+            s32 chunk = x * count + z;
+
+            if( !dirty[chunk] ) {
+                continue;
+            }
+
+            generateChunkVertices( x, z, mesh, mesh.chunkBaseVertex( chunk ), static_cast<f32>( x * kChunkSize ), static_cast<f32>( z * kChunkSize ) );
+            mesh.expandBounds( mesh.chunkBaseVertex( chunk ), verticesPerChunk );
+            chunks.push_back( chunk );
+        }
+    }
+
+    return chunks;
+}
+
+// ** Terrain::updateMesh
+Array<s32> Terrain::updateMesh( MeshHandle mesh, const Heightmap::Regions& regions, RenderCacheWPtr cache ) const
+{
+    Array<s32> chunks;
+
+    // Release a write lock before vertices are read by a render cache
+    {
+        Assets::WriteLock<Mesh> locked = mesh.writeLock();
+        chunks = updateMesh( *locked, regions );
+    }
+
+    uploadChunks( mesh, chunks, cache );
+
+    return chunks;
+}
+
+// ** Terrain::uploadChunks
+void Terrain::uploadChunks( const MeshHandle& mesh, const Array<s32>& chunks, RenderCacheWPtr cache ) const
+{
+    s32 verticesPerChunk = (kChunkSize + 1) * (kChunkSize + 1);
+
+    // Chunk vertices are stored one after another, so a run of adjacent chunks is a single vertex range
+    for( s32 i = 0, n = static_cast<s32>( chunks.size() ); i < n; ) {
+        s32 first = i;
+
+        while( i + 1 < n && chunks[i + 1] == chunks[i] + 1 ) {
+            i++;
+        }
+
+        cache->updateVertexBuffer( mesh, mesh->chunkBaseVertex( chunks[first] ), (i - first + 1) * verticesPerChunk );
+        i++;
+    }
+}
+
+// ** Terrain::processChunkJob
+void Terrain::processChunkJob( Threads::TaskProgressWPtr progress, void* userData )
+{
+    const ChunkJob* job    = reinterpret_cast<const ChunkJob*>( userData );
+    const Terrain*  self   = job->terrain;
+    u32             count  = self->chunkCount();
+    s32             stride = kChunkSize + 1;
+
+    for( u32 z = 0; z < count; z++ ) {
+        u32 chunk = job->x * count + z;
+        self->generateChunkVertices( job->x, z, *job->mesh, chunk * stride * stride, static_cast<f32>( job->x * kChunkSize ), static_cast<f32>( z * kChunkSize ) );
+    }
+}
+
 // ** Terrain::createChunkMesh
 Mesh Terrain::createChunkMesh( u32 x, u32 z ) const
 {
+    NIMBLE_ABORT_IF( x >= chunkCount(), "invalid chunk coordinate" )
+    NIMBLE_ABORT_IF( z >= chunkCount(), "invalid chunk coordinate" )
+
     // Create an empty mesh
     Mesh mesh;
 
-    // Get the chunk buffers
-    VertexBuffer vertices = chunkVertexBuffer( x, z );
-    IndexBuffer  indices  = chunkIndexBuffer();
+    s32                stride  = kChunkSize + 1;
+    const IndexBuffer& indices = chunkIndexBuffer();
 
     // Set the number of mesh chunks
     mesh.setChunkCount( 1 );
+    mesh.setIndexBuffer( indices );
+    mesh.setChunkIndices( 0, 0, static_cast<s32>( indices.size() ) );
 
     // Set the chunk data
-    setMeshChunk( mesh, 0, vertices, indices );
+    mesh.vertexBuffer().resize( stride * stride );
+    generateChunkVertices( x, z, mesh, 0, 0.0f, 0.0f );
 
     // Now update the mesh bounding box
     mesh.updateBounds();
@@ -272,25 +414,74 @@ Mesh Terrain::createChunkMesh( u32 x, u32 z ) const
     return mesh;
 }
 
-// ** Terrain::setMeshChunk
-void Terrain::setMeshChunk( Mesh& mesh, u32 chunk, const VertexBuffer& vertices, const IndexBuffer& indices, u32 x, u32 z ) const
+// ** Terrain::generateChunkVertices
+void Terrain::generateChunkVertices( u32 x, u32 z, Mesh& mesh, s32 firstVertex, f32 originX, f32 originZ ) const
 {
-#if 0
-    // Set the chunk data
-    Mesh::VertexBuffer vb;
-    vb.resize( vertices.size() );
+    s32 size        = static_cast<s32>( m_heightmap.size() );
+    s32 stride      = kChunkSize + 1;
+    s32 cacheStride = kChunkSize + 3;
+    s32 x0          = x * kChunkSize;
+    s32 z0          = z * kChunkSize;
+    f32 heightScale = m_maxHeight / m_heightmap.maxValue();
+    f32 uvSize      = 1.0f / size;
+    f32 detailSize  = 1.0f / kChunkSize;
+
+    // Read heights of chunk vertices with a single vertex border once, so normals do not fetch neighbours again
+    Array<f32> heights;
+    heights.resize( cacheStride * cacheStride );
+
+    for( s32 i = 0; i < cacheStride; i++ ) {
+        s32 hz = min2( max2( z0 - 1 + i, 0 ), size );
+
+        for( s32 j = 0; j < cacheStride; j++ ) {
+            s32 hx = min2( max2( x0 - 1 + j, 0 ), size );
+            heights[i * cacheStride + j] = static_cast<f32>( m_heightmap.height( hx, hz ) );
+        }
+    }
 
-    for( u32 i = 0, n = ( u32 )vertices.size(); i < n; i++ ) {
-        vb[i].position = vertices[i].position + Vec3( x, 0, z );
-        vb[i].normal = vertices[i].normal;
-        vb[i].uv[0] = vertices[i].uv;
+    // Neighbour offsets and gradient scales are the same for each row and each column, so they are calculated once.
+    // Heightmap borders are handled the same way Heightmap::normal does.
+    Array<s32> prev, next;
+    Array<f32> scale;
+    prev.resize( stride );
+    next.resize( stride );
+    scale.resize( stride * 2 );
+
+    for( s32 i = 0; i < stride; i++ ) {
+        s32 gx = x0 + i;
+        s32 gz = z0 + i;
+
+        prev[i] = (gx > 0 ? gx - 1 : gx) - x0 + 1;
+        next[i] = (gx < size - 1 ? gx + 1 : gx) - x0 + 1;
+        scale[i] = (gx == 0 || gx == size - 1) ? 2.0f : 1.0f;
+        scale[stride + i] = (gz == 0 || gz == size - 1) ? 2.0f : 1.0f;
     }
 
-    mesh.setVertexBuffer( vb );
-    mesh.setIndexBuffer( indices );
-#else
-    NIMBLE_NOT_IMPLEMENTED
-#endif
+    Mesh::Vertex* vertices = &mesh.vertexBuffer()[firstVertex];
+
+    for( s32 i = 0; i < stride; i++ ) {
+        s32 gz = z0 + i;
+
+        // Rows used by a Z gradient of this row
+        const f32* row  = &heights[(i + 1) * cacheStride];
+        const f32* down = &heights[((gz > 0 ? gz - 1 : gz) - z0 + 1) * cacheStride];
+        const f32* up   = &heights[((gz < size - 1 ? gz + 1 : gz) - z0 + 1) * cacheStride];
+        f32        sz   = scale[stride + i];
+
+        for( s32 j = 0; j < stride; j++ ) {
+            f32 dx = (row[next[j]] - row[prev[j]]) * scale[j];
+            f32 dz = (up[j + 1] - down[j + 1]) * sz;
+
+            Vec3 normal( -dx, 2.0f, dz );
+            normal.normalize();
+
+            Mesh::Vertex& vertex = vertices[i * stride + j];
+            vertex.position = Vec3( originX + j, row[j + 1] * heightScale, originZ + i );
+            vertex.normal   = normal;
+            vertex.uv[0]    = Vec2( vertex.position.x, vertex.position.z ) * uvSize;
+            vertex.uv[1]    = Vec2( static_cast<f32>( j ), static_cast<f32>( i ) ) * detailSize;
+        }
+    }
 }
 
 // --------------------------------------------------------------------- Heightmap ---------------------------------------------------------------------- //
@@ -329,6 +520,7 @@ void Heightmap::setHeight( u32 x, u32 z, Type value )
 {
     NIMBLE_ABORT_IF( x > m_size || z > m_size, "index is out of range" );
     m_buffer[z * (m_size + 1) + x] = value;
+    invalidate( x, z, 1, 1 );
 }
 
 // ** Heightmap::normal
@@ -355,15 +547,78 @@ Vec3 Heightmap::normal( u32 x, u32 z ) const
     return normal;
 }
 
+// ** Heightmap::invalidate
+void Heightmap::invalidate( u32 x, u32 z, u32 width, u32 height )
+{
+    NIMBLE_ABORT_IF( x > m_size || z > m_size, "index is out of range" );
+
+    Region region( x, z, min2( width, m_size + 1 - x ), min2( height, m_size + 1 - z ) );
+
+    if( region.width == 0 || region.height == 0 ) {
+        return;
+    }
+
+    // The most recent region is the last one, so a brush that writes vertex by vertex usually ends here
+    if( !m_dirty.empty() ) {
+        const Region& last = m_dirty.back();
+
+        if( region.x >= last.x && region.z >= last.z && region.x + region.width <= last.x + last.width && region.z + region.height <= last.z + last.height ) {
+            return;
+        }
+    }
+
+    // Merge all touching regions into a new one
+    for( s32 i = 0; i < static_cast<s32>( m_dirty.size() ); ) {
+        const Region& item = m_dirty[i];
+
+        if( item.x > region.x + region.width || region.x > item.x + item.width || item.z > region.z + region.height || region.z > item.z + item.height ) {
+            i++;
+            continue;
+        }
+
+        u32 maxX = max2( item.x + item.width, region.x + region.width );
+        u32 maxZ = max2( item.z + item.height, region.z + region.height );
+
+        region.x      = min2( item.x, region.x );
+        region.z      = min2( item.z, region.z );
+        region.width  = maxX - region.x;
+        region.height = maxZ - region.z;
+
+        m_dirty[i] = m_dirty.back();
+        m_dirty.pop_back();
+
+        // A grown region may now touch regions that were already tested
+        i = 0;
+    }
+
+    m_dirty.push_back( region );
+}
+
+// ** Heightmap::dirtyRegions
+const Heightmap::Regions& Heightmap::dirtyRegions( void ) const
+{
+    return m_dirty;
+}
+
+// ** Heightmap::clearDirtyRegions
+void Heightmap::clearDirtyRegions( void )
+{
+    m_dirty.clear();
+}
+
 // ** Heightmap::set
 void Heightmap::set( StrongPtr<Generator> generator )
 {
     // Generate heightmap
     for( u32 z = 0; z <= m_size; z++ ) {
         for( u32 x = 0; x <= m_size; x++ ) {
-            setHeight( x, z, generator->calculate( x, z ) );
+            m_buffer[z * (m_size + 1) + x] = generator->calculate( x, z );
         }
     }
+
+    // The whole heightmap was changed
+    m_dirty.clear();
+    m_dirty.push_back( Region( 0, 0, m_size + 1, m_size + 1 ) );
 }
 
 } // namespace Scene
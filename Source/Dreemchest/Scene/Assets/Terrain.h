@@ -40,6 +40,20 @@ namespace Scene {
         typedef u16                Type;    //!< Single heightmap pixel type.
         typedef Array<Type>        Buffer;    //!< Heightmap buffer.
 
+        //! A rectangle of heightmap vertices.
+        struct Region {
+                                //! Constructs Region instance.
+                                Region( u32 x = 0, u32 z = 0, u32 width = 0, u32 height = 0 )
+                                    : x( x ), z( z ), width( width ), height( height ) {}
+
+            u32                 x;          //!< The first vertex along the X axis.
+            u32                 z;          //!< The first vertex along the Z axis.
+            u32                 width;      //!< The total number of vertices along the X axis.
+            u32                 height;     //!< The total number of vertices along the Z axis.
+        };
+
+        typedef Array<Region>    Regions;    //!< Container type to store heightmap regions.
+
         //! Base class to declare custom heightmap generators.
         class Generator : public RefCounted {
         public:
@@ -69,6 +83,15 @@ namespace Scene {
         //! Returns the maximum value that can be stored inside this heightmap.
         Type                    maxValue( void ) const;
 
+        //! Marks a rectangle of heightmap vertices as changed, touching or overlapping dirty regions are merged.
+        void                    invalidate( u32 x, u32 z, u32 width, u32 height );
+
+        //! Returns regions that were changed since the last call to clearDirtyRegions.
+        const Regions&            dirtyRegions( void ) const;
+
+        //! Clears all dirty regions.
+        void                    clearDirtyRegions( void );
+
         //! Fills the heightmap with a constant height value.
         class ConstantHeight : public Generator {
         public:
@@ -106,6 +129,7 @@ namespace Scene {
 
         u32                        m_size;        //!< Heightmap size.
         Buffer                    m_buffer;    //!< Actual heightmap buffer.
+        Regions                    m_dirty;    //!< Changed heightmap regions.
     };
 
     //! Heightmap base terrain.
@@ -143,7 +167,7 @@ namespace Scene {
         //! Returns maximum terrain height.
         f32                        maxHeight( void ) const;
 
-        //! Finds the terrain & ray intersection point.
+        //! Finds the terrain & ray intersection point by bisecting the first 1000 units of a ray, use TerrainRayCaster for exact results.
         Vec3                    rayMarch( const Ray& ray, f32 epsilon = 0.001f ) const;
 
         //! Returns terrain heightmap.
@@ -156,24 +180,56 @@ namespace Scene {
         //! Returns terrain chunk vertex buffer.
         VertexBuffer            chunkVertexBuffer( u32 x, u32 z ) const;
 
-        //! Returns terrain chunk index buffer.
-        IndexBuffer                chunkIndexBuffer( void ) const;
+        //! Returns terrain chunk index buffer, the buffer is built by a constructor and is shared by all chunks.
+        const IndexBuffer&        chunkIndexBuffer( void ) const;
 
         //! Creates the chunk mesh.
         Mesh                    createChunkMesh( u32 x, u32 z ) const;
 
         //! Creates the mesh for whole terrain.
-        Mesh                    createMesh( void ) const;
+        /*!
+         Vertices of all chunks are stored in a single vertex buffer and each mesh chunk renders the shared
+         chunk index buffer with its own base vertex. Chunks are generated in parallel when a task manager is passed.
+         */
+        Mesh                    createMesh( Threads::TaskManagerWPtr taskManager = Threads::TaskManagerWPtr() ) const;
+
+        //! Regenerates chunks of a mesh constructed by createMesh that are affected by changed heightmap regions.
+        /*!
+         Regions are extended by a single vertex, because normals of neighbouring vertices depend on changed heights.
+         Mesh bounds are only expanded. Returns sorted indices of updated mesh chunks, vertices of each one start at
+         a chunk base vertex.
+         */
+        Array<s32>              updateMesh( Mesh& mesh, const Heightmap::Regions& regions ) const;
+
+        //! Regenerates affected chunks of a mesh asset and uploads their vertices to a render cache, returns indices of updated chunks.
+        Array<s32>              updateMesh( MeshHandle mesh, const Heightmap::Regions& regions, RenderCacheWPtr cache ) const;
+
+        //! Uploads vertices of mesh chunks returned by updateMesh to a render cache, adjacent chunks are uploaded as a single vertex range.
+        void                    uploadChunks( const MeshHandle& mesh, const Array<s32>& chunks, RenderCacheWPtr cache ) const;
 
     private:
 
-        //! Adds the mesh node constructed from chunk buffers.
-        void                    setMeshChunk( Mesh& mesh, u32 chunk, const VertexBuffer& vertices, const IndexBuffer& indices, u32 x = 0, u32 z = 0 ) const;
+        //! A unit of work performed by a parallel mesh generation.
+        struct ChunkJob {
+            const Terrain*      terrain;    //!< A terrain to generate chunks of.
+            Mesh*               mesh;       //!< A mesh that receives chunk vertices.
+            u32                 x;          //!< A column of chunks to be generated.
+        };
+
+        //! Writes vertices of a chunk to a mesh vertex buffer starting from a specified vertex.
+        void                    generateChunkVertices( u32 x, u32 z, Mesh& mesh, s32 firstVertex, f32 originX, f32 originZ ) const;
+
+        //! Task function that generates a column of chunks.
+        static void             processChunkJob( Threads::TaskProgressWPtr progress, void* userData );
+
+        //! Builds an index buffer shared by all chunks.
+        static IndexBuffer      createChunkIndexBuffer( void );
 
     private:
 
         Heightmap                m_heightmap;    //!< Terrain heightmap.
         f32                        m_maxHeight;    //!< Maximum terrain height.
+        IndexBuffer             m_chunkIndices; //!< An index buffer shared by all chunks.
     };
 
 } // namespace Scene
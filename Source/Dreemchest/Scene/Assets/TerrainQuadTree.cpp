@@ -0,0 +1,469 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "TerrainQuadTree.h"
+#include "Mesh.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+// ** TerrainQuadTree::TerrainQuadTree
+TerrainQuadTree::TerrainQuadTree( const Terrain& terrain, s32 leafSize )
+    : m_terrain( terrain )
+    , m_leafSize( leafSize > 0 ? leafSize : Terrain::kChunkSize )
+    , m_levelCount( 1 )
+{
+    s32 size = static_cast<s32>( terrain.size() );
+    NIMBLE_BREAK_IF( size % m_leafSize != 0, "terrain size should be a multiple of a leaf size" );
+
+    // Find the smallest power of two multiple of a leaf size that covers the whole terrain
+    s32 rootSize = m_leafSize;
+
+    while( rootSize < size ) {
+        rootSize *= 2;
+        m_levelCount++;
+    }
+
+    NIMBLE_ABORT_IF( rootSize > 0xFFFF, "terrain is too large" );
+
+    // Build the quadtree and calculate node height bounds
+    buildNode( 0, 0, static_cast<u16>( rootSize ), static_cast<u8>( m_levelCount - 1 ) );
+    updateHeightBounds();
+
+    // Setup default detail level ranges
+    setLodRanges( m_leafSize * 2.0f );
+}
+
+// ** TerrainQuadTree::nodes
+const Array<TerrainQuadTree::Node>& TerrainQuadTree::nodes( void ) const
+{
+    return m_nodes;
+}
+
+// ** TerrainQuadTree::levelCount
+s32 TerrainQuadTree::levelCount( void ) const
+{
+    return m_levelCount;
+}
+
+// ** TerrainQuadTree::leafSize
+s32 TerrainQuadTree::leafSize( void ) const
+{
+    return m_leafSize;
+}
+
+// ** TerrainQuadTree::lodRange
+f32 TerrainQuadTree::lodRange( s32 level ) const
+{
+    NIMBLE_ABORT_IF( level < 0 || level >= m_levelCount, "index is out of range" );
+    return m_lodRanges[level];
+}
+
+// ** TerrainQuadTree::setLodRanges
+void TerrainQuadTree::setLodRanges( f32 distance, f32 ratio, f32 morphRatio )
+{
+    NIMBLE_BREAK_IF( distance <= 0.0f, "detail level range should be positive" );
+    NIMBLE_BREAK_IF( ratio <= 1.0f, "detail level ranges should increase" );
+
+    m_lodRanges.resize( m_levelCount );
+    m_morphStart.resize( m_levelCount );
+
+    f32 previous = 0.0f;
+
+    for( s32 i = 0; i < m_levelCount; i++ ) {
+        m_lodRanges[i]  = distance;
+        m_morphStart[i] = distance - (distance - previous) * morphRatio;
+        previous        = distance;
+        distance       *= ratio;
+    }
+}
+
+// ** TerrainQuadTree::buildNode
+u32 TerrainQuadTree::buildNode( u16 x, u16 z, u16 size, u8 level )
+{
+    u32 index = static_cast<u32>( m_nodes.size() );
+
+    Node node;
+    node.x         = x;
+    node.z         = z;
+    node.size      = size;
+    node.level     = level;
+    node.minHeight = 0.0f;
+    node.maxHeight = 0.0f;
+    node.children[0] = node.children[1] = node.children[2] = node.children[3] = 0;
+    m_nodes.push_back( node );
+
+    if( level == 0 ) {
+        return index;
+    }
+
+    // Construct children that overlap the terrain
+    u16 half    = size / 2;
+    u32 terrain = m_terrain.size();
+
+    for( s32 i = 0; i < 4; i++ ) {
+        u16 cx = x + (i & 1 ? half : 0);
+        u16 cz = z + (i & 2 ? half : 0);
+
+        if( cx >= terrain || cz >= terrain ) {
+            continue;
+        }
+
+        u32 child = buildNode( cx, cz, half, level - 1 );
+        m_nodes[index].children[i] = child;
+    }
+
+    return index;
+}
+
+// ** TerrainQuadTree::updateHeightBounds
+void TerrainQuadTree::updateHeightBounds( void )
+{
+    if( m_nodes.size() ) {
+        updateNodeBounds( 0 );
+    }
+}
+
+// ** TerrainQuadTree::updateHeightBounds
+void TerrainQuadTree::updateHeightBounds( s32 x, s32 z, s32 width, s32 height )
+{
+    if( m_nodes.size() && width > 0 && height > 0 ) {
+        refitNodeBounds( 0, x, z, x + width - 1, z + height - 1 );
+    }
+}
+
+// ** TerrainQuadTree::refitNodeBounds
+void TerrainQuadTree::refitNodeBounds( u32 index, s32 minX, s32 minZ, s32 maxX, s32 maxZ )
+{
+    Node& node = m_nodes[index];
+
+    // Border vertices are shared by adjacent nodes
+    if( node.x > maxX || node.z > maxZ || node.x + node.size < minX || node.z + node.size < minZ ) {
+        return;
+    }
+
+    if( node.level == 0 ) {
+        updateNodeBounds( index );
+        return;
+    }
+
+    // Refit overlapped children and merge bounds of all of them
+    bool first = true;
+
+    for( s32 i = 0; i < 4; i++ ) {
+        u32 child = node.children[i];
+
+        if( !child ) {
+            continue;
+        }
+
+        refitNodeBounds( child, minX, minZ, maxX, maxZ );
+
+        const Node& item = m_nodes[child];
+        node.minHeight = first ? item.minHeight : min2( node.minHeight, item.minHeight );
+        node.maxHeight = first ? item.maxHeight : max2( node.maxHeight, item.maxHeight );
+        first = false;
+    }
+}
+
+// ** TerrainQuadTree::updateNodeBounds
+void TerrainQuadTree::updateNodeBounds( u32 index )
+{
+    Node& node = m_nodes[index];
+
+    // Scan heightmap vertices covered by a leaf node
+    if( node.level == 0 ) {
+        s32 size = static_cast<s32>( m_terrain.size() );
+        s32 maxX = min2( node.x + node.size, size );
+        s32 maxZ = min2( node.z + node.size, size );
+
+        node.minHeight = node.maxHeight = m_terrain.heightAtVertex( node.x, node.z );
+
+        for( s32 z = node.z; z <= maxZ; z++ ) {
+            for( s32 x = node.x; x <= maxX; x++ ) {
+                f32 height = m_terrain.heightAtVertex( x, z );
+                node.minHeight = min2( node.minHeight, height );
+                node.maxHeight = max2( node.maxHeight, height );
+            }
+        }
+
+        return;
+    }
+
+    // Merge bounds of child nodes
+    bool first = true;
+
+    for( s32 i = 0; i < 4; i++ ) {
+        u32 child = node.children[i];
+
+        if( !child ) {
+            continue;
+        }
+
+        updateNodeBounds( child );
+
+        const Node& item = m_nodes[child];
+        node.minHeight = first ? item.minHeight : min2( node.minHeight, item.minHeight );
+        node.maxHeight = first ? item.maxHeight : max2( node.maxHeight, item.maxHeight );
+        first = false;
+    }
+}
+
+// ** TerrainQuadTree::nodeBounds
+Bounds TerrainQuadTree::nodeBounds( const Node& node ) const
+{
+    f32 size = static_cast<f32>( m_terrain.size() );
+    f32 maxX = min2( static_cast<f32>( node.x + node.size ), size );
+    f32 maxZ = min2( static_cast<f32>( node.z + node.size ), size );
+
+    return Bounds( Vec3( node.x, node.minHeight, node.z ), Vec3( maxX, node.maxHeight, maxZ ) );
+}
+
+// ** TerrainQuadTree::intersectsSphere
+bool TerrainQuadTree::intersectsSphere( const Node& node, const Vec3& center, f32 radius ) const
+{
+    Bounds bounds = nodeBounds( node );
+    const Vec3& min = bounds.min();
+    const Vec3& max = bounds.max();
+
+    // Find the closest point of a box to a sphere center
+    f32 dx = center.x < min.x ? min.x - center.x : (center.x > max.x ? center.x - max.x : 0.0f);
+    f32 dy = center.y < min.y ? min.y - center.y : (center.y > max.y ? center.y - max.y : 0.0f);
+    f32 dz = center.z < min.z ? min.z - center.z : (center.z > max.z ? center.z - max.z : 0.0f);
+
+    return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+// ** TerrainQuadTree::select
+void TerrainQuadTree::select( const Vec3& camera, const Matrix4& viewProjection, Selection& selection ) const
+{
+    const f32* m = viewProjection.m;
+    Plane planes[6];
+
+    planes[0] = Plane( m[3] - m[0], m[7] - m[4], m[11] - m[8], m[15] - m[12] );
+    planes[1] = Plane( m[3] + m[0], m[7] + m[4], m[11] + m[8], m[15] + m[12] );
+
+    planes[2] = Plane( m[3] + m[1], m[7] + m[5], m[11] + m[9], m[15] + m[13] );
+    planes[3] = Plane( m[3] - m[1], m[7] - m[5], m[11] - m[9], m[15] - m[13] );
+
+    planes[4] = Plane( m[3] - m[2], m[7] - m[6], m[11] - m[10], m[15] - m[14] );
+    planes[5] = Plane( m[3] + m[2], m[7] + m[6], m[11] + m[10], m[15] + m[14] );
+
+    select( camera, planes, 6, selection );
+}
+
+// ** TerrainQuadTree::select
+void TerrainQuadTree::select( const Vec3& camera, const Plane* planes, s32 planeCount, Selection& selection ) const
+{
+    selection.nodes.clear();
+    selection.visited   = 0;
+    selection.culled    = 0;
+    selection.triangles = 0;
+
+    if( m_nodes.size() ) {
+        selectNode( 0, camera, planes, planeCount, selection );
+    }
+}
+
+// ** TerrainQuadTree::selectNode
+bool TerrainQuadTree::selectNode( u32 index, const Vec3& camera, const Plane* planes, s32 planeCount, Selection& selection ) const
+{
+    const Node& node = m_nodes[index];
+    selection.visited++;
+
+    // A node outside of its range should be rendered by a parent node
+    if( !intersectsSphere( node, camera, m_lodRanges[node.level] ) ) {
+        return false;
+    }
+
+    // A node outside of a frustum is handled, but nothing should be rendered
+    if( planeCount ) {
+        Bounds bounds = nodeBounds( node );
+
+        for( s32 i = 0; i < planeCount; i++ ) {
+            if( planes[i].isBehind( bounds ) ) {
+                selection.culled++;
+                return true;
+            }
+        }
+    }
+
+    // Render the whole node if it is a leaf or is not close enough to be subdivided
+    if( node.level == 0 || !intersectsSphere( node, camera, m_lodRanges[node.level - 1] ) ) {
+        addSelectedNode( index, AllQuadrants, selection );
+        return true;
+    }
+
+    // Select children and render quadrants that are out of child detail level range with this node
+    u8 quadrants = 0;
+
+    for( s32 i = 0; i < 4; i++ ) {
+        u32 child = node.children[i];
+
+        if( child && !selectNode( child, camera, planes, planeCount, selection ) ) {
+            quadrants |= BIT( i );
+        }
+    }
+
+    if( quadrants ) {
+        addSelectedNode( index, quadrants, selection );
+    }
+
+    return true;
+}
+
+// ** TerrainQuadTree::addSelectedNode
+void TerrainQuadTree::addSelectedNode( u32 index, u8 quadrants, Selection& selection ) const
+{
+    const Node& node = m_nodes[index];
+
+    // Skip quadrants that do not overlap the terrain
+    if( node.level > 0 ) {
+        for( s32 i = 0; i < 4; i++ ) {
+            if( !node.children[i] ) {
+                quadrants &= ~BIT( i );
+            }
+        }
+    }
+
+    if( !quadrants ) {
+        return;
+    }
+
+    SelectedNode selected;
+    selected.node       = index;
+    selected.level      = node.level;
+    selected.quadrants  = quadrants;
+    selected.morphStart = m_morphStart[node.level];
+    selected.morphEnd   = m_lodRanges[node.level];
+    selection.nodes.push_back( selected );
+
+    // Each quadrant is a quarter of a patch grid
+    s32 quadrantCount = ((quadrants >> 0) & 1) + ((quadrants >> 1) & 1) + ((quadrants >> 2) & 1) + ((quadrants >> 3) & 1);
+    selection.triangles += quadrantCount * m_leafSize * m_leafSize / 2;
+}
+
+// ** TerrainQuadTree::morphFactor
+f32 TerrainQuadTree::morphFactor( const SelectedNode& node, const Vec3& camera, const Vec3& vertex ) const
+{
+    f32 distance = (vertex - camera).length();
+    f32 factor   = (distance - node.morphStart) / max2( node.morphEnd - node.morphStart, 0.0001f );
+    return min2( max2( factor, 0.0f ), 1.0f );
+}
+
+// ** TerrainQuadTree::createPatchMesh
+Mesh TerrainQuadTree::createPatchMesh( void ) const
+{
+    s32 stride = m_leafSize + 1;
+    s32 half   = m_leafSize / 2;
+    f32 scale  = 1.0f / m_leafSize;
+
+    NIMBLE_ABORT_IF( stride * stride > 0xFFFF, "patch grid is too large for 16-bit indices" );
+
+    // Construct a flat grid
+    Mesh::VertexBuffer vertices;
+    vertices.resize( stride * stride );
+
+    for( s32 i = 0; i <= m_leafSize; i++ ) {
+        for( s32 j = 0; j <= m_leafSize; j++ ) {
+            Mesh::Vertex& vertex = vertices[i * stride + j];
+            vertex.position = Vec3( j * scale, 0.0f, i * scale );
+            vertex.normal   = Vec3( 0.0f, 1.0f, 0.0f );
+            vertex.uv[0]    = Vec2( vertex.position.x, vertex.position.z );
+            vertex.uv[1]    = vertex.uv[0];
+        }
+    }
+
+    // Emit indices quadrant by quadrant, so each quadrant is a contiguous range of a quarter of an index buffer
+    Mesh::IndexBuffer indices;
+    indices.reserve( m_leafSize * m_leafSize * 6 );
+
+    for( s32 quadrant = 0; quadrant < 4; quadrant++ ) {
+        s32 x0 = quadrant & 1 ? half : 0;
+        s32 z0 = quadrant & 2 ? half : 0;
+
+        for( s32 i = z0; i < z0 + half; i++ ) {
+            for( s32 j = x0; j < x0 + half; j++ ) {
+                indices.push_back( static_cast<u16>( (i    ) * stride + (j    ) ) );
+                indices.push_back( static_cast<u16>( (i + 1) * stride + (j    ) ) );
+                indices.push_back( static_cast<u16>( (i    ) * stride + (j + 1) ) );
+
+                indices.push_back( static_cast<u16>( (i    ) * stride + (j + 1) ) );
+                indices.push_back( static_cast<u16>( (i + 1) * stride + (j    ) ) );
+                indices.push_back( static_cast<u16>( (i + 1) * stride + (j + 1) ) );
+            }
+        }
+    }
+
+    Mesh mesh;
+    mesh.setChunkCount( 1 );
+    mesh.setVertexBuffer( vertices );
+    mesh.setIndexBuffer( indices );
+    mesh.setChunkIndices( 0, 0, static_cast<s32>( indices.size() ) );
+    mesh.updateBounds();
+
+    return mesh;
+}
+
+// ** TerrainQuadTree::displacePatch
+void TerrainQuadTree::displacePatch( const SelectedNode& selected, const Vec3& camera, Terrain::VertexBuffer& vertices ) const
+{
+    const Node& node   = m_nodes[selected.node];
+    s32         stride = m_leafSize + 1;
+    f32         step   = static_cast<f32>( node.size ) / m_leafSize;
+    f32         size   = static_cast<f32>( m_terrain.size() );
+    f32         uvSize = 1.0f / size;
+
+    vertices.resize( stride * stride );
+
+    for( s32 i = 0; i <= m_leafSize; i++ ) {
+        for( s32 j = 0; j <= m_leafSize; j++ ) {
+            f32 x = min2( node.x + j * step, size );
+            f32 z = min2( node.z + i * step, size );
+
+            // Odd grid vertices slide towards even ones, so at the end of a range a patch matches a parent grid
+            f32 k = morphFactor( selected, camera, Vec3( x, m_terrain.height( x, z ), z ) );
+
+            if( j & 1 ) {
+                x -= step * k;
+            }
+            if( i & 1 ) {
+                z -= step * k;
+            }
+
+            Terrain::Vertex& vertex = vertices[i * stride + j];
+            vertex.position = Vec3( x, m_terrain.height( x, z ), z );
+            vertex.normal   = m_terrain.heightmap().normal( static_cast<u32>( x + 0.5f ), static_cast<u32>( z + 0.5f ) );
+            vertex.uv       = Vec2( x, z ) * uvSize;
+        }
+    }
+}
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
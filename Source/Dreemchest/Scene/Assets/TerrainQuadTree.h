@@ -0,0 +1,183 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Scene_TerrainQuadTree_H__
+#define __DC_Scene_TerrainQuadTree_H__
+
+#include "Terrain.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+    //! A continuous distance-dependent level of detail quadtree built over a terrain heightmap.
+    /*!
+     Each quadtree node covers a square region of a heightmap and stores minimum and maximum heights of this region.
+     Leaf nodes cover a single patch, each parent node covers four times more area and is rendered with the same
+     patch grid, so a single patch mesh is shared by all detail levels and is scaled and displaced per node.
+
+     Nodes are selected on a CPU by a camera distance, each detail level has a visibility range and vertices of
+     a selected node are morphed to a grid of a parent level when approaching the end of this range, so there
+     are no popping artifacts and no cracks between neighbouring nodes of different levels.
+     */
+    class TerrainQuadTree {
+    public:
+
+        //! Quadrants of a node.
+        enum Quadrant {
+              QuadrantNearLeft  = BIT( 0 )  //!< A quadrant at a minimum X and minimum Z coordinates.
+            , QuadrantNearRight = BIT( 1 )  //!< A quadrant at a maximum X and minimum Z coordinates.
+            , QuadrantFarLeft   = BIT( 2 )  //!< A quadrant at a minimum X and maximum Z coordinates.
+            , QuadrantFarRight  = BIT( 3 )  //!< A quadrant at a maximum X and maximum Z coordinates.
+            , AllQuadrants      = QuadrantNearLeft | QuadrantNearRight | QuadrantFarLeft | QuadrantFarRight
+        };
+
+        //! A quadtree node.
+        struct Node {
+            u16                 x;              //!< A node origin on a heightmap along the X axis.
+            u16                 z;              //!< A node origin on a heightmap along the Z axis.
+            u16                 size;           //!< A node size in heightmap cells.
+            u8                  level;          //!< A node detail level, leaf nodes have a zero level.
+            f32                 minHeight;      //!< The minimum terrain height inside a node.
+            f32                 maxHeight;      //!< The maximum terrain height inside a node.
+            u32                 children[4];    //!< Child node indices ordered by quadrant, a zero index stands for a missing child.
+        };
+
+        //! A node selected for rendering.
+        struct SelectedNode {
+            u32                 node;           //!< A selected node index.
+            u8                  level;          //!< A node detail level.
+            u8                  quadrants;      //!< A mask of node quadrants to be rendered.
+            f32                 morphStart;     //!< A camera distance where vertices start morphing to a parent grid.
+            f32                 morphEnd;       //!< A camera distance where vertices are completely morphed to a parent grid.
+        };
+
+        //! Container type to store selected nodes.
+        typedef Array<SelectedNode> SelectedNodes;
+
+        //! A result of a quadtree node selection.
+        struct Selection {
+                                //! Constructs Selection instance.
+                                Selection( void )
+                                    : visited( 0 ), culled( 0 ), triangles( 0 ) {}
+
+            SelectedNodes       nodes;          //!< Selected nodes.
+            s32                 visited;        //!< The total number of visited nodes.
+            s32                 culled;         //!< The total number of nodes rejected by a frustum.
+            s32                 triangles;      //!< The total number of triangles to be rendered.
+        };
+
+                                //! Constructs TerrainQuadTree instance.
+                                /*!
+                                 \param terrain A terrain to build the quadtree for.
+                                 \param leafSize The size of a leaf node and a patch grid resolution, the terrain chunk size is used by default.
+                                 */
+                                TerrainQuadTree( const Terrain& terrain, s32 leafSize = 0 );
+
+        //! Returns quadtree nodes, the root node is always the first one.
+        const Array<Node>&      nodes( void ) const;
+
+        //! Returns the total number of detail levels.
+        s32                     levelCount( void ) const;
+
+        //! Returns the leaf node size.
+        s32                     leafSize( void ) const;
+
+        //! Returns the visibility range of a specified detail level.
+        f32                     lodRange( s32 level ) const;
+
+        //! Calculates visibility ranges of all detail levels.
+        /*!
+         \param distance The visibility range of the most detailed level.
+         \param ratio The visibility range of each next level is this times larger than the previous one.
+         \param morphRatio A fraction of each detail level range where vertices are morphed to a parent grid.
+         */
+        void                    setLodRanges( f32 distance, f32 ratio = 2.0f, f32 morphRatio = 0.3f );
+
+        //! Recalculates height bounds of all nodes from a terrain heightmap.
+        void                    updateHeightBounds( void );
+
+        //! Recalculates height bounds of nodes that contain changed heightmap vertices inside a specified rectangle.
+        void                    updateHeightBounds( s32 x, s32 z, s32 width, s32 height );
+
+        //! Selects nodes to be rendered from a specified camera position, nodes outside a view frustum are skipped.
+        void                    select( const Vec3& camera, const Matrix4& viewProjection, Selection& selection ) const;
+
+        //! Selects nodes to be rendered from a specified camera position, nodes that are behind any of clipping planes are skipped.
+        void                    select( const Vec3& camera, const Plane* planes, s32 planeCount, Selection& selection ) const;
+
+        //! Returns a bounding box of a node.
+        Bounds                  nodeBounds( const Node& node ) const;
+
+        //! Returns a morph factor of a vertex from 0 (node grid) to 1 (parent grid).
+        f32                     morphFactor( const SelectedNode& node, const Vec3& camera, const Vec3& vertex ) const;
+
+        //! Creates a patch mesh shared by all nodes, the patch is a flat grid with vertex positions in a [0, 1] range.
+        Mesh                    createPatchMesh( void ) const;
+
+        //! Writes displaced and morphed vertices of a selected node to an output buffer.
+        /*!
+         This function does on a CPU the same work as a terrain vertex shader does, each patch vertex is scaled to
+         a node size, morphed to a parent grid by a camera distance and displaced by a heightmap.
+         */
+        void                    displacePatch( const SelectedNode& node, const Vec3& camera, Terrain::VertexBuffer& vertices ) const;
+
+    private:
+
+        //! Recursively constructs a node and returns its index.
+        u32                     buildNode( u16 x, u16 z, u16 size, u8 level );
+
+        //! Calculates height bounds of a node and all of its children.
+        void                    updateNodeBounds( u32 index );
+
+        //! Recalculates height bounds of a node and its children that overlap an inclusive rectangle of vertices.
+        void                    refitNodeBounds( u32 index, s32 minX, s32 minZ, s32 maxX, s32 maxZ );
+
+        //! Recursively selects nodes, returns false if a node is outside of its detail level range.
+        bool                    selectNode( u32 index, const Vec3& camera, const Plane* planes, s32 planeCount, Selection& selection ) const;
+
+        //! Adds a node to a selection.
+        void                    addSelectedNode( u32 index, u8 quadrants, Selection& selection ) const;
+
+        //! Returns true if a sphere intersects a node bounding box.
+        bool                    intersectsSphere( const Node& node, const Vec3& center, f32 radius ) const;
+
+    private:
+
+        const Terrain&          m_terrain;      //!< A parent terrain.
+        s32                     m_leafSize;     //!< The leaf node size.
+        s32                     m_levelCount;   //!< The total number of detail levels.
+        Array<Node>             m_nodes;        //!< Quadtree nodes.
+        Array<f32>              m_lodRanges;    //!< Visibility ranges of detail levels.
+        Array<f32>              m_morphStart;   //!< Morph start distances of detail levels.
+    };
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Scene_TerrainQuadTree_H__    */
@@ -0,0 +1,374 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "TerrainRayCaster.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+//! Returns a dot product of two vectors.
+static f32 dot( const Vec3& a, const Vec3& b )
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// ** TerrainRayCaster::TerrainRayCaster
+TerrainRayCaster::TerrainRayCaster( const Terrain& terrain )
+    : m_terrain( terrain )
+{
+    build();
+}
+
+// ** TerrainRayCaster::levelCount
+s32 TerrainRayCaster::levelCount( void ) const
+{
+    return static_cast<s32>( m_levels.size() );
+}
+
+// ** TerrainRayCaster::build
+void TerrainRayCaster::build( void )
+{
+    m_levels.clear();
+
+    s32 size = static_cast<s32>( m_terrain.size() );
+
+    if( size == 0 ) {
+        return;
+    }
+
+    // Allocate levels until a single cell covers the whole heightmap
+    for( s32 cells = size; ; cells = (cells + 1) / 2 ) {
+        Level level;
+        level.size = cells;
+        level.cells.resize( cells * cells );
+        m_levels.push_back( level );
+
+        if( cells == 1 ) {
+            break;
+        }
+    }
+
+    update( 0, 0, size + 1, size + 1 );
+}
+
+// ** TerrainRayCaster::update
+void TerrainRayCaster::update( s32 x, s32 z, s32 width, s32 height )
+{
+    if( m_levels.empty() ) {
+        return;
+    }
+
+    // A changed vertex affects all cells that share it
+    s32 x0 = x - 1;
+    s32 z0 = z - 1;
+    s32 x1 = x + width - 1;
+    s32 z1 = z + height - 1;
+
+    for( s32 level = 0, n = levelCount(); level < n; level++ ) {
+        s32 size = m_levels[level].size;
+
+        s32 minX = max2( x0, 0 );
+        s32 minZ = max2( z0, 0 );
+        s32 maxX = min2( x1, size - 1 );
+        s32 maxZ = min2( z1, size - 1 );
+
+        for( s32 j = minZ; j <= maxZ; j++ ) {
+            for( s32 i = minX; i <= maxX; i++ ) {
+                updateCell( level, i, j );
+            }
+        }
+
+        // Switch to a range of parent cells
+        x0 = max2( x0, 0 ) / 2;
+        z0 = max2( z0, 0 ) / 2;
+        x1 = x1 / 2;
+        z1 = z1 / 2;
+    }
+}
+
+// ** TerrainRayCaster::updateCell
+void TerrainRayCaster::updateCell( s32 level, s32 x, s32 z )
+{
+    Range& range = m_levels[level].cells[z * m_levels[level].size + x];
+
+    // The first level is calculated from cell corners
+    if( level == 0 ) {
+        f32 h00 = m_terrain.heightAtVertex( x,     z     );
+        f32 h10 = m_terrain.heightAtVertex( x + 1, z     );
+        f32 h01 = m_terrain.heightAtVertex( x,     z + 1 );
+        f32 h11 = m_terrain.heightAtVertex( x + 1, z + 1 );
+
+        range.min = min2( min2( h00, h10 ), min2( h01, h11 ) );
+        range.max = max2( max2( h00, h10 ), max2( h01, h11 ) );
+        return;
+    }
+
+    // Merge up to four cells of a previous level
+    const Level& child = m_levels[level - 1];
+    bool first = true;
+
+    for( s32 j = z * 2; j <= min2( z * 2 + 1, child.size - 1 ); j++ ) {
+        for( s32 i = x * 2; i <= min2( x * 2 + 1, child.size - 1 ); i++ ) {
+            const Range& item = child.cells[j * child.size + i];
+            range.min = first ? item.min : min2( range.min, item.min );
+            range.max = first ? item.max : max2( range.max, item.max );
+            first = false;
+        }
+    }
+}
+
+// ** TerrainRayCaster::vertex
+Vec3 TerrainRayCaster::vertex( s32 x, s32 z ) const
+{
+    return Vec3( static_cast<f32>( x ), m_terrain.heightAtVertex( x, z ), static_cast<f32>( z ) );
+}
+
+// ** TerrainRayCaster::intersectCell
+bool TerrainRayCaster::intersectCell( s32 level, s32 x, s32 z, const Vec3& origin, const Vec3& direction, f32 maxDistance, f32& distance ) const
+{
+    const Range& range = m_levels[level].cells[z * m_levels[level].size + x];
+    f32          size  = static_cast<f32>( m_terrain.size() );
+
+    f32 min[3] = { static_cast<f32>( x << level ), range.min, static_cast<f32>( z << level ) };
+    f32 max[3] = { min2( static_cast<f32>( (x + 1) << level ), size ), range.max, min2( static_cast<f32>( (z + 1) << level ), size ) };
+    f32 o[3]   = { origin.x, origin.y, origin.z };
+    f32 d[3]   = { direction.x, direction.y, direction.z };
+
+    f32 tmin = 0.0f;
+    f32 tmax = maxDistance;
+
+    // Clip a ray segment by slabs of a cell box
+    for( s32 i = 0; i < 3; i++ ) {
+        if( fabs( d[i] ) < 1e-12f ) {
+            if( o[i] < min[i] || o[i] > max[i] ) {
+                return false;
+            }
+            continue;
+        }
+
+        f32 inv = 1.0f / d[i];
+        f32 t0  = (min[i] - o[i]) * inv;
+        f32 t1  = (max[i] - o[i]) * inv;
+
+        if( t0 > t1 ) {
+            f32 t = t0; t0 = t1; t1 = t;
+        }
+
+        tmin = max2( tmin, t0 );
+        tmax = min2( tmax, t1 );
+
+        if( tmin > tmax ) {
+            return false;
+        }
+    }
+
+    distance = tmin;
+    return true;
+}
+
+// ** TerrainRayCaster::intersectTriangles
+bool TerrainRayCaster::intersectTriangles( s32 x, s32 z, const Vec3& origin, const Vec3& direction, f32& distance, Vec3& normal ) const
+{
+    // Cells are split the same way as chunk index buffers do
+    Vec3 triangles[2][3] = {
+          { vertex( x,     z ), vertex( x, z + 1 ), vertex( x + 1, z     ) }
+        , { vertex( x + 1, z ), vertex( x, z + 1 ), vertex( x + 1, z + 1 ) }
+    };
+
+    bool found = false;
+
+    for( s32 i = 0; i < 2; i++ ) {
+        const Vec3* v = triangles[i];
+
+        // Moller-Trumbore ray and triangle intersection
+        Vec3 e1 = v[1] - v[0];
+        Vec3 e2 = v[2] - v[0];
+        Vec3 p  = direction % e2;
+        f32  det = dot( e1, p );
+
+        if( fabs( det ) < 1e-12f ) {
+            continue;
+        }
+
+        f32  inv = 1.0f / det;
+        Vec3 s   = origin - v[0];
+        f32  u   = dot( s, p ) * inv;
+
+        if( u < 0.0f || u > 1.0f ) {
+            continue;
+        }
+
+        Vec3 q = s % e1;
+        f32  w = dot( direction, q ) * inv;
+
+        if( w < 0.0f || u + w > 1.0f ) {
+            continue;
+        }
+
+        f32 t = dot( e2, q ) * inv;
+
+        if( t < 0.0f || t > distance ) {
+            continue;
+        }
+
+        distance = t;
+        normal   = e1 % e2;
+        found    = true;
+    }
+
+    if( found ) {
+        // Triangles are wound clockwise when viewed from above, so flip a normal to point upwards
+        if( normal.y < 0.0f ) {
+            normal = normal * -1.0f;
+        }
+        normal.normalize();
+    }
+
+    return found;
+}
+
+// ** TerrainRayCaster::cast
+bool TerrainRayCaster::cast( const Ray& ray, Hit& hit, f32 maxDistance ) const
+{
+    if( m_levels.empty() ) {
+        return false;
+    }
+
+    Vec3 direction = ray.direction();
+    f32  length    = direction.length();
+
+    if( length <= 0.0f ) {
+        return false;
+    }
+
+    direction = direction * (1.0f / length);
+
+    //! A pyramid cell queued for a traversal.
+    struct Item {
+        s32     level;      //!< A cell level.
+        s32     x;          //!< A cell coordinate along the X axis.
+        s32     z;          //!< A cell coordinate along the Z axis.
+        f32     distance;   //!< A distance where a ray enters a cell.
+    };
+
+    // Each visited level pushes at most four cells, a stack is enough for 2^32 terrains
+    Item stack[32 * 4];
+    s32  top = 0;
+
+    const Vec3& origin   = ray.origin();
+    f32         closest  = maxDistance;
+    bool        found    = false;
+    s32         root     = levelCount() - 1;
+    f32         distance;
+
+    if( !intersectCell( root, 0, 0, origin, direction, closest, distance ) ) {
+        return false;
+    }
+
+    Item item = { root, 0, 0, distance };
+    stack[top++] = item;
+
+    while( top ) {
+        Item cell = stack[--top];
+
+        // A closer hit was found after this cell was queued
+        if( cell.distance > closest ) {
+            continue;
+        }
+
+        // Test triangles of a heightmap cell
+        if( cell.level == 0 ) {
+            if( intersectTriangles( cell.x, cell.z, origin, direction, closest, hit.normal ) ) {
+                hit.x = cell.x;
+                hit.z = cell.z;
+                found = true;
+            }
+            continue;
+        }
+
+        // Queue intersected children sorted from far to near, so the nearest one is processed first
+        const Level& child = m_levels[cell.level - 1];
+        Item         children[4];
+        s32          count = 0;
+
+        for( s32 i = 0; i < 4; i++ ) {
+            s32 x = cell.x * 2 + (i & 1);
+            s32 z = cell.z * 2 + (i >> 1);
+
+            if( x >= child.size || z >= child.size ) {
+                continue;
+            }
+
+            if( !intersectCell( cell.level - 1, x, z, origin, direction, closest, distance ) ) {
+                continue;
+            }
+
+            Item next = { cell.level - 1, x, z, distance };
+            s32  j    = count++;
+
+            for( ; j > 0 && children[j - 1].distance < distance; j-- ) {
+                children[j] = children[j - 1];
+            }
+            children[j] = next;
+        }
+
+        for( s32 i = 0; i < count; i++ ) {
+            stack[top++] = children[i];
+        }
+    }
+
+    if( found ) {
+        hit.distance = closest;
+        hit.point    = origin + direction * closest;
+    }
+
+    return found;
+}
+
+// ** TerrainRayCaster::castBatch
+s32 TerrainRayCaster::castBatch( const Ray* rays, s32 count, Hit* hits, bool* results, f32 maxDistance ) const
+{
+    s32 total = 0;
+
+    for( s32 i = 0; i < count; i++ ) {
+        bool result = cast( rays[i], hits[i], maxDistance );
+
+        if( results ) {
+            results[i] = result;
+        }
+        if( result ) {
+            total++;
+        }
+    }
+
+    return total;
+}
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
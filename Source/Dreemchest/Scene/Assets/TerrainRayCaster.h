@@ -0,0 +1,117 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Scene_TerrainRayCaster_H__
+#define __DC_Scene_TerrainRayCaster_H__
+
+#include "Terrain.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+    //! Casts rays against a terrain heightmap using a min-max height pyramid.
+    /*!
+     The first pyramid level stores minimum and maximum heights of each heightmap cell, each next level
+     stores bounds of 2x2 blocks of a previous one. A ray descends the pyramid front to back skipping blocks
+     that it passes above or below and is tested against two triangles of each reached cell, so a returned
+     point is exactly on a terrain surface that is rendered from chunk meshes.
+     */
+    class TerrainRayCaster {
+    public:
+
+        //! A ray cast result.
+        struct Hit {
+            f32                 distance;   //!< A distance from a ray origin to an intersection point.
+            Vec3                point;      //!< An intersection point.
+            Vec3                normal;     //!< A normal of an intersected triangle.
+            s32                 x;          //!< An intersected cell coordinate along the X axis.
+            s32                 z;          //!< An intersected cell coordinate along the Z axis.
+        };
+
+                                //! Constructs TerrainRayCaster instance and builds a height pyramid.
+                                TerrainRayCaster( const Terrain& terrain );
+
+        //! Returns the total number of pyramid levels.
+        s32                     levelCount( void ) const;
+
+        //! Rebuilds the whole height pyramid.
+        void                    build( void );
+
+        //! Updates the height pyramid after heightmap vertices inside a specified rectangle were changed.
+        void                    update( s32 x, s32 z, s32 width, s32 height );
+
+        //! Finds the closest intersection of a ray with a terrain, returns false if there is no intersection closer than a maximum distance.
+        bool                    cast( const Ray& ray, Hit& hit, f32 maxDistance = FLT_MAX ) const;
+
+        //! Casts an array of rays and writes a result of each one to an output array, returns the total number of hits.
+        /*!
+         \param rays Rays to be casted.
+         \param count The total number of rays.
+         \param hits An output array of ray hits.
+         \param results An optional output array that receives a hit flag of each ray.
+         \param maxDistance The maximum intersection distance.
+         */
+        s32                     castBatch( const Ray* rays, s32 count, Hit* hits, bool* results = NULL, f32 maxDistance = FLT_MAX ) const;
+
+    private:
+
+        //! Minimum and maximum heights of a pyramid cell.
+        struct Range {
+            f32                 min;        //!< The minimum height.
+            f32                 max;        //!< The maximum height.
+        };
+
+        //! A pyramid level.
+        struct Level {
+            s32                 size;       //!< A level size in cells.
+            Array<Range>        cells;      //!< Level cells.
+        };
+
+        //! Calculates a cell range of a specified level from a lower level or a heightmap.
+        void                    updateCell( s32 level, s32 x, s32 z );
+
+        //! Returns a parametric range where a ray passes through a pyramid cell, returns false if a ray misses it.
+        bool                    intersectCell( s32 level, s32 x, s32 z, const Vec3& origin, const Vec3& direction, f32 maxDistance, f32& distance ) const;
+
+        //! Tests a ray against two triangles of a heightmap cell and updates a hit if a closer intersection is found.
+        bool                    intersectTriangles( s32 x, s32 z, const Vec3& origin, const Vec3& direction, f32& distance, Vec3& normal ) const;
+
+        //! Returns a vertex position of a heightmap.
+        Vec3                    vertex( s32 x, s32 z ) const;
+
+    private:
+
+        const Terrain&          m_terrain;  //!< A parent terrain.
+        Array<Level>            m_levels;   //!< Height pyramid levels, the first one stores heightmap cells.
+    };
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Scene_TerrainRayCaster_H__    */
@@ -64,6 +64,7 @@ ForwardRenderer::ForwardRenderer( s32 shadowSize, s32 shadowCascadeCount )
     , m_shadowCascadeCount( shadowCascadeCount )
     , m_shadowCascadeLambda( 0.5f )
     , m_debugCascadeShadows( false )
+    , m_occlusionCulling( false )
 {
 }
 
@@ -115,6 +116,18 @@ void ForwardRenderer::setShadowCascadeLambda( f32 value )
     m_shadowCascadeLambda = value;
 }
 
+// ** ForwardRenderer::isOcclusionCulling
+bool ForwardRenderer::isOcclusionCulling( void ) const
+{
+    return m_occlusionCulling;
+}
+
+// ** ForwardRenderer::setOcclusionCulling
+void ForwardRenderer::setOcclusionCulling( bool value )
+{
+    m_occlusionCulling = value;
+}
+
 // -------------------------------------------------------------- DebugRenderer -------------------------------------------------------------- //
 
 // ** DebugRenderer::DebugRenderer
@@ -259,6 +272,7 @@ void StaticMesh::setMesh( const MeshHandle& value )
 {
     NIMBLE_ABORT_IF( !value.isValid(), "invalid mesh" );
     m_mesh = value;
+    markChanged();
 }
 
 // ** StaticMesh::worldSpaceBounds
@@ -273,6 +287,18 @@ void StaticMesh::setWorldSpaceBounds( const Bounds& value )
     m_worldSpaceBounds = value;
 }
 
+// ** StaticMesh::isOccluder
+bool StaticMesh::isOccluder( void ) const
+{
+    return m_isOccluder;
+}
+
+// ** StaticMesh::setOccluder
+void StaticMesh::setOccluder( bool value )
+{
+    m_isOccluder = value;
+}
+
 // ** StaticMesh::setMaterial
 void StaticMesh::setMaterial( u32 index, MaterialHandle value )
 {
@@ -299,6 +325,69 @@ void StaticMesh::setLightmap( const Renderer::TexturePtr& value )
 }
 #endif  /*  #if DEV_DEPRECATED_HAL  */
 
+// ------------------------------------------- LodGroup ----------------------------------------- //
+
+// ** LodGroup::LodGroup
+LodGroup::LodGroup( f32 hysteresis )
+    : m_hysteresis( hysteresis )
+    , m_crossFade( false )
+    , m_crossFadeFrames( 30 )
+{
+}
+
+// ** LodGroup::mesh
+const MeshHandle& LodGroup::mesh( s32 index ) const
+{
+    NIMBLE_ABORT_IF( index < 0 || index >= levelCount(), "index is out of range" );
+    return m_meshes[index];
+}
+
+// ** LodGroup::addLevel
+void LodGroup::addLevel( const MeshHandle& mesh, f32 screenSize )
+{
+    NIMBLE_ABORT_IF( !m_screenSizes.empty() && screenSize > m_screenSizes.back(), "levels should be added from the finest one" );
+    m_meshes.push_back( mesh );
+    m_screenSizes.push_back( screenSize );
+}
+
+// ** LodGroup::hysteresis
+f32 LodGroup::hysteresis( void ) const
+{
+    return m_hysteresis;
+}
+
+// ** LodGroup::setHysteresis
+void LodGroup::setHysteresis( f32 value )
+{
+    NIMBLE_ABORT_IF( value < 0.0f || value >= 1.0f, "hysteresis should be in [0, 1) range" );
+    m_hysteresis = value;
+}
+
+// ** LodGroup::isCrossFade
+bool LodGroup::isCrossFade( void ) const
+{
+    return m_crossFade;
+}
+
+// ** LodGroup::setCrossFade
+void LodGroup::setCrossFade( bool value )
+{
+    m_crossFade = value;
+}
+
+// ** LodGroup::crossFadeFrames
+s32 LodGroup::crossFadeFrames( void ) const
+{
+    return m_crossFadeFrames;
+}
+
+// ** LodGroup::setCrossFadeFrames
+void LodGroup::setCrossFadeFrames( s32 value )
+{
+    NIMBLE_ABORT_IF( value <= 0, "a cross-fade should last at least one frame" );
+    m_crossFadeFrames = value;
+}
+
 // ------------------------------------------- PointCloud ----------------------------------------- //
 
 // ** PointCloud::PointCloud
@@ -89,12 +89,19 @@ namespace Scene
         //! Sets a parameter value used by a splitting planes calculation function, should be in [0, 1] range.
         void                            setShadowCascadeLambda( f32 value );
 
+        //! Returns true if static meshes hidden behind occluders are skipped.
+        bool                            isOcclusionCulling( void ) const;
+
+        //! Enables or disables a software occlusion culling of static meshes.
+        void                            setOcclusionCulling( bool value );
+
     private:
 
         s32                             m_shadowSize;           //!< A shadow texture size.
         s32                             m_shadowCascadeCount;   //!< A total number of cascades a camera frustum is split to.
         f32                             m_shadowCascadeLambda;  //!< An interpolation factor between linear and logarithmic splitting schemes.
         bool                            m_debugCascadeShadows;  //!< Enables a debug rendering of cascaded shadowmaps.
+        bool                            m_occlusionCulling;     //!< Enables a software occlusion culling of static meshes.
     };
 
     //! This component is attached to a camera to render a debug info.
@@ -206,6 +213,7 @@ namespace Scene
                                         //! Constructs StaticMesh instance.
                                         StaticMesh( const MeshHandle mesh = MeshHandle() )
                                             : m_mesh( mesh )
+                                            , m_isOccluder( false )
                                             {
                                             }
 
@@ -221,6 +229,12 @@ namespace Scene
         //! Sets the mesh world space bounding box.
         void                            setWorldSpaceBounds( const Bounds& value );
 
+        //! Returns true if the mesh hides other meshes during an occlusion culling.
+        bool                            isOccluder( void ) const;
+
+        //! Marks the mesh as an occluder, should be set only for large closed meshes like walls and buildings.
+        void                            setOccluder( bool value );
+
         //! Returns the total number of materials.
         u32                             materialCount( void ) const;
 
@@ -242,6 +256,7 @@ namespace Scene
 
         MeshHandle                      m_mesh;                 //!< Mesh to be rendered.
         Bounds                          m_worldSpaceBounds;     //!< Mesh world space bounding box.
+        bool                            m_isOccluder;           //!< Indicates that the mesh is rasterized to an occlusion depth buffer.
         Array<MaterialHandle>           m_materials;            //!< Mesh materials array.
     #if DEV_DEPRECATED_HAL
         Renderer::TexturePtr            m_lightmap;             //!< Lightmap texture that is rendered for this mesh.
@@ -261,6 +276,65 @@ namespace Scene
         return index < materialCount() ? m_materials[index] : Invalid;
     }
 
+    //! Holds meshes that replace a static mesh when its projected screen size gets smaller.
+    class LodGroup : public Ecs::Component<LodGroup>
+    {
+    public:
+
+                                        //! Constructs LodGroup instance.
+                                        LodGroup( f32 hysteresis = 0.1f );
+
+        //! Returns the total number of levels.
+        s32                             levelCount( void ) const;
+
+        //! Returns a mesh of a level.
+        const MeshHandle&               mesh( s32 index ) const;
+
+        //! Returns a minimum fraction of a viewport height covered by a mesh to be rendered with a level.
+        f32                             screenSize( s32 index ) const;
+
+        //! Adds a new level that is coarser than all previous ones, a mesh is culled when it gets smaller than the last level.
+        void                            addLevel( const MeshHandle& mesh, f32 screenSize );
+
+        //! Returns a relative width of a band around each level threshold that prevents levels from popping back and forth.
+        f32                             hysteresis( void ) const;
+
+        //! Sets a relative width of a hysteresis band, should be in [0, 1) range.
+        void                            setHysteresis( f32 value );
+
+        //! Returns true if levels are switched with a dithered cross-fade.
+        bool                            isCrossFade( void ) const;
+
+        //! Enables or disables a dithered cross-fade between levels.
+        void                            setCrossFade( bool value );
+
+        //! Returns the total number of frames a cross-fade lasts.
+        s32                             crossFadeFrames( void ) const;
+
+        //! Sets the total number of frames a cross-fade lasts.
+        void                            setCrossFadeFrames( s32 value );
+
+    private:
+
+        Array<MeshHandle>               m_meshes;               //!< Level meshes ordered from the finest one.
+        Array<f32>                      m_screenSizes;          //!< Minimum screen sizes of levels.
+        f32                             m_hysteresis;           //!< A relative width of a hysteresis band.
+        bool                            m_crossFade;            //!< Enables a dithered cross-fade between levels.
+        s32                             m_crossFadeFrames;      //!< The total number of frames a cross-fade lasts.
+    };
+
+    // ** LodGroup::levelCount
+    NIMBLE_INLINE s32 LodGroup::levelCount( void ) const
+    {
+        return static_cast<s32>( m_screenSizes.size() );
+    }
+
+    // ** LodGroup::screenSize
+    NIMBLE_INLINE f32 LodGroup::screenSize( s32 index ) const
+    {
+        return m_screenSizes[index];
+    }
+
     //! Holds a point cloud.
     class PointCloud : public Ecs::Component<PointCloud>
     {
@@ -73,7 +73,13 @@ const Matrix4& Transform::matrix( void ) const
 // ** Transform::setMatrix
 void Transform::setMatrix( const Matrix4& value )
 {
+    // Only an actual change is reported to queries, so static transforms are not revisited
+    if( memcmp( &m_transform, &value, sizeof( Matrix4 ) ) == 0 ) {
+        return;
+    }
+
     m_transform = value;
+    markChanged();
 }
 
 // ** Transform::parent
@@ -297,7 +303,32 @@ const String& Identifier::name( void ) const
 // ** Identifier::setName
 void Identifier::setName( const String& value )
 {
-    m_name = value;
+    m_name   = value;
+    m_nameId = Ecs::NameTable::intern( value );
+
+    if( m_entity.valid() ) {
+        m_entity->setNameId( m_nameId );
+    }
+}
+
+// ** Identifier::nameId
+Ecs::NameId Identifier::nameId( void ) const
+{
+    return m_nameId;
+}
+
+// ** Identifier::setParentEntity
+void Identifier::setParentEntity( const Ecs::EntityWPtr& value )
+{
+    if( m_entity.valid() && !value.valid() ) {
+        m_entity->setNameId( 0 );
+    }
+
+    Ecs::ComponentBase::setParentEntity( value );
+
+    if( value.valid() ) {
+        value->setNameId( m_nameId );
+    }
 }
 
 // --------------------------------------------- MoveAlongAxes --------------------------------------------- //
@@ -204,7 +204,7 @@ namespace Scene {
 
                                 //! Constructs the Identifier instance.
                                 Identifier( const String& name = "" )
-                                    : m_name( name ) {}
+                                    : m_name( name ), m_nameId( Ecs::NameTable::intern( name ) ) {}
 
         //! Returns the identifier.
         const String&            name( void ) const;
@@ -212,9 +212,18 @@ namespace Scene {
         //! Sets the identifier.
         void                    setName( const String& value );
 
+        //! Returns the interned identifier.
+        Ecs::NameId             nameId( void ) const;
+
+    protected:
+
+        //! Registers a scene object name when this component is attached and unregisters it once detached.
+        virtual void            setParentEntity( const Ecs::EntityWPtr& value ) NIMBLE_OVERRIDE;
+
     private:
 
         String                    m_name;    //!< Scene object name.
+        Ecs::NameId             m_nameId;   //!< Interned scene object name.
     };
 
     //! Moves the scene object transform along the coordinate axes.
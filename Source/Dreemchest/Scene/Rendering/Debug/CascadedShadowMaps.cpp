@@ -30,6 +30,9 @@ DC_BEGIN_DREEMCHEST
 
 namespace Scene {
 
+//! A distance a cascade volume is extruded toward the light to capture casters that are outside of a view frustum.
+static const f32 kLightSpaceExtrusion = 50.0f;
+
 // ** CascadedShadowMaps::CascadedShadowMaps
 CascadedShadowMaps::CascadedShadowMaps( void )
     : m_textureSize( 0 )
@@ -79,7 +82,8 @@ void CascadedShadowMaps::calculate( f32 fov, f32 near, f32 far, f32 aspect, f32
         cascade.worldSpaceBounds = calculateWorldSpaceBounds( fov, cascade.near, cascade.far, aspect );
 
         // Calculate a cascade projection matrix
-        cascade.transform = calculateViewProjection( cascade.worldSpaceBounds );
+        cascade.lightSpaceBounds = calculateLightSpaceBounds( cascade.worldSpaceBounds );
+        cascade.transform        = calculateViewProjection( cascade.lightSpaceBounds );
 
         // Calculate light space vertices
         calculateLightSpaceVertices( cascade.transform, cascade.lightSpaceVertices );
@@ -99,6 +103,44 @@ const CascadedShadowMaps::Cascade& CascadedShadowMaps::cascadeAt( s32 index ) co
     return m_cascades[index];
 }
 
+// ** CascadedShadowMaps::cullCasters
+void CascadedShadowMaps::cullCasters( const Bounds* worldSpaceBounds, s32 count, Array<Casters>& casters ) const
+{
+    s32 cascades = cascadeCount();
+
+    casters.resize( cascades );
+
+    for( s32 i = 0; i < cascades; i++ ) {
+        casters[i].clear();
+    }
+
+    // Compute an inverse of a light matrix
+    Matrix4 inverseLight = m_light.inversed();
+
+    for( s32 i = 0; i < count; i++ ) {
+        // Transform caster bounds to a light space
+        Bounds bounds = worldSpaceBounds[i] * inverseLight;
+        const Vec3& min = bounds.min();
+        const Vec3& max = bounds.max();
+
+        // Cascades are ordered from the finest one to the coarsest one
+        for( s32 j = 0; j < cascades; j++ ) {
+            const Bounds& volume = m_cascades[j].lightSpaceBounds;
+
+            if( max.x < volume.min().x || min.x > volume.max().x || max.y < volume.min().y || min.y > volume.max().y || max.z < volume.min().z || min.z > volume.max().z ) {
+                continue;
+            }
+
+            casters[j].push_back( i );
+
+            // A caster is completely captured by this cascade, so skip coarser ones
+            if( min.x >= volume.min().x && max.x <= volume.max().x && min.y >= volume.min().y && max.y <= volume.max().y && min.z >= volume.min().z && max.z <= volume.max().z ) {
+                break;
+            }
+        }
+    }
+}
+
 // ** CascadedShadowMaps::resize
 void CascadedShadowMaps::resize( s32 count )
 {
@@ -158,8 +200,8 @@ void CascadedShadowMaps::calculateLightSpaceVertices( const Matrix4& viewProject
     }
 }
 
-// ** CascadedShadowMaps::calculateViewProjection
-Matrix4 CascadedShadowMaps::calculateViewProjection( const BoundingVolume& worldSpaceBounds ) const
+// ** CascadedShadowMaps::calculateLightSpaceBounds
+Bounds CascadedShadowMaps::calculateLightSpaceBounds( const BoundingVolume& worldSpaceBounds ) const
 {
     // Compute an inverse of a light matrix
     Matrix4 inverseLight = m_light.inversed();
@@ -171,12 +213,25 @@ Matrix4 CascadedShadowMaps::calculateViewProjection( const BoundingVolume& world
     Bounds lightSpaceBounds = worldSpaceBounds * inverseLight;
 #endif  /*  #if DEV_CSM_BOUNDING_SPHERES    */
 
-    // Calculate a projection matrix based on a light-space cascade bounding box
+    // Extrude a volume toward the light
+    const Vec3& min = lightSpaceBounds.min();
+    const Vec3& max = lightSpaceBounds.max();
+
+    return Bounds( min, Vec3( max.x, max.y, max.z + kLightSpaceExtrusion ) );
+}
+
+// ** CascadedShadowMaps::calculateViewProjection
+Matrix4 CascadedShadowMaps::calculateViewProjection( const Bounds& lightSpaceBounds ) const
+{
+    // Compute an inverse of a light matrix
+    Matrix4 inverseLight = m_light.inversed();
+
+    // Calculate a projection matrix based on a light-space cascade volume
     const Vec3& min = lightSpaceBounds.min();
     const Vec3& max = lightSpaceBounds.max();
 
     // IMPORTANT: minZ and maxZ are swapped!
-    Matrix4 projection = Matrix4::ortho( min.x, max.x, min.y, max.y, max.z + 50.0f, min.z );
+    Matrix4 projection = Matrix4::ortho( min.x, max.x, min.y, max.y, max.z, min.z );
 
     // Fix the sub-texel jittering
     projection = fixSubTexel( projection * inverseLight, projection );
@@ -49,12 +49,16 @@ namespace Scene {
             f32                 far;                    //!< The far cascade plane.
             Vec3                lightSpaceVertices[8];  //!< Light space vertices reprojected back to the world space.
             BoundingVolume      worldSpaceBounds;       //!< A world space bounding box of the cascade.
+            Bounds              lightSpaceBounds;       //!< A light space volume of a cascade shadowmap that is extruded toward the light.
             Matrix4             transform;              //!< A view-projection matrix that is used to render a shadowmap for a cascade.
         };
 
         //! A container type to store shadow map cascades.
         typedef Array<Cascade>  Cascades;
 
+        //! A container type to store indices of shadow casters rendered to a cascade.
+        typedef Array<s32>      Casters;
+
                                 //! Constructs an empty CascadedShadowMaps instance.
                                 CascadedShadowMaps( void );
 
@@ -76,6 +80,13 @@ namespace Scene {
         //! Returns an array of split distances.
         const Cascade&          cascadeAt( s32 index ) const;
 
+        //! Distributes shadow casters between cascades by testing their world space bounds against cascade light space volumes.
+        /*!
+         A caster that is completely inside a volume of a finer cascade is not added to coarser ones. Each output
+         array stores caster indices in an ascending order, so it can be directly passed to a shadow pass.
+         */
+        void                    cullCasters( const Bounds* worldSpaceBounds, s32 count, Array<Casters>& casters ) const;
+
     private:
 
         //! Fixes a sub-texel jitter in a cascade final matrix.
@@ -90,8 +101,11 @@ namespace Scene {
         //! Calculates light space vertices for a cascade.
         void                    calculateLightSpaceVertices( const Matrix4& viewProjection, Vec3 lightSpaceVertices[8] ) const;
 
-        //! Calculates a view-projection matrix from a set of cascade world space vertices.
-        Matrix4                 calculateViewProjection( const BoundingVolume& worldSpaceBounds ) const;
+        //! Calculates a light space volume of a cascade shadowmap.
+        Bounds                  calculateLightSpaceBounds( const BoundingVolume& worldSpaceBounds ) const;
+
+        //! Calculates a view-projection matrix from a cascade light space volume.
+        Matrix4                 calculateViewProjection( const Bounds& lightSpaceBounds ) const;
 
     private:
 
@@ -37,6 +37,7 @@ ForwardRenderSystem::ForwardRenderSystem( RenderingContext& context, RenderScene
     , m_shadows( context, renderScene )
     , m_debugCascadedShadows( context, renderScene )
     , m_debugRenderTarget( context, renderScene )
+    , m_meshes( NULL )
 {
     m_phongShader       = m_context.deprecatedRequestShader( "../../Source/Dreemchest/Scene/Rendering/Shaders/Phong.shader" );
     m_clipPlanesCBuffer = m_context.deprecatedRequestConstantBuffer( NULL, sizeof( RenderScene::CBuffer::ClipPlanes ), RenderScene::CBuffer::ClipPlanes::Layout );
@@ -45,8 +46,24 @@ ForwardRenderSystem::ForwardRenderSystem( RenderingContext& context, RenderScene
 // ** ForwardRenderSystem::emitRenderOperations
 void ForwardRenderSystem::emitRenderOperations( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const Ecs::Entity& entity, const Camera& camera, const Transform& transform, const ForwardRenderer& forwardRenderer )
 {
+    // Get world space bounds of static meshes, they are tested against both occluders and shadow cascades
+    const RenderScene::StaticMeshes& staticMeshes = m_renderScene.staticMeshes();
+    m_meshBounds.resize( staticMeshes.count() );
+
+    for( s32 i = 0, n = staticMeshes.count(); i < n; i++ ) {
+        m_meshBounds[i] = staticMeshes[i].mesh->worldSpaceBounds();
+    }
+
+    // Find static meshes hidden behind occluders before emitting any pass
+    m_meshes = NULL;
+
+    if( forwardRenderer.isOcclusionCulling() ) {
+        cullOccludedMeshes( Camera::calculateViewProjection( camera, *entity.get<Viewport>(), transform.matrix() ) );
+        m_meshes = &m_visibleMeshes;
+    }
+
     // First perform an ambient render pass
-    m_ambient.render( frame, commands, stateStack );
+    m_ambient.render( frame, commands, stateStack, m_meshes );
 
     // Get all light sources
     const RenderScene::Lights& lights = m_renderScene.lights();
@@ -121,6 +138,9 @@ void ForwardRenderSystem::renderDirectionalLight( RenderFrame& frame, RenderComm
     CascadedShadowMaps csm( cameraTransform.matrix(), *light.matrix, shadowSize );
     csm.calculate( camera.fov(), camera.near(), camera.far(), viewport.aspect(), lambda, cascadeCount );
 
+    // Distribute static meshes between cascades, so each mesh is rendered only to shadowmaps it can affect
+    csm.cullCasters( m_meshBounds.empty() ? NULL : &m_meshBounds[0], static_cast<s32>( m_meshBounds.size() ), m_casters );
+
     // Render each cascade
     for( s32 j = 0; j < cascadeCount; j++ ) {
         const CascadedShadowMaps::Cascade& cascade = csm.cascadeAt( j );
@@ -129,7 +149,7 @@ void ForwardRenderSystem::renderDirectionalLight( RenderFrame& frame, RenderComm
         parameters.invSize   = 1.0f / shadowSize;
         parameters.transform = cascade.transform;
 
-        TransientTexture shadows = m_shadows.render( frame, commands, stateStack, parameters );
+        TransientTexture shadows = m_shadows.render( frame, commands, stateStack, parameters, &m_casters[j] );
 
         RenderScene::CBuffer::ClipPlanes clip = RenderScene::CBuffer::ClipPlanes::fromNearAndFar( cameraTransform.axisZ(), cameraTransform.worldSpacePosition(), cascade.near, cascade.far );
 
@@ -151,6 +171,37 @@ void ForwardRenderSystem::renderDirectionalLight( RenderFrame& frame, RenderComm
     }
 }
 
+// ** ForwardRenderSystem::cullOccludedMeshes
+void ForwardRenderSystem::cullOccludedMeshes( const Matrix4& viewProjection )
+{
+    const RenderScene::StaticMeshes& staticMeshes = m_renderScene.staticMeshes();
+
+    m_occlusionCuller.setTaskManager( m_renderScene.taskManager() );
+    m_occlusionCuller.begin( viewProjection );
+
+    // Rasterize all meshes marked as occluders
+    for( s32 i = 0, n = staticMeshes.count(); i < n; i++ ) {
+        const RenderScene::StaticMeshNode& node = staticMeshes[i];
+
+        if( !node.mesh->isOccluder() ) {
+            continue;
+        }
+
+        const MeshHandle& mesh = node.mesh->mesh();
+
+        if( !mesh.isValid() || !mesh.isLoaded() ) {
+            continue;
+        }
+
+        m_occlusionCuller.addOccluder( mesh.readLock(), *node.matrix );
+    }
+
+    m_occlusionCuller.rasterize();
+
+    // Now test bounds of all static meshes against a depth pyramid
+    m_occlusionCuller.cull( m_meshBounds.empty() ? NULL : &m_meshBounds[0], static_cast<s32>( m_meshBounds.size() ), m_visibleMeshes );
+}
+
 // ** ForwardRenderSystem::renderLight
 void ForwardRenderSystem::renderLight( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const RenderScene::LightNode& light, const RenderScene::CBuffer::ClipPlanes* clip, TransientTexture shadows )
 {
@@ -182,7 +233,11 @@ void ForwardRenderSystem::renderLight( RenderFrame& frame, RenderCommandBuffer&
     }
 
     // Emit render operations
-    RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), frame, commands, stateStack, RenderMaskPhong );
+    if( m_meshes == NULL ) {
+        RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), frame, commands, stateStack, RenderMaskPhong );
+    } else if( !m_meshes->empty() ) {
+        RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), &m_meshes->front(), static_cast<s32>( m_meshes->size() ), frame, commands, stateStack, RenderMaskPhong );
+    }
     RenderPassBase::emitPointClouds( m_renderScene.pointClouds(), frame, commands, stateStack, RenderMaskPhong );
 }
 
@@ -32,6 +32,7 @@
 #include "../Passes/DebugRenderPasses.h"
 #include "../Passes/GenericRenderPasses.h"
 #include "CascadedShadowMaps.h"
+#include "../OcclusionCuller.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -62,6 +63,9 @@ namespace Scene {
         //! Emits operations to render a directional light pass.
         void                            renderDirectionalLight( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const ForwardRenderer& forwardRenderer, const Camera& camera, const Transform& cameraTransform, const Viewport& viewport, const RenderScene::LightNode& light );
 
+        //! Rasterizes occluder meshes and outputs indices of static meshes that are not hidden by them.
+        void                            cullOccludedMeshes( const Matrix4& viewProjection );
+
     private:
 
         Program                         m_phongShader;
@@ -70,6 +74,11 @@ namespace Scene {
         ShadowPass                      m_shadows;
         DebugCascadedShadows            m_debugCascadedShadows;
         DebugRenderTarget               m_debugRenderTarget;
+        Array<Bounds>                   m_meshBounds;       //!< World space bounds of static meshes that are tested against occluders and shadow cascades.
+        Array<CascadedShadowMaps::Casters>  m_casters;      //!< Shadow casters of each cascade.
+        OcclusionCuller                 m_occlusionCuller;  //!< Rejects static meshes hidden behind occluders.
+        Array<s32>                      m_visibleMeshes;    //!< Static meshes that passed an occlusion test.
+        const Array<s32>*               m_meshes;           //!< Static meshes rendered by light passes, all meshes are rendered if this is NULL.
     };
 
 } // namespace Scene
@@ -0,0 +1,264 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "LodSelector.h"
+#include "../Components/Rendering.h"
+#include "../Components/Transform.h"
+#include "../Viewport.h"
+
+#include <float.h>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+//! A total number of objects processed by a single job.
+static const s32 kObjectsPerJob = 1024;
+
+// ** LodSelector::LodSelector
+LodSelector::LodSelector( void )
+{
+}
+
+// ** LodSelector::taskManager
+Threads::TaskManagerWPtr LodSelector::taskManager( void ) const
+{
+    return m_taskManager;
+}
+
+// ** LodSelector::setTaskManager
+void LodSelector::setTaskManager( Threads::TaskManagerWPtr value )
+{
+    m_taskManager = value;
+}
+
+// ** LodSelector::count
+s32 LodSelector::count( void ) const
+{
+    return static_cast<s32>( m_states.size() );
+}
+
+// ** LodSelector::state
+const LodSelector::State& LodSelector::state( s32 index ) const
+{
+    NIMBLE_ABORT_IF( index < 0 || index >= count(), "index is out of range" );
+    return m_states[index];
+}
+
+// ** LodSelector::reset
+void LodSelector::reset( void )
+{
+    m_states.clear();
+    m_keys.clear();
+}
+
+// ** LodSelector::screenSize
+f32 LodSelector::screenSize( const View& view, const Bounds& bounds )
+{
+    f32 radius = (bounds.max() - bounds.min()).length() * 0.5f;
+
+    if( !view.perspective ) {
+        return radius * view.scale;
+    }
+
+    // An object covers a whole screen when a camera is inside its bounding sphere
+    f32 distance = ((bounds.min() + bounds.max()) * 0.5f - view.position).length();
+    return radius * view.scale / max2( distance, radius );
+}
+
+// ** LodSelector::viewFromCamera
+LodSelector::View LodSelector::viewFromCamera( const Camera& camera, const Viewport& viewport, const Vec3& position )
+{
+    View view;
+    view.position    = position;
+    view.perspective = camera.projection() == Projection::Perspective;
+
+    if( view.perspective ) {
+        view.scale = 1.0f / tanf( radians( camera.fov() * 0.5f ) );
+    } else {
+        view.scale = 2.0f / viewport.denormalize( camera.ndc() ).height();
+    }
+
+    return view;
+}
+
+// ** LodSelector::findLevel
+s32 LodSelector::findLevel( const LodGroup& group, f32 screenSize )
+{
+    s32 count = group.levelCount();
+
+    for( s32 i = 0; i < count; i++ ) {
+        if( screenSize >= group.screenSize( i ) ) {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+// ** LodSelector::select
+void LodSelector::select( const View& view, const Bounds* bounds, const LodGroup* const* groups, s32 count, const u64* keys )
+{
+    // Levels selected during a previous call follow their objects
+    remapStates( keys, count );
+
+    if( count == 0 ) {
+        return;
+    }
+
+    s32 jobCount = (count + kObjectsPerJob - 1) / kObjectsPerJob;
+
+    Array<Job> jobs;
+    jobs.resize( jobCount );
+
+    for( s32 i = 0; i < jobCount; i++ ) {
+        jobs[i].view   = &view;
+        jobs[i].bounds = bounds + i * kObjectsPerJob;
+        jobs[i].groups = groups + i * kObjectsPerJob;
+        jobs[i].states = &m_states[i * kObjectsPerJob];
+        jobs[i].count  = min2( kObjectsPerJob, count - i * kObjectsPerJob );
+    }
+
+    if( m_taskManager.valid() && jobCount > 1 ) {
+        Array<Threads::TaskProgressPtr> progress;
+
+        // Queue all jobs except the first one to worker threads
+        for( s32 i = 1; i < jobCount; i++ ) {
+            progress.push_back( m_taskManager->runBackgroundTask( dcStaticFunction( LodSelector::processJob ), &jobs[i] ) );
+        }
+
+        // The calling thread processes the first job itself
+        processJob( Threads::TaskProgressWPtr(), &jobs[0] );
+
+        for( s32 i = 0, n = static_cast<s32>( progress.size() ); i < n; i++ ) {
+            progress[i]->waitForCompletion();
+        }
+    } else {
+        for( s32 i = 0; i < jobCount; i++ ) {
+            processJob( Threads::TaskProgressWPtr(), &jobs[i] );
+        }
+    }
+}
+
+// ** LodSelector::remapStates
+void LodSelector::remapStates( const u64* keys, s32 count )
+{
+    // Nothing was added or removed since a previous call
+    if( this->count() == count ) {
+        s32 i = 0;
+
+        while( i < count && m_keys[i] == (keys ? keys[i] : static_cast<u64>( i )) ) {
+            i++;
+        }
+
+        if( i == count ) {
+            return;
+        }
+    }
+
+    HashMap<u64, State> previous;
+
+    for( s32 i = 0, n = this->count(); i < n; i++ ) {
+        previous[m_keys[i]] = m_states[i];
+    }
+
+    State initial;
+    initial.level    = -1;
+    initial.previous = -1;
+    initial.fade     = 1.0f;
+
+    m_states.clear();
+    m_states.resize( count, initial );
+    m_keys.resize( count );
+
+    for( s32 i = 0; i < count; i++ ) {
+        m_keys[i] = keys ? keys[i] : static_cast<u64>( i );
+
+        HashMap<u64, State>::const_iterator j = previous.find( m_keys[i] );
+
+        if( j != previous.end() ) {
+            m_states[i] = j->second;
+        }
+    }
+}
+
+// ** LodSelector::processJob
+void LodSelector::processJob( Threads::TaskProgressWPtr progress, void* userData )
+{
+    Job* job = reinterpret_cast<Job*>( userData );
+    selectRange( *job->view, job->bounds, job->groups, job->states, job->count );
+}
+
+// ** LodSelector::selectRange
+void LodSelector::selectRange( const View& view, const Bounds* bounds, const LodGroup* const* groups, State* states, s32 count )
+{
+    for( s32 i = 0; i < count; i++ ) {
+        const LodGroup* group = groups[i];
+        State&          state = states[i];
+
+        // Objects without levels of detail are always rendered with a base mesh
+        if( group == NULL || group->levelCount() == 0 ) {
+            state.level    = 0;
+            state.previous = 0;
+            state.fade     = 1.0f;
+            continue;
+        }
+
+        f32 size = screenSize( view, bounds[i] );
+        s32 level;
+
+        if( state.level < 0 ) {
+            // There is no previous level, so just pick the one that matches a screen size
+            level = findLevel( *group, size );
+        } else {
+            // Keep a previous level while a screen size stays inside a hysteresis band
+            f32 hysteresis = group->hysteresis();
+            s32 finer      = findLevel( *group, size * (1.0f + hysteresis) );
+            s32 coarser    = findLevel( *group, size * (1.0f - hysteresis) );
+            level          = min2( max2( state.level, finer ), coarser );
+        }
+
+        if( level != state.level ) {
+            // Start a cross-fade from a previously rendered level
+            if( state.level >= 0 && group->isCrossFade() ) {
+                state.previous = state.level;
+                state.fade     = 0.0f;
+            } else {
+                state.previous = level;
+                state.fade     = 1.0f;
+            }
+
+            state.level = level;
+        } else if( state.fade < 1.0f ) {
+            state.fade = min2( state.fade + 1.0f / max2( group->crossFadeFrames(), 1 ), 1.0f );
+        }
+    }
+}
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
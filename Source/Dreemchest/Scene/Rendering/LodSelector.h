@@ -0,0 +1,128 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Scene_Rendering_LodSelector_H__
+#define __DC_Scene_Rendering_LodSelector_H__
+
+#include "../Scene.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+    //! Selects a level of detail of each object from its projected screen size.
+    /*!
+     A screen size is a fraction of a viewport height covered by a bounding sphere of an object. A level is
+     switched only when a screen size gets out of a hysteresis band around a level threshold, so an object
+     does not flicker between two levels when a screen size oscillates around a threshold.
+
+     A selector stores levels picked during a previous call, so a separate instance should be used for each camera.
+     Stored levels are matched to objects by keys, so an object keeps its level when other objects are added or removed.
+     Objects are split to ranges, each of them is processed by a separate job when a task manager is set.
+     */
+    class LodSelector {
+    public:
+
+        //! Camera parameters used to calculate projected screen sizes.
+        struct View {
+            Vec3                        position;       //!< A camera world space position.
+            f32                         scale;          //!< Converts a bounding sphere radius to a fraction of a viewport height.
+            bool                        perspective;    //!< Indicates that a screen size is divided by a distance to a camera.
+        };
+
+        //! A level of detail state of a single object.
+        struct State {
+            s32                         level;          //!< A selected level, equals to a total number of levels if an object is culled.
+            s32                         previous;       //!< A level an object fades out from during a cross-fade.
+            f32                         fade;           //!< A cross-fade progress in [0, 1] range, an object is not fading when it equals to one.
+        };
+
+                                        //! Constructs a LodSelector instance.
+                                        LodSelector( void );
+
+        //! Returns a task manager used to run jobs.
+        Threads::TaskManagerWPtr        taskManager( void ) const;
+
+        //! Sets a task manager used to run jobs, all work is done on a calling thread if no task manager is set.
+        void                            setTaskManager( Threads::TaskManagerWPtr value );
+
+        //! Selects levels of objects with specified world space bounds, an object without a level of detail group always uses the first level.
+        /*!
+         Objects are identified by specified keys or by indices when no keys are passed.
+         */
+        void                            select( const View& view, const Bounds* bounds, const LodGroup* const* groups, s32 count, const u64* keys = NULL );
+
+        //! Returns a total number of objects processed by a last selection.
+        s32                             count( void ) const;
+
+        //! Returns a level of detail state of an object.
+        const State&                    state( s32 index ) const;
+
+        //! Forgets all previously selected levels.
+        void                            reset( void );
+
+        //! Returns a projected screen size of a world space box.
+        static f32                      screenSize( const View& view, const Bounds& bounds );
+
+        //! Constructs view parameters from a camera.
+        static View                     viewFromCamera( const Camera& camera, const Viewport& viewport, const Vec3& position );
+
+    private:
+
+        //! A job that selects levels of a range of objects.
+        struct Job {
+            const View*                 view;           //!< Camera parameters.
+            const Bounds*               bounds;         //!< World space bounds of objects.
+            const LodGroup* const*      groups;         //!< Level of detail groups of objects.
+            State*                      states;         //!< Level of detail states of objects.
+            s32                         count;          //!< A total number of objects in a range.
+        };
+
+        //! Moves previously selected states to new indices of objects with specified keys.
+        void                            remapStates( const u64* keys, s32 count );
+
+        //! Selects levels of a range of objects.
+        static void                     selectRange( const View& view, const Bounds* bounds, const LodGroup* const* groups, State* states, s32 count );
+
+        //! Returns the finest level that is allowed for a specified screen size.
+        static s32                      findLevel( const LodGroup& group, f32 screenSize );
+
+        //! A job entry point to select levels of a range of objects.
+        static void                     processJob( Threads::TaskProgressWPtr progress, void* userData );
+
+    private:
+
+        Threads::TaskManagerWPtr        m_taskManager;  //!< A task manager used to run jobs.
+        Array<State>                    m_states;       //!< Level of detail states of all objects.
+        Array<u64>                      m_keys;         //!< Keys of objects processed by a last selection.
+    };
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Scene_Rendering_LodSelector_H__    */
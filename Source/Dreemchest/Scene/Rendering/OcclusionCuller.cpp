@@ -0,0 +1,673 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "OcclusionCuller.h"
+#include "../Assets/Mesh.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+    #define DC_SCENE_OCCLUSION_SSE
+    #include <xmmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+    #define DC_SCENE_OCCLUSION_NEON
+    #include <arm_neon.h>
+#endif
+
+#include <float.h>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+//! A total number of depth buffer rows rasterized by a single job.
+static const s32 kBandHeight = 16;
+
+//! A total number of bounding boxes tested by a single job.
+static const s32 kBoxesPerJob = 1024;
+
+//! A bounding box is tested against a pyramid level where its screen rectangle spans less than this number of texels.
+static const s32 kMaxTestSpan = 4;
+
+//! Transforms a point by a matrix without a perspective division.
+static Vec4 transformPoint( const Matrix4& transform, f32 x, f32 y, f32 z )
+{
+    const f32* m = transform.m;
+    return Vec4( m[0] * x + m[4] * y + m[8]  * z + m[12]
+               , m[1] * x + m[5] * y + m[9]  * z + m[13]
+               , m[2] * x + m[6] * y + m[10] * z + m[14]
+               , m[3] * x + m[7] * y + m[11] * z + m[15] );
+}
+
+//! Linearly interpolates between two clip space points.
+static Vec4 lerpPoint( const Vec4& a, const Vec4& b, f32 t )
+{
+    return Vec4( a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t );
+}
+
+// ** OcclusionCuller::OcclusionCuller
+OcclusionCuller::OcclusionCuller( s32 width, s32 height )
+{
+    NIMBLE_ABORT_IF( width <= 0 || height <= 0, "invalid depth buffer dimensions" );
+    NIMBLE_ABORT_IF( width % Alignment != 0, "a depth buffer width should be a multiple of an alignment" );
+
+    // Each next level is a half of a previous one rounded up, the last level is a single texel
+    s32 offset = 0;
+
+    while( true ) {
+        Level level;
+        level.width  = width;
+        level.height = height;
+        level.offset = offset;
+        m_levels.push_back( level );
+
+        offset += width * height;
+
+        if( width == 1 && height == 1 ) {
+            break;
+        }
+
+        width  = (width  + 1) / 2;
+        height = (height + 1) / 2;
+    }
+
+    m_depth.resize( offset, 1.0f );
+}
+
+// ** OcclusionCuller::width
+s32 OcclusionCuller::width( void ) const
+{
+    return m_levels[0].width;
+}
+
+// ** OcclusionCuller::height
+s32 OcclusionCuller::height( void ) const
+{
+    return m_levels[0].height;
+}
+
+// ** OcclusionCuller::taskManager
+Threads::TaskManagerWPtr OcclusionCuller::taskManager( void ) const
+{
+    return m_taskManager;
+}
+
+// ** OcclusionCuller::setTaskManager
+void OcclusionCuller::setTaskManager( Threads::TaskManagerWPtr value )
+{
+    m_taskManager = value;
+}
+
+// ** OcclusionCuller::triangleCount
+s32 OcclusionCuller::triangleCount( void ) const
+{
+    return static_cast<s32>( m_triangles.size() );
+}
+
+// ** OcclusionCuller::levelCount
+s32 OcclusionCuller::levelCount( void ) const
+{
+    return static_cast<s32>( m_levels.size() );
+}
+
+// ** OcclusionCuller::depthAt
+f32 OcclusionCuller::depthAt( s32 level, s32 x, s32 y ) const
+{
+    NIMBLE_ABORT_IF( level < 0 || level >= levelCount(), "level index is out of range" );
+    const Level& l = m_levels[level];
+    NIMBLE_ABORT_IF( x < 0 || x >= l.width || y < 0 || y >= l.height, "texel coordinates are out of range" );
+    return m_depth[l.offset + y * l.width + x];
+}
+
+// ** OcclusionCuller::begin
+void OcclusionCuller::begin( const Matrix4& viewProjection )
+{
+    m_viewProjection = viewProjection;
+    m_triangles.clear();
+}
+
+// ** OcclusionCuller::addOccluder
+void OcclusionCuller::addOccluder( const Vec3* positions, s32 stride, const u16* indices, s32 indexCount, const Matrix4& transform )
+{
+    if( indexCount < 3 ) {
+        return;
+    }
+
+    // Transform each referenced vertex only once
+    s32 vertexCount = 0;
+
+    for( s32 i = 0; i < indexCount; i++ ) {
+        vertexCount = max2( vertexCount, static_cast<s32>( indices[i] ) + 1 );
+    }
+
+    Matrix4      m    = m_viewProjection * transform;
+    const u8*    data = reinterpret_cast<const u8*>( positions );
+    m_vertices.resize( vertexCount );
+
+    for( s32 i = 0; i < vertexCount; i++ ) {
+        const Vec3& p = *reinterpret_cast<const Vec3*>( data + i * stride );
+        m_vertices[i] = transformPoint( m, p.x, p.y, p.z );
+    }
+
+    for( s32 i = 0; i + 2 < indexCount; i += 3 ) {
+        addClipSpaceTriangle( m_vertices[indices[i]], m_vertices[indices[i + 1]], m_vertices[indices[i + 2]] );
+    }
+}
+
+// ** OcclusionCuller::addOccluder
+void OcclusionCuller::addOccluder( const Mesh& mesh, const Matrix4& transform )
+{
+    const Mesh::VertexBuffer& vertices = mesh.vertexBuffer();
+    const Mesh::IndexBuffer&  indices  = mesh.indexBuffer();
+
+    if( vertices.empty() || indices.empty() ) {
+        return;
+    }
+
+    bool hasRanges = false;
+
+    for( s32 i = 0, n = mesh.chunkCount(); i < n; i++ ) {
+        s32 count = mesh.chunkIndexCount( i );
+
+        if( count == 0 ) {
+            continue;
+        }
+
+        addOccluder( &vertices[mesh.chunkBaseVertex( i )].position, sizeof( Mesh::Vertex ), &indices[mesh.chunkOffset( i )], count, transform );
+        hasRanges = true;
+    }
+
+    // Loaded and generated meshes have no chunk ranges, so a whole index buffer is rasterized
+    if( !hasRanges ) {
+        addOccluder( &vertices[0].position, sizeof( Mesh::Vertex ), &indices[0], static_cast<s32>( indices.size() ), transform );
+    }
+}
+
+// ** OcclusionCuller::addOccluder
+void OcclusionCuller::addOccluder( const Bounds& bounds )
+{
+    static const u8 kFaces[] = {
+          0, 2, 1,  1, 2, 3
+        , 4, 5, 6,  5, 7, 6
+        , 0, 1, 4,  1, 5, 4
+        , 2, 6, 3,  3, 6, 7
+        , 0, 4, 2,  2, 4, 6
+        , 1, 3, 5,  3, 7, 5
+    };
+
+    const Vec3& min = bounds.min();
+    const Vec3& max = bounds.max();
+    Vec4 corners[8];
+
+    for( s32 i = 0; i < 8; i++ ) {
+        corners[i] = transformPoint( m_viewProjection, (i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z );
+    }
+
+    for( s32 i = 0; i < 36; i += 3 ) {
+        addClipSpaceTriangle( corners[kFaces[i]], corners[kFaces[i + 1]], corners[kFaces[i + 2]] );
+    }
+}
+
+// ** OcclusionCuller::addClipSpaceTriangle
+void OcclusionCuller::addClipSpaceTriangle( const Vec4& a, const Vec4& b, const Vec4& c )
+{
+    const Vec4* vertices[] = { &a, &b, &c };
+    f32         distances[3];
+    s32         inside = 0;
+
+    // Calculate distances to a near plane
+    for( s32 i = 0; i < 3; i++ ) {
+        distances[i] = vertices[i]->z + vertices[i]->w;
+        inside += distances[i] >= 0.0f ? 1 : 0;
+    }
+
+    if( inside == 3 ) {
+        addScreenSpaceTriangle( a, b, c );
+        return;
+    }
+
+    if( inside == 0 ) {
+        return;
+    }
+
+    // A triangle crosses a near plane, so clip it to a triangle or a quad
+    Vec4 polygon[4];
+    s32  count = 0;
+
+    for( s32 i = 0; i < 3; i++ ) {
+        s32 j = (i + 1) % 3;
+
+        if( distances[i] >= 0.0f ) {
+            polygon[count++] = *vertices[i];
+        }
+
+        if( (distances[i] >= 0.0f) != (distances[j] >= 0.0f) ) {
+            polygon[count++] = lerpPoint( *vertices[i], *vertices[j], distances[i] / (distances[i] - distances[j]) );
+        }
+    }
+
+    addScreenSpaceTriangle( polygon[0], polygon[1], polygon[2] );
+
+    if( count == 4 ) {
+        addScreenSpaceTriangle( polygon[0], polygon[2], polygon[3] );
+    }
+}
+
+// ** OcclusionCuller::addScreenSpaceTriangle
+void OcclusionCuller::addScreenSpaceTriangle( const Vec4& a, const Vec4& b, const Vec4& c )
+{
+    const Vec4* vertices[] = { &a, &b, &c };
+    const Level& target    = m_levels[0];
+    Triangle     triangle;
+
+    for( s32 i = 0; i < 3; i++ ) {
+        const Vec4& v = *vertices[i];
+
+        if( v.w <= 0.0f ) {
+            return;
+        }
+
+        f32 invW = 1.0f / v.w;
+        triangle.x[i] = (v.x * invW * 0.5f + 0.5f) * target.width;
+        triangle.y[i] = (v.y * invW * 0.5f + 0.5f) * target.height;
+        triangle.z[i] =  v.z * invW * 0.5f + 0.5f;
+    }
+
+    // A triangle that is completely behind a far plane can not hide anything
+    if( triangle.z[0] > 1.0f && triangle.z[1] > 1.0f && triangle.z[2] > 1.0f ) {
+        return;
+    }
+
+    // Make all triangles counter-clockwise, so edge functions are positive inside
+    f32 area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+
+    if( area == 0.0f ) {
+        return;
+    }
+
+    if( area < 0.0f ) {
+        std::swap( triangle.x[1], triangle.x[2] );
+        std::swap( triangle.y[1], triangle.y[2] );
+        std::swap( triangle.z[1], triangle.z[2] );
+    }
+
+    // Find pixels with centers inside a triangle bounding rectangle
+    f32 minX = min2( triangle.x[0], min2( triangle.x[1], triangle.x[2] ) );
+    f32 maxX = max2( triangle.x[0], max2( triangle.x[1], triangle.x[2] ) );
+    f32 minY = min2( triangle.y[0], min2( triangle.y[1], triangle.y[2] ) );
+    f32 maxY = max2( triangle.y[0], max2( triangle.y[1], triangle.y[2] ) );
+
+    triangle.minX = static_cast<s32>( ceilf ( max2( minX - 0.5f, 0.0f ) ) );
+    triangle.maxX = static_cast<s32>( floorf( min2( maxX - 0.5f, target.width  - 1.0f ) ) );
+    triangle.minY = static_cast<s32>( ceilf ( max2( minY - 0.5f, 0.0f ) ) );
+    triangle.maxY = static_cast<s32>( floorf( min2( maxY - 0.5f, target.height - 1.0f ) ) );
+
+    if( triangle.minX > triangle.maxX || triangle.minY > triangle.maxY ) {
+        return;
+    }
+
+    m_triangles.push_back( triangle );
+}
+
+// ** OcclusionCuller::rasterize
+void OcclusionCuller::rasterize( void )
+{
+    const Level& target = m_levels[0];
+
+    // Clear a depth buffer to a far plane
+    for( s32 i = 0, n = target.width * target.height; i < n; i++ ) {
+        m_depth[i] = 1.0f;
+    }
+
+    // Each job rasterizes a horizontal band, so jobs never write to the same pixels
+    s32 count = (target.height + kBandHeight - 1) / kBandHeight;
+
+    if( m_taskManager.valid() && count > 1 && !m_triangles.empty() ) {
+        Array<RasterJob> jobs;
+        jobs.resize( count );
+
+        for( s32 i = 0; i < count; i++ ) {
+            jobs[i].culler = this;
+            jobs[i].minY   = i * kBandHeight;
+            jobs[i].maxY   = min2( (i + 1) * kBandHeight, target.height ) - 1;
+        }
+
+        Array<Threads::TaskProgressPtr> progress;
+
+        // Queue all jobs except the first one to worker threads
+        for( s32 i = 1; i < count; i++ ) {
+            progress.push_back( m_taskManager->runBackgroundTask( dcStaticFunction( OcclusionCuller::processRasterJob ), &jobs[i] ) );
+        }
+
+        // The calling thread processes the first job itself
+        processRasterJob( Threads::TaskProgressWPtr(), &jobs[0] );
+
+        for( s32 i = 0, n = static_cast<s32>( progress.size() ); i < n; i++ ) {
+            progress[i]->waitForCompletion();
+        }
+    } else {
+        rasterizeBand( 0, target.height - 1 );
+    }
+
+    // Now build a depth pyramid
+    for( s32 i = 1, n = levelCount(); i < n; i++ ) {
+        downsample( m_levels[i - 1], m_levels[i] );
+    }
+}
+
+// ** OcclusionCuller::processRasterJob
+void OcclusionCuller::processRasterJob( Threads::TaskProgressWPtr progress, void* userData )
+{
+    RasterJob* job = reinterpret_cast<RasterJob*>( userData );
+    job->culler->rasterizeBand( job->minY, job->maxY );
+}
+
+// ** OcclusionCuller::rasterizeBand
+void OcclusionCuller::rasterizeBand( s32 minY, s32 maxY )
+{
+    for( s32 i = 0, n = triangleCount(); i < n; i++ ) {
+        const Triangle& triangle = m_triangles[i];
+
+        if( triangle.maxY < minY || triangle.minY > maxY ) {
+            continue;
+        }
+
+        rasterizeTriangle( triangle, max2( triangle.minY, minY ), min2( triangle.maxY, maxY ) );
+    }
+}
+
+// ** OcclusionCuller::rasterizeTriangle
+void OcclusionCuller::rasterizeTriangle( const Triangle& triangle, s32 minY, s32 maxY )
+{
+    const f32* x = triangle.x;
+    const f32* y = triangle.y;
+    const f32* z = triangle.z;
+
+    // Edge functions E(px, py) = a * px + b * py + c, the edge i is opposite to a vertex i
+    f32 a[3], b[3], c[3];
+
+    for( s32 i = 0; i < 3; i++ ) {
+        s32 j = (i + 1) % 3;
+        s32 k = (i + 2) % 3;
+        a[i] = y[j] - y[k];
+        b[i] = x[k] - x[j];
+        c[i] = -(a[i] * x[j] + b[i] * y[j]);
+    }
+
+    // Depth is linear in screen space, so it is a weighted sum of edge functions
+    f32 invArea = 1.0f / (a[0] * x[0] + b[0] * y[0] + c[0]);
+    f32 dzdx    = (a[0] * z[0] + a[1] * z[1] + a[2] * z[2]) * invArea;
+    f32 dzdy    = (b[0] * z[0] + b[1] * z[1] + b[2] * z[2]) * invArea;
+    f32 z0      = (c[0] * z[0] + c[1] * z[1] + c[2] * z[2]) * invArea;
+
+    // Rasterize groups of four pixels starting from an aligned column
+    s32 width  = m_levels[0].width;
+    s32 startX = triangle.minX & ~(Alignment - 1);
+
+    for( s32 row = minY; row <= maxY; row++ ) {
+        f32  py    = row + 0.5f;
+        f32* depth = &m_depth[row * width];
+
+    #if defined( DC_SCENE_OCCLUSION_SSE )
+        __m128 px    = _mm_add_ps( _mm_set1_ps( startX + 0.5f ), _mm_set_ps( 3.0f, 2.0f, 1.0f, 0.0f ) );
+        __m128 zero  = _mm_setzero_ps();
+        __m128 e0    = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( a[0] ), px ), _mm_set1_ps( b[0] * py + c[0] ) );
+        __m128 e1    = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( a[1] ), px ), _mm_set1_ps( b[1] * py + c[1] ) );
+        __m128 e2    = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( a[2] ), px ), _mm_set1_ps( b[2] * py + c[2] ) );
+        __m128 pz    = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( dzdx ), px ), _mm_set1_ps( dzdy * py + z0 ) );
+        __m128 step0 = _mm_set1_ps( a[0] * Alignment );
+        __m128 step1 = _mm_set1_ps( a[1] * Alignment );
+        __m128 step2 = _mm_set1_ps( a[2] * Alignment );
+        __m128 stepZ = _mm_set1_ps( dzdx * Alignment );
+
+        for( s32 column = startX; column <= triangle.maxX; column += Alignment ) {
+            __m128 mask  = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( e0, zero ), _mm_cmpge_ps( e1, zero ) ), _mm_cmpge_ps( e2, zero ) );
+            __m128 value = _mm_loadu_ps( depth + column );
+            __m128 nearest = _mm_min_ps( value, pz );
+            _mm_storeu_ps( depth + column, _mm_or_ps( _mm_and_ps( mask, nearest ), _mm_andnot_ps( mask, value ) ) );
+
+            e0 = _mm_add_ps( e0, step0 );
+            e1 = _mm_add_ps( e1, step1 );
+            e2 = _mm_add_ps( e2, step2 );
+            pz = _mm_add_ps( pz, stepZ );
+        }
+    #elif defined( DC_SCENE_OCCLUSION_NEON )
+        static const f32 kLanes[] = { 0.0f, 1.0f, 2.0f, 3.0f };
+        float32x4_t px    = vaddq_f32( vdupq_n_f32( startX + 0.5f ), vld1q_f32( kLanes ) );
+        float32x4_t zero  = vdupq_n_f32( 0.0f );
+        float32x4_t e0    = vmlaq_f32( vdupq_n_f32( b[0] * py + c[0] ), vdupq_n_f32( a[0] ), px );
+        float32x4_t e1    = vmlaq_f32( vdupq_n_f32( b[1] * py + c[1] ), vdupq_n_f32( a[1] ), px );
+        float32x4_t e2    = vmlaq_f32( vdupq_n_f32( b[2] * py + c[2] ), vdupq_n_f32( a[2] ), px );
+        float32x4_t pz    = vmlaq_f32( vdupq_n_f32( dzdy * py + z0 ), vdupq_n_f32( dzdx ), px );
+        float32x4_t step0 = vdupq_n_f32( a[0] * Alignment );
+        float32x4_t step1 = vdupq_n_f32( a[1] * Alignment );
+        float32x4_t step2 = vdupq_n_f32( a[2] * Alignment );
+        float32x4_t stepZ = vdupq_n_f32( dzdx * Alignment );
+
+        for( s32 column = startX; column <= triangle.maxX; column += Alignment ) {
+            uint32x4_t  mask  = vandq_u32( vandq_u32( vcgeq_f32( e0, zero ), vcgeq_f32( e1, zero ) ), vcgeq_f32( e2, zero ) );
+            float32x4_t value = vld1q_f32( depth + column );
+            vst1q_f32( depth + column, vbslq_f32( mask, vminq_f32( value, pz ), value ) );
+
+            e0 = vaddq_f32( e0, step0 );
+            e1 = vaddq_f32( e1, step1 );
+            e2 = vaddq_f32( e2, step2 );
+            pz = vaddq_f32( pz, stepZ );
+        }
+    #else
+        for( s32 column = startX; column <= triangle.maxX; column++ ) {
+            f32 px = column + 0.5f;
+
+            if( a[0] * px + b[0] * py + c[0] < 0.0f || a[1] * px + b[1] * py + c[1] < 0.0f || a[2] * px + b[2] * py + c[2] < 0.0f ) {
+                continue;
+            }
+
+            depth[column] = min2( depth[column], dzdx * px + dzdy * py + z0 );
+        }
+    #endif
+    }
+}
+
+// ** OcclusionCuller::downsample
+void OcclusionCuller::downsample( const Level& src, const Level& dst )
+{
+    const f32* input  = &m_depth[src.offset];
+    f32*       output = &m_depth[dst.offset];
+
+    for( s32 y = 0; y < dst.height; y++ ) {
+        // The last row of an odd height level is paired with itself
+        const f32* row0 = input + (y * 2) * src.width;
+        const f32* row1 = input + min2( y * 2 + 1, src.height - 1 ) * src.width;
+        f32*       out  = output + y * dst.width;
+        s32        x    = 0;
+
+    #if defined( DC_SCENE_OCCLUSION_SSE )
+        for( ; x + 4 <= dst.width && x * 2 + 8 <= src.width; x += 4 ) {
+            __m128 lo = _mm_max_ps( _mm_loadu_ps( row0 + x * 2 ),     _mm_loadu_ps( row1 + x * 2 ) );
+            __m128 hi = _mm_max_ps( _mm_loadu_ps( row0 + x * 2 + 4 ), _mm_loadu_ps( row1 + x * 2 + 4 ) );
+            _mm_storeu_ps( out + x, _mm_max_ps( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 ) ), _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 ) ) ) );
+        }
+    #elif defined( DC_SCENE_OCCLUSION_NEON )
+        for( ; x + 4 <= dst.width && x * 2 + 8 <= src.width; x += 4 ) {
+            float32x4x2_t top    = vld2q_f32( row0 + x * 2 );
+            float32x4x2_t bottom = vld2q_f32( row1 + x * 2 );
+            vst1q_f32( out + x, vmaxq_f32( vmaxq_f32( top.val[0], top.val[1] ), vmaxq_f32( bottom.val[0], bottom.val[1] ) ) );
+        }
+    #endif
+
+        // Process the rest of a row, the last column of an odd width level is paired with itself
+        for( ; x < dst.width; x++ ) {
+            s32 x0 = x * 2;
+            s32 x1 = min2( x * 2 + 1, src.width - 1 );
+            out[x] = max2( max2( row0[x0], row0[x1] ), max2( row1[x0], row1[x1] ) );
+        }
+    }
+}
+
+// ** OcclusionCuller::isVisible
+bool OcclusionCuller::isVisible( const Bounds& bounds ) const
+{
+    const Vec3&  min    = bounds.min();
+    const Vec3&  max    = bounds.max();
+    const Level& target = m_levels[0];
+
+    f32 minX = FLT_MAX, maxX = -FLT_MAX;
+    f32 minY = FLT_MAX, maxY = -FLT_MAX;
+    f32 minZ = FLT_MAX;
+    s32 clipped = 0;
+
+    // Project box corners to find a screen rectangle and the nearest depth
+    for( s32 i = 0; i < 8; i++ ) {
+        Vec4 p = transformPoint( m_viewProjection, (i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z );
+
+        if( p.z + p.w < 0.0f || p.w <= 0.0f ) {
+            clipped++;
+            continue;
+        }
+
+        f32 invW = 1.0f / p.w;
+        f32 x    = (p.x * invW * 0.5f + 0.5f) * target.width;
+        f32 y    = (p.y * invW * 0.5f + 0.5f) * target.height;
+
+        minX = min2( minX, x );
+        maxX = max2( maxX, x );
+        minY = min2( minY, y );
+        maxY = max2( maxY, y );
+        minZ = min2( minZ, p.z * invW * 0.5f + 0.5f );
+    }
+
+    // A box that crosses a near plane is always visible, while a box behind it is never visible
+    if( clipped > 0 ) {
+        return clipped < 8;
+    }
+
+    // A box is behind a far plane
+    if( minZ > 1.0f ) {
+        return false;
+    }
+
+    // Find all pixels touched by a screen rectangle
+    s32 x0 = static_cast<s32>( floorf( max2( minX, -1.0f ) ) );
+    s32 x1 = static_cast<s32>( floorf( min2( maxX, static_cast<f32>( target.width ) ) ) );
+    s32 y0 = static_cast<s32>( floorf( max2( minY, -1.0f ) ) );
+    s32 y1 = static_cast<s32>( floorf( min2( maxY, static_cast<f32>( target.height ) ) ) );
+
+    if( x1 < 0 || y1 < 0 || x0 >= target.width || y0 >= target.height ) {
+        return false;
+    }
+
+    x0 = max2( x0, 0 );
+    y0 = max2( y0, 0 );
+    x1 = min2( x1, target.width - 1 );
+    y1 = min2( y1, target.height - 1 );
+
+    // Pick the finest level where a rectangle covers only a few texels
+    s32 level = 0;
+
+    while( level + 1 < levelCount() && ((x1 >> level) - (x0 >> level) >= kMaxTestSpan || (y1 >> level) - (y0 >> level) >= kMaxTestSpan) ) {
+        level++;
+    }
+
+    // A box is visible if it is nearer than the farthest occluder depth of any covered texel
+    const Level& l     = m_levels[level];
+    const f32*   depth = &m_depth[l.offset];
+
+    for( s32 y = y0 >> level; y <= (y1 >> level); y++ ) {
+        for( s32 x = x0 >> level; x <= (x1 >> level); x++ ) {
+            if( minZ <= depth[y * l.width + x] ) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// ** OcclusionCuller::cull
+void OcclusionCuller::cull( const Bounds* bounds, s32 count, Array<s32>& visible ) const
+{
+    visible.clear();
+
+    if( count == 0 ) {
+        return;
+    }
+
+    // Each job writes visibility flags of a range of boxes
+    Array<u8> flags;
+    flags.resize( count );
+
+    s32 jobCount = (count + kBoxesPerJob - 1) / kBoxesPerJob;
+
+    Array<TestJob> jobs;
+    jobs.resize( jobCount );
+
+    for( s32 i = 0; i < jobCount; i++ ) {
+        jobs[i].culler  = this;
+        jobs[i].bounds  = bounds + i * kBoxesPerJob;
+        jobs[i].visible = &flags[i * kBoxesPerJob];
+        jobs[i].count   = min2( kBoxesPerJob, count - i * kBoxesPerJob );
+    }
+
+    if( m_taskManager.valid() && jobCount > 1 ) {
+        Array<Threads::TaskProgressPtr> progress;
+
+        // Queue all jobs except the first one to worker threads
+        for( s32 i = 1; i < jobCount; i++ ) {
+            progress.push_back( m_taskManager->runBackgroundTask( dcStaticFunction( OcclusionCuller::processTestJob ), &jobs[i] ) );
+        }
+
+        // The calling thread processes the first job itself
+        processTestJob( Threads::TaskProgressWPtr(), &jobs[0] );
+
+        for( s32 i = 0, n = static_cast<s32>( progress.size() ); i < n; i++ ) {
+            progress[i]->waitForCompletion();
+        }
+    } else {
+        for( s32 i = 0; i < jobCount; i++ ) {
+            processTestJob( Threads::TaskProgressWPtr(), &jobs[i] );
+        }
+    }
+
+    // Output indices of visible boxes
+    for( s32 i = 0; i < count; i++ ) {
+        if( flags[i] ) {
+            visible.push_back( i );
+        }
+    }
+}
+
+// ** OcclusionCuller::processTestJob
+void OcclusionCuller::processTestJob( Threads::TaskProgressWPtr progress, void* userData )
+{
+    TestJob* job = reinterpret_cast<TestJob*>( userData );
+
+    for( s32 i = 0; i < job->count; i++ ) {
+        job->visible[i] = job->culler->isVisible( job->bounds[i] ) ? 1 : 0;
+    }
+}
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
@@ -0,0 +1,169 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#ifndef __DC_Scene_Rendering_OcclusionCuller_H__
+#define __DC_Scene_Rendering_OcclusionCuller_H__
+
+#include "../Scene.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Scene {
+
+    //! Rejects objects hidden behind occluders by testing their bounds against a software rasterized depth buffer.
+    /*!
+     Occluder triangles are rasterized to a low resolution depth buffer, then a hierarchical Z pyramid is built
+     from it, where each texel stores the farthest depth of four texels from a previous level. A world space
+     bounding box is tested against a pyramid level where its screen rectangle covers only a few texels, so
+     a test costs the same for both small and large objects.
+
+     Rasterization is split to horizontal bands and visibility tests are split to ranges of boxes, each of them
+     is processed by a separate job when a task manager is set. Everything runs on a CPU, so no rendering context
+     is required.
+     */
+    class OcclusionCuller {
+    public:
+
+        //! A width of a depth buffer should be a multiple of this value.
+        enum { Alignment = 4 };
+
+                                    //! Constructs an OcclusionCuller instance.
+                                    OcclusionCuller( s32 width = 256, s32 height = 128 );
+
+        //! Returns a depth buffer width.
+        s32                         width( void ) const;
+
+        //! Returns a depth buffer height.
+        s32                         height( void ) const;
+
+        //! Returns a task manager used to run jobs.
+        Threads::TaskManagerWPtr    taskManager( void ) const;
+
+        //! Sets a task manager used to run jobs, all work is done on a calling thread if no task manager is set.
+        void                        setTaskManager( Threads::TaskManagerWPtr value );
+
+        //! Removes all occluders and sets a view-projection matrix used for both rasterization and visibility tests.
+        void                        begin( const Matrix4& viewProjection );
+
+        //! Adds an indexed triangle list to a set of occluders, positions are read with a specified stride in bytes.
+        void                        addOccluder( const Vec3* positions, s32 stride, const u16* indices, s32 indexCount, const Matrix4& transform );
+
+        //! Adds all chunks of a mesh to a set of occluders.
+        void                        addOccluder( const Mesh& mesh, const Matrix4& transform );
+
+        //! Adds a world space box to a set of occluders, useful for simplified occluder hulls.
+        void                        addOccluder( const Bounds& bounds );
+
+        //! Returns a total number of occluder triangles that survived clipping.
+        s32                         triangleCount( void ) const;
+
+        //! Rasterizes all added occluders and builds a hierarchical depth buffer.
+        void                        rasterize( void );
+
+        //! Returns a total number of pyramid levels.
+        s32                         levelCount( void ) const;
+
+        //! Returns the farthest depth of a pyramid texel, level zero is a rasterized depth buffer.
+        f32                         depthAt( s32 level, s32 x, s32 y ) const;
+
+        //! Returns true if a world space box is inside a view frustum and is not hidden by occluders.
+        bool                        isVisible( const Bounds& bounds ) const;
+
+        //! Tests an array of world space boxes and outputs indices of visible ones in an ascending order.
+        void                        cull( const Bounds* bounds, s32 count, Array<s32>& visible ) const;
+
+    private:
+
+        //! A screen space occluder triangle.
+        struct Triangle {
+            f32                     x[3];       //!< Screen space X coordinates of vertices.
+            f32                     y[3];       //!< Screen space Y coordinates of vertices.
+            f32                     z[3];       //!< Vertex depth values in [0, 1] range.
+            s32                     minX;       //!< The first pixel column covered by a triangle.
+            s32                     maxX;       //!< The last pixel column covered by a triangle.
+            s32                     minY;       //!< The first pixel row covered by a triangle.
+            s32                     maxY;       //!< The last pixel row covered by a triangle.
+        };
+
+        //! A single level of a hierarchical depth buffer.
+        struct Level {
+            s32                     width;      //!< A level width in texels.
+            s32                     height;     //!< A level height in texels.
+            s32                     offset;     //!< An offset of the first texel inside a depth array.
+        };
+
+        //! A job that rasterizes occluders to a band of depth buffer rows.
+        struct RasterJob {
+            OcclusionCuller*        culler;     //!< An occlusion culler instance.
+            s32                     minY;       //!< The first row of a band.
+            s32                     maxY;       //!< The last row of a band.
+        };
+
+        //! A job that tests a range of bounding boxes.
+        struct TestJob {
+            const OcclusionCuller*  culler;     //!< An occlusion culler instance.
+            const Bounds*           bounds;     //!< Bounding boxes to be tested.
+            u8*                     visible;    //!< Receives a visibility flag of each box.
+            s32                     count;      //!< A total number of boxes to be tested.
+        };
+
+        //! Clips a clip space triangle by a near plane and adds resulting triangles to a list.
+        void                        addClipSpaceTriangle( const Vec4& a, const Vec4& b, const Vec4& c );
+
+        //! Projects a triangle to a screen and adds it to a list if it covers at least one pixel row and column.
+        void                        addScreenSpaceTriangle( const Vec4& a, const Vec4& b, const Vec4& c );
+
+        //! Rasterizes all triangles to a band of depth buffer rows.
+        void                        rasterizeBand( s32 minY, s32 maxY );
+
+        //! Rasterizes a single triangle to a band of depth buffer rows.
+        void                        rasterizeTriangle( const Triangle& triangle, s32 minY, s32 maxY );
+
+        //! Builds a pyramid level from a previous one.
+        void                        downsample( const Level& src, const Level& dst );
+
+        //! A job entry point to rasterize a band of rows.
+        static void                 processRasterJob( Threads::TaskProgressWPtr progress, void* userData );
+
+        //! A job entry point to test a range of bounding boxes.
+        static void                 processTestJob( Threads::TaskProgressWPtr progress, void* userData );
+
+    private:
+
+        Threads::TaskManagerWPtr    m_taskManager;      //!< A task manager used to run jobs.
+        Matrix4                     m_viewProjection;   //!< A view-projection matrix.
+        Array<Vec4>                 m_vertices;         //!< Clip space vertices of an occluder being added.
+        Array<Triangle>             m_triangles;        //!< Screen space occluder triangles.
+        Array<Level>                m_levels;           //!< Levels of a depth pyramid.
+        Array<f32>                  m_depth;            //!< Depth values of all pyramid levels.
+    };
+
+} // namespace Scene
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_Scene_Rendering_OcclusionCuller_H__    */
@@ -39,13 +39,17 @@ AmbientPass::AmbientPass( RenderingContext& context, RenderScene& renderScene )
 }
 
 // ** AmbientPass::render
-void AmbientPass::render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack )
+void AmbientPass::render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const Array<s32>* meshes )
 {
     StateScope pass = stateStack.newScope();
     pass->bindProgram( m_shader );
     pass->enableFeatures( ShaderEmissionColor | ShaderAmbientColor );
 
-    RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), frame, commands, stateStack );
+    if( meshes == NULL ) {
+        RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), frame, commands, stateStack );
+    } else if( !meshes->empty() ) {
+        RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), &meshes->front(), static_cast<s32>( meshes->size() ), frame, commands, stateStack );
+    }
     RenderPassBase::emitPointClouds( m_renderScene.pointClouds(), frame, commands, stateStack );
 }
 
@@ -69,7 +73,7 @@ ConstantBuffer_ ShadowPass::cbuffer( void ) const
 }
 
 // ** ShadowPass::render
-TransientTexture ShadowPass::render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const RenderScene::CBuffer::Shadow& parameters )
+TransientTexture ShadowPass::render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const RenderScene::CBuffer::Shadow& parameters, const Array<s32>* casters )
 {
     // Acquire a shadow render target
     s32 dimensions  = static_cast<s32>( 1.0f / parameters.invSize );
@@ -90,8 +94,12 @@ TransientTexture ShadowPass::render( RenderFrame& frame, RenderCommandBuffer& co
     state->bindProgram( m_shader );
     state->setCullFace( Renderer::TriangleFaceFront );
 
-    // Render all static meshes to a target
-    RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), frame, cmd, stateStack );
+    // Render static meshes to a target
+    if( casters == NULL ) {
+        RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), frame, cmd, stateStack, ~0, RenderPassBase::CasterLevel );
+    } else if( !casters->empty() ) {
+        RenderPassBase::emitStaticMeshes( m_renderScene.staticMeshes(), &casters->front(), static_cast<s32>( casters->size() ), frame, cmd, stateStack, ~0, RenderPassBase::CasterLevel );
+    }
 
     return renderTarget;
 }
@@ -41,8 +41,8 @@ namespace Scene {
                                     //! Constructs a AmbientPass instance.
                                     AmbientPass( RenderingContext& context, RenderScene& renderScene );
 
-        //! Emits operations to render an ambient lit scene.
-        void                        render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack );
+        //! Emits operations to render an ambient lit scene, only listed static meshes are rendered when an array of meshes is passed.
+        void                        render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const Array<s32>* meshes = NULL );
 
     private:
 
@@ -56,8 +56,8 @@ namespace Scene {
                                     //! Constructs a ShadowPass instance.
                                     ShadowPass( RenderingContext& context, RenderScene& renderScene );
 
-        //! Emits render operations to output a depth to a texture.
-        TransientTexture            render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const RenderScene::CBuffer::Shadow& parameters );
+        //! Emits render operations to output a depth to a texture, only listed static meshes are rendered when an array of casters is passed.
+        TransientTexture            render( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, const RenderScene::CBuffer::Shadow& parameters, const Array<s32>* casters = NULL );
 
         //! Returns a constant buffer that is used for shadow parameters.
         ConstantBuffer_             cbuffer( void ) const;
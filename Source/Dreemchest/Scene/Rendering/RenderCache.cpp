@@ -46,6 +46,34 @@ RenderCachePtr TestRenderCache::create( Assets::AssetsWPtr assets, RenderingCont
     return DC_NEW TestRenderCache( assets, context );
 }
 
+// ** AbstractRenderCache::indexRanges
+RenderScene::IndexRanges AbstractRenderCache::indexRanges( const Mesh& mesh )
+{
+    RenderScene::IndexRanges ranges;
+
+    for( s32 i = 0, n = mesh.chunkCount(); i < n; i++ ) {
+        RenderScene::IndexRange range;
+        range.offset     = mesh.chunkOffset( i );
+        range.count      = mesh.chunkIndexCount( i );
+        range.baseVertex = mesh.chunkBaseVertex( i );
+
+        if( range.count > 0 ) {
+            ranges.push_back( range );
+        }
+    }
+
+    // A mesh without chunk ranges is rendered by a single draw call
+    if( ranges.empty() ) {
+        RenderScene::IndexRange range;
+        range.offset     = 0;
+        range.count      = static_cast<s32>( mesh.indexBuffer().size() );
+        range.baseVertex = 0;
+        ranges.push_back( range );
+    }
+
+    return ranges;
+}
+
 // ** TestRenderCache::requestInputLayout
 InputLayout TestRenderCache::requestInputLayout( const VertexFormat& format )
 {
@@ -82,6 +110,27 @@ VertexBuffer_ TestRenderCache::requestVertexBuffer( const MeshHandle& mesh )
     return id;
 }
 
+// ** TestRenderCache::updateVertexBuffer
+void TestRenderCache::updateVertexBuffer( const MeshHandle& mesh, s32 firstVertex, s32 count )
+{
+    VertexBuffers::iterator i = m_vertexBuffers.find( mesh.asset().uniqueId() );
+
+    // A vertex buffer will be created from an actual mesh data
+    if( i == m_vertexBuffers.end() ) {
+        return;
+    }
+
+    const Mesh::VertexBuffer& vertices = mesh->vertexBuffer();
+    NIMBLE_ABORT_IF( firstVertex < 0 || firstVertex + count > static_cast<s32>( vertices.size() ), "vertex range is out of bounds" );
+
+    if( count == 0 ) {
+        return;
+    }
+
+    VertexFormat vertexFormat( VertexFormat::Normal | VertexFormat::TexCoord0 | VertexFormat::TexCoord1 );
+    m_context->uploadVertexBuffer( i->second, &vertices[firstVertex], count * vertexFormat.vertexSize(), firstVertex * vertexFormat.vertexSize() );
+}
+
 // ** TestRenderCache::requestIndexBuffer
 IndexBuffer_ TestRenderCache::requestIndexBuffer( const MeshHandle& mesh )
 {
@@ -127,6 +176,7 @@ const TestRenderCache::RenderableNode* TestRenderCache::requestMesh( const MeshH
     RenderableNode* node = DC_NEW RenderableNode;
     node->offset = 0;
     node->count  = asset->indexBuffer().size();
+    node->ranges = indexRanges( *asset );
     node->states.bindVertexBuffer( requestVertexBuffer( asset ) );
     node->states.bindIndexBuffer( requestIndexBuffer( asset ) );
     node->states.bindInputLayout( requestInputLayout( asset->vertexFormat() ) );
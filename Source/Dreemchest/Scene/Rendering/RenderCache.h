@@ -51,9 +51,13 @@ namespace Scene {
         struct RenderableNode {
             s32                         offset;         //!< Render command offset argument.
             s32                         count;          //!< Render command count argument.
+            RenderScene::IndexRanges    ranges;         //!< Index ranges rendered by separate draw calls.
             StateBlock8                 states;         //!< Renderable instance states that is bound right before rendering.
         };
 
+        //! Returns index ranges of mesh chunks, chunks that share an index buffer are rendered with their own base vertices.
+        static RenderScene::IndexRanges         indexRanges( const Mesh& mesh );
+
         virtual                                 ~AbstractRenderCache( void ) {}
 
         //! Creates a material node instance for a specified material or returns a cached one.
@@ -73,6 +77,9 @@ namespace Scene {
 
         //! Requests a new index buffer for a mesh asset or returns a cached one.
         virtual IndexBuffer_                    requestIndexBuffer( const MeshHandle& mesh ) NIMBLE_ABSTRACT;
+
+        //! Uploads a range of mesh vertices to a cached vertex buffer.
+        virtual void                            updateVertexBuffer( const MeshHandle& mesh, s32 firstVertex, s32 count ) NIMBLE_ABSTRACT;
     };
 
 
@@ -90,6 +97,9 @@ namespace Scene {
         //! Requests a new index buffer for a mesh asset or returns a cached one.
         virtual IndexBuffer_                    requestIndexBuffer( const MeshHandle& mesh ) NIMBLE_OVERRIDE;
 
+        //! Uploads a range of mesh vertices to a cached vertex buffer, does nothing if a mesh was not cached yet.
+        virtual void                            updateVertexBuffer( const MeshHandle& mesh, s32 firstVertex, s32 count ) NIMBLE_OVERRIDE;
+
         //! Creates a renderable node instance for a specified mesh or returns a cached one.
         virtual const RenderableNode*           requestMesh( const MeshHandle& asset ) NIMBLE_OVERRIDE;
 
@@ -179,12 +179,17 @@ RenderScene::RenderScene( SceneWPtr scene, Renderer::RenderingContextWPtr contex
     m_staticMeshes  = ecs->createDataCache<StaticMeshCache>( Ecs::Aspect::all<StaticMesh, Transform>(), dcThisMethod( RenderScene::createStaticMeshNode ) );
     m_sprites        = ecs->createDataCache<SpriteCache>( Ecs::Aspect::all<Sprite, Transform>(), dcThisMethod( RenderScene::createSpriteNode ) );
 
+    // Static mesh instance constants are uploaded only when a mesh was added or moved
+    m_movedMeshes   = ecs->requestQuery( "DataCache", Ecs::Aspect::all<StaticMesh, Transform>(), Transform::bit() );
+
     // Create scene constant buffer
     m_sceneConstants  = m_context->deprecatedRequestConstantBuffer( NULL, sizeof( CBuffer::Scene ), CBuffer::Scene::Layout );
     m_sceneParameters = DC_NEW CBuffer::Scene;
     
     // Create a default shader
     m_defaultShader = m_context->deprecatedRequestShader( "../../Source/Dreemchest/Scene/Rendering/Shaders/Null.shader" );
+
+    memset( &m_statistics, 0, sizeof( m_statistics ) );
 }
 
 // ** RenderScene::create
@@ -223,6 +228,18 @@ const RenderScene::Sprites& RenderScene::sprites( void ) const
     return m_sprites->data();
 }
 
+// ** RenderScene::taskManager
+Threads::TaskManagerWPtr RenderScene::taskManager( void ) const
+{
+    return m_taskManager;
+}
+
+// ** RenderScene::setTaskManager
+void RenderScene::setTaskManager( Threads::TaskManagerWPtr value )
+{
+    m_taskManager = value;
+}
+
 // ** RenderScene::cameras
 const RenderScene::Cameras& RenderScene::cameras( void ) const
 {
@@ -243,6 +260,9 @@ Renderer::RenderFrame& RenderScene::captureFrame( void )
     // Update active constant buffers
     updateConstantBuffers( frame );
 
+    // Select levels of detail before any render system emits static meshes
+    selectLods();
+
     // Get a state stack
     Renderer::StateStack& stateStack = frame.stateStack();
 
@@ -282,6 +302,126 @@ Renderer::RenderFrame& RenderScene::captureFrame( void )
     return frame;
 }
 
+// ** RenderScene::statistics
+const RenderScene::Statistics& RenderScene::statistics( void ) const
+{
+    return m_statistics;
+}
+
+// ** RenderScene::selectLods
+void RenderScene::selectLods( void )
+{
+    const StaticMeshes& staticMeshes = m_staticMeshes->data();
+    const Cameras&      cameras      = m_cameras->data();
+    s32                 count        = staticMeshes.count();
+
+    memset( &m_statistics, 0, sizeof( m_statistics ) );
+
+    // Gather inputs of a level of detail selection once for all cameras
+    m_meshBounds.resize( count );
+    m_meshLods.resize( count );
+    m_meshKeys.resize( count );
+
+    for( s32 i = 0; i < count; i++ )
+    {
+        m_meshBounds[i] = staticMeshes[i].mesh->worldSpaceBounds();
+        m_meshLods[i]   = staticMeshes[i].lodGroup;
+        m_meshKeys[i]   = staticMeshes[i].key;
+    }
+
+    for( s32 i = 0, n = cameras.count(); i < n; i++ )
+    {
+        const CameraNode& camera = cameras[i];
+        LodSelector&      lods   = *camera.lods;
+
+        // Select levels for this camera
+        lods.setTaskManager( m_taskManager );
+        lods.select( LodSelector::viewFromCamera( *camera.camera, *camera.viewport, camera.transform->worldSpacePosition() ), count ? &m_meshBounds[0] : NULL, count ? &m_meshLods[0] : NULL, count, count ? &m_meshKeys[0] : NULL );
+
+        // Accumulate the geometry submitted by this camera
+        for( s32 j = 0; j < count; j++ )
+        {
+            const StaticMeshNode& mesh = staticMeshes[j];
+
+            if( mesh.lods.empty() )
+            {
+                m_statistics.meshes++;
+                m_statistics.vertices += mesh.vertices;
+                m_statistics.indices  += mesh.count;
+                continue;
+            }
+
+            s32 level = lods.state( j ).level;
+
+            if( level >= static_cast<s32>( mesh.lods.size() ) )
+            {
+                m_statistics.culled++;
+                continue;
+            }
+
+            m_statistics.meshes++;
+            m_statistics.vertices += mesh.lods[level].vertices;
+            m_statistics.indices  += mesh.lods[level].count;
+        }
+    }
+}
+
+// ** RenderScene::applyLods
+void RenderScene::applyLods( const CameraNode& camera )
+{
+    StaticMeshes&      staticMeshes = m_staticMeshes->data();
+    const LodSelector& lods         = *camera.lods;
+
+    // Levels were not selected for this camera yet
+    if( lods.count() != staticMeshes.count() )
+    {
+        return;
+    }
+
+    for( s32 i = 0, n = staticMeshes.count(); i < n; i++ )
+    {
+        StaticMeshNode& mesh = staticMeshes[i];
+
+        if( mesh.lods.empty() )
+        {
+            continue;
+        }
+
+        // A culled mesh is skipped by render passes
+        s32 level = lods.state( i ).level;
+
+        if( level < static_cast<s32>( mesh.lods.size() ) )
+        {
+            mesh.states = mesh.lods[level].states;
+            mesh.count  = mesh.lods[level].count;
+            mesh.ranges = mesh.lods[level].ranges;
+        }
+        else
+        {
+            mesh.count  = 0;
+        }
+    }
+}
+
+// ** RenderScene::shadowCasterLevel
+RenderScene::StaticMeshNode::Lod RenderScene::shadowCasterLevel( const StaticMeshNode& mesh )
+{
+    for( s32 i = static_cast<s32>( mesh.lods.size() ) - 1; i >= 0; i-- )
+    {
+        if( mesh.lods[i].count > 0 )
+        {
+            return mesh.lods[i];
+        }
+    }
+
+    StaticMeshNode::Lod base;
+    base.states   = mesh.states;
+    base.count    = mesh.count;
+    base.vertices = mesh.vertices;
+    base.ranges   = mesh.ranges;
+    return base;
+}
+
 // ** RenderScene::updateConstantBuffers
 void RenderScene::updateConstantBuffers( Renderer::RenderFrame& frame )
 {
@@ -330,12 +470,12 @@ void RenderScene::updateConstantBuffers( Renderer::RenderFrame& frame )
         commands.uploadConstantBuffer( node.constantBuffer, node.instance.parameters.get(), sizeof( CBuffer::Instance ) );
     }
 
-    // Update static mesh constant buffers
-    StaticMeshes& staticMeshes = m_staticMeshes->data();
+    // Update constant buffers of added and moved static meshes
+    const Ecs::EntityArray& movedMeshes = m_movedMeshes->changed();
 
-    for( s32 i = 0, n = staticMeshes.count(); i < n; i++ )
+    for( s32 i = 0, n = static_cast<s32>( movedMeshes.size() ); i < n; i++ )
     {
-        StaticMeshNode& node = staticMeshes[i];
+        const StaticMeshNode& node = m_staticMeshes->dataFromEntity( movedMeshes[i] );
         node.instance.parameters->transform = node.transform->matrix();
         commands.uploadConstantBuffer( node.constantBuffer, node.instance.parameters.get(), sizeof( CBuffer::Instance ) );
     }
@@ -400,6 +540,7 @@ RenderScene::CameraNode RenderScene::createCameraNode( const Ecs::Entity& entity
     camera.camera           = entity.get<Camera>();
     camera.constantBuffer   = m_context->deprecatedRequestConstantBuffer( NULL, sizeof( CBuffer::View ), CBuffer::View::Layout );
     camera.parameters       = DC_NEW CBuffer::View;
+    camera.lods             = DC_NEW LodSelector;
 
     return camera;
 }
@@ -410,6 +551,7 @@ RenderScene::StaticMeshNode RenderScene::createStaticMeshNode( const Ecs::Entity
     StaticMeshNode mesh;
 
     mesh.mesh = entity.get<StaticMesh>();
+    mesh.key  = entity.handle().value();
 
     initializeInstanceNode( entity, mesh, mesh.mesh->material(0) );
 
@@ -417,14 +559,56 @@ RenderScene::StaticMeshNode RenderScene::createStaticMeshNode( const Ecs::Entity
     /*const Mesh&       data  =*/ asset.readLock();
 
     mesh.count = 0;
+    mesh.vertices = 0;
     mesh.states = NULL;
+    mesh.ranges = NULL;
+    mesh.lodGroup = NULL;
 
     if( const AbstractRenderCache::RenderableNode* cached = m_cache->requestMesh( mesh.mesh->mesh() ) )
     {
-        mesh.states = &cached->states;
-        mesh.count  = cached->count;
+        mesh.states   = &cached->states;
+        mesh.ranges   = &cached->ranges;
+        mesh.count    = cached->count;
+        mesh.vertices = static_cast<s32>( asset->vertexBuffer().size() );
     }
 
+    // Request renderable states of all levels of detail
+    const LodGroup* lodGroup = entity.has<LodGroup>();
+
+    if( lodGroup && lodGroup->levelCount() > 0 )
+    {
+        mesh.lodGroup = lodGroup;
+
+        for( s32 i = 0, n = lodGroup->levelCount(); i < n; i++ )
+        {
+            const MeshHandle& level = lodGroup->mesh( i );
+
+            StaticMeshNode::Lod lod;
+            lod.states   = NULL;
+            lod.count    = 0;
+            lod.vertices = 0;
+            lod.ranges   = NULL;
+
+            if( level.isValid() )
+            {
+                level.readLock();
+            }
+
+            if( const AbstractRenderCache::RenderableNode* cached = m_cache->requestMesh( level ) )
+            {
+                lod.states   = &cached->states;
+                lod.ranges   = &cached->ranges;
+                lod.count    = cached->count;
+                lod.vertices = static_cast<s32>( level->vertexBuffer().size() );
+            }
+
+            mesh.lods.push_back( lod );
+        }
+    }
+
+    // Shadow casters are not switched by a camera, so they do not disappear from shadow maps
+    mesh.caster = shadowCasterLevel( mesh );
+
     return mesh;
 }
 
@@ -28,6 +28,7 @@
 #define __DC_Scene_RenderScene_H__
 
 #include "../Scene.h"
+#include "LodSelector.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -119,6 +120,17 @@ namespace Scene
             };
         };
 
+        //! A range of indices rendered by a single draw call, each index is offset by a base vertex.
+        struct IndexRange
+        {
+            s32                                 offset;             //!< The first index of a range.
+            s32                                 count;              //!< A total number of indices in a range.
+            s32                                 baseVertex;         //!< A value added to each index of a range.
+        };
+
+        //! A container type to store index ranges of a renderable.
+        typedef Array<IndexRange>               IndexRanges;
+
         //! Base class for all renderable entities.
         struct Node
         {
@@ -174,14 +186,30 @@ namespace Scene
             const Camera*                       camera;             //!< Camera component.
             const Viewport*                     viewport;           //!< Output viewport component.
             UPtr<CBuffer::View>              parameters;         //!< View constant buffer.
+            UPtr<LodSelector>                   lods;               //!< Levels of detail of static meshes selected for this camera.
         };
 
         //! Stores info about a static mesh.
         struct StaticMeshNode : public InstanceNode
         {
+            //! Stores renderable states of a single level of detail.
+            struct Lod
+            {
+                const Renderer::StateBlock*     states;             //!< A level renderable state.
+                s32                             count;              //!< A total number of indices in a level mesh.
+                s32                             vertices;           //!< A total number of vertices in a level mesh.
+                const IndexRanges*              ranges;             //!< Index ranges of a level mesh.
+            };
+
             const StaticMesh*                   mesh;               //!< Mesh component.
+            u64                                 key;                //!< An entity handle that identifies a mesh during a level of detail selection.
             s32                                 count;              //!< A total number of indices in a mesh.
+            s32                                 vertices;           //!< A total number of vertices in a mesh.
             const Renderer::StateBlock*   states;             //!< A renderable state.
+            const IndexRanges*                  ranges;             //!< Index ranges rendered by separate draw calls.
+            const LodGroup*                     lodGroup;           //!< Level of detail component or NULL if a mesh has no levels.
+            Array<Lod>                          lods;               //!< Levels of detail, a renderable state and count are switched to a level selected for a rendered camera.
+            Lod                                 caster;             //!< A level rendered to shadow maps, the coarsest one for meshes with levels of detail, so casters are never culled.
         };
 
         //! A fixed array with renderable point clouds inside.
@@ -199,6 +227,15 @@ namespace Scene
         //! A fixed array with sprite nodes inside.
         typedef FixedArray<SpriteNode>          Sprites;
 
+        //! Geometry statistics of a captured frame.
+        struct Statistics
+        {
+            s32                                 meshes;             //!< A total number of static meshes submitted by all cameras.
+            s32                                 culled;             //!< A total number of static meshes culled by a level of detail selection.
+            s32                                 vertices;           //!< A total number of vertices of submitted static meshes.
+            s32                                 indices;            //!< A total number of indices of submitted static meshes.
+        };
+
         //! Returns parent scene.
         SceneWPtr                               scene( void ) const;
 
@@ -220,6 +257,12 @@ namespace Scene
         //! Returns a camera node by a component.
         const CameraNode&                       findCameraNode( Ecs::EntityWPtr camera ) const;
 
+        //! Returns a task manager used by render systems to run jobs.
+        Threads::TaskManagerWPtr                taskManager( void ) const;
+
+        //! Sets a task manager used by render systems to run jobs, like an occlusion culling.
+        void                                    setTaskManager( Threads::TaskManagerWPtr value );
+
         //! Adds a new render system to the scene.
         template<typename TRenderSystem, typename ... TArgs>
         void                                    addRenderSystem( const TArgs& ... args );
@@ -227,6 +270,15 @@ namespace Scene
         //! Captures scene rendering state and returns an array of resulting command buffers.
         Renderer::RenderFrame&                  captureFrame( void );
 
+        //! Returns geometry statistics of a last captured frame.
+        const Statistics&                       statistics( void ) const;
+
+        //! Switches static meshes to levels of detail selected for a camera.
+        void                                    applyLods( const CameraNode& camera );
+
+        //! Returns a level of a static mesh rendered to shadow maps, it is the coarsest valid level of detail or a base mesh.
+        static StaticMeshNode::Lod              shadowCasterLevel( const StaticMeshNode& mesh );
+
         //! Creates a new render scene.
         static RenderScenePtr                   create( SceneWPtr scene, Renderer::RenderingContextWPtr context, RenderCacheWPtr cache );
 
@@ -256,6 +308,9 @@ namespace Scene
         //! Updates all active constant buffers.
         void                                    updateConstantBuffers( Renderer::RenderFrame& frame );
 
+        //! Selects levels of detail of static meshes for each camera and updates frame statistics.
+        void                                    selectLods( void );
+
     private:
 
         //! Entity data cache to store renderable point clouds.
@@ -279,12 +334,18 @@ namespace Scene
         UPtr<CBuffer::Scene>                    m_sceneParameters;  //!< Scene parameters constant buffer.
         Program                                 m_defaultShader;    //!< A default shader that will be used if no shader set by a pass.
         SceneWPtr                               m_scene;            //!< Parent scene instance.
+        Threads::TaskManagerWPtr                m_taskManager;      //!< A task manager used by render systems.
         Array<RenderSystemUPtr>                 m_renderSystems;    //!< Entity render systems.
         Ptr<PointCloudCache>                    m_pointClouds;      //!< Renderable point clouds cache.
         Ptr<LightCache>                         m_lights;           //!< Light nodes cache.
         Ptr<CameraCache>                        m_cameras;          //!< Camera nodes cache.
         Ptr<StaticMeshCache>                    m_staticMeshes;     //!< Static mesh nodes cache.
+        Ecs::QueryPtr                           m_movedMeshes;      //!< Static meshes with changed transforms.
         Ptr<SpriteCache>                        m_sprites;          //!< Sprite nodes cache.
+        Array<Bounds>                           m_meshBounds;       //!< World space bounds of static meshes used by a level of detail selection.
+        Array<const LodGroup*>                  m_meshLods;         //!< Level of detail components of static meshes.
+        Array<u64>                              m_meshKeys;         //!< Entity handles of static meshes.
+        Statistics                              m_statistics;       //!< Geometry statistics of a last captured frame.
     };
 
     // ** RenderScene::addRenderSystem
@@ -59,7 +59,7 @@ void RenderPassBase::renderWithColor( RenderFrame& frame, RenderCommandBuffer& c
 }
 
 // ** RenderPassBase::emitStaticMeshes
-void RenderPassBase::emitStaticMeshes( const RenderScene::StaticMeshes& staticMeshes, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask )
+void RenderPassBase::emitStaticMeshes( const RenderScene::StaticMeshes& staticMeshes, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask, MeshLevel level )
 {
     // Process each mesh entity
     for( s32 i = 0, n = staticMeshes.count(); i < n; i++ ) {
@@ -71,17 +71,59 @@ void RenderPassBase::emitStaticMeshes( const RenderScene::StaticMeshes& staticMe
             continue;
         }
 
-        StateScope materialStates = stateStack.push( mesh.material.states );
-        StateScope renderableStates = stateStack.push( mesh.states );
+        emitStaticMesh( mesh, commands, stateStack, level );
+    }
+}
 
-        StateScope instance = stateStack.newScope();
-        instance->bindConstantBuffer( mesh.constantBuffer, Constants::Instance );
+// ** RenderPassBase::emitStaticMeshes
+void RenderPassBase::emitStaticMeshes( const RenderScene::StaticMeshes& staticMeshes, const s32* indices, s32 count, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask, MeshLevel level )
+{
+    for( s32 i = 0; i < count; i++ ) {
+        // Get mesh entity by index
+        const RenderScene::StaticMeshNode& mesh = staticMeshes[indices[i]];
 
-        if( mesh.material.lighting == LightingModel::Unlit ) {
-            instance->disableFeatures( ShaderAmbientColor );
+        // Skip all meshes that do not pass a specified mask
+        if( (mesh.mask & mask) == 0 ) {
+            continue;
         }
 
-        commands.drawIndexed( 0, Renderer::PrimTriangles, 0, mesh.count );
+        emitStaticMesh( mesh, commands, stateStack, level );
+    }
+}
+
+// ** RenderPassBase::emitStaticMesh
+void RenderPassBase::emitStaticMesh( const RenderScene::StaticMeshNode& mesh, RenderCommandBuffer& commands, StateStack& stateStack, MeshLevel level )
+{
+    const Renderer::StateBlock*     states = mesh.states;
+    s32                             count  = mesh.count;
+    const RenderScene::IndexRanges* ranges = mesh.ranges;
+
+    // Shadow casters ignore a level selected for a camera
+    if( level == CasterLevel ) {
+        states = mesh.caster.states;
+        count  = mesh.caster.count;
+        ranges = mesh.caster.ranges;
+    }
+
+    // Skip meshes culled by a level of detail selection
+    if( count == 0 ) {
+        return;
+    }
+
+    StateScope materialStates = stateStack.push( mesh.material.states );
+    StateScope renderableStates = stateStack.push( states );
+
+    StateScope instance = stateStack.newScope();
+    instance->bindConstantBuffer( mesh.constantBuffer, Constants::Instance );
+
+    if( mesh.material.lighting == LightingModel::Unlit ) {
+        instance->disableFeatures( ShaderAmbientColor );
+    }
+
+    // Chunks that share an index buffer are rendered with their own base vertices
+    for( s32 i = 0, n = static_cast<s32>( ranges->size() ); i < n; i++ ) {
+        const RenderScene::IndexRange& range = (*ranges)[i];
+        commands.drawIndexed( 0, Renderer::PrimTriangles, range.offset, range.count, range.baseVertex );
     }
 }
 
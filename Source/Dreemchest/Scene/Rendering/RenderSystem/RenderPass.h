@@ -40,6 +40,12 @@ namespace Scene
     class RenderPassBase {
     public:
 
+        //! Selects a level of static meshes that is rendered by a pass.
+        enum MeshLevel {
+              CameraLevel       //!< A level selected for a rendered camera.
+            , CasterLevel       //!< A level rendered to shadow maps.
+        };
+
                                                 //! Constructs RenderPassBase instance.
                                                 RenderPassBase( Renderer::RenderingContext& context, RenderScene& renderScene );
 
@@ -56,7 +62,10 @@ namespace Scene
         virtual void                            end( RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack ) {}
 
         //! Emits rendering operations for static meshes that reside in scene.
-        static void                             emitStaticMeshes( const RenderScene::StaticMeshes& staticMeshes, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask = ~0 );
+        static void                             emitStaticMeshes( const RenderScene::StaticMeshes& staticMeshes, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask = ~0, MeshLevel level = CameraLevel );
+
+        //! Emits rendering operations for static meshes with specified indices.
+        static void                             emitStaticMeshes( const RenderScene::StaticMeshes& staticMeshes, const s32* indices, s32 count, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask = ~0, MeshLevel level = CameraLevel );
 
         //! Emits rendering operations for point clouds that reside in scene.
         static void                             emitPointClouds( const RenderScene::PointClouds& pointClouds, RenderFrame& frame, RenderCommandBuffer& commands, StateStack& stateStack, u8 mask = ~0 );
@@ -67,6 +76,11 @@ namespace Scene
         //! Constructs a view constant buffer with an ortho projection.
         static RenderScene::CBuffer::View       orthoView( const Viewport& viewport );
 
+    private:
+
+        //! Emits rendering operations for a single static mesh.
+        static void                             emitStaticMesh( const RenderScene::StaticMeshNode& mesh, RenderCommandBuffer& commands, StateStack& stateStack, MeshLevel level );
+
     protected:
 
         RenderingContext&                       m_context;          //!< A parent rendering context.
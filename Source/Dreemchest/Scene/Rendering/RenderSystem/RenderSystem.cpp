@@ -69,6 +69,9 @@ void RenderSystemBase::render( RenderFrame& frame, RenderCommandBuffer& commands
         StateScope pass = stateStack.newScope();
         pass->bindConstantBuffer( cameraNode.constantBuffer, Constants::Pass );
 
+        // Render static meshes with levels of detail selected for this camera
+        m_renderScene.applyLods( cameraNode );
+
         // Emit render operations for this camera
         emitRenderOperations(frame, cameraCommands, stateStack, entity, camera, transform);
     }
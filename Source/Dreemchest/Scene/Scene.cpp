@@ -93,9 +93,6 @@ Scene::Scene( void )
     // Construct entity component system instance
     m_ecs = Ecs::Ecs::create();
 
-    // Create entity indices
-    m_named        = m_ecs->requestIndex( "Named Entities", Ecs::Aspect::all<Identifier>() );
-
     // Create spatial index
     m_spatial   = DC_NEW Spatial( this );
 
@@ -192,18 +189,13 @@ const Spatial* Scene::spatial( void ) const
 // ** Scene::findAllWithName
 SceneObjectSet Scene::findAllWithName( const String& name ) const
 {
-    const Ecs::EntitySet& entities = m_named->entities();
-    SceneObjectSet objects;
-
-    for( Ecs::EntitySet::const_iterator i = entities.begin(), end = entities.end(); i != end; ++i ) {
-        SceneObjectPtr sceneObject = *i;
-
-        if( sceneObject->get<Identifier>()->name() == name ) {
-            objects.insert( sceneObject );
-        }
-    }
+    return m_ecs->findByName( name );
+}
 
-    return objects;
+// ** Scene::findAllWithName
+SceneObjectSet Scene::findAllWithName( Ecs::NameId name ) const
+{
+    return m_ecs->findByName( name );
 }
 
 // ** Scene::create
@@ -226,8 +218,6 @@ ScenePtr Scene::createFromFile( const Resources& assets, const String& fileName
 ScenePtr Scene::createFromJson( const Resources& assets, const String& json )
 {
 #if DEV_DEPRECATED_SCENE_SERIALIZATION
-
-#ifdef JSONCPP_FOUND
     // Create scene instance
     ScenePtr scene( DC_NEW Scene );
 
@@ -239,10 +229,6 @@ ScenePtr Scene::createFromJson( const Resources& assets, const String& json )
     }
 
     return scene;
-#else
-    LogError( "deserialize", "%s", "failed to load scene, built with no JSON support.\n" );
-    return ScenePtr();
-#endif    /*    #ifdef JSONCPP_FOUND    */
 #else
     NIMBLE_NOT_IMPLEMENTED;
     return ScenePtr();
@@ -253,8 +239,6 @@ ScenePtr Scene::createFromJson( const Resources& assets, const String& json )
 
 // ------------------------------------------------- JsonSceneLoader ------------------------------------------------- //
 
-#ifdef JSONCPP_FOUND
-
 // ** JsonSceneLoader::JsonSceneLoader
 JsonSceneLoader::JsonSceneLoader( const Resources& assets ) : m_assets( assets )
 {
@@ -305,77 +289,79 @@ bool JsonSceneLoader::load( ScenePtr scene, const String& json )
         const Assets::Assets&    m_assets;    //!< Asset bundle to use.        
     };
 
-    Json::Reader reader;
-
-    // Parse the JSON string
-    if( !reader.parse( json, m_json ) ) {
-        return false;
-    }
-
     // Save the scene reference.
     m_scene = scene;
 
     // Construct the particle material instance.
     m_particleMaterialFactory = Fx::IMaterialFactoryPtr( DC_NEW ParticleMaterialFactory( m_assets ) );
 
-    // Read objects from JSON
-    for( Json::ValueIterator i = m_json.begin(), end = m_json.end(); i != end; ++i ) {
-        // Get the instance type.
-        String type = i->get( "class", "" ).asString();
+    // Read records one by one as they are parsed, objects are kept untyped because particle modules use x, y and z keys
+    if( !Io::VariantTextStream::parseMembers( json.c_str(), static_cast<s32>( json.length() ), dcThisMethod( JsonSceneLoader::readRecord ), false ) ) {
+        return false;
+    }
 
-        // Read the scene object.
-        if( type == "SceneObject" ) {
-            requestSceneObject( i.key().asString() );
+    // Link transforms to parents that were read after them
+    for( s32 i = 0, n = static_cast<s32>( m_pendingParents.size() ); i < n; i++ ) {
+        const PendingParent& pending = m_pendingParents[i];
+        Components::iterator parent  = m_components.find( pending.parent );
+
+        if( parent == m_components.end() ) {
+            LogWarning( "deserialize", "unresolved parent transform '%s'\n", pending.parent.c_str() );
             continue;
         }
 
-        // Read the component
-        Ecs::ComponentPtr component = requestComponent( i.key().asString() );
-        NIMBLE_BREAK_IF( !component.valid(), "no such component" );
-
-        // Get the scene object to attach the component to.
-        Ecs::EntityPtr entity = requestSceneObject( i->get( "sceneObject", Json::Value() ).asString() );
-
-        // Attach the component.
-        entity->attachComponent( component.get() );
+        pending.transform->setParent( static_cast<Transform*>( parent->second.get() ) );
     }
 
+    m_pendingParents.clear();
+
     // Update the scene to populate all families and systems
     m_scene->update( 0, 0.0f );
 
     return true;
 }
 
-// ** JsonSceneLoader::requestComponent
-Ecs::ComponentPtr JsonSceneLoader::requestComponent( const String& id )
+// ** JsonSceneLoader::readRecord
+bool JsonSceneLoader::readRecord( const String& id, const Variant& value )
 {
-    Components::iterator i = m_components.find( id );
-
-    if( i != m_components.end() ) {
-        return i->second;
+    if( !value.isValid() || !value.type()->is<KeyValue>() ) {
+        LogWarning( "deserialize", "record '%s' is not an object\n", id.c_str() );
+        return true;
     }
 
-    // Get the data
-    Json::Value data = m_json.get( id, Json::Value() );
+    const KeyValue& data = value.as<KeyValue>();
+
+    // Get the instance type.
+    String type = readString( data.valueAtKey( "class" ) );
 
-    // Get the component type
-    String type = data.get( "class", "" ).asString();
+    // Read the scene object.
+    if( type == "SceneObject" ) {
+        requestSceneObject( id )->attach<Identifier>( readString( data.valueAtKey( "name" ) ) );
+        return true;
+    }
 
     // Get the component loader.
-    ComponentLoaders::iterator j = m_loaders.find( type );
+    ComponentLoaders::iterator i = m_loaders.find( type );
 
-    if( j == m_loaders.end() ) {
+    if( i == m_loaders.end() ) {
         LogError( "deserialize", "unknown component type '%s'\n", type.c_str() );
-        return Ecs::ComponentPtr();
+        return true;
     }
 
     // Read the component.
-    Ecs::ComponentPtr component = j->second( data );
+    Ecs::ComponentPtr component = i->second( data );
+    NIMBLE_BREAK_IF( !component.valid(), "no such component" );
 
     // Save parsed component
     m_components[id] = component;
 
-    return component;
+    // Get the scene object to attach the component to.
+    Ecs::EntityPtr entity = requestSceneObject( readString( data.valueAtKey( "sceneObject" ) ) );
+
+    // Attach the component.
+    entity->attachComponent( component.get() );
+
+    return true;
 }
 
 // ** JsonSceneLoader::requestSceneObject
@@ -387,10 +373,7 @@ Ecs::EntityPtr JsonSceneLoader::requestSceneObject( const String& id )
         return i->second;
     }
 
-    Json::Value data = m_json.get( id, Json::Value() );
     Ecs::EntityPtr sceneObject = m_scene->createSceneObject();
-
-    sceneObject->attach<Identifier>( data["name"].asString() );
     m_sceneObjects[id] = sceneObject;
 
     m_scene->addSceneObject( sceneObject );
@@ -399,73 +382,87 @@ Ecs::EntityPtr JsonSceneLoader::requestSceneObject( const String& id )
 }
 
 // ** JsonSceneLoader::readTransform
-Ecs::ComponentPtr JsonSceneLoader::readTransform( const Json::Value& value )
+Ecs::ComponentPtr JsonSceneLoader::readTransform( const KeyValue& value )
 {
-    Vec3 position = readVec3( value["position"] );
-    Vec3 scale    = readVec3( value["scale"] );
-    Quat rotation = readQuat( value["rotation"] );
+    Vec3 position = readVec3( value.valueAtKey( "position" ) );
+    Vec3 scale    = readVec3( value.valueAtKey( "scale" ) );
+    Quat rotation = readQuat( value.valueAtKey( "rotation" ) );
 
     Transform* result = DC_NEW Transform;
     result->setPosition( Vec3( -position.x, position.y, position.z ) );
     result->setScale( scale );
     result->setRotation( Quat( -rotation.x, rotation.y, rotation.z, -rotation.w ) );
 
-    Json::Value parent = value["parent"];
+    String parent = readString( value.valueAtKey( "parent" ) );
+
+    if( parent != "" ) {
+        Components::iterator i = m_components.find( parent );
 
-    if( parent != Json::nullValue ) {
-        Ecs::ComponentPtr component = requestComponent( parent.asString() );
-        result->setParent( static_cast<Transform*>( component.get() ) );
+        if( i != m_components.end() ) {
+            result->setParent( static_cast<Transform*>( i->second.get() ) );
+        } else {
+            PendingParent pending;
+            pending.transform = result;
+            pending.parent    = parent;
+            m_pendingParents.push_back( pending );
+        }
     }
 
     return result;
 }
 
 // ** JsonSceneLoader::readCamera
-Ecs::ComponentPtr JsonSceneLoader::readCamera( const Json::Value& value )
+Ecs::ComponentPtr JsonSceneLoader::readCamera( const KeyValue& value )
 {
     Camera* result = DC_NEW Camera;
-    result->setFov( value["fov"].asFloat() );
-    result->setNear( value["near"].asFloat() );
-    result->setFar( value["far"].asFloat() );
-    result->setClearColor( readRgba( value["backgroundColor"] ) );
-    result->setNdc( readRect( value["ndc"] ) );
+    result->setFov( readFloat( value.valueAtKey( "fov" ) ) );
+    result->setNear( readFloat( value.valueAtKey( "near" ) ) );
+    result->setFar( readFloat( value.valueAtKey( "far" ) ) );
+    result->setClearColor( readRgba( value.valueAtKey( "backgroundColor" ) ) );
+    result->setNdc( readRect( value.valueAtKey( "ndc" ) ) );
 
     return result;
 }
 
 // ** JsonSceneLoader::readRenderer
-Ecs::ComponentPtr JsonSceneLoader::readRenderer( const Json::Value& value )
+Ecs::ComponentPtr JsonSceneLoader::readRenderer( const KeyValue& value )
 {
     StaticMesh* result = DC_NEW StaticMesh;
-    String        asset  = value["asset"].asString();
+    String        asset  = readString( value.valueAtKey( "asset" ) );
 
     result->setMesh( m_assets.find<Mesh>( asset ) );
 
-    Json::Value materials = value["materials"];
+    const Variant& materials = value.valueAtKey( "materials" );
+
+    for( s32 i = 0; ; i++ ) {
+        Variant material = readItem( materials, i );
 
-    for( u32 i = 0; i < materials.size(); i++ ) {
-        result->setMaterial( i, m_assets.find<Material>( materials[i].asString() ) );
+        if( !material.isValid() ) {
+            break;
+        }
+
+        result->setMaterial( i, m_assets.find<Material>( readString( material ) ) );
     }
 
     return result;
 }
 
 // ** JsonSceneLoader::readLight
-Ecs::ComponentPtr JsonSceneLoader::readLight( const Json::Value& value )
+Ecs::ComponentPtr JsonSceneLoader::readLight( const KeyValue& value )
 {
     LightType types[] = { LightType::Spot, LightType::Directional, LightType::Point };
 
     Light* result = DC_NEW Light;
-    result->setColor( readRgb( value["color"] ) );
-    result->setIntensity( value["intensity"].asFloat() );
-    result->setRange( value["range"].asFloat() );
-    result->setType( types[value["type"].asInt()] );
+    result->setColor( readRgb( value.valueAtKey( "color" ) ) );
+    result->setIntensity( readFloat( value.valueAtKey( "intensity" ) ) );
+    result->setRange( readFloat( value.valueAtKey( "range" ) ) );
+    result->setType( types[readInt( value.valueAtKey( "type" ) )] );
 
     return result;
 }
 
 // ** JsonSceneLoader::readParticles
-Ecs::ComponentPtr JsonSceneLoader::readParticles( const Json::Value& value )
+Ecs::ComponentPtr JsonSceneLoader::readParticles( const KeyValue& value )
 {
     // Create the particle system
     Fx::ParticleSystemPtr particleSystem( DC_NEW Fx::ParticleSystem );
@@ -474,32 +471,37 @@ Ecs::ComponentPtr JsonSceneLoader::readParticles( const Json::Value& value )
     Fx::EmitterWPtr emitter = particleSystem->addEmitter();
 
     // Setup emitter
-    emitter->setLooped( value["isLooped"].asBool() );
-    emitter->setDuration( value["duration"].asFloat() );
+    emitter->setLooped( readBool( value.valueAtKey( "isLooped" ) ) );
+    emitter->setDuration( readFloat( value.valueAtKey( "duration" ) ) );
 
     // Add particles to the emitter
     Fx::ParticlesWPtr particles = emitter->addParticles();
 
     // Setup material
-    particles->setMaterial( value["material"].asString() );
+    particles->setMaterial( readString( value.valueAtKey( "material" ) ) );
 
     // Setup particles
-    for( Json::ValueConstIterator i = value.begin(), end = value.end(); i != end; ++i ) {
-        if( !i->isObject() ) {
+    const KeyValue::Properties& properties = value.properties();
+
+    for( KeyValue::Properties::const_iterator i = properties.begin(), end = properties.end(); i != end; ++i ) {
+        if( !i->second.isValid() || !i->second.type()->is<KeyValue>() ) {
             continue;
         }
 
         // Find the module loader
-        ModuleLoaders::const_iterator j = m_moduleLoaders.find( i.key().asString() );
+        ModuleLoaders::const_iterator j = m_moduleLoaders.find( i->first );
 
         if( j == m_moduleLoaders.end() ) {
-            LogWarning( "deserialize", "unhandled particle module %s\n", i.key().asString().c_str() );
+            LogWarning( "deserialize", "unhandled particle module %s\n", i->first.c_str() );
             continue;
         }
 
-        j->second( particles, *i );
+        j->second( particles, i->second.as<KeyValue>() );
     }
 
+    // Evaluate parameter curves into lookup tables
+    particleSystem->bake();
+
     // Create particles instance
     Fx::ParticleSystemInstancePtr instance = particleSystem->createInstance( m_particleMaterialFactory );
 
@@ -511,19 +513,20 @@ Ecs::ComponentPtr JsonSceneLoader::readParticles( const Json::Value& value )
 }
 
 // ** JsonSceneLoader::readModuleShape
-bool JsonSceneLoader::readModuleShape( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleShape( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
     Fx::EmitterWPtr emitter = particles->emitter();
-    s32             type    = object["type"].asInt();
+    s32             type    = readInt( object.valueAtKey( "type" ) );
+    f32             radius  = readFloat( object.valueAtKey( "radius" ) );
 
     switch( type ) {
     case 4: break;    // not implemented
     case 0:
-    case 1: emitter->setZone( DC_NEW Fx::SphereZone( object["radius"].asFloat() ) ); break;
+    case 1: emitter->setZone( DC_NEW Fx::SphereZone( radius ) ); break;
     case 3:
-    case 2: emitter->setZone( DC_NEW Fx::HemiSphereZone( object["radius"].asFloat() ) ); break;
-    case 5: emitter->setZone( DC_NEW Fx::BoxZone( object["width"].asFloat(), object["height"].asFloat(), object["depth"].asFloat() ) ); break;
-    case 12: emitter->setZone( DC_NEW Fx::LineZone( object["radius"].asFloat() ) ); break;
+    case 2: emitter->setZone( DC_NEW Fx::HemiSphereZone( radius ) ); break;
+    case 5: emitter->setZone( DC_NEW Fx::BoxZone( readFloat( object.valueAtKey( "width" ) ), readFloat( object.valueAtKey( "height" ) ), readFloat( object.valueAtKey( "depth" ) ) ) ); break;
+    case 12: emitter->setZone( DC_NEW Fx::LineZone( radius ) ); break;
     default: NIMBLE_NOT_IMPLEMENTED;
     }
 
@@ -531,40 +534,47 @@ bool JsonSceneLoader::readModuleShape( Fx::ParticlesWPtr particles, const Json::
 }
 
 // ** JsonSceneLoader::readModuleColor
-bool JsonSceneLoader::readModuleColor( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleColor( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
     Fx::Color* color = DC_NEW Fx::Color;
-    readColorParameter( color->get(), object["rgb"] );
+    readColorParameter( color->get(), object.valueAtKey( "rgb" ) );
     particles->addModule( color );
 
     Fx::Transparency* transparency = DC_NEW Fx::Transparency;
-    readScalarParameter( transparency->get(), object["alpha"] );
+    readScalarParameter( transparency->get(), object.valueAtKey( "alpha" ) );
     particles->addModule( transparency );
 
     return true;
 }
 
 // ** JsonSceneLoader::readModuleEmission
-bool JsonSceneLoader::readModuleEmission( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleEmission( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
-    readScalarParameter( particles->emitter()->emission(), object["rate"] );
+    readScalarParameter( particles->emitter()->emission(), object.valueAtKey( "rate" ) );
 
-    Json::Value bursts = object.get( "bursts", Json::Value::null );
+    const Variant& bursts = object.valueAtKey( "bursts" );
 
-    for( s32 i = 0, n = bursts.size() / 2; i < n; i++ ) {
-        particles->emitter()->addBurst( bursts[i * 2 + 0].asFloat(), bursts[i * 2 + 1].asInt() );
+    for( s32 i = 0; ; i++ ) {
+        Variant time  = readItem( bursts, i * 2 + 0 );
+        Variant count = readItem( bursts, i * 2 + 1 );
+
+        if( !time.isValid() || !count.isValid() ) {
+            break;
+        }
+
+        particles->emitter()->addBurst( readFloat( time ), readInt( count ) );
     }
 
     return true;
 }
 
 // ** JsonSceneLoader::readModuleAcceleration
-bool JsonSceneLoader::readModuleAcceleration( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleAcceleration( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
 #if 0
-    readScalarParameter( particles->scalarParameter( Fx::Particles::AccelerationXOverLife ), object["x"] );
-    readScalarParameter( particles->scalarParameter( Fx::Particles::AccelerationYOverLife ), object["y"] );
-    readScalarParameter( particles->scalarParameter( Fx::Particles::AccelerationZOverLife ), object["z"] );
+    readScalarParameter( particles->scalarParameter( Fx::Particles::AccelerationXOverLife ), object.valueAtKey( "x" ) );
+    readScalarParameter( particles->scalarParameter( Fx::Particles::AccelerationYOverLife ), object.valueAtKey( "y" ) );
+    readScalarParameter( particles->scalarParameter( Fx::Particles::AccelerationZOverLife ), object.valueAtKey( "z" ) );
 #else
     NIMBLE_NOT_IMPLEMENTED
 #endif
@@ -572,7 +582,7 @@ bool JsonSceneLoader::readModuleAcceleration( Fx::ParticlesWPtr particles, const
 }
 
 // ** JsonSceneLoader::readModuleVelocity
-bool JsonSceneLoader::readModuleVelocity( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleVelocity( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
     Fx::LinearVelocity* module = DC_NEW Fx::LinearVelocity;
     particles->addModule( module );
@@ -581,9 +591,9 @@ bool JsonSceneLoader::readModuleVelocity( Fx::ParticlesWPtr particles, const Jso
     Fx::FloatParameter& y = module->y();
     Fx::FloatParameter& z = module->z();
 
-    readScalarParameter( x, object["x"] );
-    readScalarParameter( y, object["y"] );
-    readScalarParameter( z, object["z"] );
+    readScalarParameter( x, object.valueAtKey( "x" ) );
+    readScalarParameter( y, object.valueAtKey( "y" ) );
+    readScalarParameter( z, object.valueAtKey( "z" ) );
 
     if( x.samplingMode() == Fx::SampleRandomBetweenConstants ) {
         x.setSamplingMode( Fx::SampleRandomBetweenCurves );
@@ -602,31 +612,31 @@ bool JsonSceneLoader::readModuleVelocity( Fx::ParticlesWPtr particles, const Jso
 }
 
 // ** JsonSceneLoader::readModuleLimitVelocity
-bool JsonSceneLoader::readModuleLimitVelocity( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleLimitVelocity( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
     Fx::LimitVelocity* module = DC_NEW Fx::LimitVelocity;
     particles->addModule( module );
 
-    readScalarParameter( module->get(), object["magnitude"] );
+    readScalarParameter( module->get(), object.valueAtKey( "magnitude" ) );
 
     return true;
 }
 
 // ** JsonSceneLoader::readModuleSize
-bool JsonSceneLoader::readModuleSize( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleSize( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
     Fx::Size* module = DC_NEW Fx::Size;
-    readScalarParameter( module->get(), object["curve"] );
+    readScalarParameter( module->get(), object.valueAtKey( "curve" ) );
     particles->addModule( module );
 
     return true;
 }
 
 // ** JsonSceneLoader::readModuleAngularVelocity
-bool JsonSceneLoader::readModuleAngularVelocity( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleAngularVelocity( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
     Fx::InitialAngularVelocity* module = DC_NEW Fx::InitialAngularVelocity;
-    readScalarParameter( module->get(), object["curve"] );
+    readScalarParameter( module->get(), object.valueAtKey( "curve" ) );
     particles->emitter()->addModule( module );
 
     particles->addModule( DC_NEW Fx::Rotation );
@@ -635,46 +645,46 @@ bool JsonSceneLoader::readModuleAngularVelocity( Fx::ParticlesWPtr particles, co
 }
 
 // ** JsonSceneLoader::readModuleInitial
-bool JsonSceneLoader::readModuleInitial( Fx::ParticlesWPtr particles, const Json::Value& object )
+bool JsonSceneLoader::readModuleInitial( Fx::ParticlesWPtr particles, const KeyValue& object )
 {
-    particles->setCount( object["maxParticles"].asInt() );
+    particles->setCount( readInt( object.valueAtKey( "maxParticles" ) ) );
 
     Fx::EmitterWPtr emitter = particles->emitter();
 
     {
         Fx::InitialColor* module = DC_NEW Fx::InitialColor;
-        readColorParameter( module->get(), object["rgb"] );
+        readColorParameter( module->get(), object.valueAtKey( "rgb" ) );
         emitter->addModule( module );
     }
     {
         Fx::InitialLife* module = DC_NEW Fx::InitialLife;
-        readScalarParameter( module->get(), object["life"] );
+        readScalarParameter( module->get(), object.valueAtKey( "life" ) );
         emitter->addModule( module );
     }
     {
         Fx::InitialTransparency* module = DC_NEW Fx::InitialTransparency;
-        readScalarParameter( module->get(), object["alpha"] );
+        readScalarParameter( module->get(), object.valueAtKey( "alpha" ) );
         emitter->addModule( module );
     }
 
     {
         Fx::InitialSize* module = DC_NEW Fx::InitialSize;
-        readScalarParameter( module->get(), object["size"] );
+        readScalarParameter( module->get(), object.valueAtKey( "size" ) );
         emitter->addModule( module );
     }
     {
         Fx::InitialSpeed* module = DC_NEW Fx::InitialSpeed;
-        readScalarParameter( module->get(), object["speed"] );
+        readScalarParameter( module->get(), object.valueAtKey( "speed" ) );
         emitter->addModule( module );
     }
     {
         Fx::InitialGravity* module = DC_NEW Fx::InitialGravity;
-        readScalarParameter( module->get(), object["gravity"] );
+        readScalarParameter( module->get(), object.valueAtKey( "gravity" ) );
         emitter->addModule( module );
     }
     {
         Fx::InitialRotation* module = DC_NEW Fx::InitialRotation;
-        readScalarParameter( module->get(), object["rotation"] );
+        readScalarParameter( module->get(), object.valueAtKey( "rotation" ) );
         emitter->addModule( module );
     }
 
@@ -682,17 +692,18 @@ bool JsonSceneLoader::readModuleInitial( Fx::ParticlesWPtr particles, const Json
 }
 
 // ** JsonSceneLoader::readColorParameter
-void JsonSceneLoader::readColorParameter( Fx::RgbParameter& parameter, const Json::Value& object )
+void JsonSceneLoader::readColorParameter( Fx::RgbParameter& parameter, const Variant& object )
 {
-    String type = object.get( "type", "" ).asString();
+    KeyValue data = object.isValid() && object.type()->is<KeyValue>() ? object.as<KeyValue>() : KeyValue();
+    String   type = readString( data.valueAtKey( "type" ) );
 
     parameter.setEnabled( true );
 
     if( type == "curve" ) {
-        parameter.setCurve( readFloats( object["value"] ) );
+        parameter.setCurve( readFloats( data.valueAtKey( "value" ) ) );
     }
     else if( type == "constant" ) {
-        parameter.setConstant( readRgb( object["value"] ) );
+        parameter.setConstant( readRgb( data.valueAtKey( "value" ) ) );
     }
     else {
         NIMBLE_NOT_IMPLEMENTED;
@@ -700,29 +711,32 @@ void JsonSceneLoader::readColorParameter( Fx::RgbParameter& parameter, const Jso
 }
 
 // ** JsonSceneLoader::readScalarParameter
-void JsonSceneLoader::readScalarParameter( Fx::FloatParameter& parameter, const Json::Value& object )
+void JsonSceneLoader::readScalarParameter( Fx::FloatParameter& parameter, const Variant& object )
 {
     parameter.setEnabled( true );
 
-    if( object.isDouble() ) {
-        parameter.setConstant( object.asFloat() );
+    if( isNumber( object ) ) {
+        parameter.setConstant( readFloat( object ) );
         return;
     }
 
-    String type = object.get( "type", "" ).asString();
+    KeyValue       data  = object.isValid() && object.type()->is<KeyValue>() ? object.as<KeyValue>() : KeyValue();
+    String         type  = readString( data.valueAtKey( "type" ) );
+    const Variant& value = data.valueAtKey( "value" );
 
     if( type == "curve" ) {
-        parameter.setCurve( readFloats( object["value"] ) );
+        parameter.setCurve( readFloats( value ) );
     }
     else if( type == "constant" ) {
-        parameter.setConstant( object["value"].asFloat() );
+        parameter.setConstant( readFloat( value ) );
     }
     else if( type == "randomBetweenConstants" ) {
-        Fx::FloatArray range = readFloats( object["value"] );
+        Fx::FloatArray range = readFloats( value );
+        range.resize( 2, 0.0f );
         parameter.setRandomBetweenConstants( range[0], range[1] );
     }
     else if( type == "randomBetweenCurves" ) {
-        parameter.setRandomBetweenCurves( readFloats( object["value"][0] ), readFloats( object["value"][1] ) );
+        parameter.setRandomBetweenCurves( readFloats( readItem( value, 0 ) ), readFloats( readItem( value, 1 ) ) );
         parameter.constructLifetimeCurves();
     }
     else {
@@ -733,87 +747,141 @@ void JsonSceneLoader::readScalarParameter( Fx::FloatParameter& parameter, const
 // ** JsonLoaderBase::load
 bool JsonLoaderBase::load( const String& json )
 {
-    Json::Reader reader;
+    return Io::VariantTextStream::parseMembers( json.c_str(), static_cast<s32>( json.length() ), dcThisMethod( JsonLoaderBase::constructObject ), false );
+}
 
-    // Parse the JSON string
-    if( !reader.parse( json, m_json ) ) {
-        return false;
+// ** JsonLoaderBase::constructObject
+bool JsonLoaderBase::constructObject( const String& id, const Variant& value )
+{
+    if( !value.isValid() || !value.type()->is<KeyValue>() ) {
+        return true;
     }
 
-    // Read objects from JSON
-    for( Json::ValueIterator i = m_json.begin(), end = m_json.end(); i != end; ++i ) {
-        // Get the instance type.
-        String type = i->get( "class", "" ).asString();
+    const KeyValue& data = value.as<KeyValue>();
+    Loaders::const_iterator i = m_loaders.find( readString( data.valueAtKey( "class" ) ) );
 
-        // Construct object
-        constructObject( type, *i );
+    if( i == m_loaders.end() ) {
+        return true;
     }
 
+    i->second( data );
     return true;
 }
 
-// ** JsonLoaderBase::constructObject
-bool JsonLoaderBase::constructObject( const String& name, const Json::Value& value )
+// ** JsonLoaderBase::registerLoader
+void JsonLoaderBase::registerLoader( const String& name, const Loader& loader )
 {
-    Loaders::const_iterator i = m_loaders.find( name );
+    m_loaders[name] = loader;
+}
 
-    if( i == m_loaders.end() ) {
+// ** JsonLoaderBase::isNumber
+bool JsonLoaderBase::isNumber( const Variant& value )
+{
+    if( !value.isValid() ) {
         return false;
     }
 
-    return i->second( value );
+    return value.type()->is<s32>() || value.type()->is<u32>() || value.type()->is<s64>() || value.type()->is<f64>();
 }
 
-// ** JsonLoaderBase::registerLoader
-void JsonLoaderBase::registerLoader( const String& name, const Loader& loader )
+// ** JsonLoaderBase::readFloat
+f32 JsonLoaderBase::readFloat( const Variant& value )
 {
-    m_loaders[name] = loader;
+    return isNumber( value ) ? value.as<f32>() : 0.0f;
+}
+
+// ** JsonLoaderBase::readInt
+s32 JsonLoaderBase::readInt( const Variant& value )
+{
+    return isNumber( value ) ? value.as<s32>() : 0;
+}
+
+// ** JsonLoaderBase::readBool
+bool JsonLoaderBase::readBool( const Variant& value )
+{
+    return value.isValid() && value.type()->is<bool>() ? value.as<bool>() : false;
+}
+
+// ** JsonLoaderBase::readString
+String JsonLoaderBase::readString( const Variant& value )
+{
+    return value.isValid() && value.type()->is<String>() ? value.as<String>() : "";
+}
+
+// ** JsonLoaderBase::readItem
+Variant JsonLoaderBase::readItem( const Variant& value, s32 index )
+{
+    if( !value.isValid() || !value.type()->is<VariantArray>() ) {
+        return Variant();
+    }
+
+    VariantArray array = value.as<VariantArray>();
+    const VariantArray::Container& items = array;
+
+    return index < static_cast<s32>( items.size() ) ? items[index] : Variant();
 }
 
 // ** JsonLoaderBase::readVec3
-Vec3 JsonLoaderBase::readVec3( const Json::Value& value )
+Vec3 JsonLoaderBase::readVec3( const Variant& value )
 {
-    return Vec3( value[0].asFloat(), value[1].asFloat(), value[2].asFloat() );
+    Array<f32> v = readFloats( value );
+    v.resize( 3, 0.0f );
+    return Vec3( v[0], v[1], v[2] );
 }
 
 // ** JsonLoaderBase::readRect
-Rect JsonLoaderBase::readRect( const Json::Value& value )
+Rect JsonLoaderBase::readRect( const Variant& value )
 {
-    return Rect( value[0].asFloat(), value[1].asFloat(), value[2].asFloat(), value[3].asFloat() );
+    Array<f32> v = readFloats( value );
+    v.resize( 4, 0.0f );
+    return Rect( v[0], v[1], v[2], v[3] );
 }
 
 // ** JsonLoaderBase::readRgba
-Rgba JsonLoaderBase::readRgba( const Json::Value& value )
+Rgba JsonLoaderBase::readRgba( const Variant& value )
 {
-    return Rgba( value[0].asFloat(), value[1].asFloat(), value[2].asFloat(), value[3].asFloat() );
+    Array<f32> v = readFloats( value );
+    v.resize( 4, 0.0f );
+    return Rgba( v[0], v[1], v[2], v[3] );
 }
 
 // ** JsonLoaderBase::readRgb
-Rgb JsonLoaderBase::readRgb( const Json::Value& value )
+Rgb JsonLoaderBase::readRgb( const Variant& value )
 {
-    return Rgb( value[0].asFloat(), value[1].asFloat(), value[2].asFloat() );
+    Array<f32> v = readFloats( value );
+    v.resize( 3, 0.0f );
+    return Rgb( v[0], v[1], v[2] );
 }
 
 // ** JsonLoaderBase::readQuat
-Quat JsonLoaderBase::readQuat( const Json::Value& value )
+Quat JsonLoaderBase::readQuat( const Variant& value )
 {
-    return Quat( value[0].asFloat(), value[1].asFloat(), value[2].asFloat(), value[3].asFloat() );
+    Array<f32> v = readFloats( value );
+    v.resize( 4, 0.0f );
+    return Quat( v[0], v[1], v[2], v[3] );
 }
 
-// ** JsonLoaderBase::readQuat
-Array<f32> JsonLoaderBase::readFloats( const Json::Value& value )
+// ** JsonLoaderBase::readFloats
+Array<f32> JsonLoaderBase::readFloats( const Variant& value )
 {
     Array<f32> result;
 
-    for( s32 i = 0, n = value.size(); i < n; i++ ) {
-        result.push_back( value[i].asFloat() );
+    if( !value.isValid() || !value.type()->is<VariantArray>() ) {
+        return result;
+    }
+
+    VariantArray array = value.as<VariantArray>();
+    const VariantArray::Container& items = array;
+
+    result.reserve( items.size() );
+
+    for( s32 i = 0, n = static_cast<s32>( items.size() ); i < n; i++ ) {
+        result.push_back( readFloat( items[i] ) );
     }
 
     return result;
 }
 
-#endif    /*    #ifdef JSONCPP_FOUND    */
-
 #endif  /*  #if DEV_DEPRECATED_SCENE_SERIALIZATION    */
 
 } // namespace Scene
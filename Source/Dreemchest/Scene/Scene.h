@@ -50,14 +50,18 @@
 #include <Assets/Assets.h>
 #include <Assets/AssetSource.h>
 
+#include <Threads/Threads.h>
+
 #include <Ecs/Entity/Entity.h>
 #include <Ecs/Entity/DataCache.h>
+#include <Ecs/Entity/NameTable.h>
 #include <Ecs/Component/Component.h>
 #include <Ecs/System/GenericEntitySystem.h>
 #include <Ecs/System/ImmutableEntitySystem.h>
 #include <Ecs/System/SystemGroup.h>
 
 #include <Io/DiskFileSystem.h>
+#include <Io/KeyValue.h>
 #include <Io/streams/Stream.h>
 
 #include <Fx/ParticleSystem.h>
@@ -110,6 +114,7 @@ namespace Scene {
 
     class Transform;
     class StaticMesh;
+    class LodGroup;
     class Sprite;
     class Camera;
     class Viewport;
@@ -260,6 +265,9 @@ namespace Scene {
         //! Returns the list of scene object with specified name.
         SceneObjectSet                    findAllWithName( const String& name ) const;
 
+        //! Returns the list of scene object with specified interned name.
+        SceneObjectSet                    findAllWithName( Ecs::NameId name ) const;
+
         //! Returns a list of scene objects that match a specified aspect.
         SceneObjectSet                    findByAspect( const Ecs::Aspect& aspect ) const;
 
@@ -314,7 +322,6 @@ namespace Scene {
         Ecs::EcsPtr                        m_ecs;                //!< Internal entity component system.
         Ecs::SystemGroupPtr                m_updateSystems;    //!< Update systems group.
         Array<InputSystemPtr>           m_inputSystems;     //!< User input processing systems.
-        Ecs::IndexPtr                    m_named;            //!< All named entities that reside in scene stored inside this family.
         SpatialUPtr                     m_spatial;          //!< Scene spatial index.
     };
 
@@ -377,14 +384,16 @@ namespace Scene {
 
 #if DEV_DEPRECATED_SCENE_SERIALIZATION
 
-#ifdef JSONCPP_FOUND
-
     //! Base class for all JSON object loaders.
+    /*!
+     A JSON text is expected to be an object of records, records are read and constructed one by one
+     without building a document for a whole file.
+     */
     class JsonLoaderBase {
     public:
 
         //! Object loader type.
-        typedef cClosure<bool(const Json::Value&)>    Loader;
+        typedef cClosure<bool(const KeyValue&)>    Loader;
 
         virtual                        ~JsonLoaderBase( void ) {}
 
@@ -396,28 +405,46 @@ namespace Scene {
 
     protected:
 
-        //! Reads the Vec3 from a JSON object.
-        static Vec3                    readVec3( const Json::Value& value );
+        //! Returns true if a value is a number.
+        static bool                    isNumber( const Variant& value );
+
+        //! Reads a float from a number value.
+        static f32                    readFloat( const Variant& value );
+
+        //! Reads an integer from a number value.
+        static s32                    readInt( const Variant& value );
+
+        //! Reads a boolean value.
+        static bool                    readBool( const Variant& value );
+
+        //! Reads a string value.
+        static String                readString( const Variant& value );
+
+        //! Returns an array item or an invalid value.
+        static Variant                readItem( const Variant& value, s32 index );
 
-        //! Reads the Rect from a JSON object.
-        static Rect                    readRect( const Json::Value& value );
+        //! Reads the Vec3 from a JSON array.
+        static Vec3                    readVec3( const Variant& value );
 
-        //! Reads the Rgba from JSON object.
-        static Rgba                    readRgba( const Json::Value& value );
+        //! Reads the Rect from a JSON array.
+        static Rect                    readRect( const Variant& value );
 
-        //! Reads the Rgba from JSON object.
-        static Rgb                    readRgb( const Json::Value& value );
+        //! Reads the Rgba from JSON array.
+        static Rgba                    readRgba( const Variant& value );
 
-        //! Reads the Quat from JSON object.
-        static Quat                    readQuat( const Json::Value& value );
+        //! Reads the Rgba from JSON array.
+        static Rgb                    readRgb( const Variant& value );
 
-        //! Reads the array of floats from JSON object.
-        static Array<f32>            readFloats( const Json::Value& value );
+        //! Reads the Quat from JSON array.
+        static Quat                    readQuat( const Variant& value );
+
+        //! Reads the array of floats from JSON array.
+        static Array<f32>            readFloats( const Variant& value );
 
     private:
 
-        //! Constructs an object from JSON object.
-        bool                        constructObject( const String& name, const Json::Value& value );
+        //! Constructs an object from a JSON record.
+        bool                        constructObject( const String& id, const Variant& value );
 
     private:
 
@@ -425,7 +452,6 @@ namespace Scene {
         typedef Map<String, Loader>    Loaders;
 
         Loaders                        m_loaders;    //!< Object loaders.
-        Json::Value                    m_json;        //!< Parsed JSON object.
     };
 
     //! Loads the scene from JSON file.
@@ -440,67 +466,67 @@ namespace Scene {
 
     private:
 
-        //! Returns the scene object by it's id.
-        Ecs::EntityPtr                requestSceneObject( const String& id );
+        //! Reads a single scene record.
+        bool                        readRecord( const String& id, const Variant& value );
 
-        //! Returns the component by it's id.
-        Ecs::ComponentPtr            requestComponent( const String& id );
+        //! Returns the scene object by it's id, a scene object is created on a first request.
+        Ecs::EntityPtr                requestSceneObject( const String& id );
 
         //! Reads the Transform component from JSON object.
-        Ecs::ComponentPtr            readTransform( const Json::Value& value );
+        Ecs::ComponentPtr            readTransform( const KeyValue& value );
 
         //! Reads the Renderer component from JSON object.
-        Ecs::ComponentPtr            readRenderer( const Json::Value& value );
+        Ecs::ComponentPtr            readRenderer( const KeyValue& value );
 
         //! Reads the Camera component from JSON object.
-        Ecs::ComponentPtr            readCamera( const Json::Value& value );
+        Ecs::ComponentPtr            readCamera( const KeyValue& value );
 
         //! Reads the Light component from JSON object.
-        Ecs::ComponentPtr            readLight( const Json::Value& value );
+        Ecs::ComponentPtr            readLight( const KeyValue& value );
 
         //! Reads the Particles component from JSON object.
-        Ecs::ComponentPtr            readParticles( const Json::Value& value );
+        Ecs::ComponentPtr            readParticles( const KeyValue& value );
 
         //! Reads the shape module from JSON object.
-        bool                        readModuleShape( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleShape( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the color module from JSON object.
-        bool                        readModuleColor( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleColor( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the emission module from JSON object.
-        bool                        readModuleEmission( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleEmission( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the size module from JSON object.
-        bool                        readModuleSize( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleSize( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the rotation module from JSON object.
-        bool                        readModuleAngularVelocity( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleAngularVelocity( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the acceleration module from JSON object.
-        bool                        readModuleAcceleration( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleAcceleration( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the velocity module from JSON object.
-        bool                        readModuleVelocity( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleVelocity( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the limit velocity module from JSON object.
-        bool                        readModuleLimitVelocity( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleLimitVelocity( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the initial module from JSON object.
-        bool                        readModuleInitial( Fx::ParticlesWPtr particles, const Json::Value& object );
+        bool                        readModuleInitial( Fx::ParticlesWPtr particles, const KeyValue& object );
 
         //! Reads the color parameter from JSON object.
-        void                        readColorParameter( Fx::RgbParameter& parameter, const Json::Value& object );
+        void                        readColorParameter( Fx::RgbParameter& parameter, const Variant& object );
 
         //! Reads the scalar parameter from JSON object.
-        void                        readScalarParameter( Fx::FloatParameter& parameter, const Json::Value& object );
+        void                        readScalarParameter( Fx::FloatParameter& parameter, const Variant& object );
 
     private:
 
         //! Component loader type.
-        typedef cClosure<Ecs::ComponentPtr(const Json::Value&)> ComponentLoader;
+        typedef cClosure<Ecs::ComponentPtr(const KeyValue&)> ComponentLoader;
 
         //! Particle system module loader
-        typedef cClosure<bool(Fx::ParticlesWPtr, const Json::Value&)> ModuleLoader;
+        typedef cClosure<bool(Fx::ParticlesWPtr, const KeyValue&)> ModuleLoader;
 
         //! Container type to store particle module loaders.
         typedef Map<String, ModuleLoader>    ModuleLoaders;
@@ -514,18 +540,25 @@ namespace Scene {
         //! Container type to store parsed components.
         typedef Map<String, Ecs::ComponentPtr> Components;
 
+        //! Transform parent that is resolved once all records are read.
+        struct PendingParent {
+            Transform*                transform;    //!< A transform to be linked.
+            String                    parent;        //!< A parent transform record id.
+        };
+
+        //! Container type to store unresolved transform parents.
+        typedef Array<PendingParent> PendingParents;
+
         const Resources&            m_assets;                    //!< Available assets.
-        Json::Value                    m_json;                        //!< Parsed JSON.
         ScenePtr                    m_scene;                    //!< The scene to be loaded.
         SceneObjects                m_sceneObjects;                //!< Parsed scene objects.
         Components                    m_components;                //!< Parsed components.
+        PendingParents                m_pendingParents;            //!< Transform parents referenced before they were read.
         ComponentLoaders            m_loaders;                    //!< Available component loaders.
         ModuleLoaders                m_moduleLoaders;            //!< Available module loaders.
         Fx::IMaterialFactoryPtr        m_particleMaterialFactory;    //!< Constructs particle system materials.
     };
 
-#endif    /*    #ifdef JSONCPP_FOUND    */
-
 #endif  /*  #if DEV_DEPRECATED_SCENE_SERIALIZATION    */
 
 } // namespace Scene
@@ -539,9 +572,12 @@ DC_END_DREEMCHEST
     #include "Components/Physics.h"
     #include "Components/Debug.h"
     #include "Assets/Mesh.h"
+    #include "Assets/MeshOptimizer.h"
     #include "Assets/Material.h"
     #include "Assets/Image.h"
     #include "Assets/Terrain.h"
+    #include "Assets/TerrainQuadTree.h"
+    #include "Assets/TerrainRayCaster.h"
     #include "Assets/Prefab.h"
     #include "Assets/AssetFileSources.h"
     #include "Assets/AssetGenerators.h"
@@ -551,6 +587,8 @@ DC_END_DREEMCHEST
     #include "Systems/CullingSystems.h"
     #include "Rendering/RenderScene.h"
     #include "Rendering/RenderCache.h"
+    #include "Rendering/OcclusionCuller.h"
+    #include "Rendering/LodSelector.h"
     #include "Rendering/Debug/ForwardRenderSystem.h"
     #include "Rendering/Debug/SpriteRenderSystem.h"
     #include "Rendering/Debug/DebugRenderSystem.h"
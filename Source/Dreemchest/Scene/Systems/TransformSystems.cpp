@@ -77,10 +77,19 @@ void AffineTransformSystem::entityRemoved( const Ecs::Entity& entity )
 
 // -------------------------------------------- WorldSpaceBoundingBoxSystem -------------------------------------------- //
 
+// ** WorldSpaceBoundingBoxSystem::WorldSpaceBoundingBoxSystem
+WorldSpaceBoundingBoxSystem::WorldSpaceBoundingBoxSystem( void )
+{
+    // Bounds are recalculated only for moved or modified meshes
+    processChangesOnly( Ecs::Aspect::expandComponentBits<StaticMesh, Transform>() );
+}
+
 // ** WorldSpaceBoundingBoxSystem::process
 void WorldSpaceBoundingBoxSystem::process( u32 currentTime, f32 dt, Ecs::Entity& sceneObject, StaticMesh& staticMesh, Transform& transform )
 {
+    // Revisit this mesh on the next update until it is loaded
     if( !staticMesh.mesh().isLoaded() ) {
+        staticMesh.markChanged();
         return;
     }
 
@@ -57,6 +57,11 @@ namespace Scene {
 
     //! World space bounding box system calculates bounding volumes for static meshes in scene.
     class WorldSpaceBoundingBoxSystem : public Ecs::GenericEntitySystem<WorldSpaceBoundingBoxSystem, StaticMesh, Transform> {
+    public:
+
+                            //! Constructs WorldSpaceBoundingBoxSystem instance.
+                            WorldSpaceBoundingBoxSystem( void );
+
     protected:
 
         //! Calculates the world space bounds for static mesh.
@@ -0,0 +1,71 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "PcmSoundDecoder.h"
+#include "../SoundStream.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+// ** PcmSoundDecoder::PcmSoundDecoder
+PcmSoundDecoder::PcmSoundDecoder( Io::ByteBufferPtr pcm, u32 rate, SoundSampleFormat format )
+{
+    NIMBLE_ABORT_IF( !pcm.valid(), "invalid PCM data" );
+
+    pcm->setPosition( 0 );
+    SoundDecoder::open( DC_NEW MemorySoundStream( pcm ) );
+
+    m_rate   = rate;
+    m_format = format;
+}
+
+// ** PcmSoundDecoder::~PcmSoundDecoder
+PcmSoundDecoder::~PcmSoundDecoder( void )
+{
+}
+
+// ** PcmSoundDecoder::size
+u32 PcmSoundDecoder::size( void ) const
+{
+    return m_stream->length();
+}
+
+// ** PcmSoundDecoder::read
+u32 PcmSoundDecoder::read( u8 *buffer, u32 size )
+{
+    return m_stream->read( buffer, size );
+}
+
+// ** PcmSoundDecoder::seek
+void PcmSoundDecoder::seek( u32 pos )
+{
+    m_stream->setPosition( pos );
+}
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
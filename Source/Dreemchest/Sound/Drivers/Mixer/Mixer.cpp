@@ -0,0 +1,330 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "Mixer.h"
+
+#include "MixerSource.h"
+#include "MixerBuffer.h"
+
+#include "../../Decoders/SoundDecoder.h"
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+    #define DC_SOUND_SIMD_SSE
+    #include <xmmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+    #define DC_SOUND_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+// ** mixAdd
+static void mixAdd( f32* output, const f32* input, f32 gain, u32 count )
+{
+    u32 i = 0;
+
+#if defined( DC_SOUND_SIMD_SSE )
+    __m128 g = _mm_set1_ps( gain );
+
+    for( ; i + 4 <= count; i += 4 ) {
+        _mm_storeu_ps( output + i, _mm_add_ps( _mm_loadu_ps( output + i ), _mm_mul_ps( _mm_loadu_ps( input + i ), g ) ) );
+    }
+#elif defined( DC_SOUND_SIMD_NEON )
+    float32x4_t g = vdupq_n_f32( gain );
+
+    for( ; i + 4 <= count; i += 4 ) {
+        vst1q_f32( output + i, vmlaq_f32( vld1q_f32( output + i ), vld1q_f32( input + i ), g ) );
+    }
+#endif
+
+    // Mix the rest of samples
+    for( ; i < count; i++ ) {
+        output[i] += input[i] * gain;
+    }
+}
+
+// ** writeWavHeader
+static void writeWavHeader( Io::StreamWPtr stream, u32 rate, u32 dataSize )
+{
+    u32 fileSize    = dataSize + 36;
+    u32 formatSize  = 16;
+    u16 formatTag   = 1;
+    u16 channels    = 2;
+    u32 byteRate    = rate * 4;
+    u16 blockAlign  = 4;
+    u16 bits        = 16;
+
+    stream->write( "RIFF", 4 );
+    stream->write( &fileSize, sizeof( fileSize ) );
+    stream->write( "WAVE", 4 );
+    stream->write( "fmt ", 4 );
+    stream->write( &formatSize, sizeof( formatSize ) );
+    stream->write( &formatTag, sizeof( formatTag ) );
+    stream->write( &channels, sizeof( channels ) );
+    stream->write( &rate, sizeof( rate ) );
+    stream->write( &byteRate, sizeof( byteRate ) );
+    stream->write( &blockAlign, sizeof( blockAlign ) );
+    stream->write( &bits, sizeof( bits ) );
+    stream->write( "data", 4 );
+    stream->write( &dataSize, sizeof( dataSize ) );
+}
+
+// ** Mixer::Mixer
+Mixer::Mixer( u32 rate )
+    : m_rate( rate )
+    , m_volume( 1.0f )
+    , m_pitch( 1.0f )
+    , m_distanceModel( InverseDistanceAttenuation )
+    , m_mixedVoices( 0 )
+{
+    m_voice.resize( BlockFrames * 2 );
+}
+
+Mixer::~Mixer( void )
+{
+    // Sources may outlive a mixer, so detach them
+    for( s32 i = 0, n = static_cast<s32>( m_sources.size() ); i < n; i++ ) {
+        m_sources[i]->m_mixer = NULL;
+    }
+}
+
+// ** Mixer::initialize
+bool Mixer::initialize( void )
+{
+    LogVerbose( "mixer", "software mixer initialized, rate=%d\n", m_rate );
+    return true;
+}
+
+// ** Mixer::createSource
+SoundSourcePtr Mixer::createSource( void )
+{
+    return DC_NEW MixerSource( this );
+}
+
+// ** Mixer::createBuffer
+SoundBufferPtr Mixer::createBuffer( SoundDecoderPtr decoder, u32 chunks )
+{
+    NIMBLE_ABORT_IF( !decoder.valid(), "invalid decoder" );
+    return DC_NEW MixerBuffer( decoder, chunks );
+}
+
+// ** Mixer::setPosition
+void Mixer::setPosition( const Vec3& value )
+{
+    m_position = value;
+}
+
+// ** Mixer::setVolume
+void Mixer::setVolume( f32 value )
+{
+    m_volume = value;
+}
+
+// ** Mixer::setPitch
+void Mixer::setPitch( f32 value )
+{
+    m_pitch = value;
+}
+
+// ** Mixer::setDistanceModel
+void Mixer::setDistanceModel( DistanceModel value )
+{
+    m_distanceModel = value;
+}
+
+// ** Mixer::rate
+u32 Mixer::rate( void ) const
+{
+    return m_rate;
+}
+
+// ** Mixer::mixedVoices
+u64 Mixer::mixedVoices( void ) const
+{
+    return m_mixedVoices;
+}
+
+// ** Mixer::addSource
+void Mixer::addSource( MixerSource* source )
+{
+    m_sources.push_back( source );
+}
+
+// ** Mixer::removeSource
+void Mixer::removeSource( MixerSource* source )
+{
+    Array<MixerSource*>::iterator i = std::find( m_sources.begin(), m_sources.end(), source );
+    NIMBLE_BREAK_IF( i == m_sources.end(), "removing unknown sound source" );
+
+    if( i != m_sources.end() ) {
+        m_sources.erase( i );
+    }
+}
+
+// ** Mixer::render
+void Mixer::render( f32* output, u32 frames )
+{
+    memset( output, 0, frames * 2 * sizeof( f32 ) );
+
+    for( u32 offset = 0; offset < frames; offset += BlockFrames ) {
+        mixBlock( output + offset * 2, min2<u32>( BlockFrames, frames - offset ) );
+    }
+}
+
+// ** Mixer::renderToWav
+bool Mixer::renderToWav( Io::StreamWPtr stream, u32 frames )
+{
+    if( !stream.valid() ) {
+        LogError( "mixer", "failed to render %d frames, invalid output stream\n", frames );
+        return false;
+    }
+
+    writeWavHeader( stream, m_rate, frames * 4 );
+
+    f32 bus[BlockFrames * 2];
+    s16 pcm[BlockFrames * 2];
+
+    for( u32 offset = 0; offset < frames; offset += BlockFrames ) {
+        u32 count = min2<u32>( BlockFrames, frames - offset );
+
+        render( bus, count );
+
+        for( u32 i = 0; i < count * 2; i++ ) {
+            pcm[i] = static_cast<s16>( max2( -1.0f, min2( bus[i], 1.0f ) ) * 32767.0f );
+        }
+
+        stream->write( pcm, count * 2 * sizeof( s16 ) );
+    }
+
+    return true;
+}
+
+// ** Mixer::mixBlock
+void Mixer::mixBlock( f32* output, u32 frames )
+{
+    for( s32 i = 0, n = static_cast<s32>( m_sources.size() ); i < n; i++ ) {
+        MixerSource* source = m_sources[i];
+
+        if( source->m_state != SoundSource::Playing || !source->m_buffer.valid() ) {
+            continue;
+        }
+
+        if( !mixSource( source, output, frames ) ) {
+            source->m_state = SoundSource::Stopped;
+        }
+
+        m_mixedVoices++;
+    }
+}
+
+// ** Mixer::mixSource
+bool Mixer::mixSource( MixerSource* source, f32* output, u32 frames )
+{
+    MixerBuffer* buffer   = static_cast<MixerBuffer*>( source->m_buffer.get() );
+    u32          channels = buffer->channels();
+    f64          step     = f64( source->m_pitch ) * m_pitch * buffer->rate() / m_rate;
+
+    if( step <= 0.0 ) {
+        return true;
+    }
+
+    f32* voice    = &m_voice[0];
+    u32  produced = 0;
+    bool playing  = true;
+
+    while( produced < frames ) {
+        u32 frame = static_cast<u32>( source->m_cursor );
+        f64 local = source->m_cursor - frame;
+
+        // Request enough frames to produce the rest of a block, plus one for interpolation
+        u32        count   = static_cast<u32>( ( frames - produced ) * step + local ) + 2;
+        const f32* samples = buffer->samples( frame, count );
+
+        if( !samples ) {
+            // Reached the end of a sound - either rewind or stop
+            if( source->m_isLooped && buffer->frameCount() && source->m_cursor >= buffer->frameCount() ) {
+                source->m_cursor = fmod( source->m_cursor, f64( buffer->frameCount() ) );
+                continue;
+            }
+
+            playing = false;
+            break;
+        }
+
+        // Interpolate output frames while both neighbouring samples are available
+        u32 remaining = frames - produced;
+        f64 limit     = count - 1;
+        f64 pos       = local;
+        u32 n         = 0;
+
+        if( channels == 1 ) {
+            for( ; n < remaining && pos < limit; n++, pos += step ) {
+                u32 i = static_cast<u32>( pos );
+                f32 f = static_cast<f32>( pos - i );
+                f32 s = samples[i] + ( samples[i + 1] - samples[i] ) * f;
+                voice[0] = s;
+                voice[1] = s;
+                voice += 2;
+            }
+        } else {
+            for( ; n < remaining && pos < limit; n++, pos += step ) {
+                u32        i = static_cast<u32>( pos );
+                f32        f = static_cast<f32>( pos - i );
+                const f32* a = samples + i * 2;
+                voice[0] = a[0] + ( a[2] - a[0] ) * f;
+                voice[1] = a[1] + ( a[3] - a[1] ) * f;
+                voice += 2;
+            }
+        }
+
+        source->m_cursor = frame + pos;
+        produced += n;
+    }
+
+    // Only mono sources are spatialized, same as hardware implementations do
+    f32 gain = source->m_volume * m_volume;
+
+    if( channels == 1 ) {
+        gain *= attenuation( source );
+    }
+
+    mixAdd( output, &m_voice[0], gain, produced * 2 );
+
+    return playing;
+}
+
+// ** Mixer::attenuation
+f32 Mixer::attenuation( const MixerSource* source ) const
+{
+    f32 distance = source->m_isRelative ? source->m_position.length() : ( source->m_position - m_position ).length();
+    return SoundEngine::attenuation( m_distanceModel, distance, source->m_referenceDistance, source->m_maximumDistance, source->m_rolloffFactor );
+}
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
@@ -0,0 +1,110 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Sound_Mixer_H__
+#define __DC_Sound_Mixer_H__
+
+#include "../SoundEngine.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+    class MixerSource;
+
+    //! Software sound engine that mixes all playing sources into an interleaved stereo float bus.
+    /*!
+     Mixer does not output sound to a device, the mixed audio is pulled by calling render or renderToWav,
+     so it can be used for headless tests, profiling and offline rendering faster than in real time.
+     */
+    class Mixer : public SoundEngine {
+    friend class MixerSource;
+    public:
+
+        //! Default output sample rate.
+        enum { DefaultRate = 44100 };
+
+        //! The number of frames mixed at once, the render call is split into blocks of this size.
+        enum { BlockFrames = 512 };
+
+                                Mixer( u32 rate = DefaultRate );
+        virtual                 ~Mixer( void );
+
+        // ** SoundEngine
+        virtual bool            initialize( void ) NIMBLE_OVERRIDE;
+        virtual SoundSourcePtr  createSource( void ) NIMBLE_OVERRIDE;
+        virtual SoundBufferPtr  createBuffer( SoundDecoderPtr decoder, u32 chunks ) NIMBLE_OVERRIDE;
+        virtual void            setPosition( const Vec3& value ) NIMBLE_OVERRIDE;
+        virtual void            setVolume( f32 value ) NIMBLE_OVERRIDE;
+        virtual void            setPitch( f32 value ) NIMBLE_OVERRIDE;
+        virtual void            setDistanceModel( DistanceModel value ) NIMBLE_OVERRIDE;
+
+        //! Returns the output sample rate.
+        u32                     rate( void ) const;
+
+        //! Returns the total number of voices mixed so far, each source counts once per mixed block.
+        u64                     mixedVoices( void ) const;
+
+        //! Mixes a specified number of stereo frames into an interleaved float buffer.
+        void                    render( f32* output, u32 frames );
+
+        //! Mixes a specified number of frames and writes them to a stream as a 16-bit stereo WAV file.
+        bool                    renderToWav( Io::StreamWPtr stream, u32 frames );
+
+    private:
+
+        //! Mixes a single block of frames.
+        void                    mixBlock( f32* output, u32 frames );
+
+        //! Resamples a source into the voice buffer and adds it to an output, returns false if the source has ended.
+        bool                    mixSource( MixerSource* source, f32* output, u32 frames );
+
+        //! Calculates the distance attenuation for a source.
+        f32                     attenuation( const MixerSource* source ) const;
+
+        //! Registers a created source.
+        void                    addSource( MixerSource* source );
+
+        //! Unregisters a destroyed source.
+        void                    removeSource( MixerSource* source );
+
+    private:
+
+        u32                     m_rate;             //!< Output sample rate.
+        f32                     m_volume;           //!< Master volume.
+        f32                     m_pitch;            //!< Master pitch.
+        Vec3                    m_position;         //!< Listener position.
+        DistanceModel           m_distanceModel;    //!< Distance attenuation model.
+        Array<MixerSource*>     m_sources;          //!< All alive sources.
+        Array<f32>              m_voice;            //!< Resampled stereo frames of a single source.
+        u64                     m_mixedVoices;      //!< The total number of mixed voices.
+    };
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
+
+#endif        /*    __DC_Sound_Mixer_H__    */
@@ -0,0 +1,185 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "MixerBuffer.h"
+
+#include "../../Decoders/SoundDecoder.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+// ** MixerBuffer::MixerBuffer
+MixerBuffer::MixerBuffer( SoundDecoderPtr decoder, u32 chunks )
+    : SoundBuffer( decoder, chunks )
+    , m_channels( 1 )
+    , m_sampleSize( 1 )
+    , m_frameCount( 0 )
+    , m_windowStart( 0 )
+    , m_bytesRead( 0 )
+    , m_isEndOfStream( false )
+{
+    switch( m_format ) {
+    case SoundSampleMono8:      m_channels = 1; m_sampleSize = 1; break;
+    case SoundSampleMono16:     m_channels = 1; m_sampleSize = 2; break;
+    case SoundSampleStereo8:    m_channels = 2; m_sampleSize = 1; break;
+    case SoundSampleStereo16:   m_channels = 2; m_sampleSize = 2; break;
+    }
+
+    m_frameCount = static_cast<u32>( m_size / ( m_channels * m_sampleSize ) );
+
+    if( !isStreamed() ) {
+        // Decode the whole sound at once
+        m_samples.reserve( ( m_frameCount + 1 ) * m_channels );
+        while( decodeChunk() ) {}
+    }
+}
+
+// ** MixerBuffer::channels
+u32 MixerBuffer::channels( void ) const
+{
+    return m_channels;
+}
+
+// ** MixerBuffer::frameCount
+u32 MixerBuffer::frameCount( void ) const
+{
+    return m_frameCount;
+}
+
+// ** MixerBuffer::isStreamed
+bool MixerBuffer::isStreamed( void ) const
+{
+    return m_chunks > 1;
+}
+
+// ** MixerBuffer::samples
+const f32* MixerBuffer::samples( u32 frame, u32& count )
+{
+    if( frame >= m_frameCount ) {
+        return NULL;
+    }
+
+    if( isStreamed() ) {
+        // Looped sources jump back to the beginning
+        if( frame < m_windowStart ) {
+            rewind();
+        }
+
+        // Drop frames that were already consumed
+        u32 consumed = frame - m_windowStart;
+
+        if( consumed >= StreamChunkFrames ) {
+            m_samples.erase( m_samples.begin(), m_samples.begin() + consumed * m_channels );
+            m_windowStart += consumed;
+        }
+
+        // Decode until a requested range is available
+        while( m_windowStart + windowFrames() < frame + count && decodeChunk() ) {}
+    }
+
+    u32 offset = frame - m_windowStart;
+    u32 frames = windowFrames();
+
+    if( offset + 1 >= frames ) {
+        return NULL;
+    }
+
+    count = min2( count, frames - offset );
+    return &m_samples[offset * m_channels];
+}
+
+// ** MixerBuffer::windowFrames
+u32 MixerBuffer::windowFrames( void ) const
+{
+    return static_cast<u32>( m_samples.size() ) / m_channels;
+}
+
+// ** MixerBuffer::rewind
+void MixerBuffer::rewind( void )
+{
+    m_decoder->seek( 0 );
+    m_samples.clear();
+    m_windowStart   = 0;
+    m_bytesRead     = 0;
+    m_isEndOfStream = false;
+}
+
+// ** MixerBuffer::decodeChunk
+bool MixerBuffer::decodeChunk( void )
+{
+    if( m_isEndOfStream ) {
+        return false;
+    }
+
+    u32 frameSize = m_channels * m_sampleSize;
+    u32 size      = min2<u32>( StreamChunkFrames * frameSize, static_cast<u32>( m_size ) - m_bytesRead );
+    u32 read      = 0;
+
+    if( size ) {
+        m_pcm.resize( size );
+        read = m_decoder->read( &m_pcm[0], size );
+    }
+
+    // Append a silent guard frame after the last one, so interpolation never reads past the end
+    if( read == 0 ) {
+        m_samples.resize( m_samples.size() + m_channels, 0.0f );
+        m_isEndOfStream = true;
+        return false;
+    }
+
+    m_bytesRead += read;
+    appendPcm( &m_pcm[0], read - read % frameSize );
+
+    return true;
+}
+
+// ** MixerBuffer::appendPcm
+void MixerBuffer::appendPcm( const u8* pcm, u32 size )
+{
+    u32 offset = static_cast<u32>( m_samples.size() );
+    u32 count  = size / m_sampleSize;
+
+    m_samples.resize( offset + count );
+    f32* output = &m_samples[offset];
+
+    if( m_sampleSize == 1 ) {
+        // 8-bit samples are unsigned
+        for( u32 i = 0; i < count; i++ ) {
+            output[i] = ( static_cast<f32>( pcm[i] ) - 128.0f ) / 128.0f;
+        }
+    } else {
+        for( u32 i = 0; i < count; i++ ) {
+            s16 sample;
+            memcpy( &sample, pcm + i * 2, sizeof( s16 ) );
+            output[i] = sample / 32768.0f;
+        }
+    }
+}
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
@@ -0,0 +1,98 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Sound_MixerBuffer_H__
+#define __DC_Sound_MixerBuffer_H__
+
+#include "Mixer.h"
+#include "../SoundBuffer.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+    //! Sound buffer that holds PCM samples converted to floats for a software mixer.
+    /*!
+     A buffer with a single chunk is decoded once on construction. Streamed buffers keep a window of
+     decoded frames that is advanced on demand while a source is mixed.
+     */
+    class MixerBuffer : public SoundBuffer {
+    public:
+
+        //! The number of frames decoded at once by a streamed buffer.
+        enum { StreamChunkFrames = 4096 };
+
+                                MixerBuffer( SoundDecoderPtr decoder, u32 chunks );
+
+        //! Returns the number of interleaved channels.
+        u32                     channels( void ) const;
+
+        //! Returns the total number of frames.
+        u32                     frameCount( void ) const;
+
+        //! Returns decoded samples starting at a specified frame.
+        /*!
+         \param frame The first frame to return.
+         \param count The number of requested frames, on return contains the number of available ones.
+                      Available frames include a silent guard frame after the last one, so a pair of frames is always available for interpolation.
+         \return Pointer to interleaved samples, or NULL if the frame is past the end of a sound.
+         */
+        const f32*              samples( u32 frame, u32& count );
+
+    private:
+
+        //! Returns true if a buffer decodes a sound on demand.
+        bool                    isStreamed( void ) const;
+
+        //! Returns the number of decoded frames available in a window.
+        u32                     windowFrames( void ) const;
+
+        //! Rewinds a streamed sound to the beginning.
+        void                    rewind( void );
+
+        //! Decodes a next chunk of a sound, returns false if there is no more data.
+        bool                    decodeChunk( void );
+
+        //! Converts PCM bytes to float samples and appends them.
+        void                    appendPcm( const u8* pcm, u32 size );
+
+    private:
+
+        u32                     m_channels;     //!< The number of interleaved channels.
+        u32                     m_sampleSize;   //!< The size of a single PCM sample in bytes.
+        u32                     m_frameCount;   //!< The total number of frames.
+        u32                     m_windowStart;  //!< The first decoded frame of a streamed buffer.
+        u32                     m_bytesRead;    //!< The number of PCM bytes read from a decoder.
+        bool                    m_isEndOfStream;//!< Indicates that all PCM data was decoded.
+        Array<f32>              m_samples;      //!< Decoded samples.
+        Array<u8>               m_pcm;          //!< Raw PCM data read from a decoder.
+    };
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
+
+#endif        /*    __DC_Sound_MixerBuffer_H__    */
@@ -0,0 +1,107 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "MixerSource.h"
+#include "MixerBuffer.h"
+
+#include <float.h>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+// ** MixerSource::MixerSource
+MixerSource::MixerSource( Mixer* mixer )
+    : m_mixer( mixer )
+    , m_cursor( 0.0 )
+    , m_isRelative( false )
+    , m_referenceDistance( 1.0f )
+    , m_maximumDistance( FLT_MAX )
+    , m_rolloffFactor( 1.0f )
+{
+    m_mixer->addSource( this );
+}
+
+MixerSource::~MixerSource( void )
+{
+    if( m_mixer ) {
+        m_mixer->removeSource( this );
+    }
+}
+
+// ** MixerSource::setBuffer
+void MixerSource::setBuffer( SoundBufferPtr value )
+{
+    SoundSource::setBuffer( value );
+    m_cursor = 0.0;
+}
+
+// ** MixerSource::setState
+void MixerSource::setState( SourceState value )
+{
+    // Playing a stopped source starts it from the beginning
+    if( value == Playing && m_state != Paused ) {
+        m_cursor = 0.0;
+    }
+
+    SoundSource::setState( value );
+}
+
+// ** MixerSource::setRelative
+void MixerSource::setRelative( bool value )
+{
+    m_isRelative = value;
+}
+
+// ** MixerSource::setReferenceDistance
+void MixerSource::setReferenceDistance( f32 value )
+{
+    m_referenceDistance = value;
+}
+
+// ** MixerSource::setMaximumDistance
+void MixerSource::setMaximumDistance( f32 value )
+{
+    m_maximumDistance = value;
+}
+
+// ** MixerSource::setRolloffFactor
+void MixerSource::setRolloffFactor( f32 value )
+{
+    m_rolloffFactor = value;
+}
+
+// ** MixerSource::setOffset
+void MixerSource::setOffset( f32 value )
+{
+    if( m_buffer.valid() ) {
+        m_cursor = static_cast<f64>( value ) * m_buffer->rate();
+    }
+}
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
@@ -0,0 +1,68 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_Sound_MixerSource_H__
+#define __DC_Sound_MixerSource_H__
+
+#include "Mixer.h"
+#include "../SoundSource.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+    //! Sound source mixed by a software mixer.
+    class MixerSource : public SoundSource {
+    friend class Mixer;
+    public:
+
+                                MixerSource( Mixer* mixer );
+        virtual                 ~MixerSource( void ) NIMBLE_OVERRIDE;
+
+        // ** SoundSource
+        virtual void            setBuffer( SoundBufferPtr value ) NIMBLE_OVERRIDE;
+        virtual void            setState( SourceState value ) NIMBLE_OVERRIDE;
+        virtual void            setRelative( bool value ) NIMBLE_OVERRIDE;
+        virtual void            setReferenceDistance( f32 value ) NIMBLE_OVERRIDE;
+        virtual void            setMaximumDistance( f32 value ) NIMBLE_OVERRIDE;
+        virtual void            setRolloffFactor( f32 value ) NIMBLE_OVERRIDE;
+        virtual void            setOffset( f32 value ) NIMBLE_OVERRIDE;
+
+    private:
+
+        Mixer*                  m_mixer;                //!< Parent mixer, NULL if the mixer was destroyed.
+        f64                     m_cursor;               //!< Playback position in source frames.
+        bool                    m_isRelative;           //!< Indicates that a source position is relative to a listener.
+        f32                     m_referenceDistance;    //!< The distance at which a source has a full volume.
+        f32                     m_maximumDistance;      //!< The distance after which a source is no longer attenuated.
+        f32                     m_rolloffFactor;        //!< Distance attenuation scale.
+    };
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
+
+#endif        /*    __DC_Sound_MixerSource_H__    */
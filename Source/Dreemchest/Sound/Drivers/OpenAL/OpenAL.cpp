@@ -29,6 +29,8 @@
 #include "OpenALSource.h"
 #include "OpenALBuffer.h"
 
+#include "../SoundStreamer.h"
+
 #include "../../Decoders/SoundDecoder.h"
 
 #define MAX_PCM_SIZE    10024
@@ -39,6 +41,8 @@ namespace Sound {
 
 // ** OpenAL::OpenAL
 OpenAL::OpenAL( void )
+    : m_device( NULL )
+    , m_context( NULL )
 {
 
 }
@@ -73,6 +77,10 @@ bool OpenAL::initialize( void )
 
     alcMakeContextCurrent( m_context );
 
+    // ** Start decoding streamed sounds on a dedicated thread
+    m_streamer = DC_NEW SoundStreamer;
+    m_streamer->start();
+
     LogVerbose( "openal", "version=%s, renderer=%s, vendor=%s\n", alGetString( AL_VERSION ), alGetString( AL_RENDERER ), alGetString( AL_VENDOR ) );
 //    LogVerbose( "AL_EXTENSIONS: %s\n", alGetString( AL_EXTENSIONS ) );
 
@@ -138,7 +146,13 @@ SoundSourcePtr OpenAL::createSource( void )
 SoundBufferPtr OpenAL::createBuffer( SoundDecoderPtr decoder, u32 chunks )
 {
     NIMBLE_ABORT_IF( !decoder.valid(), "invalid decoder" );
-    return DC_NEW OpenALBuffer( decoder, chunks, chunks == 1 ? decoder->size() : 16536 );
+    return DC_NEW OpenALBuffer( decoder, chunks, chunks == 1 ? decoder->size() : 16536, m_streamer );
+}
+
+// ** OpenAL::streamUnderruns
+u32 OpenAL::streamUnderruns( void ) const
+{
+    return m_streamer.valid() ? m_streamer->underruns() : 0;
 }
 
 // ** OpenAL::setPosition
@@ -56,6 +56,7 @@ namespace Sound {
         virtual void            setVolume( f32 value );
         virtual void            setPitch( f32 value );
         virtual void            setDistanceModel( DistanceModel value );
+        virtual u32             streamUnderruns( void ) const;
 
         // ** OpenAL
         static ALuint           soundSampleFormat( SoundSampleFormat format );
@@ -67,6 +68,7 @@ namespace Sound {
 
         ALCdevice*              m_device;
         ALCcontext*             m_context;
+        SoundStreamerPtr        m_streamer;
     };
     
 } // namespace Sound
@@ -35,14 +35,19 @@ DC_BEGIN_DREEMCHEST
 namespace Sound {
 
 // ** OpenALBuffer::OpenALBuffer
-OpenALBuffer::OpenALBuffer( SoundDecoderPtr data, u32 chunks, u32 pcmSize ) : SoundBuffer( data, chunks )
+OpenALBuffer::OpenALBuffer( SoundDecoderPtr data, u32 chunks, u32 pcmSize, SoundStreamerWPtr streamer )
+    : SoundBuffer( data, chunks )
+    , m_streamer( streamer )
+    , m_stream( NULL )
+    , m_isStarved( false )
+    , m_isRewound( false )
 {
     // ** Resize buffer id array
     m_buffers.resize( m_chunks );
 
     // ** Initialize variables
     m_pcmSize = pcmSize;
-    m_pcm     = DC_NEW u8[pcmSize];
+    m_pcm     = NULL;
     m_format  = OpenAL::soundSampleFormat( data->format() );
 
     // ** Generate buffers
@@ -51,16 +56,16 @@ OpenALBuffer::OpenALBuffer( SoundDecoderPtr data, u32 chunks, u32 pcmSize ) : So
         NIMBLE_BREAK_IF( !alIsBuffer( m_buffers[i] ), "the generated id expected to be an OpenAL buffer" );
     }
 
-    // ** Fill buffers with data
-    m_decoder->seek( 0 );
-    for( u32 i = 0; i < m_chunks; i++ ) {
-        readSoundDecoder( m_buffers[i], m_pcmSize );
-    }
-
-    // ** If the buffer is not streamed - cleanup data right now
-    if( chunks == 1 ) {
-        NIMBLE_DELETE_ARRAY( m_pcm );
+    // ** Streamed buffers are filled with chunks decoded by a streamer thread, so a decoder is never read on this thread
+    if( chunks > 1 ) {
+        NIMBLE_ABORT_IF( !m_streamer.valid(), "streamed buffers require a sound streamer" );
+        m_stream  = m_streamer->open( m_decoder, m_pcmSize );
         m_decoder = SoundDecoderPtr();
+    } else {
+        m_pcm = DC_NEW u8[m_pcmSize];
+        m_decoder->seek( 0 );
+        readSoundDecoder( m_buffers[0], m_pcmSize );
+        NIMBLE_DELETE_ARRAY( m_pcm );
     }
 
     OpenAL::dumpErrors( "OpenALBuffer::OpenALBuffer" );
@@ -68,6 +73,10 @@ OpenALBuffer::OpenALBuffer( SoundDecoderPtr data, u32 chunks, u32 pcmSize ) : So
 
 OpenALBuffer::~OpenALBuffer( void )
 {
+    if( m_stream ) {
+        m_streamer->close( m_stream );
+    }
+
     NIMBLE_DELETE_ARRAY( m_pcm );
     alDeleteBuffers( static_cast<ALsizei>(m_buffers.size()), &m_buffers[0] );
 
@@ -79,6 +88,14 @@ void OpenALBuffer::attachToSource( SoundSourceWPtr target )
 {
     NIMBLE_ABORT_IF( !target.valid(), "invalid target" );
 
+    // ** Streamed buffers are queued once decoded chunks are available
+    if( m_stream ) {
+        m_idle      = m_buffers;
+        m_isStarved = true;
+        m_isRewound = false;
+        return;
+    }
+
     ALuint source = static_cast<OpenALSource*>( target.get() )->m_id;
 
     alSourceQueueBuffers( source, static_cast<ALsizei>(m_buffers.size()), &m_buffers[0] );
@@ -104,6 +121,14 @@ void OpenALBuffer::detachFromSource( SoundSourceWPtr target )
         alSourceUnqueueBuffers( source, 1, &bufferId );
         OpenAL::dumpErrors( "OpenALBuffer::detachFromSource - alSourceUnqueueBuffers" );
     }
+
+    m_idle.clear();
+}
+
+// ** OpenALBuffer::underruns
+u32 OpenALBuffer::underruns( void ) const
+{
+    return m_stream ? m_stream->underruns() : 0;
 }
 
 // ** OpenALBuffer::readSoundDecoder
@@ -134,6 +159,9 @@ bool OpenALBuffer::updateStream( SoundSourceWPtr target, bool isLooped )
 
     ALuint source = static_cast<OpenALSource*>( target.get() )->m_id;
 
+    // ** A streamer thread stops decoding after the end of a non-looped sound
+    m_stream->setLooped( isLooped );
+
     // ** Ensure the streamed sound is not looped
     ALint looping;
     alGetSourcei( source, AL_LOOPING, &looping );
@@ -143,40 +171,58 @@ bool OpenALBuffer::updateStream( SoundSourceWPtr target, bool isLooped )
     ALint processed = 0;
     alGetSourcei( source, AL_BUFFERS_PROCESSED, &processed );
 
-    // ** Fill the processe buffers with data
+    // ** Collect processed buffers, they are refilled with chunks decoded by a streamer thread
     while( processed-- ) {
         ALuint buffer = 0;
 
-        // ** Remove buffer from a queue
         alSourceUnqueueBuffers( source, 1, &buffer );
         if( buffer == 0 ) {
             OpenAL::dumpErrors( "OpenALBuffer::updateStream - alSourceUnqueueBuffers" );
             continue;
         }
 
-        // ** Fill a buffer with data and put it to a queue
-        if( readSoundDecoder( buffer, m_pcmSize ) ) {
-            alSourceQueueBuffers( source, 1, &buffer );
-            OpenAL::dumpErrors( "OpenALBuffer::updateStream - alSourceQueueBuffers" );
-            continue;
+        m_idle.push_back( buffer );
+    }
+
+    // ** Upload decoded chunks, no decoding is performed on this thread
+    while( !m_idle.empty() ) {
+        const PcmRingBuffer::Chunk* chunk = m_stream->read();
+
+        // ** The streamer did not keep up, count an underrun once all buffers are drained
+        if( chunk == NULL ) {
+            if( m_idle.size() == m_buffers.size() && !m_isStarved ) {
+                m_stream->registerUnderrun();
+                m_isStarved = true;
+            }
+            break;
         }
 
-        // ** No more data - rewind
-        m_decoder->seek( 0 );
+        m_isStarved = false;
 
-        // ** Handle the looping
-        if( !isLooped ) {
-            return true;
-        }
+        // ** No more data - either stop or continue with a rewound stream
+        if( chunk->size == 0 ) {
+            m_stream->consume();
+
+            // ** Two markers in a row mean that a sound has no data, so even a looped playback stops
+            if( !isLooped || m_isRewound ) {
+                m_isRewound = false;
+                return true;
+            }
 
-        // ** Fill buffer with data
-        if( readSoundDecoder( buffer, m_pcmSize ) ) {
-            alSourceQueueBuffers( source, 1, &buffer );
-            OpenAL::dumpErrors( "OpenALBuffer::updateStream - alSourceQueueBuffers" );
+            m_isRewound = true;
             continue;
         }
-        
-        break;
+
+        m_isRewound = false;
+
+        ALuint buffer = m_idle.back();
+        m_idle.pop_back();
+
+        alBufferData( buffer, m_format, chunk->data, chunk->size, m_rate );
+        m_stream->consume();
+
+        alSourceQueueBuffers( source, 1, &buffer );
+        OpenAL::dumpErrors( "OpenALBuffer::updateStream - alSourceQueueBuffers" );
     }
 
     return false;
@@ -29,6 +29,7 @@
 
 #include "OpenAL.h"
 #include "../SoundBuffer.h"
+#include "../SoundStreamer.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -38,7 +39,7 @@ namespace Sound {
     class OpenALBuffer : public SoundBuffer {
     public:
 
-                                OpenALBuffer( SoundDecoderPtr data, u32 chunks, u32 pcmSize );
+                                OpenALBuffer( SoundDecoderPtr data, u32 chunks, u32 pcmSize, SoundStreamerWPtr streamer );
                                 ~OpenALBuffer( void );
 
         // ** SoundBuffer
@@ -46,6 +47,9 @@ namespace Sound {
         virtual void            detachFromSource( SoundSourceWPtr target );
         virtual bool            updateStream( SoundSourceWPtr target, bool isLooped );
 
+        //! Returns the number of times a streamed playback was starved.
+        u32                     underruns( void ) const;
+
     private:
 
         bool                    readSoundDecoder( ALuint target, u32 size );
@@ -56,6 +60,11 @@ namespace Sound {
         u32                     m_pcmSize;
         u8*                     m_pcm;
         ALuint                  m_format;
+        SoundStreamerPtr        m_streamer;
+        DecodedStream*          m_stream;
+        Array<ALuint>           m_idle;
+        bool                    m_isStarved;
+        bool                    m_isRewound;
     };
 
 } // namespace Sound
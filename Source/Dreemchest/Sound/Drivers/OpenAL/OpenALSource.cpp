@@ -82,6 +82,11 @@ void OpenALSource::setBuffer( SoundBufferPtr value )
 // ** OpenALSource::state
 SoundSource::SourceState OpenALSource::state( void ) const
 {
+    // ** Streamed sources are stopped by OpenAL while they wait for decoded chunks, so a requested state is reported
+    if( m_buffer.valid() && isStreamed() ) {
+        return m_state;
+    }
+
     ALint state;
     alGetSourcei( m_id, AL_SOURCE_STATE, &state );
 
@@ -174,6 +179,18 @@ void OpenALSource::setRolloffFactor( f32 value )
     alSourcef( m_id, AL_ROLLOFF_FACTOR, value );
 }
 
+// ** OpenALSource::setOffset
+void OpenALSource::setOffset( f32 value )
+{
+    // Streamed sources can only be positioned inside queued buffers, so they start from a current stream position
+    if( isStreamed() ) {
+        return;
+    }
+
+    alSourcef( m_id, AL_SEC_OFFSET, value );
+    OpenAL::dumpErrors( "OpenALSource::setOffset" );
+}
+
 // ** OpenALSource::isStreamed
 bool OpenALSource::isStreamed( void ) const
 {
@@ -185,21 +202,26 @@ void OpenALSource::update( void )
 {
     NIMBLE_ABORT_IF( !m_buffer.valid(), "invalid buffer" );
 
-    // ** Ensure we have a valid source state for a streamed sources
-    if( m_state != state() && isStreamed() ) {
-        setState( m_state );
-    }
-    
-    // ** Don't update stopped/paused sources
-    if( state() != Playing ) {
+    if( !isStreamed() || m_state != Playing ) {
         return;
     }
-    
-    // ** Update stream
+
+    // ** Queue decoded chunks before a source state is restored, so a playback never starts from an empty queue
     bool completed = m_buffer->updateStream( this, isLooped() );
-    
+
     if( completed ) {
         setState( Stopped );
+        return;
+    }
+
+    // ** A starved source is stopped by OpenAL, resume it once new chunks are queued
+    ALint queued = 0, state = 0;
+    alGetSourcei( m_id, AL_BUFFERS_QUEUED, &queued );
+    alGetSourcei( m_id, AL_SOURCE_STATE, &state );
+
+    if( queued > 0 && state != AL_PLAYING ) {
+        alSourcePlay( m_id );
+        OpenAL::dumpErrors( "OpenALSource::update" );
     }
 }
 
@@ -55,6 +55,7 @@ namespace Sound {
         virtual void            setReferenceDistance( f32 value ) NIMBLE_OVERRIDE;
         virtual void            setMaximumDistance( f32 value ) NIMBLE_OVERRIDE;
         virtual void            setRolloffFactor( f32 value ) NIMBLE_OVERRIDE;
+        virtual void            setOffset( f32 value ) NIMBLE_OVERRIDE;
         bool                    isStreamed( void ) const;
 
     private:
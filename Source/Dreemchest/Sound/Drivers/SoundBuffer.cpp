@@ -39,10 +39,13 @@ SoundBuffer::SoundBuffer( SoundDecoderPtr decoder, u32 chunks )
     , m_decoder( decoder )
     , m_size( 0 )
     , m_chunks( chunks )
+    , m_rate( 0 )
+    , m_users( 0 )
 {
     NIMBLE_ABORT_IF( !decoder.valid(), "invalid sound decoder" );
     m_size = decoder->size();
     m_format = decoder->format();
+    m_rate = decoder->rate();
 }
 
 SoundBuffer::~SoundBuffer( void )
@@ -74,6 +77,33 @@ SoundSampleFormat SoundBuffer::format( void ) const
     return m_format;
 }
 
+// ** SoundBuffer::rate
+u32 SoundBuffer::rate( void ) const
+{
+    return m_rate;
+}
+
+// ** SoundBuffer::duration
+f32 SoundBuffer::duration( void ) const
+{
+    u32 frameSize = 1;
+
+    switch( m_format ) {
+    case SoundSampleMono8:      frameSize = 1; break;
+    case SoundSampleMono16:     frameSize = 2; break;
+    case SoundSampleStereo8:    frameSize = 2; break;
+    case SoundSampleStereo16:   frameSize = 4; break;
+    }
+
+    return m_rate ? static_cast<f32>( m_size / frameSize ) / m_rate : 0.0f;
+}
+
+// ** SoundBuffer::users
+u32 SoundBuffer::users( void ) const
+{
+    return m_users;
+}
+
 // ** SoundBuffer::attachToSource
 void SoundBuffer::attachToSource( SoundSourceWPtr target )
 {
@@ -35,6 +35,7 @@ namespace Sound {
 
     //! Hardware sound buffer that holds decoded PCM samples.
     class SoundBuffer : public RefCounted {
+    friend class SoundSource;
     public:
 
                             //! Constructs a new SoundBuffer instance.
@@ -66,6 +67,15 @@ namespace Sound {
         //! Returns the sound buffer format.
         SoundSampleFormat   format( void ) const;
 
+        //! Returns the sample rate.
+        u32                 rate( void ) const;
+
+        //! Returns the sound duration in seconds.
+        f32                 duration( void ) const;
+
+        //! Returns the number of sound sources this buffer is attached to.
+        u32                 users( void ) const;
+
     protected:
 
         //! Internal sound format.
@@ -79,6 +89,12 @@ namespace Sound {
 
         //! Number of PCM chunks.
         u32                    m_chunks;
+
+        //! Sample rate.
+        u32                 m_rate;
+
+        //! The number of sound sources this buffer is attached to.
+        u32                 m_users;
     };
 
 } // namespace Sound
@@ -88,6 +88,37 @@ void SoundEngine::setDistanceModel( DistanceModel value )
 {
 }
 
+// ** SoundEngine::streamUnderruns
+u32 SoundEngine::streamUnderruns( void ) const
+{
+    return 0;
+}
+
+// ** SoundEngine::attenuation
+f32 SoundEngine::attenuation( DistanceModel model, f32 distance, f32 referenceDistance, f32 maximumDistance, f32 rolloffFactor )
+{
+    if( model == NoDistanceAttenutation ) {
+        return 1.0f;
+    }
+
+    // All models are clamped between the reference and maximum distances
+    distance = max2( referenceDistance, min2( distance, maximumDistance ) );
+
+    f32 gain = 1.0f;
+
+    switch( model ) {
+    case InverseDistanceAttenuation:    gain = referenceDistance / ( referenceDistance + rolloffFactor * ( distance - referenceDistance ) );
+                                        break;
+    case LinearDistanceAttenutation:    gain = maximumDistance > referenceDistance ? 1.0f - rolloffFactor * ( distance - referenceDistance ) / ( maximumDistance - referenceDistance ) : 1.0f;
+                                        break;
+    case ExponentDistanceAttenuation:   gain = referenceDistance > 0.0f ? powf( distance / referenceDistance, -rolloffFactor ) : 1.0f;
+                                        break;
+    default:                            break;
+    }
+
+    return max2( 0.0f, min2( gain, 1.0f ) );
+}
+
 // ** SoundEngine::createSoundDecoder
 SoundDecoderPtr SoundEngine::createSoundDecoder( SoundContainerFormat format ) const
 {
@@ -65,9 +65,15 @@ namespace Sound {
          */
         virtual SoundBufferPtr    createBuffer( SoundDecoderPtr decoder, u32 chunks );
 
+        //! Returns the total number of times streamed sounds were starved because decoding did not keep up.
+        virtual u32             streamUnderruns( void ) const;
+
         //! Creates a sound decoder with a given input stream and file format.
         SoundDecoderPtr         createSoundDecoder( ISoundStreamPtr stream, SoundContainerFormat format = SoundFormatUnknown );
 
+        //! Calculates a distance gain the same way hardware implementations do, distances are clamped to a [reference, maximum] range.
+        static f32              attenuation( DistanceModel model, f32 distance, f32 referenceDistance, f32 maximumDistance, f32 rolloffFactor );
+
     private:
 
         //! Creates a sound decoder instance for a given format.
@@ -39,6 +39,9 @@ SoundSource::SoundSource( void ) : m_state( Unknown ), m_isLooped( false ), m_vo
 
 SoundSource::~SoundSource( void )
 {
+    if( m_buffer.valid() ) {
+        m_buffer->m_users--;
+    }
 }
 
 // ** SoundSource::update
@@ -56,7 +59,15 @@ SoundBufferWPtr SoundSource::buffer( void ) const
 // ** SoundSource::setBuffer
 void SoundSource::setBuffer( SoundBufferPtr value )
 {
+    if( m_buffer.valid() ) {
+        m_buffer->m_users--;
+    }
+
     m_buffer = value;
+
+    if( m_buffer.valid() ) {
+        m_buffer->m_users++;
+    }
 }
 
 // ** SoundSource::state
@@ -119,6 +130,12 @@ void SoundSource::setPosition( const Vec3& value )
     m_position = value;
 }
 
+// ** SoundSource::setOffset
+void SoundSource::setOffset( f32 value )
+{
+
+}
+
 } // namespace Sound
 
 DC_END_DREEMCHEST
\ No newline at end of file
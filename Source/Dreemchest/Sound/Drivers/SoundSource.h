@@ -101,6 +101,9 @@ namespace Sound {
         //! Sets the rollof factor value.
         virtual void            setRolloffFactor( f32 value ) = 0;
 
+        //! Moves a playback cursor to a specified time in seconds.
+        virtual void            setOffset( f32 value );
+
     protected:
 
         //! Strong pointer to a hardware sound buffer.
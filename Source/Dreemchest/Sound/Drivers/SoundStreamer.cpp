@@ -0,0 +1,307 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "SoundStreamer.h"
+
+#include "../Decoders/SoundDecoder.h"
+
+#include "../../Threads/Thread.h"
+#include "../../Threads/Mutex.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+// ------------------------------------------------- PcmRingBuffer ------------------------------------------------- //
+
+// ** PcmRingBuffer::PcmRingBuffer
+PcmRingBuffer::PcmRingBuffer( u32 chunkCount, u32 chunkSize )
+    : m_chunkSize( chunkSize )
+    , m_read( 0 )
+    , m_write( 0 )
+{
+    NIMBLE_ABORT_IF( chunkCount == 0 || chunkSize == 0, "invalid ring buffer size" );
+
+    m_chunks.resize( chunkCount );
+    m_storage.resize( chunkCount * chunkSize );
+
+    for( u32 i = 0; i < chunkCount; i++ ) {
+        m_chunks[i].data = &m_storage[i * chunkSize];
+        m_chunks[i].size = 0;
+    }
+}
+
+// ** PcmRingBuffer::chunkSize
+u32 PcmRingBuffer::chunkSize( void ) const
+{
+    return m_chunkSize;
+}
+
+// ** PcmRingBuffer::size
+u32 PcmRingBuffer::size( void ) const
+{
+    return m_write.load( std::memory_order_acquire ) - m_read.load( std::memory_order_acquire );
+}
+
+// ** PcmRingBuffer::beginWrite
+PcmRingBuffer::Chunk* PcmRingBuffer::beginWrite( void )
+{
+    u32 write = m_write.load( std::memory_order_relaxed );
+
+    if( write - m_read.load( std::memory_order_acquire ) == m_chunks.size() ) {
+        return NULL;
+    }
+
+    return &m_chunks[write % m_chunks.size()];
+}
+
+// ** PcmRingBuffer::endWrite
+void PcmRingBuffer::endWrite( void )
+{
+    m_write.store( m_write.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+// ** PcmRingBuffer::beginRead
+const PcmRingBuffer::Chunk* PcmRingBuffer::beginRead( void )
+{
+    u32 read = m_read.load( std::memory_order_relaxed );
+
+    if( read == m_write.load( std::memory_order_acquire ) ) {
+        return NULL;
+    }
+
+    return &m_chunks[read % m_chunks.size()];
+}
+
+// ** PcmRingBuffer::endRead
+void PcmRingBuffer::endRead( void )
+{
+    m_read.store( m_read.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+// ------------------------------------------------- DecodedStream ------------------------------------------------- //
+
+// ** DecodedStream::DecodedStream
+DecodedStream::DecodedStream( SoundStreamer* streamer, SoundDecoderPtr decoder, u32 chunkCount, u32 chunkSize, bool isLooped )
+    : m_streamer( streamer )
+    , m_decoder( decoder )
+    , m_ring( chunkCount, chunkSize )
+    , m_isClosed( false )
+    , m_underruns( 0 )
+    , m_isLooped( isLooped )
+    , m_isRewound( false )
+    , m_isExhausted( false )
+{
+
+}
+
+// ** DecodedStream::read
+const PcmRingBuffer::Chunk* DecodedStream::read( void )
+{
+    return m_ring.beginRead();
+}
+
+// ** DecodedStream::consume
+void DecodedStream::consume( void )
+{
+    m_ring.endRead();
+}
+
+// ** DecodedStream::underruns
+u32 DecodedStream::underruns( void ) const
+{
+    return m_underruns;
+}
+
+// ** DecodedStream::registerUnderrun
+void DecodedStream::registerUnderrun( void )
+{
+    m_underruns++;
+    m_streamer->m_underruns++;
+}
+
+// ** DecodedStream::setLooped
+void DecodedStream::setLooped( bool value )
+{
+    m_isLooped = value;
+}
+
+// ------------------------------------------------- SoundStreamer ------------------------------------------------- //
+
+// ** SoundStreamer::SoundStreamer
+SoundStreamer::SoundStreamer( void )
+    : m_isRunning( false )
+    , m_underruns( 0 )
+{
+    m_mutex = Threads::Mutex::create();
+}
+
+SoundStreamer::~SoundStreamer( void )
+{
+    stop();
+    destroyStreams();
+}
+
+// ** SoundStreamer::start
+void SoundStreamer::start( void )
+{
+    if( m_isRunning ) {
+        return;
+    }
+
+    m_isRunning = true;
+    m_thread    = Threads::Thread::create();
+    m_thread->start( dcThisMethod( SoundStreamer::main ), NULL );
+}
+
+// ** SoundStreamer::stop
+void SoundStreamer::stop( void )
+{
+    if( !m_isRunning ) {
+        return;
+    }
+
+    m_isRunning = false;
+    m_thread->wait();
+    m_thread = Threads::ThreadPtr();
+}
+
+// ** SoundStreamer::open
+DecodedStream* SoundStreamer::open( SoundDecoderPtr decoder, u32 chunkSize, bool isLooped )
+{
+    NIMBLE_ABORT_IF( !decoder.valid(), "invalid decoder" );
+
+    DecodedStream* stream = DC_NEW DecodedStream( this, decoder, DecodeAheadChunks, chunkSize, isLooped );
+
+    DC_SCOPED_LOCK( m_mutex );
+    m_opened.push_back( stream );
+
+    return stream;
+}
+
+// ** SoundStreamer::close
+void SoundStreamer::close( DecodedStream* stream )
+{
+    NIMBLE_ABORT_IF( stream == NULL, "invalid stream" );
+    NIMBLE_BREAK_IF( stream->m_streamer != this, "the stream was opened by another streamer" );
+    stream->m_isClosed = true;
+}
+
+// ** SoundStreamer::underruns
+u32 SoundStreamer::underruns( void ) const
+{
+    return m_underruns;
+}
+
+// ** SoundStreamer::main
+void SoundStreamer::main( void* userData )
+{
+    while( m_isRunning ) {
+        // Take the ownership of opened streams
+        {
+            DC_SCOPED_LOCK( m_mutex );
+            m_streams.insert( m_streams.end(), m_opened.begin(), m_opened.end() );
+            m_opened.clear();
+        }
+
+        bool decoded = false;
+
+        for( Array<DecodedStream*>::iterator i = m_streams.begin(); i != m_streams.end(); ) {
+            DecodedStream* stream = *i;
+
+            // Closed streams are destroyed here, so decoders are always released by this thread
+            if( stream->m_isClosed ) {
+                delete stream;
+                i = m_streams.erase( i );
+                continue;
+            }
+
+            decoded = decode( stream ) || decoded;
+            ++i;
+        }
+
+        if( !decoded ) {
+            Threads::Thread::sleep( IdleSleepTime );
+        }
+    }
+}
+
+// ** SoundStreamer::decode
+bool SoundStreamer::decode( DecodedStream* stream )
+{
+    if( stream->m_isExhausted ) {
+        return false;
+    }
+
+    bool decoded = false;
+
+    while( PcmRingBuffer::Chunk* chunk = stream->m_ring.beginWrite() ) {
+        u32 size = stream->m_decoder->read( chunk->data, stream->m_ring.chunkSize() );
+
+        // An empty chunk is published as the end of stream marker, a consumer decides whether
+        // to continue with a looped playback or to stop
+        chunk->size = size;
+        decoded     = true;
+        stream->m_ring.endWrite();
+
+        if( size > 0 ) {
+            stream->m_isRewound = false;
+            continue;
+        }
+
+        // A decoder that has no data right after a rewind is empty, and a non-looped stream ends with a marker
+        if( stream->m_isRewound || !stream->m_isLooped ) {
+            stream->m_isExhausted = true;
+            break;
+        }
+
+        // Keep decoding from the beginning
+        stream->m_decoder->seek( 0 );
+        stream->m_isRewound = true;
+    }
+
+    return decoded;
+}
+
+// ** SoundStreamer::destroyStreams
+void SoundStreamer::destroyStreams( void )
+{
+    DC_SCOPED_LOCK( m_mutex );
+
+    for( u32 i = 0; i < m_streams.size(); i++ ) {
+        delete m_streams[i];
+    }
+    for( u32 i = 0; i < m_opened.size(); i++ ) {
+        delete m_opened[i];
+    }
+
+    m_streams.clear();
+    m_opened.clear();
+}
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
@@ -0,0 +1,178 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_SoundStreamer_H__
+#define __DC_SoundStreamer_H__
+
+#include "../Sound.h"
+#include "../../Threads/Threads.h"
+
+#include <atomic>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+    //! Lock-free ring of PCM chunks with a single producer and a single consumer.
+    /*!
+     A producer fills a chunk returned by beginWrite and publishes it with endWrite, a consumer
+     reads a chunk returned by beginRead and releases it with endRead. Chunks are never copied,
+     only read and write cursors are exchanged between threads.
+     */
+    class PcmRingBuffer {
+    public:
+
+        //! A single chunk of decoded PCM data, a chunk with zero size marks the end of a stream.
+        struct Chunk {
+            u8*                 data;       //!< Chunk PCM data.
+            u32                 size;       //!< The number of PCM bytes stored in a chunk.
+        };
+
+                                PcmRingBuffer( u32 chunkCount, u32 chunkSize );
+
+        //! Returns the maximum size of a single chunk.
+        u32                     chunkSize( void ) const;
+
+        //! Returns the number of chunks ready to be read.
+        u32                     size( void ) const;
+
+        //! Returns a next chunk to be filled by a producer, or NULL if a ring is full.
+        Chunk*                  beginWrite( void );
+
+        //! Publishes a filled chunk to a consumer.
+        void                    endWrite( void );
+
+        //! Returns a next chunk to be read by a consumer, or NULL if a ring is empty.
+        const Chunk*            beginRead( void );
+
+        //! Releases a consumed chunk to a producer.
+        void                    endRead( void );
+
+    private:
+
+        Array<Chunk>            m_chunks;       //!< Ring chunks.
+        Array<u8>               m_storage;      //!< PCM storage shared by all chunks.
+        u32                     m_chunkSize;    //!< The maximum size of a single chunk.
+        std::atomic<u32>        m_read;         //!< The total number of consumed chunks.
+        std::atomic<u32>        m_write;        //!< The total number of produced chunks.
+    };
+
+    //! A sound stream decoded ahead by a streamer thread.
+    class DecodedStream {
+    friend class SoundStreamer;
+    public:
+
+        //! Returns a next decoded chunk, or NULL if a decoder did not keep up with a playback.
+        const PcmRingBuffer::Chunk* read( void );
+
+        //! Releases a chunk returned by read.
+        void                    consume( void );
+
+        //! Returns the number of times a playback of this stream was starved.
+        u32                     underruns( void ) const;
+
+        //! Records a playback starvation.
+        void                    registerUnderrun( void );
+
+        //! Sets a loop flag, a non-looped stream stops decoding after an end marker.
+        void                    setLooped( bool value );
+
+    private:
+
+                                DecodedStream( SoundStreamer* streamer, SoundDecoderPtr decoder, u32 chunkCount, u32 chunkSize, bool isLooped );
+
+    private:
+
+        SoundStreamer*          m_streamer;     //!< Parent streamer.
+        SoundDecoderPtr         m_decoder;      //!< Decoder owned by a streamer thread.
+        PcmRingBuffer           m_ring;         //!< Decoded PCM chunks.
+        std::atomic<bool>       m_isClosed;     //!< Indicates that a stream is no longer used and can be destroyed.
+        std::atomic<u32>        m_underruns;    //!< The number of playback starvations.
+        std::atomic<bool>       m_isLooped;     //!< Indicates that a stream is decoded from the beginning after an end marker.
+        bool                    m_isRewound;    //!< Indicates that a decoder was just rewound, used to detect empty sounds.
+        bool                    m_isExhausted;  //!< Indicates that a decoder has no data at all or a non-looped stream has ended.
+    };
+
+    //! Decodes all streamed sounds ahead on a dedicated thread.
+    /*!
+     Once a decoder is passed to a streamer, it is accessed only by a streamer thread. A streamed
+     sound buffer consumes decoded chunks on the main thread without touching a decoder, so the
+     decoding cost never shows up inside a frame.
+     */
+    class SoundStreamer : public RefCounted {
+    friend class DecodedStream;
+    public:
+
+        //! The number of chunks decoded ahead for each stream.
+        enum { DecodeAheadChunks = 8 };
+
+        //! The time in milliseconds a streamer thread sleeps when all streams are full.
+        enum { IdleSleepTime = 5 };
+
+                                SoundStreamer( void );
+        virtual                 ~SoundStreamer( void );
+
+        //! Starts a streamer thread.
+        void                    start( void );
+
+        //! Stops a streamer thread and waits for it to finish.
+        void                    stop( void );
+
+        //! Takes an ownership of a decoder and starts decoding it ahead, the current decoder position is preserved.
+        DecodedStream*          open( SoundDecoderPtr decoder, u32 chunkSize, bool isLooped = true );
+
+        //! Closes a stream, it will be destroyed by a streamer thread.
+        void                    close( DecodedStream* stream );
+
+        //! Returns the total number of playback starvations of all streams.
+        u32                     underruns( void ) const;
+
+    private:
+
+        //! Streamer thread function.
+        void                    main( void* userData );
+
+        //! Fills a stream ring with decoded chunks, returns true if anything was decoded.
+        bool                    decode( DecodedStream* stream );
+
+        //! Destroys all streams.
+        void                    destroyStreams( void );
+
+    private:
+
+        Threads::ThreadPtr      m_thread;       //!< Streamer thread.
+        Threads::MutexPtr       m_mutex;        //!< Guards the list of opened streams.
+        Array<DecodedStream*>   m_opened;       //!< Streams opened since the last streamer pass.
+        Array<DecodedStream*>   m_streams;      //!< Streams owned by a streamer thread.
+        std::atomic<bool>       m_isRunning;    //!< Indicates that a streamer thread should keep running.
+        std::atomic<u32>        m_underruns;    //!< The total number of playback starvations.
+    };
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_SoundStreamer_H__    */
@@ -68,11 +68,14 @@ namespace Sound {
     dcDeclarePtrs( SoundGroup )
     dcDeclarePtrs( SoundEvent )
     dcDeclarePtrs( Fader )
+    dcDeclarePtrs( SoundCache )
 
     dcDeclarePtrs( SoundEngine )
     dcDeclarePtrs( SoundBuffer )
     dcDeclarePtrs( SoundDecoder )
     dcDeclarePtrs( SoundSource )
+    dcDeclarePtrs( Mixer )
+    dcDeclarePtrs( SoundStreamer )
 
     dcDeclarePtrs( IStreamOpener )
     dcDeclarePtrs( ISoundStream )
@@ -103,6 +106,7 @@ DC_END_DREEMCHEST
     #include "SoundEvent.h"
     #include "SoundChannel.h"
     #include "SoundStream.h"
+    #include "SoundCache.h"
 #endif
 
 #endif    /*    !__DC_Sound_H__    */
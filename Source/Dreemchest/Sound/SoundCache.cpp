@@ -0,0 +1,329 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "SoundCache.h"
+#include "SoundData.h"
+#include "SoundStream.h"
+
+#include "Decoders/SoundDecoder.h"
+#include "Decoders/PcmSoundDecoder.h"
+#include "Drivers/SoundBuffer.h"
+#include "Drivers/SoundEngine.h"
+
+#include "../Threads/Thread.h"
+#include "../Threads/Mutex.h"
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+// ** SoundCache::SoundCache
+SoundCache::SoundCache( SoundEngineWPtr hal, IStreamOpenerWPtr streamOpener )
+    : m_hal( hal )
+    , m_streamOpener( streamOpener )
+    , m_size( 0 )
+    , m_budget( DefaultBudget )
+    , m_useCounter( 0 )
+    , m_isRunning( false )
+    , m_pending( 0 )
+{
+    NIMBLE_ABORT_IF( !hal.valid(), "invalid sound engine" );
+    NIMBLE_ABORT_IF( !streamOpener.valid(), "invalid stream opener" );
+    m_mutex = Threads::Mutex::create();
+}
+
+SoundCache::~SoundCache( void )
+{
+    if( m_isRunning ) {
+        m_isRunning = false;
+        m_thread->wait();
+    }
+}
+
+// ** SoundCache::keyFor
+String SoundCache::keyFor( SoundDataWPtr data )
+{
+    // The same file decoded with a different container format is a different sound
+    String key = data->uri();
+    key += '#';
+    key += static_cast<char>( '0' + data->format() );
+    return key;
+}
+
+// ** SoundCache::acquire
+SoundBufferPtr SoundCache::acquire( SoundDataWPtr data )
+{
+    NIMBLE_ABORT_IF( !data.valid(), "invalid sound data" );
+
+    String          key = keyFor( data );
+    Entries::iterator i = m_entries.find( String64( key.c_str() ) );
+
+    if( i != m_entries.end() ) {
+        i->second.lastUsed = ++m_useCounter;
+        return i->second.buffer;
+    }
+
+    // Decode a sound on a cache miss
+    SoundDecoderPtr decoder = createDecoder( data->uri(), data->format() );
+
+    if( !decoder.valid() ) {
+        return SoundBufferPtr();
+    }
+
+    SoundBufferPtr buffer = m_hal->createBuffer( decoder, 1 );
+
+    if( buffer.valid() ) {
+        insert( key, buffer );
+    }
+
+    return buffer;
+}
+
+// ** SoundCache::contains
+bool SoundCache::contains( SoundDataWPtr data ) const
+{
+    NIMBLE_ABORT_IF( !data.valid(), "invalid sound data" );
+    return m_entries.find( String64( keyFor( data ).c_str() ) ) != m_entries.end();
+}
+
+// ** SoundCache::preload
+void SoundCache::preload( SoundDataWPtr data )
+{
+    NIMBLE_ABORT_IF( !data.valid(), "invalid sound data" );
+
+    if( contains( data ) ) {
+        return;
+    }
+
+    Request request;
+    request.key    = keyFor( data );
+    request.uri    = data->uri();
+    request.format = data->format();
+
+    {
+        DC_SCOPED_LOCK( m_mutex );
+        m_requests.push_back( request );
+    }
+
+    m_pending++;
+
+    // Start a loader thread on a first request
+    if( !m_isRunning ) {
+        m_isRunning = true;
+        m_thread    = Threads::Thread::create();
+        m_thread->start( dcThisMethod( SoundCache::main ), NULL );
+    }
+}
+
+// ** SoundCache::pendingCount
+u32 SoundCache::pendingCount( void ) const
+{
+    return m_pending;
+}
+
+// ** SoundCache::update
+void SoundCache::update( void )
+{
+    Array<Decoded> decoded;
+
+    {
+        DC_SCOPED_LOCK( m_mutex );
+        decoded.swap( m_decoded );
+    }
+
+    for( u32 i = 0, n = ( u32 )decoded.size(); i < n; i++ ) {
+        const Decoded& sound = decoded[i];
+
+        // A sound could be decoded on a main thread while it was waiting for a loader
+        if( sound.pcm.valid() && m_entries.find( String64( sound.key.c_str() ) ) == m_entries.end() ) {
+            SoundBufferPtr buffer = m_hal->createBuffer( DC_NEW PcmSoundDecoder( sound.pcm, sound.rate, sound.format ), 1 );
+
+            if( buffer.valid() ) {
+                insert( sound.key, buffer );
+            }
+        }
+
+        m_pending--;
+    }
+
+    trim();
+}
+
+// ** SoundCache::trim
+void SoundCache::trim( void )
+{
+    while( m_size > m_budget ) {
+        Entries::iterator oldest = m_entries.end();
+
+        for( Entries::iterator i = m_entries.begin(), end = m_entries.end(); i != end; ++i ) {
+            // Buffers attached to sound sources are never released
+            if( i->second.buffer->users() ) {
+                continue;
+            }
+
+            if( oldest == m_entries.end() || i->second.lastUsed < oldest->second.lastUsed ) {
+                oldest = i;
+            }
+        }
+
+        if( oldest == m_entries.end() ) {
+            break;
+        }
+
+        m_size -= oldest->second.buffer->size();
+        m_entries.erase( oldest );
+    }
+}
+
+// ** SoundCache::clear
+void SoundCache::clear( void )
+{
+    for( Entries::iterator i = m_entries.begin(); i != m_entries.end(); ) {
+        if( i->second.buffer->users() ) {
+            ++i;
+            continue;
+        }
+
+        m_size -= i->second.buffer->size();
+        m_entries.erase( i++ );
+    }
+}
+
+// ** SoundCache::entryCount
+u32 SoundCache::entryCount( void ) const
+{
+    return ( u32 )m_entries.size();
+}
+
+// ** SoundCache::size
+u64 SoundCache::size( void ) const
+{
+    return m_size;
+}
+
+// ** SoundCache::budget
+u64 SoundCache::budget( void ) const
+{
+    return m_budget;
+}
+
+// ** SoundCache::setBudget
+void SoundCache::setBudget( u64 value )
+{
+    m_budget = value;
+    trim();
+}
+
+// ** SoundCache::insert
+void SoundCache::insert( const String& key, SoundBufferPtr buffer )
+{
+    Entry& entry = m_entries[String64( key.c_str() )];
+
+    entry.buffer   = buffer;
+    entry.lastUsed = ++m_useCounter;
+    m_size        += buffer->size();
+
+    trim();
+}
+
+// ** SoundCache::createDecoder
+SoundDecoderPtr SoundCache::createDecoder( CString uri, SoundContainerFormat format ) const
+{
+    ISoundStreamPtr stream = m_streamOpener->open( uri );
+
+    if( !stream.valid() ) {
+        LogError( "sfx", "failed to open sound stream %s\n", uri );
+        return SoundDecoderPtr();
+    }
+
+    SoundDecoderPtr decoder = m_hal->createSoundDecoder( stream, format );
+
+    if( !decoder.valid() ) {
+        LogError( "sfx", "failed to create sound decoder for %s\n", uri );
+    }
+
+    return decoder;
+}
+
+// ** SoundCache::main
+void SoundCache::main( void* userData )
+{
+    while( m_isRunning ) {
+        Request request;
+
+        {
+            DC_SCOPED_LOCK( m_mutex );
+
+            if( !m_requests.empty() ) {
+                request = m_requests.front();
+                m_requests.erase( m_requests.begin() );
+            }
+        }
+
+        if( request.key.empty() ) {
+            Threads::Thread::sleep( IdleSleepTime );
+            continue;
+        }
+
+        // Read a whole sound to memory, a buffer is created from it on a main thread
+        Decoded         sound;
+        SoundDecoderPtr decoder = createDecoder( request.uri.c_str(), request.format );
+
+        sound.key = request.key;
+
+        if( decoder.valid() ) {
+            Array<u8> pcm( decoder->size() );
+            u32       size = 0;
+
+            while( size < pcm.size() ) {
+                u32 read = decoder->read( &pcm[size], ( u32 )pcm.size() - size );
+
+                if( read == 0 ) {
+                    break;
+                }
+
+                size += read;
+            }
+
+            if( size ) {
+                sound.pcm = Io::ByteBuffer::createFromData( &pcm[0], size );
+            }
+
+            sound.rate   = decoder->rate();
+            sound.format = decoder->format();
+        }
+
+        DC_SCOPED_LOCK( m_mutex );
+        m_decoded.push_back( sound );
+
+        // Drop a reference while the lock is held, decoded samples are owned by a main thread from now on
+        sound.pcm = Io::ByteBufferPtr();
+    }
+}
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
@@ -0,0 +1,163 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#ifndef __DC_SoundCache_H__
+#define __DC_SoundCache_H__
+
+#include "Sound.h"
+#include "../Threads/Threads.h"
+
+#include <atomic>
+
+DC_BEGIN_DREEMCHEST
+
+namespace Sound {
+
+    //! Shares decoded PCM buffers between all playbacks of a sound.
+    /*!
+     Buffers are keyed by a sound URI and a container format, so a sound is decoded once no matter
+     how many times it is played. Buffers that are not attached to any sound source are released
+     in a least recently used order once the total size exceeds a memory budget. Sounds can be
+     decoded ahead on a background thread, so the first playback does not hit a decoder either.
+     */
+    class SoundCache : public RefCounted {
+    public:
+
+        //! The default memory budget in bytes.
+        enum { DefaultBudget = 32 * 1024 * 1024 };
+
+        //! The time in milliseconds a loader thread sleeps when there is nothing to decode.
+        enum { IdleSleepTime = 5 };
+
+                                //! Constructs a SoundCache instance.
+                                /*!
+                                 \param hal Sound engine used to create buffers.
+                                 \param streamOpener A stream opener interface used to load sounds.
+                                 */
+                                SoundCache( SoundEngineWPtr hal, IStreamOpenerWPtr streamOpener );
+        virtual                 ~SoundCache( void );
+
+        //! Returns a decoded buffer for a given sound, the sound is decoded on a cache miss.
+        SoundBufferPtr          acquire( SoundDataWPtr data );
+
+        //! Returns true if a given sound is already decoded.
+        bool                    contains( SoundDataWPtr data ) const;
+
+        //! Queues a sound to be decoded on a loader thread, a stream opener should be safe to use from that thread.
+        void                    preload( SoundDataWPtr data );
+
+        //! Returns the number of sounds queued for a preload that are not cached yet.
+        u32                     pendingCount( void ) const;
+
+        //! Puts sounds decoded by a loader thread to a cache and releases buffers that do not fit a budget.
+        void                    update( void );
+
+        //! Releases least recently used buffers until the total size fits a budget.
+        void                    trim( void );
+
+        //! Releases all buffers that are not used by sound sources.
+        void                    clear( void );
+
+        //! Returns the number of cached buffers.
+        u32                     entryCount( void ) const;
+
+        //! Returns the total size of cached PCM data in bytes.
+        u64                     size( void ) const;
+
+        //! Returns the memory budget in bytes.
+        u64                     budget( void ) const;
+
+        //! Sets the memory budget in bytes.
+        void                    setBudget( u64 value );
+
+    private:
+
+        //! Cached sound buffer.
+        struct Entry {
+                                Entry( void )
+                                    : lastUsed( 0 ) {}
+
+            SoundBufferPtr      buffer;     //!< Decoded sound buffer.
+            u32                 lastUsed;   //!< The value of a use counter when this buffer was last requested.
+        };
+
+        //! A sound to be decoded by a loader thread.
+        struct Request {
+                                Request( void )
+                                    : format( SoundFormatUnknown ) {}
+
+            String              key;        //!< Cache key.
+            String              uri;        //!< Sound URI.
+            SoundContainerFormat format;    //!< Sound container format.
+        };
+
+        //! A sound decoded by a loader thread.
+        struct Decoded {
+                                Decoded( void )
+                                    : rate( 0 ), format( SoundSampleMono8 ) {}
+
+            String              key;        //!< Cache key.
+            Io::ByteBufferPtr   pcm;        //!< Decoded PCM samples.
+            u32                 rate;       //!< Sample rate.
+            SoundSampleFormat   format;     //!< Sound sample format.
+        };
+
+        //! Container type to store cached buffers by key.
+        typedef Hash<Entry>     Entries;
+
+        //! Returns a cache key for a given sound.
+        static String           keyFor( SoundDataWPtr data );
+
+        //! Opens a sound stream and creates a decoder for it.
+        SoundDecoderPtr         createDecoder( CString uri, SoundContainerFormat format ) const;
+
+        //! Adds a decoded buffer to a cache.
+        void                    insert( const String& key, SoundBufferPtr buffer );
+
+        //! Loader thread function.
+        void                    main( void* userData );
+
+    private:
+
+        SoundEngineWPtr         m_hal;          //!< Sound engine used to create buffers.
+        IStreamOpenerWPtr       m_streamOpener; //!< Stream opener interface.
+        Entries                 m_entries;      //!< Cached buffers.
+        u64                     m_size;         //!< The total size of cached PCM data.
+        u64                     m_budget;       //!< The memory budget.
+        u32                     m_useCounter;   //!< Incremented each time a buffer is requested.
+        Threads::ThreadPtr      m_thread;       //!< Loader thread, started by a first preload.
+        Threads::MutexPtr       m_mutex;        //!< Guards queued and decoded sounds.
+        Array<Request>          m_requests;     //!< Sounds queued for a loader thread.
+        Array<Decoded>          m_decoded;      //!< Sounds decoded by a loader thread.
+        std::atomic<bool>       m_isRunning;    //!< Indicates that a loader thread should keep running.
+        u32                     m_pending;      //!< The number of queued sounds that are not cached yet.
+    };
+
+} // namespace Sound
+
+DC_END_DREEMCHEST
+
+#endif    /*    !__DC_SoundCache_H__    */
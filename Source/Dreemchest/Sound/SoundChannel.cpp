@@ -29,6 +29,7 @@
 #include "Decoders/SoundDecoder.h"
 #include "Drivers/SoundSource.h"
 #include "Drivers/SoundBuffer.h"
+#include "Drivers/SoundEngine.h"
 #include "SoundData.h"
 #include "SoundGroup.h"
 
@@ -37,11 +38,17 @@ DC_BEGIN_DREEMCHEST
 namespace Sound {
 
 // ** SoundChannel::SoundChannel
-SoundChannel::SoundChannel( SoundDataWPtr data, SoundSourcePtr source )
+SoundChannel::SoundChannel( SoundDataWPtr data, SoundSourcePtr source, f32 pitch, f32 duration )
     : m_source( source )
     , m_volumeFader( NULL )
     , m_sound( data )
     , m_volume( 1.0f )
+    , m_state( SoundSource::Unknown )
+    , m_pitch( pitch )
+    , m_time( 0.0f )
+    , m_duration( duration )
+    , m_gain( 0.0f )
+    , m_audibility( 0.0f )
 {
 
 }
@@ -66,12 +73,19 @@ void SoundChannel::setVolume( f32 value )
 // ** SoundChannel::position
 const Vec3& SoundChannel::position( void ) const
 {
-    return m_source->position();
+    return m_position;
 }
 
 // ** SoundChannel::setPosition
 void SoundChannel::setPosition( const Vec3& value )
 {
+    m_position = value;
+
+    // Virtual channels only track the position
+    if( !m_source.valid() ) {
+        return;
+    }
+
     // Get the sound source buffer
     SoundBufferWPtr buffer = m_source->buffer();
 
@@ -93,13 +107,37 @@ void SoundChannel::setPosition( const Vec3& value )
 // ** SoundChannel::isPlaying
 bool SoundChannel::isPlaying( void ) const
 {
-    return m_source->state() == SoundSource::Playing;
+    return state() == SoundSource::Playing;
 }
 
 // ** SoundChannel::isStopped
 bool SoundChannel::isStopped( void ) const
 {
-    return m_source->state() == SoundSource::Stopped;
+    return state() == SoundSource::Stopped;
+}
+
+// ** SoundChannel::state
+SoundSource::SourceState SoundChannel::state( void ) const
+{
+    return m_source.valid() ? m_source->state() : m_state;
+}
+
+// ** SoundChannel::isVirtual
+bool SoundChannel::isVirtual( void ) const
+{
+    return !m_source.valid();
+}
+
+// ** SoundChannel::audibility
+f32 SoundChannel::audibility( void ) const
+{
+    return m_audibility;
+}
+
+// ** SoundChannel::time
+f32 SoundChannel::time( void ) const
+{
+    return m_time;
 }
 
 // ** SoundChannel::sound
@@ -131,12 +169,21 @@ void SoundChannel::resume( f32 fade )
         return;
     }
 
-    m_source->setState( SoundSource::Playing );
-    m_source->setVolume( 0.0f );
+    // A stopped playback starts over
+    if( state() == SoundSource::Stopped ) {
+        m_time = 0.0f;
+    }
+
+    m_state = SoundSource::Playing;
+
+    if( m_source.valid() ) {
+        m_source->setState( SoundSource::Playing );
+        m_source->setVolume( 0.0f );
+    }
 
     if( fade > 0.0f ) {
         m_volumeFader = DC_NEW Fader( 0.0f, m_volume, fade, dcThisMethod( SoundChannel::onFadeIn ) );
-    } else {
+    } else if( m_source.valid() ) {
         m_source->setVolume( m_volume );
     }
 }
@@ -163,7 +210,9 @@ void SoundChannel::stop( f32 fade )
 // ** SoundChannel::update
 bool SoundChannel::update( f32 dt )
 {
-    m_source->update();
+    if( m_source.valid() ) {
+        m_source->update();
+    }
 
     // Update volume fader and calculate the volume fade factor
     f32 fade = 1.0f;
@@ -173,31 +222,117 @@ bool SoundChannel::update( f32 dt )
     }
 
     // Calculate the final volume base on fade factor, group volume & channel volume
-    f32 volume = m_volume * m_sound->group()->volume() * fade;
+    m_gain = m_volume * m_sound->group()->volume() * fade;
+
+    // Track the playback position for both hardware and virtual channels
+    if( state() == SoundSource::Playing ) {
+        advance( dt );
+    }
+
+    if( !m_source.valid() ) {
+        return m_state == SoundSource::Stopped;
+    }
 
     // Set the sond source volume
-    m_source->setVolume( volume );
+    m_source->setVolume( m_gain );
 
     // Update source distance attenuation properties
+    updateDistanceProperties();
+
+    return m_source->state() == SoundSource::Stopped;
+}
+
+// ** SoundChannel::updateDistanceProperties
+void SoundChannel::updateDistanceProperties( void )
+{
     m_source->setMaximumDistance( m_sound->maximumDistance() );
     m_source->setRolloffFactor( m_sound->rolloffFactor() );
     m_source->setReferenceDistance( m_sound->referenceDistance() );
     m_source->setRelative( m_sound->isRelative() );
+}
 
-    return m_source->state() == SoundSource::Stopped;
+// ** SoundChannel::advance
+void SoundChannel::advance( f32 dt )
+{
+    m_time += dt * m_pitch;
+
+    if( m_duration <= 0.0f || m_time < m_duration ) {
+        return;
+    }
+
+    if( m_sound->isLooped() ) {
+        m_time = fmodf( m_time, m_duration );
+        return;
+    }
+
+    // A hardware source stops by itself, a virtual one should be stopped here
+    m_time = m_duration;
+
+    if( !m_source.valid() ) {
+        m_state = SoundSource::Stopped;
+    }
+}
+
+// ** SoundChannel::updateAudibility
+void SoundChannel::updateAudibility( const Vec3& listener, DistanceModel model )
+{
+    // Paused and stopped channels do not need a hardware voice
+    if( state() != SoundSource::Playing ) {
+        m_audibility = 0.0f;
+        return;
+    }
+
+    f32 distance    = m_sound->isRelative() ? m_position.length() : ( m_position - listener ).length();
+    f32 attenuation = SoundEngine::attenuation( model, distance, m_sound->referenceDistance(), m_sound->maximumDistance(), m_sound->rolloffFactor() );
+
+    // A priority scales the audible gain, so important sounds keep their voices over louder ones
+    m_audibility = m_gain * attenuation * ( m_sound->priority() + 1 );
+}
+
+// ** SoundChannel::virtualize
+void SoundChannel::virtualize( void )
+{
+    NIMBLE_ABORT_IF( !m_source.valid(), "the channel is already virtual" );
+
+    m_state = m_source->state();
+    m_source->setState( SoundSource::Stopped );
+    m_source = SoundSourcePtr();
+}
+
+// ** SoundChannel::realize
+void SoundChannel::realize( SoundSourcePtr source )
+{
+    NIMBLE_ABORT_IF( m_source.valid(), "the channel already has a sound source" );
+    NIMBLE_ABORT_IF( !source.valid(), "invalid sound source" );
+
+    m_source = source;
+    m_source->setPitch( m_pitch );
+    m_source->setPosition( m_position );
+    m_source->setVolume( m_gain );
+    updateDistanceProperties();
+
+    // Continue the playback from a tracked position
+    m_source->setState( m_state );
+    m_source->setOffset( m_time );
 }
 
 // ** SoundChannel::stopPlayback
 void SoundChannel::stopPlayback( bool pause )
 {
-    m_source->setState( pause ? SoundSource::Paused : SoundSource::Stopped );
-    m_source->setVolume( 0.0f );
+    m_state = pause ? SoundSource::Paused : SoundSource::Stopped;
+
+    if( m_source.valid() ) {
+        m_source->setState( m_state );
+        m_source->setVolume( 0.0f );
+    }
 }
 
 // ** SoundChannel::onFadeIn
 void SoundChannel::onFadeIn( FaderWPtr fader )
 {
-    m_source->setVolume( fader->value() );
+    if( m_source.valid() ) {
+        m_source->setVolume( fader->value() );
+    }
     m_volumeFader = FaderPtr();
 }
 
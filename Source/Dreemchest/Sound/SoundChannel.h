@@ -28,6 +28,7 @@
 #define __DC_SoundChannel_H__
 
 #include "Sound.h"
+#include "Drivers/SoundSource.h"
 
 DC_BEGIN_DREEMCHEST
 
@@ -35,6 +36,10 @@ namespace Sound {
 
     // ** class SoundChannel
     //! A SoundChannel object represents a single sound playback.
+    /*!
+     A channel that is not audible enough to get a hardware voice becomes virtual: it releases a hardware sound source
+     and only tracks a playback position. Once a virtual channel gets a voice back, it continues from a tracked position.
+     */
     class SoundChannel : public RefCounted {
     friend class SoundFx;
     public:
@@ -60,6 +65,15 @@ namespace Sound {
         //! Returns a pointer to an attached sound data.
         SoundDataWPtr        sound( void ) const;
 
+        //! Returns true if this channel has no hardware sound source.
+        bool                isVirtual( void ) const;
+
+        //! Returns the last calculated audibility score, channels with a higher score get hardware voices first.
+        f32                 audibility( void ) const;
+
+        //! Returns a playback position in seconds.
+        f32                 time( void ) const;
+
         //! Pauses a sound playback with a given fade in time.
         /*!
          \param fade Sound fade in time in milliseconds.
@@ -83,9 +97,11 @@ namespace Sound {
                             //! Constructs a new SoundChannel instance.
                             /*!
                              \param data Attached sound data instance.
-                             \param source Hardware sound source.
+                             \param source Hardware sound source, a NULL source starts a virtual playback.
+                             \param pitch Sound playback pitch.
+                             \param duration Sound duration in seconds.
                              */
-                            SoundChannel( SoundDataWPtr data, SoundSourcePtr source );
+                            SoundChannel( SoundDataWPtr data, SoundSourcePtr source, f32 pitch, f32 duration );
         virtual             ~SoundChannel( void );
 
         //! Does a sound channel update (sound streaming, fading, stopping).
@@ -106,6 +122,24 @@ namespace Sound {
         //! Stops the playback of a sound by switching it to a specified state (the sound volume will be set to 0).
         void                stopPlayback( bool pause );
 
+        //! Returns a current playback state.
+        SoundSource::SourceState state( void ) const;
+
+        //! Advances a tracked playback position.
+        void                advance( f32 dt );
+
+        //! Calculates an audibility score for a given listener position and a distance model.
+        void                updateAudibility( const Vec3& listener, DistanceModel model );
+
+        //! Releases a hardware sound source, the playback continues virtually.
+        void                virtualize( void );
+
+        //! Continues a virtual playback with a given hardware sound source.
+        void                realize( SoundSourcePtr source );
+
+        //! Applies sound data distance properties to a hardware sound source.
+        void                updateDistanceProperties( void );
+
     private:
 
         //! Hardware sound source used for sound playback.
@@ -119,6 +153,27 @@ namespace Sound {
 
         //! Sound channel volume.
         f32                 m_volume;
+
+        //! Playback state of a virtual channel.
+        SoundSource::SourceState m_state;
+
+        //! Sound channel position.
+        Vec3                m_position;
+
+        //! Sound playback pitch.
+        f32                 m_pitch;
+
+        //! Tracked playback position in seconds.
+        f32                 m_time;
+
+        //! Sound duration in seconds.
+        f32                 m_duration;
+
+        //! The final channel gain before the distance attenuation.
+        f32                 m_gain;
+
+        //! Channel audibility score.
+        f32                 m_audibility;
     };
     
 } // namespace Sound
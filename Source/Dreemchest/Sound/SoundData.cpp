@@ -43,7 +43,7 @@ SoundData::SoundData( SoundFxWPtr sfx, CString identifier, CString uri, SoundGro
     , m_referenceDistance( 1.0f )
     , m_maximumDistance( FLT_MAX )
     , m_rolloffFactor( 1.0f )
-    , m_pcm( NULL )
+    , m_duration( 0.0f )
 {
     m_identifier        = identifier;
     m_type              = 0;
@@ -282,16 +282,16 @@ void SoundData::setData( const SoundDataInfo& value )
     m_priority          = value.priority;
 }
 
-// ** SoundData::pcm
-SoundBufferWPtr SoundData::pcm( void ) const
+// ** SoundData::duration
+f32 SoundData::duration( void ) const
 {
-    return m_pcm;
+    return m_duration;
 }
 
-// ** SoundData::setPcm
-void SoundData::setPcm( SoundBufferPtr value )
+// ** SoundData::setDuration
+void SoundData::setDuration( f32 value )
 {
-    m_pcm = value;
+    m_duration = value;
 }
 
 // ** SoundData::volumeForSound
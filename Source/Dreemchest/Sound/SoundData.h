@@ -153,10 +153,10 @@ namespace Sound {
         SoundDataInfo            data( void ) const;
         //! Loads a serialized sound data.
         void                    setData( const SoundDataInfo& value );
-        //! Returns a sound buffer with decoded PCM data.
-        SoundBufferWPtr            pcm( void ) const;
-        //! Sets a sound buffer with decoded PCM data.
-        void                    setPcm( SoundBufferPtr value );
+        //! Returns a sound duration in seconds, zero if a sound was never loaded.
+        f32                     duration( void ) const;
+        //! Sets a sound duration in seconds.
+        void                    setDuration( f32 value );
         //! Calculates and returns a sound volume with a random modifier applied.
         f32                        volumeForSound( void ) const;
         //! Calculates and returns a sound pitch with a random modifier applied.
@@ -200,8 +200,8 @@ namespace Sound {
         f32                     m_rolloffFactor;
         //! Sound playback priority.
         u32                        m_priority;
-        //! Decoded PCM data.
-        SoundBufferPtr            m_pcm;
+        //! Sound duration in seconds.
+        f32                     m_duration;
     };
     
 } // namespace Sound
@@ -31,11 +31,13 @@
 #include "SoundData.h"
 #include "SoundEvent.h"
 #include "SoundStream.h"
+#include "SoundCache.h"
 
 #include "Decoders/SoundDecoder.h"
 #include "Drivers/SoundSource.h"
 #include "Drivers/SoundBuffer.h"
 #include "Drivers/SoundEngine.h"
+#include "Drivers/Mixer/Mixer.h"
 
 #ifdef OPENAL_FOUND
     #include "Drivers/OpenAL/OpenAL.h"
@@ -47,6 +49,9 @@ namespace Sound {
 
 // ------------------------------------------------------ SoundFx ------------------------------------------------------ //
 
+// ** SoundFx::AudibilityThreshold
+const f32 SoundFx::AudibilityThreshold = 0.0001f;
+
 // ** SoundFx::SoundFx
 SoundFx::SoundFx( SoundHal hal, IStreamOpenerPtr streamOpener )
     : m_hal( NULL )
@@ -54,6 +59,7 @@ SoundFx::SoundFx( SoundHal hal, IStreamOpenerPtr streamOpener )
     , m_pitch( 1.0f )
     , m_streamOpener( streamOpener.valid() ? streamOpener : DC_NEW StandardStreamOpener )
     , m_distanceModel( InverseDistanceAttenuation )
+    , m_maxVoices( DefaultMaxVoices )
 {
     switch( hal ) {
     case None:      m_hal = NULL;           break;
@@ -68,6 +74,13 @@ SoundFx::SoundFx( SoundHal hal, IStreamOpenerPtr streamOpener )
                         LogError( "sfx", "%s", "the default sound HAL is OpenAL, but library compiled without OpenAL\n" );
                     #endif  /*  #ifdef OPENAL_FOUND */
                     break;
+    case Software:  m_hal = DC_NEW Mixer;
+                    m_hal->initialize();
+                    break;
+    }
+
+    if( m_hal.valid() ) {
+        m_cache = DC_NEW SoundCache( m_hal, m_streamOpener );
     }
 }
 
@@ -289,25 +302,35 @@ SoundBufferPtr SoundFx::createBuffer( SoundDataWPtr data )
         return NULL;
     }
 
+    // ** Decoded sounds are shared through a cache, so no decoder is created on a cache hit
+    if( data->loading() == SoundData::Decode ) {
+        SoundBufferPtr buffer = m_cache->acquire( data );
+
+        if( !buffer.valid() ) {
+            LogError( "sfx", "failed to decode sound '%s'\n", data->identifier() );
+            return NULL;
+        }
+
+        data->setDuration( buffer->duration() );
+        return buffer;
+    }
+
     // ** Create sound decoder
     SoundDecoderPtr decoder = createDecoder( data );
-    if( !decoder.valid() && !data->pcm().valid() ) {
+    if( !decoder.valid() ) {
         LogError( "sfx", "failed to create sound decoder for '%s'\n", data->identifier() );
         return NULL;
     }
 
-    // ** Create buffer
-    switch( data->loading() ) {
-    case SoundData::Decode:     if( !data->pcm().valid() ) {
-                                    data->setPcm( m_hal->createBuffer( decoder, 1 ) );
-                                }
-                                return data->pcm();
+    // ** Create a streamed buffer
+    SoundBufferPtr buffer = m_hal->createBuffer( decoder, 3 );
 
-    case SoundData::Stream:     return m_hal->createBuffer( decoder, 3 );
-    case SoundData::LoadToRam:  return m_hal->createBuffer( decoder, 3 );
+    // ** Virtual channels rely on a sound duration to track a playback
+    if( buffer.valid() ) {
+        data->setDuration( buffer->duration() );
     }
 
-    return NULL;
+    return buffer;
 }
 
 // ** SoundFx::createDecoder
@@ -322,11 +345,7 @@ SoundDecoderPtr SoundFx::createDecoder( SoundDataWPtr data )
     }
 
     switch( data->loading() ) {
-    case SoundData::Decode:     if( !data->pcm().valid() ) {
-                                    decoder = m_hal->createSoundDecoder( stream, data->format() );
-                                } else {
-                                //    stream->release();
-                                }
+    case SoundData::Decode:     decoder = m_hal->createSoundDecoder( stream, data->format() );
                                 break;
 
     case SoundData::LoadToRam:  decoder = m_hal->createSoundDecoder( stream->loadToRam(), data->format() );
@@ -343,9 +362,42 @@ SoundDecoderPtr SoundFx::createDecoder( SoundDataWPtr data )
 // ** SoundFx::setListenerPosition
 void SoundFx::setListenerPosition( const Vec3& value )
 {
+    m_listenerPosition = value;
     m_hal->setPosition( value );
 }
 
+// ** SoundFx::maxVoices
+u32 SoundFx::maxVoices( void ) const
+{
+    return m_maxVoices;
+}
+
+// ** SoundFx::setMaxVoices
+void SoundFx::setMaxVoices( u32 value )
+{
+    m_maxVoices = value;
+}
+
+// ** SoundFx::voiceCount
+u32 SoundFx::voiceCount( void ) const
+{
+    u32 count = 0;
+
+    for( u32 i = 0, n = ( u32 )m_channels.size(); i < n; i++ ) {
+        if( !m_channels[i]->isVirtual() ) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// ** SoundFx::virtualChannelCount
+u32 SoundFx::virtualChannelCount( void ) const
+{
+    return ( u32 )m_channels.size() - voiceCount();
+}
+
 // ** SoundFx::event
 SoundChannelPtr SoundFx::event( CString identifier )
 {
@@ -390,11 +442,20 @@ SoundChannelPtr SoundFx::play( CString identifier )
     // Cleanup dead channels
     cleanupChannels();
 
-    // Create a sound source
-    SoundSourcePtr source = createSource( data );
+    // Create a sound source if there is a free hardware voice, otherwise start a virtual playback
+    // that will get a voice on a next update if it is audible enough.
+    SoundSourcePtr source;
 
-    if( !source.valid() ) {
-        LogError( "sfx", "failed to start playback for '%s', no sound source created\n", identifier );
+    if( voiceCount() < m_maxVoices ) {
+        source = createSource( data );
+
+        if( !source.valid() ) {
+            LogError( "sfx", "failed to start playback for '%s', no sound source created\n", identifier );
+            return NULL;
+        }
+    }
+    else if( data->duration() <= 0.0f && !createBuffer( data ).valid() ) {
+        LogError( "sfx", "failed to start playback for '%s', the sound could not be loaded\n", identifier );
         return NULL;
     }
 
@@ -406,7 +467,7 @@ SoundChannelPtr SoundFx::play( CString identifier )
     }
 
     // Create channel
-    SoundChannel* channel = DC_NEW SoundChannel( data, source );
+    SoundChannel* channel = DC_NEW SoundChannel( data, source, source.valid() ? source->pitch() : data->pitchForSound(), data->duration() );
     channel->setVolume( data->volumeForSound() );
     channel->resume( fadeTime );
     m_channels.push_back( channel );
@@ -518,6 +579,10 @@ void SoundFx::reset( void )
     m_events.clear();
     m_sounds.clear();
     m_groups.clear();
+
+    if( m_cache.valid() ) {
+        m_cache->clear();
+    }
 }
 
 // ** SoundFx::volume
@@ -547,6 +612,34 @@ void SoundFx::setPitch( f32 value )
     m_hal->setPitch( pitch() );
 }
 
+// ** SoundFx::hal
+SoundEngineWPtr SoundFx::hal( void ) const
+{
+    return m_hal;
+}
+
+// ** SoundFx::cache
+SoundCacheWPtr SoundFx::cache( void ) const
+{
+    return m_cache;
+}
+
+// ** SoundFx::preload
+void SoundFx::preload( SoundGroupWPtr group )
+{
+    if( !m_cache.valid() ) {
+        return;
+    }
+
+    for( Sounds::iterator i = m_sounds.begin(), end = m_sounds.end(); i != end; ++i ) {
+        SoundDataWPtr data = i->second;
+
+        if( data->group().get() == group.get() && data->loading() == SoundData::Decode ) {
+            m_cache->preload( data );
+        }
+    }
+}
+
 // ** SoundGroups& SoundFx::groups
 const SoundGroups& SoundFx::groups( void ) const
 {
@@ -570,10 +663,18 @@ void SoundFx::update( f32 dt )
     // ** Cleanup stopped channels
     cleanupChannels();
 
+    // ** Distribute hardware voices between channels
+    updateVoices();
+
     // ** Update sound groups
     for( SoundGroups::iterator i = m_groups.begin(), end = m_groups.end(); i != end; ++i ) {
         i->second->update();
     }
+
+    // ** Take sounds decoded in background and release buffers that are no longer used
+    if( m_cache.valid() ) {
+        m_cache->update();
+    }
 }
 
 // ** SoundFx::cleanupChannels
@@ -590,6 +691,62 @@ void SoundFx::cleanupChannels( void )
     }
 }
 
+// ** SoundFx::updateVoices
+void SoundFx::updateVoices( void )
+{
+    // ** Sort channels by an audibility
+    m_voices.clear();
+
+    for( u32 i = 0, n = ( u32 )m_channels.size(); i < n; i++ ) {
+        SoundChannel* channel = m_channels[i].get();
+        channel->updateAudibility( m_listenerPosition, m_distanceModel );
+        m_voices.push_back( channel );
+    }
+
+    std::stable_sort( m_voices.begin(), m_voices.end(), compareAudibility );
+
+    // ** Release voices of channels that do not fit a budget first, so sources are reused by promoted channels
+    for( u32 i = 0, n = ( u32 )m_voices.size(); i < n; i++ ) {
+        SoundChannel* channel = m_voices[i];
+
+        if( channel->isVirtual() ) {
+            continue;
+        }
+
+        if( i >= m_maxVoices || channel->audibility() < AudibilityThreshold ) {
+            channel->virtualize();
+        }
+    }
+
+    // ** Give voices to the most audible virtual channels
+    for( u32 i = 0, n = min2( ( u32 )m_voices.size(), m_maxVoices ); i < n; i++ ) {
+        SoundChannel* channel = m_voices[i];
+
+        if( !channel->isVirtual() || channel->audibility() < AudibilityThreshold ) {
+            continue;
+        }
+
+        SoundSourcePtr source = createSource( channel->sound() );
+
+        if( !source.valid() ) {
+            break;
+        }
+
+        channel->realize( source );
+    }
+}
+
+// ** SoundFx::compareAudibility
+bool SoundFx::compareAudibility( const SoundChannel* a, const SoundChannel* b )
+{
+    // ** Channels that already have a voice win ties, so equally audible channels do not swap voices each frame
+    if( a->audibility() == b->audibility() ) {
+        return !a->isVirtual() && b->isVirtual();
+    }
+
+    return a->audibility() > b->audibility();
+}
+
 } // namespace Sound
 
 DC_END_DREEMCHEST
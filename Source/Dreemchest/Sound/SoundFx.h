@@ -49,8 +49,15 @@ namespace Sound {
         enum SoundHal {
             None,        //!< No HAL, the sound playback is disabled.
             Default,     //!< Use a platform default HAL.
+            Software,    //!< Use a software mixer, the mixed audio is pulled by a user.
         };
 
+        //! The default number of hardware voices.
+        enum { DefaultMaxVoices = 32 };
+
+        //! Channels with an audibility below this value never get a hardware voice.
+        static const f32        AudibilityThreshold;
+
     public:
 
         virtual                 ~SoundFx( void );
@@ -89,6 +96,15 @@ namespace Sound {
         //! Sets the listener position.
         void                    setListenerPosition( const Vec3& value );
 
+        //! Returns the maximum number of channels that are played by a hardware.
+        u32                     maxVoices( void ) const;
+        //! Sets the maximum number of channels that are played by a hardware, the rest of channels are virtual.
+        void                    setMaxVoices( u32 value );
+        //! Returns the number of channels that are played by a hardware.
+        u32                     voiceCount( void ) const;
+        //! Returns the number of virtual channels.
+        u32                     virtualChannelCount( void ) const;
+
         //! Returns the selected distance model.
         DistanceModel           distanceModel( void ) const;
         //! Sets the distance model to be used.
@@ -170,6 +186,14 @@ namespace Sound {
         //! Sets a master sound pitch.
         void                    setPitch( f32 value );
 
+        //! Returns a sound engine used for playback.
+        SoundEngineWPtr         hal( void ) const;
+
+        //! Returns a cache of decoded sounds.
+        SoundCacheWPtr          cache( void ) const;
+        //! Decodes all sounds of a group that are loaded with a SoundData::Decode flag on a background thread.
+        void                    preload( SoundGroupWPtr group );
+
         //! Returns a reference to a sound group container.
         const SoundGroups&      groups( void ) const;
         //! Returns a reference to a sound container.
@@ -213,6 +237,12 @@ namespace Sound {
         //! Removes all stopped sound channels from an update queue.
         void                    cleanupChannels( void );
 
+        //! Gives hardware voices to the most audible channels and virtualizes the rest.
+        void                    updateVoices( void );
+
+        //! Returns true if a first channel is more audible than a second one.
+        static bool             compareAudibility( const SoundChannel* a, const SoundChannel* b );
+
     private:
 
         //! Sound engine HAL.
@@ -227,6 +257,9 @@ namespace Sound {
         //! Stream opener interface.
         IStreamOpenerPtr        m_streamOpener;
 
+        //! Decoded sounds shared between playbacks.
+        SoundCachePtr           m_cache;
+
         //! Array of sound channels the are now playing.
         SoundChannels            m_channels;
 
@@ -244,6 +277,15 @@ namespace Sound {
 
         //! Distance attenuation model.
         DistanceModel           m_distanceModel;
+
+        //! Listener position.
+        Vec3                    m_listenerPosition;
+
+        //! The maximum number of hardware voices.
+        u32                     m_maxVoices;
+
+        //! Channels sorted by an audibility, reused each update.
+        Array<SoundChannel*>    m_voices;
     };
     
 } // namespace Sound
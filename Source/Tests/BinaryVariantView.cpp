@@ -0,0 +1,127 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Writes a value with a binary variant stream and returns a buffer that holds it.
+static Io::ByteBufferPtr writeBinaryVariant( const Variant& value )
+{
+    Io::ByteBufferPtr buffer = Io::ByteBuffer::create();
+    Io::BinaryVariantStream( buffer.get() ).write( value );
+    return buffer;
+}
+
+//! Returns a small asset manifest used by tests.
+static KeyValue createManifest( void )
+{
+    VariantArray tags;
+    tags << Variant::fromValue<String>( "static" ) << Variant::fromValue<String>( "lod" );
+
+    KeyValue asset;
+    asset.setValueAtKey( "name", Variant::fromValue<String>( "meshes/rock" ) );
+    asset.setValueAtKey( "size", Variant::fromValue<s32>( 4096 ) );
+    asset.setValueAtKey( "scale", Variant::fromValue<f32>( 0.5f ) );
+    asset.setValueAtKey( "streamed", Variant::fromValue<bool>( true ) );
+    asset.setValueAtKey( "tags", Variant::fromValue<VariantArray>( tags ) );
+
+    KeyValue manifest;
+    manifest.setValueAtKey( "rock", Variant::fromValue<KeyValue>( asset ) );
+    manifest.setValueAtKey( "version", Variant::fromValue<s32>( 3 ) );
+    return manifest;
+}
+
+TEST(BinaryVariantView, ReadsValuesInPlace)
+{
+    Io::ByteBufferPtr       buffer = writeBinaryVariant( Variant::fromValue<KeyValue>( createManifest() ) );
+    Io::BinaryVariantView   root   = Io::BinaryVariantView::root( buffer->buffer(), buffer->length() );
+
+    ASSERT_EQ( Io::BinaryVariantView::ObjectValue, root.kind() );
+    EXPECT_EQ( 2, root.size() );
+    EXPECT_EQ( 3, root.valueAtKey( "version" ).toInteger() );
+    EXPECT_EQ( buffer->buffer() + buffer->length(), root.end() );
+
+    Io::BinaryVariantView asset = root.valueAtKey( "rock" );
+    Io::StringSpan        name  = asset.valueAtKey( "name" ).toStringSpan();
+
+    // Strings point directly into a buffer
+    EXPECT_TRUE( name == "meshes/rock" );
+    EXPECT_TRUE( reinterpret_cast<const u8*>( name.data ) > buffer->buffer() && reinterpret_cast<const u8*>( name.data ) < buffer->buffer() + buffer->length() );
+
+    EXPECT_EQ( 4096, asset.valueAtKey( "size" ).toInteger() );
+    EXPECT_EQ( 0.5, asset.valueAtKey( "scale" ).toReal() );
+    EXPECT_TRUE( asset.valueAtKey( "streamed" ).toBool() );
+    EXPECT_FALSE( asset.valueAtKey( "missing" ).isValid() );
+
+    Io::BinaryVariantView tags = asset.valueAtKey( "tags" );
+    ASSERT_EQ( 2, tags.size() );
+    EXPECT_TRUE( tags.itemAt( 1 ).toStringSpan() == "lod" );
+    EXPECT_FALSE( tags.itemAt( 2 ).isValid() );
+}
+
+TEST(BinaryVariantView, MaterializesVariants)
+{
+    Io::ByteBufferPtr buffer = writeBinaryVariant( Variant::fromValue<KeyValue>( createManifest() ) );
+    KeyValue          kv     = Io::BinaryVariantView::root( buffer->buffer(), buffer->length() ).toVariant().as<KeyValue>();
+
+    EXPECT_EQ( 3, kv.valueAtKey( "version" ).as<s32>() );
+    EXPECT_EQ( "meshes/rock", kv.valueAtKey( "rock" ).as<KeyValue>().valueAtKey( "name" ).as<String>() );
+}
+
+TEST(BinaryVariantView, IndexesObjectMembers)
+{
+    KeyValue manifest;
+    char     key[32];
+
+    for( s32 i = 0; i < 1000; i++ ) {
+        sprintf( key, "asset%d", i );
+        manifest.setValueAtKey( key, Variant::fromValue<s32>( i ) );
+    }
+
+    Io::ByteBufferPtr        buffer = writeBinaryVariant( Variant::fromValue<KeyValue>( manifest ) );
+    Io::BinaryVariantIndex   index( Io::BinaryVariantView::root( buffer->buffer(), buffer->length() ) );
+
+    EXPECT_EQ( 1000, index.size() );
+    EXPECT_EQ( 0, index.find( "asset0" ).toInteger() );
+    EXPECT_EQ( 777, index.find( "asset777" ).toInteger() );
+    EXPECT_FALSE( index.find( "asset1000" ).isValid() );
+}
+
+TEST(BinaryVariantView, RejectsTruncatedData)
+{
+    Io::ByteBufferPtr buffer = writeBinaryVariant( Variant::fromValue<KeyValue>( createManifest() ) );
+
+    for( s32 size = 0; size < buffer->length(); size++ ) {
+        Io::BinaryVariantView root = Io::BinaryVariantView::root( buffer->buffer(), size );
+        EXPECT_TRUE( root.end() == NULL );
+
+        for( Io::BinaryVariantView::Cursor i = root.items(); i.next(); ) {
+            i.value().toStringSpan();
+        }
+    }
+}
@@ -0,0 +1,187 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Returns a small box around a point.
+static Bounds casterAt( f32 x, f32 y, f32 z, f32 size = 0.5f )
+{
+    return Bounds( Vec3( x - size, y - size, z - size ), Vec3( x + size, y + size, z + size ) );
+}
+
+//! Constructs cascades for a camera and a light that both look down the negative Z axis.
+static Scene::CascadedShadowMaps createCascades( void )
+{
+    Scene::CascadedShadowMaps csm( Matrix4::translation( 0.0f, 0.0f, 0.0f ), Matrix4::translation( 0.0f, 0.0f, 0.0f ), 1024 );
+    csm.calculate( 60.0f, 1.0f, 100.0f, 1.0f, 0.5f, 3 );
+    return csm;
+}
+
+TEST(CascadedShadowCasters, CastersAreAssignedToFinestCascade)
+{
+    Scene::CascadedShadowMaps csm = createCascades();
+
+    const Scene::CascadedShadowMaps::Cascade& first = csm.cascadeAt( 0 );
+    const Scene::CascadedShadowMaps::Cascade& last  = csm.cascadeAt( 2 );
+
+    Bounds casters[] = {
+          casterAt( 0.0f, 0.0f, -(first.near + first.far) * 0.5f )  // Inside the first cascade
+        , casterAt( 1000.0f, 0.0f, -50.0f )                          // Outside of all cascades
+        , casterAt( 0.0f, 0.0f, -first.far, 1.0f )                  // Crosses the first split
+        , casterAt( 0.0f, 0.0f, -(last.near + last.far) * 0.5f )    // Inside the last cascade
+    };
+
+    Array<Scene::CascadedShadowMaps::Casters> result;
+    csm.cullCasters( casters, 4, result );
+
+    ASSERT_EQ( 3u, result.size() );
+
+    ASSERT_EQ( 2u, result[0].size() );
+    EXPECT_EQ( 0, result[0][0] );
+    EXPECT_EQ( 2, result[0][1] );
+
+    ASSERT_EQ( 1u, result[1].size() );
+    EXPECT_EQ( 2, result[1][0] );
+
+    ASSERT_EQ( 1u, result[2].size() );
+    EXPECT_EQ( 3, result[2][0] );
+}
+
+TEST(CascadedShadowCasters, VolumesAreExtrudedTowardLight)
+{
+    Scene::CascadedShadowMaps csm = createCascades();
+
+    const Scene::CascadedShadowMaps::Cascade& first = csm.cascadeAt( 0 );
+
+    // A caster between a light and the first cascade
+    Bounds caster = casterAt( 0.0f, 0.0f, first.lightSpaceBounds.max().z - 1.0f );
+    Array<Scene::CascadedShadowMaps::Casters> result;
+    csm.cullCasters( &caster, 1, result );
+
+    ASSERT_EQ( 1u, result[0].size() );
+    EXPECT_GT( first.lightSpaceBounds.max().z, -first.near );
+
+    // Casters behind a cascade volume are skipped
+    caster = casterAt( 0.0f, 0.0f, -200.0f );
+    csm.cullCasters( &caster, 1, result );
+
+    EXPECT_TRUE( result[0].empty() );
+    EXPECT_TRUE( result[1].empty() );
+    EXPECT_TRUE( result[2].empty() );
+}
+
+//! Renders each cascade through a shadow pass and returns the number of issued draw calls, all static meshes are rendered when no casters are passed.
+static s32 renderShadowCascades( Renderer::RenderingContextWPtr context, Scene::ShadowPass& pass, const Scene::CascadedShadowMaps& csm, const Array<Scene::CascadedShadowMaps::Casters>* casters )
+{
+    Renderer::RenderFrame& frame = context->allocateFrame();
+
+    for( s32 i = 0, n = csm.cascadeCount(); i < n; i++ ) {
+        Scene::RenderScene::CBuffer::Shadow parameters;
+        parameters.transform = csm.cascadeAt( i ).transform;
+        parameters.invSize   = 1.0f / 64.0f;
+
+        Renderer::TransientTexture shadows = pass.render( frame, frame.entryPoint(), frame.stateStack(), parameters, casters ? &(*casters)[i] : NULL );
+        frame.entryPoint().releaseTexture( shadows );
+    }
+
+    context->display( frame );
+    return context->frameCounters().drawCalls;
+}
+
+TEST(CascadedShadowCasters, ShadowPassDrawsOnlyCulledCasters)
+{
+    Renderer::RenderingContextPtr context = Renderer::createNullRenderingContext();
+    ASSERT_TRUE( context.valid() );
+
+    // A single box mesh is shared by all casters
+    Assets::AssetsPtr assets( DC_NEW Assets::Assets );
+    Scene::MeshHandle box = assets->add<Scene::Mesh>( "box", DC_NEW Scene::MeshBoxGenerator( 1.0f, 1.0f, 1.0f ) );
+    ASSERT_TRUE( assets->forceLoad( box ) );
+
+    Scene::ScenePtr       scene       = Scene::Scene::create();
+    Scene::RenderCachePtr cache       = Scene::TestRenderCache::create( assets, context );
+    Scene::RenderScenePtr renderScene = Scene::RenderScene::create( scene, context, cache );
+
+    // Casters inside cascades, one far to the side and one behind all cascades
+    Vec3 positions[] = {
+          Vec3( 0.0f, 0.0f, -3.0f )
+        , Vec3( 0.0f, 0.0f, -20.0f )
+        , Vec3( 2.0f, 0.0f, -20.0f )
+        , Vec3( 0.0f, 0.0f, -80.0f )
+        , Vec3( 1000.0f, 0.0f, -50.0f )
+        , Vec3( 0.0f, 0.0f, -200.0f )
+    };
+    const s32 kCasterCount = sizeof( positions ) / sizeof( positions[0] );
+
+    for( s32 i = 0; i < kCasterCount; i++ ) {
+        Scene::SceneObjectPtr object = scene->createSceneObject();
+        object->attach<Scene::Transform>( positions[i].x, positions[i].y, positions[i].z, Scene::TransformWPtr() );
+        object->attach<Scene::StaticMesh>( box );
+        scene->addSceneObject( object );
+    }
+
+    // Update world space bounds of static meshes
+    scene->update( 0, 0.0f );
+
+    const Scene::RenderScene::StaticMeshes& meshes = renderScene->staticMeshes();
+    ASSERT_EQ( kCasterCount, meshes.count() );
+
+    // Cull casters the same way a forward render system does
+    Array<Bounds> bounds;
+
+    for( s32 i = 0, n = meshes.count(); i < n; i++ ) {
+        bounds.push_back( meshes[i].mesh->worldSpaceBounds() );
+    }
+
+    Scene::CascadedShadowMaps                 csm = createCascades();
+    Array<Scene::CascadedShadowMaps::Casters> casters;
+    csm.cullCasters( &bounds[0], static_cast<s32>( bounds.size() ), casters );
+
+    s32 culledCasters = 0;
+
+    for( size_t i = 0; i < casters.size(); i++ ) {
+        culledCasters += static_cast<s32>( casters[i].size() );
+    }
+
+    Scene::ShadowPass pass( *context, *renderScene );
+
+    s32 unculled = renderShadowCascades( context, pass, csm, NULL );
+    s32 culled   = renderShadowCascades( context, pass, csm, &casters );
+
+    // Every mesh is drawn to every cascade without culling
+    s32 drawsPerMesh = unculled / (csm.cascadeCount() * kCasterCount);
+    ASSERT_GT( drawsPerMesh, 0 );
+    EXPECT_EQ( csm.cascadeCount() * kCasterCount * drawsPerMesh, unculled );
+
+    // Only casters assigned to a cascade are drawn to it
+    EXPECT_EQ( culledCasters * drawsPerMesh, culled );
+    EXPECT_LT( culled, unculled );
+}
@@ -0,0 +1,176 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A component allocated from a pool.
+class PooledHealth : public Ecs::Component<PooledHealth> {
+public:
+
+                            PooledHealth( void )
+                                : value( 100 ) {}
+
+    s32                     value;  //!< A health value.
+};
+
+//! Returns occupancy statistics of a pool with a specified name.
+static Ecs::ComponentPool::Statistics findPoolStatistics( const String& name )
+{
+    Ecs::ComponentPool::StatisticsArray pools = Ecs::ComponentPool::allStatistics();
+
+    for( s32 i = 0, n = static_cast<s32>( pools.size() ); i < n; i++ ) {
+        if( pools[i].name == name ) {
+            return pools[i];
+        }
+    }
+
+    Ecs::ComponentPool::Statistics empty;
+    empty.name      = name;
+    empty.blockSize = 0;
+    empty.capacity  = 0;
+    empty.used      = 0;
+    empty.peak      = 0;
+    empty.slabs     = 0;
+    return empty;
+}
+
+TEST(EcsPools, ResolvesEntityHandles)
+{
+    Ecs::EcsPtr    ecs    = Ecs::Ecs::create();
+    Ecs::EntityPtr entity = ecs->createEntity();
+
+    EXPECT_FALSE( entity->handle().isValid() );
+
+    ecs->addEntity( entity );
+    Ecs::EntityHandle handle = entity->handle();
+
+    EXPECT_TRUE( handle.isValid() );
+    EXPECT_TRUE( ecs->findEntity( handle ) == entity );
+}
+
+TEST(EcsPools, InvalidatesHandlesOfRemovedEntities)
+{
+    Ecs::EcsPtr    ecs   = Ecs::Ecs::create();
+    Ecs::EntityPtr first = ecs->createEntity();
+    ecs->addEntity( first );
+
+    Ecs::EntityHandle stale = first->handle();
+    ecs->removeEntity( first->id() );
+    ecs->update( 0, 0.0f );
+
+    EXPECT_FALSE( ecs->findEntity( stale ).valid() );
+
+    // A released slot is reused with a new generation
+    Ecs::EntityPtr second = ecs->createEntity();
+    ecs->addEntity( second );
+
+    EXPECT_EQ( stale.index, second->handle().index );
+    EXPECT_NE( stale.generation, second->handle().generation );
+    EXPECT_FALSE( ecs->findEntity( stale ).valid() );
+    EXPECT_TRUE( ecs->findEntity( second->handle() ) == second );
+}
+
+//! A block type used to stress a pool from several threads.
+struct ThreadedPoolBlock {
+    u8                      data[24];   //!< Block payload.
+};
+
+//! Allocates and frees pool blocks in small batches.
+static void churnPoolBlocks( Threads::TaskProgressWPtr progress, void* userData )
+{
+    Ecs::ComponentPool& pool = Ecs::ComponentPool::forType<ThreadedPoolBlock>();
+    void*               blocks[16];
+
+    for( s32 i = 0; i < 2000; i++ ) {
+        for( s32 j = 0; j < 16; j++ ) {
+            blocks[j] = pool.allocate();
+        }
+
+        for( s32 j = 0; j < 16; j++ ) {
+            pool.deallocate( blocks[j] );
+        }
+    }
+}
+
+TEST(EcsPools, AllocatesFromSeveralThreads)
+{
+    Threads::TaskManagerPtr          taskManager = Threads::TaskManager::create();
+    Array<Threads::TaskProgressPtr>  progress;
+
+    for( s32 i = 0; i < 3; i++ ) {
+        progress.push_back( taskManager->runBackgroundTask( dcStaticFunction( churnPoolBlocks ) ) );
+    }
+
+    churnPoolBlocks( Threads::TaskProgressWPtr(), NULL );
+
+    for( size_t i = 0; i < progress.size(); i++ ) {
+        progress[i]->waitForCompletion();
+    }
+
+    // Every block was returned and the free list still links each block exactly once
+    Ecs::ComponentPool&            pool  = Ecs::ComponentPool::forType<ThreadedPoolBlock>();
+    Ecs::ComponentPool::Statistics stats = pool.statistics();
+    EXPECT_EQ( 0, stats.used );
+
+    Set<void*> blocks;
+
+    for( s32 i = 0; i < stats.capacity; i++ ) {
+        blocks.insert( pool.allocate() );
+    }
+
+    EXPECT_EQ( static_cast<size_t>( stats.capacity ), blocks.size() );
+    EXPECT_EQ( stats.slabs, pool.statistics().slabs );
+
+    for( Set<void*>::iterator i = blocks.begin(); i != blocks.end(); ++i ) {
+        pool.deallocate( *i );
+    }
+}
+
+#if DC_ECS_POOLED_ALLOCATIONS
+
+TEST(EcsPools, ReusesComponentBlocks)
+{
+    Ecs::EcsPtr    ecs    = Ecs::Ecs::create();
+    Ecs::EntityPtr entity = ecs->createEntity();
+
+    PooledHealth* first = entity->attach<PooledHealth>();
+    s32           used  = findPoolStatistics( TypeInfo<PooledHealth>::name() ).used;
+    EXPECT_GE( used, 1 );
+
+    entity->detach<PooledHealth>();
+    EXPECT_EQ( used - 1, findPoolStatistics( TypeInfo<PooledHealth>::name() ).used );
+
+    // The most recently freed block is allocated first
+    PooledHealth* second = entity->attach<PooledHealth>();
+    EXPECT_EQ( first, second );
+    EXPECT_EQ( 100, second->value );
+}
+
+#endif  /*  DC_ECS_POOLED_ALLOCATIONS   */
@@ -0,0 +1,125 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A component tracked by change queries.
+class QueryMotion : public Ecs::Component<QueryMotion> {
+
+    INTROSPECTION_SUPER( QueryMotion, Ecs::ComponentBase
+        , PROPERTY( speed, speed, setSpeed, "The movement speed." )
+        )
+
+public:
+
+                            QueryMotion( void )
+                                : m_speed( 0.0f ) {}
+
+    f32                     speed( void ) const { return m_speed; }
+    void                    setSpeed( f32 value ) { m_speed = value; }
+
+private:
+
+    f32                     m_speed;
+};
+
+//! Creates an entity with a motion component and adds it to a world.
+static Ecs::EntityPtr addMovingEntity( Ecs::EcsWPtr ecs )
+{
+    Ecs::EntityPtr entity = ecs->createEntity();
+    entity->attach<QueryMotion>();
+    ecs->addEntity( entity );
+    return entity;
+}
+
+TEST(EcsQuery, ReportsAddedEntitiesOnce)
+{
+    Ecs::EcsPtr    ecs   = Ecs::Ecs::create();
+    Ecs::QueryPtr  query = ecs->requestQuery( "Moving", Ecs::Aspect::all<QueryMotion>(), QueryMotion::bit() );
+
+    addMovingEntity( ecs );
+    addMovingEntity( ecs );
+    ecs->update( 0, 0.0f );
+
+    EXPECT_EQ( 2, query->size() );
+    EXPECT_EQ( 2u, query->changed().size() );
+    EXPECT_TRUE( query->changed().empty() );
+}
+
+TEST(EcsQuery, ReportsChangedComponents)
+{
+    Ecs::EcsPtr    ecs    = Ecs::Ecs::create();
+    Ecs::QueryPtr  query  = ecs->requestQuery( "Moving", Ecs::Aspect::all<QueryMotion>(), QueryMotion::bit() );
+    Ecs::EntityPtr first  = addMovingEntity( ecs );
+    Ecs::EntityPtr second = addMovingEntity( ecs );
+
+    ecs->update( 0, 0.0f );
+    query->changed();
+
+    // Reading a component does not mark it as changed
+    first->get<QueryMotion>()->speed();
+    EXPECT_TRUE( query->changed().empty() );
+
+    // Several writes are reported once
+    first->modify<QueryMotion>()->setSpeed( 1.0f );
+    first->modify<QueryMotion>()->setSpeed( 2.0f );
+
+    const Ecs::EntityArray& changed = query->changed();
+    ASSERT_EQ( 1u, changed.size() );
+    EXPECT_TRUE( first == changed[0] );
+
+    // Removed entities are not reported
+    second->modify<QueryMotion>();
+    ecs->removeEntity( second->id() );
+    ecs->update( 0, 0.0f );
+    EXPECT_TRUE( query->changed().empty() );
+}
+
+TEST(EcsQuery, TracksChangesPerQuery)
+{
+    Ecs::EcsPtr    ecs    = Ecs::Ecs::create();
+    Ecs::QueryPtr  fast   = ecs->requestQuery( "Fast", Ecs::Aspect::all<QueryMotion>(), QueryMotion::bit() );
+    Ecs::QueryPtr  slow   = ecs->requestQuery( "Slow", Ecs::Aspect::all<QueryMotion>(), QueryMotion::bit() );
+    Ecs::EntityPtr entity = addMovingEntity( ecs );
+
+    ecs->update( 0, 0.0f );
+    fast->changed();
+    slow->changed();
+
+    // A change that was read by one query is still reported to another one
+    entity->modify<QueryMotion>();
+    EXPECT_EQ( 1u, fast->changed().size() );
+
+    entity->modify<QueryMotion>();
+    ecs->update( 0, 0.0f );
+
+    EXPECT_EQ( 1u, fast->changed().size() );
+    EXPECT_EQ( 1u, slow->changed().size() );
+    EXPECT_TRUE( slow->changed().empty() );
+}
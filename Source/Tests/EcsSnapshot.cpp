@@ -0,0 +1,146 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A component with plain data properties only.
+class SnapshotMotion : public Ecs::Component<SnapshotMotion> {
+
+    INTROSPECTION_SUPER( SnapshotMotion, Ecs::ComponentBase
+        , PROPERTY( position, position, setPosition, "The body position." )
+        , PROPERTY( mass, mass, setMass, "The body mass." )
+        )
+
+public:
+
+                            SnapshotMotion( void )
+                                : m_mass( 0.0f ) {}
+
+    const Vec3&             position( void ) const { return m_position; }
+    void                    setPosition( const Vec3& value ) { m_position = value; }
+    f32                     mass( void ) const { return m_mass; }
+    void                    setMass( f32 value ) { m_mass = value; }
+
+private:
+
+    Vec3                    m_position;
+    f32                     m_mass;
+};
+
+//! A component with a string and an entity reference.
+class SnapshotLink : public Ecs::Component<SnapshotLink> {
+
+    INTROSPECTION_SUPER( SnapshotLink, Ecs::ComponentBase
+        , PROPERTY( name, name, setName, "The link name." )
+        , PROPERTY( target, target, setTarget, "The linked entity." )
+        )
+
+public:
+
+    const String&           name( void ) const { return m_name; }
+    void                    setName( const String& value ) { m_name = value; }
+    Ecs::EntityWPtr         target( void ) const { return m_target; }
+    void                    setTarget( Ecs::EntityWPtr value ) { m_target = value; }
+
+private:
+
+    String                  m_name;
+    Ecs::EntityWPtr         m_target;
+};
+
+//! Creates an assembly with snapshot test components.
+static Reflection::AssemblyPtr createSnapshotAssembly( void )
+{
+    Reflection::AssemblyPtr assembly = Reflection::Assembly::create();
+    assembly->registerClass<SnapshotMotion>();
+    assembly->registerClass<SnapshotLink>();
+    return assembly;
+}
+
+TEST(EcsSnapshot, RoundTrip)
+{
+    Ecs::EcsPtr    world  = Ecs::Ecs::create();
+    Ecs::EntityPtr first  = world->createEntity();
+    Ecs::EntityPtr second = world->createEntity();
+
+    first->attachComponent( DC_NEW SnapshotMotion )->setPosition( Vec3( 1.0f, 2.0f, 3.0f ) );
+    second->attachComponent( DC_NEW SnapshotMotion )->setMass( 10.0f );
+
+    SnapshotLink* link = second->attachComponent( DC_NEW SnapshotLink );
+    link->setName( "link" );
+    link->setTarget( first );
+
+    world->addEntity( first );
+    world->addEntity( second );
+
+    Io::ByteBufferPtr stream = Io::ByteBuffer::create();
+    EXPECT_TRUE( Ecs::WorldSnapshot( world ).save( stream.get() ) );
+
+    // Load a snapshot to an empty world
+    Ecs::EcsPtr        restored = Ecs::Ecs::create();
+    Ecs::WorldSnapshot snapshot( restored );
+    stream->setPosition( 0 );
+    EXPECT_EQ( 2, snapshot.load( createSnapshotAssembly(), stream.get() ) );
+    EXPECT_FALSE( stream->hasDataLeft() );
+
+    Ecs::EntityPtr a = restored->findEntity( first->id() );
+    Ecs::EntityPtr b = restored->findEntity( second->id() );
+    ASSERT_TRUE( a.valid() );
+    ASSERT_TRUE( b.valid() );
+
+    EXPECT_EQ( Vec3( 1.0f, 2.0f, 3.0f ), a->get<SnapshotMotion>()->position() );
+    EXPECT_EQ( 10.0f, b->get<SnapshotMotion>()->mass() );
+    EXPECT_EQ( "link", b->get<SnapshotLink>()->name() );
+    EXPECT_EQ( a.get(), b->get<SnapshotLink>()->target().get() );
+    EXPECT_EQ( NULL, a->has<SnapshotLink>() );
+}
+
+TEST(EcsSnapshot, RestoresEntitiesInPlace)
+{
+    Ecs::EcsPtr    world  = Ecs::Ecs::create();
+    Ecs::EntityPtr entity = world->createEntity();
+
+    entity->attachComponent( DC_NEW SnapshotMotion )->setMass( 1.0f );
+    world->addEntity( entity );
+
+    Ecs::WorldSnapshot snapshot( world );
+    Io::ByteBufferPtr  stream = Io::ByteBuffer::create();
+    EXPECT_TRUE( snapshot.save( stream.get() ) );
+
+    // Modify an entity after a snapshot was taken
+    entity->get<SnapshotMotion>()->setMass( 5.0f );
+    entity->attachComponent( DC_NEW SnapshotLink );
+
+    // Rollback
+    stream->setPosition( 0 );
+    EXPECT_EQ( 1, snapshot.load( createSnapshotAssembly(), stream.get() ) );
+
+    EXPECT_EQ( entity.get(), world->findEntity( entity->id() ).get() );
+    EXPECT_EQ( 1.0f, entity->get<SnapshotMotion>()->mass() );
+    EXPECT_EQ( NULL, entity->has<SnapshotLink>() );
+}
@@ -0,0 +1,113 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A projectile component copied from a prefab.
+class SpawnedProjectile : public Ecs::Component<SpawnedProjectile> {
+public:
+
+                            SpawnedProjectile( void )
+                                : speed( 0.0f ) {}
+
+    f32                     speed;  //!< A projectile speed.
+};
+
+//! A tag component that is not present on a prefab.
+class SpawnedTarget : public Ecs::Component<SpawnedTarget> {
+};
+
+//! Creates a projectile prefab added to a world.
+static Ecs::EntityPtr createPrefab( Ecs::EcsWPtr ecs )
+{
+    Ecs::EntityPtr prefab = ecs->createEntity();
+    prefab->attach<SpawnedProjectile>()->speed = 10.0f;
+    ecs->addEntity( prefab );
+    ecs->update( 0, 0.0f );
+    return prefab;
+}
+
+TEST(EcsSpawnBatch, CopiesPrefabComponents)
+{
+    Ecs::EcsPtr      ecs      = Ecs::Ecs::create();
+    Ecs::EntityPtr   prefab   = createPrefab( ecs );
+    Ecs::EntityArray entities = ecs->spawnBatch( prefab, 10 );
+
+    ASSERT_EQ( 10u, entities.size() );
+
+    for( s32 i = 0; i < 10; i++ ) {
+        SpawnedProjectile* projectile = entities[i]->has<SpawnedProjectile>();
+        ASSERT_TRUE( projectile != NULL );
+        EXPECT_TRUE( projectile != prefab->get<SpawnedProjectile>() );
+        EXPECT_TRUE( projectile->entity() == entities[i] );
+        EXPECT_EQ( 10.0f, projectile->speed );
+        EXPECT_TRUE( entities[i]->mask() == prefab->mask() );
+        EXPECT_TRUE( ecs->findEntity( entities[i]->id() ) == entities[i] );
+        EXPECT_TRUE( ecs->findEntity( entities[i]->handle() ) == entities[i] );
+    }
+
+    EXPECT_EQ( 11, ecs->entityCount() );
+}
+
+TEST(EcsSpawnBatch, InsertsEntitiesToMatchingIndices)
+{
+    Ecs::EcsPtr    ecs         = Ecs::Ecs::create();
+    Ecs::IndexPtr  projectiles = ecs->requestIndex( "Projectiles", Ecs::Aspect::all<SpawnedProjectile>() );
+    Ecs::IndexPtr  targets     = ecs->requestIndex( "Targets", Ecs::Aspect::all<SpawnedTarget>() );
+    Ecs::QueryPtr  query       = ecs->requestQuery( "Projectiles", Ecs::Aspect::all<SpawnedProjectile>(), SpawnedProjectile::bit() );
+    Ecs::EntityPtr prefab      = createPrefab( ecs );
+    query->changed();
+
+    Ecs::EntityArray entities = ecs->spawnBatch( prefab, 100 );
+
+    // Entities are indexed without waiting for the next update
+    EXPECT_EQ( 101, projectiles->size() );
+    EXPECT_EQ( 0, targets->size() );
+    EXPECT_EQ( 100u, query->changed().size() );
+
+    ecs->update( 0, 0.0f );
+    EXPECT_EQ( 101, projectiles->size() );
+
+    for( s32 i = 0; i < 50; i++ ) {
+        ecs->removeEntity( entities[i]->id() );
+    }
+    ecs->update( 0, 0.0f );
+
+    EXPECT_EQ( 51, projectiles->size() );
+}
+
+TEST(EcsSpawnBatch, IgnoresEmptyBatches)
+{
+    Ecs::EcsPtr    ecs    = Ecs::Ecs::create();
+    Ecs::EntityPtr prefab = createPrefab( ecs );
+
+    EXPECT_TRUE( ecs->spawnBatch( prefab, 0 ).empty() );
+    EXPECT_EQ( 1, ecs->entityCount() );
+}
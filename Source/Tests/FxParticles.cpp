@@ -0,0 +1,248 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+using namespace Fx;
+
+//! The number of particles used by compaction tests.
+static const s32 kParticleCount = 100;
+
+//! Fills all particle attributes with values derived from a particle index, particles with an index divisible by a period are dead.
+static void fillParticles( Particle& particles, s32 deadPeriod )
+{
+    for( s32 i = 0; i < kParticleCount; i++ ) {
+        f32 v = static_cast<f32>( i );
+
+        particles.indices[i]                    = i;
+        particles.position[i]                   = Vec3( v, v + 0.1f, v + 0.2f );
+        particles.velocity[i]                   = Vec3( -v, -v - 0.1f, -v - 0.2f );
+        particles.rotation[i]                   = v * 2.0f;
+        particles.life[i].current               = (deadPeriod && i % deadPeriod == 0) ? -1.0f : v + 1.0f;
+        particles.life[i].initial               = v + 2.0f;
+        particles.life[i].scalar                = v * 0.01f;
+        particles.size[i].initial               = v * 3.0f;
+        particles.size[i].current               = v * 4.0f;
+        particles.transparency[i].initial       = v * 5.0f;
+        particles.transparency[i].current       = v * 6.0f;
+        particles.color[i].initial              = Rgb( v, v * 0.5f, v * 0.25f );
+        particles.color[i].current              = Rgb( v * 0.25f, v * 0.5f, v );
+        particles.angularVelocity[i].initial    = v * 7.0f;
+        particles.angularVelocity[i].current    = v * 8.0f;
+        particles.force.velocity[i]             = Vec3( v * 9.0f, 0.0f, 0.0f );
+        particles.force.acceleration[i]         = Vec3( 0.0f, v * 10.0f, 0.0f );
+    }
+}
+
+//! Checks that all attributes of a particle at specified index were moved from a particle with a specified source index.
+static void expectParticle( const Particle& particles, s32 index, s32 source )
+{
+    f32 v = static_cast<f32>( source );
+
+    EXPECT_EQ( source, particles.indices[index] );
+    EXPECT_EQ( v + 0.2f, particles.position[index].z );
+    EXPECT_EQ( -v - 0.1f, particles.velocity[index].y );
+    EXPECT_EQ( v * 2.0f, particles.rotation[index] );
+    EXPECT_EQ( v + 1.0f, particles.life[index].current );
+    EXPECT_EQ( v + 2.0f, particles.life[index].initial );
+    EXPECT_EQ( v * 0.01f, particles.life[index].scalar );
+    EXPECT_EQ( v * 3.0f, particles.size[index].initial );
+    EXPECT_EQ( v * 4.0f, particles.size[index].current );
+    EXPECT_EQ( v * 5.0f, particles.transparency[index].initial );
+    EXPECT_EQ( v * 6.0f, particles.transparency[index].current );
+    EXPECT_EQ( v * 0.5f, particles.color[index].initial.g );
+    EXPECT_EQ( v, particles.color[index].current.b );
+    EXPECT_EQ( v * 7.0f, particles.angularVelocity[index].initial );
+    EXPECT_EQ( v * 8.0f, particles.angularVelocity[index].current );
+    EXPECT_EQ( v * 9.0f, particles.force.velocity[index].x );
+    EXPECT_EQ( v * 10.0f, particles.force.acceleration[index].y );
+}
+
+TEST(FxParticles, CompactionKeepsAliveParticles)
+{
+    Particle particles;
+    particles.allocate( kParticleCount );
+    fillParticles( particles, 0 );
+
+    EXPECT_EQ( kParticleCount, particles.compact( kParticleCount ) );
+
+    for( s32 i = 0; i < kParticleCount; i++ ) {
+        expectParticle( particles, i, i );
+    }
+}
+
+TEST(FxParticles, CompactionRemovesAllDeadParticles)
+{
+    Particle particles;
+    particles.allocate( kParticleCount );
+    fillParticles( particles, 1 );
+
+    EXPECT_EQ( 0, particles.compact( kParticleCount ) );
+}
+
+TEST(FxParticles, CompactionPreservesAttributes)
+{
+    Particle particles;
+    particles.allocate( kParticleCount );
+    fillParticles( particles, 3 );
+
+    s32 alive = particles.compact( kParticleCount );
+    EXPECT_EQ( kParticleCount - (kParticleCount + 2) / 3, alive );
+
+    // Alive particles keep their relative order and every attribute moves together
+    for( s32 i = 0, source = 0; i < alive; i++, source++ ) {
+        if( source % 3 == 0 ) {
+            source++;
+        }
+
+        expectParticle( particles, i, source );
+    }
+}
+
+TEST(FxParticles, CompactionIgnoresParticlesOutOfRange)
+{
+    Particle particles;
+    particles.allocate( kParticleCount );
+    fillParticles( particles, 2 );
+
+    // Only the first half of particles is alive before the compaction
+    s32 alive = particles.compact( kParticleCount / 2 );
+    EXPECT_EQ( kParticleCount / 4, alive );
+    expectParticle( particles, alive - 1, kParticleCount / 2 - 1 );
+}
+
+TEST(FxParameter, BakedCurveMatchesCurve)
+{
+    f32 keyframes[] = { 0.0f, 1.0f, 0.5f, 3.0f, 1.0f, 2.0f };
+
+    FloatParameter parameter;
+    parameter.setCurve( FloatArray( keyframes, keyframes + 6 ) );
+
+    f32 expected[11];
+    for( s32 i = 0; i <= 10; i++ ) {
+        expected[i] = parameter.sample( 0, i * 0.1f );
+    }
+
+    parameter.bake();
+    EXPECT_TRUE( parameter.isBaked() );
+
+    for( s32 i = 0; i <= 10; i++ ) {
+        EXPECT_NEAR( expected[i], parameter.sample( 0, i * 0.1f ), 0.01f );
+    }
+}
+
+TEST(FxParameter, EditingCurveInvalidatesTables)
+{
+    FloatParameter parameter;
+    parameter.setConstant( 2.0f );
+    parameter.bake();
+    EXPECT_EQ( 2.0f, parameter.sample( 0, 0.5f ) );
+
+    parameter.setConstant( 4.0f );
+    EXPECT_FALSE( parameter.isBaked() );
+
+    parameter.bake();
+    EXPECT_EQ( 4.0f, parameter.sample( 0, 0.5f ) );
+}
+
+TEST(FxParameter, ParameterWithoutKeyframesIsBaked)
+{
+    FloatParameter parameter;
+    parameter.bake();
+    EXPECT_TRUE( parameter.isBaked() );
+
+    f32 scalars[] = { 0.0f, 0.5f, 1.0f };
+    u32 indices[] = { 0, 1, 2 };
+    f32 result[3];
+
+    parameter.sample( indices, scalars, 1, result, 3, 7.0f );
+    EXPECT_EQ( 7.0f, parameter.sample( 0, 0.5f, 7.0f ) );
+
+    for( s32 i = 0; i < 3; i++ ) {
+        EXPECT_EQ( 7.0f, result[i] );
+    }
+}
+
+//! Creates a particle system with several emitters that emit particles with randomized initial attributes.
+static ParticleSystemPtr createRandomizedParticleSystem( void )
+{
+    ParticleSystemPtr particleSystem( DC_NEW ParticleSystem );
+
+    for( s32 i = 0; i < 4; i++ ) {
+        EmitterWPtr emitter = particleSystem->addEmitter();
+        emitter->setLooped( true );
+        emitter->setDuration( 1.0f );
+        emitter->setZone( DC_NEW SphereZone( 10.0f ) );
+        emitter->emission().setConstant( 50000.0f );
+
+        InitialLife* life = DC_NEW InitialLife;
+        life->get().setRandomBetweenConstants( 0.25f, 1.0f );
+        emitter->addModule( life );
+
+        InitialSpeed* speed = DC_NEW InitialSpeed;
+        speed->get().setRandomBetweenConstants( 1.0f, 5.0f );
+        emitter->addModule( speed );
+
+        emitter->addParticles()->setCount( 20000 );
+    }
+
+    particleSystem->bake();
+    return particleSystem;
+}
+
+TEST(FxParticleSystem, ParallelUpdateMatchesSerialUpdate)
+{
+    ParticleSystemPtr         particleSystem = createRandomizedParticleSystem();
+    ParticleSystemInstancePtr serial         = particleSystem->createInstance( IMaterialFactoryWPtr() );
+    ParticleSystemInstancePtr parallel       = particleSystem->createInstance( IMaterialFactoryWPtr() );
+
+    Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+    parallel->setTaskManager( taskManager );
+
+    serial->setSeed( 42 );
+    parallel->setSeed( 42 );
+
+    for( s32 frame = 0; frame < 30; frame++ ) {
+        ASSERT_EQ( serial->update( 1.0f / 30.0f ), parallel->update( 1.0f / 30.0f ) );
+
+        for( s32 i = 0; i < serial->emitterCount(); i++ ) {
+            ParticlesInstanceWPtr a = serial->emitter( i )->particles( 0 );
+            ParticlesInstanceWPtr b = parallel->emitter( i )->particles( 0 );
+
+            ASSERT_EQ( a->aliveCount(), b->aliveCount() );
+            EXPECT_FLOAT_EQ( a->bounds().min().x, b->bounds().min().x );
+            EXPECT_FLOAT_EQ( a->bounds().min().y, b->bounds().min().y );
+            EXPECT_FLOAT_EQ( a->bounds().min().z, b->bounds().min().z );
+            EXPECT_FLOAT_EQ( a->bounds().max().x, b->bounds().max().x );
+            EXPECT_FLOAT_EQ( a->bounds().max().y, b->bounds().max().y );
+            EXPECT_FLOAT_EQ( a->bounds().max().z, b->bounds().max().z );
+        }
+    }
+
+    EXPECT_GT( serial->aliveCount(), 0 );
+}
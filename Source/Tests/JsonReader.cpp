@@ -0,0 +1,98 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Collects root object member keys passed to a callback.
+class MemberCollector {
+public:
+
+    //! Stores a member key.
+    bool            collect( const String& key, const Variant& value )
+    {
+        keys.push_back( key );
+        return true;
+    }
+
+    Array<String>   keys;   //!< Collected member keys.
+};
+
+TEST(JsonReader, ParsesScalars)
+{
+    KeyValue kv = Io::VariantTextStream::parse( "{ \"int\": -42, \"real\": 1.5e2, \"flag\": true, \"text\": \"a\\tb\\u00e9\" }" ).as<KeyValue>();
+
+    EXPECT_EQ( -42, kv.valueAtKey( "int" ).as<s32>() );
+    EXPECT_EQ( 150.0, kv.valueAtKey( "real" ).as<f64>() );
+    EXPECT_TRUE( kv.valueAtKey( "flag" ).as<bool>() );
+    EXPECT_EQ( "a\tb\xc3\xa9", kv.valueAtKey( "text" ).as<String>() );
+}
+
+TEST(JsonReader, ConvertsTypedObjects)
+{
+    KeyValue kv = Io::VariantTextStream::parse( "{ \"position\": { \"x\": 1, \"y\": 2, \"z\": 3 }, \"color\": { \"r\": 0.5, \"g\": 0.5, \"b\": 1 } }" ).as<KeyValue>();
+
+    EXPECT_EQ( Vec3( 1.0f, 2.0f, 3.0f ), kv.valueAtKey( "position" ).as<Vec3>() );
+    EXPECT_TRUE( kv.valueAtKey( "color" ).type()->is<Rgb>() );
+}
+
+TEST(JsonReader, RejectsMalformedText)
+{
+    EXPECT_FALSE( Io::VariantTextStream::parse( "{ \"a\": [1, 2,, 3] }" ).isValid() );
+    EXPECT_FALSE( Io::VariantTextStream::parse( "{ \"a\": \"unterminated }" ).isValid() );
+    EXPECT_FALSE( Io::VariantTextStream::parse( "[1] 2" ).isValid() );
+}
+
+TEST(JsonReader, StreamsRootMembers)
+{
+    String          json = "{ \"first\": { \"class\": \"SceneObject\" }, \"second\": [ 1, 2 ] }";
+    MemberCollector collector;
+
+    EXPECT_TRUE( Io::VariantTextStream::parseMembers( json.c_str(), static_cast<s32>( json.length() ), dcObjectMethod( &collector, MemberCollector::collect ) ) );
+    ASSERT_EQ( 2u, collector.keys.size() );
+    EXPECT_EQ( "first", collector.keys[0] );
+    EXPECT_EQ( "second", collector.keys[1] );
+}
+
+TEST(JsonReader, ParsesTinyValues)
+{
+    KeyValue kv = Io::VariantTextStream::parse( "{ \"a\": 0.00000000000000000001, \"b\": -0.000000000000000000000000000000000001, \"c\": 0.000123, \"d\": 1e-300 }" ).as<KeyValue>();
+
+    EXPECT_EQ( strtod( "0.00000000000000000001", NULL ), kv.valueAtKey( "a" ).as<f64>() );
+    EXPECT_EQ( strtod( "-0.000000000000000000000000000000000001", NULL ), kv.valueAtKey( "b" ).as<f64>() );
+    EXPECT_EQ( strtod( "0.000123", NULL ), kv.valueAtKey( "c" ).as<f64>() );
+    EXPECT_EQ( 1e-300, kv.valueAtKey( "d" ).as<f64>() );
+}
+
+TEST(JsonReader, ParsesLongFractions)
+{
+    KeyValue kv = Io::VariantTextStream::parse( "{ \"pi\": 3.14159265358979323846264338327950288, \"a\": 0.30000000000000004441, \"b\": 123456789012345678901234 }" ).as<KeyValue>();
+
+    EXPECT_EQ( strtod( "3.14159265358979323846264338327950288", NULL ), kv.valueAtKey( "pi" ).as<f64>() );
+    EXPECT_EQ( strtod( "0.30000000000000004441", NULL ), kv.valueAtKey( "a" ).as<f64>() );
+    EXPECT_EQ( strtod( "123456789012345678901234", NULL ), kv.valueAtKey( "b" ).as<f64>() );
+}
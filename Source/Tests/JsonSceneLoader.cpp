@@ -0,0 +1,95 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Returns true if particles of a first emitter have a module with a specified name.
+static bool hasParticleModule( const Scene::SceneObjectPtr& sceneObject, const String& name )
+{
+    Fx::ParticlesWPtr particles = sceneObject->get<Scene::Particles>()->particles()->emitter( 0 )->particles( 0 );
+
+    for( s32 i = 0, n = particles->moduleCount(); i < n; i++ ) {
+        if( particles->module( i )->name() == name ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//! Collects root object member values passed to a callback.
+class MemberValues {
+public:
+
+    //! Stores a member value.
+    bool            collect( const String& key, const Variant& value )
+    {
+        values.push_back( value );
+        return true;
+    }
+
+    Array<Variant>  values; //!< Collected member values.
+};
+
+TEST(JsonSceneLoader, ReadsVelocityModule)
+{
+    String json =
+        "{"
+        "    \"1\": { \"class\": \"SceneObject\", \"name\": \"sparks\" },"
+        "    \"2\": {"
+        "        \"class\": \"Particles\", \"sceneObject\": \"1\", \"isLooped\": true, \"duration\": 1,"
+        "        \"velocity\": { \"x\": 1, \"y\": { \"type\": \"constant\", \"value\": 2 }, \"z\": 3 }"
+        "    }"
+        "}";
+
+    Scene::Resources       resources;
+    Scene::ScenePtr        scene = Scene::Scene::create();
+    Scene::JsonSceneLoader loader( resources );
+
+    ASSERT_TRUE( loader.load( scene, json ) );
+
+    Scene::SceneObjectSet objects = scene->findAllWithName( "sparks" );
+    ASSERT_EQ( 1u, objects.size() );
+    ASSERT_TRUE( (*objects.begin())->has<Scene::Particles>() != NULL );
+    EXPECT_TRUE( hasParticleModule( *objects.begin(), "LinearVelocity" ) );
+}
+
+TEST(JsonSceneLoader, KeepsVectorLikeObjectsUntyped)
+{
+    String       json = "{ \"velocity\": { \"x\": 1, \"y\": 2, \"z\": 3 } }";
+    MemberValues collector;
+
+    EXPECT_TRUE( Io::VariantTextStream::parseMembers( json.c_str(), static_cast<s32>( json.length() ), dcObjectMethod( &collector, MemberValues::collect ), false ) );
+    ASSERT_EQ( 1u, collector.values.size() );
+    ASSERT_TRUE( collector.values[0].type()->is<KeyValue>() );
+    EXPECT_EQ( 2, collector.values[0].as<KeyValue>().valueAtKey( "y" ).as<s32>() );
+
+    // Objects with non-numeric vector keys are never converted
+    KeyValue kv = Io::VariantTextStream::parse( "{ \"velocity\": { \"x\": { \"type\": \"constant\" }, \"y\": 2, \"z\": 3 } }" ).as<KeyValue>();
+    EXPECT_TRUE( kv.valueAtKey( "velocity" ).type()->is<KeyValue>() );
+}
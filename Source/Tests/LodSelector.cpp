@@ -0,0 +1,239 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Returns a box with a bounding sphere of a specified radius at a distance from an origin along the negative Z axis.
+static Bounds boxAtDistance( f32 distance, f32 radius = 1.0f )
+{
+    f32 half = radius / sqrtf( 3.0f );
+    return Bounds( Vec3( -half, -half, -distance - half ), Vec3( half, half, -distance + half ) );
+}
+
+//! Returns a perspective view located at an origin with a unit scale.
+static Scene::LodSelector::View lodView( void )
+{
+    Scene::LodSelector::View view;
+    view.position    = Vec3( 0.0f, 0.0f, 0.0f );
+    view.scale       = 1.0f;
+    view.perspective = true;
+    return view;
+}
+
+//! Returns a group with three levels.
+static Scene::LodGroup createLodGroup( void )
+{
+    Scene::LodGroup group( 0.1f );
+    group.addLevel( Scene::MeshHandle(), 0.5f );
+    group.addLevel( Scene::MeshHandle(), 0.2f );
+    group.addLevel( Scene::MeshHandle(), 0.05f );
+    return group;
+}
+
+//! Selects a level of a single object at a specified distance.
+static s32 selectAt( Scene::LodSelector& selector, const Scene::LodGroup& group, f32 distance )
+{
+    Bounds                 bounds = boxAtDistance( distance );
+    const Scene::LodGroup* groups = &group;
+    selector.select( lodView(), &bounds, &groups, 1 );
+    return selector.state( 0 ).level;
+}
+
+TEST(LodSelector, ScreenSizeIsInverselyProportionalToDistance)
+{
+    Scene::LodSelector::View view = lodView();
+
+    EXPECT_NEAR( 0.5f, Scene::LodSelector::screenSize( view, boxAtDistance( 2.0f ) ), 1e-5f );
+    EXPECT_NEAR( 0.1f, Scene::LodSelector::screenSize( view, boxAtDistance( 10.0f ) ), 1e-5f );
+
+    // A camera inside a bounding sphere
+    EXPECT_NEAR( 1.0f, Scene::LodSelector::screenSize( view, boxAtDistance( 0.5f ) ), 1e-5f );
+
+    // Orthographic cameras ignore a distance
+    view.perspective = false;
+    view.scale       = 0.25f;
+    EXPECT_NEAR( 0.5f, Scene::LodSelector::screenSize( view, boxAtDistance( 100.0f, 2.0f ) ), 1e-5f );
+}
+
+TEST(LodSelector, LevelsMatchScreenSize)
+{
+    Scene::LodGroup group = createLodGroup();
+
+    const f32 distances[] = { 1.5f, 4.0f, 10.0f, 100.0f };
+    const s32 levels[]    = { 0, 1, 2, 3 };
+
+    for( s32 i = 0; i < 4; i++ ) {
+        Scene::LodSelector selector;
+        EXPECT_EQ( levels[i], selectAt( selector, group, distances[i] ) );
+    }
+}
+
+TEST(LodSelector, HysteresisPreventsPopping)
+{
+    Scene::LodGroup    group = createLodGroup();
+    Scene::LodSelector selector;
+
+    EXPECT_EQ( 1, selectAt( selector, group, 4.0f ) );
+
+    // Moving slightly past a threshold keeps a level
+    EXPECT_EQ( 1, selectAt( selector, group, 1.9f ) );
+    EXPECT_EQ( 0, selectAt( selector, group, 1.7f ) );
+
+    // Moving slightly back keeps a finer level as well
+    EXPECT_EQ( 0, selectAt( selector, group, 2.1f ) );
+    EXPECT_EQ( 1, selectAt( selector, group, 2.4f ) );
+}
+
+TEST(LodSelector, ObjectsWithoutGroupUseFirstLevel)
+{
+    Scene::LodGroup    group = createLodGroup();
+    Scene::LodSelector selector;
+
+    Bounds                 bounds[] = { boxAtDistance( 100.0f ), boxAtDistance( 100.0f ) };
+    const Scene::LodGroup* groups[] = { NULL, &group };
+
+    selector.select( lodView(), bounds, groups, 2 );
+
+    ASSERT_EQ( 2, selector.count() );
+    EXPECT_EQ( 0, selector.state( 0 ).level );
+    EXPECT_EQ( 3, selector.state( 1 ).level );
+}
+
+TEST(LodSelector, CrossFadeStartsFromPreviousLevel)
+{
+    Scene::LodGroup group = createLodGroup();
+    group.setCrossFade( true );
+    group.setCrossFadeFrames( 4 );
+
+    Scene::LodSelector selector;
+    selectAt( selector, group, 1.5f );
+    EXPECT_FLOAT_EQ( 1.0f, selector.state( 0 ).fade );
+
+    // Switching to a coarser level starts a cross-fade
+    EXPECT_EQ( 1, selectAt( selector, group, 4.0f ) );
+    EXPECT_EQ( 0, selector.state( 0 ).previous );
+    EXPECT_FLOAT_EQ( 0.0f, selector.state( 0 ).fade );
+
+    for( s32 i = 1; i <= 4; i++ ) {
+        selectAt( selector, group, 4.0f );
+        EXPECT_FLOAT_EQ( i * 0.25f, selector.state( 0 ).fade );
+    }
+
+    // A cross-fade is disabled by default
+    Scene::LodGroup    instant = createLodGroup();
+    Scene::LodSelector other;
+    selectAt( other, instant, 1.5f );
+    selectAt( other, instant, 4.0f );
+    EXPECT_FLOAT_EQ( 1.0f, other.state( 0 ).fade );
+}
+
+TEST(LodSelector, ParallelSelectionMatchesSerial)
+{
+    Scene::LodGroup group = createLodGroup();
+
+    Array<Bounds>                 bounds;
+    Array<const Scene::LodGroup*> groups;
+
+    for( s32 i = 0; i < 5000; i++ ) {
+        bounds.push_back( boxAtDistance( 1.0f + (i % 997) * 0.05f ) );
+        groups.push_back( i % 7 ? &group : NULL );
+    }
+
+    Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+
+    Scene::LodSelector serial;
+    Scene::LodSelector parallel;
+    parallel.setTaskManager( taskManager );
+
+    serial.select( lodView(), &bounds[0], &groups[0], static_cast<s32>( bounds.size() ) );
+    parallel.select( lodView(), &bounds[0], &groups[0], static_cast<s32>( bounds.size() ) );
+
+    for( s32 i = 0, n = static_cast<s32>( bounds.size() ); i < n; i++ ) {
+        ASSERT_EQ( serial.state( i ).level, parallel.state( i ).level );
+    }
+}
+
+TEST(LodSelector, StatesFollowObjectKeys)
+{
+    Scene::LodGroup    group = createLodGroup();
+    Scene::LodSelector selector;
+
+    // The first object is close to a camera, the second one uses a coarser level
+    Bounds                 bounds[] = { boxAtDistance( 1.5f ), boxAtDistance( 4.0f ) };
+    const Scene::LodGroup* groups[] = { &group, &group };
+    u64                    keys[]   = { 10, 20 };
+
+    selector.select( lodView(), bounds, groups, 2, keys );
+    EXPECT_EQ( 0, selector.state( 0 ).level );
+    EXPECT_EQ( 1, selector.state( 1 ).level );
+
+    // The first object is removed and a new one is added within a single frame, both are inside a hysteresis band
+    bounds[0] = bounds[1] = boxAtDistance( 1.9f );
+    keys[0]   = 20;
+    keys[1]   = 30;
+
+    selector.select( lodView(), bounds, groups, 2, keys );
+    ASSERT_EQ( 2, selector.count() );
+    EXPECT_EQ( 1, selector.state( 0 ).level );
+    EXPECT_EQ( 0, selector.state( 1 ).level );
+}
+
+TEST(LodSelector, ShadowCastersUseCoarsestLevel)
+{
+    Scene::RenderScene::IndexRanges base( 1 ), coarse( 1 );
+
+    Scene::RenderScene::StaticMeshNode mesh;
+    mesh.states   = NULL;
+    mesh.count    = 36;
+    mesh.vertices = 24;
+    mesh.ranges   = &base;
+
+    // A mesh without levels casts shadows with a base mesh
+    EXPECT_EQ( &base, Scene::RenderScene::shadowCasterLevel( mesh ).ranges );
+    EXPECT_EQ( 36, Scene::RenderScene::shadowCasterLevel( mesh ).count );
+
+    Scene::RenderScene::StaticMeshNode::Lod level;
+    level.states   = NULL;
+    level.count    = 12;
+    level.vertices = 8;
+    level.ranges   = &coarse;
+    mesh.lods.push_back( level );
+
+    // A level without a mesh is skipped, so a caster is never culled
+    level.count    = 0;
+    level.vertices = 0;
+    level.ranges   = NULL;
+    mesh.lods.push_back( level );
+
+    EXPECT_EQ( &coarse, Scene::RenderScene::shadowCasterLevel( mesh ).ranges );
+    EXPECT_EQ( 12, Scene::RenderScene::shadowCasterLevel( mesh ).count );
+}
@@ -0,0 +1,211 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+// Mesh importers are a part of the Composer and are built only with Qt
+#ifdef DC_QT_VERSION
+
+#include "../Composer/Importers/MeshImporter.h"
+#include "../Composer/FileSystem.h"
+
+DC_USE_DREEMCHEST
+
+//! Imports a grid of quads on the XZ plane instead of parsing a source file.
+class MeshImporterGrid : public Importers::MeshImporter {
+public:
+
+    enum { Size = 4 };
+
+protected:
+
+    //! Adds a single grid node with a texture path that should be written as a base name.
+    virtual bool importNodes( FileSystemQPtr fs, const Io::Path& sourceFileName ) NIMBLE_OVERRIDE
+    {
+        Node node;
+        node.texture = "Textures/Grid.tga";
+
+        for( s32 z = 0; z < Size; z++ ) {
+            for( s32 x = 0; x < Size; x++ ) {
+                s32 corners[6][2] = { { x, z }, { x, z + 1 }, { x + 1, z }, { x + 1, z }, { x, z + 1 }, { x + 1, z + 1 } };
+
+                for( s32 i = 0; i < 6; i++ ) {
+                    Vertex vertex;
+                    vertex.position = Vec3( corners[i][0] - Size * 0.5f, 0.0f, corners[i][1] - Size * 0.5f );
+                    vertex.normal   = Vec3( 0.0f, 1.0f, 0.0f );
+                    vertex.uv[0]    = Vec2( corners[i][0] / f32( Size ), corners[i][1] / f32( Size ) );
+                    vertex.uv[1]    = Vec2( corners[i][0], corners[i][1] );
+                    node.mesh += vertex;
+                }
+            }
+        }
+
+        m_nodes.push_back( node );
+        return true;
+    }
+};
+
+//! A header and a first chunk layout read back from a mesh file.
+struct MeshImporterFile {
+            //! Constructs an empty MeshImporterFile instance.
+            MeshImporterFile( void )
+                : signature( 0 ), version( 0 ), chunkCount( 0 ), vertexCount( 0 ), indexCount( 0 ), attributes( 0 ), quantization( 0 ) {}
+
+    u32     signature;      //!< A file signature.
+    u32     version;        //!< A file version.
+    u32     chunkCount;     //!< The total number of chunks.
+    String  texture;        //!< A first chunk texture name.
+    u32     vertexCount;    //!< The total number of chunk vertices.
+    u32     indexCount;     //!< The total number of chunk indices.
+    u8      attributes;     //!< A chunk vertex attribute mask.
+    u8      quantization;   //!< A chunk vertex quantization mask.
+    Vec3    min;            //!< Quantization bounds minimum.
+    Vec3    max;            //!< Quantization bounds maximum.
+};
+
+//! Imports a grid mesh with specified settings and reads back a written header.
+static MeshImporterFile meshImporterWrite( const Io::Path& fileName, const String& settings )
+{
+    FileSystem       fs( NULL );
+    MeshImporterGrid importer;
+    importer.setSettings( Io::VariantTextStream::parse( settings ).as<KeyValue>() );
+
+    MeshImporterFile result;
+
+    if( !importer.import( &fs, "Grid.fbx", fileName ) ) {
+        return result;
+    }
+
+    Io::StreamPtr stream = Io::DiskFileSystem::open( fileName );
+
+    if( !stream.valid() ) {
+        return result;
+    }
+
+    stream->read( &result.signature, 4 );
+    stream->read( &result.version, 4 );
+    stream->read( &result.chunkCount, 4 );
+    stream->readString( result.texture );
+    stream->read( &result.vertexCount, 4 );
+    stream->read( &result.indexCount, 4 );
+    stream->read( &result.attributes, 1 );
+    stream->read( &result.quantization, 1 );
+
+    if( result.quantization & Renderer::VertexFormat::QuantizedPosition ) {
+        stream->read( &result.min.x, sizeof( Vec3 ) );
+        stream->read( &result.max.x, sizeof( Vec3 ) );
+    }
+
+    return result;
+}
+
+//! Adds a mesh asset that is loaded from a file written by an importer.
+static Scene::MeshHandle meshImporterAsset( Assets::Assets& assets, const Io::Path& fileName )
+{
+    Scene::MeshFormatRaw* source = DC_NEW Scene::MeshFormatRaw;
+    source->setFileName( fileName.str() );
+    return assets.add<Scene::Mesh>( fileName.str(), source );
+}
+
+TEST(MeshImporter, WritesFloatVerticesByDefault)
+{
+    MeshImporterFile file = meshImporterWrite( "MeshImporterFloat.mesh", "{}" );
+
+    EXPECT_EQ( Scene::MeshFormatRaw::Signature, file.signature );
+    EXPECT_EQ( Scene::MeshFormatRaw::Version, file.version );
+    EXPECT_EQ( 1, file.chunkCount );
+    EXPECT_EQ( "Grid", file.texture );
+    EXPECT_EQ( ( MeshImporterGrid::Size + 1 ) * ( MeshImporterGrid::Size + 1 ), file.vertexCount );
+    EXPECT_EQ( MeshImporterGrid::Size * MeshImporterGrid::Size * 6, file.indexCount );
+    EXPECT_EQ( Renderer::VertexFormat::Normal | Renderer::VertexFormat::TexCoord0 | Renderer::VertexFormat::TexCoord1, file.attributes );
+    EXPECT_EQ( 0, file.quantization );
+
+    Assets::AssetsPtr assets( DC_NEW Assets::Assets );
+    Scene::MeshHandle mesh = meshImporterAsset( *assets, "MeshImporterFloat.mesh" );
+    ASSERT_TRUE( assets->forceLoad( mesh ) );
+
+    const Scene::Mesh::VertexBuffer& vertices = mesh->vertexBuffer();
+    const Scene::Mesh::IndexBuffer&  indices  = mesh->indexBuffer();
+
+    EXPECT_EQ( 1, mesh->chunkCount() );
+    EXPECT_EQ( "Grid", mesh->texture( 0 ) );
+    EXPECT_EQ( file.vertexCount, vertices.size() );
+    EXPECT_EQ( file.indexCount, indices.size() );
+
+    // Vertices are renumbered in an order of a first use
+    for( s32 i = 0, next = 0, n = static_cast<s32>( indices.size() ); i < n; i++ ) {
+        EXPECT_LE( indices[i], next );
+        next = max2( next, indices[i] + 1 );
+    }
+
+    for( s32 i = 0, n = static_cast<s32>( vertices.size() ); i < n; i++ ) {
+        EXPECT_EQ( vertices[i].position.x * 0.25f + 0.5f, vertices[i].uv[0].x );
+        EXPECT_EQ( vertices[i].position.z * 0.25f + 0.5f, vertices[i].uv[0].y );
+        EXPECT_EQ( 1.0f, vertices[i].normal.y );
+    }
+
+    std::remove( "MeshImporterFloat.mesh" );
+}
+
+TEST(MeshImporter, WritesQuantizedVerticesFromSettings)
+{
+    MeshImporterFile file = meshImporterWrite( "MeshImporterQuantized.mesh", "{ \"quantizePositions\": true, \"quantizeNormals\": true, \"quantizeTexCoords\": true }" );
+
+    EXPECT_EQ( Scene::MeshFormatRaw::Signature, file.signature );
+    EXPECT_EQ( Scene::MeshFormatRaw::Version, file.version );
+    EXPECT_EQ( 1, file.chunkCount );
+    EXPECT_EQ( "Grid", file.texture );
+    EXPECT_EQ( Renderer::VertexFormat::Normal | Renderer::VertexFormat::TexCoord0 | Renderer::VertexFormat::TexCoord1, file.attributes );
+    EXPECT_EQ( Renderer::VertexFormat::QuantizedPosition | Renderer::VertexFormat::OctahedralNormal | Renderer::VertexFormat::HalfTexCoord, file.quantization );
+
+    // Quantized positions are relative to chunk bounds written after a vertex format
+    EXPECT_EQ( Vec3( -2.0f, 0.0f, -2.0f ), file.min );
+    EXPECT_EQ( Vec3(  2.0f, 0.0f,  2.0f ), file.max );
+
+    Assets::AssetsPtr assets( DC_NEW Assets::Assets );
+    Scene::MeshHandle mesh = meshImporterAsset( *assets, "MeshImporterQuantized.mesh" );
+    ASSERT_TRUE( assets->forceLoad( mesh ) );
+
+    const Scene::Mesh::VertexBuffer& vertices = mesh->vertexBuffer();
+
+    EXPECT_EQ( file.vertexCount, vertices.size() );
+    EXPECT_EQ( file.indexCount, mesh->indexBuffer().size() );
+
+    for( s32 i = 0, n = static_cast<s32>( vertices.size() ); i < n; i++ ) {
+        const Vec3& position = vertices[i].position;
+
+        EXPECT_NEAR( floorf( position.x + 0.5f ), position.x, 1e-3f );
+        EXPECT_NEAR( 0.0f, position.y, 1e-3f );
+        EXPECT_NEAR( floorf( position.z + 0.5f ), position.z, 1e-3f );
+        EXPECT_NEAR( position.x * 0.25f + 0.5f, vertices[i].uv[0].x, 1e-3f );
+        EXPECT_NEAR( position.z * 0.25f + 0.5f, vertices[i].uv[0].y, 1e-3f );
+        EXPECT_NEAR( 1.0f, vertices[i].normal.y, 1e-3f );
+    }
+
+    std::remove( "MeshImporterQuantized.mesh" );
+}
+
+#endif  /*  DC_QT_VERSION   */
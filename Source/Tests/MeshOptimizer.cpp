@@ -0,0 +1,284 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A triangle with sorted vertex indices used to compare triangle sets.
+typedef std::pair<u16, std::pair<u16, u16> > MeshOptimizerTriangle;
+
+//! Builds a grid of quads with triangles written in a pseudo-random order.
+static void meshOptimizerGrid( s32 size, Array<Vec3>& positions, Array<u16>& indices )
+{
+    for( s32 z = 0; z <= size; z++ ) {
+        for( s32 x = 0; x <= size; x++ ) {
+            positions.push_back( Vec3( static_cast<f32>( x ), 0.0f, static_cast<f32>( z ) ) );
+        }
+    }
+
+    Array<s32> order;
+
+    for( s32 i = 0; i < size * size; i++ ) {
+        order.push_back( i );
+    }
+
+    // A linear congruential generator keeps a shuffled order stable
+    u32 seed = 12345;
+
+    for( s32 i = static_cast<s32>( order.size() ) - 1; i > 0; i-- ) {
+        seed = seed * 1103515245 + 12345;
+        std::swap( order[i], order[(seed >> 16) % (i + 1)] );
+    }
+
+    for( s32 i = 0, n = static_cast<s32>( order.size() ); i < n; i++ ) {
+        s32 x = order[i] % size;
+        s32 z = order[i] / size;
+        u16 a = static_cast<u16>( z * (size + 1) + x );
+        u16 b = static_cast<u16>( a + 1 );
+        u16 c = static_cast<u16>( a + size + 1 );
+        u16 d = static_cast<u16>( c + 1 );
+
+        indices.push_back( a ); indices.push_back( c ); indices.push_back( b );
+        indices.push_back( b ); indices.push_back( c ); indices.push_back( d );
+    }
+}
+
+//! Returns a sorted list of triangles with vertex indices sorted inside each triangle.
+static Array<MeshOptimizerTriangle> meshOptimizerTriangles( const Array<u16>& indices )
+{
+    Array<MeshOptimizerTriangle> result;
+
+    for( s32 i = 0, n = static_cast<s32>( indices.size() ); i < n; i += 3 ) {
+        u16 v[3] = { indices[i], indices[i + 1], indices[i + 2] };
+        std::sort( v, v + 3 );
+        result.push_back( std::make_pair( v[0], std::make_pair( v[1], v[2] ) ) );
+    }
+
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+TEST(MeshOptimizer, VertexCacheOptimizationReducesAcmr)
+{
+    Array<Vec3> positions;
+    Array<u16>  indices;
+    meshOptimizerGrid( 64, positions, indices );
+
+    s32 vertexCount = static_cast<s32>( positions.size() );
+    s32 indexCount  = static_cast<s32>( indices.size() );
+
+    Array<MeshOptimizerTriangle> triangles = meshOptimizerTriangles( indices );
+    f32 before = Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount );
+
+    Scene::MeshOptimizer::optimizeVertexCache( &indices[0], indexCount, vertexCount );
+    f32 after = Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount );
+
+    // Only vertices shared by two triangles of a quad hit a cache of a shuffled grid, an optimized one transforms each vertex about once
+    EXPECT_GT( before, 1.9f );
+    EXPECT_LT( after, 0.8f );
+    EXPECT_TRUE( triangles == meshOptimizerTriangles( indices ) );
+}
+
+TEST(MeshOptimizer, AcmrOfTriangleStrip)
+{
+    // Each next triangle of a strip adds a single vertex
+    Array<u16> indices;
+
+    for( u16 i = 0; i < 100; i++ ) {
+        indices.push_back( i );
+        indices.push_back( i + 1 );
+        indices.push_back( i + 2 );
+    }
+
+    EXPECT_NEAR( 102.0f / 100.0f, Scene::MeshOptimizer::acmr( &indices[0], 300, 102 ), 1e-5f );
+
+    // A cache of a single vertex misses every index
+    EXPECT_NEAR( 3.0f, Scene::MeshOptimizer::acmr( &indices[0], 300, 102, 1 ), 1e-5f );
+}
+
+TEST(MeshOptimizer, OverdrawOptimizationRendersOuterSurfacesFirst)
+{
+    // Three disjoint triangles, the first one faces a mesh center and others face away from it
+    Vec3 positions[] = {
+          Vec3( 0.0f, 1.0f, 0.0f ), Vec3( 0.0f, 1.0f, 1.0f ), Vec3( 1.0f, 1.0f, 0.0f )
+        , Vec3( 0.0f, 2.0f, 0.0f ), Vec3( 0.0f, 2.0f, 1.0f ), Vec3( 1.0f, 2.0f, 0.0f )
+        , Vec3( 0.0f, -3.0f, 0.0f ), Vec3( 1.0f, -3.0f, 0.0f ), Vec3( 0.0f, -3.0f, 1.0f )
+    };
+    u16 indices[] = { 0, 2, 1, 3, 4, 5, 6, 7, 8 };
+
+    s32 clusters = Scene::MeshOptimizer::optimizeOverdraw( indices, 9, positions, sizeof( Vec3 ), 9 );
+
+    // A triangle farther from a center goes first and one facing a center goes last
+    EXPECT_EQ( 3, clusters );
+    EXPECT_EQ( 6, indices[0] );
+    EXPECT_EQ( 3, indices[3] );
+    EXPECT_EQ( 0, indices[6] );
+}
+
+TEST(MeshOptimizer, OverdrawOptimizationKeepsCacheEfficiency)
+{
+    Array<Vec3> positions;
+    Array<u16>  indices;
+    meshOptimizerGrid( 64, positions, indices );
+
+    s32 vertexCount = static_cast<s32>( positions.size() );
+    s32 indexCount  = static_cast<s32>( indices.size() );
+
+    // Bend a grid to a half cylinder so that clusters get different orientations
+    for( s32 i = 0; i < vertexCount; i++ ) {
+        f32 angle    = positions[i].x / 64.0f * 3.1415926f;
+        positions[i] = Vec3( cosf( angle ) * 10.0f, sinf( angle ) * 10.0f, positions[i].z );
+    }
+
+    Scene::MeshOptimizer::optimizeVertexCache( &indices[0], indexCount, vertexCount );
+
+    Array<MeshOptimizerTriangle> triangles = meshOptimizerTriangles( indices );
+    f32 before = Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount );
+
+    Scene::MeshOptimizer::optimizeOverdraw( &indices[0], indexCount, &positions[0], sizeof( Vec3 ), vertexCount );
+
+    EXPECT_LT( Scene::MeshOptimizer::acmr( &indices[0], indexCount, vertexCount ), before * 1.05f );
+    EXPECT_TRUE( triangles == meshOptimizerTriangles( indices ) );
+}
+
+TEST(MeshOptimizer, VertexFetchOptimizationRenumbersVertices)
+{
+    u16        indices[] = { 5, 2, 5, 7, 2, 0 };
+    Array<u16> remap;
+
+    EXPECT_EQ( 4, Scene::MeshOptimizer::optimizeVertexFetch( indices, 6, 8, remap ) );
+
+    const u16 expected[] = { 0, 1, 0, 2, 1, 3 };
+
+    for( s32 i = 0; i < 6; i++ ) {
+        EXPECT_EQ( expected[i], indices[i] );
+    }
+
+    Array<s32> vertices;
+
+    for( s32 i = 0; i < 8; i++ ) {
+        vertices.push_back( i * 10 );
+    }
+
+    Scene::MeshOptimizer::remapVertices( vertices, remap );
+
+    ASSERT_EQ( 4, static_cast<s32>( vertices.size() ) );
+    EXPECT_EQ( 50, vertices[0] );
+    EXPECT_EQ( 20, vertices[1] );
+    EXPECT_EQ( 70, vertices[2] );
+    EXPECT_EQ( 0,  vertices[3] );
+}
+
+TEST(MeshOptimizer, HalfFloatConversion)
+{
+    const f32 exact[] = { 0.0f, 1.0f, -2.0f, 0.5f, 0.25f, 65504.0f, -0.000061035156f };
+
+    for( s32 i = 0; i < 7; i++ ) {
+        EXPECT_EQ( exact[i], Scene::MeshOptimizer::decodeHalf( Scene::MeshOptimizer::encodeHalf( exact[i] ) ) );
+    }
+
+    for( s32 i = 1; i < 1000; i++ ) {
+        f32 value = i * 0.0137f - 5.0f;
+        EXPECT_NEAR( value, Scene::MeshOptimizer::decodeHalf( Scene::MeshOptimizer::encodeHalf( value ) ), fabsf( value ) * 1e-3f );
+    }
+
+    // Subnormals, overflows and infinities
+    EXPECT_NEAR( 1e-6f, Scene::MeshOptimizer::decodeHalf( Scene::MeshOptimizer::encodeHalf( 1e-6f ) ), 1e-7f );
+    EXPECT_EQ( 0x7c00, Scene::MeshOptimizer::encodeHalf( 1e6f ) );
+    EXPECT_EQ( 0xfc00, Scene::MeshOptimizer::encodeHalf( -1e6f ) );
+}
+
+TEST(MeshOptimizer, OctahedralNormals)
+{
+    for( s32 i = 0; i < 32; i++ ) {
+        for( s32 j = 0; j <= 16; j++ ) {
+            f32  theta  = i / 32.0f * 6.2831853f;
+            f32  phi    = j / 16.0f * 3.1415926f;
+            Vec3 normal = Vec3( sinf( phi ) * cosf( theta ), sinf( phi ) * sinf( theta ), cosf( phi ) );
+
+            s16 x, y;
+            Scene::MeshOptimizer::encodeOctahedral( normal, x, y );
+            Vec3 decoded = Scene::MeshOptimizer::decodeOctahedral( x, y );
+
+            EXPECT_GT( decoded.x * normal.x + decoded.y * normal.y + decoded.z * normal.z, 0.99999f );
+        }
+    }
+}
+
+TEST(MeshOptimizer, QuantizedVerticesDecodeBack)
+{
+    typedef Renderer::VertexFormat VertexFormat;
+
+    Scene::Mesh::VertexBuffer vertices;
+    Bounds                    bounds;
+
+    for( s32 i = 0; i < 100; i++ ) {
+        Scene::Mesh::Vertex vertex;
+        vertex.position = Vec3( i * 0.37f - 10.0f, sinf( i * 0.1f ) * 5.0f, i * 0.05f );
+        vertex.normal   = Vec3( cosf( i * 0.3f ), sinf( i * 0.3f ), 0.0f );
+        vertex.uv[0]    = Vec2( i / 100.0f, 1.0f - i / 100.0f );
+        vertex.uv[1]    = Vec2( i * 0.5f, 0.0f );
+        vertices.push_back( vertex );
+        bounds << vertex.position;
+    }
+
+    VertexFormat floats( VertexFormat::Normal | VertexFormat::TexCoord0 | VertexFormat::TexCoord1 );
+    VertexFormat quantized( VertexFormat::Normal | VertexFormat::TexCoord0 | VertexFormat::TexCoord1, VertexFormat::QuantizedPosition | VertexFormat::OctahedralNormal | VertexFormat::HalfTexCoord );
+
+    EXPECT_EQ( 40, floats.vertexSize() );
+    EXPECT_EQ( 20, quantized.vertexSize() );
+    EXPECT_FALSE( floats == quantized );
+
+    Array<u8>                 encoded;
+    Scene::Mesh::VertexBuffer decoded;
+
+    encoded.resize( vertices.size() * quantized.vertexSize() );
+    decoded.resize( vertices.size() );
+
+    Scene::MeshOptimizer::encodeVertices( &vertices[0], 100, quantized, bounds, &encoded[0] );
+    Scene::MeshOptimizer::decodeVertices( &encoded[0], 100, quantized, bounds, &decoded[0] );
+
+    for( s32 i = 0; i < 100; i++ ) {
+        EXPECT_NEAR( vertices[i].position.x, decoded[i].position.x, 1e-3f );
+        EXPECT_NEAR( vertices[i].position.y, decoded[i].position.y, 1e-3f );
+        EXPECT_NEAR( vertices[i].position.z, decoded[i].position.z, 1e-3f );
+        EXPECT_NEAR( vertices[i].normal.x, decoded[i].normal.x, 1e-3f );
+        EXPECT_NEAR( vertices[i].normal.y, decoded[i].normal.y, 1e-3f );
+        EXPECT_NEAR( vertices[i].uv[0].x, decoded[i].uv[0].x, 1e-3f );
+        EXPECT_NEAR( vertices[i].uv[1].x, decoded[i].uv[1].x, 1e-2f );
+    }
+
+    // Floating point vertices are copied as is
+    encoded.resize( vertices.size() * floats.vertexSize() );
+    Scene::MeshOptimizer::encodeVertices( &vertices[0], 100, floats, bounds, &encoded[0] );
+    Scene::MeshOptimizer::decodeVertices( &encoded[0], 100, floats, bounds, &decoded[0] );
+    EXPECT_EQ( 0, memcmp( &vertices[0], &decoded[0], sizeof( Scene::Mesh::Vertex ) * vertices.size() ) );
+}
@@ -0,0 +1,204 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A camera looks down the negative Z axis and matches a default depth buffer aspect ratio.
+static Matrix4 occlusionViewProjection( void )
+{
+    return Matrix4::perspective( 90.0f, 2.0f, 0.1f, 100.0f );
+}
+
+//! Returns a box around a point.
+static Bounds boxAt( f32 x, f32 y, f32 z, f32 size )
+{
+    return Bounds( Vec3( x - size, y - size, z - size ), Vec3( x + size, y + size, z + size ) );
+}
+
+//! Rasterizes a square wall that faces a camera.
+static void rasterizeWall( Scene::OcclusionCuller& culler, f32 depth, f32 halfSize, const Matrix4& transform = Matrix4::translation( 0.0f, 0.0f, 0.0f ) )
+{
+    Vec3 positions[] = {
+          Vec3( -halfSize, -halfSize, depth )
+        , Vec3(  halfSize, -halfSize, depth )
+        , Vec3(  halfSize,  halfSize, depth )
+        , Vec3( -halfSize,  halfSize, depth )
+    };
+    u16 indices[] = { 0, 1, 2, 0, 2, 3 };
+
+    culler.begin( occlusionViewProjection() );
+    culler.addOccluder( positions, sizeof( Vec3 ), indices, 6, transform );
+    culler.rasterize();
+}
+
+TEST(OcclusionCuller, PyramidLevelsAreHalved)
+{
+    Scene::OcclusionCuller culler( 256, 128 );
+
+    EXPECT_EQ( 256, culler.width() );
+    EXPECT_EQ( 128, culler.height() );
+    EXPECT_EQ( 9, culler.levelCount() );
+}
+
+TEST(OcclusionCuller, EmptyDepthBufferHidesNothing)
+{
+    Scene::OcclusionCuller culler;
+    culler.begin( occlusionViewProjection() );
+    culler.rasterize();
+
+    EXPECT_EQ( 0, culler.triangleCount() );
+    EXPECT_TRUE( culler.isVisible( boxAt( 0.0f, 0.0f, -50.0f, 1.0f ) ) );
+    EXPECT_FLOAT_EQ( 1.0f, culler.depthAt( culler.levelCount() - 1, 0, 0 ) );
+}
+
+TEST(OcclusionCuller, BoxesOutsideOfFrustumAreHidden)
+{
+    Scene::OcclusionCuller culler;
+    culler.begin( occlusionViewProjection() );
+    culler.rasterize();
+
+    EXPECT_FALSE( culler.isVisible( boxAt( 0.0f, 0.0f, 10.0f, 1.0f ) ) );     // Behind a camera
+    EXPECT_FALSE( culler.isVisible( boxAt( 0.0f, 0.0f, -200.0f, 1.0f ) ) );   // Behind a far plane
+    EXPECT_FALSE( culler.isVisible( boxAt( 100.0f, 0.0f, -10.0f, 1.0f ) ) );  // Right of a screen
+    EXPECT_TRUE ( culler.isVisible( boxAt( 0.0f, 0.0f, 0.0f, 1.0f ) ) );      // Crosses a near plane
+}
+
+TEST(OcclusionCuller, WallHidesBoxesBehindIt)
+{
+    Scene::OcclusionCuller culler;
+    rasterizeWall( culler, -10.0f, 5.0f );
+
+    EXPECT_EQ( 2, culler.triangleCount() );
+    EXPECT_TRUE ( culler.isVisible( boxAt( 0.0f, 0.0f, -5.0f, 1.0f ) ) );     // In front of a wall
+    EXPECT_FALSE( culler.isVisible( boxAt( 0.0f, 0.0f, -20.0f, 1.0f ) ) );    // Behind a wall
+    EXPECT_FALSE( culler.isVisible( boxAt( 0.0f, 0.0f, -90.0f, 10.0f ) ) );   // A large box behind a wall
+    EXPECT_TRUE ( culler.isVisible( boxAt( 0.0f, 0.0f, -10.0f, 1.0f ) ) );    // Intersects a wall
+    EXPECT_TRUE ( culler.isVisible( boxAt( 12.0f, 0.0f, -20.0f, 1.0f ) ) );   // Sticks out of a wall
+    EXPECT_TRUE ( culler.isVisible( boxAt( 30.0f, 0.0f, -20.0f, 1.0f ) ) );   // Next to a wall
+}
+
+TEST(OcclusionCuller, LoadedMeshWithoutChunkRangesOccludes)
+{
+    // A mesh is set up the same way a raw mesh loader does, chunk index ranges are left empty
+    Scene::Mesh::VertexBuffer vertices( 4 );
+    vertices[0].position = Vec3( -5.0f, -5.0f, -10.0f );
+    vertices[1].position = Vec3(  5.0f, -5.0f, -10.0f );
+    vertices[2].position = Vec3(  5.0f,  5.0f, -10.0f );
+    vertices[3].position = Vec3( -5.0f,  5.0f, -10.0f );
+
+    Scene::Mesh::IndexBuffer indices;
+    const u16 faces[] = { 0, 1, 2, 0, 2, 3 };
+    indices.insert( indices.end(), faces, faces + 6 );
+
+    Scene::Mesh mesh;
+    mesh.setChunkCount( 1 );
+    mesh.setVertexBuffer( vertices );
+    mesh.setIndexBuffer( indices );
+    mesh.updateBounds();
+    ASSERT_EQ( 0, mesh.chunkIndexCount( 0 ) );
+
+    Scene::OcclusionCuller culler;
+    culler.begin( occlusionViewProjection() );
+    culler.addOccluder( mesh, Matrix4::translation( 0.0f, 0.0f, 0.0f ) );
+    culler.rasterize();
+
+    EXPECT_EQ( 2, culler.triangleCount() );
+    EXPECT_FALSE( culler.isVisible( boxAt( 0.0f, 0.0f, -20.0f, 1.0f ) ) );
+    EXPECT_TRUE ( culler.isVisible( boxAt( 0.0f, 0.0f, -5.0f, 1.0f ) ) );
+}
+
+TEST(OcclusionCuller, PyramidStoresFarthestDepth)
+{
+    Scene::OcclusionCuller culler;
+
+    // A wall covers the left half of a screen
+    rasterizeWall( culler, -10.0f, 10.0f, Matrix4::translation( -10.0f, 0.0f, 0.0f ) );
+
+    f32 wallDepth = culler.depthAt( 0, 64, 64 );
+    EXPECT_LT( wallDepth, 1.0f );
+    EXPECT_FLOAT_EQ( 1.0f, culler.depthAt( 0, 192, 64 ) );
+
+    // Texels that are completely covered by a wall keep its depth, texels crossing a wall border are far
+    EXPECT_NEAR( wallDepth, culler.depthAt( 3, 4, 8 ), 1e-4f );
+    EXPECT_FLOAT_EQ( 1.0f, culler.depthAt( 3, 24, 8 ) );
+    EXPECT_FLOAT_EQ( 1.0f, culler.depthAt( culler.levelCount() - 1, 0, 0 ) );
+}
+
+TEST(OcclusionCuller, OccluderCrossingNearPlaneIsClipped)
+{
+    Scene::OcclusionCuller culler;
+    culler.begin( occlusionViewProjection() );
+
+    // A floor that starts behind a camera and goes far away
+    culler.addOccluder( Bounds( Vec3( -50.0f, -2.0f, -50.0f ), Vec3( 50.0f, -1.0f, 50.0f ) ) );
+    culler.rasterize();
+
+    EXPECT_GT( culler.triangleCount(), 0 );
+    EXPECT_FALSE( culler.isVisible( boxAt( 0.0f, -5.0f, -10.0f, 1.0f ) ) );   // Under a floor
+    EXPECT_TRUE ( culler.isVisible( boxAt( 0.0f,  1.0f, -10.0f, 1.0f ) ) );   // Above a floor
+}
+
+TEST(OcclusionCuller, ParallelCullingMatchesSerial)
+{
+    Array<Bounds> boxes;
+
+    for( s32 x = -20; x <= 20; x++ ) {
+        for( s32 z = 1; z <= 60; z++ ) {
+            boxes.push_back( boxAt( x * 2.0f, (x % 3) * 1.5f, -z * 1.5f, 0.5f ) );
+        }
+    }
+
+    Scene::OcclusionCuller serial;
+    Scene::OcclusionCuller parallel;
+
+    Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+    parallel.setTaskManager( taskManager );
+
+    rasterizeWall( serial, -15.0f, 8.0f );
+    rasterizeWall( parallel, -15.0f, 8.0f );
+
+    for( s32 level = 0; level < serial.levelCount(); level++ ) {
+        for( s32 y = 0; y < (serial.height() >> level); y++ ) {
+            for( s32 x = 0; x < (serial.width() >> level); x++ ) {
+                ASSERT_EQ( serial.depthAt( level, x, y ), parallel.depthAt( level, x, y ) );
+            }
+        }
+    }
+
+    Array<s32> a, b;
+    serial.cull( &boxes[0], static_cast<s32>( boxes.size() ), a );
+    parallel.cull( &boxes[0], static_cast<s32>( boxes.size() ), b );
+
+    EXPECT_GT( a.size(), 0u );
+    EXPECT_LT( a.size(), boxes.size() );
+    EXPECT_EQ( a, b );
+}
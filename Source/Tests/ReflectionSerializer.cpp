@@ -0,0 +1,163 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! A reflected type with a few plain data properties.
+class SerializedBody {
+
+    INTROSPECTION( SerializedBody
+        , PROPERTY( name, name, setName, "The body name." )
+        , PROPERTY( position, position, setPosition, "The body position." )
+        , PROPERTY( mass, mass, setMass, "The body mass." )
+        )
+
+public:
+
+                            SerializedBody( void )
+                                : m_mass( 0.0f ) {}
+
+    const String&           name( void ) const { return m_name; }
+    void                    setName( const String& value ) { m_name = value; }
+    const Vec3&             position( void ) const { return m_position; }
+    void                    setPosition( const Vec3& value ) { m_position = value; }
+    f32                     mass( void ) const { return m_mass; }
+    void                    setMass( f32 value ) { m_mass = value; }
+
+private:
+
+    String                  m_name;
+    Vec3                    m_position;
+    f32                     m_mass;
+};
+
+//! Returns a default mass for serialized bodies.
+static Variant defaultMass( const KeyValue& ar )
+{
+    return Variant::fromValue( 5.0f );
+}
+
+TEST(ReflectionSerializer, KeyValueRoundTrip)
+{
+    SerializedBody source;
+    source.setName( "body" );
+    source.setPosition( Vec3( 1.0f, 2.0f, 3.0f ) );
+    source.setMass( 10.0f );
+
+    Reflection::Serializer serializer;
+    KeyValue               ar;
+    EXPECT_TRUE( serializer.serialize( source.metaInstance(), ar ) );
+
+    SerializedBody target;
+    serializer.deserialize( target.metaInstance(), ar );
+
+    EXPECT_EQ( "body", target.name() );
+    EXPECT_EQ( source.position(), target.position() );
+    EXPECT_EQ( 10.0f, target.mass() );
+}
+
+TEST(ReflectionSerializer, BinaryRoundTrip)
+{
+    Reflection::Serializer serializer;
+    Io::ByteBufferPtr      stream = Io::ByteBuffer::create();
+    Array<SerializedBody>  source( 3 );
+
+    for( s32 i = 0; i < 3; i++ ) {
+        source[i].setName( i ? "body" : "" );
+        source[i].setPosition( Vec3( static_cast<f32>( i ), 2.0f, 3.0f ) );
+        source[i].setMass( i * 10.0f );
+        EXPECT_TRUE( serializer.serialize( source[i].metaInstance(), stream.get() ) );
+    }
+
+    stream->setPosition( 0 );
+
+    for( s32 i = 0; i < 3; i++ ) {
+        SerializedBody target;
+        serializer.deserialize( target.metaInstance(), stream.get() );
+
+        EXPECT_EQ( source[i].name(), target.name() );
+        EXPECT_EQ( source[i].position(), target.position() );
+        EXPECT_EQ( source[i].mass(), target.mass() );
+    }
+
+    EXPECT_FALSE( stream->hasDataLeft() );
+}
+
+TEST(ReflectionSerializer, AppliesDefaultsRegisteredAfterFirstUse)
+{
+    Reflection::Serializer serializer;
+    SerializedBody         body;
+    KeyValue               empty;
+
+    // Build a plan before a default value is registered
+    serializer.deserialize( body.metaInstance(), empty );
+    EXPECT_EQ( 0.0f, body.mass() );
+
+    serializer.registerPropertyDefault<SerializedBody>( "mass", dcStaticFunction( defaultMass ) );
+    serializer.deserialize( body.metaInstance(), empty );
+    EXPECT_EQ( 5.0f, body.mass() );
+}
+
+//! Serializes and deserializes bodies with a shared serializer passed as user data.
+static void roundTripBodies( Threads::TaskProgressWPtr progress, void* userData )
+{
+    const Reflection::Serializer& serializer = *reinterpret_cast<const Reflection::Serializer*>( userData );
+
+    for( s32 i = 0; i < 500; i++ ) {
+        SerializedBody source;
+        source.setPosition( Vec3( static_cast<f32>( i ), 0.0f, 0.0f ) );
+        source.setMass( static_cast<f32>( i ) );
+
+        KeyValue ar;
+        serializer.serialize( source.metaInstance(), ar );
+
+        SerializedBody target;
+        serializer.deserialize( target.metaInstance(), ar );
+
+        if( target.mass() != source.mass() || !(target.position() == source.position()) ) {
+            progress->setStatus( "mismatch" );
+        }
+    }
+}
+
+TEST(ReflectionSerializer, IsSharedBetweenThreads)
+{
+    Reflection::Serializer           serializer;
+    Threads::TaskManagerPtr          taskManager = Threads::TaskManager::create();
+    Array<Threads::TaskProgressPtr>  progress;
+
+    // A plan is requested by all threads at once
+    for( s32 i = 0; i < 3; i++ ) {
+        progress.push_back( taskManager->runBackgroundTask( dcStaticFunction( roundTripBodies ), &serializer ) );
+    }
+
+    for( size_t i = 0; i < progress.size(); i++ ) {
+        progress[i]->waitForCompletion();
+        EXPECT_TRUE( progress[i]->status().empty() );
+    }
+}
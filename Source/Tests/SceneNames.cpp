@@ -0,0 +1,100 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Creates a named scene object and adds it to a scene.
+static Scene::SceneObjectPtr addNamedObject( Scene::ScenePtr scene, const String& name )
+{
+    Scene::SceneObjectPtr sceneObject = scene->createSceneObject();
+    sceneObject->attach<Scene::Identifier>( name );
+    scene->addSceneObject( sceneObject );
+    return sceneObject;
+}
+
+TEST(SceneNames, InternsNames)
+{
+    Ecs::NameId id = Ecs::NameTable::intern( "interned" );
+
+    EXPECT_NE( 0u, id );
+    EXPECT_EQ( id, Ecs::NameTable::intern( "interned" ) );
+    EXPECT_EQ( id, Ecs::NameTable::find( "interned" ) );
+    EXPECT_EQ( "interned", Ecs::NameTable::str( id ) );
+    EXPECT_EQ( 0u, Ecs::NameTable::intern( "" ) );
+    EXPECT_EQ( 0u, Ecs::NameTable::find( "never interned" ) );
+}
+
+TEST(SceneNames, FindsObjectsByName)
+{
+    Scene::ScenePtr       scene  = Scene::Scene::create();
+    Scene::SceneObjectPtr first  = addNamedObject( scene, "enemy" );
+    Scene::SceneObjectPtr second = addNamedObject( scene, "enemy" );
+    addNamedObject( scene, "player" );
+
+    Scene::SceneObjectSet enemies = scene->findAllWithName( "enemy" );
+    EXPECT_EQ( 2u, enemies.size() );
+    EXPECT_EQ( 1u, enemies.count( first ) );
+    EXPECT_EQ( 1u, enemies.count( second ) );
+    EXPECT_EQ( 2u, scene->findAllWithName( first->get<Scene::Identifier>()->nameId() ).size() );
+    EXPECT_TRUE( scene->findAllWithName( "missing" ).empty() );
+}
+
+TEST(SceneNames, TracksRenamesAndRemovals)
+{
+    Scene::ScenePtr       scene  = Scene::Scene::create();
+    Scene::SceneObjectPtr object = addNamedObject( scene, "crate" );
+
+    object->get<Scene::Identifier>()->setName( "barrel" );
+    EXPECT_TRUE( scene->findAllWithName( "crate" ).empty() );
+    EXPECT_EQ( 1u, scene->findAllWithName( "barrel" ).size() );
+
+    object->detach<Scene::Identifier>();
+    EXPECT_TRUE( scene->findAllWithName( "barrel" ).empty() );
+
+    object->attach<Scene::Identifier>( "barrel" );
+    EXPECT_EQ( 1u, scene->findAllWithName( "barrel" ).size() );
+
+    scene->removeSceneObject( object );
+    EXPECT_TRUE( scene->findAllWithName( "barrel" ).empty() );
+}
+
+TEST(SceneNames, DeepCopyKeepsSourceName)
+{
+    Scene::ScenePtr       scene  = Scene::Scene::create();
+    Scene::SceneObjectPtr source = addNamedObject( scene, "prototype" );
+    Scene::SceneObjectPtr copy   = source->deepCopy();
+
+    EXPECT_EQ( "prototype", source->get<Scene::Identifier>()->name() );
+    EXPECT_EQ( 1u, scene->findAllWithName( "prototype" ).count( source ) );
+    ASSERT_TRUE( copy->has<Scene::Identifier>() != NULL );
+    EXPECT_EQ( "prototype", copy->get<Scene::Identifier>()->name() );
+
+    scene->addSceneObject( copy );
+    EXPECT_EQ( 2u, scene->findAllWithName( "prototype" ).size() );
+}
@@ -0,0 +1,196 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+#include <atomic>
+
+DC_USE_DREEMCHEST
+
+using namespace Sound;
+
+//! Opens the same in-memory WAV file for any URI and counts opened streams.
+class CountingStreamOpener : public IStreamOpener {
+public:
+
+                            CountingStreamOpener( u32 frames )
+                                : m_opened( 0 )
+    {
+        u32 dataSize    = frames * 2;
+        u32 fileSize    = dataSize + 36;
+        u32 formatSize  = 16;
+        u16 formatTag   = 1;
+        u16 channels    = 1;
+        u32 rate        = 44100;
+        u32 byteRate    = rate * 2;
+        u16 blockAlign  = 2;
+        u16 bits        = 16;
+
+        m_wav = Io::ByteBuffer::create();
+        m_wav->write( "RIFF", 4 );
+        m_wav->write( &fileSize, 4 );
+        m_wav->write( "WAVE", 4 );
+        m_wav->write( "fmt ", 4 );
+        m_wav->write( &formatSize, 4 );
+        m_wav->write( &formatTag, 2 );
+        m_wav->write( &channels, 2 );
+        m_wav->write( &rate, 4 );
+        m_wav->write( &byteRate, 4 );
+        m_wav->write( &blockAlign, 2 );
+        m_wav->write( &bits, 2 );
+        m_wav->write( "data", 4 );
+        m_wav->write( &dataSize, 4 );
+
+        for( u32 i = 0; i < frames; i++ ) {
+            s16 value = 8192;
+            m_wav->write( &value, 2 );
+        }
+    }
+
+    virtual ISoundStreamPtr open( CString uri )
+    {
+        m_opened++;
+
+        Io::ByteBufferPtr wav = m_wav->copy();
+        wav->setPosition( 0 );
+
+        return DC_NEW MemorySoundStream( wav );
+    }
+
+    //! Returns the number of opened streams.
+    u32                     opened( void ) const { return m_opened; }
+
+private:
+
+    Io::ByteBufferPtr       m_wav;
+    std::atomic<u32>        m_opened;
+};
+
+//! Sound identifiers used by tests.
+static CString s_sounds[] = { "sound0", "sound1", "sound2", "sound3" };
+
+//! Creates a sound fx with a software HAL and a given number of decoded sounds.
+static SoundFxPtr createSoundFx( CountingStreamOpener* opener, u32 count )
+{
+    SoundFxPtr sfx = SoundFx::create( SoundFx::Software, opener );
+
+    SoundGroupWPtr group = sfx->createGroup( "group" );
+    group->setSlotCount( 100 );
+
+    for( u32 i = 0; i < count; i++ ) {
+        SoundDataWPtr sound = sfx->createSound( s_sounds[i], ( String( s_sounds[i] ) + ".wav" ).c_str(), group );
+        sound->setFormat( SoundFormatWav );
+        sound->setLoading( SoundData::Decode );
+    }
+
+    return sfx;
+}
+
+TEST(SoundCache, DecodesSoundOnce)
+{
+    CountingStreamOpener* opener = DC_NEW CountingStreamOpener( 4410 );
+    SoundFxPtr            sfx    = createSoundFx( opener, 1 );
+
+    for( s32 i = 0; i < 16; i++ ) {
+        EXPECT_TRUE( sfx->play( "sound0" ).valid() );
+        sfx->update( 0.01f );
+    }
+
+    EXPECT_EQ( 1, opener->opened() );
+    EXPECT_EQ( 1, sfx->cache()->entryCount() );
+}
+
+TEST(SoundCache, ReleasesLeastRecentlyUsed)
+{
+    CountingStreamOpener* opener = DC_NEW CountingStreamOpener( 4410 );
+    SoundFxPtr            sfx    = createSoundFx( opener, 3 );
+    SoundCacheWPtr        cache  = sfx->cache();
+
+    sfx->play( "sound0" )->stop( 0.0f );
+    sfx->play( "sound1" )->stop( 0.0f );
+    sfx->update( 0.01f );
+
+    u64 size = cache->size();
+    EXPECT_EQ( 2, cache->entryCount() );
+
+    // A budget fits two sounds, so a least recently used one is released
+    cache->setBudget( size );
+    sfx->play( "sound0" )->stop( 0.0f );
+    sfx->play( "sound2" )->stop( 0.0f );
+    sfx->update( 0.01f );
+
+    EXPECT_EQ( 2, cache->entryCount() );
+    EXPECT_TRUE( cache->contains( sfx->findSoundByName( "sound0" ) ) );
+    EXPECT_FALSE( cache->contains( sfx->findSoundByName( "sound1" ) ) );
+    EXPECT_TRUE( cache->contains( sfx->findSoundByName( "sound2" ) ) );
+    EXPECT_LE( cache->size(), cache->budget() );
+}
+
+TEST(SoundCache, KeepsBuffersInUse)
+{
+    CountingStreamOpener* opener = DC_NEW CountingStreamOpener( 4410 );
+    SoundFxPtr            sfx    = createSoundFx( opener, 2 );
+    SoundCacheWPtr        cache  = sfx->cache();
+
+    SoundChannelPtr first  = sfx->play( "sound0" );
+    SoundChannelPtr second = sfx->play( "sound1" );
+
+    // Both buffers are attached to sources, so none of them is released
+    cache->setBudget( 0 );
+    EXPECT_EQ( 2, cache->entryCount() );
+
+    first->stop( 0.0f );
+    first = SoundChannelPtr();
+    sfx->update( 0.01f );
+
+    EXPECT_EQ( 1, cache->entryCount() );
+    EXPECT_TRUE( cache->contains( sfx->findSoundByName( "sound1" ) ) );
+}
+
+TEST(SoundCache, PreloadsGroupInBackground)
+{
+    CountingStreamOpener* opener = DC_NEW CountingStreamOpener( 4410 );
+    SoundFxPtr            sfx    = createSoundFx( opener, 4 );
+    SoundCacheWPtr        cache  = sfx->cache();
+
+    sfx->preload( sfx->findGroupByName( "group" ) );
+
+    for( s32 i = 0; i < 1000 && cache->pendingCount(); i++ ) {
+        Threads::Thread::sleep( 1 );
+        sfx->update( 0.0f );
+    }
+
+    EXPECT_EQ( 0, cache->pendingCount() );
+    EXPECT_EQ( 4, cache->entryCount() );
+    EXPECT_EQ( 4, opener->opened() );
+
+    // Playing preloaded sounds does not touch a decoder
+    for( u32 i = 0; i < 4; i++ ) {
+        EXPECT_TRUE( sfx->play( s_sounds[i] ).valid() );
+    }
+
+    EXPECT_EQ( 4, opener->opened() );
+}
@@ -0,0 +1,187 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+using namespace Sound;
+
+//! Opens the same in-memory WAV file for any URI.
+class MemoryStreamOpener : public IStreamOpener {
+public:
+
+                            MemoryStreamOpener( void )
+    {
+        u32 frames      = 44100;
+        u32 dataSize    = frames * 2;
+        u32 fileSize    = dataSize + 36;
+        u32 formatSize  = 16;
+        u16 formatTag   = 1;
+        u16 channels    = 1;
+        u32 rate        = 44100;
+        u32 byteRate    = rate * 2;
+        u16 blockAlign  = 2;
+        u16 bits        = 16;
+
+        m_wav = Io::ByteBuffer::create();
+        m_wav->write( "RIFF", 4 );
+        m_wav->write( &fileSize, 4 );
+        m_wav->write( "WAVE", 4 );
+        m_wav->write( "fmt ", 4 );
+        m_wav->write( &formatSize, 4 );
+        m_wav->write( &formatTag, 2 );
+        m_wav->write( &channels, 2 );
+        m_wav->write( &rate, 4 );
+        m_wav->write( &byteRate, 4 );
+        m_wav->write( &blockAlign, 2 );
+        m_wav->write( &bits, 2 );
+        m_wav->write( "data", 4 );
+        m_wav->write( &dataSize, 4 );
+
+        for( u32 i = 0; i < frames; i++ ) {
+            s16 value = 8192;
+            m_wav->write( &value, 2 );
+        }
+    }
+
+    virtual ISoundStreamPtr open( CString uri )
+    {
+        Io::ByteBufferPtr wav = m_wav->copy();
+        wav->setPosition( 0 );
+        return DC_NEW MemorySoundStream( wav );
+    }
+
+private:
+
+    Io::ByteBufferPtr       m_wav;
+};
+
+//! Creates a sound fx with a software HAL and a single looped positional sound.
+static SoundFxPtr createSoundFx( u32 maxVoices )
+{
+    SoundFxPtr sfx = SoundFx::create( SoundFx::Software, DC_NEW MemoryStreamOpener );
+    sfx->setMaxVoices( maxVoices );
+
+    SoundGroupWPtr group = sfx->createGroup( "group" );
+    group->setSlotCount( 100 );
+
+    SoundDataWPtr sound = sfx->createSound( "sound", "sound.wav", group );
+    sound->setFormat( SoundFormatWav );
+    sound->setLooped( true );
+    sound->setLoading( SoundData::Decode );
+
+    return sfx;
+}
+
+TEST(SoundFx, VirtualizesQuietestChannels)
+{
+    SoundFxPtr sfx = createSoundFx( 2 );
+
+    Array<SoundChannelPtr> channels;
+
+    for( s32 i = 0; i < 4; i++ ) {
+        SoundChannelPtr channel = sfx->play( "sound" );
+        ASSERT_TRUE( channel.valid() );
+        channel->setPosition( Vec3( 10.0f - i * 3.0f, 0.0f, 0.0f ) );
+        channels.push_back( channel );
+    }
+
+    sfx->update( 0.1f );
+
+    // Only two nearest channels have hardware voices
+    EXPECT_EQ( 2, sfx->voiceCount() );
+    EXPECT_EQ( 2, sfx->virtualChannelCount() );
+    EXPECT_TRUE( channels[0]->isVirtual() );
+    EXPECT_TRUE( channels[1]->isVirtual() );
+    EXPECT_FALSE( channels[2]->isVirtual() );
+    EXPECT_FALSE( channels[3]->isVirtual() );
+
+    // Virtual channels keep playing
+    EXPECT_TRUE( channels[0]->isPlaying() );
+    EXPECT_NEAR( channels[3]->time(), channels[0]->time(), 0.0001f );
+}
+
+TEST(SoundFx, PromotesChannelsThatBecomeAudible)
+{
+    SoundFxPtr sfx = createSoundFx( 1 );
+
+    SoundChannelPtr closest = sfx->play( "sound" );
+    SoundChannelPtr distant = sfx->play( "sound" );
+    closest->setPosition( Vec3( 1.0f, 0.0f, 0.0f ) );
+    distant->setPosition( Vec3( 50.0f, 0.0f, 0.0f ) );
+
+    sfx->update( 0.1f );
+    EXPECT_FALSE( closest->isVirtual() );
+    EXPECT_TRUE( distant->isVirtual() );
+
+    // Move the listener to a distant channel
+    sfx->setListenerPosition( Vec3( 50.0f, 0.0f, 0.0f ) );
+    sfx->update( 0.1f );
+
+    EXPECT_TRUE( closest->isVirtual() );
+    EXPECT_FALSE( distant->isVirtual() );
+    EXPECT_EQ( 1, sfx->voiceCount() );
+    EXPECT_NEAR( 0.2f, distant->time(), 0.0001f );
+}
+
+TEST(SoundFx, PriorityWinsOverDistance)
+{
+    SoundFxPtr sfx = createSoundFx( 1 );
+
+    SoundDataWPtr important = sfx->createSound( "important", "important.wav", sfx->findGroupByName( "group" ) );
+    important->setFormat( SoundFormatWav );
+    important->setLooped( true );
+    important->setPriority( 10 );
+
+    SoundChannelPtr ambient = sfx->play( "sound" );
+    SoundChannelPtr alarm   = sfx->play( "important" );
+    ambient->setPosition( Vec3( 1.0f, 0.0f, 0.0f ) );
+    alarm->setPosition( Vec3( 4.0f, 0.0f, 0.0f ) );
+
+    sfx->update( 0.1f );
+
+    EXPECT_TRUE( ambient->isVirtual() );
+    EXPECT_FALSE( alarm->isVirtual() );
+}
+
+TEST(SoundFx, VirtualChannelStopsAtTheEnd)
+{
+    SoundFxPtr sfx = createSoundFx( 1 );
+    sfx->findSoundByName( "sound" )->setLooped( false );
+
+    SoundChannelPtr first  = sfx->play( "sound" );
+    SoundChannelPtr second = sfx->play( "sound" );
+    second->setPosition( Vec3( 100.0f, 0.0f, 0.0f ) );
+
+    sfx->update( 0.5f );
+    EXPECT_TRUE( second->isVirtual() );
+    EXPECT_FALSE( second->isStopped() );
+
+    // The test sound is one second long
+    sfx->update( 0.6f );
+    EXPECT_TRUE( second->isStopped() );
+}
@@ -0,0 +1,225 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+#include <Sound/Drivers/Mixer/Mixer.h>
+#include <Sound/Drivers/SoundSource.h>
+#include <Sound/Decoders/SoundDecoder.h>
+
+DC_USE_DREEMCHEST
+
+using namespace Sound;
+
+//! The sample rate of test sounds.
+static const u32 kRate = 44100;
+
+//! The number of frames in a test sound.
+static const u32 kFrameCount = 10000;
+
+//! Writes a mono 16-bit WAV file with samples produced by a function of a frame index.
+static Io::ByteBufferPtr createWav( s16 (*sample)( u32 ), u32 frames )
+{
+    Io::ByteBufferPtr wav = Io::ByteBuffer::create();
+
+    u32 dataSize    = frames * 2;
+    u32 fileSize    = dataSize + 36;
+    u32 formatSize  = 16;
+    u16 formatTag   = 1;
+    u16 channels    = 1;
+    u32 rate        = kRate;
+    u32 byteRate    = kRate * 2;
+    u16 blockAlign  = 2;
+    u16 bits        = 16;
+
+    wav->write( "RIFF", 4 );
+    wav->write( &fileSize, 4 );
+    wav->write( "WAVE", 4 );
+    wav->write( "fmt ", 4 );
+    wav->write( &formatSize, 4 );
+    wav->write( &formatTag, 2 );
+    wav->write( &channels, 2 );
+    wav->write( &rate, 4 );
+    wav->write( &byteRate, 4 );
+    wav->write( &blockAlign, 2 );
+    wav->write( &bits, 2 );
+    wav->write( "data", 4 );
+    wav->write( &dataSize, 4 );
+
+    for( u32 i = 0; i < frames; i++ ) {
+        s16 value = sample( i );
+        wav->write( &value, 2 );
+    }
+
+    wav->setPosition( 0 );
+    return wav;
+}
+
+//! Returns a constant sample equal to a half of the full scale.
+static s16 halfScale( u32 frame )
+{
+    return 16384;
+}
+
+//! Returns a sawtooth sample that increases linearly over 2000 frames.
+static s16 ramp( u32 frame )
+{
+    return static_cast<s16>( ( frame % 2000 ) * 16 );
+}
+
+//! Creates a playing source with a test sound attached.
+static SoundSourcePtr createSource( MixerPtr mixer, s16 (*sample)( u32 ), u32 chunks = 1 )
+{
+    SoundDecoderPtr decoder = mixer->createSoundDecoder( DC_NEW MemorySoundStream( createWav( sample, kFrameCount ) ), SoundFormatWav );
+    SoundSourcePtr  source  = mixer->createSource();
+
+    source->setBuffer( mixer->createBuffer( decoder, chunks ) );
+    source->setRelative( true );
+    source->setState( SoundSource::Playing );
+
+    return source;
+}
+
+TEST(SoundMixer, MixesConstantSignal)
+{
+    MixerPtr       mixer  = DC_NEW Mixer;
+    SoundSourcePtr source = createSource( mixer, halfScale );
+
+    Array<f32> output( 600 * 2 );
+    mixer->render( &output[0], 600 );
+
+    for( u32 i = 0; i < output.size(); i++ ) {
+        EXPECT_FLOAT_EQ( 0.5f, output[i] );
+    }
+}
+
+TEST(SoundMixer, StopsAtTheEndOfSound)
+{
+    MixerPtr       mixer  = DC_NEW Mixer;
+    SoundSourcePtr source = createSource( mixer, halfScale );
+
+    Array<f32> output( ( kFrameCount + 100 ) * 2 );
+    mixer->render( &output[0], kFrameCount + 100 );
+
+    EXPECT_FLOAT_EQ( 0.5f, output[( kFrameCount - 1 ) * 2] );
+    EXPECT_FLOAT_EQ( 0.0f, output[kFrameCount * 2] );
+    EXPECT_EQ( SoundSource::Stopped, source->state() );
+}
+
+TEST(SoundMixer, LoopedSourceWraps)
+{
+    MixerPtr       mixer  = DC_NEW Mixer;
+    SoundSourcePtr source = createSource( mixer, ramp );
+    source->setLooped( true );
+
+    Array<f32> output( ( kFrameCount + 10 ) * 2 );
+    mixer->render( &output[0], kFrameCount + 10 );
+
+    EXPECT_FLOAT_EQ( ramp( 5 ) / 32768.0f, output[( kFrameCount + 5 ) * 2] );
+    EXPECT_EQ( SoundSource::Playing, source->state() );
+}
+
+TEST(SoundMixer, StreamedSourceMatchesStatic)
+{
+    MixerPtr       mixer    = DC_NEW Mixer;
+    SoundSourcePtr source   = createSource( mixer, ramp, 3 );
+
+    Array<f32> output( kFrameCount * 2 );
+    mixer->render( &output[0], kFrameCount );
+
+    for( u32 i = 0; i < kFrameCount; i++ ) {
+        EXPECT_FLOAT_EQ( ramp( i ) / 32768.0f, output[i * 2 + 1] );
+    }
+}
+
+TEST(SoundMixer, PitchResamplesSignal)
+{
+    MixerPtr       mixer = DC_NEW Mixer;
+    SoundSourcePtr fast  = createSource( mixer, ramp );
+    fast->setPitch( 2.0f );
+
+    Array<f32> output( 100 * 2 );
+    mixer->render( &output[0], 100 );
+
+    for( u32 i = 0; i < 100; i++ ) {
+        EXPECT_FLOAT_EQ( ramp( i * 2 ) / 32768.0f, output[i * 2] );
+    }
+
+    fast->setState( SoundSource::Stopped );
+
+    SoundSourcePtr slow = createSource( mixer, ramp );
+    slow->setPitch( 0.5f );
+    mixer->render( &output[0], 100 );
+
+    for( u32 i = 0; i < 100; i++ ) {
+        EXPECT_FLOAT_EQ( i * 8 / 32768.0f, output[i * 2] );
+    }
+}
+
+TEST(SoundMixer, InverseDistanceAttenuation)
+{
+    MixerPtr       mixer  = DC_NEW Mixer;
+    SoundSourcePtr source = createSource( mixer, halfScale );
+    source->setRelative( false );
+    source->setPosition( Vec3( 2.0f, 0.0f, 0.0f ) );
+
+    Array<f32> output( 64 * 2 );
+    mixer->render( &output[0], 64 );
+    EXPECT_FLOAT_EQ( 0.25f, output[0] );
+
+    // Moving a listener to a source restores the full volume
+    mixer->setPosition( Vec3( 2.0f, 0.0f, 0.0f ) );
+    mixer->render( &output[0], 64 );
+    EXPECT_FLOAT_EQ( 0.5f, output[0] );
+
+    // Disabled attenuation ignores the distance
+    mixer->setPosition( Vec3( 100.0f, 0.0f, 0.0f ) );
+    mixer->setDistanceModel( NoDistanceAttenutation );
+    mixer->render( &output[0], 64 );
+    EXPECT_FLOAT_EQ( 0.5f, output[0] );
+}
+
+TEST(SoundMixer, RendersToWav)
+{
+    MixerPtr          mixer  = DC_NEW Mixer;
+    SoundSourcePtr    source = createSource( mixer, halfScale );
+    Io::ByteBufferPtr wav    = Io::ByteBuffer::create();
+
+    EXPECT_TRUE( mixer->renderToWav( wav.get(), 800 ) );
+    EXPECT_EQ( 44 + 800 * 4, wav->length() );
+
+    // The rendered file should be readable by a WAV decoder
+    wav->setPosition( 0 );
+    SoundDecoderPtr decoder = mixer->createSoundDecoder( DC_NEW MemorySoundStream( wav ), SoundFormatWav );
+    ASSERT_TRUE( decoder.valid() );
+    EXPECT_EQ( SoundSampleStereo16, decoder->format() );
+    EXPECT_EQ( 800 * 4, decoder->size() );
+
+    s16 samples[2];
+    decoder->read( reinterpret_cast<u8*>( samples ), sizeof( samples ) );
+    EXPECT_EQ( 16383, samples[0] );
+    EXPECT_EQ( 16383, samples[1] );
+}
@@ -0,0 +1,242 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+#include "UnitTests.h"
+
+#include <Sound/Drivers/SoundEngine.h>
+#include <Sound/Drivers/SoundStreamer.h>
+
+DC_USE_DREEMCHEST
+
+using namespace Sound;
+
+//! The number of PCM bytes in a test sound.
+static const u32 kPcmSize = 10000;
+
+//! The size of a decoded chunk.
+static const u32 kChunkSize = 1024;
+
+//! Returns a PCM byte at specified offset of a test sound.
+static u8 pcmByte( u32 offset )
+{
+    return static_cast<u8>( offset * 7 + offset / 256 );
+}
+
+//! Creates a decoder for a mono 8-bit WAV file with a test sound of a specified size.
+static SoundDecoderPtr createDecoder( SoundEngine& engine, u32 pcmSize = kPcmSize )
+{
+    Io::ByteBufferPtr wav = Io::ByteBuffer::create();
+
+    u32 fileSize    = pcmSize + 36;
+    u32 formatSize  = 16;
+    u16 formatTag   = 1;
+    u16 channels    = 1;
+    u32 rate        = 22050;
+    u16 blockAlign  = 1;
+    u16 bits        = 8;
+
+    wav->write( "RIFF", 4 );
+    wav->write( &fileSize, 4 );
+    wav->write( "WAVE", 4 );
+    wav->write( "fmt ", 4 );
+    wav->write( &formatSize, 4 );
+    wav->write( &formatTag, 2 );
+    wav->write( &channels, 2 );
+    wav->write( &rate, 4 );
+    wav->write( &rate, 4 );
+    wav->write( &blockAlign, 2 );
+    wav->write( &bits, 2 );
+    wav->write( "data", 4 );
+    wav->write( &pcmSize, 4 );
+
+    for( u32 i = 0; i < pcmSize; i++ ) {
+        u8 value = pcmByte( i );
+        wav->write( &value, 1 );
+    }
+
+    wav->setPosition( 0 );
+    return engine.createSoundDecoder( DC_NEW MemorySoundStream( wav ), SoundFormatWav );
+}
+
+//! Waits for a next decoded chunk.
+static const PcmRingBuffer::Chunk* waitForChunk( DecodedStream* stream )
+{
+    for( s32 i = 0; i < 1000; i++ ) {
+        if( const PcmRingBuffer::Chunk* chunk = stream->read() ) {
+            return chunk;
+        }
+        Threads::Thread::sleep( 1 );
+    }
+
+    return NULL;
+}
+
+TEST(PcmRingBuffer, WrapsAround)
+{
+    PcmRingBuffer ring( 4, 16 );
+
+    for( u32 i = 0; i < 10; i++ ) {
+        PcmRingBuffer::Chunk* chunk = ring.beginWrite();
+        ASSERT_TRUE( chunk != NULL );
+        chunk->size = i + 1;
+        ring.endWrite();
+
+        const PcmRingBuffer::Chunk* read = ring.beginRead();
+        ASSERT_TRUE( read != NULL );
+        EXPECT_EQ( i + 1, read->size );
+        ring.endRead();
+    }
+
+    EXPECT_EQ( 0, ring.size() );
+    EXPECT_TRUE( ring.beginRead() == NULL );
+}
+
+TEST(PcmRingBuffer, RejectsWritesWhenFull)
+{
+    PcmRingBuffer ring( 4, 16 );
+
+    for( u32 i = 0; i < 4; i++ ) {
+        ASSERT_TRUE( ring.beginWrite() != NULL );
+        ring.endWrite();
+    }
+
+    EXPECT_EQ( 4, ring.size() );
+    EXPECT_TRUE( ring.beginWrite() == NULL );
+
+    ring.beginRead();
+    ring.endRead();
+    EXPECT_TRUE( ring.beginWrite() != NULL );
+}
+
+TEST(SoundStreamer, DecodesAheadOnWorkerThread)
+{
+    SoundEngine      engine;
+    SoundStreamerPtr streamer = DC_NEW SoundStreamer;
+    streamer->start();
+
+    DecodedStream* stream = streamer->open( createDecoder( engine ), kChunkSize );
+
+    // Read the whole sound until an end of stream marker
+    u32 offset = 0;
+
+    while( const PcmRingBuffer::Chunk* chunk = waitForChunk( stream ) ) {
+        u32 size = chunk->size;
+
+        for( u32 i = 0; i < size; i++ ) {
+            ASSERT_EQ( pcmByte( offset + i ), chunk->data[i] );
+        }
+
+        stream->consume();
+        offset += size;
+
+        if( size == 0 ) {
+            break;
+        }
+    }
+
+    EXPECT_EQ( kPcmSize, offset );
+
+    // The stream is rewound after the end marker, so a looped playback continues from the beginning
+    const PcmRingBuffer::Chunk* chunk = waitForChunk( stream );
+    ASSERT_TRUE( chunk != NULL );
+    EXPECT_EQ( pcmByte( 0 ), chunk->data[0] );
+    EXPECT_EQ( pcmByte( 1 ), chunk->data[1] );
+
+    streamer->close( stream );
+    streamer->stop();
+}
+
+TEST(SoundStreamer, NonLoopedStreamStopsAfterEndMarker)
+{
+    SoundEngine      engine;
+    SoundStreamerPtr streamer = DC_NEW SoundStreamer;
+    streamer->start();
+
+    DecodedStream* stream = streamer->open( createDecoder( engine ), kChunkSize, false );
+
+    // Read the whole sound until an end of stream marker
+    u32 offset = 0;
+
+    while( const PcmRingBuffer::Chunk* chunk = waitForChunk( stream ) ) {
+        u32 size = chunk->size;
+        stream->consume();
+        offset += size;
+
+        if( size == 0 ) {
+            break;
+        }
+    }
+
+    EXPECT_EQ( kPcmSize, offset );
+
+    // A sound is not decoded again after the end marker
+    Threads::Thread::sleep( 10 );
+    EXPECT_TRUE( stream->read() == NULL );
+
+    streamer->close( stream );
+    streamer->stop();
+}
+
+TEST(SoundStreamer, PublishesEndMarkersOfEmptySound)
+{
+    SoundEngine      engine;
+    SoundStreamerPtr streamer = DC_NEW SoundStreamer;
+    streamer->start();
+
+    DecodedStream* stream = streamer->open( createDecoder( engine, 0 ), kChunkSize );
+
+    // An end marker is published before and after a rewind, so a looped consumer sees two markers in a row and stops
+    for( s32 i = 0; i < 2; i++ ) {
+        const PcmRingBuffer::Chunk* chunk = waitForChunk( stream );
+        ASSERT_TRUE( chunk != NULL );
+        EXPECT_EQ( 0, chunk->size );
+        stream->consume();
+    }
+
+    // An exhausted decoder is not read anymore
+    Threads::Thread::sleep( 10 );
+    EXPECT_TRUE( stream->read() == NULL );
+
+    streamer->close( stream );
+    streamer->stop();
+}
+
+TEST(SoundStreamer, CountsUnderruns)
+{
+    SoundEngine      engine;
+    SoundStreamerPtr streamer = DC_NEW SoundStreamer;
+
+    DecodedStream* stream = streamer->open( createDecoder( engine ), kChunkSize );
+
+    // The streamer is not started, so a consumer is starved
+    EXPECT_TRUE( stream->read() == NULL );
+    stream->registerUnderrun();
+
+    EXPECT_EQ( 1, stream->underruns() );
+    EXPECT_EQ( 1, streamer->underruns() );
+
+    streamer->close( stream );
+}
@@ -0,0 +1,242 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Generates rolling hills.
+class TerrainDirtyHills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.11f ) * cosf( z * 0.07f ) );
+    }
+};
+
+//! Raises heightmap vertices inside a square brush.
+static void raise( Scene::Heightmap& heightmap, u32 cx, u32 cz, u32 radius )
+{
+    for( u32 z = cz - radius; z <= cz + radius; z++ ) {
+        for( u32 x = cx - radius; x <= cx + radius; x++ ) {
+            heightmap.setHeight( x, z, heightmap.height( x, z ) + 1000 );
+        }
+    }
+}
+
+TEST(TerrainDirtyRegions, MergesTouchingRegions)
+{
+    Scene::Heightmap heightmap( 64 );
+
+    EXPECT_TRUE( heightmap.dirtyRegions().empty() );
+
+    raise( heightmap, 10, 10, 1 );
+    ASSERT_EQ( 1u, heightmap.dirtyRegions().size() );
+    EXPECT_EQ( 9u, heightmap.dirtyRegions()[0].x );
+    EXPECT_EQ( 9u, heightmap.dirtyRegions()[0].z );
+    EXPECT_EQ( 3u, heightmap.dirtyRegions()[0].width );
+    EXPECT_EQ( 3u, heightmap.dirtyRegions()[0].height );
+
+    heightmap.setHeight( 40, 40, 1 );
+    ASSERT_EQ( 2u, heightmap.dirtyRegions().size() );
+
+    // This region touches both previous ones
+    heightmap.invalidate( 12, 12, 28, 28 );
+    ASSERT_EQ( 1u, heightmap.dirtyRegions().size() );
+    EXPECT_EQ( 9u, heightmap.dirtyRegions()[0].x );
+    EXPECT_EQ( 32u, heightmap.dirtyRegions()[0].width );
+
+    heightmap.clearDirtyRegions();
+    EXPECT_TRUE( heightmap.dirtyRegions().empty() );
+
+    heightmap.set( DC_NEW TerrainDirtyHills );
+    ASSERT_EQ( 1u, heightmap.dirtyRegions().size() );
+    EXPECT_EQ( 65u, heightmap.dirtyRegions()[0].width );
+    EXPECT_EQ( 65u, heightmap.dirtyRegions()[0].height );
+}
+
+TEST(TerrainDirtyRegions, RegionsAreClampedToHeightmap)
+{
+    Scene::Heightmap heightmap( 32 );
+    heightmap.invalidate( 30, 31, 10, 10 );
+
+    ASSERT_EQ( 1u, heightmap.dirtyRegions().size() );
+    EXPECT_EQ( 3u, heightmap.dirtyRegions()[0].width );
+    EXPECT_EQ( 2u, heightmap.dirtyRegions()[0].height );
+}
+
+TEST(TerrainDirtyRegions, UpdatesOnlyAffectedChunks)
+{
+    Scene::Terrain terrain( 96 );
+    terrain.heightmap().set( DC_NEW TerrainDirtyHills );
+
+    Scene::Mesh mesh = terrain.createMesh();
+    terrain.heightmap().clearDirtyRegions();
+
+    // A brush inside a single chunk
+    raise( terrain.heightmap(), 48, 48, 3 );
+    Array<s32> chunks = terrain.updateMesh( mesh, terrain.heightmap().dirtyRegions() );
+    terrain.heightmap().clearDirtyRegions();
+
+    ASSERT_EQ( 1u, chunks.size() );
+    EXPECT_EQ( 1 * 3 + 1, chunks[0] );
+
+    // A brush next to a chunk border changes normals of a neighbouring chunk
+    raise( terrain.heightmap(), 33, 48, 2 );
+    chunks = terrain.updateMesh( mesh, terrain.heightmap().dirtyRegions() );
+    terrain.heightmap().clearDirtyRegions();
+
+    ASSERT_EQ( 2u, chunks.size() );
+    EXPECT_EQ( 0 * 3 + 1, chunks[0] );
+    EXPECT_EQ( 1 * 3 + 1, chunks[1] );
+
+    // Updated mesh should be the same as a regenerated one
+    Scene::Mesh expected = terrain.createMesh();
+    ASSERT_EQ( expected.vertexBuffer().size(), mesh.vertexBuffer().size() );
+
+    for( size_t i = 0, n = expected.vertexBuffer().size(); i < n; i++ ) {
+        EXPECT_EQ( 0, memcmp( &expected.vertexBuffer()[i], &mesh.vertexBuffer()[i], sizeof( Scene::Mesh::Vertex ) ) );
+    }
+
+    EXPECT_GE( mesh.bounds().max().y, expected.bounds().max().y );
+}
+
+TEST(TerrainDirtyRegions, RefitsQuadTreeBounds)
+{
+    Scene::Terrain terrain( 256 );
+    terrain.heightmap().set( DC_NEW TerrainDirtyHills );
+
+    Scene::TerrainQuadTree quadTree( terrain );
+    terrain.heightmap().clearDirtyRegions();
+
+    raise( terrain.heightmap(), 64, 100, 5 );
+    raise( terrain.heightmap(), 200, 20, 4 );
+
+    const Scene::Heightmap::Regions& regions = terrain.heightmap().dirtyRegions();
+    ASSERT_EQ( 2u, regions.size() );
+
+    for( size_t i = 0; i < regions.size(); i++ ) {
+        quadTree.updateHeightBounds( regions[i].x, regions[i].z, regions[i].width, regions[i].height );
+    }
+
+    Scene::TerrainQuadTree expected( terrain );
+    ASSERT_EQ( expected.nodes().size(), quadTree.nodes().size() );
+
+    for( size_t i = 0, n = expected.nodes().size(); i < n; i++ ) {
+        EXPECT_FLOAT_EQ( expected.nodes()[i].minHeight, quadTree.nodes()[i].minHeight );
+        EXPECT_FLOAT_EQ( expected.nodes()[i].maxHeight, quadTree.nodes()[i].maxHeight );
+    }
+}
+
+//! Generates a mesh asset from a terrain.
+class TerrainMeshSource : public Assets::GeneratorSource<Scene::Mesh> {
+public:
+
+                    TerrainMeshSource( const Scene::Terrain& terrain )
+                        : m_terrain( terrain ) {}
+
+protected:
+
+    virtual bool    generate( Assets::Assets& assets, Scene::Mesh& mesh ) NIMBLE_OVERRIDE
+    {
+        mesh = m_terrain.createMesh();
+        return true;
+    }
+
+private:
+
+    const Scene::Terrain&   m_terrain;
+};
+
+//! Records vertex ranges uploaded to a render cache.
+class RecordingRenderCache : public Scene::AbstractRenderCache {
+public:
+
+    //! A single uploaded vertex range.
+    struct Upload {
+        s32                 firstVertex;
+        s32                 count;
+    };
+
+    virtual const MaterialNode*     requestMaterial( const Scene::MaterialHandle& asset ) NIMBLE_OVERRIDE { return NULL; }
+    virtual const RenderableNode*   requestMesh( const Scene::MeshHandle& asset ) NIMBLE_OVERRIDE { return NULL; }
+    virtual const RenderableNode*   createRenderable( const void* vertices, s32 count, const Renderer::VertexFormat& vertexFormat ) NIMBLE_OVERRIDE { return NULL; }
+    virtual Renderer::InputLayout   requestInputLayout( const Renderer::VertexFormat& vertexFormat ) NIMBLE_OVERRIDE { return Renderer::InputLayout(); }
+    virtual Renderer::VertexBuffer_ requestVertexBuffer( const Scene::MeshHandle& mesh ) NIMBLE_OVERRIDE { return Renderer::VertexBuffer_(); }
+    virtual Renderer::IndexBuffer_  requestIndexBuffer( const Scene::MeshHandle& mesh ) NIMBLE_OVERRIDE { return Renderer::IndexBuffer_(); }
+
+    virtual void                    updateVertexBuffer( const Scene::MeshHandle& mesh, s32 firstVertex, s32 count ) NIMBLE_OVERRIDE
+    {
+        Upload upload = { firstVertex, count };
+        uploads.push_back( upload );
+    }
+
+    Array<Upload>                   uploads;    //!< All uploaded vertex ranges.
+};
+
+TEST(TerrainDirtyRegions, UploadsVerticesOfUpdatedChunks)
+{
+    Scene::Terrain terrain( 128 );
+    terrain.heightmap().set( DC_NEW TerrainDirtyHills );
+
+    Assets::AssetsPtr assets( DC_NEW Assets::Assets );
+    Scene::MeshHandle mesh = assets->add<Scene::Mesh>( "terrain", DC_NEW TerrainMeshSource( terrain ) );
+    ASSERT_TRUE( assets->forceLoad( mesh ) );
+    terrain.heightmap().clearDirtyRegions();
+
+    StrongPtr<RecordingRenderCache> cache( DC_NEW RecordingRenderCache );
+    s32 verticesPerChunk = (Scene::Terrain::kChunkSize + 1) * (Scene::Terrain::kChunkSize + 1);
+
+    // A brush inside a single chunk uploads only its vertices
+    raise( terrain.heightmap(), 16, 48, 2 );
+    Array<s32> chunks = terrain.updateMesh( mesh, terrain.heightmap().dirtyRegions(), cache );
+    terrain.heightmap().clearDirtyRegions();
+
+    ASSERT_EQ( 1u, chunks.size() );
+    ASSERT_EQ( 1u, cache->uploads.size() );
+    EXPECT_EQ( 1 * verticesPerChunk, cache->uploads[0].firstVertex );
+    EXPECT_EQ( verticesPerChunk, cache->uploads[0].count );
+
+    // A brush at a corner of four chunks, chunks along the Z axis are adjacent and uploaded together
+    cache->uploads.clear();
+    raise( terrain.heightmap(), 32, 32, 2 );
+    chunks = terrain.updateMesh( mesh, terrain.heightmap().dirtyRegions(), cache );
+    terrain.heightmap().clearDirtyRegions();
+
+    ASSERT_EQ( 4u, chunks.size() );
+    ASSERT_EQ( 2u, cache->uploads.size() );
+    EXPECT_EQ( 0, cache->uploads[0].firstVertex );
+    EXPECT_EQ( 2 * verticesPerChunk, cache->uploads[0].count );
+    EXPECT_EQ( 4 * verticesPerChunk, cache->uploads[1].firstVertex );
+    EXPECT_EQ( 2 * verticesPerChunk, cache->uploads[1].count );
+
+    // Uploaded ranges match chunks of the updated mesh asset
+    EXPECT_EQ( mesh->chunkBaseVertex( chunks[2] ), cache->uploads[1].firstVertex );
+}
@@ -0,0 +1,203 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Generates rolling hills.
+class TerrainMeshHills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.11f ) * cosf( z * 0.07f ) );
+    }
+};
+
+TEST(TerrainMesh, ChunkMeshMatchesHeightmap)
+{
+    Scene::Terrain terrain( 96 );
+    terrain.heightmap().set( DC_NEW TerrainMeshHills );
+
+    s32 stride = Scene::Terrain::kChunkSize + 1;
+
+    for( u32 z = 0; z < terrain.chunkCount(); z++ ) {
+        for( u32 x = 0; x < terrain.chunkCount(); x++ ) {
+            Scene::Mesh mesh = terrain.createChunkMesh( x, z );
+            const Scene::Mesh::VertexBuffer& vertices = mesh.vertexBuffer();
+
+            ASSERT_EQ( static_cast<size_t>( stride * stride ), vertices.size() );
+
+            for( s32 i = 0; i < stride; i++ ) {
+                for( s32 j = 0; j < stride; j++ ) {
+                    u32 gx = x * Scene::Terrain::kChunkSize + j;
+                    u32 gz = z * Scene::Terrain::kChunkSize + i;
+                    const Scene::Mesh::Vertex& vertex = vertices[i * stride + j];
+                    Vec3 normal = terrain.heightmap().normal( gx, gz );
+
+                    EXPECT_FLOAT_EQ( static_cast<f32>( j ), vertex.position.x );
+                    EXPECT_FLOAT_EQ( static_cast<f32>( i ), vertex.position.z );
+                    EXPECT_NEAR( terrain.heightAtVertex( gx, gz ), vertex.position.y, 1e-4f );
+                    EXPECT_NEAR( normal.x, vertex.normal.x, 1e-5f );
+                    EXPECT_NEAR( normal.y, vertex.normal.y, 1e-5f );
+                    EXPECT_NEAR( normal.z, vertex.normal.z, 1e-5f );
+                }
+            }
+        }
+    }
+}
+
+TEST(TerrainMesh, ChunksShareIndexBuffer)
+{
+    Scene::Terrain terrain( 64 );
+    Scene::Mesh    mesh = terrain.createMesh();
+
+    const Scene::Terrain::IndexBuffer& indices = terrain.chunkIndexBuffer();
+    s32 stride = Scene::Terrain::kChunkSize + 1;
+
+    EXPECT_EQ( &indices, &terrain.chunkIndexBuffer() );
+    EXPECT_EQ( static_cast<size_t>( Scene::Terrain::kChunkSize * Scene::Terrain::kChunkSize * 6 ), indices.size() );
+    EXPECT_TRUE( indices == mesh.indexBuffer() );
+    ASSERT_EQ( 4, mesh.chunkCount() );
+    EXPECT_EQ( static_cast<size_t>( 4 * stride * stride ), mesh.vertexBuffer().size() );
+
+    for( s32 i = 0; i < mesh.chunkCount(); i++ ) {
+        EXPECT_EQ( 0, mesh.chunkOffset( i ) );
+        EXPECT_EQ( static_cast<s32>( indices.size() ), mesh.chunkIndexCount( i ) );
+        EXPECT_EQ( i * stride * stride, mesh.chunkBaseVertex( i ) );
+    }
+}
+
+TEST(TerrainMesh, ChunksAreDrawnWithBaseVertices)
+{
+    Scene::Terrain terrain( 96 );
+    Scene::Mesh    mesh = terrain.createMesh();
+    s32            size = static_cast<s32>( terrain.chunkIndexBuffer().size() );
+
+    Scene::RenderScene::IndexRanges ranges = Scene::AbstractRenderCache::indexRanges( mesh );
+    ASSERT_EQ( static_cast<size_t>( mesh.chunkCount() ), ranges.size() );
+
+    // Emit a draw call for each range, like a render pass does
+    Renderer::RenderingContextPtr context = Renderer::createNullRenderingContext();
+    Renderer::RenderFrame& frame = context->allocateFrame();
+    Renderer::RenderCommandBuffer& commands = frame.entryPoint();
+
+    for( size_t i = 0; i < ranges.size(); i++ ) {
+        commands.drawIndexed( 0, Renderer::PrimTriangles, ranges[i].offset, ranges[i].count, ranges[i].baseVertex );
+    }
+
+    ASSERT_EQ( mesh.chunkCount(), commands.size() );
+
+    for( s32 i = 0; i < commands.size(); i++ ) {
+        const Renderer::OpCode& opCode = commands.opCodeAt( i );
+
+        EXPECT_EQ( Renderer::OpCode::DrawIndexed, opCode.type );
+        EXPECT_EQ( 0, opCode.drawCall.first );
+        EXPECT_EQ( size, opCode.drawCall.count );
+        EXPECT_EQ( mesh.chunkBaseVertex( i ), opCode.drawCall.baseVertex );
+    }
+
+    // Base vertices of all chunks are distinct and address the whole vertex buffer
+    for( s32 i = 1; i < mesh.chunkCount(); i++ ) {
+        EXPECT_GT( ranges[i].baseVertex, ranges[i - 1].baseVertex );
+    }
+
+    EXPECT_EQ( mesh.vertexBuffer().size(), static_cast<size_t>( ranges.back().baseVertex + (Scene::Terrain::kChunkSize + 1) * (Scene::Terrain::kChunkSize + 1) ) );
+
+    context->display( frame );
+    EXPECT_EQ( mesh.chunkCount(), context->frameCounters().drawCalls );
+}
+
+TEST(TerrainMesh, MeshWithoutChunkRangesIsDrawnAtOnce)
+{
+    Scene::Mesh mesh;
+    mesh.setChunkCount( 1 );
+    mesh.setIndexBuffer( Scene::Mesh::IndexBuffer( 36, 0 ) );
+
+    Scene::RenderScene::IndexRanges ranges = Scene::AbstractRenderCache::indexRanges( mesh );
+
+    ASSERT_EQ( 1u, ranges.size() );
+    EXPECT_EQ( 0, ranges[0].offset );
+    EXPECT_EQ( 36, ranges[0].count );
+    EXPECT_EQ( 0, ranges[0].baseVertex );
+}
+
+TEST(TerrainMesh, WholeMeshMatchesChunkMeshes)
+{
+    Scene::Terrain terrain( 96 );
+    terrain.heightmap().set( DC_NEW TerrainMeshHills );
+
+    Scene::Mesh mesh     = terrain.createMesh();
+    u32         count    = terrain.chunkCount();
+    s32         vertices = (Scene::Terrain::kChunkSize + 1) * (Scene::Terrain::kChunkSize + 1);
+
+    for( u32 x = 0; x < count; x++ ) {
+        for( u32 z = 0; z < count; z++ ) {
+            Scene::Mesh chunk = terrain.createChunkMesh( x, z );
+            s32 base = mesh.chunkBaseVertex( x * count + z );
+
+            for( s32 i = 0; i < vertices; i++ ) {
+                const Scene::Mesh::Vertex& a = chunk.vertexBuffer()[i];
+                const Scene::Mesh::Vertex& b = mesh.vertexBuffer()[base + i];
+
+                EXPECT_FLOAT_EQ( a.position.x + x * Scene::Terrain::kChunkSize, b.position.x );
+                EXPECT_FLOAT_EQ( a.position.y, b.position.y );
+                EXPECT_FLOAT_EQ( a.position.z + z * Scene::Terrain::kChunkSize, b.position.z );
+                EXPECT_FLOAT_EQ( a.normal.y, b.normal.y );
+                EXPECT_FLOAT_EQ( a.uv[1].x, b.uv[1].x );
+            }
+        }
+    }
+}
+
+TEST(TerrainMesh, ParallelGenerationMatchesSerial)
+{
+    Scene::Terrain terrain( 256 );
+    terrain.heightmap().set( DC_NEW TerrainMeshHills );
+
+    Threads::TaskManagerPtr taskManager = Threads::TaskManager::create();
+
+    Scene::Mesh serial   = terrain.createMesh();
+    Scene::Mesh parallel = terrain.createMesh( taskManager );
+
+    ASSERT_EQ( serial.vertexBuffer().size(), parallel.vertexBuffer().size() );
+    ASSERT_EQ( serial.chunkCount(), parallel.chunkCount() );
+
+    for( size_t i = 0, n = serial.vertexBuffer().size(); i < n; i++ ) {
+        const Scene::Mesh::Vertex& a = serial.vertexBuffer()[i];
+        const Scene::Mesh::Vertex& b = parallel.vertexBuffer()[i];
+
+        EXPECT_EQ( 0, memcmp( &a, &b, sizeof( Scene::Mesh::Vertex ) ) );
+    }
+
+    for( s32 i = 0; i < serial.chunkCount(); i++ ) {
+        EXPECT_EQ( serial.chunkBaseVertex( i ), parallel.chunkBaseVertex( i ) );
+    }
+}
@@ -0,0 +1,173 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Generates rolling hills.
+class TerrainQuadTreeHills : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 20000 * sinf( x * 0.05f ) * cosf( z * 0.03f ) );
+    }
+};
+
+//! Returns the heightmap area covered by selected node quadrants.
+static f32 selectedArea( const Scene::TerrainQuadTree& quadTree, const Scene::TerrainQuadTree::Selection& selection )
+{
+    f32 area = 0.0f;
+
+    for( s32 i = 0, n = static_cast<s32>( selection.nodes.size() ); i < n; i++ ) {
+        const Scene::TerrainQuadTree::SelectedNode& selected = selection.nodes[i];
+        f32 quadrant = quadTree.nodes()[selected.node].size * 0.5f;
+
+        for( s32 j = 0; j < 4; j++ ) {
+            if( selected.quadrants & BIT( j ) ) {
+                area += quadrant * quadrant;
+            }
+        }
+    }
+
+    return area;
+}
+
+TEST(TerrainQuadTree, BuildsLevelsOverHeightmap)
+{
+    Scene::Terrain terrain( 2048 );
+    terrain.heightmap().set( DC_NEW TerrainQuadTreeHills );
+    Scene::TerrainQuadTree quadTree( terrain );
+
+    EXPECT_EQ( 7, quadTree.levelCount() );
+    EXPECT_EQ( 5461u, quadTree.nodes().size() );
+
+    // Each leaf bounds contain all heights of its vertices
+    const Scene::TerrainQuadTree::Node& leaf = quadTree.nodes().back();
+    EXPECT_EQ( 0, leaf.level );
+
+    for( s32 z = leaf.z; z <= leaf.z + leaf.size; z++ ) {
+        for( s32 x = leaf.x; x <= leaf.x + leaf.size; x++ ) {
+            EXPECT_GE( terrain.heightAtVertex( x, z ), leaf.minHeight );
+            EXPECT_LE( terrain.heightAtVertex( x, z ), leaf.maxHeight );
+        }
+    }
+
+    // A root node bounds contain bounds of all nodes
+    const Scene::TerrainQuadTree::Node& root = quadTree.nodes()[0];
+    EXPECT_LE( root.minHeight, leaf.minHeight );
+    EXPECT_GE( root.maxHeight, leaf.maxHeight );
+}
+
+TEST(TerrainQuadTree, CoversTerrainWithinTriangleBudget)
+{
+    Scene::Terrain terrain( 2048 );
+    terrain.heightmap().set( DC_NEW TerrainQuadTreeHills );
+    Scene::TerrainQuadTree quadTree( terrain );
+    Scene::TerrainQuadTree::Selection selection;
+
+    Vec3 camera( 1000.0f, terrain.height( 1000.0f, 700.0f ) + 10.0f, 700.0f );
+    quadTree.select( camera, NULL, 0, selection );
+
+    // Selected nodes cover the whole terrain without overlaps
+    EXPECT_EQ( 2048.0f * 2048.0f, selectedArea( quadTree, selection ) );
+
+    // A full resolution terrain has 8M triangles
+    EXPECT_GT( selection.triangles, 0 );
+    EXPECT_LT( selection.triangles, 2048 * 2048 * 2 / 32 );
+
+    // The closest node is rendered with the most detailed level
+    bool hasLeaves = false;
+
+    for( s32 i = 0, n = static_cast<s32>( selection.nodes.size() ); i < n; i++ ) {
+        hasLeaves = hasLeaves || selection.nodes[i].level == 0;
+    }
+
+    EXPECT_TRUE( hasLeaves );
+}
+
+TEST(TerrainQuadTree, CoversTerrainWithPartialRoot)
+{
+    Scene::Terrain terrain( 96 );
+    Scene::TerrainQuadTree quadTree( terrain );
+    Scene::TerrainQuadTree::Selection selection;
+
+    quadTree.select( Vec3( 0.0f, 0.0f, 0.0f ), NULL, 0, selection );
+
+    EXPECT_EQ( 3, quadTree.levelCount() );
+    EXPECT_EQ( 96.0f * 96.0f, selectedArea( quadTree, selection ) );
+}
+
+TEST(TerrainQuadTree, CullsNodesBehindClippingPlanes)
+{
+    Scene::Terrain terrain( 2048 );
+    terrain.heightmap().set( DC_NEW TerrainQuadTreeHills );
+    Scene::TerrainQuadTree quadTree( terrain );
+    Scene::TerrainQuadTree::Selection selection;
+
+    Vec3  camera( 1000.0f, terrain.height( 1000.0f, 700.0f ) + 10.0f, 700.0f );
+    Plane plane = Plane::calculate( Vec3( 1.0f, 0.0f, 0.0f ), Vec3( 1024.0f, 0.0f, 0.0f ) );
+
+    quadTree.select( camera, NULL, 0, selection );
+    s32 triangles = selection.triangles;
+
+    quadTree.select( camera, &plane, 1, selection );
+    EXPECT_GT( selection.culled, 0 );
+    EXPECT_LT( selection.triangles, triangles );
+
+    for( s32 i = 0, n = static_cast<s32>( selection.nodes.size() ); i < n; i++ ) {
+        const Scene::TerrainQuadTree::Node& node = quadTree.nodes()[selection.nodes[i].node];
+        EXPECT_GE( node.x + node.size, 1024 );
+    }
+}
+
+TEST(TerrainQuadTree, MorphsToParentGrid)
+{
+    Scene::Terrain terrain( 256 );
+    terrain.heightmap().set( DC_NEW TerrainQuadTreeHills );
+    Scene::TerrainQuadTree quadTree( terrain );
+    Scene::TerrainQuadTree::Selection selection;
+    Scene::Terrain::VertexBuffer vertices;
+
+    quadTree.select( Vec3( 0.0f, 0.0f, 0.0f ), NULL, 0, selection );
+    ASSERT_FALSE( selection.nodes.empty() );
+
+    const Scene::TerrainQuadTree::SelectedNode& selected = selection.nodes[0];
+    const Scene::TerrainQuadTree::Node&         node     = quadTree.nodes()[selected.node];
+    f32                                         step     = static_cast<f32>( node.size ) / quadTree.leafSize();
+
+    // Close to a camera vertices stay on a node grid
+    quadTree.displacePatch( selected, Vec3( node.x, 0.0f, node.z ), vertices );
+    EXPECT_FLOAT_EQ( node.x + step, vertices[1].position.x );
+
+    // Far from a camera odd vertices collapse onto even ones
+    quadTree.displacePatch( selected, Vec3( -10000.0f, 0.0f, -10000.0f ), vertices );
+    EXPECT_FLOAT_EQ( vertices[0].position.x, vertices[1].position.x );
+    EXPECT_FLOAT_EQ( node.x + step * 2.0f, vertices[2].position.x );
+}
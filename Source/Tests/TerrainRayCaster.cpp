@@ -0,0 +1,205 @@
+/**************************************************************************
+
+ The MIT License (MIT)
+
+ Copyright (c) 2015 Dmitry Sovetov
+
+ https://github.com/dmsovetov
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+
+ **************************************************************************/
+
+
+
+#include "UnitTests.h"
+
+DC_USE_DREEMCHEST
+
+//! Generates steep ridges that are missed by sampling heights along a ray.
+class TerrainRayCasterRidges : public Scene::Heightmap::Generator {
+public:
+
+    virtual Scene::Heightmap::Type calculate( u32 x, u32 z ) NIMBLE_OVERRIDE
+    {
+        return static_cast<Scene::Heightmap::Type>( 32767 + 30000 * sinf( x * 0.3f ) * cosf( z * 0.2f ) );
+    }
+};
+
+//! Returns a dot product of two vectors.
+static f32 rayCasterDot( const Vec3& a, const Vec3& b )
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+//! Intersects a ray with a triangle and updates the closest distance.
+static bool rayCasterTriangle( const Vec3& origin, const Vec3& direction, const Vec3& a, const Vec3& b, const Vec3& c, f32& distance )
+{
+    Vec3 e1  = b - a;
+    Vec3 e2  = c - a;
+    Vec3 p   = direction % e2;
+    f32  det = rayCasterDot( e1, p );
+
+    if( fabs( det ) < 1e-12f ) {
+        return false;
+    }
+
+    Vec3 s = origin - a;
+    f32  u = rayCasterDot( s, p ) / det;
+
+    if( u < 0.0f || u > 1.0f ) {
+        return false;
+    }
+
+    Vec3 q = s % e1;
+    f32  v = rayCasterDot( direction, q ) / det;
+
+    if( v < 0.0f || u + v > 1.0f ) {
+        return false;
+    }
+
+    f32 t = rayCasterDot( e2, q ) / det;
+
+    if( t < 0.0f || t > distance ) {
+        return false;
+    }
+
+    distance = t;
+    return true;
+}
+
+//! Finds the closest ray intersection by testing every terrain triangle.
+static bool rayCasterBruteForce( const Scene::Terrain& terrain, const Vec3& origin, const Vec3& direction, f32& distance )
+{
+    s32  size  = static_cast<s32>( terrain.size() );
+    bool found = false;
+
+    distance = FLT_MAX;
+
+    for( s32 z = 0; z < size; z++ ) {
+        for( s32 x = 0; x < size; x++ ) {
+            Vec3 v00( x,     terrain.heightAtVertex( x,     z     ), z     );
+            Vec3 v10( x + 1, terrain.heightAtVertex( x + 1, z     ), z     );
+            Vec3 v01( x,     terrain.heightAtVertex( x,     z + 1 ), z + 1 );
+            Vec3 v11( x + 1, terrain.heightAtVertex( x + 1, z + 1 ), z + 1 );
+
+            found = rayCasterTriangle( origin, direction, v00, v01, v10, distance ) || found;
+            found = rayCasterTriangle( origin, direction, v10, v01, v11, distance ) || found;
+        }
+    }
+
+    return found;
+}
+
+TEST(TerrainRayCaster, MatchesBruteForce)
+{
+    Scene::Terrain terrain( 64 );
+    terrain.heightmap().set( DC_NEW TerrainRayCasterRidges );
+    Scene::TerrainRayCaster caster( terrain );
+
+    srand( 1 );
+    s32 hits = 0;
+
+    for( s32 i = 0; i < 500; i++ ) {
+        Vec3 origin( rand() % 192 - 64.0f, terrain.maxHeight() * (rand() % 100) / 50.0f, rand() % 192 - 64.0f );
+        Vec3 target( rand() % 64, terrain.maxHeight() * (rand() % 100) / 100.0f, rand() % 64 );
+        Vec3 direction = target - origin;
+        direction.normalize();
+
+        f32  expected;
+        bool intersects = rayCasterBruteForce( terrain, origin, direction, expected );
+
+        Scene::TerrainRayCaster::Hit hit;
+        ASSERT_EQ( intersects, caster.cast( Ray( origin, direction ), hit ) );
+
+        if( intersects ) {
+            EXPECT_NEAR( expected, hit.distance, expected * 0.0001f );
+            EXPECT_GT( hit.normal.y, 0.0f );
+            hits++;
+        }
+    }
+
+    EXPECT_GT( hits, 0 );
+}
+
+TEST(TerrainRayCaster, RespectsMaximumDistance)
+{
+    Scene::Terrain terrain( 64 );
+    Scene::TerrainRayCaster caster( terrain );
+    Scene::TerrainRayCaster::Hit hit;
+
+    // A ray that is far longer than the old fixed segment
+    Ray ray( Vec3( 32.25f, 5000.0f, 32.5f ), Vec3( 0.0f, -1.0f, 0.0f ) );
+
+    EXPECT_FALSE( caster.cast( ray, hit, 4000.0f ) );
+    ASSERT_TRUE( caster.cast( ray, hit ) );
+    EXPECT_FLOAT_EQ( 5000.0f, hit.distance );
+    EXPECT_FLOAT_EQ( 0.0f, hit.point.y );
+    EXPECT_EQ( 32, hit.x );
+    EXPECT_EQ( 32, hit.z );
+
+    // A ray that points away from a terrain
+    EXPECT_FALSE( caster.cast( Ray( Vec3( 32.0f, 10.0f, 32.0f ), Vec3( 0.0f, 1.0f, 0.0f ) ), hit ) );
+}
+
+TEST(TerrainRayCaster, UpdatesEditedRegions)
+{
+    Scene::Terrain terrain( 64 );
+    terrain.heightmap().set( DC_NEW TerrainRayCasterRidges );
+    Scene::TerrainRayCaster caster( terrain );
+
+    for( u32 z = 10; z < 14; z++ ) {
+        for( u32 x = 20; x < 25; x++ ) {
+            terrain.heightmap().setHeight( x, z, terrain.heightmap().maxValue() );
+        }
+    }
+
+    caster.update( 20, 10, 5, 4 );
+    Scene::TerrainRayCaster rebuilt( terrain );
+
+    for( s32 z = 0; z < 64; z++ ) {
+        for( s32 x = 0; x < 64; x++ ) {
+            Ray ray( Vec3( x + 0.3f, 1000.0f, z + 0.6f ), Vec3( 0.0f, -1.0f, 0.0f ) );
+            Scene::TerrainRayCaster::Hit a, b;
+
+            ASSERT_TRUE( caster.cast( ray, a ) );
+            ASSERT_TRUE( rebuilt.cast( ray, b ) );
+            EXPECT_FLOAT_EQ( b.distance, a.distance );
+        }
+    }
+}
+
+TEST(TerrainRayCaster, CastsBatches)
+{
+    Scene::Terrain terrain( 32 );
+    Scene::TerrainRayCaster caster( terrain );
+
+    Ray rays[3] = {
+          Ray( Vec3( 1.3f, 10.0f, 1.6f ), Vec3( 0.0f, -1.0f, 0.0f ) )
+        , Ray( Vec3( 1.3f, 10.0f, 1.6f ), Vec3( 0.0f,  1.0f, 0.0f ) )
+        , Ray( Vec3( -10.0f, 6.0f, 16.3f ), Vec3( 1.0f, -0.5f, 0.0f ) )
+    };
+
+    Scene::TerrainRayCaster::Hit hits[3];
+    bool                         results[3];
+
+    EXPECT_EQ( 2, caster.castBatch( rays, 3, hits, results ) );
+    EXPECT_TRUE( results[0] );
+    EXPECT_FALSE( results[1] );
+    EXPECT_TRUE( results[2] );
+    EXPECT_NEAR( 2.0f, hits[2].point.x, 0.001f );
+}